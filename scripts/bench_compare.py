@@ -0,0 +1,88 @@
+#!/usr/bin/env python3
+"""Compare two hl_bench JSON result files and flag slowdowns.
+
+Usage:
+    bench_compare.py BASELINE.json CURRENT.json [--threshold PCT] [--filter TEXT]
+
+A case regresses when its median ns/op grew by more than --threshold percent
+(default 10) AND the fastest current repeat is still slower than the baseline
+median, so a single noisy repeat does not fail the comparison.
+
+Exit status: 0 no regressions, 1 at least one regression, 2 bad input.
+Cases present in only one file are listed but never fail the run.
+"""
+
+import argparse
+import json
+import sys
+
+
+def fail(path, why):
+    print("bench_compare: %s: %s" % (path, why), file=sys.stderr)
+    sys.exit(2)
+
+
+def load(path):
+    try:
+        with open(path, "r", encoding="utf-8") as f:
+            data = json.load(f)
+    except (OSError, ValueError) as e:
+        fail(path, e)
+    if not isinstance(data, dict) or data.get("suite") != "hl_bench" or data.get("schema") != 1:
+        fail(path, "not an hl_bench schema 1 file")
+    return data
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Flag hl_bench slowdowns between two runs.")
+    ap.add_argument("baseline")
+    ap.add_argument("current")
+    ap.add_argument("--threshold", type=float, default=10.0,
+                    help="allowed slowdown in percent (default 10)")
+    ap.add_argument("--filter", default="", help="only cases whose name contains TEXT")
+    args = ap.parse_args()
+
+    base = load(args.baseline)
+    cur = load(args.current)
+
+    for key in ("platform", "compiler", "payloads"):
+        if base.get(key) != cur.get(key):
+            print("warning: %s differs (%s vs %s); numbers may not be comparable"
+                  % (key, base.get(key), cur.get(key)))
+
+    base_by_name = {r["name"]: r for r in base["results"]}
+    cur_by_name = {r["name"]: r for r in cur["results"]}
+    names = [n for n in base_by_name if n in cur_by_name and args.filter in n]
+
+    print("baseline: %s   current: %s   threshold: %.1f%%"
+          % (base.get("label") or args.baseline, cur.get("label") or args.current, args.threshold))
+    print("%-30s %12s %12s %9s" % ("case", "base ns/op", "cur ns/op", "change"))
+
+    regressions = []
+    for name in names:
+        b = base_by_name[name]
+        c = cur_by_name[name]
+        change = (c["ns_per_op"] / b["ns_per_op"] - 1.0) * 100.0 if b["ns_per_op"] > 0 else 0.0
+        slower = change > args.threshold and c["min_ns"] > b["ns_per_op"]
+        mark = "  REGRESSION" if slower else ""
+        print("%-30s %12.1f %12.1f %+8.1f%%%s" % (name, b["ns_per_op"], c["ns_per_op"], change, mark))
+        if slower:
+            regressions.append(name)
+
+    only_base = [n for n in base_by_name if n not in cur_by_name and args.filter in n]
+    only_cur = [n for n in cur_by_name if n not in base_by_name and args.filter in n]
+    if only_base:
+        print("only in baseline: %s" % ", ".join(only_base))
+    if only_cur:
+        print("only in current: %s" % ", ".join(only_cur))
+
+    if regressions:
+        print("\n%d regression(s) above %.1f%%: %s"
+              % (len(regressions), args.threshold, ", ".join(regressions)))
+        return 1
+    print("\nno regressions above %.1f%%" % args.threshold)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -96,46 +96,54 @@ static int zorroLogCallback(const char* msg) {
 
 // WS userFills → TradeMap bridge [OPM-87]
 // Called on WS connection thread; trading functions use critical sections.
-// Receives per-OID cumulative fill totals computed from PriceCache.
+// Receives per-OID cumulative fill totals, only for OIDs with new fills.
 static void onFillNotify(const char* oid, double totalFilledSz, double avgFillPx) {
     int tradeId = hl::trading::findTradeIdByOid(oid);
     if (tradeId <= 0) return;
+    if (hl::trace::enabled()) {
+        char detail[48];
+        sprintf_s(detail, "oid %.16s sz %.6g", oid, totalFilledSz);
+        hl::trace::instant("userFills", "ws", tradeId, nullptr, detail);
+    }
 
-    hl::OrderState state;
-    if (!hl::trading::getOrder(tradeId, state)) return;
-
-    if (totalFilledSz < state.filledSize) return;
-
-    hl::OrderStatus newStatus = hl::determineFilledStatus(totalFilledSz, state.requestedSize);
+    // Monotonic check, status derivation and write in one locked step
+    hl::OrderStatus newStatus;
+    if (!hl::trading::applyFillUpdate(tradeId, totalFilledSz, avgFillPx, &newStatus)) return;
+    HL_LAT_ORDER_FILLED(tradeId);
 
-    hl::trading::updateOrder(tradeId, totalFilledSz, avgFillPx, newStatus);
+    // Fully filled: the aggregator can forget this order
+    if (newStatus == hl::OrderStatus::Filled && hl::g_wsManager)
+        static_cast<hl::ws::WebSocketManager*>(hl::g_wsManager)->retireFillOrder(oid);
 }
 
 // WS orderUpdates → TradeMap bridge [OPM-86]
 // Called on WS connection thread; trading functions use critical sections.
+// avgPx here is the order's limit price: it only seeds avgPrice until
+// userFills reports the real average.
 static void onOrderUpdate(const char* oid, const char* cloid,
                            const char* status, double filledSz, double avgPx) {
-    int tradeId = 0;
-    if (cloid) tradeId = hl::trading::findTradeIdByCloid(cloid);
-    if (tradeId == 0 && oid) tradeId = hl::trading::findTradeIdByOid(oid);
-    if (tradeId == 0) return;
-
-    hl::OrderState state;
-    hl::trading::getOrder(tradeId, state);
-
-    hl::OrderStatus orderStatus = hl::OrderStatus::Open;
-    if (status) {
-        if (strcmp(status, "filled") == 0)
-            orderStatus = hl::determineFilledStatus(filledSz, state.requestedSize);
-        else if (strstr(status, "canceled") || strstr(status, "Canceled"))
-            orderStatus = hl::OrderStatus::Cancelled;
-        else if (strcmp(status, "rejected") == 0 || strstr(status, "Rejected"))
-            orderStatus = hl::OrderStatus::Error;
-        else if (filledSz > 0 && state.requestedSize > 0)
-            orderStatus = hl::determineFilledStatus(filledSz, state.requestedSize);
+    if (hl::trace::enabled()) {
+        int tradeId = (cloid && *cloid) ? hl::trading::extractTradeIdFromCloid(cloid) : 0;
+        if (tradeId <= 0) tradeId = hl::trading::findTradeIdByOid(oid);
+        hl::trace::instant("orderUpdates", "ws", tradeId, cloid, status);
     }
+    hl::trading::applyOrderUpdate(oid, cloid, status, filledSz, avgPx);
+
+    // Cancelled/rejected after a partial fill: the aggregator must not keep
+    // its totals forever (fills already in flight are still applied)
+    hl::OrderStatus st = hl::trading::mapExchangeStatus(status, 0.0, 0.0);
+    if ((st == hl::OrderStatus::Cancelled || st == hl::OrderStatus::Error) &&
+        oid && *oid && hl::g_wsManager)
+        static_cast<hl::ws::WebSocketManager*>(hl::g_wsManager)->closeFillOrder(oid);
+}
 
-    hl::trading::updateOrder(tradeId, filledSz, avgPx, orderStatus);
+// Order feed state for reconciliation: live while orderUpdates is acked on a
+// healthy connection; the epoch moves whenever the feed may have gapped
+static bool orderFeedProbe(uint32_t* epoch) {
+    auto* wsMgr = static_cast<hl::ws::WebSocketManager*>(hl::g_wsManager);
+    if (!wsMgr) return false;
+    *epoch = wsMgr->getOrderFeedEpoch();
+    return wsMgr->isOrderFeedLive();
 }
 
 //=============================================================================
@@ -196,6 +204,8 @@ DLLFUNC int BrokerOpen(char* name, FARPROC fpMessage, FARPROC fpProgress) {
     (FARPROC&)BrokerProgress = fpProgress;
 
     hl::initGlobals();
+    hl::trading::resetOrderSync();
+    hl::trading::resetTradeSnapshot();
 
 #ifdef DEV_BUILD
     hl::g_config.diagLevel = 2;
@@ -203,6 +213,9 @@ DLLFUNC int BrokerOpen(char* name, FARPROC fpMessage, FARPROC fpProgress) {
 #endif
 
     hl::g_logger.callback = zorroLogCallback;
+    // Zorro calls every Broker* function on this thread: WS and worker
+    // threads queue their messages for it instead of calling BrokerMessage
+    hl::g_logRing.setDrainThread(hl::g_config.asyncLog ? GetCurrentThreadId() : 0);
 
     if (!hl::crypto::init()) {
         if (BrokerMessage) {
@@ -348,7 +361,7 @@ DLLFUNC int BrokerLogin(char* user, char* pwd, char* type, char* accounts) {
         // Initialize WebSocket
         if (hl::g_config.enableWebSocket) {
             if (!hl::g_priceCache) {
-                hl::g_priceCache = new hl::ws::PriceCache();
+                hl::g_priceCache = new hl::ws::PriceCache(hl::g_config.fillCapacity);
             }
 
             auto* priceCache = static_cast<hl::ws::PriceCache*>(hl::g_priceCache);
@@ -360,11 +373,18 @@ DLLFUNC int BrokerLogin(char* user, char* pwd, char* type, char* accounts) {
                 wsMgr->setOrderUpdateCallback(onOrderUpdate);
                 wsMgr->setFillNotifyCallback(onFillNotify);
                 wsMgr->setUserAddress(hl::g_config.walletAddress);
+                wsMgr->setMarketConnections(hl::g_config.wsMarketConnections);
+                wsMgr->setStandbyEnabled(hl::g_config.wsStandby);
+                wsMgr->setSharedPricesEnabled(hl::g_config.sharedPrices);
+                wsMgr->setSubscriptionPacing(hl::g_config.wsSubRate, hl::config::WS_SUB_BURST);
+                wsMgr->setNotifyMinInterval(hl::g_config.guiNotifyMinMs);
+                wsMgr->setNotifyTradedOnly(hl::g_config.guiNotifyTradedOnly);
                 if (hl::g_config.zorroWindow) {
                     wsMgr->setZorroWindow(hl::g_config.zorroWindow);
                 }
                 hl::g_wsManager = wsMgr;
             }
+            hl::trading::setOrderFeedProbe(orderFeedProbe);
 
             auto* wsMgr = static_cast<hl::ws::WebSocketManager*>(hl::g_wsManager);
 
@@ -405,6 +425,7 @@ DLLFUNC int BrokerLogin(char* user, char* pwd, char* type, char* accounts) {
             delete wsMgr;
             hl::g_wsManager = nullptr;
         }
+        hl::g_logRing.drain();      // Shutdown messages of the WS threads
         if (hl::g_priceCache) {
             auto* cache = static_cast<hl::ws::PriceCache*>(hl::g_priceCache);
             delete cache;
@@ -424,6 +445,7 @@ DLLFUNC int BrokerLogin(char* user, char* pwd, char* type, char* accounts) {
 //=============================================================================
 
 DLLFUNC int BrokerTime(DATE *pTimeGMT) {
+    hl::g_logRing.drain();          // Messages deferred by WS / worker threads
     if (!hl::g_config.walletAddress[0]) return 0;
 
     if (pTimeGMT) {
@@ -439,6 +461,7 @@ DLLFUNC int BrokerTime(DATE *pTimeGMT) {
 //=============================================================================
 
 DLLFUNC double BrokerCommand(int mode, intptr_t parameter) {
+    hl::g_logRing.drain();
     double result = handleBrokerCommand(mode, parameter);
     if (hl::g_config.diagLevel >= 1 && mode != GET_VOLUME) {
         hl::g_logger.logf(1, "BrokerCommand: mode=%d param=%lld -> %.4f",
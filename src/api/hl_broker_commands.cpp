@@ -13,13 +13,14 @@
 // - GET_POSITION, GET_TRADES, GET_PRICE
 // - DO_CANCEL
 // - Export commands (50001-50003)
-// - Custom commands (50010-50031)
+// - Custom commands (50010-50067)
 //=============================================================================
 
 #include "hl_broker_internal.h"
 #include "../services/hl_trading_twap.h"
 #include "../services/hl_trading_modify.h"
 #include "../services/hl_trading_bracket.h"
+#include <algorithm>
 
 //=============================================================================
 // HANDLER IMPLEMENTATION
@@ -333,6 +334,7 @@ double handleBrokerCommand(int mode, intptr_t parameter) {
         }
 
         bool success = hl::trading::cancelOrderByTradeId(tradeId);
+        hl::trading::invalidateTradeSnapshot();
         if (hl::g_config.diagLevel >= 1) {
             char msg[64];
             sprintf_s(msg, "DO_CANCEL: TradeID=%d %s",
@@ -353,13 +355,19 @@ double handleBrokerCommand(int mode, intptr_t parameter) {
             hl::g_config.enableWebSocket = true;
 
             if (!hl::g_priceCache) {
-                hl::g_priceCache = new hl::ws::PriceCache();
+                hl::g_priceCache = new hl::ws::PriceCache(hl::g_config.fillCapacity);
             }
             if (!hl::g_wsManager) {
                 auto* cache = static_cast<hl::ws::PriceCache*>(hl::g_priceCache);
                 auto* wsMgr = new hl::ws::WebSocketManager(*cache);
                 wsMgr->setDiagLevel(hl::g_config.diagLevel);
                 wsMgr->setUserAddress(hl::g_config.walletAddress);
+                wsMgr->setMarketConnections(hl::g_config.wsMarketConnections);
+                wsMgr->setStandbyEnabled(hl::g_config.wsStandby);
+                wsMgr->setSharedPricesEnabled(hl::g_config.sharedPrices);
+                wsMgr->setSubscriptionPacing(hl::g_config.wsSubRate, hl::config::WS_SUB_BURST);
+                wsMgr->setNotifyMinInterval(hl::g_config.guiNotifyMinMs);
+                wsMgr->setNotifyTradedOnly(hl::g_config.guiNotifyTradedOnly);
                 hl::g_wsManager = wsMgr;
             }
 
@@ -483,6 +491,281 @@ double handleBrokerCommand(int mode, intptr_t parameter) {
         return 1;
     }
 
+    case HL_SET_WS_CONNECTIONS: {
+        // Market-data connection pool size. Takes effect when the manager is
+        // (re)started — call before login or toggle HL_ENABLE_WEBSOCKET.
+        int count = (int)parameter;
+        if (count < 0 || count > hl::config::WS_MAX_MARKET_CONNECTIONS) return 0;
+        hl::g_config.wsMarketConnections = count;
+        bool running = false;
+        if (hl::g_wsManager) {
+            auto* wsMgr = static_cast<hl::ws::WebSocketManager*>(hl::g_wsManager);
+            running = wsMgr->isRunning();
+            if (!running) wsMgr->setMarketConnections(count);
+        }
+        hl::g_logger.logf(1, "WS market connections: %d%s", count,
+                          running ? " (applies on restart)" : "");
+        return 1;
+    }
+
+    case HL_SET_WS_STANDBY: {
+        // Warm standby — takes effect when the manager is (re)started
+        hl::g_config.wsStandby = (parameter != 0);
+        bool running = false;
+        if (hl::g_wsManager) {
+            auto* wsMgr = static_cast<hl::ws::WebSocketManager*>(hl::g_wsManager);
+            running = wsMgr->isRunning();
+            if (!running) wsMgr->setStandbyEnabled(hl::g_config.wsStandby);
+        }
+        hl::g_logger.logf(1, "WS warm standby: %s%s", hl::g_config.wsStandby ? "on" : "off",
+                          running ? " (applies on restart)" : "");
+        return 1;
+    }
+
+    case HL_SET_SHARED_PRICES: {
+        // Shared price table — takes effect when the manager is (re)started
+        hl::g_config.sharedPrices = (parameter != 0);
+        bool running = false;
+        if (hl::g_wsManager) {
+            auto* wsMgr = static_cast<hl::ws::WebSocketManager*>(hl::g_wsManager);
+            running = wsMgr->isRunning();
+            if (!running) wsMgr->setSharedPricesEnabled(hl::g_config.sharedPrices);
+        }
+        hl::g_logger.logf(1, "Shared prices: %s%s", hl::g_config.sharedPrices ? "on" : "off",
+                          running ? " (applies on restart)" : "");
+        return 1;
+    }
+
+    case HL_SET_ASYNC_LOG:
+        // Off = WS threads call BrokerMessage themselves again (debugging only, [OPM-133])
+        hl::g_config.asyncLog = (parameter != 0);
+        hl::g_logRing.setDrainThread(hl::g_config.asyncLog ? GetCurrentThreadId() : 0);
+        hl::g_logger.logf(1, "Async log: %s", hl::g_config.asyncLog ? "on" : "off");
+        return 1;
+
+    case HL_SET_NOTIFY_INTERVAL: {
+        // Min ms between WM_APP+1 price notifications — applies immediately
+        int ms = (int)parameter;
+        if (ms < 0) return 0;
+        hl::g_config.guiNotifyMinMs = ms;
+        if (hl::g_wsManager) {
+            auto* wsMgr = static_cast<hl::ws::WebSocketManager*>(hl::g_wsManager);
+            wsMgr->setNotifyMinInterval(ms);
+        }
+        hl::g_logger.logf(1, "GUI notify interval: %d ms", ms);
+        return 1;
+    }
+
+    case HL_SET_NOTIFY_FILTER:
+        // 1 = notify only for coins with positions/open orders, 0 = every subscribed coin
+        hl::g_config.guiNotifyTradedOnly = (parameter != 0);
+        if (hl::g_wsManager) {
+            auto* wsMgr = static_cast<hl::ws::WebSocketManager*>(hl::g_wsManager);
+            wsMgr->setNotifyTradedOnly(hl::g_config.guiNotifyTradedOnly);
+        }
+        hl::g_logger.logf(1, "GUI notify filter: %s",
+                          hl::g_config.guiNotifyTradedOnly ? "traded coins" : "all coins");
+        return 1;
+
+    case HL_GET_LATENCY: {
+        // p50/p90/p99/max per hot-path stage since start or HL_RESET_LATENCY
+        if (!hl::lat::compiledIn()) {
+            hl::g_logger.log(1, "Latency stats: compiled out (HL_LATENCY_STATS=OFF)");
+            return 0;
+        }
+        const int stages = (int)hl::lat::Stage::Count;
+        if (parameter) return hl::lat::summarize((hl::lat::StageSummary*)parameter, stages);
+        hl::lat::StageSummary rows[(int)hl::lat::Stage::Count];
+        int n = hl::lat::summarize(rows, stages);
+        for (int i = 0; i < n; i++) {
+            if (rows[i].count == 0) continue;
+            hl::g_logger.logf(1, "Latency %-12s n=%.0f p50=%.1fus p90=%.1fus p99=%.1fus max=%.1fus",
+                              rows[i].name, rows[i].count, rows[i].p50Us, rows[i].p90Us,
+                              rows[i].p99Us, rows[i].maxUs);
+        }
+        return n;
+    }
+
+    case HL_SAVE_LATENCY: {
+        const char* path = (const char*)parameter;
+        if (!path || !*path) return 0;
+        if (!hl::lat::writeCsv(path)) {
+            hl::g_logger.logf(1, "Latency stats: cannot write %s", path);
+            return 0;
+        }
+        hl::g_logger.logf(1, "Latency stats written to %s", path);
+        return 1;
+    }
+
+    case HL_RESET_LATENCY:
+        hl::lat::reset();
+        return 1;
+
+    case HL_SET_TRACE:
+        hl::trace::setEnabled(parameter != 0);
+        hl::g_logger.logf(1, "Order trace: %s (%d events max)",
+                          parameter ? "recording" : "stopped", hl::config::TRACE_CAPACITY);
+        return 1;
+
+    case HL_SAVE_TRACE: {
+        // Chrome trace-event JSON: open in ui.perfetto.dev or chrome://tracing
+        const char* path = (const char*)parameter;
+        if (!path || !*path) return 0;
+        hl::trace::TraceStats st = hl::trace::getStats();
+        int events = hl::trace::flush(path);
+        if (events < 0) {
+            hl::g_logger.logf(1, "Order trace: cannot write %s", path);
+            return 0;
+        }
+        hl::g_logger.logf(1, "Order trace: %d events written to %s (%lld lost to wrap)",
+                          events, path, st.overwritten);
+        return events;
+    }
+
+    case HL_SET_CAPTURE: {
+        // Binary capture for tests/replay_capture (hl_capture.h)
+        const char* path = (const char*)parameter;
+        if (!path || !*path) {
+            hl::capture::CaptureStats st = hl::capture::getStats();
+            hl::capture::stop();
+            hl::g_logger.logf(1, "Traffic capture stopped: %lld records, %lld bytes",
+                              st.records, st.bytes);
+            return 1;
+        }
+        if (!hl::capture::start(path)) {
+            hl::g_logger.logf(1, "Traffic capture: cannot write %s", path);
+            return 0;
+        }
+        hl::g_logger.logf(1, "Traffic capture recording to %s", path);
+        return 1;
+    }
+
+    case HL_SET_WS_SUB_RATE: {
+        // l2Book subscribe pacing — applies immediately to every connection
+        int rate = (int)parameter;
+        if (rate <= 0) return 0;
+        hl::g_config.wsSubRate = rate;
+        if (hl::g_wsManager) {
+            auto* wsMgr = static_cast<hl::ws::WebSocketManager*>(hl::g_wsManager);
+            wsMgr->setSubscriptionPacing(rate, hl::config::WS_SUB_BURST);
+        }
+        hl::g_logger.logf(1, "WS subscribe pacing: %d/s", rate);
+        return 1;
+    }
+
+    case HL_SET_FILL_CAPACITY: {
+        // Fill store size — resizes in place, newest fills are kept
+        int count = (int)parameter;
+        if (count <= 0) return 0;
+        hl::g_config.fillCapacity = count;
+        if (hl::g_priceCache)
+            static_cast<hl::ws::PriceCache*>(hl::g_priceCache)->setFillCapacity(count);
+        hl::g_logger.logf(1, "WS fill store capacity: %d", count);
+        return 1;
+    }
+
+    case HL_GET_WS_HEALTH: {
+        if (!hl::g_wsManager) return 0;
+        auto* wsMgr = static_cast<hl::ws::WebSocketManager*>(hl::g_wsManager);
+        int connected = 0;
+        for (const auto& h : wsMgr->getConnectionHealth()) {
+            if (h.connected) connected++;
+            hl::g_logger.logf(1, "WS[%d]%s %s%s subs=%d (acked=%d queued=%d) reconnects=%d "
+                              "msgs=%lld bytes=%lld first=%lld last=%ds",
+                              h.index, h.standby ? " standby" : "", h.connected ? "UP" : "DOWN",
+                              h.circuitOpen ? " CIRCUIT-OPEN" : "",
+                              h.l2Subscriptions, h.l2Acked, h.l2Queued, h.reconnects,
+                              h.messages, h.bytes,
+                              h.firstArrivals, h.secondsSinceLastMessage);
+        }
+        if (wsMgr->isStandbyEnabled())
+            hl::g_logger.logf(1, "WS duplicates dropped: %lld", wsMgr->getDuplicatesDropped());
+        if (wsMgr->isSharedPricesEnabled()) {
+            hl::ws::SharedPriceStats sp = wsMgr->getSharedPriceStats();
+            hl::g_logger.logf(1, "Shared prices: %s role=%s publisher=%s pid=%lu takeovers=%u "
+                              "slots=%d published=%lld readRetries=%lld",
+                              sp.open ? "MAPPED" : "UNAVAILABLE", sp.publisher ? "publisher" : "reader",
+                              sp.publisherAlive ? "alive" : "SILENT", (unsigned long)sp.publisherPid,
+                              sp.takeovers, sp.slotsUsed, sp.published, sp.readRetries);
+        }
+        hl::ws::GuiNotifyStats gn = wsMgr->getNotifyStats();
+        hl::g_logger.logf(1, "GUI notify: posted=%lld updates=%lld filtered=%lld coalesced=%lld "
+                          "acks=%lld rearms=%lld interval=%dms filter=%s",
+                          gn.posted, gn.updates, gn.filtered, gn.coalesced, gn.acks, gn.rearms,
+                          gn.minIntervalMs, gn.tradedOnly ? "traded" : "all");
+        hl::LogRingStats ls = hl::g_logRing.getStats();
+        hl::g_logger.logf(1, "Log ring: %s pushed=%lld drained=%lld dropped=%lld highWater=%d",
+                          ls.deferring ? "deferring" : "direct", ls.pushed, ls.drained,
+                          ls.dropped, ls.highWater);
+        return connected;
+    }
+
+    case HL_GET_WS_SUBSCRIPTIONS: {
+        // Subscription registry dump — find dead feeds in one pass
+        if (!hl::g_wsManager) return 0;
+        auto* wsMgr = static_cast<hl::ws::WebSocketManager*>(hl::g_wsManager);
+        auto table = wsMgr->getSubscriptionTable();
+        std::sort(table.begin(), table.end(),
+                  [](const hl::ws::SubscriptionInfo& a, const hl::ws::SubscriptionInfo& b) {
+                      return a.connection != b.connection ? a.connection < b.connection
+                                                          : a.key < b.key;
+                  });
+        DWORD now = GetTickCount();
+        int dead = 0;
+        hl::g_logger.logf(1, "WS subscriptions: %d", (int)table.size());
+        for (const auto& row : table) {
+            if (row.status == hl::ws::SubStatus::Dead) dead++;
+            int quietSec = row.lastDataAt ? (int)((now - row.lastDataAt) / 1000) : -1;
+            int ackMs = (row.ackedAt && row.sentAt) ? (int)(row.ackedAt - row.sentAt) : -1;
+            hl::g_logger.logf(1, "  WS[%d] %-28s %-9s sends=%d ack=%dms msgs=%lld quiet=%ds",
+                              row.connection, row.key.c_str(), hl::ws::subStatusName(row.status),
+                              row.sends, ackMs, row.messages, quietSec);
+        }
+        if (dead > 0) hl::g_logger.logf(1, "WS subscriptions DEAD (never acked): %d", dead);
+        return dead;
+    }
+
+    case HL_SET_ASSET_CTX_STREAM: {
+        // activeAssetCtx per asset subscribed from now on; off = BrokerAsset
+        // serves the context pulled when the asset was subscribed
+        hl::g_config.wsAssetCtx = (parameter != 0);
+        hl::g_logger.logf(1, "Asset context stream: %s",
+                          hl::g_config.wsAssetCtx ? "on" : "off");
+        return 1;
+    }
+
+    case HL_GET_ORDER_SYNC: {
+        // HTTP budget and order reconciliation counters
+        hl::http::CallStats calls = hl::http::getCallStats();
+        hl::trading::OrderSyncStats sync = hl::trading::getOrderSyncStats();
+        bool feedLive = false;
+        unsigned epoch = 0;
+        if (hl::g_wsManager) {
+            auto* wsMgr = static_cast<hl::ws::WebSocketManager*>(hl::g_wsManager);
+            feedLive = wsMgr->isOrderFeedLive();
+            epoch = wsMgr->getOrderFeedEpoch();
+        }
+        hl::g_logger.logf(1, "HTTP calls last hour: %d (info=%d exchange=%d other=%d)",
+                          calls.lastHour(), calls.infoLastHour, calls.exchangeLastHour,
+                          calls.otherLastHour);
+        hl::g_logger.logf(1, "HTTP calls total: info=%lld exchange=%lld other=%lld",
+                          calls.infoTotal, calls.exchangeTotal, calls.otherTotal);
+        hl::g_logger.logf(1, "Order feed: %s epoch=%u active=%d | pushes: orders=%lld fills=%lld",
+                          feedLive ? "LIVE" : "DOWN", epoch,
+                          (int)hl::g_trading.activeOrderCount(),
+                          sync.orderEvents, sync.fillEvents);
+        hl::g_logger.logf(1, "Order reconcile: batches=%lld http=%lld failed=%lld "
+                          "reconciled=%lld notFound=%lld lastBatch=%d",
+                          sync.batches, sync.httpCalls, sync.httpFailures,
+                          sync.ordersReconciled, sync.ordersNotFound, sync.lastBatchOrders);
+        hl::trading::TradeSnapshotStats snap = hl::trading::getTradeSnapshotStats();
+        hl::g_logger.logf(1, "BrokerTrade snapshot: rebuilds=%lld hits=%lld misses=%lld "
+                          "lastTrades=%d lastBuild=%.1fus",
+                          snap.rebuilds, snap.hits, snap.misses,
+                          snap.lastTrades, snap.lastBuildUs);
+        return calls.lastHour();
+    }
+
     case HL_SCHEDULE_CANCEL: {
         // Dead man's switch [OPM-83]
         // param = seconds from now (0 = clear). Plugin converts to absolute ms.
@@ -561,12 +844,21 @@ double handleBrokerCommand(int mode, intptr_t parameter) {
                 }
             }
 
+            // Rollover from funding: one context pull per dex covers the file
+            double rollLong = 0.0, rollShort = 0.0;
+            hl::AssetCtx ctx;
+            if (hl::market::getAssetCtx(asset->name, &ctx)) {
+                hl::market::fundingToRollover(ctx, &rollLong, &rollShort);
+                if (mid <= 0.0) mid = ctx.midPx;
+            }
+
             double pip = asset->tickSize;       // [OPM-198] use pre-calculated
             double lotAmt = asset->minSize;
             double pipCost = pip * lotAmt;  // 10^(-6) for perps, 10^(-8) for spot [OPM-141]
 
-            fprintf(f, "%s,%.8f,%.8f,0,0,%.8f,%.8f,0,%d,%.8f,-0.035\n",
-                    asset->coin, mid, spread, pip, pipCost, asset->maxLeverage, lotAmt);
+            fprintf(f, "%s,%.8f,%.8f,%.8f,%.8f,%.8f,%.8f,0,%d,%.8f,-0.035\n",
+                    asset->coin, mid, spread, rollLong, rollShort, pip, pipCost,
+                    asset->maxLeverage, lotAmt);
             written++;
         }
 
@@ -639,6 +931,7 @@ double handleBrokerCommand(int mode, intptr_t parameter) {
         if (parameter == 0) return 0;
         const hl::ModifyRequest* req = (const hl::ModifyRequest*)parameter;
         hl::ModifyResult res = hl::trading::modifyOrder(*req);
+        hl::trading::invalidateTradeSnapshot();
         if (!res.success) {
             hl::g_logger.logf(1, "HL_MODIFY_ORDER failed: %s", res.error.c_str());
             return 0;
@@ -53,12 +53,17 @@
 #include "../foundation/hl_config.h"
 #include "../foundation/hl_crypto.h"
 #include "../foundation/hl_utils.h"
+#include "../foundation/hl_latency.h"
+#include "../foundation/hl_trace.h"
 #include "../services/hl_market_service.h"
 #include "../services/hl_trading_service.h"
+#include "../services/hl_order_sync.h"
+#include "../services/hl_trade_snapshot.h"
 #include "../services/hl_account_service.h"
 #include "../services/hl_meta.h"
 #include "../transport/ws_manager.h"
 #include "../transport/ws_price_cache.h"
+#include "../transport/hl_capture.h"
 
 // Plugin identification
 #define PLUGIN_TYPE 2
@@ -88,6 +93,24 @@
 #define HL_CANCEL_TWAP         50041  // Cancel TWAP order: param=twapId [OPM-81]
 #define HL_MODIFY_ORDER        50042  // Atomic order modify: param=ModifyRequest* [OPM-80]
 #define HL_PLACE_BRACKET       50043  // Bracket order: param=BracketRequest* [OPM-79]
+#define HL_SET_WS_CONNECTIONS  50050  // Market-data WS connection pool size: param=count (0=single)
+#define HL_GET_WS_HEALTH       50051  // Log per-connection WS health, returns connected count
+#define HL_SET_WS_STANDBY      50052  // Warm-standby WS connection: param=1 on, 0 off
+#define HL_SET_WS_SUB_RATE     50053  // l2Book subscribe pacing: param=frames/s per connection
+#define HL_GET_WS_SUBSCRIPTIONS 50054 // Log subscription registry table, returns dead feed count
+#define HL_SET_FILL_CAPACITY   50055  // Fills kept in the WS fill store: param=count
+#define HL_GET_ORDER_SYNC      50056  // Log order sync / HTTP call stats, returns HTTP calls in last hour
+#define HL_SET_ASSET_CTX_STREAM 50057  // Stream activeAssetCtx for subscribed assets: param=0/1
+#define HL_SET_SHARED_PRICES   50058  // Share l2Book prices across instances on this box: param=1 on, 0 off
+#define HL_SET_ASYNC_LOG       50059  // Defer worker-thread log messages to Zorro's thread: param=1 on (default), 0 off
+#define HL_SET_NOTIFY_INTERVAL 50060  // Min ms between WM_APP+1 price notifications: param=ms (0 = no limit)
+#define HL_SET_NOTIFY_FILTER   50061  // WM_APP+1 only for coins with positions/open orders: param=1 on, 0 off
+#define HL_GET_LATENCY         50062  // Per-stage latency: param=hl::lat::StageSummary[12] to fill, 0 = log; returns stage count
+#define HL_SAVE_LATENCY        50063  // Write per-stage latency as CSV: param=file path
+#define HL_RESET_LATENCY       50064  // Clear the latency histograms
+#define HL_SET_TRACE           50065  // Per-order lifecycle trace: param=1 record, 0 stop (keeps events)
+#define HL_SAVE_TRACE          50066  // Write recorded trace as Chrome trace JSON and clear it: param=file path
+#define HL_SET_CAPTURE         50067  // Record WS frames and HTTP traffic for offline replay: param=file path, 0 = stop
 
 // Zorro runtime function pointer (defined in hl_broker.cpp, used by BrokerAccount)
 extern "C" { extern int (*nap)(int); }
@@ -19,10 +19,36 @@
 // BrokerAsset - Get asset price and info
 //=============================================================================
 
+// Coins subscribed since the last price pass. The first price query after
+// Zorro's subscription loop waits for all of them at once, instead of each
+// getPrice waiting up to WS_FIRST_DATA_WAIT_MS in turn.
+static std::vector<std::string> s_warmupCoins;
+
+// Rollover and volume from the stored asset context — never a request on
+// Zorro's thread. The subscription pass pulls each dex once (primeAssetCtx);
+// the activeAssetCtx stream (HL_SET_ASSET_CTX_STREAM) keeps entries live.
+// Left at 0 when no context is stored.
+static void fillAssetCtx(const char* coin, double* pVolume,
+                         double* pRollLong, double* pRollShort) {
+    if (pRollLong) *pRollLong = 0;
+    if (pRollShort) *pRollShort = 0;
+    if (pVolume) *pVolume = 0;
+    if (!pRollLong && !pRollShort && !pVolume) return;
+
+    hl::AssetCtx ctx;
+    if (!hl::market::peekAssetCtx(coin, &ctx)) return;
+    hl::market::fundingToRollover(ctx, pRollLong, pRollShort);
+    if (pVolume) *pVolume = ctx.dayBaseVlm;
+}
+
 DLLFUNC int BrokerAsset(char* symbol, double* pPrice, double* pSpread,
                         double* pVolume, double* pPip, double* pPipCost,
                         double* pMinAmount, double* pMargin,
                         double* pRollLong, double* pRollShort) {
+    HL_LAT_SCOPE(BrokerAsset);
+    hl::g_logRing.drain();
+    // Zorro is reading prices: the pending WM_APP+1 has been consumed
+    if (hl::g_wsManager) static_cast<hl::ws::WebSocketManager*>(hl::g_wsManager)->acknowledgeNotify();
     if (!symbol || !*symbol) return 0;
 
     // Fatal error: halt strategy [OPM-170]
@@ -68,15 +94,16 @@ DLLFUNC int BrokerAsset(char* symbol, double* pPrice, double* pSpread,
             if (hl::g_wsManager) {
                 auto* wsMgr = static_cast<hl::ws::WebSocketManager*>(hl::g_wsManager);
                 wsMgr->subscribeL2Book(coinForApi);
+                if (hl::g_config.wsAssetCtx) wsMgr->subscribeAssetCtx(coinForApi);
+                s_warmupCoins.push_back(coinForApi);
             }
             // Set static parameters using pre-calculated values from metadata [OPM-198]
             if (pPip) *pPip = asset->tickSize;
             if (pPipCost) *pPipCost = asset->tickSize * asset->minSize;
             if (pMinAmount) *pMinAmount = asset->minSize;
             if (pMargin) *pMargin = -asset->maxLeverage;
-            if (pRollLong) *pRollLong = 0;
-            if (pRollShort) *pRollShort = 0;
-            if (pVolume) *pVolume = 0;
+            if (!hl::g_config.wsAssetCtx) hl::market::primeAssetCtx(coinForApi.c_str());
+            fillAssetCtx(coinForApi.c_str(), pVolume, pRollLong, pRollShort);
             if (hl::g_config.diagLevel >= 2)
                 hl::g_logger.logf(2, "BrokerAsset: %s subscription OK", coinForApi.c_str());
             return 1;
@@ -86,8 +113,20 @@ DLLFUNC int BrokerAsset(char* symbol, double* pPrice, double* pSpread,
         return 0;
     }
 
+    // Price query mode: warm up every coin subscribed so far in one wait
+    if (!s_warmupCoins.empty()) {
+        std::vector<std::string> coins;
+        coins.swap(s_warmupCoins);
+        DWORD waitStart = GetTickCount();
+        int ready = hl::market::waitForPrices(coins, hl::config::WS_WARMUP_WAIT_MS);
+        hl::g_logger.logf(1, "BrokerAsset: WS warm-up %d/%d coins quoted in %lums",
+                          ready, (int)coins.size(), (unsigned long)(GetTickCount() - waitStart));
+    }
+
     // Price query mode: get current price via market service
+    HL_LAT_BEGIN(lookupStart);
     hl::PriceData price = hl::market::getPrice(coinForApi.c_str());
+    HL_LAT_END(PriceLookup, lookupStart);
 
     if (price.bid <= 0 || price.ask <= 0) {
         if (hl::g_config.diagLevel >= 1) {
@@ -121,9 +160,7 @@ DLLFUNC int BrokerAsset(char* symbol, double* pPrice, double* pSpread,
         if (pMinAmount) *pMinAmount = asset->minSize;
         if (pMargin) *pMargin = -asset->maxLeverage;
     }
-    if (pRollLong) *pRollLong = 0;
-    if (pRollShort) *pRollShort = 0;
-    if (pVolume) *pVolume = 0;
+    fillAssetCtx(coinForApi.c_str(), pVolume, pRollLong, pRollShort);
 
     return 1;
 }
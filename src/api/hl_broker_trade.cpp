@@ -21,6 +21,9 @@
 
 DLLFUNC int BrokerBuy2(char* symbol, int volume, double stopDist,
                        double limit, double* pPrice, int* pFill) {
+    HL_LAT_SCOPE(BrokerBuy);
+    hl::trace::Span traceSpan("BrokerBuy2", "api");
+    traceSpan.setDetail(symbol);
     hl::g_logger.logf(1, ">>> BrokerBuy2 CALLED: sym=%s vol=%d stop=%.2f limit=%.2f",
                        symbol ? symbol : "(null)", volume, stopDist, limit);
 
@@ -127,6 +130,7 @@ DLLFUNC int BrokerBuy2(char* symbol, int volume, double stopDist,
 
     // Generate trade ID before placing order
     int tradeId = hl::trading::generateTradeId();
+    traceSpan.setOrder(tradeId);
 
     // [OPM-227] Close order: verify exchange has a position before reduce-only order.
     // With NFA mode, Zorro closes via BrokerBuy2(StopDist=-1). If the position was
@@ -146,6 +150,7 @@ DLLFUNC int BrokerBuy2(char* symbol, int volume, double stopDist,
 
     // Place order via trading service with explicit trade ID
     hl::OrderResult result = hl::trading::placeOrderWithId(request, tradeId);
+    traceSpan.setOrder(tradeId, result.cloid.c_str());
 
     if (!result.success) {
         // [OPM-227] Close rejected — position may have been closed externally
@@ -180,6 +185,11 @@ DLLFUNC int BrokerBuy2(char* symbol, int volume, double stopDist,
                                request.side == hl::OrderSide::Buy);
     }
 
+    // Traded-only notifications: quote updates for this coin wake Zorro
+    // before the account feeds report the position or resting order
+    if (hl::g_wsManager)
+        static_cast<hl::ws::WebSocketManager*>(hl::g_wsManager)->watchNotifyCoin(coinForApi);
+
     if (hl::g_config.diagLevel >= 1) {
         char msg[256];
         sprintf_s(msg, "Order placed: tradeID=%d filled=%.6f @ %.2f",
@@ -326,6 +336,17 @@ DLLFUNC int BrokerSell2(int tradeId, int amount, double limit,
 // BrokerTrade - Query trade status
 //=============================================================================
 
+// Order trace: the first BrokerTrade call that reports lots for a trade
+static void traceFillSeen(int tradeId, int lots) {
+    static int s_seen[256];     // tradeId per slot; main thread only
+    int& slot = s_seen[tradeId & 255];
+    if (slot == tradeId) return;
+    slot = tradeId;
+    char detail[32];
+    sprintf_s(detail, "lots %d", lots);
+    hl::trace::instant("BrokerTrade fill seen", "api", tradeId, nullptr, detail);
+}
+
 DLLFUNC int BrokerTrade(int tradeId, double* pOpen, double* pClose,
                         double* pRoll, double* pProfit) {
     if (!hl::g_config.walletAddress[0]) return 0;
@@ -336,211 +357,29 @@ DLLFUNC int BrokerTrade(int tradeId, double* pOpen, double* pClose,
         hl::g_logger.log(2, msg);
     }
 
-    // Get trade state
-    hl::OrderState state;
-    if (!hl::trading::getOrder(tradeId, state)) {
+    // Zorro asks for every open trade each tick; the first call of a tick
+    // evaluates all of them in one pass (see hl_trade_snapshot.h), the rest
+    // are served from that snapshot.
+    hl::trading::TradeView view = hl::trading::getTradeView(tradeId);
+
+    if (view.kind == hl::trading::TradeViewKind::Missing) {
         if (hl::g_config.diagLevel >= 2)
             hl::g_logger.log(2, "BrokerTrade: Trade not found - returning NAY");
         return NAY;
     }
 
-    // --- PENDING_ reconciliation [OPM-89] ---
-    // Orders with synthetic "PENDING_<cloid>" orderId need exchange query to
-    // determine real status.
-    if (strncmp(state.orderId, "PENDING_", 8) == 0) {
-        hl::g_logger.logf(1, "BrokerTrade: PENDING order %d (cloid=%s) — querying exchange",
-                          tradeId, state.cloid);
-
-        hl::CloidQueryResult qr = hl::trading::queryOrderByCloid(state.cloid);
-
-        if (qr.outcome == hl::QueryOutcome::Found) {
-            if (qr.oid[0]) {
-                hl::OrderState updated = state;
-                strncpy_s(updated.orderId, qr.oid, _TRUNCATE);
-                if (strcmp(qr.status, "filled") == 0) {
-                    updated.status = hl::determineFilledStatus(qr.filledSize, state.requestedSize);
-                    updated.filledSize = qr.filledSize;
-                    updated.avgPrice = qr.avgPrice;
-                } else if (strcmp(qr.status, "canceled") == 0 ||
-                           strcmp(qr.status, "siblingFilledCanceled") == 0) {  // [OPM-79]
-                    updated.status = hl::OrderStatus::Cancelled;
-                } else {
-                    updated.status = hl::OrderStatus::Open;
-                }
-                updated.lastUpdate = (double)time(NULL) / 86400.0 + 25569.0;
-                hl::trading::storeOrder(tradeId, updated);
-                state = updated;
-                hl::g_logger.logf(1, "BrokerTrade: PENDING resolved -> oid=%s status=%s",
-                                  qr.oid, qr.status);
-            }
-        } else if (qr.outcome == hl::QueryOutcome::NotFound) {
-            hl::trading::updateOrder(tradeId, 0, 0, hl::OrderStatus::Cancelled);
-            hl::g_logger.logf(1, "BrokerTrade: PENDING %d NOT_FOUND — returning NAY-1", tradeId);
-            return NAY - 1;
-        } else {
-            hl::g_logger.logf(1, "BrokerTrade: PENDING %d query FAILED — returning NAY", tradeId);
-            return NAY;
-        }
-    }
-
-    // --- RESUMED_ early return [OPM-90] ---
-    // Historical positions synced from broker on startup. No real order ID,
-    // so skip WS/HTTP lookups. Use cached entry price + live price for P&L.
-    if (strncmp(state.orderId, "RESUMED_", 8) == 0) {
-        if (pOpen) *pOpen = state.avgPrice;
+    if (view.hasOpen) {
+        if (pOpen) *pOpen = view.openPx;
         if (pRoll) *pRoll = 0;
-        if (pProfit && state.avgPrice > 0) {
-            hl::PriceData price = hl::market::getPrice(state.coin);
-            double currentPx = price.mid > 0 ? price.mid : price.ask;
-            if (currentPx > 0) {
-                double pnl = (currentPx - state.avgPrice) * state.filledSize;
-                if (state.side == hl::OrderSide::Sell) pnl = -pnl;
-                *pProfit = pnl;
-            }
-        }
-        int fillLots = (hl::g_trading.lotSize > 0)
-            ? (int)round(state.filledSize / hl::g_trading.lotSize)
-            : (int)round(state.filledSize);
-        if (fillLots < 1 && state.filledSize > 0) fillLots = 1;
-        if (hl::g_config.diagLevel >= 2)
-            hl::g_logger.logf(2, "BrokerTrade: RESUMED %d -> %d lots (%.6f)",
-                              tradeId, fillLots, state.filledSize);
-        return fillLots;
-    }
-
-    // --- IMPORTED_ live position lookup [OPM-90] ---
-    // Positions synced via GET_TRADES. Must query CURRENT position from WS
-    // cache — position may have changed due to fills from other orders.
-    if (strncmp(state.orderId, "IMPORTED_", 9) == 0) {
-        hl::account::PositionInfo livePos = hl::account::getPosition(state.coin);
-        bool importWasLong = (state.side == hl::OrderSide::Buy);
-        bool currentIsLong = (livePos.size > 0);
-
-        // Position closed or reversed direction -> trade is done
-        if (!livePos.isOpen() || (importWasLong != currentIsLong)) {
-            if (hl::g_config.diagLevel >= 1)
-                hl::g_logger.logf(1, "BrokerTrade: IMPORTED %d %s — position %s",
-                    tradeId, state.coin, !livePos.isOpen() ? "CLOSED" : "REVERSED");
-            if (pOpen) *pOpen = state.avgPrice;
-            if (pClose) *pClose = livePos.entryPrice > 0 ? livePos.entryPrice : state.avgPrice;
-            if (pRoll) *pRoll = 0;
-            if (pProfit) *pProfit = 0;
-            return 0;  // Trade closed/reversed
-        }
-
-        // Position still exists in same direction — return CURRENT size
-        double actualSize = fabs(livePos.size);
-        double entryPx = livePos.entryPrice > 0 ? livePos.entryPrice : state.avgPrice;
-        if (pOpen) *pOpen = entryPx;
-        if (pRoll) *pRoll = 0;
-        if (pProfit && entryPx > 0) {
-            hl::PriceData price = hl::market::getPrice(state.coin);
-            double currentPx = price.mid > 0 ? price.mid : price.ask;
-            if (currentPx > 0) {
-                double pnl = (currentPx - entryPx) * actualSize;
-                if (!currentIsLong) pnl = -pnl;
-                *pProfit = pnl;
-            }
-        }
-        int fillLots = (hl::g_trading.lotSize > 0)
-            ? (int)round(actualSize / hl::g_trading.lotSize)
-            : (int)round(actualSize);
-        if (fillLots < 1 && actualSize > 0) fillLots = 1;
-        if (hl::g_config.diagLevel >= 2)
-            hl::g_logger.logf(2, "BrokerTrade: IMPORTED %d -> %d lots (live=%.6f, orig=%.6f)",
-                              tradeId, fillLots, actualSize, state.filledSize);
-        return fillLots;
-    }
-
-    // --- WS PriceCache check for normal orders [OPM-90] ---
-    // Check for fills/open orders in WS cache. This catches updates that
-    // the onOrderUpdate/onFillNotify callbacks may have missed.
-    if (hl::g_config.enableWebSocket && hl::g_priceCache && state.orderId[0]) {
-        auto* cache = static_cast<hl::ws::PriceCache*>(hl::g_priceCache);
-        auto wsFills = cache->getFillsForOrder(state.orderId);
-
-        if (!wsFills.empty()) {
-            double totalFilled = 0, totalValue = 0;
-            for (const auto& fill : wsFills) {
-                totalFilled += fill.sz;
-                totalValue += fill.px * fill.sz;
-            }
-            double avgPx = totalValue / totalFilled;
-
-            if (totalFilled >= state.filledSize) {
-                hl::OrderStatus newSt = hl::determineFilledStatus(totalFilled, state.requestedSize);
-                hl::trading::updateOrder(tradeId, totalFilled, avgPx, newSt);
-                state.filledSize = totalFilled;
-                state.avgPrice = avgPx;
-            }
-        } else if (state.filledSize <= 0) {
-            auto wsOrder = cache->getOpenOrder(state.orderId);
-            if (!wsOrder.oid.empty()) {
-                if (hl::g_config.diagLevel >= 2)
-                    hl::g_logger.logf(2, "BrokerTrade: WS shows order %d still open", tradeId);
-            }
-        }
     }
-
-    // --- HTTP stale check for non-terminal orders [OPM-90, OPM-91] ---
-    // Query exchange for orders that are Open or PartialFill after staleness window.
-    // Uses 5s for unfilled, 10s for partially-filled (reduces HTTP load for GTC orders).
-    if ((state.status == hl::OrderStatus::Open || state.status == hl::OrderStatus::PartialFill)
-        && state.cloid[0] && state.lastUpdate > 0) {
-        double now = (double)time(NULL) / 86400.0 + 25569.0;
-        double ageSec = (now - state.lastUpdate) * 86400.0;
-        double staleThreshold = (state.filledSize > 0) ? 10.0 : 5.0;
-        if (ageSec > staleThreshold) {
-            hl::CloidQueryResult qr = hl::trading::queryOrderByCloid(state.cloid);
-            if (qr.outcome == hl::QueryOutcome::Found) {
-                if (strcmp(qr.status, "filled") == 0 && qr.filledSize > 0) {
-                    hl::OrderStatus newSt = hl::determineFilledStatus(qr.filledSize, state.requestedSize);
-                    hl::trading::updateOrder(tradeId, qr.filledSize, qr.avgPrice, newSt);
-                    state.filledSize = qr.filledSize;
-                    state.avgPrice = qr.avgPrice;
-                    state.status = newSt;
-                    if (qr.oid[0]) strncpy_s(state.orderId, qr.oid, _TRUNCATE);
-                    hl::g_logger.logf(1, "BrokerTrade: HTTP fallback found fill for %d", tradeId);
-                } else if (strcmp(qr.status, "canceled") == 0 ||
-                           strcmp(qr.status, "siblingFilledCanceled") == 0) {  // [OPM-79]
-                    hl::trading::updateOrder(tradeId, 0, 0, hl::OrderStatus::Cancelled);
-                    state.status = hl::OrderStatus::Cancelled;
-                } else if (qr.oid[0] && strcmp(state.orderId, qr.oid) != 0) {
-                    hl::OrderState updated = state;
-                    strncpy_s(updated.orderId, qr.oid, _TRUNCATE);
-                    updated.lastUpdate = now;
-                    hl::trading::storeOrder(tradeId, updated);
-                    state = updated;
-                }
-            }
-        }
+    if (view.hasClose && pClose) *pClose = view.closePx;
+    if (view.hasProfit && pProfit) *pProfit = view.profit;
+
+    switch (view.kind) {
+        case hl::trading::TradeViewKind::Cancelled: return NAY - 1;
+        case hl::trading::TradeViewKind::Open:
+            if (view.lots != 0 && hl::trace::enabled()) traceFillSeen(tradeId, view.lots);
+            return view.lots;
+        default:                                    return 0;  // Pending / closed
     }
-
-    // --- Generic return path ---
-    if (pOpen) *pOpen = state.avgPrice;
-    if (pRoll) *pRoll = 0;
-
-    if (pProfit && state.avgPrice > 0 && state.filledSize > 0) {
-        hl::PriceData price = hl::market::getPrice(state.coin);
-        double currentPx = price.mid > 0 ? price.mid : price.ask;
-
-        if (currentPx > 0) {
-            double pnl = (currentPx - state.avgPrice) * state.filledSize;
-            if (state.side == hl::OrderSide::Sell) pnl = -pnl;
-            *pProfit = pnl;
-        }
-    }
-
-    if (state.status == hl::OrderStatus::Cancelled) {
-        return NAY - 1;
-    }
-
-    if (state.filledSize > 0) {
-        int fillLots = (hl::g_trading.lotSize > 0)
-            ? (int)round(state.filledSize / hl::g_trading.lotSize)
-            : (int)round(state.filledSize);
-        return (fillLots > 0) ? fillLots : 1;
-    }
-
-    return 0;  // Pending order
 }
@@ -0,0 +1,54 @@
+//=============================================================================
+// hl_asset_ctx.cpp - Per-asset market context store implementation
+//=============================================================================
+// LAYER: Foundation | DEPENDENCIES: hl_asset_ctx.h
+//=============================================================================
+
+#include "hl_asset_ctx.h"
+
+namespace hl {
+
+AssetCtxStore g_assetCtx;
+
+AssetCtxStore::AssetCtxStore() {
+    InitializeCriticalSection(&cs_);
+}
+
+AssetCtxStore::~AssetCtxStore() {
+    DeleteCriticalSection(&cs_);
+}
+
+bool AssetCtxStore::set(uint32_t symbolId, const AssetCtx& ctx, AssetCtxSource source) {
+    return set(symbolId, ctx, source, GetTickCount());
+}
+
+bool AssetCtxStore::set(uint32_t symbolId, const AssetCtx& ctx, AssetCtxSource source,
+                        DWORD now) {
+    if (symbolId == 0 || symbolId >= (uint32_t)config::SYMBOL_MAX_IDS) return false;
+    AssetCtx stamped = ctx;
+    stamped.updated = now;
+    stamped.source = source;
+    EnterCriticalSection(&cs_);
+    ctx_[symbolId] = stamped;
+    LeaveCriticalSection(&cs_);
+    return true;
+}
+
+bool AssetCtxStore::get(uint32_t symbolId, AssetCtx* out, DWORD* ageMs) const {
+    if (symbolId == 0 || symbolId >= (uint32_t)config::SYMBOL_MAX_IDS) return false;
+    EnterCriticalSection(&cs_);
+    AssetCtx copy = ctx_[symbolId];
+    LeaveCriticalSection(&cs_);
+    if (copy.source == AssetCtxSource::None) return false;
+    if (out) *out = copy;
+    if (ageMs) *ageMs = GetTickCount() - copy.updated;
+    return true;
+}
+
+void AssetCtxStore::clear() {
+    EnterCriticalSection(&cs_);
+    for (int i = 0; i < config::SYMBOL_MAX_IDS; ++i) ctx_[i] = AssetCtx();
+    LeaveCriticalSection(&cs_);
+}
+
+} // namespace hl
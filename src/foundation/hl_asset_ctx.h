@@ -0,0 +1,71 @@
+//=============================================================================
+// hl_asset_ctx.h - Per-asset market context (funding, mark, oracle, OI, volume)
+//=============================================================================
+// LAYER: Foundation | DEPENDENCIES: hl_config.h, hl_symbols.h
+// THREAD SAFETY: All methods lock an internal critical section (one record
+//                copy per call, no allocation)
+//
+// Filled per dex from one metaAndAssetCtxs / spotMetaAndAssetCtxs pull
+// (hl::market, every ASSET_CTX_TTL_MS at most) or per coin from the
+// activeAssetCtx WS stream. Indexed by g_symbols id, so every asset of
+// every dex is an O(1) read once its dex has been pulled.
+//=============================================================================
+
+#pragma once
+
+#include "hl_config.h"
+#include "hl_symbols.h"
+#include "hl_platform.h"
+#include <cstdint>
+
+namespace hl {
+
+enum class AssetCtxSource : uint8_t {
+    None = 0,
+    Http,       // metaAndAssetCtxs / spotMetaAndAssetCtxs pull
+    Ws          // activeAssetCtx / activeSpotAssetCtx push
+};
+
+struct AssetCtx {
+    double funding = 0.0;       // Hourly funding rate (perps; 0 for spot)
+    double markPx = 0.0;
+    double oraclePx = 0.0;      // Perps only
+    double midPx = 0.0;
+    double prevDayPx = 0.0;
+    double openInterest = 0.0;  // In coin units (perps only)
+    double dayNtlVlm = 0.0;     // 24h volume in USDC
+    double dayBaseVlm = 0.0;    // 24h volume in coin units
+    DWORD updated = 0;          // GetTickCount() of the write
+    AssetCtxSource source = AssetCtxSource::None;
+};
+
+class AssetCtxStore {
+public:
+    AssetCtxStore();
+    ~AssetCtxStore();
+
+    AssetCtxStore(const AssetCtxStore&) = delete;
+    AssetCtxStore& operator=(const AssetCtxStore&) = delete;
+
+    /// Store ctx for a symbol id, stamped with now and source.
+    /// @return false for id 0 / out of range
+    bool set(uint32_t symbolId, const AssetCtx& ctx, AssetCtxSource source);
+
+    /// Same, stamped with the given GetTickCount() value (time injection)
+    bool set(uint32_t symbolId, const AssetCtx& ctx, AssetCtxSource source, DWORD now);
+
+    /// Copy of the symbol's context and its age in ms.
+    /// @return false if never set
+    bool get(uint32_t symbolId, AssetCtx* out, DWORD* ageMs = nullptr) const;
+
+    /// Forget every context (logout)
+    void clear();
+
+private:
+    AssetCtx ctx_[config::SYMBOL_MAX_IDS];
+    mutable CRITICAL_SECTION cs_;
+};
+
+extern AssetCtxStore g_assetCtx;
+
+} // namespace hl
@@ -36,6 +36,23 @@ constexpr int WS_RECEIVE_TIMEOUT_MS    = 1000;   // 1s receive timeout (polling
 constexpr int WS_PING_INTERVAL_MS      = 20000;  // 20s keepalive ping interval
 constexpr int WS_ORDER_RESPONSE_TIMEOUT_MS = 5000;  // 5s order response timeout
 constexpr int WS_HEALTH_THRESHOLD_SEC  = 60;     // Consider unhealthy after 60s silence
+constexpr int WS_MAX_MARKET_CONNECTIONS = 8;     // Upper bound for the l2Book connection pool
+constexpr int WS_SUB_RATE_PER_SEC      = 20;     // l2Book subscribe frames per second per connection
+constexpr int WS_SUB_BURST             = 10;     // Back-to-back subscribe frames allowed after idle
+constexpr int WS_SUB_ACK_TIMEOUT_MS    = 5000;   // Resend a subscription not acked within 5s
+constexpr int WS_SUB_MAX_ATTEMPTS      = 5;      // Give up after 5 ack timeouts in a row
+
+// Shared-memory price table (one publishing process, any number of readers)
+constexpr char SHM_PRICES_NAME[]       = "Local\\HyperliquidZorro.Prices";  // + ".mainnet" / ".testnet"
+constexpr int SHM_PRICE_SLOTS          = 1024;   // Coins in the table, all dexes
+constexpr int SHM_PUBLISHER_STALE_MS   = 3000;   // Readers ignore a publisher silent this long
+constexpr int SHM_TAKEOVER_CHECK_MS    = 1000;   // How often a reader tries to become publisher
+constexpr int SHM_WAIT_POLL_MS         = 5;      // First-quote wait poll for coins read from the table
+
+// Zorro GUI notifications (WM_APP+1, at most one in flight)
+constexpr int NOTIFY_REARM_MS          = 1000;   // Post again if Zorro has not consumed the last one
+constexpr int NOTIFY_WATCH_REFRESH_MS  = 1000;   // Traded-only filter: rescan positions/open orders
+constexpr int NOTIFY_ORDER_WATCH_MS    = 10000;  // Coin of a just-placed order notifies this long
 
 // =============================================================================
 // CACHE SETTINGS
@@ -45,11 +62,36 @@ constexpr int WS_HEALTH_THRESHOLD_SEC  = 60;     // Consider unhealthy after 60s
 constexpr int PRICE_STALE_MS           = 5000;   // Price considered stale after 5s
 constexpr int PRICE_MAX_AGE_HTTP_MS    = 1500;   // Max age before HTTP fallback
 constexpr int WS_FIRST_DATA_WAIT_MS    = 300;    // Max wait for WS data on first query [OPM-142]
+constexpr int WS_WARMUP_WAIT_MS        = 2000;   // Max wait for all subscribed coins on first price pass
+
+// userFills aggregation / fill store
+constexpr int WS_FILL_CAPACITY         = 1000;   // Fills kept in PriceCache (basket partial fills)
+constexpr int FILL_AGG_RETIRED_MEMORY  = 4096;   // Retired oids remembered to ignore late fills
+constexpr int FILL_AGG_IDLE_RETIRE_MS  = 600000; // No fill for 10 min: park open orders, retire closed ones
+constexpr int FILL_AGG_RETIRE_CHECK_MS = 60000;  // How often to sweep idle orders
 
 // Position/account cache
 constexpr int POSITION_CACHE_MS        = 2000;   // 2s cache for clearinghouseState
 constexpr int ORDERS_CACHE_MS          = 1000;   // 1s cache for openOrders
 
+// Order reconciliation (push feed authoritative; HTTP only on gaps/staleness)
+constexpr int ORDER_SYNC_SCAN_MS       = 1000;   // Due-order scan at most once per second
+constexpr int ORDER_RECONCILE_INTERVAL_MS = 5000;  // At most one batch per 5s
+constexpr int ORDER_PENDING_GRACE_MS   = 3000;   // Wait for a push before querying a PENDING_ order
+constexpr int ORDER_STALE_OPEN_MS      = 5000;   // Feed down: poll unfilled orders after 5s
+constexpr int ORDER_STALE_PARTIAL_MS   = 10000;  // Feed down: poll partial fills after 10s
+
+// BrokerTrade per-tick snapshot
+constexpr int TRADE_SNAPSHOT_MAX_AGE_MS = 250;   // Recompute if a tick's pass takes longer
+
+// yyjson parse pools (one per parsing thread, reused for every document)
+constexpr int JSON_POOL_INITIAL_BYTES  = 64 * 1024;        // First pool of a thread
+constexpr int JSON_POOL_MAX_BYTES      = 4 * 1024 * 1024;  // Larger documents (meta) use the heap
+
+// Asset contexts (funding, mark, oracle, volume): one pull per dex serves every asset
+constexpr int ASSET_CTX_TTL_MS         = 60000;  // getAssetCtx re-pulls a dex after 60s (not BrokerAsset)
+constexpr int ASSET_CTX_RETRY_MS       = 5000;   // Min time between pulls of the same dex
+
 // Metadata cache
 constexpr int META_CACHE_SECONDS       = 300;    // 5 minutes for asset metadata
 
@@ -71,7 +113,13 @@ constexpr double MARKET_ORDER_SLIPPAGE  = 0.05;   // 5%
 
 constexpr int MAX_ASSETS               = 1024;   // Maximum supported assets
 constexpr int MAX_PENDING_ORDERS       = 100;    // Maximum concurrent pending orders
-constexpr int MAX_RECENT_FILLS         = 100;    // Recent fills to keep in cache
+constexpr int TRADE_ARCHIVE_MAX        = 10000;  // Cancelled/Error orders kept for lookups (oldest evicted)
+constexpr int SYMBOL_MAX_IDS           = 4096;   // Interned coins (ids 1..4095, never reused)
+constexpr int SYMBOL_TABLE_SLOTS       = 8192;   // Coin forms incl. aliases (power of 2, filled to 3/4)
+constexpr int LOG_RING_CAPACITY        = 2048;   // Deferred log records (power of 2, 512 bytes each)
+constexpr int LATENCY_MAX_THREADS      = 16;     // Threads with their own latency slab (rest share one)
+constexpr int LATENCY_ORDER_SLOTS      = 256;    // Orders tracked for FirstFill (power of 2)
+constexpr int TRACE_CAPACITY           = 8192;   // Order-trace events kept (power of 2, oldest overwritten)
 
 // =============================================================================
 // PLUGIN INFO
@@ -7,10 +7,11 @@
 
 #include "hl_crypto.h"
 
+#include <atomic>
 #include <cstring>
 #include <cstdio>
 #include <cstdlib>
-#include <windows.h>  // SecureZeroMemory (cannot be optimized away)
+#include "hl_platform.h"  // SecureZeroMemory (cannot be optimized away)
 
 // secp256k1 library (bundled header-only version)
 // Enable recovery module for Ethereum-style signatures
@@ -32,6 +33,10 @@ namespace crypto {
 
 static secp256k1_context* s_ctx = nullptr;
 
+// Verify-capable context for recoverAddress, built on first use: signing
+// never needs its multiplication tables
+static std::atomic<secp256k1_context*> s_verifyCtx(nullptr);
+
 // =============================================================================
 // INITIALIZATION
 // =============================================================================
@@ -50,6 +55,20 @@ void cleanup() {
         secp256k1_context_destroy(s_ctx);
         s_ctx = nullptr;
     }
+    secp256k1_context* verify = s_verifyCtx.exchange(nullptr);
+    if (verify) secp256k1_context_destroy(verify);
+}
+
+// Racing first callers each build one; the loser destroys its own
+static secp256k1_context* verifyContext() {
+    secp256k1_context* ctx = s_verifyCtx.load(std::memory_order_acquire);
+    if (ctx) return ctx;
+    secp256k1_context* created = secp256k1_context_create(SECP256K1_CONTEXT_VERIFY);
+    if (!created) return nullptr;
+    if (s_verifyCtx.compare_exchange_strong(ctx, created, std::memory_order_acq_rel))
+        return created;
+    secp256k1_context_destroy(created);
+    return ctx;
 }
 
 bool isInitialized() {
@@ -90,6 +109,25 @@ static bool parsePrivateKey(const char* hexKey, uint8_t* out) {
     return true;
 }
 
+// Ethereum address of a public key: keccak256(pubkey[1:65])[-20:]
+static void formatAddress(const secp256k1_pubkey& pubkey, char* addressOut, size_t addressOutSize) {
+    // Serialize to uncompressed format (65 bytes: 0x04 prefix + 64 bytes)
+    uint8_t pubkey_serialized[65];
+    size_t pubkey_len = 65;
+    secp256k1_ec_pubkey_serialize(s_ctx, pubkey_serialized, &pubkey_len,
+                                   &pubkey, SECP256K1_EC_UNCOMPRESSED);
+
+    // Hash the 64-byte public key (skip the 0x04 prefix)
+    uint8_t hash[32];
+    ::keccak256(pubkey_serialized + 1, 64, hash);
+
+    // Format address: take last 20 bytes of hash
+    snprintf(addressOut, addressOutSize, "0x");
+    for (int i = 12; i < 32; i++) {
+        snprintf(addressOut + 2 + (i - 12) * 2, 3, "%02x", hash[i]);
+    }
+}
+
 // =============================================================================
 // ADDRESS DERIVATION
 // =============================================================================
@@ -120,22 +158,7 @@ bool deriveAddress(const char* privateKeyHex, char* addressOut, size_t addressOu
         return false;
     }
 
-    // Serialize to uncompressed format (65 bytes: 0x04 prefix + 64 bytes)
-    uint8_t pubkey_serialized[65];
-    size_t pubkey_len = 65;
-    secp256k1_ec_pubkey_serialize(s_ctx, pubkey_serialized, &pubkey_len,
-                                   &pubkey, SECP256K1_EC_UNCOMPRESSED);
-
-    // Ethereum address = keccak256(pubkey[1:65])[-20:]
-    // Hash the 64-byte public key (skip the 0x04 prefix)
-    uint8_t hash[32];
-    ::keccak256(pubkey_serialized + 1, 64, hash);
-
-    // Format address: take last 20 bytes of hash
-    snprintf(addressOut, addressOutSize, "0x");
-    for (int i = 12; i < 32; i++) {
-        snprintf(addressOut + 2 + (i - 12) * 2, 3, "%02x", hash[i]);
-    }
+    formatAddress(pubkey, addressOut, addressOutSize);
 
     // Clear sensitive data
     SecureZeroMemory(privkey, sizeof(privkey));
@@ -224,6 +247,47 @@ bool signHashToJson(const uint8_t* hash, const char* privateKeyHex,
     return true;
 }
 
+bool recoverAddress(const uint8_t* hash, const Signature& sig,
+                    char* addressOut, size_t addressOutSize) {
+    if (!s_ctx) {
+        return false;
+    }
+
+    if (!hash || !addressOut || addressOutSize < 43) {
+        return false;
+    }
+
+    // r || s back into the 64-byte compact form
+    uint8_t compact[64];
+    if (hexToBytes(sig.r, compact, 32) != 32 || hexToBytes(sig.s, compact + 32, 32) != 32) {
+        return false;
+    }
+
+    // Ethereum v = recid + 27 (accept a raw 0/1 as well)
+    int recid = sig.v >= 27 ? sig.v - 27 : sig.v;
+    if (recid < 0 || recid > 3) {
+        return false;
+    }
+
+    secp256k1_context* verify = verifyContext();
+    if (!verify) {
+        return false;
+    }
+
+    secp256k1_ecdsa_recoverable_signature rsig;
+    if (!secp256k1_ecdsa_recoverable_signature_parse_compact(verify, &rsig, compact, recid)) {
+        return false;
+    }
+
+    secp256k1_pubkey pubkey;
+    if (!secp256k1_ecdsa_recover(verify, &pubkey, &rsig, hash)) {
+        return false;
+    }
+
+    formatAddress(pubkey, addressOut, addressOutSize);
+    return true;
+}
+
 // =============================================================================
 // UTILITY FUNCTIONS
 // =============================================================================
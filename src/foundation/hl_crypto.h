@@ -86,6 +86,16 @@ bool signHash(const uint8_t* hash, const char* privateKeyHex, Signature& sigOut)
 bool signHashToJson(const uint8_t* hash, const char* privateKeyHex,
                     char* jsonOut, size_t jsonOutSize);
 
+/// Recover the signer address of a signature (the check an exchange does).
+/// Uses its own verify context, created on the first call.
+/// @param hash           32-byte hash that was signed
+/// @param sig            Signature as produced by signHash (v = 27/28)
+/// @param addressOut     Buffer to receive the address (minimum 43 bytes)
+/// @param addressOutSize Size of addressOut buffer
+/// @return true on success, false for a malformed signature
+bool recoverAddress(const uint8_t* hash, const Signature& sig,
+                    char* addressOut, size_t addressOutSize);
+
 // =============================================================================
 // UTILITY FUNCTIONS
 // =============================================================================
@@ -0,0 +1,83 @@
+//=============================================================================
+// hl_decimal.cpp - Decimal string <-> double kernels implementation
+//=============================================================================
+// LAYER: Foundation | DEPENDENCIES: hl_decimal.h
+//=============================================================================
+
+#include "hl_decimal.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace hl {
+namespace decimal {
+
+static const uint64_t POW10_INT[16] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL,
+    100000000ULL, 1000000000ULL, 10000000000ULL, 100000000000ULL,
+    1000000000000ULL, 10000000000000ULL, 100000000000000ULL, 1000000000000000ULL
+};
+
+static const double TWO_POW_52 = 4503599627370496.0;
+
+// Digits of v (no sign) into out, returns count
+static int writeUint(uint64_t v, char* out) {
+    char tmp[20];
+    int n = 0;
+    do {
+        tmp[n++] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v);
+    for (int i = 0; i < n; i++) out[i] = tmp[n - 1 - i];
+    return n;
+}
+
+int formatFixed(double value, int decimals, char* out, size_t outSize) {
+    if (!out || outSize == 0) return -1;
+    if (decimals < 0) decimals = 0;
+    if (decimals > 15) decimals = 15;
+
+    double scaled = fabs(value) * detail::pow10()[decimals];
+    if (std::isfinite(value) && scaled < TWO_POW_52) {
+        double whole = floor(scaled);
+        double rest = scaled - whole;                   // Exact below 2^52
+        // scaled is within scaled*2^-53 of the exact product; away from a
+        // .5 tie by more than that, rounding the exact value gives the same
+        if (fabs(rest - 0.5) > scaled * (1.0 / TWO_POW_52)) {
+            uint64_t q = (uint64_t)whole + (rest > 0.5 ? 1 : 0);
+            char buf[MAX_FIXED_CHARS];
+            int n = 0;
+            if (std::signbit(value)) buf[n++] = '-';    // printf keeps "-0.00"
+            n += writeUint(q / POW10_INT[decimals], buf + n);
+            if (decimals > 0) {
+                uint64_t frac = q % POW10_INT[decimals];
+                buf[n++] = '.';
+                for (int i = decimals - 1; i >= 0; i--) {
+                    buf[n + i] = (char)('0' + frac % 10);
+                    frac /= 10;
+                }
+                n += decimals;
+            }
+            if ((size_t)n >= outSize) return -1;
+            memcpy(out, buf, (size_t)n);
+            out[n] = '\0';
+            return n;
+        }
+    }
+
+    int n = snprintf(out, outSize, "%.*f", decimals, value);
+    if (n < 0 || (size_t)n >= outSize) return -1;
+    return n;
+}
+
+int formatTrimmed(double value, int decimals, char* out, size_t outSize) {
+    int n = formatFixed(value, decimals, out, outSize);
+    if (n <= 0 || !memchr(out, '.', (size_t)n)) return n;
+    while (n > 0 && out[n - 1] == '0') n--;
+    if (n > 0 && out[n - 1] == '.') n--;
+    out[n] = '\0';
+    return n;
+}
+
+} // namespace decimal
+} // namespace hl
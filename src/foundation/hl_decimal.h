@@ -0,0 +1,85 @@
+//=============================================================================
+// hl_decimal.h - Decimal string <-> double kernels for px/sz fields
+//=============================================================================
+// LAYER: Foundation | DEPENDENCIES: None | THREAD SAFETY: All functions safe
+//
+// Hyperliquid encodes every price and size as a short decimal string
+// ("50000.5", "0.00123") and expects the same back in orders. These
+// kernels handle that shape with integer arithmetic and fall back to the
+// C runtime for anything else, so results are identical to strtod and
+// printf("%.*f"):
+//   parse()      - up to 15 significant digits and 22 decimals is one exact
+//                  int->double conversion and one correctly rounded divide;
+//                  exponents, whitespace, inf/nan or longer input -> strtod
+//   formatFixed  - value * 10^decimals rounded to an integer; values that
+//                  land within rounding error of a .5 tie, or need more than
+//                  53 bits, go through snprintf
+//=============================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+
+namespace hl {
+namespace decimal {
+
+// Longest formatFixed output (-DBL_MAX with 15 decimals) incl. terminator
+constexpr int MAX_FIXED_CHARS = 330;
+
+namespace detail {
+// 10^0..10^22, every one exactly representable as a double
+inline const double* pow10() {
+    static const double TABLE[23] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    return TABLE;
+}
+} // namespace detail
+
+/// Parse a decimal number string. Same result as strtod(s, nullptr);
+/// returns 0.0 for nullptr or text without a number.
+inline double parse(const char* s) {
+    if (!s) return 0.0;
+    const char* p = s;
+    bool neg = false;
+    if (*p == '-') { neg = true; p++; }
+
+    uint64_t mant = 0;
+    int sig = 0;        // Significant digits in mant
+    int frac = 0;       // Digits after the point
+    bool any = false;
+    for (; *p >= '0' && *p <= '9'; p++) {
+        any = true;
+        if (mant == 0 && *p == '0') continue;
+        if (++sig > 15) return strtod(s, nullptr);
+        mant = mant * 10 + (uint64_t)(*p - '0');
+    }
+    if (*p == '.') {
+        for (p++; *p >= '0' && *p <= '9'; p++) {
+            any = true;
+            if (++frac > 22) return strtod(s, nullptr);
+            if (mant == 0 && *p == '0') continue;
+            if (++sig > 15) return strtod(s, nullptr);
+            mant = mant * 10 + (uint64_t)(*p - '0');
+        }
+    }
+    if (!any || *p != '\0') return strtod(s, nullptr);
+
+    // mant < 10^15 < 2^53 and 10^frac are exact doubles: one rounding step
+    double v = (double)mant / detail::pow10()[frac];
+    return neg ? -v : v;
+}
+
+/// Write value with exactly `decimals` (0..15) digits after the point, as
+/// printf("%.*f") does. Returns the length, or -1 if out is too small.
+int formatFixed(double value, int decimals, char* out, size_t outSize);
+
+/// formatFixed, then strip trailing zeros and a trailing point if the
+/// output has a fractional part ("0.10000000" -> "0.1", "2.000" -> "2").
+int formatTrimmed(double value, int decimals, char* out, size_t outSize);
+
+} // namespace decimal
+} // namespace hl
@@ -8,6 +8,7 @@
 #include "hl_eip712.h"
 #include "hl_crypto.h"
 #include "hl_msgpack.h"
+#include "hl_decimal.h"
 
 #include <sstream>
 #include <iomanip>
@@ -15,7 +16,7 @@
 #include <cstdio>
 
 #ifdef _WIN32
-#include <windows.h>
+#include "hl_platform.h"
 #else
 #include <sys/time.h>
 #endif
@@ -109,25 +110,10 @@ std::string normalizeOrderType(const std::string& tif) {
 // =============================================================================
 
 std::string formatNumber(double value) {
-    char buf[32];
-    snprintf(buf, sizeof(buf), "%.8f", value);
-
-    std::string s(buf);
-
-    // Remove trailing zeros after decimal point
-    size_t dot = s.find('.');
-    if (dot != std::string::npos) {
-        size_t end = s.find_last_not_of('0');
-        if (end != std::string::npos) {
-            s = s.substr(0, end + 1);
-        }
-        // Remove trailing decimal point
-        if (!s.empty() && s.back() == '.') {
-            s.pop_back();
-        }
-    }
-
-    return s;
+    // "%.8f" without trailing zeros / trailing decimal point
+    char buf[decimal::MAX_FIXED_CHARS];
+    int n = decimal::formatTrimmed(value, 8, buf, sizeof(buf));
+    return n < 0 ? std::string() : std::string(buf, n);
 }
 
 ByteArray hexToBytes(const std::string& hex) {
@@ -5,7 +5,6 @@
 //=============================================================================
 
 #include "hl_globals.h"
-#include <cstdarg>
 #include <cstdio>
 #include <cstring>
 
@@ -89,12 +88,27 @@ const AssetInfo* AssetRegistry::getByIndex(int idx) const {
 }
 
 bool AssetRegistry::add(const AssetInfo& info) {
+    // Every form of the coin resolves to one symbol id: the API coin
+    // ("BTC", "xyz:GOLD", "@107"), "xyz_GOLD" and the display name
+    uint32_t symbolId;
+    if (info.isPerpDex && info.perpDex[0]) {
+        char form[80];
+        sprintf_s(form, "%s:%s", info.perpDex, info.coin);
+        symbolId = g_symbols.intern(form);
+        sprintf_s(form, "%s_%s", info.perpDex, info.coin);
+        g_symbols.alias(form, symbolId);
+    } else {
+        symbolId = g_symbols.intern(info.coin);
+    }
+    g_symbols.alias(info.name, symbolId);
+
     if (csInit) EnterCriticalSection(&cs);
     if (count >= config::MAX_ASSETS) {
         if (csInit) LeaveCriticalSection(&cs);
         return false;
     }
-    assets[count++] = info;
+    assets[count] = info;
+    assets[count++].symbolId = symbolId;
     if (csInit) LeaveCriticalSection(&cs);
     return true;
 }
@@ -114,12 +128,22 @@ void TradingState::init() {
     httpRequestId = 0;
     lotSize = 1.0;
     tradeMap.clear();
+    tradeFilled.clear();
+    tradeArchive.clear();
+    tradeCold.clear();
+    cloidIndex.clear();
+    oidIndex.clear();
 }
 
 void TradingState::cleanup() {
     if (tradeCsInit) {
         EnterCriticalSection(&tradeCs);
         tradeMap.clear();
+        tradeFilled.clear();
+        tradeArchive.clear();
+        tradeCold.clear();
+        cloidIndex.clear();
+        oidIndex.clear();
         LeaveCriticalSection(&tradeCs);
         DeleteCriticalSection(&tradeCs);
         tradeCsInit = false;
@@ -148,29 +172,284 @@ uint64_t TradingState::generateNonce() {
     return desired;
 }
 
+static bool isTerminal(OrderStatus status) {
+    return status == OrderStatus::Filled || status == OrderStatus::Cancelled ||
+           status == OrderStatus::Error;
+}
+
+// --- Compact encodings (must round-trip exactly, else the string goes cold) ---
+
+// Canonical decimal exchange oid: no sign, no leading zero, fits 64 bits
+static bool parseOid(const char* s, uint64_t& out) {
+    if (!s || s[0] < '1' || s[0] > '9') return false;
+    uint64_t v = 0;
+    int n = 0;
+    for (; s[n]; n++) {
+        if (s[n] < '0' || s[n] > '9' || n >= 19) return false;
+        v = v * 10 + (uint64_t)(s[n] - '0');
+    }
+    out = v;
+    return true;
+}
+
+static int hexDigit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;  // Uppercase would not round-trip
+}
+
+// "0x" + exactly 32 lowercase hex digits (generateCloid format)
+static bool parseCloid(const char* s, uint64_t& hi, uint64_t& lo) {
+    if (!s || s[0] != '0' || s[1] != 'x') return false;
+    uint64_t h = 0, l = 0;
+    for (int i = 0; i < 32; i++) {
+        int d = hexDigit(s[2 + i]);
+        if (d < 0) return false;
+        if (i < 16) h = (h << 4) | (uint64_t)d;
+        else        l = (l << 4) | (uint64_t)d;
+    }
+    if (s[34] != 0) return false;
+    hi = h;
+    lo = l;
+    return true;
+}
+
+bool TradingState::formatOid(const OrderRecord& rec, char* out, size_t outSize) {
+    if (rec.oidKind != OidKind::Exchange || outSize < 21) return false;
+    char tmp[21];
+    int n = 0;
+    uint64_t v = rec.oid;
+    do { tmp[n++] = (char)('0' + v % 10); v /= 10; } while (v);
+    for (int i = 0; i < n; i++) out[i] = tmp[n - 1 - i];
+    out[n] = 0;
+    return true;
+}
+
+bool TradingState::formatCloid(const OrderRecord& rec, char* out, size_t outSize) {
+    static const char HEX[] = "0123456789abcdef";
+    if (rec.cloidKind != CloidKind::Hex128 || outSize < 35) return false;
+    out[0] = '0';
+    out[1] = 'x';
+    for (int i = 0; i < 16; i++) {
+        out[2 + i]  = HEX[(rec.cloidHi >> (60 - 4 * i)) & 0xF];
+        out[18 + i] = HEX[(rec.cloidLo >> (60 - 4 * i)) & 0xF];
+    }
+    out[34] = 0;
+    return true;
+}
+
+// --- Internals (caller holds tradeCs) ---
+
+OrderRecord* TradingState::findLocked(int tradeId) {
+    auto it = tradeMap.find(tradeId);
+    if (it != tradeMap.end()) return &it->second;
+    it = tradeFilled.find(tradeId);
+    if (it != tradeFilled.end()) return &it->second;
+    it = tradeArchive.find(tradeId);
+    if (it != tradeArchive.end()) return &it->second;
+    return nullptr;
+}
+
+const OrderRecord* TradingState::findLocked(int tradeId) const {
+    return const_cast<TradingState*>(this)->findLocked(tradeId);
+}
+
+void TradingState::encodeLocked(int tradeId, const OrderState& state, OrderRecord& rec) {
+    rec = OrderRecord();
+    OrderCold cold;
+    bool needCold = false;
+
+    if (state.orderId[0]) {
+        if (parseOid(state.orderId, rec.oid)) {
+            rec.oidKind = OidKind::Exchange;
+        } else {
+            rec.oidKind = OidKind::Text;
+            cold.oid = state.orderId;
+            needCold = true;
+        }
+    }
+    if (state.cloid[0]) {
+        if (parseCloid(state.cloid, rec.cloidHi, rec.cloidLo)) {
+            rec.cloidKind = CloidKind::Hex128;
+        } else {
+            rec.cloidKind = CloidKind::Text;
+            cold.cloid = state.cloid;
+            needCold = true;
+        }
+    }
+    if (state.lastError[0]) {
+        cold.lastError = state.lastError;
+        needCold = true;
+    }
+    if (state.zorroTradeId != tradeId) needCold = true;
+    cold.zorroTradeId = state.zorroTradeId;
+
+    rec.requestedSize = state.requestedSize;
+    rec.filledSize = state.filledSize;
+    rec.avgPrice = state.avgPrice;
+    rec.lastUpdate = state.lastUpdate;
+    rec.coinId = (uint16_t)g_symbols.intern(state.coin);
+    rec.side = (uint8_t)state.side;
+    rec.status = (uint8_t)state.status;
+
+    if (needCold) tradeCold[tradeId] = cold;
+    else tradeCold.erase(tradeId);
+}
+
+void TradingState::decodeLocked(int tradeId, const OrderRecord& rec, OrderState& out) const {
+    out = OrderState();
+    auto cold = tradeCold.find(tradeId);
+    bool hasCold = (cold != tradeCold.end());
+
+    if (rec.oidKind == OidKind::Exchange)
+        formatOid(rec, out.orderId, sizeof(out.orderId));
+    else if (rec.oidKind == OidKind::Text && hasCold)
+        strncpy_s(out.orderId, cold->second.oid.c_str(), _TRUNCATE);
+
+    if (rec.cloidKind == CloidKind::Hex128)
+        formatCloid(rec, out.cloid, sizeof(out.cloid));
+    else if (rec.cloidKind == CloidKind::Text && hasCold)
+        strncpy_s(out.cloid, cold->second.cloid.c_str(), _TRUNCATE);
+
+    strncpy_s(out.coin, g_symbols.name(rec.coinId), _TRUNCATE);
+    out.side = rec.orderSide();
+    out.requestedSize = rec.requestedSize;
+    out.filledSize = rec.filledSize;
+    out.avgPrice = rec.avgPrice;
+    out.status = rec.orderStatus();
+    out.zorroTradeId = hasCold ? cold->second.zorroTradeId : tradeId;
+    out.lastUpdate = rec.lastUpdate;
+    if (hasCold && !cold->second.lastError.empty())
+        strncpy_s(out.lastError, cold->second.lastError.c_str(), _TRUNCATE);
+}
+
+std::string TradingState::oidKeyLocked(int tradeId, const OrderRecord& rec) const {
+    if (rec.oidKind == OidKind::Exchange) {
+        char buf[24];
+        formatOid(rec, buf, sizeof(buf));
+        return buf;
+    }
+    if (rec.oidKind == OidKind::Text) {
+        auto cold = tradeCold.find(tradeId);
+        if (cold != tradeCold.end()) return cold->second.oid;
+    }
+    return std::string();
+}
+
+std::string TradingState::cloidKeyLocked(int tradeId, const OrderRecord& rec) const {
+    if (rec.cloidKind == CloidKind::Hex128) {
+        char buf[40];
+        formatCloid(rec, buf, sizeof(buf));
+        return buf;
+    }
+    if (rec.cloidKind == CloidKind::Text) {
+        auto cold = tradeCold.find(tradeId);
+        if (cold != tradeCold.end()) return cold->second.cloid;
+    }
+    return std::string();
+}
+
+void TradingState::indexLocked(int tradeId, const OrderRecord& rec) {
+    std::string key = cloidKeyLocked(tradeId, rec);
+    if (!key.empty()) cloidIndex[key] = tradeId;
+    key = oidKeyLocked(tradeId, rec);
+    if (!key.empty()) oidIndex[key] = tradeId;
+}
+
+// Drop index entries that still point at this trade (a newer trade may
+// have taken over the key, e.g. a reused cloid)
+void TradingState::unindexLocked(int tradeId, const OrderRecord& rec) {
+    std::string key = cloidKeyLocked(tradeId, rec);
+    if (!key.empty()) {
+        auto it = cloidIndex.find(key);
+        if (it != cloidIndex.end() && it->second == tradeId) cloidIndex.erase(it);
+    }
+    key = oidKeyLocked(tradeId, rec);
+    if (!key.empty()) {
+        auto it = oidIndex.find(key);
+        if (it != oidIndex.end() && it->second == tradeId) oidIndex.erase(it);
+    }
+}
+
+void TradingState::eraseLocked(int tradeId) {
+    const OrderRecord* old = findLocked(tradeId);
+    if (!old) return;
+    unindexLocked(tradeId, *old);   // Before tradeCold: text keys live there
+    tradeCold.erase(tradeId);
+    tradeMap.erase(tradeId);
+    tradeFilled.erase(tradeId);
+    tradeArchive.erase(tradeId);
+}
+
+// Cancelled/Error orders past the archive limit are dropped oldest first
+void TradingState::trimArchiveLocked() {
+    while (tradeArchive.size() > (size_t)config::TRADE_ARCHIVE_MAX) {
+        auto oldest = tradeArchive.begin();
+        unindexLocked(oldest->first, oldest->second);
+        tradeCold.erase(oldest->first);
+        tradeArchive.erase(oldest);
+    }
+}
+
+// Tier holding records of this status
+std::map<int, OrderRecord>& TradingState::tierLocked(OrderStatus status) {
+    if (status == OrderStatus::Filled) return tradeFilled;
+    return isTerminal(status) ? tradeArchive : tradeMap;
+}
+
+// Move between tiers when a field update changes the tier (the common
+// fill/progress update does not)
+void TradingState::retierLocked(int tradeId, OrderStatus oldStatus, OrderStatus newStatus) {
+    auto& from = tierLocked(oldStatus);
+    auto& to = tierLocked(newStatus);
+    if (&from == &to) return;
+
+    auto it = from.find(tradeId);
+    if (it == from.end()) return;
+    to[tradeId] = it->second;
+    from.erase(it);
+    if (&to == &tradeArchive) trimArchiveLocked();
+}
+
+// Store in the tier matching the status and re-index
+void TradingState::placeLocked(int tradeId, const OrderState& state) {
+    const OrderRecord* old = findLocked(tradeId);
+    uint16_t syncEpoch = old ? old->syncEpoch : 0;   // Not part of OrderState
+    eraseLocked(tradeId);
+
+    OrderRecord rec;
+    encodeLocked(tradeId, state, rec);
+    rec.syncEpoch = syncEpoch;
+    auto& tier = tierLocked(state.status);
+    tier[tradeId] = rec;
+    indexLocked(tradeId, rec);
+
+    if (&tier == &tradeArchive) trimArchiveLocked();
+}
+
+// --- Full-state access ---
+
 void TradingState::setOrder(int tradeId, const OrderState& state) {
     if (!tradeCsInit) return;
     EnterCriticalSection(&tradeCs);
-    tradeMap[tradeId] = state;
+    placeLocked(tradeId, state);
     LeaveCriticalSection(&tradeCs);
 }
 
 bool TradingState::getOrder(int tradeId, OrderState& out) const {
     if (!tradeCsInit) return false;
     EnterCriticalSection(&tradeCs);
-    auto it = tradeMap.find(tradeId);
-    bool found = (it != tradeMap.end());
-    if (found) out = it->second;
+    const OrderRecord* rec = findLocked(tradeId);
+    if (rec) decodeLocked(tradeId, *rec, out);
     LeaveCriticalSection(&tradeCs);
-    return found;
+    return rec != nullptr;
 }
 
 bool TradingState::updateOrder(int tradeId, const OrderState& state) {
     if (!tradeCsInit) return false;
     EnterCriticalSection(&tradeCs);
-    auto it = tradeMap.find(tradeId);
-    bool found = (it != tradeMap.end());
-    if (found) it->second = state;
+    bool found = findLocked(tradeId) != nullptr;
+    if (found) placeLocked(tradeId, state);
     LeaveCriticalSection(&tradeCs);
     return found;
 }
@@ -178,10 +457,226 @@ bool TradingState::updateOrder(int tradeId, const OrderState& state) {
 void TradingState::removeOrder(int tradeId) {
     if (!tradeCsInit) return;
     EnterCriticalSection(&tradeCs);
-    tradeMap.erase(tradeId);
+    eraseLocked(tradeId);
     LeaveCriticalSection(&tradeCs);
 }
 
+// --- Hot record access ---
+
+bool TradingState::getRecord(int tradeId, OrderRecord& out) const {
+    if (!tradeCsInit) return false;
+    EnterCriticalSection(&tradeCs);
+    const OrderRecord* rec = findLocked(tradeId);
+    if (rec) out = *rec;
+    LeaveCriticalSection(&tradeCs);
+    return rec != nullptr;
+}
+
+std::vector<std::pair<int, OrderRecord>> TradingState::getRecords(
+        const std::vector<int>& tradeIds) const {
+    std::vector<std::pair<int, OrderRecord>> out;
+    if (!tradeCsInit) return out;
+    out.reserve(tradeIds.size());
+    EnterCriticalSection(&tradeCs);
+    for (int id : tradeIds) {
+        const OrderRecord* rec = findLocked(id);
+        if (rec) out.emplace_back(id, *rec);
+    }
+    LeaveCriticalSection(&tradeCs);
+    return out;
+}
+
+const char* TradingState::coinName(uint16_t coinId) const {
+    return g_symbols.name(coinId);
+}
+
+bool TradingState::applyFill(int tradeId, double filledSize, double avgPrice,
+                             OrderStatus status, double now) {
+    if (!tradeCsInit) return false;
+    EnterCriticalSection(&tradeCs);
+    OrderRecord* rec = findLocked(tradeId);
+    if (rec) {
+        OrderStatus old = rec->orderStatus();
+        rec->filledSize = filledSize;
+        rec->avgPrice = avgPrice;
+        rec->status = (uint8_t)status;
+        rec->lastUpdate = now;
+        retierLocked(tradeId, old, status);
+    }
+    LeaveCriticalSection(&tradeCs);
+    return rec != nullptr;
+}
+
+bool TradingState::applyFillProgress(int tradeId, double totalFilled, double avgPrice,
+                                     double now, OrderStatus* newStatus) {
+    if (!tradeCsInit) return false;
+    EnterCriticalSection(&tradeCs);
+    OrderRecord* rec = findLocked(tradeId);
+    bool applied = rec && totalFilled >= rec->filledSize;
+    if (applied) {
+        OrderStatus old = rec->orderStatus();
+        OrderStatus st = determineFilledStatus(totalFilled, rec->requestedSize);
+        if (isTerminal(old) && st != OrderStatus::Filled) st = old;   // Late fill after cancel
+        rec->filledSize = totalFilled;
+        rec->avgPrice = avgPrice;
+        rec->status = (uint8_t)st;
+        rec->lastUpdate = now;
+        if (newStatus) *newStatus = st;
+        retierLocked(tradeId, old, st);
+    }
+    LeaveCriticalSection(&tradeCs);
+    return applied;
+}
+
+bool TradingState::applyOrderUpdate(int tradeId, double filledSize, double fallbackPx,
+                                    OrderStatus status, double now, OrderStatus* newStatus) {
+    if (!tradeCsInit) return false;
+    EnterCriticalSection(&tradeCs);
+    OrderRecord* rec = findLocked(tradeId);
+    if (rec) {
+        OrderStatus old = rec->orderStatus();
+        double filled = filledSize > rec->filledSize ? filledSize : rec->filledSize;
+        OrderStatus st = status;
+        if (!isTerminal(status))   // Non-terminal events carry no status beyond the fill level
+            st = filled > 0 ? determineFilledStatus(filled, rec->requestedSize) : OrderStatus::Open;
+        if (isTerminal(old) && st != OrderStatus::Filled) st = old;
+
+        rec->filledSize = filled;
+        if (rec->avgPrice <= 0 && fallbackPx > 0) rec->avgPrice = fallbackPx;
+        rec->status = (uint8_t)st;
+        rec->lastUpdate = now;
+        if (newStatus) *newStatus = st;
+        retierLocked(tradeId, old, st);
+    }
+    LeaveCriticalSection(&tradeCs);
+    return rec != nullptr;
+}
+
+bool TradingState::markSynced(int tradeId, uint16_t epoch, double now) {
+    if (!tradeCsInit) return false;
+    EnterCriticalSection(&tradeCs);
+    OrderRecord* rec = findLocked(tradeId);
+    if (rec) {
+        rec->syncEpoch = epoch;
+        rec->lastUpdate = now;
+    }
+    LeaveCriticalSection(&tradeCs);
+    return rec != nullptr;
+}
+
+std::vector<std::pair<int, OrderRecord>> TradingState::activeRecords() const {
+    std::vector<std::pair<int, OrderRecord>> out;
+    if (!tradeCsInit) return out;
+    EnterCriticalSection(&tradeCs);
+    out.reserve(tradeMap.size());
+    for (const auto& entry : tradeMap) out.push_back(entry);
+    LeaveCriticalSection(&tradeCs);
+    return out;
+}
+
+bool TradingState::setOrderId(int tradeId, const char* oid, double now) {
+    if (!tradeCsInit) return false;
+    EnterCriticalSection(&tradeCs);
+    OrderRecord* rec = findLocked(tradeId);
+    if (rec) {
+        std::string oldKey = oidKeyLocked(tradeId, *rec);
+        auto it = oidIndex.find(oldKey);
+        if (it != oidIndex.end() && it->second == tradeId) oidIndex.erase(it);
+
+        rec->oid = 0;
+        rec->oidKind = OidKind::None;
+        if (oid && *oid) {
+            if (parseOid(oid, rec->oid)) {
+                rec->oidKind = OidKind::Exchange;
+            } else {
+                rec->oidKind = OidKind::Text;
+                auto cold = tradeCold.find(tradeId);
+                if (cold == tradeCold.end()) {
+                    cold = tradeCold.emplace(tradeId, OrderCold()).first;
+                    cold->second.zorroTradeId = tradeId;
+                }
+                cold->second.oid = oid;
+            }
+            oidIndex[oidKeyLocked(tradeId, *rec)] = tradeId;
+        }
+        rec->lastUpdate = now;
+    }
+    LeaveCriticalSection(&tradeCs);
+    return rec != nullptr;
+}
+
+bool TradingState::setError(int tradeId, const char* error) {
+    if (!tradeCsInit) return false;
+    EnterCriticalSection(&tradeCs);
+    bool found = findLocked(tradeId) != nullptr;
+    if (found) {
+        auto cold = tradeCold.find(tradeId);
+        if (cold == tradeCold.end()) {
+            cold = tradeCold.emplace(tradeId, OrderCold()).first;
+            cold->second.zorroTradeId = tradeId;
+        }
+        cold->second.lastError = error ? error : "";
+    }
+    LeaveCriticalSection(&tradeCs);
+    return found;
+}
+
+// --- Index lookups ---
+
+int TradingState::findByCloid(const char* cloid) const {
+    if (!cloid || !*cloid || !tradeCsInit) return 0;
+    EnterCriticalSection(&tradeCs);
+    auto it = cloidIndex.find(cloid);
+    int result = (it != cloidIndex.end()) ? it->second : 0;
+    LeaveCriticalSection(&tradeCs);
+    return result;
+}
+
+int TradingState::findByOid(const char* oid) const {
+    if (!oid || !*oid || !tradeCsInit) return 0;
+    EnterCriticalSection(&tradeCs);
+    auto it = oidIndex.find(oid);
+    int result = (it != oidIndex.end()) ? it->second : 0;
+    LeaveCriticalSection(&tradeCs);
+    return result;
+}
+
+bool TradingState::getOrderByCloid(const char* cloid, OrderState& out) const {
+    if (!cloid || !*cloid || !tradeCsInit) return false;
+    EnterCriticalSection(&tradeCs);
+    auto it = cloidIndex.find(cloid);
+    const OrderRecord* rec = (it != cloidIndex.end()) ? findLocked(it->second) : nullptr;
+    if (rec) decodeLocked(it->second, *rec, out);
+    LeaveCriticalSection(&tradeCs);
+    return rec != nullptr;
+}
+
+bool TradingState::getOrderByOid(const char* oid, OrderState& out) const {
+    if (!oid || !*oid || !tradeCsInit) return false;
+    EnterCriticalSection(&tradeCs);
+    auto it = oidIndex.find(oid);
+    const OrderRecord* rec = (it != oidIndex.end()) ? findLocked(it->second) : nullptr;
+    if (rec) decodeLocked(it->second, *rec, out);
+    LeaveCriticalSection(&tradeCs);
+    return rec != nullptr;
+}
+
+size_t TradingState::activeOrderCount() const {
+    if (!tradeCsInit) return 0;
+    EnterCriticalSection(&tradeCs);
+    size_t n = tradeMap.size();
+    LeaveCriticalSection(&tradeCs);
+    return n;
+}
+
+size_t TradingState::archivedOrderCount() const {
+    if (!tradeCsInit) return 0;
+    EnterCriticalSection(&tradeCs);
+    size_t n = tradeFilled.size() + tradeArchive.size();
+    LeaveCriticalSection(&tradeCs);
+    return n;
+}
+
 // =============================================================================
 // LOGGER IMPLEMENTATION
 // =============================================================================
@@ -189,24 +684,10 @@ void TradingState::removeOrder(int tradeId) {
 void Logger::log(int minLevel, const char* msg) const {
     if (!callback || !msg) return;
     if (level.load() >= minLevel) {
-        callback(msg);
+        logText(callback, msg);
     }
 }
 
-void Logger::logf(int minLevel, const char* fmt, ...) const {
-    if (!callback || !fmt) return;
-    if (level.load() < minLevel) return;
-
-    char buf[2048];
-    va_list args;
-    va_start(args, fmt);
-    vsnprintf(buf, sizeof(buf), fmt, args);
-    va_end(args);
-    buf[sizeof(buf) - 1] = 0;
-
-    callback(buf);
-}
-
 // =============================================================================
 // GLOBAL INITIALIZATION / CLEANUP
 // =============================================================================
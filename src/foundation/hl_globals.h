@@ -1,7 +1,7 @@
 //=============================================================================
 // hl_globals.h - Controlled global state with clear ownership
 //=============================================================================
-// LAYER: Foundation | DEPENDENCIES: hl_types.h, hl_config.h
+// LAYER: Foundation | DEPENDENCIES: hl_types.h, hl_config.h, hl_symbols.h, hl_log_ring.h
 // THREAD SAFETY: Individual structs document their own thread safety
 //=============================================================================
 
@@ -9,10 +9,15 @@
 
 #include "hl_types.h"
 #include "hl_config.h"
-#include <windows.h>
+#include "hl_symbols.h"
+#include "hl_log_ring.h"
+#include "hl_platform.h"
 #include <string>
 #include <map>
 #include <set>
+#include <unordered_map>
+#include <deque>
+#include <vector>
 #include <atomic>
 #include <cstdint>
 
@@ -35,12 +40,19 @@ struct RuntimeConfig {
 
     // Diagnostics
     int diagLevel = 0;              // 0=off, 1=errors, 2=info, 3=verbose
+    bool asyncLog = true;           // Worker-thread messages wait in g_logRing for Zorro's thread
 
     // Features
     bool enableWebSocket = true;    // Use WS for prices
     bool useWsOrders = true;        // Use WS for order placement
     bool enableHttpSeed = true;     // HTTP fallback when WS stale
     int httpSeedCooldownMs = 1000;  // Min time between HTTP seeds
+    int wsMarketConnections = 0;    // Extra l2Book connections (0 = single WS)
+    bool wsStandby = false;         // Warm-standby WS for critical channels
+    int wsSubRate = config::WS_SUB_RATE_PER_SEC;  // l2Book subscribe pacing (frames/s)
+    int fillCapacity = config::WS_FILL_CAPACITY;  // Fills kept in PriceCache
+    bool wsAssetCtx = false;        // Stream activeAssetCtx per subscribed asset (else pulled at subscribe)
+    bool sharedPrices = false;      // Share l2Book prices with other instances via shared memory
 
     // Trading
     char orderType[16] = "Ioc";     // Default: Immediate-or-cancel
@@ -51,6 +63,8 @@ struct RuntimeConfig {
 
     // Zorro integration
     HWND zorroWindow = NULL;        // For WM_APP+1 notifications
+    int guiNotifyMinMs = 0;         // Min ms between WM_APP+1 posts (0 = one in flight only)
+    bool guiNotifyTradedOnly = false;  // WM_APP+1 only for coins with positions/open orders
     int cacheTimeoutMs = 2000;      // General cache timeout
 };
 
@@ -96,36 +110,119 @@ struct TradingState {
     // Isolates GET_PRICE from BrokerAsset subscription loops that overwrite currentSymbol.
     char priceSymbol[64] = {0};
 
-    // Trade tracking: Zorro trade ID -> OrderState
-    std::map<int, OrderState> tradeMap;
+    // Trade tracking: Zorro trade ID -> OrderRecord (64-byte hot record)
+    // Live orders (Pending/Open/PartialFill) stay in tradeMap. Filled ones
+    // move to tradeFilled: to Zorro they are open positions, so they stay
+    // until removed. Cancelled/Error ones move to tradeArchive, which keeps
+    // the newest TRADE_ARCHIVE_MAX. getOrder() and the lookups below see all
+    // three.
+    // Strings with no compact form are kept in tradeCold (few entries).
+    struct OrderCold {
+        std::string oid;            // OidKind::Text
+        std::string cloid;          // CloidKind::Text
+        std::string lastError;
+        int zorroTradeId = 0;       // Authoritative when a cold entry exists (else = key)
+    };
+    std::map<int, OrderRecord> tradeMap;
+    std::map<int, OrderRecord> tradeFilled;
+    std::map<int, OrderRecord> tradeArchive;
+    std::unordered_map<int, OrderCold> tradeCold;
+    std::unordered_map<std::string, int> cloidIndex;  // cloid -> trade ID
+    std::unordered_map<std::string, int> oidIndex;    // oid -> trade ID
     mutable CRITICAL_SECTION tradeCs;
     bool tradeCsInit = false;
 
     void init();
     void cleanup();
 
-    // Thread-safe trade map access
+    // Thread-safe trade map access (full OrderState view)
     int generateTradeId();
     uint64_t generateNonce();
     void setOrder(int tradeId, const OrderState& state);
     bool getOrder(int tradeId, OrderState& out) const;
     bool updateOrder(int tradeId, const OrderState& state);
     void removeOrder(int tradeId);
+
+    // Hot record access — no string copies
+    bool getRecord(int tradeId, OrderRecord& out) const;
+    /// Records of many trades under one lock; unknown IDs are skipped
+    std::vector<std::pair<int, OrderRecord>> getRecords(const std::vector<int>& tradeIds) const;
+    const char* coinName(uint16_t coinId) const;   // g_symbols.name(); pointer stays valid
+
+    // Field-level updates applied in place under the lock (no copy-modify-write).
+    // All set lastUpdate = now and move the order between tiers if needed.
+    bool applyFill(int tradeId, double filledSize, double avgPrice,
+                   OrderStatus status, double now);
+    /// Monotonic fill progress: applies only if totalFilled >= stored filled
+    /// size; status follows determineFilledStatus, except that a terminal
+    /// order only moves on to Filled. @return true if applied
+    bool applyFillProgress(int tradeId, double totalFilled, double avgPrice,
+                           double now, OrderStatus* newStatus = nullptr);
+    bool setOrderId(int tradeId, const char* oid, double now);
+    bool setError(int tradeId, const char* error);
+
+    /// Order-feed event (orderUpdates / reconciliation): filled size never
+    /// decreases, avgPrice is only seeded when unknown (userFills owns it),
+    /// terminal states are absorbing except for a completed fill.
+    /// @return false if the trade is unknown
+    bool applyOrderUpdate(int tradeId, double filledSize, double fallbackPx,
+                          OrderStatus status, double now, OrderStatus* newStatus = nullptr);
+
+    /// Stamp the order-feed epoch the order state was last confirmed in
+    bool markSynced(int tradeId, uint16_t epoch, double now);
+
+    /// Copy of the active (non-terminal) tier, for reconciliation sweeps
+    std::vector<std::pair<int, OrderRecord>> activeRecords() const;
+
+    // O(1) lookups via the indices (0 / false if unknown)
+    int findByCloid(const char* cloid) const;
+    int findByOid(const char* oid) const;
+    bool getOrderByCloid(const char* cloid, OrderState& out) const;
+    bool getOrderByOid(const char* oid, OrderState& out) const;
+
+    size_t activeOrderCount() const;
+    size_t archivedOrderCount() const;      // Filled + Cancelled/Error
+
+    /// Decimal oid / "0x" cloid of a record (false if not in compact form)
+    static bool formatOid(const OrderRecord& rec, char* out, size_t outSize);
+    static bool formatCloid(const OrderRecord& rec, char* out, size_t outSize);
+
+private:
+    // Caller holds tradeCs
+    OrderRecord* findLocked(int tradeId);
+    const OrderRecord* findLocked(int tradeId) const;
+    void encodeLocked(int tradeId, const OrderState& state, OrderRecord& rec);
+    void decodeLocked(int tradeId, const OrderRecord& rec, OrderState& out) const;
+    void placeLocked(int tradeId, const OrderState& state);
+    std::map<int, OrderRecord>& tierLocked(OrderStatus status);
+    void retierLocked(int tradeId, OrderStatus oldStatus, OrderStatus newStatus);
+    void trimArchiveLocked();
+    void eraseLocked(int tradeId);
+    void indexLocked(int tradeId, const OrderRecord& rec);
+    void unindexLocked(int tradeId, const OrderRecord& rec);
+    std::string oidKeyLocked(int tradeId, const OrderRecord& rec) const;
+    std::string cloidKeyLocked(int tradeId, const OrderRecord& rec) const;
 };
 
 // =============================================================================
 // LOGGER (decouples from Zorro's BrokerMessage)
-// Thread safety: Atomic level, callback assumed thread-safe
+// Thread safety: Atomic level; once g_logRing has a drain thread, messages
+// from other threads are deferred and callback runs on the drain thread only
 // =============================================================================
 
-using LogCallback = int(*)(const char*);
-
 struct Logger {
     LogCallback callback = nullptr;
     std::atomic<int> level{0};
 
     void log(int minLevel, const char* msg) const;
-    void logf(int minLevel, const char* fmt, ...) const;
+
+    template <class... A>
+    void logf(int minLevel, const char* fmt, const A&... args) const {
+        if (!callback || !fmt) return;
+        if (level.load() < minLevel) return;
+        logPrintf(callback, fmt, args...);
+    }
+
     void error(const char* msg) const { log(1, msg); }
     void info(const char* msg) const { log(2, msg); }
     void debug(const char* msg) const { log(3, msg); }
@@ -0,0 +1,210 @@
+//=============================================================================
+// hl_latency.cpp - Per-stage latency histograms implementation
+//=============================================================================
+// LAYER: Foundation | DEPENDENCIES: hl_latency.h
+//=============================================================================
+
+#include "hl_latency.h"
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+
+namespace hl {
+namespace lat {
+
+namespace {
+
+const int STAGES = (int)Stage::Count;
+const int LINEAR = 64;                  // Exact buckets below 64 ns
+const int SUB_SHIFT = 5;
+const int SUB = 1 << SUB_SHIFT;         // Buckets per power of two above
+const int MAX_MSB = 41;                 // ~36 min; longer samples land in the last bucket
+const int BUCKETS = LINEAR + (MAX_MSB - 6 + 1) * SUB;
+
+static_assert((config::LATENCY_ORDER_SLOTS & (config::LATENCY_ORDER_SLOTS - 1)) == 0,
+              "LATENCY_ORDER_SLOTS must be a power of 2");
+
+const char* const STAGE_NAMES[] = {
+    "BrokerAsset", "BrokerBuy", "PriceLookup", "Eip712Hash", "Sign", "Serialize",
+    "Send", "Ack", "FirstFill", "WsReceive", "Parse", "CachePublish"
+};
+static_assert(sizeof(STAGE_NAMES) / sizeof(STAGE_NAMES[0]) == STAGES, "one name per stage");
+
+struct Slab {
+    std::atomic<uint32_t> counts[STAGES][BUCKETS];
+    std::atomic<uint64_t> maxNs[STAGES];
+};
+
+struct OrderClock {
+    std::atomic<int> tradeId;
+    std::atomic<uint64_t> sentTicks;
+};
+
+// Static storage: zero-initialized, no constructor runs under the loader lock
+Slab s_slabs[config::LATENCY_MAX_THREADS + 1];      // Last one shared by overflow threads
+Slab* const s_overflow = &s_slabs[config::LATENCY_MAX_THREADS];
+std::atomic<int> s_slabsClaimed;
+OrderClock s_orders[config::LATENCY_ORDER_SLOTS];
+thread_local Slab* t_slab = nullptr;
+
+double nsPerTick() {
+    static const double v = []() {
+        LARGE_INTEGER f;
+        QueryPerformanceFrequency(&f);
+        return f.QuadPart > 0 ? 1e9 / (double)f.QuadPart : 1.0;
+    }();
+    return v;
+}
+
+int msb64(uint64_t v) {
+    unsigned long i;
+    if (_BitScanReverse(&i, (unsigned long)(v >> 32))) return (int)i + 32;
+    _BitScanReverse(&i, (unsigned long)v);
+    return (int)i;
+}
+
+int bucketOf(uint64_t ns) {
+    if (ns < (uint64_t)LINEAR) return (int)ns;
+    int msb = msb64(ns);
+    if (msb > MAX_MSB) return BUCKETS - 1;
+    return LINEAR + (msb - 6) * SUB + (int)(ns >> (msb - SUB_SHIFT)) - SUB;
+}
+
+// Midpoint of the bucket's range
+uint64_t bucketValue(int b) {
+    if (b < LINEAR) return (uint64_t)b;
+    int k = b - LINEAR;
+    int shift = 6 + k / SUB - SUB_SHIFT;
+    uint64_t low = (uint64_t)(SUB + k % SUB) << shift;
+    return low + ((1ULL << shift) >> 1);
+}
+
+Slab* slabForThread() {
+    Slab* s = t_slab;
+    if (!s) {
+        int i = s_slabsClaimed.fetch_add(1, std::memory_order_relaxed);
+        s = i < config::LATENCY_MAX_THREADS ? &s_slabs[i] : s_overflow;
+        t_slab = s;
+    }
+    return s;
+}
+
+} // namespace
+
+const char* stageName(Stage s) {
+    int i = (int)s;
+    return i >= 0 && i < STAGES ? STAGE_NAMES[i] : "?";
+}
+
+// Owned slab: one writer, so a plain load/store instead of a locked add
+void recordNs(Stage s, uint64_t ns) {
+    int st = (int)s;
+    if (st < 0 || st >= STAGES) return;
+    Slab* slab = slabForThread();
+    std::atomic<uint32_t>& c = slab->counts[st][bucketOf(ns)];
+    if (slab == s_overflow) c.fetch_add(1, std::memory_order_relaxed);
+    else c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+    std::atomic<uint64_t>& m = slab->maxNs[st];
+    uint64_t cur = m.load(std::memory_order_relaxed);
+    while (ns > cur && !m.compare_exchange_weak(cur, ns, std::memory_order_relaxed)) {}
+}
+
+void record(Stage s, uint64_t startTicks) {
+    recordSpan(s, startTicks, now());
+}
+
+void recordSpan(Stage s, uint64_t startTicks, uint64_t endTicks) {
+    uint64_t ticks = endTicks > startTicks ? endTicks - startTicks : 0;
+    recordNs(s, (uint64_t)((double)ticks * nsPerTick()));
+}
+
+void orderSent(int tradeId) {
+    if (tradeId <= 0) return;
+    OrderClock& o = s_orders[tradeId & (config::LATENCY_ORDER_SLOTS - 1)];
+    o.sentTicks.store(0, std::memory_order_relaxed);
+    o.tradeId.store(tradeId, std::memory_order_relaxed);
+    o.sentTicks.store(now(), std::memory_order_release);
+}
+
+void orderFilled(int tradeId) {
+    if (tradeId <= 0) return;
+    OrderClock& o = s_orders[tradeId & (config::LATENCY_ORDER_SLOTS - 1)];
+    if (o.tradeId.load(std::memory_order_relaxed) != tradeId) return;
+    uint64_t sent = o.sentTicks.exchange(0, std::memory_order_acq_rel);
+    if (sent) record(Stage::FirstFill, sent);
+}
+
+int summarize(StageSummary* out, int maxStages) {
+    if (!out) return 0;
+    int n = maxStages < STAGES ? maxStages : STAGES;
+    uint64_t merged[BUCKETS];
+    for (int st = 0; st < n; st++) {
+        StageSummary& r = out[st];
+        memset(&r, 0, sizeof(r));
+        strncpy_s(r.name, STAGE_NAMES[st], _TRUNCATE);
+
+        uint64_t total = 0, maxNs = 0;
+        memset(merged, 0, sizeof(merged));
+        for (const Slab& slab : s_slabs) {
+            for (int b = 0; b < BUCKETS; b++) merged[b] += slab.counts[st][b].load(std::memory_order_relaxed);
+            uint64_t m = slab.maxNs[st].load(std::memory_order_relaxed);
+            if (m > maxNs) maxNs = m;
+        }
+        for (int b = 0; b < BUCKETS; b++) total += merged[b];
+        r.count = (double)total;
+        r.maxUs = maxNs / 1000.0;
+        if (total == 0) continue;
+
+        const double q[3] = { 0.50, 0.90, 0.99 };
+        double* dst[3] = { &r.p50Us, &r.p90Us, &r.p99Us };
+        uint64_t seen = 0;
+        int next = 0;
+        for (int b = 0; b < BUCKETS && next < 3; b++) {
+            seen += merged[b];
+            while (next < 3 && (double)seen >= q[next] * (double)total) {
+                uint64_t v = bucketValue(b);
+                *dst[next++] = (v < maxNs ? v : maxNs) / 1000.0;
+            }
+        }
+    }
+    return n;
+}
+
+bool writeCsv(const char* path) {
+    if (!path || !*path) return false;
+    FILE* f = nullptr;
+    if (fopen_s(&f, path, "w") != 0 || !f) return false;
+    StageSummary rows[STAGES];
+    int n = summarize(rows, STAGES);
+    fprintf(f, "stage,count,p50_us,p90_us,p99_us,max_us\n");
+    for (int i = 0; i < n; i++)
+        fprintf(f, "%s,%.0f,%.3f,%.3f,%.3f,%.3f\n", rows[i].name, rows[i].count,
+                rows[i].p50Us, rows[i].p90Us, rows[i].p99Us, rows[i].maxUs);
+    fclose(f);
+    return true;
+}
+
+void reset() {
+    for (Slab& slab : s_slabs) {
+        for (int st = 0; st < STAGES; st++) {
+            for (int b = 0; b < BUCKETS; b++) slab.counts[st][b].store(0, std::memory_order_relaxed);
+            slab.maxNs[st].store(0, std::memory_order_relaxed);
+        }
+    }
+    for (OrderClock& o : s_orders) {
+        o.tradeId.store(0, std::memory_order_relaxed);
+        o.sentTicks.store(0, std::memory_order_relaxed);
+    }
+}
+
+bool compiledIn() {
+#ifdef HL_NO_LATENCY
+    return false;
+#else
+    return true;
+#endif
+}
+
+} // namespace lat
+} // namespace hl
@@ -0,0 +1,124 @@
+//=============================================================================
+// hl_latency.h - Per-stage latency histograms for the order and tick paths
+//=============================================================================
+// LAYER: Foundation | DEPENDENCIES: hl_config.h
+// THREAD SAFETY: record() from any thread (lock-free); summarize()/reset()
+//                from any thread (reset races in-flight samples, harmless)
+//
+// Hot-path stages are timed with QueryPerformanceCounter and counted into
+// log-linear (HDR-style) histograms: values below 64 ns are exact, above
+// that every power of two is split into 32 buckets (~3% resolution) up to
+// ~36 minutes. Each thread owns one slab of histograms (single writer, plain
+// relaxed stores); threads beyond LATENCY_MAX_THREADS share an overflow slab
+// with atomic adds. summarize() merges the slabs into p50/p90/p99/max.
+//
+// Instrument with the macros so a build with HL_NO_LATENCY (CMake option
+// HL_LATENCY_STATS=OFF) compiles every sample out:
+//   HL_LAT_BEGIN(t0);  ...work...  HL_LAT_END(Sign, t0);
+//   HL_LAT_SCOPE(BrokerBuy);       // Whole enclosing block
+//   HL_LAT_SPAN(Send, t0, t1);     // Two timestamps taken with now()
+//   HL_LAT_NOW()                   // Timestamp to store (0 when compiled out)
+//=============================================================================
+
+#pragma once
+
+#include "hl_config.h"
+#include "hl_platform.h"
+#include <cstdint>
+
+namespace hl {
+namespace lat {
+
+enum class Stage : uint8_t {
+    BrokerAsset,        // Zorro BrokerAsset call
+    BrokerBuy,          // Zorro BrokerBuy2 call
+    PriceLookup,        // BrokerAsset quote retrieval (cache, WS wait, HTTP seed)
+    Eip712Hash,         // Order action -> EIP-712 digest
+    Sign,               // secp256k1 signature
+    Serialize,          // Signed order -> JSON body
+    Send,               // /exchange request handed to Zorro's HTTP
+    Ack,                // /exchange request sent -> response received
+    FirstFill,          // Order sent -> first fill seen (response or userFills)
+    WsReceive,          // WS frame arrival -> dispatch on the connection thread
+    Parse,              // WS frame JSON parse
+    CachePublish,       // l2Book quote -> PriceCache and shared table
+    Count
+};
+
+/// Per-stage summary in microseconds. Plain layout for BrokerCommand callers.
+struct StageSummary {
+    char name[16];
+    double count;
+    double p50Us;
+    double p90Us;
+    double p99Us;
+    double maxUs;
+};
+
+const char* stageName(Stage s);
+
+/// Monotonic timestamp in QueryPerformanceCounter ticks
+inline uint64_t now() {
+    LARGE_INTEGER t;
+    QueryPerformanceCounter(&t);
+    return (uint64_t)t.QuadPart;
+}
+
+/// Sample of `ns` nanoseconds
+void recordNs(Stage s, uint64_t ns);
+
+/// Sample from `startTicks` (now()) to now
+void record(Stage s, uint64_t startTicks);
+
+/// Sample between two now() timestamps taken earlier
+void recordSpan(Stage s, uint64_t startTicks, uint64_t endTicks);
+
+/// Order clock for FirstFill: orderSent stamps a trade id, the first
+/// orderFilled for it records the stage (later fills are ignored)
+void orderSent(int tradeId);
+void orderFilled(int tradeId);
+
+/// Fills out[0..Stage::Count) (stages without samples have count 0).
+/// Returns the number of stages written.
+int summarize(StageSummary* out, int maxStages);
+
+/// Writes the summary as CSV; returns false if the file cannot be opened
+bool writeCsv(const char* path);
+
+/// Clears every histogram
+void reset();
+
+/// False when built with HL_NO_LATENCY (no sample is ever recorded)
+bool compiledIn();
+
+class Scope {
+public:
+    explicit Scope(Stage s) : stage_(s), start_(now()) {}
+    ~Scope() { record(stage_, start_); }
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+private:
+    Stage stage_;
+    uint64_t start_;
+};
+
+} // namespace lat
+} // namespace hl
+
+#ifdef HL_NO_LATENCY
+#define HL_LAT_NOW()                ((uint64_t)0)
+#define HL_LAT_BEGIN(var)           ((void)0)
+#define HL_LAT_END(stage, var)      ((void)0)
+#define HL_LAT_SPAN(stage, a, b)    ((void)0)
+#define HL_LAT_SCOPE(stage)         ((void)0)
+#define HL_LAT_ORDER_SENT(tradeId)  ((void)0)
+#define HL_LAT_ORDER_FILLED(tradeId) ((void)0)
+#else
+#define HL_LAT_NOW()                ::hl::lat::now()
+#define HL_LAT_BEGIN(var)           const uint64_t var = ::hl::lat::now()
+#define HL_LAT_END(stage, var)      ::hl::lat::record(::hl::lat::Stage::stage, var)
+#define HL_LAT_SPAN(stage, a, b)    ::hl::lat::recordSpan(::hl::lat::Stage::stage, a, b)
+#define HL_LAT_SCOPE(stage)         ::hl::lat::Scope hlLatScope_(::hl::lat::Stage::stage)
+#define HL_LAT_ORDER_SENT(tradeId)  ::hl::lat::orderSent(tradeId)
+#define HL_LAT_ORDER_FILLED(tradeId) ::hl::lat::orderFilled(tradeId)
+#endif
@@ -0,0 +1,272 @@
+//=============================================================================
+// hl_log_ring.cpp - Deferred logging ring implementation
+//=============================================================================
+// LAYER: Foundation | DEPENDENCIES: hl_log_ring.h
+//=============================================================================
+
+#include "hl_log_ring.h"
+#include <cstdarg>
+
+namespace hl {
+
+static_assert(sizeof(LogRing::Record) == LogRing::RECORD_BYTES, "log record size");
+static_assert((config::LOG_RING_CAPACITY & (config::LOG_RING_CAPACITY - 1)) == 0,
+              "LOG_RING_CAPACITY must be a power of 2");
+
+static LogRing::Record s_cells[config::LOG_RING_CAPACITY];
+
+LogRing g_logRing;
+
+LogRing::LogRing()
+    : cells_(s_cells), mask_((uint32_t)config::LOG_RING_CAPACITY - 1),
+      tail_(0), head_(0), draining_(false), drainThread_(0),
+      pushed_(0), dropped_(0), drained_(0), highWater_(0),
+      dropsReported_(0), lastCb_(nullptr) {
+    for (uint32_t i = 0; i <= mask_; ++i) cells_[i].seq.store(i, std::memory_order_relaxed);
+}
+
+//=============================================================================
+// PRODUCERS
+//=============================================================================
+
+// Bounded ring with a sequence per cell: a cell is free for position pos
+// when seq == pos, filled when seq == pos + 1
+LogRing::Record* LogRing::claim() {
+    uint32_t pos = tail_.load(std::memory_order_relaxed);
+    for (;;) {
+        Record* r = &cells_[pos & mask_];
+        uint32_t seq = r->seq.load(std::memory_order_acquire);
+        int32_t dif = (int32_t)(seq - pos);
+        if (dif == 0) {
+            if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) return r;
+        } else if (dif < 0) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        } else {
+            pos = tail_.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void LogRing::commit(Record* r) {
+    uint32_t pos = r->seq.load(std::memory_order_relaxed);
+    r->seq.store(pos + 1, std::memory_order_release);
+    pushed_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void LogRing::putText(Record& r, const char* s) {
+    Record::Arg& a = put(r, ARG_STR);
+    a.str = r.textUsed;
+    if (!s) s = "(null)";
+    size_t room = sizeof(r.text) - r.textUsed;
+    if (room == 0) {                        // Text full: point at the last terminator
+        a.str = (uint32_t)sizeof(r.text) - 1;
+        return;
+    }
+    size_t n = strnlen(s, room - 1);
+    memcpy(r.text + r.textUsed, s, n);
+    r.text[r.textUsed + n] = 0;
+    r.textUsed = (uint16_t)(r.textUsed + n + 1);
+}
+
+//=============================================================================
+// DRAIN
+//=============================================================================
+
+int LogRing::drain(int maxRecords) {
+    if (head_.load(std::memory_order_relaxed) == tail_.load(std::memory_order_relaxed) &&
+        dropped_.load(std::memory_order_relaxed) == dropsReported_.load(std::memory_order_relaxed))
+        return 0;
+    bool expected = false;
+    if (!draining_.compare_exchange_strong(expected, true, std::memory_order_acquire)) return 0;
+
+    uint32_t pos = head_.load(std::memory_order_relaxed);
+    int waiting = (int)(tail_.load(std::memory_order_relaxed) - pos);
+    if (waiting > highWater_.load(std::memory_order_relaxed))
+        highWater_.store(waiting, std::memory_order_relaxed);
+
+    char buf[2048];
+    int n = 0;
+    while (maxRecords <= 0 || n < maxRecords) {
+        Record* r = &cells_[pos & mask_];
+        if (r->seq.load(std::memory_order_acquire) != pos + 1) break;   // Empty (or still being written)
+        LogCallback cb = r->cb;
+        format(*r, buf, sizeof(buf));
+        r->seq.store(pos + mask_ + 1, std::memory_order_release);       // Free for the next lap
+        head_.store(++pos, std::memory_order_relaxed);
+        if (cb) {
+            cb(buf);
+            lastCb_ = cb;
+        }
+        n++;
+    }
+    drained_.fetch_add(n, std::memory_order_relaxed);
+
+    long long dropped = dropped_.load(std::memory_order_relaxed);
+    long long reported = dropsReported_.load(std::memory_order_relaxed);
+    if (dropped != reported && lastCb_) {
+        sprintf_s(buf, "LOG: %lld message(s) dropped (ring full)", dropped - reported);
+        lastCb_(buf);
+        dropsReported_.store(dropped, std::memory_order_relaxed);
+    }
+
+    draining_.store(false, std::memory_order_release);
+    return n;
+}
+
+// Each conversion is re-issued on its own with the length modifier the
+// stored kind needs, so the record's types decide, not the format's
+int LogRing::format(const Record& r, char* out, size_t outSize) {
+    if (!out || outSize == 0) return 0;
+    size_t len = 0;
+    int next = 0;
+    const char* f = r.fmt ? r.fmt : "";
+
+    auto append = [&](const char* s, size_t n) {
+        if (len + 1 >= outSize) return;
+        if (n > outSize - 1 - len) n = outSize - 1 - len;
+        memcpy(out + len, s, n);
+        len += n;
+    };
+    auto nextInt = [&](int* v) -> bool {
+        if (next >= r.nargs) return false;
+        const Record::Arg& a = r.args[next];
+        uint8_t k = r.kinds[next++];
+        *v = k == ARG_F64 ? (int)a.d : (k == ARG_U64 ? (int)a.u : (int)a.i);
+        return true;
+    };
+
+    while (*f) {
+        if (*f != '%') {
+            const char* lit = f;
+            while (*f && *f != '%') ++f;
+            append(lit, (size_t)(f - lit));
+            continue;
+        }
+        if (f[1] == '%') { append("%", 1); f += 2; continue; }
+
+        // %[flags][width|*][.precision|*][length]conversion
+        char spec[32];
+        size_t sp = 0;
+        spec[sp++] = *f++;
+        int star[2];
+        int stars = 0;
+        while (*f && strchr("-+ #0", *f) && sp < 20) spec[sp++] = *f++;
+        if (*f == '*') { if (nextInt(&star[stars])) stars++; spec[sp++] = *f++; }
+        while (*f >= '0' && *f <= '9' && sp < 20) spec[sp++] = *f++;
+        if (*f == '.') {
+            spec[sp++] = *f++;
+            if (*f == '*') { if (nextInt(&star[stars])) stars++; spec[sp++] = *f++; }
+            while (*f >= '0' && *f <= '9' && sp < 24) spec[sp++] = *f++;
+        }
+        while (*f && strchr("hlLqjzt", *f)) ++f;
+        if (f[0] == 'I' && f[1] == '6' && f[2] == '4') f += 3;
+        char conv = *f;
+        if (!conv) break;
+        ++f;
+
+        char piece[512];
+        int n = -1;
+        bool have = next < r.nargs;
+        const Record::Arg* a = have ? &r.args[next] : nullptr;
+        uint8_t k = have ? r.kinds[next] : 0;
+        if (have) next++;
+
+        switch (conv) {
+        case 'd': case 'i': case 'u': case 'x': case 'X': case 'o': case 'c': {
+            if (!have || k == ARG_STR) break;
+            long long v = k == ARG_F64 ? (long long)a->d : (k == ARG_U64 ? (long long)a->u : a->i);
+            if (conv == 'c') {
+                spec[sp++] = 'c';
+                spec[sp] = 0;
+                n = stars == 2 ? snprintf(piece, sizeof(piece), spec, star[0], star[1], (int)v)
+                  : stars == 1 ? snprintf(piece, sizeof(piece), spec, star[0], (int)v)
+                  : snprintf(piece, sizeof(piece), spec, (int)v);
+                break;
+            }
+            spec[sp++] = 'l';
+            spec[sp++] = 'l';
+            spec[sp++] = conv;
+            spec[sp] = 0;
+            n = stars == 2 ? snprintf(piece, sizeof(piece), spec, star[0], star[1], v)
+              : stars == 1 ? snprintf(piece, sizeof(piece), spec, star[0], v)
+              : snprintf(piece, sizeof(piece), spec, v);
+            break;
+        }
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A': {
+            if (!have || k == ARG_STR || k == ARG_PTR) break;
+            double v = k == ARG_F64 ? a->d : (k == ARG_U64 ? (double)a->u : (double)a->i);
+            spec[sp++] = conv;
+            spec[sp] = 0;
+            n = stars == 2 ? snprintf(piece, sizeof(piece), spec, star[0], star[1], v)
+              : stars == 1 ? snprintf(piece, sizeof(piece), spec, star[0], v)
+              : snprintf(piece, sizeof(piece), spec, v);
+            break;
+        }
+        case 's': {
+            if (!have || k != ARG_STR) break;
+            const char* v = r.text + a->str;
+            spec[sp++] = 's';
+            spec[sp] = 0;
+            n = stars == 2 ? snprintf(piece, sizeof(piece), spec, star[0], star[1], v)
+              : stars == 1 ? snprintf(piece, sizeof(piece), spec, star[0], v)
+              : snprintf(piece, sizeof(piece), spec, v);
+            break;
+        }
+        case 'p':
+            if (!have || k != ARG_PTR) break;
+            n = snprintf(piece, sizeof(piece), "%p", a->p);
+            break;
+        default:
+            break;
+        }
+
+        if (n < 0) append("<?>", 3);
+        else append(piece, (size_t)n < sizeof(piece) ? (size_t)n : sizeof(piece) - 1);
+    }
+
+    out[len] = 0;
+    return (int)len;
+}
+
+LogRingStats LogRing::getStats() const {
+    LogRingStats s;
+    s.deferring = drainThread() != 0;
+    s.pushed = pushed_.load(std::memory_order_relaxed);
+    s.dropped = dropped_.load(std::memory_order_relaxed);
+    s.drained = drained_.load(std::memory_order_relaxed);
+    s.highWater = highWater_.load(std::memory_order_relaxed);
+    return s;
+}
+
+void LogRing::reset() {
+    bool expected = false;
+    while (!draining_.compare_exchange_weak(expected, true, std::memory_order_acquire)) {
+        expected = false;
+        Sleep(0);
+    }
+    uint32_t pos = head_.load(std::memory_order_relaxed);
+    while (cells_[pos & mask_].seq.load(std::memory_order_acquire) == pos + 1) {
+        cells_[pos & mask_].seq.store(pos + mask_ + 1, std::memory_order_release);
+        head_.store(++pos, std::memory_order_relaxed);
+    }
+    pushed_ = 0;
+    dropped_ = 0;
+    drained_ = 0;
+    highWater_ = 0;
+    dropsReported_ = 0;
+    lastCb_ = nullptr;
+    draining_.store(false, std::memory_order_release);
+}
+
+void logFormatted(LogCallback cb, const char* fmt, ...) {
+    char buf[2048];
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+    buf[sizeof(buf) - 1] = 0;
+    cb(buf);
+}
+
+} // namespace hl
@@ -0,0 +1,178 @@
+//=============================================================================
+// hl_log_ring.h - Deferred logging: lock-free ring of unformatted records
+//=============================================================================
+// LAYER: Foundation | DEPENDENCIES: hl_config.h
+// THREAD SAFETY: push() from any thread (lock-free, multi-producer);
+//                drain() from one thread at a time (others return 0)
+//
+// Zorro's BrokerMessage is a SendMessage to the GUI thread: slow on a WS
+// connection thread and a deadlock if the GUI thread is blocked on that
+// connection [OPM-133]. Threads other than the drain thread (Zorro's, set at
+// BrokerOpen) therefore only store the format pointer, the arguments and
+// copies of string arguments into a fixed record. Formatting and the
+// callback run later in drain(), on the drain thread. The drain thread logs
+// synchronously, after draining, so messages keep their order.
+//
+// A full ring drops the record and counts it; the next drain reports drops.
+// Format strings must be literals (they are kept by pointer). Conversions
+// are re-typed on drain, so a %d given a long long or a %f given an int
+// prints the value instead of reading garbage.
+//=============================================================================
+
+#pragma once
+
+#include "hl_config.h"
+#include "hl_platform.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+
+namespace hl {
+
+using LogCallback = int(*)(const char*);
+
+struct LogRingStats {
+    bool deferring = false;         // Drain thread set
+    long long pushed = 0;           // Records stored
+    long long dropped = 0;          // Records lost to a full ring
+    long long drained = 0;          // Records delivered
+    int highWater = 0;              // Most records waiting at once (seen by drain)
+};
+
+class LogRing {
+public:
+    static const int ARGS_MAX = 12;
+    static const int RECORD_BYTES = 512;
+
+    enum ArgKind : uint8_t { ARG_I64, ARG_U64, ARG_F64, ARG_STR, ARG_PTR };
+
+    struct Record {
+        std::atomic<uint32_t> seq;      // Cell sequence (bounded MPMC ring)
+        uint8_t nargs;
+        uint8_t kinds[ARGS_MAX];
+        uint16_t textUsed;
+        LogCallback cb;
+        const char* fmt;
+        union Arg {
+            long long i;
+            unsigned long long u;
+            double d;
+            const void* p;
+            uint32_t str;               // Offset into text
+        } args[ARGS_MAX];
+        char text[RECORD_BYTES - 4 - 1 - ARGS_MAX - 2 - 2 * sizeof(void*) - ARGS_MAX * 8 - 8];
+    };
+
+    LogRing();
+
+    LogRing(const LogRing&) = delete;
+    LogRing& operator=(const LogRing&) = delete;
+
+    /// Thread that drains and logs synchronously (0 = every thread logs synchronously)
+    void setDrainThread(DWORD threadId) { drainThread_.store(threadId, std::memory_order_release); }
+    DWORD drainThread() const { return drainThread_.load(std::memory_order_acquire); }
+
+    /// True if the calling thread must defer instead of calling the callback
+    bool deferHere() const {
+        DWORD t = drainThread_.load(std::memory_order_relaxed);
+        return t != 0 && GetCurrentThreadId() != t;
+    }
+
+    /// Store one message. @return false if the ring was full (counted as dropped)
+    template <class... A>
+    bool push(LogCallback cb, const char* fmt, const A&... args) {
+        static_assert(sizeof...(A) <= ARGS_MAX, "too many log arguments");
+        Record* r = claim();
+        if (!r) return false;
+        r->cb = cb;
+        r->fmt = fmt;
+        r->nargs = 0;
+        r->textUsed = 0;
+        int unused[] = { 0, (capture(*r, args), 0)... };
+        (void)unused;
+        commit(r);
+        return true;
+    }
+
+    /// Format and deliver waiting records in order, then report new drops.
+    /// @param maxRecords Stop after this many (<= 0 = all)
+    /// @return records delivered
+    int drain(int maxRecords = 0);
+
+    /// Format one record as the callback would receive it
+    static int format(const Record& r, char* out, size_t outSize);
+
+    LogRingStats getStats() const;
+
+    /// Drop waiting records and zero the counters (tests)
+    void reset();
+
+private:
+    Record* cells_;
+    uint32_t mask_;
+    alignas(64) std::atomic<uint32_t> tail_;     // Next push position
+    alignas(64) std::atomic<uint32_t> head_;     // Next drain position
+    std::atomic<bool> draining_;
+    std::atomic<DWORD> drainThread_;
+    std::atomic<long long> pushed_;
+    std::atomic<long long> dropped_;
+    std::atomic<long long> drained_;
+    std::atomic<int> highWater_;
+    std::atomic<long long> dropsReported_;
+    LogCallback lastCb_;                         // Drain thread only
+
+    Record* claim();
+    void commit(Record* r);
+
+    static void putText(Record& r, const char* s);
+    static void capture(Record& r, const char* s) { putText(r, s); }
+    static void capture(Record& r, char* s) { putText(r, s); }
+    static void capture(Record& r, bool v) { put(r, ARG_I64).i = v ? 1 : 0; }
+    static void capture(Record& r, float v) { put(r, ARG_F64).d = v; }
+    static void capture(Record& r, double v) { put(r, ARG_F64).d = v; }
+    static void capture(Record& r, long double v) { put(r, ARG_F64).d = (double)v; }
+    template <class T>
+    static void capture(Record& r, T* p) { put(r, ARG_PTR).p = (const void*)p; }
+    template <class T>
+    static typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value>::type
+    capture(Record& r, T v) { put(r, ARG_I64).i = (long long)v; }
+    template <class T>
+    static typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value>::type
+    capture(Record& r, T v) { put(r, ARG_U64).u = (unsigned long long)v; }
+    template <class T>
+    static typename std::enable_if<std::is_enum<T>::value>::type
+    capture(Record& r, T v) { put(r, ARG_I64).i = (long long)v; }
+
+    static Record::Arg& put(Record& r, ArgKind kind) {
+        r.kinds[r.nargs] = kind;
+        return r.args[r.nargs++];
+    }
+};
+
+extern LogRing g_logRing;
+
+/// Format into a 2048-byte buffer (longer messages are cut) and call cb.
+/// Out of line: one vsnprintf instead of a snprintf inlined per call site.
+void logFormatted(LogCallback cb, const char* fmt, ...);
+
+/// printf-style message to cb: deferred into g_logRing off the drain thread,
+/// else delivered now after whatever the ring still holds
+template <class... A>
+inline void logPrintf(LogCallback cb, const char* fmt, const A&... args) {
+    if (!cb || !fmt) return;
+    if (g_logRing.deferHere()) {
+        g_logRing.push(cb, fmt, args...);
+        return;
+    }
+    g_logRing.drain();
+    logFormatted(cb, fmt, args...);
+}
+
+/// Preformatted message (copied when deferred)
+inline void logText(LogCallback cb, const char* msg) {
+    if (msg) logPrintf(cb, "%s", msg);
+}
+
+} // namespace hl
@@ -0,0 +1,295 @@
+//=============================================================================
+// hl_platform.h - Thin platform layer: Win32 subset with a POSIX backend
+//=============================================================================
+// LAYER: Foundation | DEPENDENCIES: none
+// THREAD SAFETY: As the Win32 functions it stands for
+//
+// The foundation, transport and services layers include this header instead
+// of <windows.h> and use only the Win32 calls listed below. On Windows it is
+// <windows.h> itself; elsewhere the same names are implemented on pthreads,
+// clock_gettime and libc (hl_platform_posix.cpp), so those layers build and
+// benchmark on Linux. The API layer and the Zorro DLL stay Windows-only.
+//
+//   Mutex         CRITICAL_SECTION: Initialize/Enter/TryEnter/Leave/Delete
+//   Condition     CONDITION_VARIABLE: Initialize, SleepConditionVariableCS,
+//                 WakeAllConditionVariable
+//   Event         CreateEvent (manual/auto reset), SetEvent, ResetEvent
+//   Thread        CreateThread, GetCurrentThreadId, GetCurrentProcessId, Sleep
+//   Wait/close    WaitForSingleObject, CloseHandle on events, threads and
+//                 named mutexes
+//   Named objects CreateMutexA, ReleaseMutex, CreateFileMappingA,
+//                 MapViewOfFile, UnmapViewOfFile (shared price table)
+//   Clocks        GetTickCount, QueryPerformanceCounter/Frequency,
+//                 GetSystemTimeAsFileTime
+//   Secure zero   SecureZeroMemory
+//   Strings       sprintf_s, strncpy_s, strcpy_s, strcat_s (truncating),
+//                 _stricmp, _strnicmp, _atoi64, sscanf_s (numeric only),
+//                 fopen_s
+//   Misc          _BitScanReverse, YieldProcessor, HWND/PostMessage (no
+//                 window on POSIX: PostMessage fails)
+//   HL_SEH_TRY / HL_SEH_EXCEPT  __try/__except around calls into host code;
+//                 a plain block on POSIX (nothing to guard without Zorro)
+//
+// Anything else from Win32 needs adding here (both backends) first.
+//=============================================================================
+
+#pragma once
+
+#ifdef _WIN32
+
+#include <windows.h>
+#include <intrin.h>
+
+#define HL_SEH_TRY      __try
+#define HL_SEH_EXCEPT   __except(EXCEPTION_EXECUTE_HANDLER)
+
+#else // POSIX
+
+#include <pthread.h>
+#include <strings.h>
+#include <time.h>
+#include <unistd.h>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#define HL_SEH_TRY      if (true)
+#define HL_SEH_EXCEPT   else
+
+//-----------------------------------------------------------------------------
+// Types and constants
+//-----------------------------------------------------------------------------
+
+typedef uint32_t DWORD;
+typedef int BOOL;
+typedef unsigned char BYTE;
+typedef unsigned int UINT;
+typedef int32_t LONG;
+typedef uint64_t ULONGLONG;
+typedef void* HANDLE;
+typedef void* HWND;
+typedef void* LPVOID;
+typedef uintptr_t WPARAM;
+typedef intptr_t LPARAM;
+
+#define WINAPI
+#ifndef TRUE
+#define TRUE 1
+#define FALSE 0
+#endif
+#define INFINITE            0xFFFFFFFFu
+#define MAXDWORD            0xFFFFFFFFu
+#define WAIT_OBJECT_0       0x00000000u
+#define WAIT_ABANDONED      0x00000080u
+#define WAIT_TIMEOUT        0x00000102u
+#define WAIT_FAILED         0xFFFFFFFFu
+#define INVALID_HANDLE_VALUE ((HANDLE)(intptr_t)-1)
+#define PAGE_READWRITE      0x04
+#define FILE_MAP_ALL_ACCESS 0xF001F
+#define WM_APP              0x8000
+#define _TRUNCATE           ((size_t)-1)
+
+typedef DWORD (*LPTHREAD_START_ROUTINE)(LPVOID param);
+
+typedef union _LARGE_INTEGER {
+    struct { DWORD LowPart; LONG HighPart; };
+    long long QuadPart;
+} LARGE_INTEGER;
+
+struct FILETIME {
+    DWORD dwLowDateTime;
+    DWORD dwHighDateTime;
+};
+
+//-----------------------------------------------------------------------------
+// Mutex / condition variable (recursive, like a critical section)
+//-----------------------------------------------------------------------------
+
+struct CRITICAL_SECTION {
+    pthread_mutex_t mutex;
+};
+
+struct CONDITION_VARIABLE {
+    pthread_cond_t cond;
+};
+
+void InitializeCriticalSection(CRITICAL_SECTION* cs);
+inline void DeleteCriticalSection(CRITICAL_SECTION* cs) { pthread_mutex_destroy(&cs->mutex); }
+inline void EnterCriticalSection(CRITICAL_SECTION* cs) { pthread_mutex_lock(&cs->mutex); }
+inline void LeaveCriticalSection(CRITICAL_SECTION* cs) { pthread_mutex_unlock(&cs->mutex); }
+inline BOOL TryEnterCriticalSection(CRITICAL_SECTION* cs) { return pthread_mutex_trylock(&cs->mutex) == 0; }
+
+void InitializeConditionVariable(CONDITION_VARIABLE* cv);
+BOOL SleepConditionVariableCS(CONDITION_VARIABLE* cv, CRITICAL_SECTION* cs, DWORD ms);
+inline void WakeAllConditionVariable(CONDITION_VARIABLE* cv) { pthread_cond_broadcast(&cv->cond); }
+
+//-----------------------------------------------------------------------------
+// Kernel objects: events, threads, named mutexes, file mappings
+//-----------------------------------------------------------------------------
+
+HANDLE CreateEvent(void* attributes, BOOL manualReset, BOOL initialState, const char* name);
+BOOL SetEvent(HANDLE event);
+BOOL ResetEvent(HANDLE event);
+
+HANDLE CreateThread(void* attributes, size_t stackSize, LPTHREAD_START_ROUTINE start,
+                    LPVOID param, DWORD flags, DWORD* threadId);
+
+/// Process-shared mutex; released by the OS when the owning process exits
+HANDLE CreateMutexA(void* attributes, BOOL initialOwner, const char* name);
+BOOL ReleaseMutex(HANDLE mutex);
+
+/// Pagefile-backed mapping (shm_open); zero-filled when first created
+HANDLE CreateFileMappingA(HANDLE file, void* attributes, DWORD protect,
+                          DWORD sizeHigh, DWORD sizeLow, const char* name);
+void* MapViewOfFile(HANDLE mapping, DWORD access, DWORD offsetHigh, DWORD offsetLow, size_t size);
+BOOL UnmapViewOfFile(const void* view);
+
+DWORD WaitForSingleObject(HANDLE object, DWORD ms);
+BOOL CloseHandle(HANDLE object);
+
+inline DWORD GetCurrentProcessId() { return (DWORD)getpid(); }
+DWORD GetCurrentThreadId();
+
+inline void Sleep(DWORD ms) {
+    struct timespec ts;
+    ts.tv_sec = (time_t)(ms / 1000);
+    ts.tv_nsec = (long)(ms % 1000) * 1000000L;
+    while (nanosleep(&ts, &ts) != 0) {}
+}
+
+//-----------------------------------------------------------------------------
+// Clocks
+//-----------------------------------------------------------------------------
+
+inline DWORD GetTickCount() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (DWORD)((uint64_t)ts.tv_sec * 1000u + (uint64_t)ts.tv_nsec / 1000000u);
+}
+
+// Nanosecond ticks: QuadPart differences are already ns
+inline BOOL QueryPerformanceCounter(LARGE_INTEGER* counter) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    counter->QuadPart = (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+    return TRUE;
+}
+
+inline BOOL QueryPerformanceFrequency(LARGE_INTEGER* frequency) {
+    frequency->QuadPart = 1000000000LL;
+    return TRUE;
+}
+
+// 100 ns intervals since 1601-01-01 UTC
+inline void GetSystemTimeAsFileTime(FILETIME* ft) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    uint64_t t = (uint64_t)ts.tv_sec * 10000000u + (uint64_t)ts.tv_nsec / 100u + 116444736000000000ULL;
+    ft->dwLowDateTime = (DWORD)t;
+    ft->dwHighDateTime = (DWORD)(t >> 32);
+}
+
+//-----------------------------------------------------------------------------
+// Secure zero
+//-----------------------------------------------------------------------------
+
+inline void* SecureZeroMemory(void* dest, size_t size) {
+    volatile unsigned char* p = static_cast<volatile unsigned char*>(dest);
+    while (size--) *p++ = 0;
+    return dest;
+}
+
+//-----------------------------------------------------------------------------
+// Bounded string ops (MSVC secure CRT semantics, truncating)
+//-----------------------------------------------------------------------------
+
+inline int vsprintf_s(char* dest, size_t size, const char* format, va_list args) {
+    if (!dest || size == 0) return -1;
+    int n = vsnprintf(dest, size, format, args);
+    return (n < 0 || (size_t)n >= size) ? -1 : n;
+}
+
+inline int sprintf_s(char* dest, size_t size, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    int n = vsprintf_s(dest, size, format, args);
+    va_end(args);
+    return n;
+}
+
+template <size_t N>
+inline int sprintf_s(char (&dest)[N], const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    int n = vsprintf_s(dest, N, format, args);
+    va_end(args);
+    return n;
+}
+
+inline int strncpy_s(char* dest, size_t size, const char* src, size_t count) {
+    if (!dest || size == 0) return 22;
+    if (!src) { dest[0] = '\0'; return 22; }
+    size_t len = strnlen(src, count == _TRUNCATE ? size : count);
+    if (len >= size) len = size - 1;
+    memcpy(dest, src, len);
+    dest[len] = '\0';
+    return 0;
+}
+
+template <size_t N>
+inline int strncpy_s(char (&dest)[N], const char* src, size_t count) {
+    return strncpy_s(dest, N, src, count);
+}
+
+inline int strcpy_s(char* dest, size_t size, const char* src) {
+    return strncpy_s(dest, size, src, _TRUNCATE);
+}
+
+template <size_t N>
+inline int strcpy_s(char (&dest)[N], const char* src) {
+    return strncpy_s(dest, N, src, _TRUNCATE);
+}
+
+inline int strcat_s(char* dest, size_t size, const char* src) {
+    size_t used = strnlen(dest, size);
+    if (used >= size) return 22;
+    return strncpy_s(dest + used, size - used, src, _TRUNCATE);
+}
+
+template <size_t N>
+inline int strcat_s(char (&dest)[N], const char* src) {
+    return strcat_s(dest, N, src);
+}
+
+inline int fopen_s(FILE** file, const char* path, const char* mode) {
+    *file = fopen(path, mode);
+    return *file ? 0 : 2;
+}
+
+#define _stricmp    strcasecmp
+#define _strnicmp   strncasecmp
+#define _atoi64     atoll
+#define sscanf_s    sscanf      // Numeric conversions only (no buffer sizes)
+
+//-----------------------------------------------------------------------------
+// Misc intrinsics and GUI
+//-----------------------------------------------------------------------------
+
+inline unsigned char _BitScanReverse(unsigned long* index, unsigned long mask) {
+    if (mask == 0) return 0;
+    *index = (unsigned long)(sizeof(unsigned long) * 8 - 1 - __builtin_clzl(mask));
+    return 1;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+#define YieldProcessor() __builtin_ia32_pause()
+#else
+#define YieldProcessor() ((void)0)
+#endif
+
+inline BOOL PostMessage(HWND, UINT, WPARAM, LPARAM) { return FALSE; }
+
+#endif // _WIN32
@@ -0,0 +1,345 @@
+//=============================================================================
+// hl_platform_posix.cpp - POSIX backend for hl_platform.h
+//=============================================================================
+// LAYER: Foundation
+//
+// Kernel objects are heap objects behind HANDLE with a virtual wait(), so
+// WaitForSingleObject/CloseHandle work on any of them:
+//   Event        pthread mutex + condition variable on CLOCK_MONOTONIC
+//   Thread       pthread; a wait with a timeout waits on the exit event,
+//                then joins; closing a running thread detaches it
+//   NamedMutex   flock() on /dev/shm/<name>.lock - dropped by the kernel
+//                when the owner exits, so WAIT_ABANDONED is never reported
+//   FileMapping  shm_open(); the segment outlives its last user until
+//                reboot (Win32 drops it), which the shared table tolerates
+//
+// Built only on non-Windows targets (CMakeLists.txt).
+//=============================================================================
+
+#ifndef _WIN32
+
+#include "hl_platform.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Helpers
+//-----------------------------------------------------------------------------
+
+struct timespec deadlineAfter(DWORD ms) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    ts.tv_sec += (time_t)(ms / 1000);
+    ts.tv_nsec += (long)(ms % 1000) * 1000000L;
+    if (ts.tv_nsec >= 1000000000L) {
+        ts.tv_sec += 1;
+        ts.tv_nsec -= 1000000000L;
+    }
+    return ts;
+}
+
+void initMonotonicCond(pthread_cond_t* cond) {
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(cond, &attr);
+    pthread_condattr_destroy(&attr);
+}
+
+// Win32 object names allow '\' and ':'; shm/file names only a plain component
+std::string objectName(const char* name) {
+    std::string out = "/hl_";
+    for (const char* p = name; *p; ++p) {
+        char c = *p;
+        bool plain = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+                     (c >= '0' && c <= '9') || c == '.' || c == '-' || c == '_';
+        out += plain ? c : '_';
+    }
+    return out;
+}
+
+//-----------------------------------------------------------------------------
+// Kernel objects
+//-----------------------------------------------------------------------------
+
+struct KernelObject {
+    virtual ~KernelObject() {}
+    virtual DWORD wait(DWORD ms) = 0;
+    virtual void close() { delete this; }
+};
+
+struct Event : KernelObject {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    bool manualReset;
+    bool signaled;
+
+    Event(bool manual, bool initial) : manualReset(manual), signaled(initial) {
+        pthread_mutex_init(&mutex, nullptr);
+        initMonotonicCond(&cond);
+    }
+    ~Event() override {
+        pthread_cond_destroy(&cond);
+        pthread_mutex_destroy(&mutex);
+    }
+
+    void set() {
+        pthread_mutex_lock(&mutex);
+        signaled = true;
+        pthread_cond_broadcast(&cond);
+        pthread_mutex_unlock(&mutex);
+    }
+
+    void reset() {
+        pthread_mutex_lock(&mutex);
+        signaled = false;
+        pthread_mutex_unlock(&mutex);
+    }
+
+    DWORD wait(DWORD ms) override {
+        struct timespec deadline = deadlineAfter(ms == INFINITE ? 0 : ms);
+        pthread_mutex_lock(&mutex);
+        int rc = 0;
+        while (!signaled && rc != ETIMEDOUT) {
+            rc = ms == INFINITE ? pthread_cond_wait(&cond, &mutex)
+                                : pthread_cond_timedwait(&cond, &mutex, &deadline);
+        }
+        bool got = signaled;
+        if (got && !manualReset) signaled = false;
+        pthread_mutex_unlock(&mutex);
+        return got ? WAIT_OBJECT_0 : WAIT_TIMEOUT;
+    }
+};
+
+struct Thread : KernelObject {
+    pthread_t thread;
+    LPTHREAD_START_ROUTINE start;
+    LPVOID param;
+    Event exited;
+    bool joined;
+
+    Thread(LPTHREAD_START_ROUTINE fn, LPVOID arg)
+        : start(fn), param(arg), exited(true, false), joined(false) {}
+
+    static void* run(void* arg) {
+        Thread* self = static_cast<Thread*>(arg);
+        self->start(self->param);
+        self->exited.set();
+        return nullptr;
+    }
+
+    DWORD wait(DWORD ms) override {
+        if (exited.wait(ms) != WAIT_OBJECT_0) return WAIT_TIMEOUT;
+        if (!joined) {
+            pthread_join(thread, nullptr);
+            joined = true;
+        }
+        return WAIT_OBJECT_0;
+    }
+
+    // Win32 keeps a thread running after its handle is closed. The object
+    // must outlive run(), so a running thread leaks this small struct.
+    void close() override {
+        if (joined) { delete this; return; }
+        if (exited.wait(0) == WAIT_OBJECT_0) {
+            pthread_join(thread, nullptr);
+            delete this;
+            return;
+        }
+        pthread_detach(thread);
+    }
+};
+
+struct NamedMutex : KernelObject {
+    int fd;
+    int depth;          // Recursive like a Win32 mutex (owning thread only)
+    pthread_t owner;
+
+    explicit NamedMutex(int f) : fd(f), depth(0), owner() {}
+    ~NamedMutex() override { ::close(fd); }
+
+    DWORD wait(DWORD ms) override {
+        if (depth > 0 && pthread_equal(owner, pthread_self())) {
+            depth++;
+            return WAIT_OBJECT_0;
+        }
+        DWORD waited = 0;
+        while (flock(fd, LOCK_EX | LOCK_NB) != 0) {
+            if (errno != EWOULDBLOCK && errno != EINTR) return WAIT_FAILED;
+            if (ms != INFINITE && waited >= ms) return WAIT_TIMEOUT;
+            Sleep(1);
+            waited++;
+        }
+        owner = pthread_self();
+        depth = 1;
+        return WAIT_OBJECT_0;
+    }
+
+    bool release() {
+        if (depth == 0 || !pthread_equal(owner, pthread_self())) return false;
+        if (--depth == 0) flock(fd, LOCK_UN);
+        return true;
+    }
+};
+
+struct FileMapping : KernelObject {
+    int fd;
+    explicit FileMapping(int f) : fd(f) {}
+    ~FileMapping() override { ::close(fd); }
+    DWORD wait(DWORD) override { return WAIT_FAILED; }
+};
+
+// MapViewOfFile views -> length for munmap
+std::mutex s_viewsMutex;
+std::map<const void*, size_t> s_views;
+
+} // namespace
+
+//=============================================================================
+// MUTEX / CONDITION VARIABLE
+//=============================================================================
+
+void InitializeCriticalSection(CRITICAL_SECTION* cs) {
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&cs->mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+}
+
+void InitializeConditionVariable(CONDITION_VARIABLE* cv) {
+    initMonotonicCond(&cv->cond);
+}
+
+BOOL SleepConditionVariableCS(CONDITION_VARIABLE* cv, CRITICAL_SECTION* cs, DWORD ms) {
+    if (ms == INFINITE) return pthread_cond_wait(&cv->cond, &cs->mutex) == 0;
+    struct timespec deadline = deadlineAfter(ms);
+    return pthread_cond_timedwait(&cv->cond, &cs->mutex, &deadline) == 0;
+}
+
+//=============================================================================
+// EVENTS / THREADS
+//=============================================================================
+
+HANDLE CreateEvent(void*, BOOL manualReset, BOOL initialState, const char*) {
+    return static_cast<KernelObject*>(new Event(manualReset != FALSE, initialState != FALSE));
+}
+
+BOOL SetEvent(HANDLE event) {
+    Event* e = dynamic_cast<Event*>(static_cast<KernelObject*>(event));
+    if (!e) return FALSE;
+    e->set();
+    return TRUE;
+}
+
+BOOL ResetEvent(HANDLE event) {
+    Event* e = dynamic_cast<Event*>(static_cast<KernelObject*>(event));
+    if (!e) return FALSE;
+    e->reset();
+    return TRUE;
+}
+
+HANDLE CreateThread(void*, size_t stackSize, LPTHREAD_START_ROUTINE start, LPVOID param,
+                    DWORD, DWORD* threadId) {
+    Thread* t = new Thread(start, param);
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    if (stackSize) pthread_attr_setstacksize(&attr, stackSize);
+    int rc = pthread_create(&t->thread, &attr, &Thread::run, t);
+    pthread_attr_destroy(&attr);
+    if (rc != 0) {
+        delete t;
+        return NULL;
+    }
+    if (threadId) *threadId = 0;
+    return static_cast<KernelObject*>(t);
+}
+
+DWORD GetCurrentThreadId() {
+#ifdef SYS_gettid
+    return (DWORD)syscall(SYS_gettid);
+#else
+    return (DWORD)(uintptr_t)pthread_self();
+#endif
+}
+
+//=============================================================================
+// NAMED MUTEX / FILE MAPPING
+//=============================================================================
+
+HANDLE CreateMutexA(void*, BOOL initialOwner, const char* name) {
+    if (!name) return NULL;
+    std::string path = "/dev/shm" + objectName(name) + ".lock";
+    int fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (fd < 0) return NULL;
+    NamedMutex* m = new NamedMutex(fd);
+    if (initialOwner) m->wait(INFINITE);
+    return static_cast<KernelObject*>(m);
+}
+
+BOOL ReleaseMutex(HANDLE mutex) {
+    NamedMutex* m = dynamic_cast<NamedMutex*>(static_cast<KernelObject*>(mutex));
+    return m && m->release();
+}
+
+HANDLE CreateFileMappingA(HANDLE, void*, DWORD, DWORD sizeHigh, DWORD sizeLow, const char* name) {
+    if (!name) return NULL;
+    int fd = shm_open(objectName(name).c_str(), O_RDWR | O_CREAT, 0600);
+    if (fd < 0) return NULL;
+    off_t size = (off_t)(((uint64_t)sizeHigh << 32) | sizeLow);
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (st.st_size < size && ftruncate(fd, size) != 0)) {
+        ::close(fd);
+        return NULL;
+    }
+    return static_cast<KernelObject*>(new FileMapping(fd));
+}
+
+void* MapViewOfFile(HANDLE mapping, DWORD, DWORD offsetHigh, DWORD offsetLow, size_t size) {
+    FileMapping* m = dynamic_cast<FileMapping*>(static_cast<KernelObject*>(mapping));
+    if (!m || size == 0) return nullptr;
+    off_t offset = (off_t)(((uint64_t)offsetHigh << 32) | offsetLow);
+    void* view = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, m->fd, offset);
+    if (view == MAP_FAILED) return nullptr;
+    std::lock_guard<std::mutex> lock(s_viewsMutex);
+    s_views[view] = size;
+    return view;
+}
+
+BOOL UnmapViewOfFile(const void* view) {
+    size_t size = 0;
+    {
+        std::lock_guard<std::mutex> lock(s_viewsMutex);
+        auto it = s_views.find(view);
+        if (it == s_views.end()) return FALSE;
+        size = it->second;
+        s_views.erase(it);
+    }
+    return munmap(const_cast<void*>(view), size) == 0;
+}
+
+//=============================================================================
+// WAIT / CLOSE
+//=============================================================================
+
+DWORD WaitForSingleObject(HANDLE object, DWORD ms) {
+    if (!object || object == INVALID_HANDLE_VALUE) return WAIT_FAILED;
+    return static_cast<KernelObject*>(object)->wait(ms);
+}
+
+BOOL CloseHandle(HANDLE object) {
+    if (!object || object == INVALID_HANDLE_VALUE) return FALSE;
+    static_cast<KernelObject*>(object)->close();
+    return TRUE;
+}
+
+#endif // !_WIN32
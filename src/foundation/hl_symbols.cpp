@@ -0,0 +1,138 @@
+//=============================================================================
+// hl_symbols.cpp - Coin intern table implementation
+//=============================================================================
+// LAYER: Foundation | DEPENDENCIES: hl_symbols.h
+//
+// Open addressing over a fixed slot array. A slot is written once: its id is
+// stored, then its key pointer is published with release; readers probe with
+// acquire loads and stop at the first empty slot. Slots are never cleared,
+// so a reader racing a writer either sees the new key or an empty slot —
+// both correct answers for a form that is being added.
+//=============================================================================
+
+#include "hl_symbols.h"
+#include <cstring>
+
+namespace hl {
+
+SymbolTable g_symbols;
+
+static const uint32_t SLOT_MASK = (uint32_t)config::SYMBOL_TABLE_SLOTS - 1;
+static const int SLOT_LIMIT = config::SYMBOL_TABLE_SLOTS / 4 * 3;   // Keeps probes short
+
+static_assert((config::SYMBOL_TABLE_SLOTS & (config::SYMBOL_TABLE_SLOTS - 1)) == 0,
+              "SYMBOL_TABLE_SLOTS must be a power of 2");
+static_assert(config::SYMBOL_MAX_IDS <= 0xFFFF, "OrderRecord stores coin ids in 16 bits");
+
+// FNV-1a, fed piecewise so find(prefix, sep, name) hashes like the joined form
+static inline uint32_t hashStep(uint32_t h, const char* s) {
+    while (*s) {
+        h ^= (unsigned char)*s++;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static inline uint32_t hashChar(uint32_t h, char c) {
+    return (h ^ (unsigned char)c) * 16777619u;
+}
+
+static const uint32_t HASH_BASIS = 2166136261u;
+
+// key == prefix + sep + name
+static bool matchesJoined(const char* key, const char* prefix, char sep, const char* name) {
+    while (*prefix) if (*key++ != *prefix++) return false;
+    if (*key++ != sep) return false;
+    return strcmp(key, name) == 0;
+}
+
+SymbolTable::SymbolTable() : count_(0), usedSlots_(0) {
+    for (int i = 0; i < config::SYMBOL_TABLE_SLOTS; ++i) {
+        slots_[i].key.store(nullptr, std::memory_order_relaxed);
+        slots_[i].id = 0;
+    }
+    for (int i = 0; i < config::SYMBOL_MAX_IDS; ++i)
+        names_[i].store(nullptr, std::memory_order_relaxed);
+    InitializeCriticalSection(&cs_);
+}
+
+SymbolTable::~SymbolTable() {
+    DeleteCriticalSection(&cs_);
+}
+
+uint32_t SymbolTable::find(const char* name) const {
+    if (!name || !*name) return 0;
+    uint32_t i = hashStep(HASH_BASIS, name) & SLOT_MASK;
+    for (int probes = 0; probes < config::SYMBOL_TABLE_SLOTS; ++probes) {
+        const char* key = slots_[i].key.load(std::memory_order_acquire);
+        if (!key) return 0;
+        if (strcmp(key, name) == 0) return slots_[i].id;
+        i = (i + 1) & SLOT_MASK;
+    }
+    return 0;
+}
+
+uint32_t SymbolTable::find(const char* prefix, char sep, const char* name) const {
+    if (!prefix || !*prefix) return find(name);
+    if (!name || !*name) return 0;
+    uint32_t i = hashStep(hashChar(hashStep(HASH_BASIS, prefix), sep), name) & SLOT_MASK;
+    for (int probes = 0; probes < config::SYMBOL_TABLE_SLOTS; ++probes) {
+        const char* key = slots_[i].key.load(std::memory_order_acquire);
+        if (!key) return 0;
+        if (matchesJoined(key, prefix, sep, name)) return slots_[i].id;
+        i = (i + 1) & SLOT_MASK;
+    }
+    return 0;
+}
+
+const char* SymbolTable::name(uint32_t id) const {
+    if (id == 0 || id >= (uint32_t)config::SYMBOL_MAX_IDS) return "";
+    const char* p = names_[id].load(std::memory_order_acquire);
+    return p ? p : "";
+}
+
+uint32_t SymbolTable::insertLocked(const char* form, uint32_t id) {
+    if (usedSlots_ >= SLOT_LIMIT) return 0;
+    storage_.push_back(form);
+    const char* key = storage_.back().c_str();
+    if (names_[id].load(std::memory_order_relaxed) == nullptr)
+        names_[id].store(key, std::memory_order_release);
+
+    uint32_t i = hashStep(HASH_BASIS, key) & SLOT_MASK;
+    while (slots_[i].key.load(std::memory_order_relaxed)) i = (i + 1) & SLOT_MASK;
+    slots_[i].id = id;
+    slots_[i].key.store(key, std::memory_order_release);
+    usedSlots_++;
+    return id;
+}
+
+uint32_t SymbolTable::intern(const char* name) {
+    uint32_t id = find(name);
+    if (id || !name || !*name) return id;
+
+    EnterCriticalSection(&cs_);
+    id = find(name);    // Another writer may have added it meanwhile
+    if (!id) {
+        uint32_t next = count_.load(std::memory_order_relaxed) + 1;
+        if (next < (uint32_t)config::SYMBOL_MAX_IDS && insertLocked(name, next)) {
+            count_.store(next, std::memory_order_release);
+            id = next;
+        }
+    }
+    LeaveCriticalSection(&cs_);
+    return id;
+}
+
+uint32_t SymbolTable::alias(const char* form, uint32_t id) {
+    if (!form || !*form || id == 0 || id > count()) return 0;
+    uint32_t existing = find(form);
+    if (existing) return existing;
+
+    EnterCriticalSection(&cs_);
+    existing = find(form);
+    if (!existing) existing = insertLocked(form, id);
+    LeaveCriticalSection(&cs_);
+    return existing;
+}
+
+} // namespace hl
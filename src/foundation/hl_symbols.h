@@ -0,0 +1,76 @@
+//=============================================================================
+// hl_symbols.h - Coin intern table: every coin form -> dense integer id
+//=============================================================================
+// LAYER: Foundation | DEPENDENCIES: hl_config.h
+// THREAD SAFETY: find()/name() are lock-free and never allocate; intern()
+//                and alias() serialize on an internal lock
+//
+// Coins arrive as "BTC", "xyz:GOLD", "@107", "PURR/USDC" and are shown to
+// Zorro as display names ("BTC-USDC", "GOLD-USDC_xyz"). AssetRegistry::add
+// interns the API coin of every asset at meta load and aliases the other
+// forms to the same id. Hot structures (PriceCache prices, l2Book dedup,
+// subscription watermarks, fill store, trade records) are keyed by that id;
+// strings are converted only at the Zorro and JSON boundaries.
+//
+// Ids are never reused or dropped (not even by a meta reload), so a cached
+// id stays valid for the life of the process. Id 0 = no coin.
+//=============================================================================
+
+#pragma once
+
+#include "hl_config.h"
+#include "hl_platform.h"
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <string>
+
+namespace hl {
+
+class SymbolTable {
+public:
+    SymbolTable();
+    ~SymbolTable();
+
+    SymbolTable(const SymbolTable&) = delete;
+    SymbolTable& operator=(const SymbolTable&) = delete;
+
+    /// Id of `name`, adding it if new. 0 for an empty name or a full table.
+    uint32_t intern(const char* name);
+
+    /// Make `form` resolve to `id` (display names, "dex_COIN"). The first
+    /// mapping of a form wins. @return the id `form` resolves to (0 if full)
+    uint32_t alias(const char* form, uint32_t id);
+
+    /// Id of `name`, 0 if never interned
+    uint32_t find(const char* name) const;
+
+    /// Id of "<prefix><sep><name>" (e.g. "xyz" ':' "GOLD") without building it
+    uint32_t find(const char* prefix, char sep, const char* name) const;
+
+    /// Interned form of an id ("" if unknown); the pointer never dangles
+    const char* name(uint32_t id) const;
+
+    /// Ids handed out so far (ids are 1..count())
+    uint32_t count() const { return count_.load(std::memory_order_acquire); }
+
+private:
+    struct Slot {
+        std::atomic<const char*> key;   // Published last (release)
+        uint32_t id;
+    };
+
+    Slot slots_[config::SYMBOL_TABLE_SLOTS];
+    std::atomic<const char*> names_[config::SYMBOL_MAX_IDS];
+    std::atomic<uint32_t> count_;
+    int usedSlots_;                     // Writer only
+    std::deque<std::string> storage_;   // Writer only; elements never move
+    CRITICAL_SECTION cs_;
+
+    // Caller holds cs_
+    uint32_t insertLocked(const char* form, uint32_t id);
+};
+
+extern SymbolTable g_symbols;
+
+} // namespace hl
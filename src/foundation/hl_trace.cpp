@@ -0,0 +1,250 @@
+//=============================================================================
+// hl_trace.cpp - Per-order lifecycle trace implementation
+//=============================================================================
+// LAYER: Foundation | DEPENDENCIES: hl_trace.h
+//=============================================================================
+
+#include "hl_trace.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <vector>
+
+namespace hl {
+namespace trace {
+
+std::atomic<bool> g_enabled(false);
+
+namespace {
+
+static_assert((config::TRACE_CAPACITY & (config::TRACE_CAPACITY - 1)) == 0,
+              "TRACE_CAPACITY must be a power of 2");
+const uint64_t MASK = (uint64_t)config::TRACE_CAPACITY - 1;
+
+// One slot of the ring. seq is odd while a writer fills it (seqlock, as in
+// the shared price table); index tells flush() which event the slot holds.
+struct Event {
+    std::atomic<uint32_t> seq;
+    uint64_t index;
+    char phase;                     // 'X' complete, 'i' instant
+    const char* name;
+    const char* cat;
+    DWORD tid;
+    int tradeId;
+    uint64_t ts;                    // lat::now() ticks
+    uint64_t dur;
+    char cloid[40];
+    char detail[48];
+};
+
+struct Snapshot {
+    char phase;
+    const char* name;
+    const char* cat;
+    DWORD tid;
+    int tradeId;
+    uint64_t ts;
+    uint64_t dur;
+    char cloid[40];
+    char detail[48];
+};
+
+std::atomic<Event*> s_ring(nullptr);
+std::atomic<uint64_t> s_next(0);        // Next event index
+std::atomic<uint64_t> s_base(0);        // First index not yet flushed/cleared
+std::atomic<long long> s_dropped(0);    // Slot still being written by a lapped writer
+
+double usPerTick() {
+    static const double v = []() {
+        LARGE_INTEGER f;
+        QueryPerformanceFrequency(&f);
+        return f.QuadPart > 0 ? 1e6 / (double)f.QuadPart : 1.0;
+    }();
+    return v;
+}
+
+void copyText(char* dst, size_t size, const char* src) {
+    if (src) strncpy_s(dst, size, src, _TRUNCATE);
+    else dst[0] = 0;
+}
+
+void record(char phase, const char* name, const char* cat, uint64_t ts, uint64_t dur,
+            int tradeId, const char* cloid, const char* detail) {
+    Event* ring = s_ring.load(std::memory_order_acquire);
+    if (!ring) return;
+    uint64_t idx = s_next.fetch_add(1, std::memory_order_relaxed);
+    Event& e = ring[idx & MASK];
+    uint32_t seq = e.seq.load(std::memory_order_relaxed);
+    if ((seq & 1) || !e.seq.compare_exchange_strong(seq, seq + 1, std::memory_order_acquire)) {
+        s_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    e.index = idx;
+    e.phase = phase;
+    e.name = name;
+    e.cat = cat;
+    e.tid = GetCurrentThreadId();
+    e.tradeId = tradeId;
+    e.ts = ts;
+    e.dur = dur;
+    copyText(e.cloid, sizeof(e.cloid), cloid);
+    copyText(e.detail, sizeof(e.detail), detail);
+    e.seq.store(seq + 2, std::memory_order_release);
+}
+
+// Consistent copies of the events in [base, next) still in the ring
+std::vector<Snapshot> collect(uint64_t base, uint64_t next) {
+    std::vector<Snapshot> out;
+    Event* ring = s_ring.load(std::memory_order_acquire);
+    if (!ring) return out;
+    uint64_t lo = next - base > MASK + 1 ? next - (MASK + 1) : base;
+    out.reserve((size_t)(next - lo));
+    for (uint64_t i = lo; i < next; i++) {
+        Event& e = ring[i & MASK];
+        uint32_t before = e.seq.load(std::memory_order_acquire);
+        if (before & 1) continue;
+        Snapshot s;
+        uint64_t index = e.index;
+        s.phase = e.phase;
+        s.name = e.name;
+        s.cat = e.cat;
+        s.tid = e.tid;
+        s.tradeId = e.tradeId;
+        s.ts = e.ts;
+        s.dur = e.dur;
+        memcpy(s.cloid, e.cloid, sizeof(s.cloid));
+        memcpy(s.detail, e.detail, sizeof(s.detail));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (e.seq.load(std::memory_order_relaxed) != before || index != i) continue;
+        s.cloid[sizeof(s.cloid) - 1] = 0;
+        s.detail[sizeof(s.detail) - 1] = 0;
+        out.push_back(s);
+    }
+    return out;
+}
+
+void writeString(FILE* f, const char* s) {
+    fputc('"', f);
+    for (; s && *s; s++) {
+        unsigned char c = (unsigned char)*s;
+        if (c == '"' || c == '\\') { fputc('\\', f); fputc(c, f); }
+        else if (c < 0x20) fprintf(f, "\\u%04x", c);
+        else fputc(c, f);
+    }
+    fputc('"', f);
+}
+
+void writeArgs(FILE* f, const Snapshot& s) {
+    fprintf(f, ",\"args\":{\"tradeId\":%d", s.tradeId);
+    if (s.cloid[0]) { fprintf(f, ",\"cloid\":"); writeString(f, s.cloid); }
+    if (s.detail[0]) { fprintf(f, ",\"detail\":"); writeString(f, s.detail); }
+    fprintf(f, "}}");
+}
+
+} // namespace
+
+void setEnabled(bool on) {
+    if (on && !s_ring.load(std::memory_order_acquire)) {
+        Event* ring = new Event[config::TRACE_CAPACITY];
+        for (int i = 0; i < config::TRACE_CAPACITY; i++) {
+            ring[i].seq.store(0, std::memory_order_relaxed);
+            ring[i].index = ~0ULL;
+        }
+        Event* expected = nullptr;
+        if (!s_ring.compare_exchange_strong(expected, ring, std::memory_order_acq_rel))
+            delete[] ring;
+    }
+    g_enabled.store(on, std::memory_order_release);
+}
+
+void instant(const char* name, const char* cat, int tradeId, const char* cloid, const char* detail) {
+    if (!enabled()) return;
+    record('i', name, cat, lat::now(), 0, tradeId, cloid, detail);
+}
+
+void complete(const char* name, const char* cat, uint64_t startTicks, int tradeId,
+              const char* cloid, const char* detail) {
+    uint64_t end = lat::now();
+    record('X', name, cat, startTicks, end > startTicks ? end - startTicks : 0, tradeId, cloid, detail);
+}
+
+void Span::setOrder(int tradeId, const char* cloid) {
+    tradeId_ = tradeId;
+    if (start_ && cloid) copyText(cloid_, sizeof(cloid_), cloid);
+}
+
+void Span::setDetail(const char* detail) {
+    if (start_) copyText(detail_, sizeof(detail_), detail);
+}
+
+int flush(const char* path) {
+    if (!path || !*path) return -1;
+    FILE* f = nullptr;
+    if (fopen_s(&f, path, "w") != 0 || !f) return -1;
+
+    uint64_t next = s_next.load(std::memory_order_acquire);
+    std::vector<Snapshot> events = collect(s_base.load(std::memory_order_relaxed), next);
+    std::stable_sort(events.begin(), events.end(),
+                     [](const Snapshot& a, const Snapshot& b) { return a.ts < b.ts; });
+
+    // Timestamps relative to the first event; one async track per order
+    uint64_t origin = events.empty() ? 0 : events.front().ts;
+    const double us = usPerTick();
+    std::map<int, std::pair<uint64_t, uint64_t>> orders;
+    for (const Snapshot& s : events) {
+        if (s.tradeId <= 0) continue;
+        auto it = orders.find(s.tradeId);
+        if (it == orders.end()) it = orders.insert(std::make_pair(s.tradeId, std::make_pair(s.ts, s.ts))).first;
+        it->second.second = (std::max)(it->second.second, s.ts + s.dur);
+    }
+
+    DWORD pid = GetCurrentProcessId();
+    fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    fprintf(f, "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":%lu,\"tid\":0,"
+               "\"args\":{\"name\":\"%s\"}}", (unsigned long)pid, config::PLUGIN_NAME);
+    for (const Snapshot& s : events) {
+        fprintf(f, ",\n{\"ph\":\"%c\",\"name\":", s.phase);
+        writeString(f, s.name);
+        fprintf(f, ",\"cat\":");
+        writeString(f, s.cat);
+        fprintf(f, ",\"pid\":%lu,\"tid\":%lu,\"ts\":%.3f", (unsigned long)pid, (unsigned long)s.tid,
+                (double)(s.ts - origin) * us);
+        if (s.phase == 'X') fprintf(f, ",\"dur\":%.3f", (double)s.dur * us);
+        else fprintf(f, ",\"s\":\"t\"");
+        writeArgs(f, s);
+    }
+    for (const auto& o : orders) {
+        for (int end = 0; end < 2; end++) {
+            uint64_t ts = end ? o.second.second : o.second.first;
+            fprintf(f, ",\n{\"ph\":\"%c\",\"name\":\"order %d\",\"cat\":\"order\",\"id\":%d,"
+                       "\"pid\":%lu,\"tid\":0,\"ts\":%.3f}",
+                    end ? 'e' : 'b', o.first, o.first, (unsigned long)pid, (double)(ts - origin) * us);
+        }
+    }
+    fprintf(f, "\n]}\n");
+    fclose(f);
+
+    s_base.store(next, std::memory_order_relaxed);
+    return (int)events.size();
+}
+
+void clear() {
+    s_base.store(s_next.load(std::memory_order_acquire), std::memory_order_relaxed);
+    s_dropped.store(0, std::memory_order_relaxed);
+}
+
+TraceStats getStats() {
+    TraceStats st;
+    st.enabled = enabled();
+    st.capacity = config::TRACE_CAPACITY;
+    uint64_t next = s_next.load(std::memory_order_relaxed);
+    uint64_t base = s_base.load(std::memory_order_relaxed);
+    st.recorded = next > base ? (long long)(next - base) : 0;
+    long long over = st.recorded - config::TRACE_CAPACITY;
+    st.overwritten = (over > 0 ? over : 0) + s_dropped.load(std::memory_order_relaxed);
+    return st;
+}
+
+} // namespace trace
+} // namespace hl
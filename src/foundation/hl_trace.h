@@ -0,0 +1,86 @@
+//=============================================================================
+// hl_trace.h - Per-order lifecycle trace, exported as Chrome trace JSON
+//=============================================================================
+// LAYER: Foundation | DEPENDENCIES: hl_config.h, hl_latency.h (clock)
+// THREAD SAFETY: Span/instant from any thread (lock-free); flush()/clear()
+//                from one thread at a time (Zorro's)
+//
+// Spans (BrokerBuy2, getPrice, placeOrder, HTTP /exchange) and instants
+// (orderUpdates/userFills pushes, BrokerTrade first seeing a fill) are
+// tagged with the tradeId and cloid they belong to and stored in a bounded
+// ring (TRACE_CAPACITY events, oldest overwritten). flush() writes them as
+// Chrome trace-event JSON for Perfetto / chrome://tracing: one track per
+// thread, plus one async track per tradeId spanning that order's events.
+//
+// Off (the default) every call is one relaxed load and a branch; the ring
+// is allocated on first enable. Names and categories must be literals
+// (kept by pointer); cloid and detail are copied and truncated.
+//=============================================================================
+
+#pragma once
+
+#include "hl_config.h"
+#include "hl_latency.h"
+#include "hl_platform.h"
+#include <atomic>
+#include <cstdint>
+
+namespace hl {
+namespace trace {
+
+struct TraceStats {
+    bool enabled = false;
+    long long recorded = 0;         // Events stored since the last flush/clear
+    long long overwritten = 0;      // Of those, lost to the ring wrapping
+    int capacity = 0;
+};
+
+extern std::atomic<bool> g_enabled;
+
+inline bool enabled() { return g_enabled.load(std::memory_order_relaxed); }
+
+/// Turn recording on (allocates the ring once) or off (keeps what was recorded)
+void setEnabled(bool on);
+
+/// Point event on the calling thread
+void instant(const char* name, const char* cat, int tradeId, const char* cloid,
+             const char* detail = nullptr);
+
+/// Event from startTicks (lat::now()) to now on the calling thread
+void complete(const char* name, const char* cat, uint64_t startTicks, int tradeId,
+              const char* cloid, const char* detail);
+
+/// Writes every stored event as Chrome trace JSON and empties the ring.
+/// Returns the number of events written, -1 if the file cannot be opened.
+int flush(const char* path);
+
+void clear();
+TraceStats getStats();
+
+/// Scoped span: free when tracing is off; order and detail may be filled in
+/// once known (e.g. the cloid after placement)
+class Span {
+public:
+    Span(const char* name, const char* cat)
+        : name_(name), cat_(cat), start_(enabled() ? lat::now() : 0),
+          tradeId_(0) { cloid_[0] = 0; detail_[0] = 0; }
+    ~Span() { if (start_) complete(name_, cat_, start_, tradeId_, cloid_, detail_); }
+
+    Span(const Span&) = delete;
+    Span& operator=(const Span&) = delete;
+
+    bool active() const { return start_ != 0; }
+    void setOrder(int tradeId, const char* cloid = nullptr);
+    void setDetail(const char* detail);
+
+private:
+    const char* name_;
+    const char* cat_;
+    uint64_t start_;
+    int tradeId_;
+    char cloid_[40];
+    char detail_[48];
+};
+
+} // namespace trace
+} // namespace hl
@@ -59,6 +59,7 @@ struct AssetInfo {
     // Spot support
     bool isSpot = false;
     char spotCoin[32] = {0};    // API coin name for spot (e.g., "@107", "PURR/USDC")
+    uint32_t symbolId = 0;      // g_symbols id of the API coin (set by AssetRegistry::add)
 };
 
 // === Order Tracking ===
@@ -77,6 +78,33 @@ struct OrderState {
     char lastError[256] = {0};
 };
 
+// Compact trade-map record: the fields BrokerTrade and the WS callbacks touch,
+// in one cache line. Strings without a compact form (synthetic PENDING_/
+// RESUMED_/IMPORTED_ oids, non-hex cloids, errors) are kept out of line by
+// TradingState; OrderState stays the full view.
+enum class OidKind : uint8_t { None, Exchange, Text };     // Exchange = numeric oid
+enum class CloidKind : uint8_t { None, Hex128, Text };     // Hex128 = "0x" + 32 hex
+
+struct alignas(64) OrderRecord {
+    uint64_t oid = 0;               // OidKind::Exchange
+    uint64_t cloidHi = 0;           // CloidKind::Hex128
+    uint64_t cloidLo = 0;
+    double requestedSize = 0.0;
+    double filledSize = 0.0;
+    double avgPrice = 0.0;
+    double lastUpdate = 0.0;        // DATE of last update
+    uint16_t coinId = 0;            // TradingState::coinName()
+    uint16_t syncEpoch = 0;         // Order-feed epoch last confirmed in (0 = never)
+    uint8_t side = 0;               // OrderSide
+    uint8_t status = 0;             // OrderStatus
+    OidKind oidKind = OidKind::None;
+    CloidKind cloidKind = CloidKind::None;
+
+    OrderSide orderSide() const { return static_cast<OrderSide>(side); }
+    OrderStatus orderStatus() const { return static_cast<OrderStatus>(status); }
+};
+static_assert(sizeof(OrderRecord) == 64, "OrderRecord must stay one cache line");
+
 // === Position Data ===
 
 struct Position {
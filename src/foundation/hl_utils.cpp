@@ -1,18 +1,17 @@
 //=============================================================================
 // hl_utils.cpp - Pure utility functions implementation
 //=============================================================================
-// LAYER: Foundation | DEPENDENCIES: hl_utils.h
+// LAYER: Foundation | DEPENDENCIES: hl_utils.h, hl_decimal.h
 //=============================================================================
 
 #include "hl_utils.h"
-#include <windows.h>
+#include "hl_decimal.h"
+#include "hl_platform.h"
 #include <cstring>
 #include <cstdlib>
 #include <cstdio>
 #include <cmath>
 #include <ctime>
-#include <sstream>
-#include <iomanip>
 
 namespace hl {
 namespace utils {
@@ -162,7 +161,7 @@ double roundPriceForExchange(double price, int szDecimals, int maxDecimals) {
     if (price == 0.0) return 0.0;
 
     // Guard: reject non-finite values (NaN, infinity)
-    if (!isfinite(price)) return 0.0;
+    if (!std::isfinite(price)) return 0.0;
 
     // Guard: reject negative prices (exchange prices are always positive)
     if (price < 0.0) return 0.0;
@@ -191,38 +190,27 @@ std::string formatPriceForExchange(double price, int szDecimals, int maxDecimals
     int maxDecPlaces = maxDecimals - szDecimals;
     if (maxDecPlaces < 0) maxDecPlaces = 0;
 
-    std::ostringstream oss;
-    oss << std::fixed << std::setprecision(maxDecPlaces) << rounded;
-    std::string s = oss.str();
-
-    // Strip trailing zeros after decimal point
-    size_t dot = s.find('.');
-    if (dot != std::string::npos) {
-        size_t end = s.find_last_not_of('0');
-        if (end != std::string::npos)
-            s = s.substr(0, end + 1);
-        if (!s.empty() && s.back() == '.')
-            s.pop_back();
-    }
-    return s;
+    char buf[decimal::MAX_FIXED_CHARS];
+    int n = decimal::formatTrimmed(rounded, maxDecPlaces, buf, sizeof(buf));
+    return n < 0 ? std::string() : std::string(buf, n);
 }
 
 std::string formatSize(double size, int szDecimals) {
     if (szDecimals < 0) szDecimals = 0;
     if (szDecimals > 15) szDecimals = 15;
 
-    std::ostringstream oss;
-    oss << std::fixed << std::setprecision(szDecimals) << size;
-    return oss.str();
+    char buf[decimal::MAX_FIXED_CHARS];
+    int n = decimal::formatFixed(size, szDecimals, buf, sizeof(buf));
+    return n < 0 ? std::string() : std::string(buf, n);
 }
 
 std::string formatPrice(double price, int pxDecimals) {
     if (pxDecimals < 0) pxDecimals = 0;
     if (pxDecimals > 15) pxDecimals = 15;
 
-    std::ostringstream oss;
-    oss << std::fixed << std::setprecision(pxDecimals) << price;
-    return oss.str();
+    char buf[decimal::MAX_FIXED_CHARS];
+    int n = decimal::formatFixed(price, pxDecimals, buf, sizeof(buf));
+    return n < 0 ? std::string() : std::string(buf, n);
 }
 
 } // namespace utils
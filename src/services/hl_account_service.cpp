@@ -13,6 +13,7 @@
 #include "../transport/ws_manager.h"
 #include "../transport/ws_parsers.h"
 #include "../transport/json_helpers.h"
+#include <cmath>
 #include <cstdio>
 #include <cstring>
 #include <set>
@@ -179,7 +180,7 @@ double refreshSpotBalance() {
     }
 
     // Parse with yyjson
-    yyjson_doc* doc = yyjson_read(resp.body.c_str(), resp.body.length(), 0);
+    yyjson_doc* doc = json::parse(resp.body.c_str(), resp.body.length());
     if (!doc) {
         logMsg(1, "refreshSpotBalance", "JSON parse error");
         return 0.0;
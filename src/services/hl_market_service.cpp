@@ -8,14 +8,17 @@
 #include "hl_meta.h"
 #include "../foundation/hl_globals.h"
 #include "../foundation/hl_utils.h"
+#include "../foundation/hl_trace.h"
 #include "../transport/hl_http.h"
 #include "../transport/json_helpers.h"
 #include "../transport/ws_price_cache.h"
 #include "../transport/ws_manager.h"
-#include <map>
+#include "../transport/ws_parsers.h"
 #include <cstdio>
 #include <cstring>
 #include <cstdlib>
+#include <map>
+#include <string>
 
 namespace hl {
 namespace market {
@@ -24,8 +27,9 @@ namespace market {
 // INTERNAL STATE
 // =============================================================================
 
-// HTTP seed cooldown tracking (coin -> last seed time in GetTickCount)
-static std::map<std::string, DWORD> s_seedTimes;
+// HTTP seed cooldown tracking: g_symbols id -> last seed time in
+// GetTickCount (0 = never seeded)
+static DWORD s_seedTimes[config::SYMBOL_MAX_IDS];
 static CRITICAL_SECTION s_seedCs;
 static bool s_seedCsInit = false;
 
@@ -37,6 +41,20 @@ static void ensureSeedCsInit() {
     }
 }
 
+// Asset-context pulls: dex key ("" main perps, perpDex name, SPOT_CTX_KEY)
+// -> GetTickCount of the last attempt
+static const char* SPOT_CTX_KEY = "@spot";
+static std::map<std::string, DWORD> s_ctxPulls;
+static CRITICAL_SECTION s_ctxCs;
+static bool s_ctxCsInit = false;
+
+static void ensureCtxCsInit() {
+    if (!s_ctxCsInit) {
+        InitializeCriticalSection(&s_ctxCs);
+        s_ctxCsInit = true;
+    }
+}
+
 // =============================================================================
 // LOGGING HELPER
 // =============================================================================
@@ -56,15 +74,18 @@ static void logMsg(int level, const char* prefix, const char* msg) {
 bool canSeedHttp(const char* coin) {
     if (!coin || !g_config.enableHttpSeed) return false;
 
+    uint32_t id = g_symbols.find(coin);
+    if (!id) return true;   // Never seeded (recordSeed interns)
+
     ensureSeedCsInit();
     EnterCriticalSection(&s_seedCs);
 
-    auto it = s_seedTimes.find(std::string(coin));
+    DWORD last = s_seedTimes[id];
     DWORD now = GetTickCount();
     bool canSeed = true;
 
-    if (it != s_seedTimes.end()) {
-        DWORD elapsed = now - it->second;
+    if (last != 0) {
+        DWORD elapsed = now - last;
         canSeed = (elapsed >= (DWORD)g_config.httpSeedCooldownMs);
     }
 
@@ -74,42 +95,63 @@ bool canSeedHttp(const char* coin) {
 
 void recordSeed(const char* coin) {
     if (!coin) return;
+    uint32_t id = g_symbols.intern(coin);
+    if (!id) return;
 
     ensureSeedCsInit();
     EnterCriticalSection(&s_seedCs);
-    s_seedTimes[std::string(coin)] = GetTickCount();
+    DWORD now = GetTickCount();
+    s_seedTimes[id] = now ? now : 1;
     LeaveCriticalSection(&s_seedCs);
 }
 
 void clearSeedCooldowns() {
     ensureSeedCsInit();
     EnterCriticalSection(&s_seedCs);
-    s_seedTimes.clear();
+    memset(s_seedTimes, 0, sizeof(s_seedTimes));
     LeaveCriticalSection(&s_seedCs);
 }
 
 void cleanup() {
     if (s_seedCsInit) {
         EnterCriticalSection(&s_seedCs);
-        s_seedTimes.clear();
+        memset(s_seedTimes, 0, sizeof(s_seedTimes));
         LeaveCriticalSection(&s_seedCs);
         DeleteCriticalSection(&s_seedCs);
         s_seedCsInit = false;
     }
+    if (s_ctxCsInit) {
+        EnterCriticalSection(&s_ctxCs);
+        s_ctxPulls.clear();
+        LeaveCriticalSection(&s_ctxCs);
+        DeleteCriticalSection(&s_ctxCs);
+        s_ctxCsInit = false;
+    }
+    g_assetCtx.clear();
 }
 
 // =============================================================================
 // PRICE ACCESS
 // =============================================================================
 
+// Order trace: where the quote came from ("BTC ws cache", "BTC http seed")
+static void traceSource(trace::Span& span, const char* coin, const char* source) {
+    if (!span.active()) return;
+    char detail[48];
+    sprintf_s(detail, "%.24s %s", coin, source);
+    span.setDetail(detail);
+}
+
 PriceData getPrice(const char* coin, uint32_t maxAgeMs) {
     PriceData result;
     if (!coin || !*coin) return result;
+    trace::Span span("getPrice", "market");
 
     // Check if this is a perpDex coin (has colon separator)
     char perpDex[32] = {0};
     char coinOnly[64] = {0};
     if (http::parsePerpDex(coin, perpDex, sizeof(perpDex), coinOnly, sizeof(coinOnly))) {
+        traceSource(span, coin, "perp dex");
         return getPerpDexPrice(perpDex, coinOnly, maxAgeMs);
     }
 
@@ -124,11 +166,13 @@ PriceData getPrice(const char* coin, uint32_t maxAgeMs) {
     if (g_config.enableWebSocket && g_priceCache) {
         auto* cache = reinterpret_cast<hl::ws::PriceCache*>(g_priceCache);
 
-        double bid = cache->getBid(apiCoin);
-        double ask = cache->getAsk(apiCoin);
-        DWORD age = cache->getAge(apiCoin);
+        DWORD age;
+        hl::ws::PriceData cached = cache->getPriceData(g_symbols.find(coin), &age);
+        double bid = cached.bid;
+        double ask = cached.ask;
 
         if (bid > 0.0 && ask > 0.0 && age < maxAgeMs) {
+            traceSource(span, coin, "ws cache");
             result.bid = bid;
             result.ask = ask;
             result.mid = (bid + ask) / 2.0;
@@ -161,32 +205,40 @@ PriceData getPrice(const char* coin, uint32_t maxAgeMs) {
         // 60s). If nothing arrived in 60s, 1.5s more won't help — go straight
         // to HTTP fallback.
         if (bid <= 0.0 || ask <= 0.0) {
-            bool wsHealthy = g_wsManager &&
-                reinterpret_cast<hl::ws::WebSocketManager*>(g_wsManager)->isHealthy();
-
-            if (wsHealthy) {
+            // Pooled mode: judge the connection that actually carries this coin
+            auto* wsMgr = reinterpret_cast<hl::ws::WebSocketManager*>(g_wsManager);
+            bool wsHealthy = wsMgr && wsMgr->isHealthyForCoin(apiCoin);
+            // Registry shortcut: nothing to wait for if the subscription was
+            // never requested, was banned, or was sent and never acked
+            bool dataExpected = wsHealthy && wsMgr->willReceiveL2Data(apiCoin);
+
+            if (dataExpected) {
+                // Event-driven: woken by the setBidAsk that delivers the first quote
                 DWORD waitStart = GetTickCount();
-                while (GetTickCount() - waitStart < config::WS_FIRST_DATA_WAIT_MS) {
-                    Sleep(50);
+                if (cache->waitForBidAsk(apiCoin, config::WS_FIRST_DATA_WAIT_MS)) {
                     bid = cache->getBid(apiCoin);
                     ask = cache->getAsk(apiCoin);
-                    if (bid > 0.0 && ask > 0.0) {
-                        DWORD waited = GetTickCount() - waitStart;
-                        char msg[128];
-                        sprintf_s(msg, "%s WS data arrived after %dms", coin, waited);
-                        logMsg(1, "getPrice", msg);
-                        result.bid = bid;
-                        result.ask = ask;
-                        result.mid = (bid + ask) / 2.0;
-                        result.timestamp = GetTickCount();
-                        return result;
-                    }
+                    DWORD waited = GetTickCount() - waitStart;
+                    char msg[128];
+                    sprintf_s(msg, "%s WS data arrived after %dms", coin, waited);
+                    logMsg(1, "getPrice", msg);
+                    traceSource(span, coin, "ws wait");
+                    result.bid = bid;
+                    result.ask = ask;
+                    result.mid = (bid + ask) / 2.0;
+                    result.timestamp = GetTickCount();
+                    return result;
                 }
                 if (g_config.diagLevel >= 1) {
                     char msg[128];
                     sprintf_s(msg, "%s WS wait timed out (%dms)", coin, config::WS_FIRST_DATA_WAIT_MS);
                     logMsg(1, "getPrice", msg);
                 }
+            } else if (wsHealthy) {
+                char msg[128];
+                sprintf_s(msg, "%s l2Book subscription %s, skipping wait — direct HTTP fallback",
+                          coin, hl::ws::subStatusName(wsMgr->getL2Status(apiCoin)));
+                logMsg(1, "getPrice", msg);
             } else {
                 logMsg(1, "getPrice", "WS unhealthy, skipping wait — direct HTTP fallback");
             }
@@ -195,6 +247,7 @@ PriceData getPrice(const char* coin, uint32_t maxAgeMs) {
 
     // HTTP fallback - only if cooldown allows
     if (!canSeedHttp(coin)) {
+        traceSource(span, coin, "http cooldown");
         if (g_config.diagLevel >= 2) {
             char msg[128];
             sprintf_s(msg, "HTTP seed skipped (cooldown) for %s", coin);
@@ -215,6 +268,7 @@ PriceData getPrice(const char* coin, uint32_t maxAgeMs) {
     char payload[128];
     sprintf_s(payload, "{\"type\":\"l2Book\",\"coin\":\"%s\",\"nSigFigs\":5}", coin);
 
+    traceSource(span, coin, "http seed");
     http::Response resp = http::infoPost(payload, true);
     if (!resp.success()) {
         logMsg(1, "getPrice", "HTTP l2Book fetch failed");
@@ -232,7 +286,7 @@ PriceData getPrice(const char* coin, uint32_t maxAgeMs) {
     // Parse bid/ask from response using yyjson
     // Format: {"levels":[[{"px":"50000",...}],[{"px":"50001",...}]]}
     const char* jsonStr = resp.body.c_str();
-    yyjson_doc* doc = yyjson_read(jsonStr, resp.body.size(), 0);
+    yyjson_doc* doc = json::parse(jsonStr, resp.body.size());
     if (!doc) return result;
     yyjson_val* root = yyjson_doc_get_root(doc);
     yyjson_val* levels = json::getArray(root, "levels");
@@ -279,17 +333,14 @@ PriceData getPerpDexPrice(const char* perpDex, const char* coin, uint32_t maxAge
     PriceData result;
     if (!perpDex || !coin) return result;
 
-    // Build API coin name with prefix
-    char apiCoin[64];
-    sprintf_s(apiCoin, "%s:%s", perpDex, coin);
-
-    // Try WebSocket cache first
+    // Try WebSocket cache first ("dex:COIN" resolved without building it)
     if (g_config.enableWebSocket && g_priceCache) {
         auto* cache = reinterpret_cast<hl::ws::PriceCache*>(g_priceCache);
 
-        double bid = cache->getBid(std::string(apiCoin));
-        double ask = cache->getAsk(std::string(apiCoin));
-        DWORD age = cache->getAge(std::string(apiCoin));
+        DWORD age;
+        hl::ws::PriceData cached = cache->getPriceData(g_symbols.find(perpDex, ':', coin), &age);
+        double bid = cached.bid;
+        double ask = cached.ask;
 
         if (bid > 0.0 && ask > 0.0 && age < maxAgeMs) {
             result.bid = bid;
@@ -300,6 +351,10 @@ PriceData getPerpDexPrice(const char* perpDex, const char* coin, uint32_t maxAge
         }
     }
 
+    // Build API coin name with prefix
+    char apiCoin[64];
+    sprintf_s(apiCoin, "%s:%s", perpDex, coin);
+
     // HTTP fallback for perpDex
     if (!canSeedHttp(apiCoin)) return result;
 
@@ -312,7 +367,7 @@ PriceData getPerpDexPrice(const char* perpDex, const char* coin, uint32_t maxAge
     // Parse bid/ask from l2Book response using yyjson
     // Format: {"levels":[[{"px":"50000",...}],[{"px":"50001",...}]]}
     const char* jsonStr = resp.body.c_str();
-    yyjson_doc* doc = yyjson_read(jsonStr, resp.body.size(), 0);
+    yyjson_doc* doc = json::parse(jsonStr, resp.body.size());
     if (!doc) return result;
     yyjson_val* root = yyjson_doc_get_root(doc);
     yyjson_val* levels = json::getArray(root, "levels");
@@ -356,19 +411,58 @@ PriceData getPerpDexPrice(const char* perpDex, const char* coin, uint32_t maxAge
     return result;
 }
 
-double getFundingRate(const char* coin) {
-    if (!coin || !*coin) return 0.0;
+// =============================================================================
+// ASSET CONTEXT
+// =============================================================================
 
-    // Look up asset to determine perpDex and universe index
-    const AssetInfo* asset = getAsset(coin);
-    if (!asset) {
-        logMsg(1, "getFundingRate", "Asset not found in metadata");
-        return 0.0;
+int storeAssetCtxs(yyjson_val* root, bool spot) {
+    // Response: [metaObj, [assetCtx0, assetCtx1, ...]]. Perp contexts line up
+    // with meta.universe; spot contexts carry their own "coin".
+    if (!root || !yyjson_is_arr(root)) return -1;
+    yyjson_val* ctxs = yyjson_arr_get(root, 1);
+    if (!ctxs || !yyjson_is_arr(ctxs)) return -1;
+
+    yyjson_arr_iter universe;
+    if (!spot) {
+        yyjson_val* arr = json::getArray(yyjson_arr_get(root, 0), "universe");
+        if (!arr) return -1;
+        yyjson_arr_iter_init(arr, &universe);
+    }
+
+    int stored = 0;
+    size_t idx, max;
+    yyjson_val* ctxObj;
+    yyjson_arr_foreach(ctxs, idx, max, ctxObj) {
+        const char* coin = spot ? json::getStringPtr(ctxObj, "coin")
+                                : json::getStringPtr(yyjson_arr_iter_next(&universe), "name");
+        uint32_t id = g_symbols.find(coin);
+        if (!id) continue;   // Never referenced by this session
+        AssetCtx ctx;
+        ws::readAssetCtx(ctxObj, ctx);
+        if (g_assetCtx.set(id, ctx, AssetCtxSource::Http)) stored++;
     }
+    return stored;
+}
+
+// One metaAndAssetCtxs / spotMetaAndAssetCtxs pull for the asset's dex,
+// at most every ASSET_CTX_RETRY_MS per dex whatever the outcome
+static bool pullAssetCtxs(const AssetInfo* asset) {
+    bool perpDex = asset->isPerpDex && asset->perpDex[0];
+    std::string key = asset->isSpot ? SPOT_CTX_KEY : (perpDex ? asset->perpDex : "");
+
+    ensureCtxCsInit();
+    EnterCriticalSection(&s_ctxCs);
+    DWORD now = GetTickCount();
+    auto it = s_ctxPulls.find(key);
+    bool due = (it == s_ctxPulls.end()) || (now - it->second >= (DWORD)config::ASSET_CTX_RETRY_MS);
+    if (due) s_ctxPulls[key] = now;
+    LeaveCriticalSection(&s_ctxCs);
+    if (!due) return false;
 
-    // Build metaAndAssetCtxs request (perpDex-aware)
     char payload[256];
-    if (asset->isPerpDex && asset->perpDex[0]) {
+    if (asset->isSpot) {
+        strcpy_s(payload, "{\"type\":\"spotMetaAndAssetCtxs\"}");
+    } else if (perpDex) {
         sprintf_s(payload, "{\"type\":\"metaAndAssetCtxs\",\"dex\":\"%s\"}", asset->perpDex);
     } else {
         strcpy_s(payload, "{\"type\":\"metaAndAssetCtxs\"}");
@@ -376,39 +470,81 @@ double getFundingRate(const char* coin) {
 
     http::Response resp = http::infoPost(payload, false);
     if (!resp.success()) {
-        logMsg(1, "getFundingRate", "API request failed");
-        return 0.0;
+        logMsg(1, "getAssetCtx", "API request failed");
+        return false;
     }
 
-    // Response: [metaObj, [assetCtx0, assetCtx1, ...]]
-    yyjson_doc* doc = yyjson_read(resp.body.c_str(), resp.body.size(), 0);
-    if (!doc) return 0.0;
-    yyjson_val* root = yyjson_doc_get_root(doc);
-    if (!yyjson_is_arr(root)) { yyjson_doc_free(doc); return 0.0; }
+    yyjson_doc* doc = json::parse(resp.body.c_str(), resp.body.size());
+    if (!doc) return false;
+    int stored = storeAssetCtxs(yyjson_doc_get_root(doc), asset->isSpot);
+    yyjson_doc_free(doc);
 
-    // Asset contexts array is the second element
-    yyjson_val* ctxs = yyjson_arr_get(root, 1);
-    if (!ctxs || !yyjson_is_arr(ctxs)) { yyjson_doc_free(doc); return 0.0; }
+    if (g_config.diagLevel >= 2) {
+        char msg[128];
+        sprintf_s(msg, "%d contexts stored for %s", stored,
+                  asset->isSpot ? "spot" : (perpDex ? asset->perpDex : "main dex"));
+        logMsg(2, "getAssetCtx", msg);
+    }
+    return stored > 0;
+}
 
-    // PerpDex assets use localIndex; regular perps use index
-    int idx = asset->isPerpDex ? asset->localIndex : asset->index;
-    yyjson_val* ctx = yyjson_arr_get(ctxs, (size_t)idx);
-    if (!ctx) {
-        logMsg(1, "getFundingRate", "Asset index out of range in response");
-        yyjson_doc_free(doc);
-        return 0.0;
+// Metadata entry of a coin, logged when unknown
+static const AssetInfo* ctxAsset(const char* coin) {
+    if (!coin || !*coin) return nullptr;
+    const AssetInfo* asset = getAsset(coin);
+    if (!asset) logMsg(1, "getAssetCtx", "Asset not found in metadata");
+    return asset;
+}
+
+bool getAssetCtx(const char* coin, AssetCtx* out) {
+    const AssetInfo* asset = ctxAsset(coin);
+    if (!asset) return false;
+    uint32_t id = asset->symbolId;
+
+    // Streamed coins are always fresh; pulled ones until the TTL runs out
+    AssetCtx ctx;
+    DWORD age = 0;
+    bool have = g_assetCtx.get(id, &ctx, &age);
+    if (!have || age >= (DWORD)config::ASSET_CTX_TTL_MS) {
+        if (pullAssetCtxs(asset)) have = g_assetCtx.get(id, &ctx, &age);
     }
+    if (have && out) *out = ctx;
+    return have;
+}
 
-    double rate = json::getDouble(ctx, "funding");
-    yyjson_doc_free(doc);
+bool peekAssetCtx(const char* coin, AssetCtx* out) {
+    if (!coin || !*coin) return false;
+    const AssetInfo* asset = getAsset(coin);
+    return asset && g_assetCtx.get(asset->symbolId, out);
+}
+
+bool primeAssetCtx(const char* coin) {
+    const AssetInfo* asset = ctxAsset(coin);
+    if (!asset) return false;
+    if (g_assetCtx.get(asset->symbolId, nullptr)) return true;
+    pullAssetCtxs(asset);
+    return g_assetCtx.get(asset->symbolId, nullptr);
+}
+
+void fundingToRollover(const AssetCtx& ctx, double* rollLong, double* rollShort) {
+    // Hourly funding on the mark notional: longs pay a positive rate, shorts
+    // receive it. Zorro wants USDC per unit held for one day.
+    double perDay = ctx.funding * 24.0 * ctx.markPx;
+    if (rollLong) *rollLong = -perDay;
+    if (rollShort) *rollShort = perDay;
+}
+
+double getFundingRate(const char* coin) {
+    AssetCtx ctx;
+    if (!getAssetCtx(coin, &ctx)) return 0.0;
 
     if (g_config.diagLevel >= 1) {
         char msg[128];
-        sprintf_s(msg, "%s funding=%.10f (%.4f bps/hr)", coin, rate, rate * 10000.0);
+        sprintf_s(msg, "%s funding=%.10f (%.4f bps/hr)", coin, ctx.funding, ctx.funding * 10000.0);
         logMsg(1, "getFundingRate", msg);
     }
 
-    return rate;
+    return ctx.funding;
 }
 
 bool hasRealtimePrice(const char* coin, uint32_t maxAgeMs) {
@@ -418,6 +554,12 @@ bool hasRealtimePrice(const char* coin, uint32_t maxAgeMs) {
     return cache->isFresh(std::string(coin), maxAgeMs);
 }
 
+int waitForPrices(const std::vector<std::string>& coins, uint32_t timeoutMs) {
+    if (coins.empty() || !g_config.enableWebSocket || !g_priceCache) return 0;
+    auto* cache = reinterpret_cast<hl::ws::PriceCache*>(g_priceCache);
+    return cache->waitForBidAsk(coins, timeoutMs);
+}
+
 void subscribePrice(const char* coin) {
     if (!coin || !g_config.enableWebSocket || !g_wsManager) return;
 
@@ -510,7 +652,7 @@ std::vector<Candle> getCandles(const char* coin, CandleInterval interval,
 
     // Parse response: [{"t":12345,"o":"100","h":"101","l":"99","c":"100.5","v":"1000"}]
     const char* jsonStr = resp.body.c_str();
-    yyjson_doc* candleDoc = yyjson_read(jsonStr, resp.body.size(), 0);
+    yyjson_doc* candleDoc = json::parse(jsonStr, resp.body.size());
     if (!candleDoc) return candles;
     yyjson_val* candleRoot = yyjson_doc_get_root(candleDoc);
     if (!yyjson_is_arr(candleRoot)) { yyjson_doc_free(candleDoc); return candles; }
@@ -12,15 +12,19 @@
 // - Historical candle data fetching
 // - Asset metadata access (via hl_meta)
 // - HTTP seed cooldown management
+// - Asset contexts (funding, mark, volume) shared per dex
 //=============================================================================
 
 #pragma once
 
 #include "../foundation/hl_types.h"
+#include "../foundation/hl_asset_ctx.h"
 #include <string>
 #include <vector>
 #include <cstdint>
 
+struct yyjson_val;
+
 namespace hl {
 namespace market {
 
@@ -64,15 +68,50 @@ PriceData getPerpDexPrice(const char* perpDex, const char* coin, uint32_t maxAge
 /// Get current hourly funding rate for a coin
 /// @param coin Coin name (e.g., "BTC", "XYZ100")
 /// @return Hourly funding rate as a decimal (e.g., 0.0000125 = 0.00125%/hr), 0 on error
-/// Uses metaAndAssetCtxs endpoint. PerpDex-aware (auto-detects dex from asset metadata).
+/// Served from the asset-context store (see getAssetCtx).
 double getFundingRate(const char* coin);
 
+/// Get funding, mark/oracle price, open interest and 24h volume for a coin
+/// @param coin Coin name (e.g., "BTC", "xyz:XYZ100", "@107")
+/// @param out Receives the context (may be null)
+/// @return false if unknown or never fetched
+/// Streamed (activeAssetCtx) coins are read as-is. Otherwise one
+/// metaAndAssetCtxs / spotMetaAndAssetCtxs pull refreshes every asset of the
+/// coin's dex once the stored context is older than ASSET_CTX_TTL_MS.
+/// May block on HTTP — not for BrokerAsset (see peekAssetCtx).
+bool getAssetCtx(const char* coin, AssetCtx* out);
+
+/// Stored context only, whatever its age; never sends a request
+/// @return false if unknown or never stored
+bool peekAssetCtx(const char* coin, AssetCtx* out);
+
+/// Subscription time: pull the coin's dex unless a context is already stored
+/// (one pull per dex serves all its assets)
+/// @return true if a context is stored afterwards
+bool primeAssetCtx(const char* coin);
+
+/// Store every context of a metaAndAssetCtxs / spotMetaAndAssetCtxs response
+/// @param root Response root ([meta, [ctx, ...]])
+/// @param spot True for spotMetaAndAssetCtxs (contexts keyed by "coin")
+/// @return Contexts stored (coins unknown to g_symbols are skipped), -1 if malformed
+int storeAssetCtxs(yyjson_val* root, bool spot);
+
+/// Zorro rollover from funding: USDC per unit per day (negative = paid)
+void fundingToRollover(const AssetCtx& ctx, double* rollLong, double* rollShort);
+
 /// Check if real-time (WebSocket) price is available and fresh
 /// @param coin Coin name (e.g., "BTC" or "xyz:XYZ100")
 /// @param maxAgeMs Maximum acceptable age (default 5000ms)
 /// @return true if WS has fresh data
 bool hasRealtimePrice(const char* coin, uint32_t maxAgeMs = 5000);
 
+/// Wait until every coin has a WS bid/ask or the deadline passes (one
+/// shared deadline, not per coin). Wakes as soon as the last quote lands.
+/// @param coins API coin names (e.g., "BTC", "xyz:XYZ100")
+/// @param timeoutMs Total wait budget
+/// @return Number of coins with a bid/ask when the wait ended
+int waitForPrices(const std::vector<std::string>& coins, uint32_t timeoutMs);
+
 /// Request WebSocket subscription for a coin's price data
 /// @param coin Coin name (e.g., "BTC" or "xyz:XYZ100")
 /// This is idempotent - calling multiple times is safe
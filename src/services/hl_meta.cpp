@@ -64,7 +64,7 @@ static void ensureTokenNames() {
         return;
     }
 
-    yyjson_doc* doc = yyjson_read(resp.body.c_str(), resp.body.size(), 0);
+    yyjson_doc* doc = json::parse(resp.body.c_str(), resp.body.size());
     if (!doc) { s_tokenNames[0] = "USDC"; return; }
 
     yyjson_val* root = yyjson_doc_get_root(doc);
@@ -116,7 +116,7 @@ int fetchMeta() {
         return 0;
     }
 
-    yyjson_doc* doc = yyjson_read(resp.body.c_str(), resp.body.size(), 0);
+    yyjson_doc* doc = json::parse(resp.body.c_str(), resp.body.size());
     if (!doc) {
         logMsg(1, "fetchMeta", "Failed to parse meta JSON");
         return 0;
@@ -218,7 +218,7 @@ int fetchPerpDexList() {
 
     // Parse perpDex names from response
     // Format: [null, {"name":"xyz",...}, {"name":"flx",...}, ...]
-    yyjson_doc* doc = yyjson_read(resp.body.c_str(), resp.body.size(), 0);
+    yyjson_doc* doc = json::parse(resp.body.c_str(), resp.body.size());
     if (!doc) return 0;
     yyjson_val* root = yyjson_doc_get_root(doc);
     if (!yyjson_is_arr(root)) { yyjson_doc_free(doc); return 0; }
@@ -304,7 +304,7 @@ int fetchPerpDexMeta(const char* perpDex) {
     }
 
     // Parse assets from perpDex meta using yyjson
-    yyjson_doc* doc = yyjson_read(resp.body.c_str(), resp.body.size(), 0);
+    yyjson_doc* doc = json::parse(resp.body.c_str(), resp.body.size());
     if (!doc) return 0;
     yyjson_val* root = yyjson_doc_get_root(doc);
     yyjson_val* universe = json::getArray(root, "universe");
@@ -57,7 +57,7 @@ int fetchSpotMeta() {
         return 0;
     }
 
-    yyjson_doc* doc = yyjson_read(resp.body.c_str(), resp.body.size(), 0);
+    yyjson_doc* doc = json::parse(resp.body.c_str(), resp.body.size());
     if (!doc) {
         logSpot(1, "Failed to parse spotMeta JSON");
         return 0;
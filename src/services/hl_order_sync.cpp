@@ -0,0 +1,439 @@
+//=============================================================================
+// hl_order_sync.cpp - Push-driven order state with batched HTTP reconciliation
+//=============================================================================
+// LAYER: Services | DEPENDENCIES: hl_order_sync.h, hl_globals.h, hl_http.h
+//
+// This module provides:
+// - Push event application (orderUpdates, userFills totals, post responses)
+// - Due-order selection by feed epoch / staleness / unresolved oid
+// - Batched reconciliation (frontendOpenOrders per dex + historicalOrders)
+// - Order sync counters (HL_GET_ORDER_SYNC)
+//=============================================================================
+
+#include "hl_order_sync.h"
+#include "../foundation/hl_globals.h"
+#include "../foundation/hl_config.h"
+#include "../transport/hl_http.h"
+#include "../transport/json_helpers.h"
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <unordered_map>
+
+namespace hl {
+namespace trading {
+
+// =============================================================================
+// STATE
+// =============================================================================
+
+static std::atomic<OrderFeedProbe> s_probe{nullptr};
+
+// Zorro-thread state (reconcileOrders only)
+static std::atomic<bool> s_reconciling{false};
+static DWORD s_lastScanAt = 0;
+static DWORD s_lastBatchAt = 0;
+static bool s_scanned = false;
+static bool s_batched = false;
+
+static std::atomic<long long> s_orderEvents{0};
+static std::atomic<long long> s_fillEvents{0};
+static std::atomic<long long> s_batches{0};
+static std::atomic<long long> s_httpCalls{0};
+static std::atomic<long long> s_httpFailures{0};
+static std::atomic<long long> s_ordersReconciled{0};
+static std::atomic<long long> s_ordersNotFound{0};
+static std::atomic<int> s_lastBatchOrders{0};
+
+static double oleNow() {
+    return (double)time(nullptr) / 86400.0 + 25569.0; // OLE DATE
+}
+
+static bool probeFeed(uint32_t* epoch) {
+    *epoch = 0;
+    OrderFeedProbe probe = s_probe.load();
+    return probe ? probe(epoch) : false;
+}
+
+// 16-bit tag stored in OrderRecord::syncEpoch; never 0 (= never synced)
+static uint16_t epochTag(uint32_t epoch) {
+    return (uint16_t)(epoch % 0xFFFF + 1);
+}
+
+static void markLive(int tradeId, double now) {
+    uint32_t epoch;
+    if (probeFeed(&epoch)) g_trading.markSynced(tradeId, epochTag(epoch), now);
+}
+
+void setOrderFeedProbe(OrderFeedProbe probe) {
+    s_probe.store(probe);
+}
+
+// =============================================================================
+// PUSH EVENTS
+// =============================================================================
+
+OrderStatus mapExchangeStatus(const char* status, double filledSize, double requestedSize) {
+    if (!status) return OrderStatus::Open;
+    if (strcmp(status, "filled") == 0)
+        return determineFilledStatus(filledSize, requestedSize);
+    if (strstr(status, "canceled") || strstr(status, "Canceled"))  // [OPM-79]
+        return OrderStatus::Cancelled;
+    if (strcmp(status, "rejected") == 0 || strstr(status, "Rejected"))
+        return OrderStatus::Error;
+    if (filledSize > 0 && requestedSize > 0)
+        return determineFilledStatus(filledSize, requestedSize);
+    return OrderStatus::Open;
+}
+
+int applyOrderUpdate(const char* oid, const char* cloid, const char* status,
+                     double filledSize, double limitPx) {
+    int tradeId = 0;
+    if (cloid && *cloid) tradeId = g_trading.findByCloid(cloid);
+    if (tradeId == 0 && oid && *oid) tradeId = g_trading.findByOid(oid);
+    if (tradeId == 0) return 0;
+
+    OrderRecord rec;
+    if (!g_trading.getRecord(tradeId, rec)) return 0;
+    double now = oleNow();
+
+    // Found by cloid while still PENDING_/UNKNOWN: the push carries the oid
+    if (rec.oidKind != OidKind::Exchange && oid && *oid)
+        g_trading.setOrderId(tradeId, oid, now);
+
+    OrderStatus st = mapExchangeStatus(status, filledSize, rec.requestedSize);
+    g_trading.applyOrderUpdate(tradeId, filledSize, limitPx, st, now);
+    markLive(tradeId, now);
+    s_orderEvents++;
+    return tradeId;
+}
+
+bool applyFillUpdate(int tradeId, double totalFilled, double avgPrice, OrderStatus* outStatus) {
+    double now = oleNow();
+    if (!g_trading.applyFillProgress(tradeId, totalFilled, avgPrice, now, outStatus))
+        return false;
+    markLive(tradeId, now);
+    s_fillEvents++;
+    return true;
+}
+
+void markOrderSynced(int tradeId) {
+    markLive(tradeId, oleNow());
+}
+
+// =============================================================================
+// RESPONSE PARSING
+// =============================================================================
+
+static void copyId(yyjson_val* v, char* out, size_t outSize) {
+    if (!v) return;
+    if (yyjson_is_int(v))
+        sprintf_s(out, outSize, "%lld", (long long)yyjson_get_sint(v));
+    else if (yyjson_is_real(v))
+        sprintf_s(out, outSize, "%.0f", yyjson_get_real(v));
+    else if (yyjson_is_str(v))
+        strncpy_s(out, outSize, yyjson_get_str(v), _TRUNCATE);
+}
+
+int parseExchangeOrders(const char* json, size_t len, std::vector<ExchangeOrder>& out) {
+    if (!json || len == 0) return 0;
+    yyjson_doc* doc = json::parse(json, len);
+    if (!doc) return 0;
+    yyjson_val* root = yyjson_doc_get_root(doc);
+
+    int count = 0;
+    if (yyjson_is_arr(root)) {
+        size_t idx, max;
+        yyjson_val* item;
+        yyjson_arr_foreach(root, idx, max, item) {
+            // historicalOrders wraps the order; frontendOpenOrders is flat
+            yyjson_val* order = json::getObject(item, "order");
+            const char* status = order ? json::getStringPtr(item, "status") : "open";
+            if (!order) order = item;
+            if (!yyjson_is_obj(order)) continue;
+
+            ExchangeOrder eo;
+            copyId(yyjson_obj_get(order, "oid"), eo.oid, sizeof(eo.oid));
+            if (!eo.oid[0]) continue;
+            json::getString(order, "cloid", eo.cloid, sizeof(eo.cloid));
+            json::getString(order, "coin", eo.coin, sizeof(eo.coin));
+            if (status) strncpy_s(eo.status, status, _TRUNCATE);
+            eo.origSz = json::getDouble(order, "origSz");
+            eo.sz = json::getDouble(order, "sz");
+            eo.limitPx = json::getDouble(order, "limitPx");
+            out.push_back(eo);
+            count++;
+        }
+    }
+    yyjson_doc_free(doc);
+    return count;
+}
+
+// =============================================================================
+// RECONCILIATION
+// =============================================================================
+
+namespace {
+
+struct DueOrder {
+    int tradeId = 0;
+    OrderRecord rec;
+    char oid[64] = {0};             // Empty or synthetic while unresolved
+    char cloid[64] = {0};           // Lowercase
+    char dex[32] = {0};             // Coin prefix before ':' ("" = first perp dex)
+    bool unresolved = false;        // PENDING_ / UNKNOWN
+    bool done = false;
+};
+
+void toLower(char* s) {
+    for (; *s; ++s) if (*s >= 'A' && *s <= 'Z') *s = (char)(*s - 'A' + 'a');
+}
+
+// Fill in ids and dex; false for synthetic trades with no exchange order
+bool describe(int tradeId, const OrderRecord& rec, DueOrder& d) {
+    d.tradeId = tradeId;
+    d.rec = rec;
+    TradingState::formatOid(rec, d.oid, sizeof(d.oid));
+    TradingState::formatCloid(rec, d.cloid, sizeof(d.cloid));
+    if (rec.oidKind == OidKind::Text || rec.cloidKind == CloidKind::Text) {
+        OrderState full;            // Out-of-line strings
+        if (!g_trading.getOrder(tradeId, full)) return false;
+        if (rec.oidKind == OidKind::Text) {
+            if (strncmp(full.orderId, "PENDING_", 8) == 0 || strcmp(full.orderId, "UNKNOWN") == 0)
+                d.unresolved = true;
+            else if (strncmp(full.orderId, "RESUMED_", 8) == 0 ||
+                     strncmp(full.orderId, "IMPORTED_", 9) == 0 ||
+                     strncmp(full.orderId, "DRY_RUN", 7) == 0)
+                return false;
+            else
+                strncpy_s(d.oid, full.orderId, _TRUNCATE);
+        }
+        if (rec.cloidKind == CloidKind::Text) strncpy_s(d.cloid, full.cloid, _TRUNCATE);
+    }
+    if (rec.oidKind == OidKind::None) d.unresolved = true;
+    toLower(d.cloid);
+    if (d.unresolved && !d.cloid[0]) return false;   // Nothing to match on
+
+    const char* coin = g_trading.coinName(rec.coinId);
+    const char* colon = strchr(coin, ':');
+    if (colon && (size_t)(colon - coin) < sizeof(d.dex)) {
+        memcpy(d.dex, coin, colon - coin);
+        d.dex[colon - coin] = '\0';
+    }
+    return true;
+}
+
+bool isDue(const DueOrder& d, bool live, uint16_t tag, double now) {
+    double ageMs = (now - d.rec.lastUpdate) * 86400000.0;
+    if (d.unresolved) return ageMs >= config::ORDER_PENDING_GRACE_MS;
+    if (live) return d.rec.syncEpoch != tag;
+    double staleMs = d.rec.filledSize > 0 ? config::ORDER_STALE_PARTIAL_MS
+                                          : config::ORDER_STALE_OPEN_MS;
+    return ageMs > staleMs;
+}
+
+// One HTTP query; appends the orders it returned. False on transport/parse failure.
+bool query(const char* body, const char* dex, std::vector<ExchangeOrder>& out) {
+    s_httpCalls++;
+    http::Response resp = (dex && *dex) ? http::infoPostPerpDex(body, dex)
+                                        : http::infoPost(body);
+    if (!resp.success() || resp.body.empty()) {
+        s_httpFailures++;
+        g_logger.logf(1, "OrderSync: query failed (HTTP %d) dex=%s", resp.statusCode, dex ? dex : "");
+        return false;
+    }
+    if (resp.body[0] != '[') {
+        s_httpFailures++;
+        g_logger.logf(1, "OrderSync: unexpected response dex=%s", dex ? dex : "");
+        return false;
+    }
+    parseExchangeOrders(resp.body.c_str(), resp.body.size(), out);
+    return true;
+}
+
+// Index exchange orders by lowercase cloid and oid; first occurrence wins
+// (historicalOrders lists the newest status first)
+struct OrderIndex {
+    std::unordered_map<std::string, size_t> byCloid;
+    std::unordered_map<std::string, size_t> byOid;
+
+    explicit OrderIndex(std::vector<ExchangeOrder>& orders) {
+        for (size_t i = 0; i < orders.size(); i++) {
+            toLower(orders[i].cloid);
+            if (orders[i].cloid[0]) byCloid.emplace(orders[i].cloid, i);
+            byOid.emplace(orders[i].oid, i);
+        }
+    }
+
+    long find(const DueOrder& d) const {
+        if (d.cloid[0]) {
+            auto it = byCloid.find(d.cloid);
+            if (it != byCloid.end()) return (long)it->second;
+        }
+        if (d.oid[0] && !d.unresolved) {
+            auto it = byOid.find(d.oid);
+            if (it != byOid.end()) return (long)it->second;
+        }
+        return -1;
+    }
+};
+
+void applyExchangeOrder(DueOrder& d, const ExchangeOrder& eo, uint16_t tag, double now) {
+    if (d.unresolved || strcmp(d.oid, eo.oid) != 0)
+        g_trading.setOrderId(d.tradeId, eo.oid, now);
+
+    double filled = eo.origSz - eo.sz;
+    if (filled < 0) filled = 0;
+    OrderStatus st = mapExchangeStatus(eo.status, filled, d.rec.requestedSize);
+    if (st == OrderStatus::Error) st = OrderStatus::Cancelled;   // rejected: never rested
+
+    OrderStatus newSt = st;
+    g_trading.applyOrderUpdate(d.tradeId, filled, eo.limitPx, st, now, &newSt);
+    g_trading.markSynced(d.tradeId, tag, now);
+    d.done = true;
+    s_ordersReconciled++;
+
+    if (newSt != d.rec.orderStatus() || d.unresolved)
+        g_logger.logf(1, "OrderSync: trade %d oid=%s %s -> status %d (filled %.6f)",
+                      d.tradeId, eo.oid, eo.status, (int)newSt, filled);
+}
+
+} // namespace
+
+int reconcileOrders() {
+    if (!g_config.walletAddress[0]) return 0;
+
+    DWORD tick = GetTickCount();
+    if (s_scanned && tick - s_lastScanAt < (DWORD)config::ORDER_SYNC_SCAN_MS) return 0;
+    if (s_batched && tick - s_lastBatchAt < (DWORD)config::ORDER_RECONCILE_INTERVAL_MS) return 0;
+
+    bool expected = false;
+    if (!s_reconciling.compare_exchange_strong(expected, true)) return 0;
+    s_lastScanAt = tick;
+    s_scanned = true;
+
+    // Epoch captured before querying: events after this are newer than the batch
+    uint32_t epoch;
+    bool live = probeFeed(&epoch);
+    uint16_t tag = epochTag(epoch);
+    double now = oleNow();
+
+    std::vector<DueOrder> due;
+    for (const auto& entry : g_trading.activeRecords()) {
+        DueOrder d;     // Only text ids touch the out-of-line strings
+        if (describe(entry.first, entry.second, d) && isDue(d, live, tag, now))
+            due.push_back(d);
+    }
+    if (due.empty()) {
+        s_reconciling = false;
+        return 0;
+    }
+
+    s_lastBatchAt = tick;
+    s_batched = true;
+    s_batches++;
+    s_lastBatchOrders = (int)due.size();
+    g_logger.logf(2, "OrderSync: reconciling %d orders (feed %s, epoch %u)",
+                  (int)due.size(), live ? "live" : "down", epoch);
+
+    char body[256];
+
+    // 1. Resting orders: one frontendOpenOrders per dex
+    std::vector<std::string> dexes;
+    for (const auto& d : due) {
+        bool seen = false;
+        for (const auto& x : dexes) if (x == d.dex) { seen = true; break; }
+        if (!seen) dexes.push_back(d.dex);
+    }
+    sprintf_s(body, "{\"type\":\"frontendOpenOrders\",\"user\":\"%s\"}", g_config.walletAddress);
+    std::vector<ExchangeOrder> open;
+    bool openOk = true;
+    for (const auto& dex : dexes)
+        openOk &= query(body, dex.c_str(), open);
+
+    int reconciled = 0;
+    int remaining = 0;
+    {
+        OrderIndex index(open);
+        for (auto& d : due) {
+            long i = index.find(d);
+            if (i >= 0) {
+                applyExchangeOrder(d, open[i], tag, now);
+                reconciled++;
+            } else {
+                remaining++;
+            }
+        }
+    }
+
+    // 2. No longer resting: one historicalOrders for all of them.
+    // If an openOrders query failed, "not open" proves nothing — stop here.
+    if (remaining > 0 && openOk) {
+        sprintf_s(body, "{\"type\":\"historicalOrders\",\"user\":\"%s\"}", g_config.walletAddress);
+        std::vector<ExchangeOrder> history;
+        if (query(body, nullptr, history)) {
+            OrderIndex index(history);
+            for (auto& d : due) {
+                if (d.done) continue;
+                long i = index.find(d);
+                if (i >= 0) {
+                    applyExchangeOrder(d, history[i], tag, now);
+                    reconciled++;
+                } else if (d.unresolved) {
+                    // Neither open nor in history: the order never landed
+                    OrderStatus old = d.rec.orderStatus();
+                    g_trading.applyOrderUpdate(d.tradeId, 0, 0, OrderStatus::Cancelled, now);
+                    g_trading.markSynced(d.tradeId, tag, now);
+                    s_ordersNotFound++;
+                    reconciled++;
+                    g_logger.logf(1, "OrderSync: trade %d not found on exchange -> cancelled "
+                                  "(was status %d)", d.tradeId, (int)old);
+                } else {
+                    // Beyond the history window: nothing newer to learn, so
+                    // don't query it again until the next gap
+                    g_trading.markSynced(d.tradeId, tag, now);
+                    g_logger.logf(1, "OrderSync: trade %d oid=%s not in open or historical orders",
+                                  d.tradeId, d.oid);
+                }
+            }
+        }
+    }
+
+    s_reconciling = false;
+    return reconciled;
+}
+
+// =============================================================================
+// STATS
+// =============================================================================
+
+OrderSyncStats getOrderSyncStats() {
+    OrderSyncStats s;
+    s.orderEvents = s_orderEvents;
+    s.fillEvents = s_fillEvents;
+    s.batches = s_batches;
+    s.httpCalls = s_httpCalls;
+    s.httpFailures = s_httpFailures;
+    s.ordersReconciled = s_ordersReconciled;
+    s.ordersNotFound = s_ordersNotFound;
+    s.lastBatchOrders = s_lastBatchOrders;
+    return s;
+}
+
+void resetOrderSync() {
+    s_orderEvents = 0;
+    s_fillEvents = 0;
+    s_batches = 0;
+    s_httpCalls = 0;
+    s_httpFailures = 0;
+    s_ordersReconciled = 0;
+    s_ordersNotFound = 0;
+    s_lastBatchOrders = 0;
+    s_scanned = false;
+    s_batched = false;
+}
+
+} // namespace trading
+} // namespace hl
@@ -0,0 +1,111 @@
+//=============================================================================
+// hl_order_sync.h - Push-driven order state with batched HTTP reconciliation
+//=============================================================================
+// Part of Hyperliquid Plugin for Zorro
+//
+// LAYER: Services
+// DEPENDENCIES: hl_types.h, hl_globals.h, hl_http.h
+// THREAD SAFETY: Push handlers run on WS threads; reconcileOrders() on the
+//                Zorro thread (serialized internally)
+//
+// Order state is fed by pushes — post responses, orderUpdates and userFills
+// — and is authoritative while the order feed is live. Each order carries
+// the order-feed epoch it was last confirmed in (OrderRecord::syncEpoch);
+// the WS layer bumps the epoch when orderUpdates may have missed events.
+//
+// An open order needs HTTP reconciliation only when:
+//   - its epoch is older than the feed's (the feed gapped since), or
+//   - the feed is not live and the order is stale (5s unfilled, 10s partial),
+//   - or it never got an exchange oid (PENDING_/UNKNOWN) and no push
+//     resolved it within ORDER_PENDING_GRACE_MS.
+// All such orders are resolved together by one frontendOpenOrders query per
+// dex, plus one historicalOrders query for those no longer open, at most
+// once per ORDER_RECONCILE_INTERVAL_MS.
+//=============================================================================
+
+#pragma once
+
+#include "../foundation/hl_types.h"
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace hl {
+namespace trading {
+
+// =============================================================================
+// FEED STATE
+// =============================================================================
+
+/// Reports the order feed: returns true if live and writes the current epoch.
+/// Installed by the API layer (reads the WebSocketManager); without a probe
+/// the feed counts as down and every open order is polled when stale.
+typedef bool (*OrderFeedProbe)(uint32_t* epoch);
+void setOrderFeedProbe(OrderFeedProbe probe);
+
+// =============================================================================
+// PUSH EVENTS
+// =============================================================================
+
+/// Order status from an exchange status string ("open", "filled",
+/// "canceled", "marginCanceled", "rejected", ...). Unknown strings map to Open.
+OrderStatus mapExchangeStatus(const char* status, double filledSize, double requestedSize);
+
+/// orderUpdates event. Finds the trade by cloid, then oid; resolves a
+/// PENDING_ oid; applies the state machine (TradingState::applyOrderUpdate).
+/// @return Trade ID, or 0 if the order is not tracked
+int applyOrderUpdate(const char* oid, const char* cloid, const char* status,
+                     double filledSize, double limitPx);
+
+/// userFills cumulative total for a tracked trade (monotonic)
+/// @return true if applied
+bool applyFillUpdate(int tradeId, double totalFilled, double avgPrice,
+                     OrderStatus* outStatus = nullptr);
+
+/// Post response accepted the order: its state is known as of now
+void markOrderSynced(int tradeId);
+
+// =============================================================================
+// RECONCILIATION
+// =============================================================================
+
+/// One order from frontendOpenOrders (flat objects) or historicalOrders
+/// ({"order":{...},"status":"..."}). Open orders get status "open".
+struct ExchangeOrder {
+    char oid[24] = {0};
+    char cloid[40] = {0};
+    char coin[32] = {0};
+    char status[32] = {0};
+    double origSz = 0.0;
+    double sz = 0.0;            // Remaining
+    double limitPx = 0.0;
+};
+
+/// Parse either response format. @return number of orders appended
+int parseExchangeOrders(const char* json, size_t len, std::vector<ExchangeOrder>& out);
+
+/// Reconcile every order that needs it (see file header) with batched HTTP
+/// queries. Scans at most once per ORDER_SYNC_SCAN_MS and batches at most
+/// once per ORDER_RECONCILE_INTERVAL_MS, so it is cheap to call per trade.
+/// Call from the Zorro thread (BrokerTrade).
+/// @return Orders reconciled, 0 if nothing was due or throttled
+int reconcileOrders();
+
+struct OrderSyncStats {
+    long long orderEvents = 0;      // orderUpdates applied to tracked trades
+    long long fillEvents = 0;       // userFills totals applied
+    long long batches = 0;          // Reconciliation batches run
+    long long httpCalls = 0;        // HTTP queries made by those batches
+    long long httpFailures = 0;
+    long long ordersReconciled = 0; // Orders whose state came from a batch
+    long long ordersNotFound = 0;   // Never-landed orders cancelled by a batch
+    int lastBatchOrders = 0;
+};
+
+OrderSyncStats getOrderSyncStats();
+
+/// Clear stats and throttle state (BrokerOpen / tests)
+void resetOrderSync();
+
+} // namespace trading
+} // namespace hl
@@ -0,0 +1,376 @@
+//=============================================================================
+// hl_trade_snapshot.cpp - Per-tick BrokerTrade results for all open trades
+//=============================================================================
+// LAYER: Services | DEPENDENCIES: hl_trade_snapshot.h, hl_globals.h,
+//        hl_trading_service.h, hl_market_service.h, hl_account_service.h,
+//        hl_order_sync.h, ws_price_cache.h
+//
+// This module provides:
+// - Batched trade evaluation (records, WS fill totals, prices, positions)
+// - The per-tick snapshot and the set of trades Zorro is watching
+// - Snapshot counters (HL_GET_ORDER_SYNC)
+//=============================================================================
+
+#include "hl_trade_snapshot.h"
+#include "hl_trading_service.h"
+#include "hl_market_service.h"
+#include "hl_account_service.h"
+#include "hl_order_sync.h"
+#include "../foundation/hl_globals.h"
+#include "../foundation/hl_config.h"
+#include "../transport/ws_price_cache.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+namespace hl {
+namespace trading {
+
+// =============================================================================
+// STATE (Zorro thread, except s_valid)
+// =============================================================================
+
+struct WatchEntry {
+    TradeView view;
+    bool served = false;    // Returned since the snapshot was built
+    int idle = 0;           // Snapshots in a row this trade was not asked for
+};
+
+static std::unordered_map<int, WatchEntry> s_watch;
+static std::atomic<bool> s_valid{false};
+static DWORD s_builtAt = 0;
+static TradeSnapshotStats s_stats;
+
+// =============================================================================
+// EVALUATION
+// =============================================================================
+
+namespace {
+
+enum class Synthetic : uint8_t { None, Pending, Resumed, Imported };
+
+struct Work {
+    int tradeId = 0;
+    OrderRecord rec;
+    int stateIdx = -1;      // Decoded OrderState (text oids only)
+    Synthetic synth = Synthetic::None;
+    char oid[64];
+};
+
+int toLots(double size) {
+    return (g_trading.lotSize > 0)
+        ? (int)round(size / g_trading.lotSize)
+        : (int)round(size);
+}
+
+// Price and position lookups, once per coin per pass
+class CoinLookups {
+public:
+    double price(const OrderRecord& rec, const char* coin) {
+        auto it = px_.find(rec.coinId);
+        if (it != px_.end()) return it->second;
+        PriceData p = market::getPrice(coin);
+        double px = p.mid > 0 ? p.mid : p.ask;
+        px_.emplace(rec.coinId, px);
+        return px;
+    }
+
+    const account::PositionInfo& position(const OrderRecord& rec, const char* coin) {
+        auto it = pos_.find(rec.coinId);
+        if (it != pos_.end()) return it->second;
+        return pos_.emplace(rec.coinId, account::getPosition(coin)).first->second;
+    }
+
+private:
+    std::unordered_map<uint16_t, double> px_;
+    std::unordered_map<uint16_t, account::PositionInfo> pos_;
+};
+
+TradeView evaluate(const Work& w, const OrderState& state, CoinLookups& lookups) {
+    TradeView v;
+    const OrderRecord& rec = w.rec;
+
+    // --- PENDING_ orders [OPM-89] ---
+    // The post response never confirmed these. orderUpdates resolves them by
+    // cloid; otherwise reconcileOrders() looks them up in its next batch and
+    // cancels those that never landed (NAY-1 via the generic path below).
+    // Until then: pending.
+    if (w.synth == Synthetic::Pending && rec.orderStatus() != OrderStatus::Cancelled) {
+        if (g_config.diagLevel >= 2)
+            g_logger.logf(2, "BrokerTrade: PENDING order %d (cloid=%s) awaiting reconciliation",
+                          w.tradeId, state.cloid);
+        v.kind = TradeViewKind::Pending;
+        return v;
+    }
+
+    // --- RESUMED_ [OPM-90] ---
+    // Historical positions synced from broker on startup. No real order ID:
+    // cached entry price + live price for P&L.
+    if (w.synth == Synthetic::Resumed) {
+        v.hasOpen = true;
+        v.openPx = state.avgPrice;
+        if (state.avgPrice > 0) {
+            double currentPx = lookups.price(rec, state.coin);
+            if (currentPx > 0) {
+                double pnl = (currentPx - state.avgPrice) * state.filledSize;
+                if (state.side == OrderSide::Sell) pnl = -pnl;
+                v.profit = pnl;
+                v.hasProfit = true;
+            }
+        }
+        int fillLots = toLots(state.filledSize);
+        if (fillLots < 1 && state.filledSize > 0) fillLots = 1;
+        if (g_config.diagLevel >= 2)
+            g_logger.logf(2, "BrokerTrade: RESUMED %d -> %d lots (%.6f)",
+                          w.tradeId, fillLots, state.filledSize);
+        v.kind = TradeViewKind::Open;
+        v.lots = fillLots;
+        return v;
+    }
+
+    // --- IMPORTED_ live position lookup [OPM-90] ---
+    // Positions synced via GET_TRADES. Must use the CURRENT position —
+    // it may have changed due to fills from other orders.
+    if (w.synth == Synthetic::Imported) {
+        const account::PositionInfo& livePos = lookups.position(rec, state.coin);
+        bool importWasLong = (state.side == OrderSide::Buy);
+        bool currentIsLong = (livePos.size > 0);
+
+        // Position closed or reversed direction -> trade is done
+        if (!livePos.isOpen() || (importWasLong != currentIsLong)) {
+            if (g_config.diagLevel >= 1)
+                g_logger.logf(1, "BrokerTrade: IMPORTED %d %s — position %s",
+                    w.tradeId, state.coin, !livePos.isOpen() ? "CLOSED" : "REVERSED");
+            v.kind = TradeViewKind::Closed;
+            v.hasOpen = true;
+            v.openPx = state.avgPrice;
+            v.hasClose = true;
+            v.closePx = livePos.entryPrice > 0 ? livePos.entryPrice : state.avgPrice;
+            v.hasProfit = true;
+            v.profit = 0;
+            return v;
+        }
+
+        // Position still exists in same direction — report CURRENT size
+        double actualSize = fabs(livePos.size);
+        double entryPx = livePos.entryPrice > 0 ? livePos.entryPrice : state.avgPrice;
+        v.hasOpen = true;
+        v.openPx = entryPx;
+        if (entryPx > 0) {
+            double currentPx = lookups.price(rec, state.coin);
+            if (currentPx > 0) {
+                double pnl = (currentPx - entryPx) * actualSize;
+                if (!currentIsLong) pnl = -pnl;
+                v.profit = pnl;
+                v.hasProfit = true;
+            }
+        }
+        int fillLots = toLots(actualSize);
+        if (fillLots < 1 && actualSize > 0) fillLots = 1;
+        if (g_config.diagLevel >= 2)
+            g_logger.logf(2, "BrokerTrade: IMPORTED %d -> %d lots (live=%.6f, orig=%.6f)",
+                          w.tradeId, fillLots, actualSize, state.filledSize);
+        v.kind = TradeViewKind::Open;
+        v.lots = fillLots;
+        return v;
+    }
+
+    // --- Generic path ---
+    v.hasOpen = true;
+    v.openPx = rec.avgPrice;
+
+    if (rec.avgPrice > 0 && rec.filledSize > 0) {
+        double currentPx = lookups.price(rec, g_trading.coinName(rec.coinId));
+        if (currentPx > 0) {
+            double pnl = (currentPx - rec.avgPrice) * rec.filledSize;
+            if (rec.orderSide() == OrderSide::Sell) pnl = -pnl;
+            v.profit = pnl;
+            v.hasProfit = true;
+        }
+    }
+
+    if (rec.orderStatus() == OrderStatus::Cancelled) {
+        v.kind = TradeViewKind::Cancelled;
+    } else if (rec.filledSize > 0) {
+        int fillLots = toLots(rec.filledSize);
+        v.kind = TradeViewKind::Open;
+        v.lots = (fillLots > 0) ? fillLots : 1;
+    } else {
+        v.kind = TradeViewKind::Pending;
+    }
+    return v;
+}
+
+// Evaluate `ids` together; out[i] matches ids[i]
+void buildViews(const std::vector<int>& ids, std::vector<TradeView>& out) {
+    out.assign(ids.size(), TradeView());
+
+    // One lock for every hot record
+    std::vector<std::pair<int, OrderRecord>> recs = g_trading.getRecords(ids);
+    std::vector<Work> work;
+    std::vector<OrderState> states;
+    std::vector<size_t> slot;       // work[k] -> out[slot[k]]
+    work.reserve(recs.size());
+    slot.reserve(recs.size());
+
+    size_t r = 0;
+    for (size_t i = 0; i < ids.size() && r < recs.size(); i++) {
+        if (recs[r].first != ids[i]) continue;     // Unknown: stays Missing
+        Work w;
+        w.tradeId = ids[i];
+        w.rec = recs[r++].second;
+        w.oid[0] = 0;
+
+        // Synthetic orderIds (PENDING_/RESUMED_/IMPORTED_) are the only text
+        // oids; everything else never decodes the full OrderState
+        if (w.rec.oidKind == OidKind::Text) {
+            OrderState state;
+            if (!getOrder(w.tradeId, state)) continue;
+            if (strncmp(state.orderId, "PENDING_", 8) == 0) w.synth = Synthetic::Pending;
+            else if (strncmp(state.orderId, "RESUMED_", 8) == 0) w.synth = Synthetic::Resumed;
+            else if (strncmp(state.orderId, "IMPORTED_", 9) == 0) w.synth = Synthetic::Imported;
+            else strncpy_s(w.oid, state.orderId, _TRUNCATE);
+            w.stateIdx = (int)states.size();
+            states.push_back(state);
+        } else {
+            TradingState::formatOid(w.rec, w.oid, sizeof(w.oid));
+        }
+        work.push_back(w);
+        slot.push_back(i);
+    }
+
+    // --- WS fill totals for normal orders [OPM-90] ---
+    // Catches fills the onFillNotify callback may have missed; one lock for
+    // all orders instead of a fill-vector copy per order.
+    if (g_config.enableWebSocket && g_priceCache) {
+        std::vector<const char*> oids;
+        std::vector<size_t> owner;
+        for (size_t k = 0; k < work.size(); k++) {
+            if (work[k].synth == Synthetic::None && work[k].oid[0]) {
+                oids.push_back(work[k].oid);
+                owner.push_back(k);
+            }
+        }
+        if (!oids.empty()) {
+            auto* cache = static_cast<ws::PriceCache*>(g_priceCache);
+            std::vector<ws::FillTotal> totals;
+            cache->getFillTotals(oids, totals);
+            for (size_t j = 0; j < totals.size(); j++) {
+                if (totals[j].fills == 0 || totals[j].size <= 0) continue;
+                Work& w = work[owner[j]];
+                if (totals[j].size == w.rec.filledSize && totals[j].avgPx == w.rec.avgPrice)
+                    continue;   // Already applied: skip the locked update
+                OrderStatus newSt;
+                if (updateFillProgress(w.tradeId, totals[j].size, totals[j].avgPx, &newSt)) {
+                    w.rec.filledSize = totals[j].size;
+                    w.rec.avgPrice = totals[j].avgPx;
+                    w.rec.status = (uint8_t)newSt;
+                }
+            }
+        }
+    }
+
+    static const OrderState kNoState;
+    CoinLookups lookups;
+    for (size_t k = 0; k < work.size(); k++) {
+        const Work& w = work[k];
+        out[slot[k]] = evaluate(w, w.stateIdx >= 0 ? states[w.stateIdx] : kNoState, lookups);
+    }
+}
+
+} // namespace
+
+TradeView computeTradeView(int tradeId) {
+    std::vector<int> ids(1, tradeId);
+    std::vector<TradeView> out;
+    buildViews(ids, out);
+    return out[0];
+}
+
+// =============================================================================
+// SNAPSHOT
+// =============================================================================
+
+static void rebuild(int requestedId) {
+    auto t0 = std::chrono::steady_clock::now();
+
+    // Keep trades Zorro asked for last tick; forget those it stopped asking for
+    for (auto it = s_watch.begin(); it != s_watch.end(); ) {
+        WatchEntry& e = it->second;
+        e.idle = e.served ? 0 : e.idle + 1;
+        if (e.idle >= 2) it = s_watch.erase(it);
+        else ++it;
+    }
+    s_watch[requestedId].idle = 0;
+
+    std::vector<int> ids;
+    ids.reserve(s_watch.size());
+    for (const auto& kv : s_watch) ids.push_back(kv.first);
+
+    std::vector<TradeView> views;
+    buildViews(ids, views);
+    for (size_t i = 0; i < ids.size(); i++) {
+        WatchEntry& e = s_watch[ids[i]];
+        e.view = views[i];
+        e.served = false;
+    }
+
+    s_builtAt = GetTickCount();
+    s_valid.store(true);
+    s_stats.rebuilds++;
+    s_stats.lastTrades = (int)ids.size();
+    s_stats.lastBuildUs = std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now() - t0).count();
+}
+
+TradeView getTradeView(int tradeId) {
+    // Batched HTTP reconciliation of orders the push feed can't vouch for.
+    // Usually a no-op; a batch that changed anything invalidates the snapshot.
+    if (reconcileOrders() > 0) s_valid.store(false);
+
+    if (s_valid.load() && GetTickCount() - s_builtAt > (DWORD)config::TRADE_SNAPSHOT_MAX_AGE_MS)
+        s_valid.store(false);
+
+    auto it = s_watch.find(tradeId);
+
+    // Asked again for a trade already served: Zorro started a new tick
+    if (s_valid.load() && it != s_watch.end() && it->second.served)
+        s_valid.store(false);
+
+    if (!s_valid.load()) {
+        rebuild(tradeId);
+        it = s_watch.find(tradeId);
+    } else if (it == s_watch.end()) {
+        // New this tick: compute alone, include from the next snapshot on
+        s_stats.misses++;
+        WatchEntry& e = s_watch[tradeId];
+        e.view = computeTradeView(tradeId);
+        e.served = true;
+        return e.view;
+    }
+
+    s_stats.hits++;
+    it->second.served = true;
+    return it->second.view;
+}
+
+void invalidateTradeSnapshot() {
+    s_valid.store(false);
+}
+
+TradeSnapshotStats getTradeSnapshotStats() {
+    return s_stats;
+}
+
+void resetTradeSnapshot() {
+    s_watch.clear();
+    s_valid.store(false);
+    s_builtAt = 0;
+    s_stats = TradeSnapshotStats();
+}
+
+} // namespace trading
+} // namespace hl
@@ -0,0 +1,75 @@
+//=============================================================================
+// hl_trade_snapshot.h - Per-tick BrokerTrade results for all open trades
+//=============================================================================
+// Part of Hyperliquid Plugin for Zorro
+//
+// LAYER: Services
+// DEPENDENCIES: hl_globals.h, hl_market_service.h, hl_account_service.h,
+//               hl_order_sync.h, ws_price_cache.h
+// THREAD SAFETY: Zorro thread only (BrokerTrade)
+//
+// Zorro calls BrokerTrade once per open trade per tick. Rather than each call
+// reading its own record, fill totals, price and (IMPORTED_) position, the
+// first call of a tick computes every trade asked about in the previous tick
+// in one pass: one trade-map lock, one fill-store lock, one price lookup per
+// coin and one position lookup per coin. Later calls in the tick are served
+// from that snapshot.
+//
+// A new tick is recognised when a trade already served from the snapshot is
+// asked for again. The snapshot is also dropped after
+// TRADE_SNAPSHOT_MAX_AGE_MS, after a reconciliation batch, and on
+// invalidateTradeSnapshot() (order placed, closed, cancelled or modified).
+// Trades not in the snapshot are computed on their own and join the next one.
+//=============================================================================
+
+#pragma once
+
+#include <cstdint>
+
+namespace hl {
+namespace trading {
+
+enum class TradeViewKind : uint8_t {
+    Missing,        // Not tracked                        -> NAY
+    Pending,        // Nothing filled yet                 -> 0
+    Open,           // (Partially) filled: `lots`          -> lots
+    Closed,         // IMPORTED_ position closed/reversed -> 0
+    Cancelled       //                                    -> NAY-1
+};
+
+/// What BrokerTrade reports for one trade
+struct TradeView {
+    TradeViewKind kind = TradeViewKind::Missing;
+    int lots = 0;
+    double openPx = 0.0;
+    double closePx = 0.0;
+    double profit = 0.0;
+    bool hasOpen = false;       // Set pOpen (and pRoll = 0)
+    bool hasClose = false;
+    bool hasProfit = false;
+};
+
+/// Result for one trade from this tick's snapshot (rebuilt as needed)
+TradeView getTradeView(int tradeId);
+
+/// Compute one trade on its own, bypassing the snapshot (same result)
+TradeView computeTradeView(int tradeId);
+
+/// Drop the snapshot; the next getTradeView() recomputes
+void invalidateTradeSnapshot();
+
+struct TradeSnapshotStats {
+    long long rebuilds = 0;
+    long long hits = 0;         // Served from a snapshot
+    long long misses = 0;       // Not in the snapshot: computed on its own
+    int lastTrades = 0;         // Trades in the last snapshot
+    double lastBuildUs = 0.0;   // Time to build it
+};
+
+TradeSnapshotStats getTradeSnapshotStats();
+
+/// Forget snapshot, watched trades and stats (BrokerOpen / tests)
+void resetTradeSnapshot();
+
+} // namespace trading
+} // namespace hl
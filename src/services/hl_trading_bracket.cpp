@@ -16,6 +16,7 @@
 
 #include "hl_trading_bracket.h"
 #include "hl_trading_service.h"
+#include "hl_order_sync.h"
 #include "hl_meta.h"
 #include "../foundation/hl_globals.h"
 #include "../foundation/hl_utils.h"
@@ -282,7 +283,7 @@ BracketResult placeBracketOrder(const BracketRequest& request) {
         logBracket(2, "place", msg);
     }
 
-    yyjson_doc* doc = yyjson_read(resp.body.c_str(), resp.body.size(), 0);
+    yyjson_doc* doc = json::parse(resp.body.c_str(), resp.body.size());
     if (!doc) {
         result.error = "Failed to parse exchange response";
         logBracket(1, "place", "JSON parse failed");
@@ -339,6 +340,7 @@ BracketResult placeBracketOrder(const BracketRequest& request) {
             }
         }
         storeOrder(entryTradeId, state);
+        markOrderSynced(entryTradeId);
     }
 
     // Store TP order state (if present)
@@ -361,6 +363,7 @@ BracketResult placeBracketOrder(const BracketRequest& request) {
             }
         }
         storeOrder(tpTradeId, state);
+        markOrderSynced(tpTradeId);
     }
 
     // Store SL order state (if present)
@@ -384,6 +387,7 @@ BracketResult placeBracketOrder(const BracketRequest& request) {
             }
         }
         storeOrder(slTradeId, state);
+        markOrderSynced(slTradeId);
     }
 
     yyjson_doc_free(doc);
@@ -39,44 +39,24 @@ static void logMsg(int level, const char* prefix, const char* msg) {
 // ORDER LOOKUP
 // =============================================================================
 
-bool getOrderByCloid(const char* cloid, OrderState& outState) {
-    if (!cloid) return false;
-
-    if (!g_trading.tradeCsInit) return false;
+// Lookups go through the cloid/oid indices on g_trading — these run on the
+// WS thread for every orderUpdates/userFills callback
 
-    EnterCriticalSection(&g_trading.tradeCs);
-    for (const auto& pair : g_trading.tradeMap) {
-        if (strcmp(pair.second.cloid, cloid) == 0) {
-            outState = pair.second;
-            LeaveCriticalSection(&g_trading.tradeCs);
-            return true;
-        }
-    }
-    LeaveCriticalSection(&g_trading.tradeCs);
-    return false;
+bool getOrderByCloid(const char* cloid, OrderState& outState) {
+    return g_trading.getOrderByCloid(cloid, outState);
 }
 
 bool getOrderByOid(const char* oid, OrderState& outState) {
-    if (!oid) return false;
-
-    if (!g_trading.tradeCsInit) return false;
-
-    EnterCriticalSection(&g_trading.tradeCs);
-    for (const auto& pair : g_trading.tradeMap) {
-        if (strcmp(pair.second.orderId, oid) == 0) {
-            outState = pair.second;
-            LeaveCriticalSection(&g_trading.tradeCs);
-            return true;
-        }
-    }
-    LeaveCriticalSection(&g_trading.tradeCs);
-    return false;
+    return g_trading.getOrderByOid(oid, outState);
 }
 
 int findTradeIdByCloid(const char* cloid) {
     if (!cloid) return 0;
 
-    // First try extracting from CLOID format
+    int tradeId = g_trading.findByCloid(cloid);
+    if (tradeId > 0) return tradeId;
+
+    // Fall back to the trade ID embedded in our CLOID format
     int embedded = extractTradeIdFromCloid(cloid);
     if (embedded > 0) {
         OrderState state;
@@ -84,35 +64,11 @@ int findTradeIdByCloid(const char* cloid) {
             return embedded;
         }
     }
-
-    // Search through trade map
-    if (!g_trading.tradeCsInit) return 0;
-
-    EnterCriticalSection(&g_trading.tradeCs);
-    for (const auto& pair : g_trading.tradeMap) {
-        if (strcmp(pair.second.cloid, cloid) == 0) {
-            int result = pair.first;
-            LeaveCriticalSection(&g_trading.tradeCs);
-            return result;
-        }
-    }
-    LeaveCriticalSection(&g_trading.tradeCs);
     return 0;
 }
 
 int findTradeIdByOid(const char* oid) {
-    if (!oid || !g_trading.tradeCsInit) return 0;
-
-    EnterCriticalSection(&g_trading.tradeCs);
-    for (const auto& pair : g_trading.tradeMap) {
-        if (strcmp(pair.second.orderId, oid) == 0) {
-            int result = pair.first;
-            LeaveCriticalSection(&g_trading.tradeCs);
-            return result;
-        }
-    }
-    LeaveCriticalSection(&g_trading.tradeCs);
-    return 0;
+    return g_trading.findByOid(oid);
 }
 
 bool updateOrderByCloid(const char* cloid, double filledSize, double avgPrice, OrderStatus status) {
@@ -150,7 +106,7 @@ CloidQueryResult queryOrderByCloid(const char* cloid) {
         return result;
     }
 
-    yyjson_doc* doc = yyjson_read(resp.body.c_str(), resp.body.size(), 0);
+    yyjson_doc* doc = json::parse(resp.body.c_str(), resp.body.size());
     if (!doc) {
         strncpy_s(result.status, "parse_error", _TRUNCATE);
         result.outcome = QueryOutcome::Failed;
@@ -324,7 +280,7 @@ bool cancelOrder(const char* coin, const char* oid) {
 
     // Check response status for errors
     if (!resp.body.empty()) {
-        yyjson_doc* cancelDoc = yyjson_read(resp.body.c_str(), resp.body.size(), 0);
+        yyjson_doc* cancelDoc = json::parse(resp.body.c_str(), resp.body.size());
         if (cancelDoc) {
             yyjson_val* cancelRoot = yyjson_doc_get_root(cancelDoc);
             const char* st = json::getStringPtr(cancelRoot, "status");
@@ -455,7 +411,7 @@ static bool submitScheduleCancel(uint64_t timeMs) {
 
     // Check response for errors
     if (!resp.body.empty()) {
-        yyjson_doc* doc = yyjson_read(resp.body.c_str(), resp.body.size(), 0);
+        yyjson_doc* doc = json::parse(resp.body.c_str(), resp.body.size());
         if (doc) {
             yyjson_val* root = yyjson_doc_get_root(doc);
             const char* st = json::getStringPtr(root, "status");
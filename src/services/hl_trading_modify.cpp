@@ -224,7 +224,7 @@ ModifyResult modifyOrder(const ModifyRequest& request) {
         logMsg(2, "modifyOrder", msg);
     }
 
-    yyjson_doc* doc = yyjson_read(resp.body.c_str(), resp.body.size(), 0);
+    yyjson_doc* doc = json::parse(resp.body.c_str(), resp.body.size());
     if (!doc) {
         result.error = "Failed to parse exchange response JSON";
         logMsg(1, "modifyOrder", result.error.c_str());
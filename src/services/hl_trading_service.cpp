@@ -14,11 +14,15 @@
 //=============================================================================
 
 #include "hl_trading_service.h"
+#include "hl_order_sync.h"
+#include "hl_trade_snapshot.h"
 #include "hl_meta.h"
 #include "../foundation/hl_globals.h"
 #include "../foundation/hl_utils.h"
 #include "../foundation/hl_crypto.h"
 #include "../foundation/hl_eip712.h"
+#include "../foundation/hl_latency.h"
+#include "../foundation/hl_trace.h"
 #include "../transport/hl_http.h"
 #include "../transport/json_helpers.h"
 #include <cstdio>
@@ -116,6 +120,7 @@ uint64_t generateNonce() {
 
 void storeOrder(int tradeId, const OrderState& state) {
     g_trading.setOrder(tradeId, state);
+    invalidateTradeSnapshot();
 
     if (g_config.diagLevel >= 2) {
         char msg[256];
@@ -134,20 +139,29 @@ bool getOrder(int tradeId, OrderState& outState) {
     return g_trading.getOrder(tradeId, outState);
 }
 
+bool getOrderRecord(int tradeId, OrderRecord& outRecord) {
+    return g_trading.getRecord(tradeId, outRecord);
+}
+
+static double oleNow() {
+    return (double)time(nullptr) / 86400.0 + 25569.0; // OLE DATE
+}
+
 bool updateOrder(int tradeId, double filledSize, double avgPrice, OrderStatus status) {
-    OrderState state;
-    if (!g_trading.getOrder(tradeId, state)) return false;
+    return g_trading.applyFill(tradeId, filledSize, avgPrice, status, oleNow());
+}
 
-    state.filledSize = filledSize;
-    state.avgPrice = avgPrice;
-    state.status = status;
-    state.lastUpdate = (double)time(nullptr) / 86400.0 + 25569.0; // OLE DATE
+bool updateFillProgress(int tradeId, double totalFilled, double avgPrice, OrderStatus* outStatus) {
+    return g_trading.applyFillProgress(tradeId, totalFilled, avgPrice, oleNow(), outStatus);
+}
 
-    return g_trading.updateOrder(tradeId, state);
+bool setOrderId(int tradeId, const char* oid) {
+    return g_trading.setOrderId(tradeId, oid, oleNow());
 }
 
 void removeOrder(int tradeId) {
     g_trading.removeOrder(tradeId);
+    invalidateTradeSnapshot();
 }
 
 // =============================================================================
@@ -219,6 +233,8 @@ OrderResult placeOrder(const OrderRequest& request) {
 OrderResult placeOrderWithId(const OrderRequest& request, int tradeId) {
     OrderResult result;
     result.success = false;
+    trace::Span span("placeOrder", "trading");
+    span.setOrder(tradeId);
 
     // Validate request
     if (request.coin.empty()) {
@@ -248,6 +264,7 @@ OrderResult placeOrderWithId(const OrderRequest& request, int tradeId) {
         strncpy_s(cloid, request.cloid.c_str(), _TRUNCATE);
     }
     result.cloid = cloid;
+    span.setOrder(tradeId, cloid);
 
     if (g_config.diagLevel >= 1) {
         char msg[256];
@@ -275,6 +292,7 @@ OrderResult placeOrderWithId(const OrderRequest& request, int tradeId) {
         storeOrder(tradeId, state);
         result.success = true;
         result.oid = "DRY_RUN";
+        span.setDetail("dry run");
         logMsg(1, "placeOrder", "DRY RUN - order not sent to exchange");
         return result;
     }
@@ -320,8 +338,10 @@ OrderResult placeOrderWithId(const OrderRequest& request, int tradeId) {
     uint64_t nonce = generateNonce();
     bool isMainnet = !g_config.isTestnet;
     std::string vault(g_config.vaultAddress);  // [OPM-202]
+    HL_LAT_BEGIN(hashStart);
     eip712::ByteArray msgHash = eip712::hashOrderForSigning(
         orderAction, isMainnet, nonce, vault);
+    HL_LAT_END(Eip712Hash, hashStart);
 
     if (msgHash.empty() || msgHash.size() != 32) {
         result.error = "Failed to generate EIP-712 message hash";
@@ -331,13 +351,17 @@ OrderResult placeOrderWithId(const OrderRequest& request, int tradeId) {
 
     // STEP 3: Sign the hash with private key
     crypto::Signature sig;
-    if (!crypto::signHash(msgHash.data(), g_config.privateKey, sig)) {
+    HL_LAT_BEGIN(signStart);
+    bool signedOk = crypto::signHash(msgHash.data(), g_config.privateKey, sig);
+    HL_LAT_END(Sign, signStart);
+    if (!signedOk) {
         result.error = "Failed to sign order";
         logMsg(1, "placeOrder", "Failed to sign order");
         return result;
     }
 
     // STEP 4: Build signed order JSON for submission
+    HL_LAT_BEGIN(serializeStart);
     // Build the "t" (type) field — different for trigger vs limit [OPM-77]
     char tField[256];
     if (request.isTriggerOrder()) {
@@ -394,6 +418,7 @@ OrderResult placeOrderWithId(const OrderRequest& request, int tradeId) {
         sig.toJson().c_str(),
         vaultJson
     );
+    HL_LAT_END(Serialize, serializeStart);
 
     {
         char msg[512];
@@ -402,9 +427,13 @@ OrderResult placeOrderWithId(const OrderRequest& request, int tradeId) {
     }
 
     // STEP 5: Submit to exchange via HTTP
+    HL_LAT_ORDER_SENT(tradeId);
     http::Response resp = http::exchangePost(orderJson);
+    trace::instant("exchange response", "trading", tradeId, cloid,
+                   resp.success() ? "HTTP" : "HTTP failed");
     if (!resp.success()) {
         logMsg(1, "placeOrder", "HTTP request failed — querying exchange for order status");
+        span.setDetail("http failed, queried");
 
         Sleep(1000);
 
@@ -427,6 +456,7 @@ OrderResult placeOrderWithId(const OrderRequest& request, int tradeId) {
             else if (strcmp(qr.status, "canceled") == 0) state.status = OrderStatus::Cancelled;
             else state.status = OrderStatus::Open;
             storeOrder(tradeId, state);
+            markOrderSynced(tradeId);
 
             result.success = true;
             result.oid = state.orderId;
@@ -478,7 +508,7 @@ OrderResult placeOrderWithId(const OrderRequest& request, int tradeId) {
         logMsg(1, "placeOrder", msg);
     }
 
-    yyjson_doc* doc = yyjson_read(body, resp.body.size(), 0);
+    yyjson_doc* doc = json::parse(body, resp.body.size());
     if (!doc) {
         result.error = "Failed to parse exchange response JSON";
         logMsg(1, "placeOrder", result.error.c_str());
@@ -497,6 +527,7 @@ OrderResult placeOrderWithId(const OrderRequest& request, int tradeId) {
         }
         result.error = errMsg;
         logMsg(1, "placeOrder", errMsg);
+        span.setDetail("rejected");
         yyjson_doc_free(doc);
         return result;
     }
@@ -564,6 +595,9 @@ OrderResult placeOrderWithId(const OrderRequest& request, int tradeId) {
     state.lastUpdate = (double)time(nullptr) / 86400.0 + 25569.0;
 
     storeOrder(tradeId, state);
+    markOrderSynced(tradeId);   // Post response is the order's current state
+    if (isFilled && filledSize > 0) HL_LAT_ORDER_FILLED(tradeId);
+    span.setDetail(isFilled ? "filled" : (isResting ? "resting" : "accepted"));
 
     result.success = true;
     result.oid = oid;
@@ -101,6 +101,12 @@ void storeOrder(int tradeId, const OrderState& state);
 /// @return true if found
 bool getOrder(int tradeId, OrderState& outState);
 
+/// Get the compact hot record (no string formatting; see OrderRecord)
+/// @param tradeId Zorro trade ID
+/// @param outRecord Output for the record
+/// @return true if found
+bool getOrderRecord(int tradeId, OrderRecord& outRecord);
+
 /// Get order state by CLOID
 /// @param cloid Client order ID
 /// @param outState Output for order state
@@ -121,6 +127,17 @@ bool getOrderByOid(const char* oid, OrderState& outState);
 /// @return true if order was found and updated
 bool updateOrder(int tradeId, double filledSize, double avgPrice, OrderStatus status);
 
+/// Apply a cumulative fill total (WS/HTTP fill sums). Status is derived from
+/// the requested size; totals below the stored filled size are ignored, so
+/// a stale source cannot roll a fill back.
+/// @param tradeId Zorro trade ID
+/// @param totalFilled Cumulative filled size
+/// @param avgPrice Volume-weighted average fill price
+/// @param outStatus Optional output for the resulting status
+/// @return true if the order was found and updated
+bool updateFillProgress(int tradeId, double totalFilled, double avgPrice,
+                        OrderStatus* outStatus = nullptr);
+
 /// Update order by CLOID
 /// @param cloid Client order ID
 /// @param filledSize New filled size
@@ -129,6 +146,12 @@ bool updateOrder(int tradeId, double filledSize, double avgPrice, OrderStatus st
 /// @return true if order was found and updated
 bool updateOrderByCloid(const char* cloid, double filledSize, double avgPrice, OrderStatus status);
 
+/// Replace the exchange order ID (re-indexes oid lookups)
+/// @param tradeId Zorro trade ID
+/// @param oid New exchange order ID
+/// @return true if the order was found
+bool setOrderId(int tradeId, const char* oid);
+
 /// Remove order from tracking (e.g., after full fill or cancel)
 /// @param tradeId Zorro trade ID
 void removeOrder(int tradeId);
@@ -183,7 +183,7 @@ TwapResult placeTwapOrder(const TwapRequest& request) {
         logTwap(2, "place", msg);
     }
 
-    yyjson_doc* doc = yyjson_read(resp.body.c_str(), resp.body.size(), 0);
+    yyjson_doc* doc = json::parse(resp.body.c_str(), resp.body.size());
     if (!doc) {
         result.error = "Failed to parse exchange response";
         logTwap(1, "place", "JSON parse failed");
@@ -309,7 +309,7 @@ bool cancelTwapOrder(const char* coin, uint64_t twapId) {
 
     // Check for error in response
     if (!resp.body.empty()) {
-        yyjson_doc* doc = yyjson_read(resp.body.c_str(), resp.body.size(), 0);
+        yyjson_doc* doc = json::parse(resp.body.c_str(), resp.body.size());
         if (doc) {
             yyjson_val* root = yyjson_doc_get_root(doc);
             const char* st = json::getStringPtr(root, "status");
@@ -0,0 +1,283 @@
+//=============================================================================
+// hl_capture.cpp - Record/replay capture implementation
+//=============================================================================
+// Part of Hyperliquid Plugin for Zorro
+//
+// LAYER: Transport
+// DEPENDENCIES: hl_capture.h
+//=============================================================================
+
+#include "hl_capture.h"
+#include "../foundation/hl_latency.h"
+#include <cstring>
+#include <ctime>
+
+namespace hl {
+namespace capture {
+
+std::atomic<bool> g_active(false);
+
+namespace {
+
+const char MAGIC[6] = { 'H', 'L', 'C', 'A', 'P', 0 };
+const uint16_t VERSION = 1;
+const size_t FILE_HEADER = 16;
+const size_t RECORD_HEADER = 16;
+const uint32_t MAX_RECORD = 64u * 1024 * 1024;     // Reader sanity limit
+
+// Writer state; the critical section serializes the IX, connection and
+// Zorro threads while a capture runs
+struct Writer {
+    CRITICAL_SECTION cs;
+    FILE* file = nullptr;
+    uint64_t startTicks = 0;
+    double nsPerTick = 1.0;
+    long long records = 0;
+    long long bytes = 0;
+    Writer() { InitializeCriticalSection(&cs); }
+    ~Writer() { DeleteCriticalSection(&cs); }
+};
+
+Writer& writer() {
+    static Writer w;
+    return w;
+}
+
+std::atomic<uint32_t> s_httpId(0);
+
+void put16(unsigned char* p, uint16_t v) { p[0] = (unsigned char)v; p[1] = (unsigned char)(v >> 8); }
+void put32(unsigned char* p, uint32_t v) { for (int i = 0; i < 4; i++) p[i] = (unsigned char)(v >> (8 * i)); }
+void put64(unsigned char* p, uint64_t v) { for (int i = 0; i < 8; i++) p[i] = (unsigned char)(v >> (8 * i)); }
+uint16_t get16(const unsigned char* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+uint32_t get32(const unsigned char* p) {
+    uint32_t v = 0;
+    for (int i = 3; i >= 0; i--) v = (v << 8) | p[i];
+    return v;
+}
+uint64_t get64(const unsigned char* p) {
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; i--) v = (v << 8) | p[i];
+    return v;
+}
+
+void writeLocked(Writer& w, Kind kind, uint8_t channel, uint16_t status,
+                 const char* a, size_t alen, const char* b, size_t blen) {
+    if (!w.file) return;
+    uint64_t ticks = lat::now() - w.startTicks;
+    unsigned char hdr[RECORD_HEADER];
+    put64(hdr, (uint64_t)((double)ticks * w.nsPerTick));
+    put32(hdr + 8, (uint32_t)(alen + blen));
+    hdr[12] = (unsigned char)kind;
+    hdr[13] = channel;
+    put16(hdr + 14, status);
+    fwrite(hdr, 1, sizeof(hdr), w.file);
+    if (alen) fwrite(a, 1, alen, w.file);
+    if (blen) fwrite(b, 1, blen, w.file);
+    w.records++;
+    w.bytes += (long long)(alen + blen);
+}
+
+} // namespace
+
+const char* kindName(Kind k) {
+    switch (k) {
+        case Kind::WsRecv:       return "WsRecv";
+        case Kind::WsSend:       return "WsSend";
+        case Kind::WsOpen:       return "WsOpen";
+        case Kind::WsClose:      return "WsClose";
+        case Kind::HttpRequest:  return "HttpRequest";
+        case Kind::HttpResponse: return "HttpResponse";
+    }
+    return "?";
+}
+
+//=============================================================================
+// RECORDER
+//=============================================================================
+
+bool start(const char* path) {
+    if (!path || !*path) return false;
+    stop();
+    FILE* f = nullptr;
+    if (fopen_s(&f, path, "wb") != 0 || !f) return false;
+    setvbuf(f, nullptr, _IOFBF, 256 * 1024);
+
+    unsigned char hdr[FILE_HEADER];
+    memcpy(hdr, MAGIC, sizeof(MAGIC));
+    put16(hdr + 6, VERSION);
+    put64(hdr + 8, (uint64_t)time(nullptr) * 1000);
+    fwrite(hdr, 1, sizeof(hdr), f);
+
+    LARGE_INTEGER freq;
+    QueryPerformanceFrequency(&freq);
+
+    Writer& w = writer();
+    EnterCriticalSection(&w.cs);
+    w.file = f;
+    w.startTicks = lat::now();
+    w.nsPerTick = freq.QuadPart > 0 ? 1e9 / (double)freq.QuadPart : 1.0;
+    w.records = 0;
+    w.bytes = 0;
+    LeaveCriticalSection(&w.cs);
+    g_active.store(true, std::memory_order_release);
+    return true;
+}
+
+void stop() {
+    g_active.store(false, std::memory_order_release);
+    Writer& w = writer();
+    EnterCriticalSection(&w.cs);
+    if (w.file) {
+        fclose(w.file);
+        w.file = nullptr;
+    }
+    LeaveCriticalSection(&w.cs);
+}
+
+CaptureStats getStats() {
+    CaptureStats st;
+    Writer& w = writer();
+    EnterCriticalSection(&w.cs);
+    st.active = w.file != nullptr;
+    st.records = w.records;
+    st.bytes = w.bytes;
+    LeaveCriticalSection(&w.cs);
+    return st;
+}
+
+void record(Kind kind, uint8_t channel, uint16_t status, const char* data, size_t len) {
+    if (!active()) return;
+    Writer& w = writer();
+    EnterCriticalSection(&w.cs);
+    writeLocked(w, kind, channel, status, data, data ? len : 0, nullptr, 0);
+    LeaveCriticalSection(&w.cs);
+}
+
+uint8_t nextHttpId() {
+    return (uint8_t)(s_httpId.fetch_add(1, std::memory_order_relaxed) % 255 + 1);
+}
+
+void recordHttpRequest(uint8_t id, const char* method, const char* url, const char* body) {
+    if (!active()) return;
+    std::string head = std::string(method ? method : "POST") + " " + (url ? url : "") + "\n";
+    Writer& w = writer();
+    EnterCriticalSection(&w.cs);
+    writeLocked(w, Kind::HttpRequest, id, 0, head.data(), head.size(),
+                body, body ? strlen(body) : 0);
+    LeaveCriticalSection(&w.cs);
+}
+
+//=============================================================================
+// READER
+//=============================================================================
+
+bool Reader::open(const char* path) {
+    close();
+    if (!path || !*path) return false;
+    if (fopen_s(&file_, path, "rb") != 0 || !file_) {
+        file_ = nullptr;
+        return false;
+    }
+    unsigned char hdr[FILE_HEADER];
+    if (fread(hdr, 1, sizeof(hdr), file_) != sizeof(hdr) ||
+        memcmp(hdr, MAGIC, sizeof(MAGIC)) != 0 || get16(hdr + 6) != VERSION) {
+        close();
+        return false;
+    }
+    startUnixMs_ = get64(hdr + 8);
+    return true;
+}
+
+void Reader::close() {
+    if (file_) fclose(file_);
+    file_ = nullptr;
+}
+
+bool Reader::next(Record& out) {
+    if (!file_) return false;
+    unsigned char hdr[RECORD_HEADER];
+    if (fread(hdr, 1, sizeof(hdr), file_) != sizeof(hdr)) return false;
+    uint32_t len = get32(hdr + 8);
+    if (len > MAX_RECORD) return false;
+    out.tsNs = get64(hdr);
+    out.kind = (Kind)hdr[12];
+    out.channel = hdr[13];
+    out.status = get16(hdr + 14);
+    out.data.resize(len);
+    return len == 0 || fread(&out.data[0], 1, len, file_) == len;
+}
+
+bool Reader::readAll(const char* path, std::vector<Record>& out) {
+    Reader r;
+    if (!r.open(path)) return false;
+    Record rec;
+    while (r.next(rec)) out.push_back(rec);
+    return true;
+}
+
+//=============================================================================
+// HTTP REPLAY
+//=============================================================================
+
+HttpReplay::HttpReplay() : served_(0), missed_(0) {
+    InitializeCriticalSection(&cs_);
+}
+
+HttpReplay::~HttpReplay() {
+    DeleteCriticalSection(&cs_);
+}
+
+void HttpReplay::load(const std::vector<Record>& records) {
+    EnterCriticalSection(&cs_);
+    exchanges_.clear();
+    served_ = missed_ = 0;
+    int pending[256];                           // Exchange index by call id
+    for (int& p : pending) p = -1;
+    for (const Record& r : records) {
+        if (r.kind == Kind::HttpRequest) {
+            size_t nl = r.data.find('\n');
+            Exchange ex;
+            ex.target = r.data.substr(0, nl);
+            ex.body = nl == std::string::npos ? std::string() : r.data.substr(nl + 1);
+            ex.status = 0;
+            ex.used = false;
+            pending[r.channel] = (int)exchanges_.size();
+            exchanges_.push_back(ex);
+        } else if (r.kind == Kind::HttpResponse && pending[r.channel] >= 0) {
+            Exchange& ex = exchanges_[pending[r.channel]];
+            ex.status = r.status;
+            ex.response = r.data;
+            pending[r.channel] = -1;
+        }
+    }
+    LeaveCriticalSection(&cs_);
+}
+
+bool HttpReplay::serve(const char* method, const char* url, const char* body, http::Response& out) {
+    std::string target = std::string(method ? method : "POST") + " " + (url ? url : "");
+    const char* b = body ? body : "";
+    EnterCriticalSection(&cs_);
+    Exchange* hit = nullptr;
+    for (Exchange& ex : exchanges_) {
+        if (!ex.used && ex.target == target && ex.body == b) { hit = &ex; break; }
+    }
+    if (!hit) {
+        for (Exchange& ex : exchanges_) {
+            if (!ex.used && ex.target == target) { hit = &ex; break; }
+        }
+    }
+    if (hit) {
+        hit->used = true;
+        out.statusCode = hit->status;
+        out.body = hit->response;
+        out.error = hit->status ? "" : "replayed failure";
+        served_++;
+    } else {
+        missed_++;
+    }
+    LeaveCriticalSection(&cs_);
+    return hit != nullptr;
+}
+
+} // namespace capture
+} // namespace hl
@@ -0,0 +1,149 @@
+//=============================================================================
+// hl_capture.h - Record/replay capture of WebSocket and HTTP traffic
+//=============================================================================
+// Part of Hyperliquid Plugin for Zorro
+//
+// LAYER: Transport
+// DEPENDENCIES: hl_http.h (Response), hl_latency.h (clock)
+// THREAD SAFETY: record() from any thread (serialized internally while a
+//                capture is running); start()/stop() from one thread.
+//                Reader and HttpReplay: one thread each, HttpReplay::serve
+//                may be called from any thread.
+//
+// Connection records every frame it receives and sends plus open/close
+// events; sendHttpInternal records each request and its response. Records
+// carry the nanoseconds since start() so a replay can keep the original
+// pacing. Not capturing costs one relaxed load per frame/request.
+//
+// FILE FORMAT (little-endian):
+//   header  "HLCAP" 0x00 | uint16 version | uint64 start (Unix ms)   16 bytes
+//   record  uint64 tsNs | uint32 len | uint8 kind | uint8 channel |
+//           uint16 status | payload[len]                           16 + len
+//   channel: WS connection index (0 = primary) or HTTP call id (1-255, a
+//            request and its response share it); status: HTTP status or
+//            WS close code. HttpRequest payload: "<METHOD> <url>\n<body>".
+//=============================================================================
+
+#pragma once
+
+#include "hl_http.h"
+#include "../foundation/hl_platform.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace hl {
+namespace capture {
+
+enum class Kind : uint8_t {
+    WsRecv = 1,         // Frame received (arrival on the IX thread)
+    WsSend,             // Frame sent
+    WsOpen,             // Connection (re)opened
+    WsClose,            // Close frame or network error (status = code)
+    HttpRequest,
+    HttpResponse        // status 0 = transport failure, empty payload
+};
+
+struct Record {
+    Kind kind = Kind::WsRecv;
+    uint8_t channel = 0;
+    uint16_t status = 0;
+    uint64_t tsNs = 0;
+    std::string data;
+};
+
+struct CaptureStats {
+    bool active = false;
+    long long records = 0;
+    long long bytes = 0;            // Payload bytes written
+};
+
+const char* kindName(Kind k);
+
+//-----------------------------------------------------------------------------
+// Recorder
+//-----------------------------------------------------------------------------
+
+extern std::atomic<bool> g_active;
+
+inline bool active() { return g_active.load(std::memory_order_relaxed); }
+
+/// Starts a new capture file (stops a running one first)
+bool start(const char* path);
+void stop();
+CaptureStats getStats();
+
+/// Appends one record; no-op unless a capture is running
+void record(Kind kind, uint8_t channel, uint16_t status, const char* data, size_t len);
+
+/// Id tying an HttpRequest to its HttpResponse (1-255, wraps)
+uint8_t nextHttpId();
+void recordHttpRequest(uint8_t id, const char* method, const char* url, const char* body);
+
+//-----------------------------------------------------------------------------
+// Reader
+//-----------------------------------------------------------------------------
+
+class Reader {
+public:
+    Reader() : file_(nullptr), startUnixMs_(0) {}
+    ~Reader() { close(); }
+    Reader(const Reader&) = delete;
+    Reader& operator=(const Reader&) = delete;
+
+    /// False if the file is missing or not a capture
+    bool open(const char* path);
+    void close();
+    /// False at end of file or on a truncated record
+    bool next(Record& out);
+    uint64_t startUnixMs() const { return startUnixMs_; }
+
+    /// Whole file into memory
+    static bool readAll(const char* path, std::vector<Record>& out);
+
+private:
+    FILE* file_;
+    uint64_t startUnixMs_;
+};
+
+//-----------------------------------------------------------------------------
+// HTTP replay: answers requests with the responses of a capture
+//-----------------------------------------------------------------------------
+
+class HttpReplay {
+public:
+    HttpReplay();
+    ~HttpReplay();
+    HttpReplay(const HttpReplay&) = delete;
+    HttpReplay& operator=(const HttpReplay&) = delete;
+
+    /// Pairs each HttpRequest with the HttpResponse of the same id
+    void load(const std::vector<Record>& records);
+
+    /// Oldest unused exchange with the same method, URL and body; failing
+    /// that the oldest unused one with the same method and URL (signed
+    /// /exchange bodies never repeat). False if none is left.
+    bool serve(const char* method, const char* url, const char* body, http::Response& out);
+
+    int size() const { return (int)exchanges_.size(); }
+    int served() const { return served_; }
+    int missed() const { return missed_; }
+
+private:
+    struct Exchange {
+        std::string target;         // "<METHOD> <url>"
+        std::string body;
+        int status;
+        std::string response;
+        bool used;
+    };
+    std::vector<Exchange> exchanges_;
+    int served_;
+    int missed_;
+    CRITICAL_SECTION cs_;
+};
+
+} // namespace capture
+} // namespace hl
@@ -6,14 +6,18 @@
 //=============================================================================
 
 #include "hl_http.h"
+#include "hl_capture.h"
 #include "../foundation/hl_globals.h"
 #include "../foundation/hl_config.h"
+#include "../foundation/hl_latency.h"
+#include "../foundation/hl_trace.h"
 
 #include <cstring>
 #include <cstdio>
+#include <atomic>
 
-// Windows headers
-#include <windows.h>
+// Win32 subset + SEH guard (hl_platform.h)
+#include "../foundation/hl_platform.h"
 
 // =============================================================================
 // ZORRO SDK HTTP FUNCTIONS (declared as extern function pointers)
@@ -46,6 +50,49 @@ static const char* HTTP_HEADERS =
     "Connection: close\r\n"
     "User-Agent: Zorro-Hyperliquid/1.1";
 
+// =============================================================================
+// CALL METRICS
+// =============================================================================
+// Rate-limit weight is charged per request, so every attempt is counted.
+// Bucket b holds the calls of the minute m with m % 60 == b; the first
+// writer in a new minute resets it. Races at a minute boundary can lose a
+// count, which is fine for a rate metric.
+
+enum CallKind { CALL_INFO = 0, CALL_EXCHANGE = 1, CALL_OTHER = 2, CALL_KIND_COUNT = 3 };
+
+static const int METRIC_MINUTES = 60;
+static std::atomic<long long> s_callTotals[CALL_KIND_COUNT];
+static std::atomic<DWORD> s_bucketMinute[METRIC_MINUTES];
+static std::atomic<int> s_bucketCalls[METRIC_MINUTES][CALL_KIND_COUNT];
+
+static void countCall(CallKind kind) {
+    DWORD minute = GetTickCount() / 60000 + 1;   // 0 = bucket never used
+    int b = (int)(minute % METRIC_MINUTES);
+    DWORD seen = s_bucketMinute[b].load();
+    if (seen != minute && s_bucketMinute[b].compare_exchange_strong(seen, minute)) {
+        for (int k = 0; k < CALL_KIND_COUNT; k++) s_bucketCalls[b][k].store(0);
+    }
+    s_bucketCalls[b][kind]++;
+    s_callTotals[kind]++;
+}
+
+CallStats getCallStats() {
+    CallStats stats;
+    stats.infoTotal = s_callTotals[CALL_INFO].load();
+    stats.exchangeTotal = s_callTotals[CALL_EXCHANGE].load();
+    stats.otherTotal = s_callTotals[CALL_OTHER].load();
+
+    DWORD minute = GetTickCount() / 60000 + 1;
+    for (int b = 0; b < METRIC_MINUTES; b++) {
+        DWORD m = s_bucketMinute[b].load();
+        if (m == 0 || minute - m >= (DWORD)METRIC_MINUTES) continue;
+        stats.infoLastHour += s_bucketCalls[b][CALL_INFO].load();
+        stats.exchangeLastHour += s_bucketCalls[b][CALL_EXCHANGE].load();
+        stats.otherLastHour += s_bucketCalls[b][CALL_OTHER].load();
+    }
+    return stats;
+}
+
 // =============================================================================
 // URL HELPERS
 // =============================================================================
@@ -148,28 +195,31 @@ enum HttpResultCode {
 // that have C++ objects requiring destructors (like std::string)
 static HttpResultCode sendHttpRaw(const char* fullUrl, const char* body,
                                    const char* method, char* buffer,
-                                   size_t bufferSize, size_t* outResultSize) {
+                                   size_t bufferSize, size_t* outResultSize,
+                                   uint64_t* outSentTicks) {
     *outResultSize = 0;
+    *outSentTicks = 0;
 
     // Send request with exception handling (Zorro functions can throw SEH exceptions)
     int requestId = 0;
-    __try {
+    HL_SEH_TRY {
         requestId = http_request(fullUrl, body ? body : nullptr, HTTP_HEADERS, method);
-    } __except(EXCEPTION_EXECUTE_HANDLER) {
+    } HL_SEH_EXCEPT {
         requestId = 0;
     }
 
     if (!requestId) {
         return HTTP_REQUEST_FAILED;
     }
+    *outSentTicks = lat::now();
 
     // Wait for response (~30 second timeout with 10ms intervals)
     int waitCount = 3000;
     int size = 0;
     while (waitCount > 0) {
-        __try {
+        HL_SEH_TRY {
             size = http_status(requestId);
-        } __except(EXCEPTION_EXECUTE_HANDLER) {
+        } HL_SEH_EXCEPT {
             size = 0;
         }
 
@@ -177,15 +227,15 @@ static HttpResultCode sendHttpRaw(const char* fullUrl, const char* body,
 
         // Non-blocking sleep (allows Zorro message processing)
         int napResult = 0;
-        __try {
+        HL_SEH_TRY {
             napResult = nap(10);
-        } __except(EXCEPTION_EXECUTE_HANDLER) {
+        } HL_SEH_EXCEPT {
             napResult = 0;
         }
 
         if (!napResult) {
             // nap returned false - abort requested
-            __try { http_free(requestId); } __except(EXCEPTION_EXECUTE_HANDLER) {}
+            HL_SEH_TRY { http_free(requestId); } HL_SEH_EXCEPT {}
             return HTTP_ABORTED;
         }
 
@@ -193,20 +243,20 @@ static HttpResultCode sendHttpRaw(const char* fullUrl, const char* body,
     }
 
     if (size == 0) {
-        __try { http_free(requestId); } __except(EXCEPTION_EXECUTE_HANDLER) {}
+        HL_SEH_TRY { http_free(requestId); } HL_SEH_EXCEPT {}
         return HTTP_TIMEOUT;
     }
 
     // Get response body
     size_t resultSize = 0;
-    __try {
+    HL_SEH_TRY {
         resultSize = http_result(requestId, buffer, bufferSize);
-    } __except(EXCEPTION_EXECUTE_HANDLER) {
+    } HL_SEH_EXCEPT {
         resultSize = 0;
     }
 
     // Free request resources
-    __try { http_free(requestId); } __except(EXCEPTION_EXECUTE_HANDLER) {}
+    HL_SEH_TRY { http_free(requestId); } HL_SEH_EXCEPT {}
 
     if (resultSize == 0) {
         return HTTP_EMPTY_RESPONSE;
@@ -219,12 +269,23 @@ static HttpResultCode sendHttpRaw(const char* fullUrl, const char* body,
     return HTTP_OK;
 }
 
+static std::atomic<Responder> s_responder(nullptr);
+
+void setResponder(Responder fn) {
+    s_responder.store(fn);
+}
+
 // High-level HTTP send that returns a Response struct
+// timeExchange: record the Send/Ack latency stages (/exchange posts)
 static Response sendHttpInternal(const char* fullUrl, const char* body,
-                                  const char* method, bool useSmallBuffer) {
+                                  const char* method, bool useSmallBuffer,
+                                  bool timeExchange = false) {
     Response resp;
     resp.statusCode = 0;
 
+    Responder responder = s_responder.load(std::memory_order_relaxed);
+    if (responder && responder(method, fullUrl, body, resp)) return resp;
+
     // Select buffer
     char* buffer = useSmallBuffer ? s_smallBuffer : s_largeBuffer;
     size_t bufferSize = useSmallBuffer ? sizeof(s_smallBuffer) : sizeof(s_largeBuffer);
@@ -236,7 +297,24 @@ static Response sendHttpInternal(const char* fullUrl, const char* body,
 
     // Call the low-level function (which has SEH handling)
     size_t resultSize = 0;
-    HttpResultCode result = sendHttpRaw(fullUrl, body, method, buffer, bufferSize, &resultSize);
+    uint64_t sentTicks = 0;
+    uint8_t captureId = 0;
+    if (capture::active()) {
+        captureId = capture::nextHttpId();
+        capture::recordHttpRequest(captureId, method, fullUrl, body);
+    }
+    HL_LAT_BEGIN(sendStart);
+    HttpResultCode result = sendHttpRaw(fullUrl, body, method, buffer, bufferSize,
+                                        &resultSize, &sentTicks);
+    if (timeExchange && sentTicks) {
+        HL_LAT_SPAN(Send, sendStart, sentTicks);
+        if (result == HTTP_OK) HL_LAT_END(Ack, sentTicks);
+    }
+    if (captureId) {
+        bool ok = (result == HTTP_OK);
+        capture::record(capture::Kind::HttpResponse, captureId, ok ? 200 : 0,
+                        buffer, ok ? strlen(buffer) : 0);
+    }
 
     // Handle result
     switch (result) {
@@ -293,16 +371,19 @@ static Response sendHttpInternal(const char* fullUrl, const char* body,
 // =============================================================================
 
 Response post(const char* url, const char* jsonBody, bool useSmallBuffer) {
+    countCall(CALL_OTHER);
     return sendHttpInternal(url, jsonBody, "POST", useSmallBuffer);
 }
 
 Response get(const char* url, bool useSmallBuffer) {
+    countCall(CALL_OTHER);
     return sendHttpInternal(url, nullptr, "GET", useSmallBuffer);
 }
 
 Response infoPost(const char* jsonBody, bool useSmallBuffer) {
     char url[512];
     buildUrl("/info", url, sizeof(url));
+    countCall(CALL_INFO);
     return sendHttpInternal(url, jsonBody, "POST", useSmallBuffer);
 }
 
@@ -321,7 +402,15 @@ Response infoPostPerpDex(const char* jsonBody, const char* perpDex, bool useSmal
 Response exchangePost(const char* jsonBody) {
     char url[512];
     buildUrl("/exchange", url, sizeof(url));
-    return sendHttpInternal(url, jsonBody, "POST", false);  // Always use large buffer
+    countCall(CALL_EXCHANGE);
+    trace::Span span("POST /exchange", "http");     // Nested in the caller's placeOrder span
+    Response resp = sendHttpInternal(url, jsonBody, "POST", false, true);  // Always use large buffer
+    if (span.active()) {
+        char detail[32];
+        sprintf_s(detail, "HTTP %d", resp.statusCode);
+        span.setDetail(detail);
+    }
+    return resp;
 }
 
 } // namespace http
@@ -71,6 +71,37 @@ Response infoPostPerpDex(const char* jsonBody, const char* perpDex, bool useSmal
 /// @return Response from exchange endpoint
 Response exchangePost(const char* jsonBody);
 
+// =============================================================================
+// CALL METRICS
+// =============================================================================
+
+/// Requests issued through this module (attempts, including failures).
+/// "Last hour" is a rolling window of one-minute buckets.
+struct CallStats {
+    long long infoTotal = 0;        // /info since load
+    long long exchangeTotal = 0;    // /exchange since load
+    long long otherTotal = 0;       // post()/get() with explicit URLs
+    int infoLastHour = 0;
+    int exchangeLastHour = 0;
+    int otherLastHour = 0;
+
+    int lastHour() const { return infoLastHour + exchangeLastHour + otherLastHour; }
+};
+
+/// Snapshot of the call counters (thread-safe)
+CallStats getCallStats();
+
+// =============================================================================
+// REPLAY
+// =============================================================================
+
+/// Answers a request instead of Zorro's HTTP (offline capture replay, see
+/// hl_capture.h). Return false to send the request for real.
+typedef bool (*Responder)(const char* method, const char* url, const char* body, Response& out);
+
+/// Install (nullptr = remove) the responder for every request
+void setResponder(Responder fn);
+
 // =============================================================================
 // URL HELPERS
 // =============================================================================
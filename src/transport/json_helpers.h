@@ -4,7 +4,7 @@
 // Part of Hyperliquid Plugin for Zorro
 //
 // LAYER: Transport
-// DEPENDENCIES: yyjson.h
+// DEPENDENCIES: yyjson.h, json_pool.h, hl_decimal.h
 // THREAD SAFETY: Stateless functions, safe to call from any thread
 //
 // Handles HL's quirk of encoding numbers as JSON strings:
@@ -14,6 +14,9 @@
 #pragma once
 
 #include "yyjson.h"
+#include "json_pool.h"
+#include "../foundation/hl_decimal.h"
+#include "../foundation/hl_platform.h"
 #include <cstdlib>
 #include <cstring>
 
@@ -27,7 +30,7 @@ inline double getDouble(yyjson_val* obj, const char* key) {
     yyjson_val* item = yyjson_obj_get(obj, key);
     if (!item) return 0.0;
     if (yyjson_is_num(item)) return yyjson_get_real(item);
-    if (yyjson_is_str(item)) return atof(yyjson_get_str(item));
+    if (yyjson_is_str(item)) return decimal::parse(yyjson_get_str(item));
     return 0.0;
 }
 
@@ -81,7 +84,7 @@ inline bool isNull(yyjson_val* item) {
 inline double valToDouble(yyjson_val* item) {
     if (!item) return 0.0;
     if (yyjson_is_num(item)) return yyjson_get_real(item);
-    if (yyjson_is_str(item)) return atof(yyjson_get_str(item));
+    if (yyjson_is_str(item)) return decimal::parse(yyjson_get_str(item));
     return 0.0;
 }
 
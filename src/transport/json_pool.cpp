@@ -0,0 +1,129 @@
+//=============================================================================
+// json_pool.cpp - Per-thread reusable yyjson allocator
+//=============================================================================
+// Part of Hyperliquid Plugin for Zorro
+//
+// LAYER: Transport
+//=============================================================================
+
+#include "json_pool.h"
+#include "../foundation/hl_config.h"
+#include <atomic>
+#include <cstdlib>
+
+namespace hl {
+namespace json {
+
+static std::atomic<long long> s_pooled(0);
+static std::atomic<long long> s_heap(0);
+static std::atomic<long long> s_grows(0);
+static std::atomic<long long> s_bytes(0);
+
+namespace {
+
+struct ThreadPool {
+    char* buf = nullptr;
+    size_t cap = 0;
+    size_t want = 0;        // Grow to this once no document is alive
+    int live = 0;           // Blocks handed out to documents
+    yyjson_alc pool;        // yyjson pool allocator over buf
+    yyjson_alc counted;     // Carried by documents: counts blocks, forwards to pool
+
+    ThreadPool();
+    ~ThreadPool();
+};
+
+void* countedMalloc(void* ctx, size_t size) {
+    ThreadPool* t = static_cast<ThreadPool*>(ctx);
+    void* p = t->pool.malloc(t->pool.ctx, size);
+    if (p) t->live++;
+    return p;
+}
+
+void* countedRealloc(void* ctx, void* ptr, size_t oldSize, size_t size) {
+    ThreadPool* t = static_cast<ThreadPool*>(ctx);
+    void* p = t->pool.realloc(t->pool.ctx, ptr, oldSize, size);
+    if (p && !ptr) t->live++;
+    return p;
+}
+
+void countedFree(void* ctx, void* ptr) {
+    ThreadPool* t = static_cast<ThreadPool*>(ctx);
+    if (!ptr) return;
+    t->live--;
+    t->pool.free(t->pool.ctx, ptr);
+}
+
+ThreadPool::ThreadPool() {
+    yyjson_alc_pool_init(&pool, nullptr, 0);    // Empty until the first parse
+    counted.malloc = countedMalloc;
+    counted.realloc = countedRealloc;
+    counted.free = countedFree;
+    counted.ctx = this;
+}
+
+ThreadPool::~ThreadPool() {
+    free(buf);
+    s_bytes -= (long long)cap;
+}
+
+thread_local ThreadPool t_pool;
+
+// Caller ensures no document of this pool is alive
+void growPool(ThreadPool& t, size_t target) {
+    const size_t maxBytes = (size_t)config::JSON_POOL_MAX_BYTES;
+    size_t size = t.cap ? t.cap : (size_t)config::JSON_POOL_INITIAL_BYTES;
+    while (size < target && size < maxBytes) size *= 2;
+    if (size > maxBytes) size = maxBytes;
+    if (size <= t.cap) return;
+
+    char* fresh = static_cast<char*>(malloc(size));
+    if (!fresh) return;
+    free(t.buf);
+    s_bytes += (long long)size - (long long)t.cap;
+    s_grows++;
+    t.buf = fresh;
+    t.cap = size;
+    yyjson_alc_pool_init(&t.pool, t.buf, t.cap);
+}
+
+} // namespace
+
+yyjson_doc* parse(const char* data, size_t len) {
+    if (!data) return nullptr;
+    ThreadPool& t = t_pool;
+    size_t need = yyjson_read_max_memory_usage(len, 0);
+
+    if (need <= (size_t)config::JSON_POOL_MAX_BYTES) {
+        if (t.live == 0) {
+            size_t target = need > t.want ? need : t.want;
+            if (target > t.cap) growPool(t, target);
+        }
+        if (t.cap) {
+            yyjson_read_err err;
+            yyjson_doc* doc = yyjson_read_opts(const_cast<char*>(data), len, 0, &t.counted, &err);
+            if (doc) {
+                s_pooled++;
+                return doc;
+            }
+            if (err.code != YYJSON_READ_ERROR_MEMORY_ALLOCATION) return nullptr;
+            // Shared with a live document (nested parse): room for both next time
+            if (t.cap + need > t.want) t.want = t.cap + need;
+        }
+    }
+
+    s_heap++;
+    return yyjson_read(data, len, 0);
+}
+
+PoolStats getPoolStats() {
+    PoolStats st;
+    st.pooled = s_pooled.load();
+    st.heap = s_heap.load();
+    st.grows = s_grows.load();
+    st.bytesReserved = s_bytes.load();
+    return st;
+}
+
+} // namespace json
+} // namespace hl
@@ -0,0 +1,47 @@
+//=============================================================================
+// json_pool.h - Per-thread reusable yyjson allocator for all document parses
+//=============================================================================
+// Part of Hyperliquid Plugin for Zorro
+//
+// LAYER: Transport
+// DEPENDENCIES: yyjson.h, hl_config.h
+// THREAD SAFETY: parse() uses the calling thread's own pool; stats are atomic
+//
+// yyjson_read() mallocs a whole DOM per document and frees it again, once
+// per WS frame. json::parse() reads into a yyjson pool allocator owned by
+// the calling thread instead (WS connection threads, Zorro thread). The
+// pool starts at JSON_POOL_INITIAL_BYTES and grows to fit the largest
+// document seen (yyjson_read_max_memory_usage), but only while none of its
+// documents are alive. Nested parses share the pool; if one does not fit,
+// it is read from the heap once and the pool grows before the next parse.
+// Documents above JSON_POOL_MAX_BYTES always use the heap.
+//
+// Free documents with yyjson_doc_free() as usual — the memory goes back to
+// the pool it came from. A document must be freed on the thread that
+// parsed it.
+//=============================================================================
+
+#pragma once
+
+#include "yyjson.h"
+#include <cstddef>
+
+namespace hl {
+namespace json {
+
+/// Parse `len` bytes of JSON with this thread's pool (nullptr if invalid)
+yyjson_doc* parse(const char* data, size_t len);
+
+/// Process-wide counters (all threads)
+struct PoolStats {
+    long long pooled = 0;        // Documents read from a pool
+    long long heap = 0;          // Documents read with malloc (too big / pool busy)
+    long long grows = 0;         // Pool (re)allocations
+    long long bytesReserved = 0; // Current size of all pools
+};
+
+/// In steady state only `pooled` moves: heap and grows stay constant
+PoolStats getPoolStats();
+
+} // namespace json
+} // namespace hl
@@ -17,7 +17,6 @@
 #include <IXNetSystem.h>
 #include <IXSocketTLSOptions.h>
 #include <cstdio>
-#include <cstdarg>
 
 namespace hl {
 namespace ws {
@@ -32,7 +31,7 @@ Connection::Connection()
       connected_(false), state_(ConnectionState::Disconnected),
       lastMessageTime_(0), lastError_(0),
       disconnectReason_(DisconnectReason::None), disconnectError_(0),
-      messageHandler_(nullptr), logCallback_(nullptr), logLevel_(0) {
+      messageHandler_(nullptr), logCallback_(nullptr), logLevel_(0), captureId_(0) {
     InitializeCriticalSection(&queueCs_);
     queueEvent_ = CreateEvent(NULL, TRUE, FALSE, NULL);  // Manual-reset
     ws_.disableAutomaticReconnection();
@@ -58,18 +57,7 @@ void Connection::setLogCallback(LogCallback cb, int level) {
 
 void Connection::log(int minLevel, const char* msg) {
     if (logCallback_ && logLevel_ >= minLevel) {
-        logCallback_(msg);
-    }
-}
-
-void Connection::logf(int minLevel, const char* fmt, ...) {
-    if (logCallback_ && logLevel_ >= minLevel) {
-        char buf[512];
-        va_list args;
-        va_start(args, fmt);
-        vsnprintf(buf, sizeof(buf), fmt, args);
-        va_end(args);
-        logCallback_(buf);
+        logText(logCallback_, msg);
     }
 }
 
@@ -124,6 +112,7 @@ void Connection::onIxMessage(const ix::WebSocketMessagePtr& msg) {
                 log(1, "WS: Auto-reconnected");
             }
             hasConnectedOnce_ = true;
+            if (capture::active()) capture::record(capture::Kind::WsOpen, captureId_, 0, nullptr, 0);
             // Signal queueEvent_ so connect() or poll() can stop waiting
             SetEvent(queueEvent_);
             break;
@@ -138,6 +127,9 @@ void Connection::onIxMessage(const ix::WebSocketMessagePtr& msg) {
                 disconnectReason_ = DisconnectReason::ServerClose;
             }
             disconnectError_ = static_cast<DWORD>(msg->closeInfo.code);
+            if (capture::active())
+                capture::record(capture::Kind::WsClose, captureId_, (uint16_t)msg->closeInfo.code,
+                                msg->closeInfo.reason.data(), msg->closeInfo.reason.size());
             connected_ = false;
             state_ = ConnectionState::Disconnected;
             // With auto-reconnect, IXWebSocket will retry — don't signal permanent disconnect [OPM-128]
@@ -156,6 +148,9 @@ void Connection::onIxMessage(const ix::WebSocketMessagePtr& msg) {
             disconnectReason_ = DisconnectReason::NetworkError;
             disconnectError_ = static_cast<DWORD>(msg->errorInfo.http_status);
             lastError_ = disconnectError_;
+            if (capture::active())
+                capture::record(capture::Kind::WsClose, captureId_, (uint16_t)msg->errorInfo.http_status,
+                                msg->errorInfo.reason.data(), msg->errorInfo.reason.size());
             connected_ = false;
             state_ = ConnectionState::Disconnected;
             // With auto-reconnect, IXWebSocket will retry — don't signal permanent disconnect [OPM-128]
@@ -168,8 +163,10 @@ void Connection::onIxMessage(const ix::WebSocketMessagePtr& msg) {
         case ix::WebSocketMessageType::Message:
             // Queue the message for poll() to dispatch on caller's thread
             if (!msg->str.empty()) {
+                if (capture::active())
+                    capture::record(capture::Kind::WsRecv, captureId_, 0, msg->str.data(), msg->str.size());
                 EnterCriticalSection(&queueCs_);
-                messageQueue_.push({msg->str});
+                messageQueue_.push({msg->str, HL_LAT_NOW()});
                 LeaveCriticalSection(&queueCs_);
                 SetEvent(queueEvent_);
             }
@@ -312,6 +309,7 @@ bool Connection::send(const char* message, size_t len) {
         return false;
     }
 
+    if (capture::active()) capture::record(capture::Kind::WsSend, captureId_, 0, message, len);
     return true;
 }
 
@@ -355,6 +353,7 @@ int Connection::poll(int timeoutMs) {
         LeaveCriticalSection(&queueCs_);
 
         lastMessageTime_ = time(NULL);
+        if (msg.arrivedTicks) HL_LAT_END(WsReceive, msg.arrivedTicks);
         if (messageHandler_) {
             messageHandler_(msg.data.c_str(), msg.data.size());
         }
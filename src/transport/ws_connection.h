@@ -4,7 +4,7 @@
 // Part of Hyperliquid Plugin for Zorro
 //
 // LAYER: Transport
-// DEPENDENCIES: ws_types.h, IXWebSocket
+// DEPENDENCIES: ws_types.h, hl_log_ring.h, hl_capture.h, IXWebSocket
 // THREAD SAFETY: connect/disconnect are NOT thread-safe. send() can be called
 //                from any thread while connected. poll() must be called from
 //                a single thread (typically the connection thread).
@@ -18,6 +18,9 @@
 #pragma once
 
 #include "ws_types.h"
+#include "../foundation/hl_log_ring.h"
+#include "../foundation/hl_latency.h"
+#include "hl_capture.h"
 #include <IXWebSocket.h>
 #include <functional>
 #include <string>
@@ -114,6 +117,9 @@ public:
     /// Caller should re-subscribe channels when this returns true. [OPM-128]
     bool wasReconnected();
 
+    /// Channel of this connection's frames in a traffic capture (hl_capture.h)
+    void setCaptureId(int id) { captureId_ = (uint8_t)id; }
+
     /// Debug: force-close the underlying socket (simulates server drop).
     /// Auto-reconnect stays active, so IXWebSocket will reconnect. [OPM-170]
     void forceCloseForTest();
@@ -126,6 +132,7 @@ private:
     // drained by poll() on the caller's thread)
     struct QueuedMessage {
         std::string data;
+        uint64_t arrivedTicks;      // HL_LAT_NOW() on the callback thread
     };
     CRITICAL_SECTION queueCs_;
     std::queue<QueuedMessage> messageQueue_;
@@ -151,12 +158,16 @@ private:
     MessageHandler messageHandler_;
     LogCallback logCallback_;
     int logLevel_;
+    uint8_t captureId_;
 
     // IXWebSocket message callback (fires on IX internal thread)
     void onIxMessage(const ix::WebSocketMessagePtr& msg);
 
     void log(int minLevel, const char* msg);
-    void logf(int minLevel, const char* fmt, ...);
+    template <class... A>
+    void logf(int minLevel, const char* fmt, const A&... args) {
+        if (logCallback_ && logLevel_ >= minLevel) logPrintf(logCallback_, fmt, args...);
+    }
 };
 
 } // namespace ws
@@ -0,0 +1,191 @@
+//=============================================================================
+// ws_fill_aggregator.cpp - Incremental per-order fill totals from userFills
+//=============================================================================
+// Part of Hyperliquid Plugin for Zorro
+//
+// LAYER: Transport
+//=============================================================================
+
+#include "ws_fill_aggregator.h"
+#include <cstdio>
+
+namespace hl {
+namespace ws {
+
+FillAggregator::FillAggregator(size_t retiredMemory)
+    : retiredMemory_(retiredMemory), duplicates_(0) {
+    InitializeCriticalSection(&cs_);
+}
+
+FillAggregator::~FillAggregator() {
+    DeleteCriticalSection(&cs_);
+}
+
+bool FillAggregator::addFill(const FillData& fill, DWORD now) {
+    if (fill.oid.empty() || fill.sz <= 0.0) return false;
+
+    // Fills without a tid (should not happen on Hyperliquid) get a synthetic
+    // key so a replayed frame still dedups
+    std::string tid = fill.tid;
+    if (tid.empty()) {
+        char buf[96];
+        snprintf(buf, sizeof(buf), "%lld/%.10g/%.10g", fill.time, fill.px, fill.sz);
+        tid = buf;
+    }
+
+    EnterCriticalSection(&cs_);
+    if (retired_.count(fill.oid)) {
+        duplicates_++;
+        LeaveCriticalSection(&cs_);
+        return false;
+    }
+
+    // A parked order forgot its tids: anything not newer than its last
+    // applied fill is a replay
+    auto oit = orders_.find(fill.oid);
+    if (oit == orders_.end()) {
+        oit = orders_.emplace(fill.oid, Order()).first;
+        oit->second.closed = closed_.erase(fill.oid) > 0;  // Fill after the cancel
+    }
+    Order& order = oit->second;
+    if ((order.parkedAt > 0 && fill.time > 0 && fill.time <= order.parkedAt) ||
+        !order.tids.insert(tid).second) {
+        duplicates_++;
+        LeaveCriticalSection(&cs_);
+        return false;
+    }
+    if (fill.time > order.lastTime) order.lastTime = fill.time;
+
+    OrderFillTotals& t = order.totals;
+    if (t.oid.empty()) t.oid = fill.oid;
+    t.filledSz += fill.sz;
+    t.notional += fill.sz * fill.px;
+    t.fees += fill.fee;
+    t.fills++;
+    t.lastFillAt = now;
+
+    if (!order.changed) {
+        order.changed = true;
+        changed_.push_back(fill.oid);
+    }
+    LeaveCriticalSection(&cs_);
+    return true;
+}
+
+std::vector<OrderFillTotals> FillAggregator::takeChanged() {
+    std::vector<OrderFillTotals> result;
+    EnterCriticalSection(&cs_);
+    result.reserve(changed_.size());
+    for (const auto& oid : changed_) {
+        auto it = orders_.find(oid);
+        if (it == orders_.end()) continue;  // Retired in between
+        it->second.changed = false;
+        result.push_back(it->second.totals);
+    }
+    changed_.clear();
+    LeaveCriticalSection(&cs_);
+    return result;
+}
+
+bool FillAggregator::getTotals(const std::string& oid, OrderFillTotals& out) const {
+    EnterCriticalSection(&cs_);
+    auto it = orders_.find(oid);
+    bool found = it != orders_.end();
+    if (found) out = it->second.totals;
+    LeaveCriticalSection(&cs_);
+    return found;
+}
+
+// Caller holds cs_
+void FillAggregator::retireLocked(const std::string& oid) {
+    orders_.erase(oid);
+    if (retiredMemory_ == 0 || !retired_.insert(oid).second) return;
+    retiredOrder_.push_back(oid);
+    if (retiredOrder_.size() > retiredMemory_) {
+        retired_.erase(retiredOrder_.front());
+        retiredOrder_.pop_front();
+    }
+}
+
+void FillAggregator::retire(const std::string& oid) {
+    if (oid.empty()) return;
+    EnterCriticalSection(&cs_);
+    retireLocked(oid);
+    LeaveCriticalSection(&cs_);
+}
+
+void FillAggregator::close(const std::string& oid) {
+    if (oid.empty()) return;
+    EnterCriticalSection(&cs_);
+    auto it = orders_.find(oid);
+    if (it != orders_.end()) {
+        it->second.closed = true;
+    } else if (!retired_.count(oid) && retiredMemory_ > 0 && closed_.insert(oid).second) {
+        closedOrder_.push_back(oid);
+        if (closedOrder_.size() > retiredMemory_) {
+            closed_.erase(closedOrder_.front());
+            closedOrder_.pop_front();
+        }
+    }
+    LeaveCriticalSection(&cs_);
+}
+
+int FillAggregator::retireIdle(DWORD now, DWORD idleMs) {
+    int swept = 0;
+    EnterCriticalSection(&cs_);
+    for (auto it = orders_.begin(); it != orders_.end(); ) {
+        Order& o = it->second;
+        if (o.changed || now - o.totals.lastFillAt < idleMs ||
+            (!o.closed && o.tids.empty())) {
+            ++it;
+            continue;
+        }
+        swept++;
+        if (o.closed) {
+            // No more fills expected: forget it, and ignore stray replays
+            std::string oid = it->first;
+            ++it;
+            retireLocked(oid);
+            continue;
+        }
+        // Keep the totals (a resting order may fill again much later and the
+        // trade map only accepts a growing cumulative size); drop the tids
+        std::unordered_set<std::string>().swap(o.tids);
+        o.parkedAt = o.lastTime;
+        ++it;
+    }
+    LeaveCriticalSection(&cs_);
+    return swept;
+}
+
+void FillAggregator::clear() {
+    EnterCriticalSection(&cs_);
+    orders_.clear();
+    changed_.clear();
+    retired_.clear();
+    retiredOrder_.clear();
+    closed_.clear();
+    closedOrder_.clear();
+    duplicates_ = 0;
+    LeaveCriticalSection(&cs_);
+}
+
+size_t FillAggregator::activeOrders() const {
+    EnterCriticalSection(&cs_);
+    size_t n = 0;
+    for (const auto& kv : orders_) {
+        if (!kv.second.tids.empty()) n++;
+    }
+    LeaveCriticalSection(&cs_);
+    return n;
+}
+
+long long FillAggregator::duplicatesDropped() const {
+    EnterCriticalSection(&cs_);
+    long long n = duplicates_;
+    LeaveCriticalSection(&cs_);
+    return n;
+}
+
+} // namespace ws
+} // namespace hl
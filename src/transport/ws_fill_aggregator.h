@@ -0,0 +1,115 @@
+//=============================================================================
+// ws_fill_aggregator.h - Incremental per-order fill totals from userFills
+//=============================================================================
+// Part of Hyperliquid Plugin for Zorro
+//
+// LAYER: Transport
+// DEPENDENCIES: ws_types.h
+// THREAD SAFETY: All public methods are thread-safe (internal lock)
+//
+// Replaces re-summing the last 100 cached fills on every userFills frame
+// [OPM-87]. Each fill is applied once:
+//   - Deduplicated by tid (snapshot replays, standby copies)
+//   - Cumulative size and notional per oid updated in O(1) -> VWAP
+//   - Changed oids are collected and handed out once via takeChanged()
+//   - Completed orders are retired (retire); late fills for a retired oid
+//     are ignored instead of restarting its totals at zero
+//   - Orders idle for a while are parked (retireIdle): the tid set is freed,
+//     the totals stay, and a later fill continues from them. Replays of
+//     fills applied before parking are recognised by exchange time
+//   - Cancelled/rejected orders are closed (close): fills still in flight
+//     are applied, and the idle sweep retires them instead of parking
+//=============================================================================
+
+#pragma once
+
+#include "ws_types.h"
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace hl {
+namespace ws {
+
+/// Cumulative fill state of one order
+struct OrderFillTotals {
+    std::string oid;
+    double filledSz = 0.0;
+    double notional = 0.0;      // Sum of px * sz
+    double fees = 0.0;
+    int fills = 0;
+    DWORD lastFillAt = 0;       // GetTickCount() of the last applied fill
+
+    double avgPx() const { return filledSz > 0.0 ? notional / filledSz : 0.0; }
+};
+
+class FillAggregator {
+public:
+    /// @param retiredMemory How many retired oids to remember (late-fill guard)
+    explicit FillAggregator(size_t retiredMemory = 4096);
+    ~FillAggregator();
+
+    FillAggregator(const FillAggregator&) = delete;
+    FillAggregator& operator=(const FillAggregator&) = delete;
+
+    /// Apply one fill. @return false if duplicate (tid seen) or oid retired
+    bool addFill(const FillData& fill, DWORD now);
+
+    /// Totals of every oid changed since the last call (each oid once)
+    std::vector<OrderFillTotals> takeChanged();
+
+    /// Totals for one order. @return false if not tracked
+    bool getTotals(const std::string& oid, OrderFillTotals& out) const;
+
+    /// Order is complete — drop its totals and tids, ignore later fills
+    void retire(const std::string& oid);
+
+    /// Order ended without filling completely (cancelled, rejected). Fills
+    /// may still arrive on userFills after the status, so nothing is dropped
+    /// here; the idle sweep retires the order once idleMs pass without one.
+    void close(const std::string& oid);
+
+    /// Orders without a fill for idleMs: closed ones are retired, open ones
+    /// parked (tids freed, totals kept, newer fills still accepted).
+    /// @return number parked or retired
+    int retireIdle(DWORD now, DWORD idleMs);
+
+    void clear();
+
+    /// Orders holding a tid set (parked ones excluded)
+    size_t activeOrders() const;
+    long long duplicatesDropped() const;
+
+private:
+    struct Order {
+        OrderFillTotals totals;
+        std::unordered_set<std::string> tids;
+        long long lastTime = 0;     // Exchange time (ms) of the newest applied fill
+        long long parkedAt = 0;     // lastTime when parked; 0 = not parked
+        bool changed = false;
+        bool closed = false;        // Cancelled/rejected — retire when idle
+    };
+
+    mutable CRITICAL_SECTION cs_;
+    std::unordered_map<std::string, Order> orders_;
+    std::vector<std::string> changed_;
+
+    // Bounded memory of retired oids (FIFO)
+    std::unordered_set<std::string> retired_;
+    std::deque<std::string> retiredOrder_;
+    size_t retiredMemory_;
+
+    // Closed oids with no fill yet (a fill may still follow the status);
+    // same bound as the retired memory
+    std::unordered_set<std::string> closed_;
+    std::deque<std::string> closedOrder_;
+
+    long long duplicates_;
+
+    void retireLocked(const std::string& oid);
+};
+
+} // namespace ws
+} // namespace hl
@@ -0,0 +1,195 @@
+//=============================================================================
+// ws_fill_ring.cpp - Fixed-capacity fill store with per-order index
+//=============================================================================
+// Part of Hyperliquid Plugin for Zorro
+//
+// LAYER: Transport
+//=============================================================================
+
+#include "ws_fill_ring.h"
+#include <cstring>
+
+namespace hl {
+namespace ws {
+
+FillRing::FillRing(size_t capacity)
+    : head_(0), size_(0), mask_(0) {
+    setCapacity(capacity);
+}
+
+uint32_t FillRing::hashId(const char* id) {
+    // FNV-1a
+    uint32_t h = 2166136261u;
+    for (const char* p = id; *p; ++p) {
+        h ^= (unsigned char)*p;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+void FillRing::copyId(char* dst, const std::string& src) {
+    size_t n = src.size() < ID_LEN - 1 ? src.size() : ID_LEN - 1;
+    memcpy(dst, src.data(), n);
+    dst[n] = 0;
+}
+
+void FillRing::setCapacity(size_t capacity) {
+    if (capacity == 0) capacity = 1;
+
+    // Keep the newest fills that fit
+    std::vector<FillData> keep = recent((int)(size_ < capacity ? size_ : capacity));
+
+    slots_.assign(capacity, Slot());
+    size_t tableSize = 1;
+    while (tableSize < capacity * 2) tableSize <<= 1;
+    index_.assign(tableSize, IndexEntry());
+    mask_ = tableSize - 1;
+    head_ = 0;
+    size_ = 0;
+
+    for (const auto& f : keep) add(f);
+}
+
+void FillRing::clear() {
+    head_ = 0;
+    size_ = 0;
+    for (auto& e : index_) e.used = false;
+}
+
+size_t FillRing::findEntry(const char* oid, uint32_t hash) const {
+    size_t i = hash & mask_;
+    while (index_[i].used) {
+        if (index_[i].hash == hash && strcmp(index_[i].oid, oid) == 0) return i;
+        i = (i + 1) & mask_;
+    }
+    return NONE;
+}
+
+// Linear-probing delete without tombstones: shift later entries of the
+// probe run back into the hole when their home bucket allows it
+void FillRing::eraseEntry(size_t pos) {
+    size_t i = pos;
+    size_t j = pos;
+    for (;;) {
+        j = (j + 1) & mask_;
+        if (!index_[j].used) break;
+        size_t home = index_[j].hash & mask_;
+        bool stays = (i <= j) ? (i < home && home <= j) : (i < home || home <= j);
+        if (!stays) {
+            index_[i] = index_[j];
+            i = j;
+        }
+    }
+    index_[i].used = false;
+}
+
+void FillRing::evictOldest() {
+    Slot& old = slots_[head_];
+    size_t e = findEntry(old.oid, hashId(old.oid));
+    if (e != NONE) {
+        // The ring evicts in insertion order, so this is the chain head
+        IndexEntry& entry = index_[e];
+        entry.head = old.next;
+        if (--entry.count <= 0) eraseEntry(e);
+    }
+    head_ = (head_ + 1) % slots_.size();
+    size_--;
+}
+
+void FillRing::add(const FillData& fill) {
+    if (size_ == slots_.size()) evictOldest();
+
+    uint32_t pos = (uint32_t)((head_ + size_) % slots_.size());
+    Slot& s = slots_[pos];
+    copyId(s.oid, fill.oid);
+    copyId(s.tid, fill.tid);
+    s.next = NONE;
+    s.coin = (uint16_t)g_symbols.intern(fill.coin.c_str());
+    s.isBuy = fill.isBuy;
+    s.px = fill.px;
+    s.sz = fill.sz;
+    s.fee = fill.fee;
+    s.time = fill.time;
+    size_++;
+
+    uint32_t hash = hashId(s.oid);
+    size_t e = findEntry(s.oid, hash);
+    if (e == NONE) {
+        e = hash & mask_;
+        while (index_[e].used) e = (e + 1) & mask_;
+        IndexEntry& entry = index_[e];
+        memcpy(entry.oid, s.oid, ID_LEN);
+        entry.hash = hash;
+        entry.head = pos;
+        entry.tail = pos;
+        entry.count = 1;
+        entry.used = true;
+    } else {
+        IndexEntry& entry = index_[e];
+        slots_[entry.tail].next = pos;
+        entry.tail = pos;
+        entry.count++;
+    }
+}
+
+FillData FillRing::toFillData(const Slot& s) const {
+    FillData f;
+    f.oid = s.oid;
+    f.coin = g_symbols.name(s.coin);
+    f.isBuy = s.isBuy;
+    f.px = s.px;
+    f.sz = s.sz;
+    f.fee = s.fee;
+    f.time = s.time;
+    f.tid = s.tid;
+    return f;
+}
+
+std::vector<FillData> FillRing::recent(int count) const {
+    std::vector<FillData> result;
+    if (count <= 0 || size_ == 0) return result;
+    size_t n = (size_t)count < size_ ? (size_t)count : size_;
+    result.reserve(n);
+    for (size_t k = size_ - n; k < size_; k++)
+        result.push_back(toFillData(slots_[(head_ + k) % slots_.size()]));
+    return result;
+}
+
+std::vector<FillData> FillRing::forOrder(const std::string& oid) const {
+    std::vector<FillData> result;
+    char key[ID_LEN];
+    copyId(key, oid);
+    size_t e = findEntry(key, hashId(key));
+    if (e == NONE) return result;
+    result.reserve(index_[e].count);
+    for (uint32_t p = index_[e].head; p != NONE; p = slots_[p].next)
+        result.push_back(toFillData(slots_[p]));
+    return result;
+}
+
+int FillRing::countForOrder(const std::string& oid) const {
+    char key[ID_LEN];
+    copyId(key, oid);
+    size_t e = findEntry(key, hashId(key));
+    return e == NONE ? 0 : index_[e].count;
+}
+
+int FillRing::sumForOrder(const char* oid, double& size, double& notional) const {
+    size = notional = 0.0;
+    if (!oid) return 0;
+    char key[ID_LEN];
+    size_t n = strlen(oid);
+    if (n > ID_LEN - 1) n = ID_LEN - 1;
+    memcpy(key, oid, n);
+    key[n] = 0;
+    size_t e = findEntry(key, hashId(key));
+    if (e == NONE) return 0;
+    for (uint32_t p = index_[e].head; p != NONE; p = slots_[p].next) {
+        size += slots_[p].sz;
+        notional += slots_[p].px * slots_[p].sz;
+    }
+    return index_[e].count;
+}
+
+} // namespace ws
+} // namespace hl
@@ -0,0 +1,101 @@
+//=============================================================================
+// ws_fill_ring.h - Fixed-capacity fill store with per-order index
+//=============================================================================
+// Part of Hyperliquid Plugin for Zorro
+//
+// LAYER: Transport
+// DEPENDENCIES: ws_types.h, hl_symbols.h
+// THREAD SAFETY: NOT thread-safe — owner serializes access (PriceCache cs_)
+//
+// Replaces the std::vector<FillData> in PriceCache that erased from the
+// front once full and was scanned linearly by getFillsForOrder (called per
+// open trade from BrokerTrade):
+//   - Ring of preallocated slots; the oldest fill is overwritten when full
+//   - Slots hold fixed-size oid/tid keys and the coin's g_symbols id, so
+//     add() does not allocate (except the first time a coin is seen)
+//   - Open-addressing oid index -> chain of that order's slots (oldest
+//     first), so per-order lookups cost O(fills of that order)
+//=============================================================================
+
+#pragma once
+
+#include "ws_types.h"
+#include "../foundation/hl_symbols.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace hl {
+namespace ws {
+
+class FillRing {
+public:
+    static const size_t ID_LEN = 32;    // oid/tid incl. terminator (HL ids are <= 20 digits)
+
+    explicit FillRing(size_t capacity);
+
+    /// Resize, keeping the newest min(size, capacity) fills
+    void setCapacity(size_t capacity);
+    size_t capacity() const { return slots_.size(); }
+    size_t size() const { return size_; }
+
+    /// Append a fill, overwriting the oldest one when full
+    void add(const FillData& fill);
+
+    void clear();
+
+    /// Last `count` fills, oldest first
+    std::vector<FillData> recent(int count) const;
+
+    /// All stored fills of one order, oldest first
+    std::vector<FillData> forOrder(const std::string& oid) const;
+
+    /// Number of stored fills of one order
+    int countForOrder(const std::string& oid) const;
+
+    /// Size and px*size summed over one order's stored fills, no copies
+    /// @return number of fills summed
+    int sumForOrder(const char* oid, double& size, double& notional) const;
+
+private:
+    static const uint32_t NONE = 0xFFFFFFFFu;
+
+    struct Slot {
+        char oid[ID_LEN];
+        char tid[ID_LEN];
+        uint32_t next;          // Next (newer) slot of the same oid, NONE = last
+        uint16_t coin;          // g_symbols id
+        bool isBuy;
+        double px;
+        double sz;
+        double fee;
+        long long time;
+    };
+
+    struct IndexEntry {
+        char oid[ID_LEN];
+        uint32_t hash;
+        uint32_t head;          // Oldest slot of this oid
+        uint32_t tail;          // Newest slot of this oid
+        int count;
+        bool used;
+    };
+
+    std::vector<Slot> slots_;
+    size_t head_;               // Oldest slot
+    size_t size_;
+
+    std::vector<IndexEntry> index_;   // Power of two, >= 2x capacity
+    size_t mask_;
+
+    static uint32_t hashId(const char* id);
+    static void copyId(char* dst, const std::string& src);
+
+    size_t findEntry(const char* oid, uint32_t hash) const;  // NONE if absent
+    void eraseEntry(size_t pos);
+    void evictOldest();
+    FillData toFillData(const Slot& s) const;
+};
+
+} // namespace ws
+} // namespace hl
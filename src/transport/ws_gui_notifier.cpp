@@ -0,0 +1,93 @@
+//=============================================================================
+// ws_gui_notifier.cpp - Coalesced WM_APP+1 notifications implementation
+//=============================================================================
+// Part of Hyperliquid Plugin for Zorro
+//
+// LAYER: Transport
+// THREAD SAFETY: See ws_gui_notifier.h
+//=============================================================================
+
+#include "ws_gui_notifier.h"
+
+namespace hl {
+namespace ws {
+
+GuiNotifier::GuiNotifier()
+    : window_(NULL), minIntervalMs_(0), tradedOnly_(false),
+      pending_(false), dirty_(false), lastPost_(0),
+      updates_(0), filtered_(0), coalesced_(0), posted_(0), acks_(0), rearms_(0) {
+    for (int i = 0; i < config::SYMBOL_MAX_IDS; ++i) watchUntil_[i].store(0, std::memory_order_relaxed);
+}
+
+void GuiNotifier::watch(uint32_t coinId, DWORD forMs) {
+    if (!coinId || coinId >= (uint32_t)config::SYMBOL_MAX_IDS) return;
+    DWORD until = GetTickCount() + forMs;
+    watchUntil_[coinId].store(until ? until : 1, std::memory_order_relaxed);
+}
+
+bool GuiNotifier::isWatched(uint32_t coinId) const {
+    if (!coinId || coinId >= (uint32_t)config::SYMBOL_MAX_IDS) return false;
+    DWORD until = watchUntil_[coinId].load(std::memory_order_relaxed);
+    return until != 0 && (int32_t)(until - GetTickCount()) > 0;
+}
+
+void GuiNotifier::onUpdate(uint32_t coinId) {
+    if (!window()) return;
+    updates_.fetch_add(1, std::memory_order_relaxed);
+    if (tradedOnly_.load(std::memory_order_relaxed) && !isWatched(coinId)) {
+        filtered_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    dirty_.store(true, std::memory_order_release);
+    if (!tryPost(GetTickCount())) coalesced_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void GuiNotifier::tick() {
+    if (window() && dirty_.load(std::memory_order_acquire)) tryPost(GetTickCount());
+}
+
+void GuiNotifier::acknowledge() {
+    if (!pending_.load(std::memory_order_acquire)) return;
+    // Clear dirty first: an update racing in after this re-marks it
+    dirty_.store(false, std::memory_order_release);
+    if (pending_.exchange(false, std::memory_order_acq_rel))
+        acks_.fetch_add(1, std::memory_order_relaxed);
+}
+
+// One winner per message: the CAS on pending_ decides which thread posts
+bool GuiNotifier::tryPost(DWORD now) {
+    HWND hwnd = window();
+    if (!hwnd) return false;
+    DWORD last = lastPost_.load(std::memory_order_relaxed);
+    if (pending_.load(std::memory_order_acquire)) {
+        if (now - last < (DWORD)config::NOTIFY_REARM_MS) return false;
+        if (pending_.exchange(false, std::memory_order_acq_rel))
+            rearms_.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (now - last < (DWORD)minIntervalMs_.load(std::memory_order_relaxed)) return false;
+
+    bool expected = false;
+    if (!pending_.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) return false;
+    dirty_.store(false, std::memory_order_release);
+    lastPost_.store(now, std::memory_order_relaxed);
+    PostMessage(hwnd, WM_APP + 1, 0, 0);
+    posted_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+GuiNotifyStats GuiNotifier::getStats() const {
+    GuiNotifyStats s;
+    s.updates = updates_.load(std::memory_order_relaxed);
+    s.filtered = filtered_.load(std::memory_order_relaxed);
+    s.coalesced = coalesced_.load(std::memory_order_relaxed);
+    s.posted = posted_.load(std::memory_order_relaxed);
+    s.acks = acks_.load(std::memory_order_relaxed);
+    s.rearms = rearms_.load(std::memory_order_relaxed);
+    s.minIntervalMs = minIntervalMs_.load(std::memory_order_relaxed);
+    s.tradedOnly = tradedOnly_.load(std::memory_order_relaxed);
+    s.pending = pending_.load(std::memory_order_relaxed);
+    return s;
+}
+
+} // namespace ws
+} // namespace hl
@@ -0,0 +1,95 @@
+//=============================================================================
+// ws_gui_notifier.h - Coalesced WM_APP+1 price notifications to Zorro
+//=============================================================================
+// Part of Hyperliquid Plugin for Zorro
+//
+// LAYER: Transport
+// DEPENDENCIES: hl_config.h
+// THREAD SAFETY: onUpdate/tick from any WS thread, acknowledge from Zorro's
+//                thread; all state is atomic
+//
+// Posting WM_APP+1 for every l2Book update floods Zorro's queue with
+// hundreds of messages per second, each waking its script loop. The notifier
+// keeps at most one message in flight:
+//   - an update posts only if no message is pending and minInterval has
+//     passed since the last post; otherwise it just marks the quotes dirty
+//   - acknowledge() (Zorro asking for prices) consumes the pending message
+//     and the dirty mark, since Zorro now reads every quote
+//   - tick() (WS primary loop) posts a dirty mark once the interval allows
+//   - a message not consumed within NOTIFY_REARM_MS is treated as lost
+// With tradedOnly, only coins with a position, an open order or a recent
+// order placement (watch()) notify.
+//=============================================================================
+
+#pragma once
+
+#include "../foundation/hl_config.h"
+#include "../foundation/hl_platform.h"
+#include <atomic>
+#include <cstdint>
+
+namespace hl {
+namespace ws {
+
+struct GuiNotifyStats {
+    long long updates = 0;          // onUpdate calls (valid l2Book updates)
+    long long filtered = 0;         // Dropped by tradedOnly
+    long long coalesced = 0;        // Covered by a pending or later message
+    long long posted = 0;           // WM_APP+1 messages sent
+    long long acks = 0;             // Pending messages consumed by Zorro
+    long long rearms = 0;           // Pending messages given up after NOTIFY_REARM_MS
+    int minIntervalMs = 0;
+    bool tradedOnly = false;
+    bool pending = false;
+};
+
+class GuiNotifier {
+public:
+    GuiNotifier();
+
+    GuiNotifier(const GuiNotifier&) = delete;
+    GuiNotifier& operator=(const GuiNotifier&) = delete;
+
+    void setWindow(HWND hwnd) { window_.store(hwnd, std::memory_order_release); }
+    HWND window() const { return window_.load(std::memory_order_acquire); }
+
+    /// Minimum time between two posts (0 = only the one-in-flight limit)
+    void setMinInterval(int ms) { minIntervalMs_.store(ms > 0 ? ms : 0, std::memory_order_relaxed); }
+    void setTradedOnly(bool on) { tradedOnly_.store(on, std::memory_order_relaxed); }
+    bool isTradedOnly() const { return tradedOnly_.load(std::memory_order_relaxed); }
+
+    /// Let a coin notify under tradedOnly for the next forMs
+    void watch(uint32_t coinId, DWORD forMs);
+    bool isWatched(uint32_t coinId) const;
+
+    /// A coin's quote changed
+    void onUpdate(uint32_t coinId);
+
+    /// Post a dirty mark the interval held back
+    void tick();
+
+    /// Zorro is reading prices: the pending message has been consumed
+    void acknowledge();
+
+    GuiNotifyStats getStats() const;
+
+private:
+    std::atomic<HWND> window_;
+    std::atomic<int> minIntervalMs_;
+    std::atomic<bool> tradedOnly_;
+    std::atomic<bool> pending_;
+    std::atomic<bool> dirty_;
+    std::atomic<DWORD> lastPost_;
+    std::atomic<long long> updates_;
+    std::atomic<long long> filtered_;
+    std::atomic<long long> coalesced_;
+    std::atomic<long long> posted_;
+    std::atomic<long long> acks_;
+    std::atomic<long long> rearms_;
+    std::atomic<DWORD> watchUntil_[config::SYMBOL_MAX_IDS];   // GetTickCount() expiry, 0 = never watched
+
+    bool tryPost(DWORD now);
+};
+
+} // namespace ws
+} // namespace hl
@@ -11,43 +11,59 @@
 #include "ws_parsers.h"
 #include "json_helpers.h"
 #include "../foundation/hl_globals.h"
+#include "../foundation/hl_asset_ctx.h"
 #include <IXNetSystem.h>
 #include <cstdio>
-#include <cstdarg>
 #include <cstring>
 #include <algorithm>
 
 namespace hl {
 namespace ws {
 
+// Registry key of a coin's l2Book subscription
+static std::string l2Key(const std::string& coin) {
+    return SubscriptionRegistry::makeKey("l2Book", coin.c_str());
+}
+
 // --- Construction / Destruction ---
 
 WebSocketManager::WebSocketManager(PriceCache& cache)
-    : cache_(cache), connectionThread_(NULL),
-      shutdownEvent_(NULL), running_(false), testnet_(false),
-      zorroWindow_(NULL), diagLevel_(0), logCallback_(nullptr),
+    : cache_(cache), marketCount_(0), standby_(nullptr), standbyRequested_(false),
+      subRate_(config::WS_SUB_RATE_PER_SEC), subBurst_(config::WS_SUB_BURST),
+      sharedRequested_(false), sharedLocalFallback_(false), sharedCheckAt_(0),
+      sharedFeedDown_(true),
+      notifyWatchAt_(0),
+      shutdownEvent_(NULL), running_(false), endpointSecure_(true), testnet_(false),
+      diagLevel_(0), logCallback_(nullptr),
       orderUpdateCallback_(nullptr), fillNotifyCallback_(nullptr),
       subscribedUserFills_(false), subscribedClearinghouse_(false),
       subscribedOpenOrders_(false), pendingUserFillsSub_(false),
       pendingClearinghouseSub_(false), pendingOpenOrdersSub_(false),
       initialSubsQueued_(false),
-      nextRequestId_(1000),
-      consecutiveReconnects_(0), circuitOpen_(false), circuitOpenedAt_(0) {
+      nextRequestId_(1000), registry_(config::WS_SUB_ACK_TIMEOUT_MS),
+      fillAgg_(config::FILL_AGG_RETIRED_MEMORY), lastFillRetireAt_(0),
+      orderFeedEpoch_(1), frameRingPos_(0), duplicatesDropped_(0) {
     ix::initNetSystem();  // WSAStartup (ref-counted, safe to call multiple times) [OPM-127]
     InitializeCriticalSection(&l2SubCs_);
     InitializeCriticalSection(&accountSubCs_);
     InitializeCriticalSection(&postCs_);
     InitializeCriticalSection(&responseCs_);
     InitializeCriticalSection(&indexMapCs_);
+    InitializeCriticalSection(&dedupCs_);
+    shards_.push_back(new Shard(0, this));
+    primary().l2Subs.setPacing(subRate_, subBurst_);
 }
 
 WebSocketManager::~WebSocketManager() {
     stop();
+    for (Shard* shard : shards_) delete shard;
+    shards_.clear();
     DeleteCriticalSection(&l2SubCs_);
     DeleteCriticalSection(&accountSubCs_);
     DeleteCriticalSection(&postCs_);
     DeleteCriticalSection(&responseCs_);
     DeleteCriticalSection(&indexMapCs_);
+    DeleteCriticalSection(&dedupCs_);
     ix::uninitNetSystem();  // WSACleanup (ref-counted) [OPM-127]
 }
 
@@ -55,27 +71,136 @@ WebSocketManager::~WebSocketManager() {
 
 void WebSocketManager::setDiagLevel(int level) {
     diagLevel_ = level;
-    connection_.setLogCallback(logCallback_, level);
+    for (Shard* shard : shards_)
+        shard->connection.setLogCallback(logCallback_, level);
 }
 
 void WebSocketManager::setLogCallback(LogCallback cb) {
     logCallback_ = cb;
-    connection_.setLogCallback(cb, diagLevel_);
+    for (Shard* shard : shards_)
+        shard->connection.setLogCallback(cb, diagLevel_);
 }
 
 void WebSocketManager::log(int minLevel, const char* msg) {
-    if (logCallback_ && diagLevel_ >= minLevel) logCallback_(msg);
+    if (logCallback_ && diagLevel_ >= minLevel) logText(logCallback_, msg);
+}
+
+// --- Configuration ---
+
+void WebSocketManager::setEndpoint(const std::string& hostname, bool secure) {
+    endpointHost_ = hostname;
+    endpointSecure_ = secure;
+}
+
+void WebSocketManager::setMarketConnections(int count) {
+    if (running_) {
+        log(1, "WS: setMarketConnections ignored — manager already running");
+        return;
+    }
+    if (count < 0) count = 0;
+    if (count > config::WS_MAX_MARKET_CONNECTIONS) count = config::WS_MAX_MARKET_CONNECTIONS;
+    marketCount_ = count;
+    rebuildShards();
+
+    logf(1, "WS: Connection pool: 1 primary + %d market data connection(s)", count);
+}
+
+void WebSocketManager::setStandbyEnabled(bool enable) {
+    if (running_) {
+        log(1, "WS: setStandbyEnabled ignored — manager already running");
+        return;
+    }
+    standbyRequested_ = enable;
+    rebuildShards();
+
+    logf(1, "WS: Warm standby %s", enable ? "enabled" : "disabled");
+}
+
+void WebSocketManager::setSubscriptionPacing(double framesPerSec, int burst) {
+    EnterCriticalSection(&l2SubCs_);
+    subRate_ = framesPerSec;
+    subBurst_ = burst;
+    for (Shard* shard : shards_) shard->l2Subs.setPacing(framesPerSec, burst);
+    subRate_ = primary().l2Subs.rate();   // Clamped values
+    subBurst_ = primary().l2Subs.burst();
+    LeaveCriticalSection(&l2SubCs_);
+
+    logf(1, "WS: l2Book subscribe pacing %.1f/s, burst %d", subRate_, subBurst_);
+}
+
+void WebSocketManager::rebuildShards() {
+    // Shards only hold subscription lists before start(); primary survives
+    // so its queued l2Book subs are redistributed below.
+    std::vector<std::string> queued;
+    for (Shard* shard : shards_) {
+        if (shard == standby_) continue;
+        auto coins = shard->l2Subs.coins();
+        queued.insert(queued.end(), coins.begin(), coins.end());
+        shard->l2Subs.clear();
+    }
+    registry_.clear();  // Nothing sent yet — records are rebuilt below
+    while (shards_.size() > 1) {
+        delete shards_.back();
+        shards_.pop_back();
+    }
+    standby_ = nullptr;
+
+    for (int i = 1; i <= marketCount_; ++i)
+        shards_.push_back(new Shard(i, this));
+    if (standbyRequested_) {
+        standby_ = new Shard((int)shards_.size(), this);
+        for (const auto& coin : standbyCoins_) {
+            standby_->l2Subs.enqueue(coin, SUB_PRIORITY_POSITION);
+            registry_.onRequested(standby_->index, l2Key(coin), GetTickCount());
+        }
+        shards_.push_back(standby_);
+    }
+    for (size_t i = 1; i < shards_.size(); ++i) {
+        shards_[i]->connection.setLogCallback(logCallback_, diagLevel_);
+        shards_[i]->l2Subs.setPacing(subRate_, subBurst_);
+    }
+
+    for (const auto& coin : queued) {
+        Shard& shard = shardForCoin(coin);
+        shard.l2Subs.enqueue(coin, subscriptionPriority(coin));
+        registry_.onRequested(shard.index, l2Key(coin), GetTickCount());
+    }
 }
 
-void WebSocketManager::logf(int minLevel, const char* fmt, ...) {
-    if (logCallback_ && diagLevel_ >= minLevel) {
-        char buf[512];
-        va_list args;
-        va_start(args, fmt);
-        vsnprintf(buf, sizeof(buf), fmt, args);
-        va_end(args);
-        logCallback_(buf);
+void WebSocketManager::addStandbyCoin(const std::string& coin) {
+    if (!standby_) return;
+    EnterCriticalSection(&l2SubCs_);
+    bool added = standbyCoins_.insert(coin).second;
+    if (added) standby_->l2Subs.enqueue(coin, SUB_PRIORITY_POSITION);  // Sent by the standby thread
+    LeaveCriticalSection(&l2SubCs_);
+    if (added)
+        registry_.onRequested(standby_->index, l2Key(coin), GetTickCount());
+    if (added) logf(2, "WS: Standby mirrors l2Book %s", coin.c_str());
+}
+
+// Stable FNV-1a hash — coin-to-connection mapping must not change between
+// runs or reconnects, so std::hash (implementation-defined) is not used.
+static uint32_t coinHash(const std::string& coin) {
+    uint32_t h = 2166136261u;
+    for (unsigned char c : coin) {
+        h ^= c;
+        h *= 16777619u;
     }
+    return h;
+}
+
+WebSocketManager::Shard& WebSocketManager::shardForCoin(const std::string& coin) {
+    if (marketCount_ == 0) return *shards_[0];
+    return *shards_[1 + coinHash(coin) % marketCount_];
+}
+
+const WebSocketManager::Shard& WebSocketManager::shardForCoin(const std::string& coin) const {
+    if (marketCount_ == 0) return *shards_[0];
+    return *shards_[1 + coinHash(coin) % marketCount_];
+}
+
+int WebSocketManager::getConnectionIndexForCoin(const std::string& coin) const {
+    return shardForCoin(coin).index;
 }
 
 // --- Lifecycle ---
@@ -94,22 +219,35 @@ void WebSocketManager::start(const std::string& hostname, bool testnet) {
         return;
     }
 
-    connection_.setMessageHandler([this](const char* data, size_t len) {
-        handleMessage(data, len);
-    });
-
-    // Enable IXWebSocket auto-reconnect — handles backoff internally [OPM-128]
-    connection_.enableAutoReconnect(1000, 30000);
+    if (sharedRequested_) {
+        std::string name = std::string(config::SHM_PRICES_NAME) + (testnet ? ".testnet" : ".mainnet");
+        if (shared_.open(name.c_str())) {
+            cache_.setSharedSource(&shared_);
+            logf(1, "WS: Shared price table %s mapped", name.c_str());
+        } else {
+            logf(1, "WS: Shared price table %s unavailable — subscribing directly", name.c_str());
+        }
+    }
 
-    connectionThread_ = CreateThread(NULL, 0, ConnectionThreadProc, this, 0, NULL);
-    if (!connectionThread_) {
-        log(1, "WS: Failed to create connection thread");
-        CloseHandle(shutdownEvent_); shutdownEvent_ = NULL;
-        running_ = false;
-        return;
+    for (Shard* shard : shards_) {
+        shard->connection.setMessageHandler([this, shard](const char* data, size_t len) {
+            shard->messages++;
+            shard->bytes += (long long)len;
+            handleMessage(*shard, data, len);
+        });
+
+        // Enable IXWebSocket auto-reconnect — handles backoff internally [OPM-128]
+        shard->connection.enableAutoReconnect(1000, 30000);
+
+        shard->thread = CreateThread(NULL, 0, ConnectionThreadProc, shard, 0, NULL);
+        if (!shard->thread) {
+            logf(1, "WS: Failed to create connection thread %d", shard->index);
+            stop();
+            return;
+        }
     }
 
-    log(1, "WS: Manager started");
+    logf(1, "WS: Manager started (%d connection(s))", (int)shards_.size());
 }
 
 void WebSocketManager::stop() {
@@ -119,7 +257,7 @@ void WebSocketManager::stop() {
     running_ = false;
 
     // Suppress logging BEFORE blocking operations to prevent deadlock [OPM-133].
-    // Both connectionThread_ and IXWebSocket thread call logCallback_ →
+    // Both connection threads and IXWebSocket threads call logCallback_ →
     // BrokerMessage → SendMessage to GUI. If the main (GUI) thread is blocked
     // in ws_.stop() or WaitForSingleObject, SendMessage deadlocks.
     logCallback_ = nullptr;
@@ -127,54 +265,148 @@ void WebSocketManager::stop() {
     if (shutdownEvent_) SetEvent(shutdownEvent_);
 
     // Disconnect to unblock any pending operations [OPM-16]
-    connection_.disconnect();
-
-    if (connectionThread_) {
-        DWORD result = WaitForSingleObject(connectionThread_, 3000);
-        CloseHandle(connectionThread_);
-        connectionThread_ = NULL;
+    for (Shard* shard : shards_)
+        shard->connection.disconnect();
+
+    for (Shard* shard : shards_) {
+        if (shard->thread) {
+            WaitForSingleObject(shard->thread, 3000);
+            CloseHandle(shard->thread);
+            shard->thread = NULL;
+        }
     }
     if (shutdownEvent_) {
         CloseHandle(shutdownEvent_);
         shutdownEvent_ = NULL;
     }
+
+    // The primary thread released the publisher mutex on its way out
+    cache_.setSharedSource(nullptr);
+    shared_.close();
+    sharedLocalFallback_ = false;
+    sharedFeedDown_ = true;
+    EnterCriticalSection(&l2SubCs_);
+    sharedCoins_.clear();
+    LeaveCriticalSection(&l2SubCs_);
 }
 
 bool WebSocketManager::isHealthy() const {
-    if (!connection_.isConnected()) return false;
-    time_t lastMsg = connection_.lastMessageTime();
+    if (!primary().connection.isConnected()) return false;
+    time_t lastMsg = primary().connection.lastMessageTime();
     return (time(NULL) - lastMsg) < 60;
 }
 
+bool WebSocketManager::isHealthyForCoin(const std::string& coin) const {
+    if (servedByShared(coin)) return true;
+    const Shard& shard = shardForCoin(coin);
+    time_t now = time(NULL);
+    if (shard.connection.isConnected() && (now - shard.connection.lastMessageTime()) < 60)
+        return true;
+
+    // Standby carries the coin too — still healthy while it is
+    if (!standby_ || !standby_->connection.isConnected()) return false;
+    EnterCriticalSection(&l2SubCs_);
+    bool mirrored = standbyCoins_.count(coin) > 0;
+    LeaveCriticalSection(&l2SubCs_);
+    return mirrored && (now - standby_->connection.lastMessageTime()) < 60;
+}
+
+bool WebSocketManager::isOrderFeedLive() const {
+    if (userAddress_.empty()) return false;
+    DWORD tick = GetTickCount();
+    time_t now = time(NULL);
+    auto carries = [&](const Shard* shard) {
+        if (!shard || !shard->connection.isConnected()) return false;
+        if (now - shard->connection.lastMessageTime() >= config::WS_HEALTH_THRESHOLD_SEC)
+            return false;
+        SubStatus st = registry_.status(shard->index, "orderUpdates", tick);
+        return st == SubStatus::Acked || st == SubStatus::Live;
+    };
+    return carries(shards_[0]) || carries(standby_);
+}
+
 int WebSocketManager::getSecondsSinceLastMessage() const {
-    return static_cast<int>(time(NULL) - connection_.lastMessageTime());
+    return static_cast<int>(time(NULL) - primary().connection.lastMessageTime());
+}
+
+std::vector<ConnectionHealth> WebSocketManager::getConnectionHealth() const {
+    std::vector<ConnectionHealth> result;
+    result.reserve(shards_.size());
+    time_t now = time(NULL);
+
+    EnterCriticalSection(&l2SubCs_);
+    for (const Shard* shard : shards_) {
+        ConnectionHealth h;
+        h.index = shard->index;
+        h.standby = (shard == standby_);
+        h.connected = shard->connection.isConnected();
+        h.circuitOpen = shard->circuitOpen;
+        h.l2Subscriptions = shard->l2Subs.size();
+        h.l2Acked = shard->l2Subs.ackedCount();
+        h.l2Queued = shard->l2Subs.queuedCount();
+        h.reconnects = shard->totalReconnects.load();
+        h.messages = shard->messages.load();
+        h.bytes = shard->bytes.load();
+        h.firstArrivals = shard->firstArrivals.load();
+        time_t lastMsg = shard->connection.lastMessageTime();
+        h.secondsSinceLastMessage = lastMsg > 0 ? (int)(now - lastMsg) : -1;
+        result.push_back(h);
+    }
+    LeaveCriticalSection(&l2SubCs_);
+    return result;
+}
+
+bool WebSocketManager::allSubscriptionsAcked() const {
+    EnterCriticalSection(&l2SubCs_);
+    bool all = true;
+    for (const Shard* shard : shards_)
+        if (shard->l2Subs.ackedCount() != shard->l2Subs.size()) { all = false; break; }
+    LeaveCriticalSection(&l2SubCs_);
+    return all;
 }
 
 // --- Threads ---
 
 DWORD WINAPI WebSocketManager::ConnectionThreadProc(LPVOID param) {
-    static_cast<WebSocketManager*>(param)->connectionLoop();
+    Shard* shard = static_cast<Shard*>(param);
+    shard->owner->connectionLoop(*shard);
     return 0;
 }
 
-// connectionLoop() — simplified with IXWebSocket auto-reconnect [OPM-128]
+bool WebSocketManager::connectShard(Shard& shard) {
+    std::string host = endpointHost_;
+    bool secure = endpointSecure_;
+    if (host.empty()) {
+        host = testnet_ ? "api.hyperliquid-testnet.xyz" : "api.hyperliquid.xyz";
+        secure = true;
+    }
+    return shard.connection.connect(host.c_str(), secure, "/ws", 30000);
+}
+
+// connectionLoop() — one instance per pooled connection [OPM-128]
 //
 // IXWebSocket handles protocol-level ping/pong and automatic reconnection
 // with exponential backoff. This loop only needs to:
 //   1. Initiate the first connection
 //   2. Drain messages via poll()
-//   3. Re-subscribe channels after auto-reconnect
-//   4. Send pending work (subscriptions, posts)
+//   3. Re-subscribe this connection's channels after auto-reconnect
+//   4. Send pending work (l2Book subscriptions; posts/account subs on primary,
+//      posts on the standby while the primary is down)
 //   5. Send periodic HL application pings (30s)
-void WebSocketManager::connectionLoop() {
-    const char* host = testnet_ ?
-        "api.hyperliquid-testnet.xyz" : "api.hyperliquid.xyz";
+void WebSocketManager::connectionLoop(Shard& shard) {
+    const bool isPrimary = (shard.index == 0);
+    const bool isStandby = (&shard == standby_);
+    Connection& conn = shard.connection;
+
+    // Claim the shared-price publisher role before the (slow) first connect
+    if (isPrimary) syncSharedPrices();
 
     // Initial connection — auto-reconnect handles subsequent retries
-    if (connection_.connect(host, true, "/ws", 30000)) {
-        subscribeInitialChannels();
+    if (connectShard(shard)) {
+        if (isPrimary) subscribeInitialChannels();
+        else if (isStandby) subscribeStandbyChannels(shard);
     } else {
-        log(1, "WS: Initial connection failed (auto-reconnect will retry)");
+        logf(1, "WS[%d]: Initial connection failed (auto-reconnect will retry)", shard.index);
     }
 
     DWORD lastHlPingTick = GetTickCount();
@@ -184,31 +416,49 @@ void WebSocketManager::connectionLoop() {
 
     while (running_) {
         if (WaitForSingleObject(shutdownEvent_, 0) == WAIT_OBJECT_0) break;
+        if (isPrimary) {
+            syncSharedPrices();
+            tickNotify();
+        }
 
         // Check if IXWebSocket auto-reconnected [OPM-128]
-        if (connection_.wasReconnected()) {
-            consecutiveReconnects_++;
-
-            if (consecutiveReconnects_ > MAX_CONSECUTIVE_RECONNECTS) {
-                logf(1, "WS: Circuit breaker OPEN — %d consecutive reconnects, "
-                     "pausing for %ds",
-                     consecutiveReconnects_, CIRCUIT_COOLDOWN_MS / 1000);
-                connection_.stopAutoReconnect();
-                circuitOpen_ = true;
-                circuitOpenedAt_ = GetTickCount();
+        if (conn.wasReconnected()) {
+            shard.totalReconnects++;
+            shard.consecutiveReconnects++;
+
+            // orderUpdates has no snapshot: unless the other carrier stayed
+            // up, events during the outage are lost
+            if (isPrimary || isStandby) {
+                const Shard* other = isPrimary ? standby_ : shards_[0];
+                if (!other || !other->connection.isConnected()) {
+                    uint32_t epoch = ++orderFeedEpoch_;
+                    logf(1, "WS[%d]: Order feed gap — epoch %u", shard.index, epoch);
+                }
+            }
+
+            if (shard.consecutiveReconnects > MAX_CONSECUTIVE_RECONNECTS) {
+                logf(1, "WS[%d]: Circuit breaker OPEN — %d consecutive reconnects, "
+                     "pausing for %ds", shard.index,
+                     shard.consecutiveReconnects, CIRCUIT_COOLDOWN_MS / 1000);
+                conn.stopAutoReconnect();
+                shard.circuitOpen = true;
+                shard.circuitOpenedAt = GetTickCount();
             } else {
-                log(1, "WS: Re-subscribing after auto-reconnect");
-                requeueSubscriptionsAfterReconnect();
-                subscribeInitialChannels();
+                logf(1, "WS[%d]: Re-subscribing after auto-reconnect", shard.index);
+                requeueSubscriptionsAfterReconnect(shard);
+                if (isPrimary) subscribeInitialChannels();
+                else if (isStandby) subscribeStandbyChannels(shard);
             }
         }
 
         // Send pending work (only if connected)
-        if (connection_.isConnected()) {
-            sendPendingPosts();
+        if (conn.isConnected()) {
+            // Standby takes over posts while the primary is down
+            if (isPrimary || (isStandby && !primary().connection.isConnected()))
+                sendPendingPosts(conn);
             if (initialSubsQueued_) {
-                sendPendingL2Subscriptions();
-                sendPendingAccountSubscriptions();
+                sendPendingL2Subscriptions(shard);
+                if (isPrimary) sendPendingAccountSubscriptions();
             }
 
             // HL application ping at reduced frequency [OPM-128]
@@ -216,40 +466,43 @@ void WebSocketManager::connectionLoop() {
             // HL app pings keep the subscription channels active.
             DWORD now = GetTickCount();
             if (now - lastHlPingTick >= HL_PING_INTERVAL_MS) {
-                connection_.send("{\"method\":\"ping\"}");
+                conn.send("{\"method\":\"ping\"}");
                 lastHlPingTick = now;
             }
         }
 
         // Circuit breaker cooldown — probe reconnect
-        if (circuitOpen_) {
-            DWORD elapsed = GetTickCount() - circuitOpenedAt_;
+        if (shard.circuitOpen) {
+            DWORD elapsed = GetTickCount() - shard.circuitOpenedAt;
             if (elapsed >= CIRCUIT_COOLDOWN_MS) {
-                log(1, "WS: Circuit breaker probe — attempting reconnect");
-                circuitOpen_ = false;
-                consecutiveReconnects_ = 0;
-                connection_.enableAutoReconnect(1000, 30000);
-                connection_.connect(host, true, "/ws", 30000);
+                logf(1, "WS[%d]: Circuit breaker probe — attempting reconnect", shard.index);
+                shard.circuitOpen = false;
+                shard.consecutiveReconnects = 0;
+                conn.enableAutoReconnect(1000, 30000);
+                connectShard(shard);
                 // wasReconnected() will fire next iteration → normal re-subscribe
             }
         }
 
         // Reset reconnect counter when data flows (connection is healthy)
-        if (connection_.isConnected() && consecutiveReconnects_ > 0) {
-            time_t lastMsg = connection_.lastMessageTime();
+        if (conn.isConnected() && shard.consecutiveReconnects > 0) {
+            time_t lastMsg = conn.lastMessageTime();
             if (lastMsg > 0 && (time(NULL) - lastMsg) < 10) {
-                logf(2, "WS: Reconnect counter reset (was %d)",
-                     consecutiveReconnects_);
-                consecutiveReconnects_ = 0;
+                logf(2, "WS[%d]: Reconnect counter reset (was %d)",
+                     shard.index, shard.consecutiveReconnects);
+                shard.consecutiveReconnects = 0;
             }
         }
 
         // Drain messages from IXWebSocket queue
-        connection_.poll(100);
+        conn.poll(100);
         Sleep(10);
     }
 
-    log(1, "WS: Connection loop exited");
+    // Named mutexes belong to the thread that took them: hand the publisher
+    // role over here, not in stop()
+    if (isPrimary) shared_.releasePublisher();
+    logf(1, "WS[%d]: Connection loop exited", shard.index);
 }
 
 // --- Initial Channel Setup ---
@@ -261,54 +514,165 @@ void WebSocketManager::subscribeInitialChannels() {
         sprintf_s(sub, "{\"method\":\"subscribe\",\"subscription\":"
                  "{\"type\":\"orderUpdates\",\"user\":\"%s\"}}",
                  userAddress_.c_str());
-        connection_.send(sub);
+        if (primary().connection.send(sub)) registry_.onSent(0, "orderUpdates", GetTickCount());
     }
 }
 
+void WebSocketManager::subscribeStandbyChannels(Shard& shard) {
+    // Critical account streams only; l2Book mirrors go through the scheduler
+    if (userAddress_.empty()) return;
+    char sub[512];
+    sprintf_s(sub, "{\"method\":\"subscribe\",\"subscription\":"
+             "{\"type\":\"orderUpdates\",\"user\":\"%s\"}}", userAddress_.c_str());
+    if (shard.connection.send(sub)) registry_.onSent(shard.index, "orderUpdates", GetTickCount());
+    sprintf_s(sub, "{\"method\":\"subscribe\",\"subscription\":"
+             "{\"type\":\"userFills\",\"user\":\"%s\"}}", userAddress_.c_str());
+    if (shard.connection.send(sub)) registry_.onSent(shard.index, "userFills", GetTickCount());
+}
+
 // --- Subscriptions ---
 
 void WebSocketManager::subscribeL2Book(const std::string& coin) {
-    // Reject coins that were banned for causing disconnects [OPM-170]
-    if (bannedL2Coins_.count(coin)) {
-        logf(1, "WS: Rejecting l2Book subscription for banned coin '%s'", coin.c_str());
+    // Shared prices: the publisher subscribes every coin claimed in the
+    // table; the other instances only claim it (unless the table is full or
+    // the publisher went silent)
+    if (shared_.isOpen() && shared_.request(coin.c_str()) >= 0 &&
+        !shared_.isPublisher() && !sharedLocalFallback_) {
+        EnterCriticalSection(&l2SubCs_);
+        sharedCoins_.insert(coin);
+        LeaveCriticalSection(&l2SubCs_);
+        if (diagLevel_ >= 2) logf(2, "WS: l2Book %s requested from shared publisher", coin.c_str());
         return;
     }
 
-    EnterCriticalSection(&l2SubCs_);
-    // Check if already subscribed or pending
-    for (const auto& c : l2Subscriptions_) if (c == coin) { LeaveCriticalSection(&l2SubCs_); return; }
-    for (const auto& c : pendingL2Subs_) if (c == coin) { LeaveCriticalSection(&l2SubCs_); return; }
+    Shard& shard = shardForCoin(coin);
+    int priority = subscriptionPriority(coin);  // Before l2SubCs_ — reads PriceCache
 
-    // Try immediate send if connected [OPM-142]
-    if (connection_.isConnected()) {
-        l2Subscriptions_.push_back(coin);
+    EnterCriticalSection(&l2SubCs_);
+    // Reject coins that were banned for causing disconnects [OPM-170]
+    if (bannedL2Coins_.count(g_symbols.find(coin.c_str()))) {
         LeaveCriticalSection(&l2SubCs_);
+        logf(1, "WS: Rejecting l2Book subscription for banned coin '%s'", coin.c_str());
+        return;
+    }
 
-        char sub[256];
-        sprintf_s(sub, "{\"method\":\"subscribe\",\"subscription\":"
-                 "{\"type\":\"l2Book\",\"coin\":\"%s\"}}", coin.c_str());
+    // Already queued, sent or acked (a coin always maps to the same shard)
+    if (shard.l2Subs.contains(coin)) { LeaveCriticalSection(&l2SubCs_); return; }
+    shard.l2Subs.enqueue(coin, priority);
+    LeaveCriticalSection(&l2SubCs_);
+    registry_.onRequested(shard.index, l2Key(coin), GetTickCount());
 
+    // Send right away if connected and a pacing token is free [OPM-142];
+    // otherwise the shard thread sends it when the bucket refills.
+    if (shard.connection.isConnected()) {
         if (diagLevel_ >= 2)
-            logf(2, "WS: Subscribe l2Book (immediate): %s", coin.c_str());
+            logf(2, "WS[%d]: Subscribe l2Book (immediate): %s", shard.index, coin.c_str());
+        sendPendingL2Subscriptions(shard);
+    } else if (diagLevel_ >= 2) {
+        logf(2, "WS[%d]: Subscribe l2Book (queued, not connected): %s", shard.index, coin.c_str());
+    }
+}
 
-        if (!connection_.send(sub)) {
-            // Send failed — move back to pending for retry on next iteration
-            EnterCriticalSection(&l2SubCs_);
-            auto it = std::find(l2Subscriptions_.begin(), l2Subscriptions_.end(), coin);
-            if (it != l2Subscriptions_.end()) {
-                l2Subscriptions_.erase(it);
+// Every l2Book connection is up (the standby carries no market data)
+bool WebSocketManager::marketFeedConnected() const {
+    for (const Shard* shard : shards_) {
+        if (shard != standby_ && !shard->connection.isConnected()) return false;
+    }
+    return true;
+}
+
+// Primary thread, every loop pass. A reader retries the publisher mutex
+// every SHM_TAKEOVER_CHECK_MS (a crashed publisher leaves it abandoned); the
+// publisher heartbeats and subscribes coins other instances claimed. The
+// heartbeat stops while its own feed is down, so readers see the table go
+// stale and subscribe directly instead of reading frozen quotes.
+void WebSocketManager::syncSharedPrices() {
+    if (!shared_.isOpen()) return;
+
+    if (!shared_.isPublisher()) {
+        DWORD now = GetTickCount();
+        if (sharedCheckAt_ != 0 && now - sharedCheckAt_ < (DWORD)config::SHM_TAKEOVER_CHECK_MS) return;
+        sharedCheckAt_ = now ? now : 1;
+
+        if (!shared_.tryAcquirePublisher()) {
+            // Mutex still held but no heartbeat: the publisher hangs.
+            // Subscribe our own coins; its quotes win again once newer.
+            if (!sharedLocalFallback_ && !shared_.publisherAlive()) {
+                sharedLocalFallback_ = true;
+                EnterCriticalSection(&l2SubCs_);
+                std::vector<std::string> coins(sharedCoins_.begin(), sharedCoins_.end());
+                LeaveCriticalSection(&l2SubCs_);
+                logf(1, "WS: Shared-price publisher silent — subscribing %d coin(s) directly",
+                     (int)coins.size());
+                for (const auto& coin : coins) subscribeL2Book(coin);
             }
-            pendingL2Subs_.push_back(coin);
-            LeaveCriticalSection(&l2SubCs_);
-            logf(1, "WS: Failed to send l2Book subscription for %s, queuing for retry", coin.c_str());
+            return;
         }
-    } else {
-        // Not connected — queue for later [OPM-142]
-        pendingL2Subs_.push_back(coin);
-        LeaveCriticalSection(&l2SubCs_);
-        if (diagLevel_ >= 2)
-            logf(2, "WS: Subscribe l2Book (queued, not connected): %s", coin.c_str());
+        logf(1, "WS: Publishing shared prices (takeover #%u)", shared_.getStats().takeovers);
+    }
+
+    bool feedUp = marketFeedConnected();
+    if (feedUp == sharedFeedDown_) {
+        sharedFeedDown_ = !feedUp;
+        if (feedUp) logf(2, "WS: Shared-price feed connected — heartbeat on");
+        else logf(1, "WS: Shared-price feed disconnected — heartbeat paused");
     }
+    if (feedUp) shared_.heartbeat();
+    std::vector<std::string> coins;
+    if (shared_.takeRequests(coins) > 0) {
+        if (diagLevel_ >= 2) logf(2, "WS: Shared prices — %d coin(s) requested", (int)coins.size());
+        for (const auto& coin : coins) subscribeL2Book(coin);
+    }
+}
+
+// A reader instance gets this coin from the publisher
+bool WebSocketManager::servedByShared(const std::string& coin) const {
+    if (!shared_.isOpen() || shared_.isPublisher() || !shared_.publisherAlive()) return false;
+    EnterCriticalSection(&l2SubCs_);
+    bool requested = sharedCoins_.count(coin) > 0;
+    LeaveCriticalSection(&l2SubCs_);
+    return requested;
+}
+
+// Trailing post for updates the interval held back; with tradedOnly,
+// re-watch coins with a position or resting order (held for three rescans
+// so a coin does not flicker out between account snapshots)
+void WebSocketManager::tickNotify() {
+    if (!notifier_.window()) return;
+    notifier_.tick();
+    if (!notifier_.isTradedOnly()) return;
+
+    DWORD now = GetTickCount();
+    if (notifyWatchAt_ != 0 && now - notifyWatchAt_ < (DWORD)config::NOTIFY_WATCH_REFRESH_MS) return;
+    notifyWatchAt_ = now ? now : 1;
+
+    const DWORD holdMs = 3 * config::NOTIFY_WATCH_REFRESH_MS;
+    for (const auto& pos : cache_.getAllPositions())
+        if (pos.size != 0) notifier_.watch(g_symbols.find(pos.coin.c_str()), holdMs);
+    for (const auto& order : cache_.getAllOpenOrders())
+        notifier_.watch(g_symbols.find(order.coin.c_str()), holdMs);
+}
+
+void WebSocketManager::watchNotifyCoin(const std::string& coin) {
+    notifier_.watch(g_symbols.find(coin.c_str()), config::NOTIFY_ORDER_WATCH_MS);
+}
+
+// Resubscribe order after a reconnect: the coins the strategy is exposed to
+// must get prices back first.
+int WebSocketManager::subscriptionPriority(const std::string& coin) {
+    for (const auto& pos : cache_.getAllPositions())
+        if (pos.coin == coin && pos.size != 0) return SUB_PRIORITY_POSITION;
+    if (!cache_.getOpenOrdersForCoin(coin).empty()) return SUB_PRIORITY_ORDER;
+    return SUB_PRIORITY_NORMAL;
+}
+
+std::map<std::string, int> WebSocketManager::subscriptionPriorities() {
+    std::map<std::string, int> result;
+    for (const auto& order : cache_.getAllOpenOrders())
+        result[order.coin] = SUB_PRIORITY_ORDER;
+    for (const auto& pos : cache_.getAllPositions())
+        if (pos.size != 0) result[pos.coin] = SUB_PRIORITY_POSITION;
+    return result;
 }
 
 bool WebSocketManager::hasL2BookData(const std::string& coin) {
@@ -360,40 +724,69 @@ void WebSocketManager::subscribeAllAccountData() {
     subscribeOpenOrders();
 }
 
-void WebSocketManager::sendPendingL2Subscriptions() {
+void WebSocketManager::subscribeAssetCtx(const std::string& coin) {
+    if (coin.empty()) return;
+    EnterCriticalSection(&accountSubCs_);
+    if (subscribedAssetCtx_.count(coin) ||
+        std::find(pendingAssetCtxSubs_.begin(), pendingAssetCtxSubs_.end(), coin)
+            != pendingAssetCtxSubs_.end()) {
+        LeaveCriticalSection(&accountSubCs_);
+        return;
+    }
+    pendingAssetCtxSubs_.push_back(coin);
+    LeaveCriticalSection(&accountSubCs_);
+    registry_.onRequested(0, SubscriptionRegistry::makeKey("activeAssetCtx", coin.c_str()),
+                          GetTickCount());
+}
+
+void WebSocketManager::sendPendingL2Subscriptions(Shard& shard) {
+    // One subscription per frame is all the protocol allows, so a reconnect
+    // with hundreds of coins is paced by the shard's token bucket instead of
+    // being written in one burst.
+    DWORD now = GetTickCount();
     EnterCriticalSection(&l2SubCs_);
-    auto toSend = std::move(pendingL2Subs_);
-    pendingL2Subs_.clear();
+    std::vector<std::string> givenUp;
+    int resent = shard.l2Subs.requeueUnacked(now, config::WS_SUB_ACK_TIMEOUT_MS,
+                                             config::WS_SUB_MAX_ATTEMPTS, &givenUp);
+    // Never acked: ban like a toxic coin so later requests don't restart the loop
+    for (const auto& coin : givenUp) {
+        uint32_t coinId = g_symbols.intern(coin.c_str());
+        if (coinId) bannedL2Coins_.insert(coinId);
+    }
+    auto toSend = shard.l2Subs.takeReady(now);
+    int queued = shard.l2Subs.queuedCount();
     LeaveCriticalSection(&l2SubCs_);
 
+    if (resent > 0)
+        logf(1, "WS[%d]: %d l2Book subscription(s) not acked within %dms, resending",
+             shard.index, resent, config::WS_SUB_ACK_TIMEOUT_MS);
+    for (const auto& coin : givenUp) {
+        registry_.remove(shard.index, l2Key(coin));
+        logf(1, "WS[%d]: l2Book %s never acked after %d attempts, subscription dropped",
+             shard.index, coin.c_str(), config::WS_SUB_MAX_ATTEMPTS);
+    }
     if (toSend.empty()) return;
     if (diagLevel_ >= 2)
-        logf(2, "WS: Sending %d l2Book subscriptions", (int)toSend.size());
+        logf(2, "WS[%d]: Sending %d l2Book subscriptions (%d still queued)",
+             shard.index, (int)toSend.size(), queued);
 
-    size_t sent = 0;
     for (size_t i = 0; i < toSend.size(); ++i) {
         char sub[256];
         sprintf_s(sub, "{\"method\":\"subscribe\",\"subscription\":"
                  "{\"type\":\"l2Book\",\"coin\":\"%s\"}}", toSend[i].c_str());
-        if (diagLevel_ >= 2) logf(2, "WS: Subscribe l2Book: %s", toSend[i].c_str());
-        if (!connection_.send(sub)) {
-            logf(1, "WS: Failed to send l2Book subscription for %s", toSend[i].c_str());
-            // Re-queue unsent coins for retry on next iteration [OPM-99]
+        if (diagLevel_ >= 2) logf(2, "WS[%d]: Subscribe l2Book: %s", shard.index, toSend[i].c_str());
+        if (shard.connection.send(sub)) {
+            registry_.onSent(shard.index, l2Key(toSend[i]), now);
+        } else {
+            logf(1, "WS[%d]: Failed to send l2Book subscription for %s",
+                 shard.index, toSend[i].c_str());
+            // Re-queue unsent coins at the front, original order kept [OPM-99]
             EnterCriticalSection(&l2SubCs_);
-            for (size_t j = i; j < toSend.size(); ++j)
-                pendingL2Subs_.push_back(toSend[j]);
+            for (size_t j = toSend.size(); j > i; --j)
+                shard.l2Subs.requeue(toSend[j - 1]);
             LeaveCriticalSection(&l2SubCs_);
             break;
         }
-        ++sent;
-    }
-
-    // Only mark successfully-sent coins as active [OPM-99]
-    if (sent > 0) {
-        EnterCriticalSection(&l2SubCs_);
-        for (size_t i = 0; i < sent; ++i)
-            l2Subscriptions_.push_back(toSend[i]);
-        LeaveCriticalSection(&l2SubCs_);
     }
 }
 
@@ -406,6 +799,8 @@ void WebSocketManager::sendPendingAccountSubscriptions() {
     // [OPM-218] Snapshot perpDex pending subs under same lock
     std::vector<std::string> dexSubs;
     dexSubs.swap(pendingClearinghouseDexSubs_);
+    std::vector<std::string> ctxSubs;
+    ctxSubs.swap(pendingAssetCtxSubs_);
     LeaveCriticalSection(&accountSubCs_);
 
     if ((sendFills || sendClearing || sendOrders) && diagLevel_ >= 2) {
@@ -417,19 +812,28 @@ void WebSocketManager::sendPendingAccountSubscriptions() {
         char sub[512];
         sprintf_s(sub, "{\"method\":\"subscribe\",\"subscription\":"
                  "{\"type\":\"userFills\",\"user\":\"%s\"}}", userAddress_.c_str());
-        if (connection_.send(sub)) subscribedUserFills_ = true;
+        if (primary().connection.send(sub)) {
+            subscribedUserFills_ = true;
+            registry_.onSent(0, "userFills", GetTickCount());
+        }
     }
     if (sendClearing) {
         char sub[512];
         sprintf_s(sub, "{\"method\":\"subscribe\",\"subscription\":"
                  "{\"type\":\"clearinghouseState\",\"user\":\"%s\"}}", userAddress_.c_str());
-        if (connection_.send(sub)) subscribedClearinghouse_ = true;
+        if (primary().connection.send(sub)) {
+            subscribedClearinghouse_ = true;
+            registry_.onSent(0, "clearinghouseState", GetTickCount());
+        }
     }
     if (sendOrders) {
         char sub[512];
         sprintf_s(sub, "{\"method\":\"subscribe\",\"subscription\":"
                  "{\"type\":\"openOrders\",\"user\":\"%s\"}}", userAddress_.c_str());
-        if (connection_.send(sub)) subscribedOpenOrders_ = true;
+        if (primary().connection.send(sub)) {
+            subscribedOpenOrders_ = true;
+            registry_.onSent(0, "openOrders", GetTickCount());
+        }
     }
 
     // [OPM-218] Send perpDex clearinghouseState subscriptions
@@ -438,10 +842,12 @@ void WebSocketManager::sendPendingAccountSubscriptions() {
         sprintf_s(sub, "{\"method\":\"subscribe\",\"subscription\":"
                  "{\"type\":\"clearinghouseState\",\"user\":\"%s\",\"dex\":\"%s\"}}",
                  userAddress_.c_str(), dex.c_str());
-        if (connection_.send(sub)) {
+        if (primary().connection.send(sub)) {
             EnterCriticalSection(&accountSubCs_);
             subscribedClearinghouseDexes_.insert(dex);
             LeaveCriticalSection(&accountSubCs_);
+            registry_.onSent(0, SubscriptionRegistry::makeKey("clearinghouseState", dex.c_str()),
+                             GetTickCount());
             logf(1, "WS: Subscribed clearinghouseState dex=%s", dex.c_str());
         } else {
             // Re-queue for retry
@@ -451,46 +857,77 @@ void WebSocketManager::sendPendingAccountSubscriptions() {
             logf(1, "WS: Failed to send clearinghouseState sub for dex=%s, re-queued", dex.c_str());
         }
     }
+
+    // activeAssetCtx (spot coins answer on activeSpotAssetCtx)
+    for (size_t i = 0; i < ctxSubs.size(); ++i) {
+        char sub[256];
+        sprintf_s(sub, "{\"method\":\"subscribe\",\"subscription\":"
+                 "{\"type\":\"activeAssetCtx\",\"coin\":\"%s\"}}", ctxSubs[i].c_str());
+        if (primary().connection.send(sub)) {
+            EnterCriticalSection(&accountSubCs_);
+            subscribedAssetCtx_.insert(ctxSubs[i]);
+            LeaveCriticalSection(&accountSubCs_);
+            registry_.onSent(0, SubscriptionRegistry::makeKey("activeAssetCtx", ctxSubs[i].c_str()),
+                             GetTickCount());
+            if (diagLevel_ >= 2) logf(2, "WS: Subscribe activeAssetCtx: %s", ctxSubs[i].c_str());
+        } else {
+            // Unsent coins go back for the next pass
+            EnterCriticalSection(&accountSubCs_);
+            pendingAssetCtxSubs_.insert(pendingAssetCtxSubs_.end(), ctxSubs.begin() + i, ctxSubs.end());
+            LeaveCriticalSection(&accountSubCs_);
+            logf(1, "WS: Failed to send activeAssetCtx sub for %s, re-queued", ctxSubs[i].c_str());
+            break;
+        }
+    }
 }
 
-void WebSocketManager::requeueSubscriptionsAfterReconnect() {
+void WebSocketManager::requeueSubscriptionsAfterReconnect(Shard& shard) {
     const int MAX_REQUEUE_WITHOUT_DATA = 3;  // Drop after 3 reconnects with no data [OPM-170]
 
+    // Reads PriceCache — taken before l2SubCs_
+    std::map<std::string, int> priorities = subscriptionPriorities();
+
+    // The server dropped every subscription of this connection
+    registry_.onConnectionLost(shard.index);
+
+    // Only this shard's coins are requeued — other connections are unaffected
     EnterCriticalSection(&l2SubCs_);
-    for (const auto& coin : l2Subscriptions_) {
-        if (cache_.getBid(coin) > 0) {
+    for (const auto& coin : shard.l2Subs.coins()) {
+        if (shard.l2Subs.isQueued(coin)) continue;  // Never sent — nothing to judge
+        uint32_t coinId = g_symbols.intern(coin.c_str());
+        if (!coinId) continue;  // Symbol table full
+        if (registry_.hadData(shard.index, l2Key(coin))) {
             // Coin has received data before — safe to requeue
-            l2RequeueFailCount_.erase(coin);
-            pendingL2Subs_.push_back(coin);
+            shard.l2RequeueFailCount.erase(coinId);
         } else {
             // Never received data — might be causing the disconnect
-            int& count = l2RequeueFailCount_[coin];
-            count++;
-            if (count <= MAX_REQUEUE_WITHOUT_DATA) {
-                pendingL2Subs_.push_back(coin);
-            }
-            // else: silently dropped — logged below outside CS
+            shard.l2RequeueFailCount[coinId]++;
         }
     }
     // Collect dropped coins for logging outside critical section
     std::vector<std::string> dropped;
-    for (auto it = l2RequeueFailCount_.begin(); it != l2RequeueFailCount_.end(); ) {
+    for (auto it = shard.l2RequeueFailCount.begin(); it != shard.l2RequeueFailCount.end(); ) {
         if (it->second > MAX_REQUEUE_WITHOUT_DATA) {
-            dropped.push_back(it->first);
-            it = l2RequeueFailCount_.erase(it);
+            std::string coin = g_symbols.name(it->first);
+            dropped.push_back(coin);
+            bannedL2Coins_.insert(it->first);
+            shard.l2Subs.remove(coin);
+            registry_.remove(shard.index, l2Key(coin));
+            it = shard.l2RequeueFailCount.erase(it);
         } else {
             ++it;
         }
     }
-    l2Subscriptions_.clear();
+    // The server forgot every subscription: all coins back to the queue,
+    // positions first, then resting orders
+    shard.l2Subs.resetAll(priorities);
     LeaveCriticalSection(&l2SubCs_);
 
     for (const auto& coin : dropped) {
-        logf(1, "WS: Symbol '%s' NOT FOUND on exchange — "
+        logf(1, "WS[%d]: Symbol '%s' NOT FOUND on exchange — "
              "caused %d consecutive disconnects, subscription removed. "
              "Check asset name or perpDex format.",
-             coin.c_str(), MAX_REQUEUE_WITHOUT_DATA + 1);
-        bannedL2Coins_.insert(coin);
+             shard.index, coin.c_str(), MAX_REQUEUE_WITHOUT_DATA + 1);
     }
 
     // Fatal: toxic subscription crashed the connection repeatedly.
@@ -501,10 +938,13 @@ void WebSocketManager::requeueSubscriptionsAfterReconnect() {
         sprintf_s(hl::g_fatalErrorMsg, "Symbol '%s' not found on exchange",
                   dropped[0].c_str());
         hl::g_fatalError = true;
-        connection_.stopAutoReconnect();
+        shard.connection.stopAutoReconnect();
         return;  // Don't requeue anything — connection is done
     }
 
+    // Account channels live on the primary connection only
+    if (shard.index != 0) return;
+
     EnterCriticalSection(&accountSubCs_);
     if (subscribedUserFills_) { pendingUserFillsSub_ = true; subscribedUserFills_ = false; }
     if (subscribedClearinghouse_) { pendingClearinghouseSub_ = true; subscribedClearinghouse_ = false; }
@@ -513,19 +953,22 @@ void WebSocketManager::requeueSubscriptionsAfterReconnect() {
     for (const auto& dex : subscribedClearinghouseDexes_)
         pendingClearinghouseDexSubs_.push_back(dex);
     subscribedClearinghouseDexes_.clear();
+    for (const auto& coin : subscribedAssetCtx_)
+        pendingAssetCtxSubs_.push_back(coin);
+    subscribedAssetCtx_.clear();
     LeaveCriticalSection(&accountSubCs_);
 }
 
 // --- Order Posts ---
 
-void WebSocketManager::sendPendingPosts() {
+void WebSocketManager::sendPendingPosts(Connection& conn) {
     EnterCriticalSection(&postCs_);
     if (pendingPosts_.empty()) { LeaveCriticalSection(&postCs_); return; }
     auto post = pendingPosts_.front();
     pendingPosts_.pop();
     LeaveCriticalSection(&postCs_);
 
-    connection_.send(post.json.c_str());
+    conn.send(post.json.c_str());
 }
 
 OrderResponse WebSocketManager::sendOrderSync(const std::string& orderJson, DWORD timeoutMs) {
@@ -533,7 +976,8 @@ OrderResponse WebSocketManager::sendOrderSync(const std::string& orderJson, DWOR
     resp.requestId = 0;
     resp.success = false;
 
-    if (!connection_.isConnected()) {
+    bool standbyUp = standby_ && standby_->connection.isConnected();
+    if (!primary().connection.isConnected() && !standbyUp) {
         resp.error = "Not connected";
         return resp;
     }
@@ -579,9 +1023,13 @@ OrderResponse WebSocketManager::sendOrderSync(const std::string& orderJson, DWOR
 
 // --- Message Handling ---
 
-void WebSocketManager::handleMessage(const char* data, size_t len) {
+// Called on each pooled connection's thread; everything below must be
+// thread-safe (PriceCache and the account/response maps are locked).
+void WebSocketManager::handleMessage(Shard& shard, const char* data, size_t len) {
     // Parse JSON once to extract channel for routing
-    yyjson_doc* doc = yyjson_read(data, len, 0);
+    HL_LAT_BEGIN(parseStart);
+    yyjson_doc* doc = json::parse(data, len);
+    HL_LAT_END(Parse, parseStart);
     if (!doc) {
         if (diagLevel_ >= 2) logf(2, "WS: JSON parse failed (%zu bytes)", len);
         return;
@@ -590,36 +1038,81 @@ void WebSocketManager::handleMessage(const char* data, size_t len) {
     const char* channel = json::getStringPtr(root, "channel");
 
     if (channel) {
-        if (strcmp(channel, "l2Book") == 0) parseL2Book(data);
-        else if (strcmp(channel, "clearinghouseState") == 0) parseClearinghouseState(data);
-        else if (strcmp(channel, "openOrders") == 0) parseOpenOrders(data);
-        else if (strcmp(channel, "userFills") == 0) parseUserFills(data);
-        else if (strcmp(channel, "orderUpdates") == 0) parseOrderUpdates(data);
+        if (strcmp(channel, "l2Book") == 0) parseL2Book(shard, root);
+        else if (strcmp(channel, "clearinghouseState") == 0) {
+            std::string dex = parseClearinghouseState(data);
+            registry_.onData(shard.index, SubscriptionRegistry::makeKey(channel, dex.c_str()),
+                             GetTickCount());
+        }
+        else if (strcmp(channel, "openOrders") == 0) {
+            registry_.onData(shard.index, channel, GetTickCount());
+            parseOpenOrders(data);
+        }
+        else if (strcmp(channel, "userFills") == 0) {
+            registry_.onData(shard.index, channel, GetTickCount());
+            // The standby's subscribe snapshot repeats what the primary loaded
+            bool standbySnapshot = (&shard == standby_) &&
+                json::getBool(json::getObject(root, "data"), "isSnapshot");
+            if (standbySnapshot) duplicatesDropped_++;
+            else if (acceptFrame(data, len)) { shard.firstArrivals++; parseUserFills(data); }
+        }
+        else if (strcmp(channel, "orderUpdates") == 0) {
+            registry_.onData(shard.index, channel, GetTickCount());
+            if (acceptFrame(data, len)) { shard.firstArrivals++; parseOrderUpdates(data); }
+        }
+        else if (strcmp(channel, "activeAssetCtx") == 0 ||
+                 strcmp(channel, "activeSpotAssetCtx") == 0) {
+            AssetCtxUpdate update = hl::ws::parseActiveAssetCtx(root);
+            if (update.valid) {
+                registry_.onData(shard.index, update.coinId, "activeAssetCtx",
+                                 g_symbols.name(update.coinId), GetTickCount());
+                g_assetCtx.set(update.coinId, update.ctx, AssetCtxSource::Ws);
+            }
+        }
         else if (strcmp(channel, "post") == 0) parsePostResponse(data);
         else if (strcmp(channel, "pong") == 0) { /* expected, ignore */ }
         else if (strcmp(channel, "subscriptionResponse") == 0) {
-            if (diagLevel_ >= 2) logf(2, "WS: Subscription ACK (%zu bytes)", len);
+            // Echo of the subscription: {"method":"subscribe","subscription":{...}}
+            yyjson_val* sub = json::getObject(json::getObject(root, "data"), "subscription");
+            const char* type = json::getStringPtr(sub, "type");
+            const char* coin = json::getStringPtr(sub, "coin");
+            const char* dex = json::getStringPtr(sub, "dex");
+            if (type)
+                registry_.onAcked(shard.index,
+                                  SubscriptionRegistry::makeKey(type, coin ? coin : dex),
+                                  GetTickCount());
+            if (type && coin && strcmp(type, "l2Book") == 0) {
+                EnterCriticalSection(&l2SubCs_);
+                shard.l2Subs.onAck(coin);
+                LeaveCriticalSection(&l2SubCs_);
+            }
+            if (diagLevel_ >= 2)
+                logf(2, "WS[%d]: Subscription ACK %s %s", shard.index,
+                     type ? type : "?", coin ? coin : "");
         }
         else if (strcmp(channel, "error") == 0) {
             // Log subscription errors (previously silently discarded) [OPM-74]
             const char* errData = json::getStringPtr(root, "data");
-            logf(1, "WS ERROR from server: %s", errData ? errData : "(no details)");
-
-            // Reset account sub flags for retry on next iteration
-            EnterCriticalSection(&accountSubCs_);
-            if (subscribedClearinghouse_) {
-                pendingClearinghouseSub_ = true;
-                subscribedClearinghouse_ = false;
-            }
-            if (subscribedUserFills_) {
-                pendingUserFillsSub_ = true;
-                subscribedUserFills_ = false;
+            logf(1, "WS[%d] ERROR from server: %s", shard.index, errData ? errData : "(no details)");
+
+            // Reset account sub flags for retry on next iteration.
+            // Market-data connections carry no account channels.
+            if (shard.index == 0) {
+                EnterCriticalSection(&accountSubCs_);
+                if (subscribedClearinghouse_) {
+                    pendingClearinghouseSub_ = true;
+                    subscribedClearinghouse_ = false;
+                }
+                if (subscribedUserFills_) {
+                    pendingUserFillsSub_ = true;
+                    subscribedUserFills_ = false;
+                }
+                if (subscribedOpenOrders_) {
+                    pendingOpenOrdersSub_ = true;
+                    subscribedOpenOrders_ = false;
+                }
+                LeaveCriticalSection(&accountSubCs_);
             }
-            if (subscribedOpenOrders_) {
-                pendingOpenOrdersSub_ = true;
-                subscribedOpenOrders_ = false;
-            }
-            LeaveCriticalSection(&accountSubCs_);
         }
         else if (diagLevel_ >= 2) {
             logf(2, "WS: Unhandled channel '%s' (%zu bytes)", channel, len);
@@ -633,23 +1126,78 @@ void WebSocketManager::handleMessage(const char* data, size_t len) {
     yyjson_doc_free(doc);
 }
 
-void WebSocketManager::parseL2Book(const char* json) {
-    auto result = hl::ws::parseL2Book(json, diagLevel_, logCallback_);
+// --- First-Arrival Dedup (warm standby) ---
+
+// Books are ordered by exchange time: an update no newer than the last one
+// accepted for the coin already arrived on the other connection.
+bool WebSocketManager::acceptBook(uint32_t coinId, long long time) {
+    if (!standby_ || time <= 0 || !coinId) return true;
+    EnterCriticalSection(&dedupCs_);
+    if (coinId >= lastBookTime_.size()) lastBookTime_.resize(config::SYMBOL_MAX_IDS, 0);
+    long long& last = lastBookTime_[coinId];
+    bool fresh = time > last;
+    if (fresh) last = time;
+    LeaveCriticalSection(&dedupCs_);
+    if (!fresh) duplicatesDropped_++;
+    return fresh;
+}
+
+// orderUpdates/userFills carry no sequence number, but both connections
+// receive byte-identical frames for the same event — dedup on a hash of the
+// frame over a bounded window of recent frames.
+bool WebSocketManager::acceptFrame(const char* data, size_t len) {
+    if (!standby_) return true;
+    const size_t FRAME_WINDOW = 512;
+
+    unsigned long long h = 14695981039346656037ull;  // FNV-1a 64
+    for (size_t i = 0; i < len; ++i) {
+        h ^= (unsigned char)data[i];
+        h *= 1099511628211ull;
+    }
+
+    EnterCriticalSection(&dedupCs_);
+    bool fresh = frameSet_.insert(h).second;
+    if (fresh) {
+        if (frameRing_.size() < FRAME_WINDOW) {
+            frameRing_.push_back(h);
+        } else {
+            frameSet_.erase(frameRing_[frameRingPos_]);
+            frameRing_[frameRingPos_] = h;
+            frameRingPos_ = (frameRingPos_ + 1) % FRAME_WINDOW;
+        }
+    }
+    LeaveCriticalSection(&dedupCs_);
+    if (!fresh) duplicatesDropped_++;
+    return fresh;
+}
+
+// Steady state allocates nothing: the frame is parsed once by handleMessage
+// and the coin is carried as its symbol id from here on.
+void WebSocketManager::parseL2Book(Shard& shard, yyjson_val* root) {
+    auto result = hl::ws::parseL2Book(root, diagLevel_, logCallback_);
+    // Watermark per connection, before dedup — a standby feed is live too
+    if (result.coin[0])
+        registry_.onData(shard.index, result.coinId, "l2Book", result.coin, GetTickCount());
     if (result.valid) {
+        if (!acceptBook(result.coinId, result.time)) return;
+        shard.firstArrivals++;
+
+        HL_LAT_BEGIN(publishStart);
         // Log first data arrival per asset at level 1 (confirms WS flowing) [OPM-99]
-        bool isFirst = (cache_.getBid(result.coin) <= 0);
-        cache_.setBidAsk(result.coin, result.bid, result.ask);
+        bool isFirst = cache_.setBidAsk(result.coinId, result.bid, result.ask);
+        shared_.publish(result.coinId, result.coin, result.bid, result.ask);
+        HL_LAT_END(CachePublish, publishStart);
         if (isFirst && diagLevel_ >= 1)
             logf(1, "WS: l2Book LIVE %s bid=%.4f ask=%.4f", result.coin, result.bid, result.ask);
         else if (diagLevel_ >= 2)
             logf(2, "WS: l2Book %s bid=%.4f ask=%.4f", result.coin, result.bid, result.ask);
-        if (zorroWindow_) PostMessage(zorroWindow_, WM_APP + 1, 0, 0);
+        notifier_.onUpdate(result.coinId);
     } else if (result.coin[0]) {
         if (diagLevel_ >= 2) logf(2, "WS: l2Book %s INVALID bid=%.2f ask=%.2f", result.coin, result.bid, result.ask);
     }
 }
 
-void WebSocketManager::parseClearinghouseState(const char* json) {
+std::string WebSocketManager::parseClearinghouseState(const char* json) {
     // [OPM-218] If perpDex subscriptions exist, infer dex from coin names
     EnterCriticalSection(&accountSubCs_);
     bool hasPerpDexSubs = !subscribedClearinghouseDexes_.empty();
@@ -657,17 +1205,27 @@ void WebSocketManager::parseClearinghouseState(const char* json) {
 
     if (!hasPerpDexSubs) {
         hl::ws::parseClearinghouseState(cache_, json, diagLevel_, logCallback_);
-        return;
+        mirrorPositionsOnStandby();
+        return "";
     }
 
     std::string dex = inferDexFromPositions(json);
     hl::ws::parseClearinghouseState(cache_, json, diagLevel_, logCallback_, dex.c_str());
+    mirrorPositionsOnStandby();
+    return dex;
+}
+
+// Coins with open positions get their l2Book mirrored on the standby
+void WebSocketManager::mirrorPositionsOnStandby() {
+    if (!standby_) return;
+    for (const auto& pos : cache_.getAllPositions())
+        if (pos.size != 0) addStandbyCoin(pos.coin);
 }
 
 std::string WebSocketManager::inferDexFromPositions(const char* json) {
     // Extract first coin from assetPositions, look up in g_assets to find its dex.
     // Returns "" for main-dex, or perpDex name if coin belongs to a perpDex.
-    yyjson_doc* doc = yyjson_read(json, strlen(json), 0);
+    yyjson_doc* doc = json::parse(json, strlen(json));
     if (!doc) return "";
     yyjson_val* root = yyjson_doc_get_root(doc);
 
@@ -705,26 +1263,40 @@ void WebSocketManager::parseOpenOrders(const char* json) {
 }
 
 void WebSocketManager::parseUserFills(const char* json) {
-    hl::ws::parseUserFills(cache_, json, diagLevel_, logCallback_);
-
-    // Propagate fills to TradeMap via callback [OPM-87]
-    if (!fillNotifyCallback_) return;
+    std::vector<FillData> fills;
+    hl::ws::parseUserFillsList(json, fills, diagLevel_, logCallback_);
 
-    // Compute per-OID cumulative totals from all cached fills.
-    // Fires callback for each OID — the callback decides whether to update
-    // TradeMap (only if cumulative total >= current filledSize).
-    auto fills = cache_.getRecentFills(100);
-    std::map<std::string, std::pair<double, double>> totals;  // oid -> {totalSz, totalValue}
+    // Apply each fill once: replayed snapshots and standby copies are dropped
+    // by tid, so the cache and the per-order totals never double count
+    DWORD now = GetTickCount();
     for (const auto& f : fills) {
-        auto& t = totals[f.oid];
-        t.first += f.sz;
-        t.second += f.sz * f.px;
+        if (fillAgg_.addFill(f, now)) cache_.addFill(f);
     }
-    for (const auto& entry : totals) {
-        double avgPx = entry.second.first > 0
-            ? entry.second.second / entry.second.first : 0;
-        fillNotifyCallback_(entry.first.c_str(), entry.second.first, avgPx);
+
+    DWORD lastSweep = lastFillRetireAt_.load();
+    if (now - lastSweep >= (DWORD)config::FILL_AGG_RETIRE_CHECK_MS &&
+        lastFillRetireAt_.compare_exchange_strong(lastSweep, now)) {
+        int n = fillAgg_.retireIdle(now, (DWORD)config::FILL_AGG_IDLE_RETIRE_MS);
+        if (n > 0) logf(2, "WS: Parked or retired %d idle fill aggregates", n);
     }
+
+    // Propagate fills to TradeMap via callback [OPM-87]
+    // Only orders that received a new fill in this frame are notified.
+    if (!fillNotifyCallback_) {
+        fillAgg_.takeChanged();
+        return;
+    }
+    for (const auto& t : fillAgg_.takeChanged()) {
+        fillNotifyCallback_(t.oid.c_str(), t.filledSz, t.avgPx());
+    }
+}
+
+void WebSocketManager::retireFillOrder(const std::string& oid) {
+    fillAgg_.retire(oid);
+}
+
+void WebSocketManager::closeFillOrder(const std::string& oid) {
+    fillAgg_.close(oid);
 }
 
 void WebSocketManager::parseOrderUpdates(const char* json) {
@@ -745,19 +1317,51 @@ void WebSocketManager::parsePostResponse(const char* json) {
 }
 
 bool WebSocketManager::isCoinBanned(const std::string& coin) const {
-    // No lock needed — bannedL2Coins_ is only written from connectionLoop thread
-    // and read from main thread. Worst case: brief race returns false (safe).
-    return bannedL2Coins_.count(coin) > 0;
+    // Locked: pooled connection threads may ban coins concurrently [OPM-170]
+    EnterCriticalSection(&l2SubCs_);
+    bool banned = bannedL2Coins_.count(g_symbols.find(coin.c_str())) > 0;
+    LeaveCriticalSection(&l2SubCs_);
+    return banned;
+}
+
+// --- Subscription Registry ---
+
+SubStatus WebSocketManager::getL2Status(const std::string& coin) const {
+    return registry_.status(shardForCoin(coin).index,
+                            l2Key(coin), GetTickCount());
+}
+
+bool WebSocketManager::willReceiveL2Data(const std::string& coin) const {
+    if (servedByShared(coin)) return true;
+    std::string key = l2Key(coin);
+    DWORD now = GetTickCount();
+    if (registry_.willReceiveData(shardForCoin(coin).index, key, now)) return true;
+    return standby_ && standby_->connection.isConnected() &&
+           registry_.willReceiveData(standby_->index, key, now);
+}
+
+std::vector<SubscriptionInfo> WebSocketManager::getSubscriptionTable() const {
+    return registry_.snapshot(GetTickCount());
 }
 
 // --- Debug ---
 
-void WebSocketManager::forceDisconnectForTest() {
+void WebSocketManager::forceDisconnectForTest(int index) {
     // Force a disconnect without disabling auto-reconnect.
     // This simulates a server-side drop (code 1006 scenario).
     // IXWebSocket will auto-reconnect, triggering the wasReconnected() path.
-    log(1, "WS: DEBUG — forcing disconnect (auto-reconnect stays active)");
-    connection_.forceCloseForTest();
+    for (Shard* shard : shards_) {
+        if (index >= 0 && shard->index != index) continue;
+        logf(1, "WS[%d]: DEBUG — forcing disconnect (auto-reconnect stays active)", shard->index);
+        shard->connection.forceCloseForTest();
+    }
+}
+
+void WebSocketManager::replayMessage(int index, const char* data, size_t len) {
+    Shard* shard = (index >= 0 && index < (int)shards_.size()) ? shards_[index] : shards_[0];
+    shard->messages++;
+    shard->bytes += (long long)len;
+    handleMessage(*shard, data, len);
 }
 
 // --- Index Mappings ---
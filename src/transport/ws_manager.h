@@ -4,22 +4,92 @@
 // Part of Hyperliquid Plugin for Zorro
 //
 // LAYER: Transport
-// DEPENDENCIES: ws_connection.h, ws_price_cache.h
+// DEPENDENCIES: ws_connection.h, ws_price_cache.h, ws_sub_scheduler.h,
+//               ws_sub_registry.h
 // THREAD SAFETY: All public methods are thread-safe except start/stop
+//
+// CONNECTION POOL:
+//   Connection 0 (primary) always carries orderUpdates, account channels and
+//   order posts. With setMarketConnections(N > 0), l2Book subscriptions are
+//   spread over N additional connections by a stable hash of the coin. Each
+//   connection owns its thread, reconnect handling and circuit breaker, so a
+//   toxic coin or a dropped socket only resubscribes its own shard.
+//
+// WARM STANDBY:
+//   setStandbyEnabled(true) adds one more connection that stays subscribed to
+//   orderUpdates, userFills and l2Book of standby coins (open positions plus
+//   addStandbyCoin). Frames from both paths are merged first-arrival-wins:
+//   l2Book by exchange timestamp, orderUpdates/userFills by frame hash.
+//   When the primary drops, the standby keeps data (and order posts) flowing
+//   with no resubscribe gap.
+//
+// SUBSCRIPTION PACING:
+//   l2Book subscribe frames go through a per-connection SubscriptionScheduler
+//   (token bucket, setSubscriptionPacing). After a reconnect coins with open
+//   positions are resubscribed first, then coins with resting orders, then
+//   the rest. A coin counts as subscribed only once the server's
+//   subscriptionResponse arrives; unacked subscriptions are resent.
+//
+// SHARED PRICES:
+//   setSharedPricesEnabled(true) lets several instances on one box share one
+//   set of l2Book subscriptions through a SharedPriceTable. The process whose
+//   primary thread holds the publisher mutex subscribes every coin any
+//   instance requested and publishes its quotes; the others only request
+//   coins and read PriceCache through the table. A crashed publisher is
+//   replaced by the next instance; one that hangs makes the readers
+//   subscribe their own coins.
+//
+// GUI NOTIFICATIONS:
+//   Quote updates reach Zorro's window as WM_APP+1 through a GuiNotifier:
+//   one message in flight at a time, re-armed when Zorro reads prices
+//   (acknowledgeNotify from BrokerAsset), optionally rate-limited and
+//   restricted to coins with positions or open orders.
+//
+// SUBSCRIPTION REGISTRY:
+//   Every subscription (l2Book and account channels, per connection) is
+//   tracked requested -> sent -> acked -> first/last data with a message
+//   count. willReceiveL2Data() answers "will data come?" without touching
+//   PriceCache; getSubscriptionTable() exports the rows.
 //=============================================================================
 
 #pragma once
 
 #include "ws_connection.h"
 #include "ws_price_cache.h"
+#include "ws_sub_scheduler.h"
+#include "ws_sub_registry.h"
+#include "ws_fill_aggregator.h"
+#include "ws_shared_prices.h"
+#include "ws_gui_notifier.h"
+#include "../foundation/hl_log_ring.h"
 #include <queue>
+#include <vector>
 #include <map>
 #include <set>
 #include <atomic>
+#include <cstdint>
+
+struct yyjson_val;
 
 namespace hl {
 namespace ws {
 
+/// Per-connection health snapshot (see getConnectionHealth)
+struct ConnectionHealth {
+    int index = 0;                  // 0 = primary (account/post), 1..N = market data
+    bool standby = false;           // Warm-standby connection (last index)
+    bool connected = false;
+    bool circuitOpen = false;
+    int l2Subscriptions = 0;        // Active + pending l2Book subs on this connection
+    int l2Acked = 0;                // ...of which confirmed by subscriptionResponse
+    int l2Queued = 0;               // ...of which waiting for a pacing token
+    int reconnects = 0;             // Auto-reconnects since start()
+    long long messages = 0;         // Messages dispatched by this connection's thread
+    long long bytes = 0;            // Payload bytes received
+    long long firstArrivals = 0;    // Deduplicated frames this connection delivered first
+    int secondsSinceLastMessage = -1;  // -1 if nothing received yet
+};
+
 /// High-level WebSocket manager for Hyperliquid
 ///
 /// Orchestrates connection, subscriptions, and message parsing.
@@ -51,10 +121,14 @@ public:
     void start(const std::string& hostname, bool testnet = false);
     void stop();
     bool isRunning() const { return running_.load(); }
-    bool isConnected() const { return connection_.isConnected(); }
+    bool isConnected() const { return primary().connection.isConnected(); }
     bool isHealthy() const;
     int getSecondsSinceLastMessage() const;
 
+    /// Health of the connection that carries this coin's l2Book (primary when
+    /// the pool is disabled). Use for price-path decisions.
+    bool isHealthyForCoin(const std::string& coin) const;
+
     //=========================================================================
     // CONFIGURATION
     //=========================================================================
@@ -62,9 +136,64 @@ public:
     void setUserAddress(const std::string& address) { userAddress_ = address; }
     void setDiagLevel(int level);
     void setLogCallback(LogCallback cb);
-    void setZorroWindow(HWND hwnd) { zorroWindow_ = hwnd; }
+    void setZorroWindow(HWND hwnd) { notifier_.setWindow(hwnd); }
     void setOrderUpdateCallback(OrderUpdateCallback cb) { orderUpdateCallback_ = cb; }
 
+    /// Override the endpoint (default: Hyperliquid mainnet/testnet over wss).
+    /// hostname may include a port, e.g. "127.0.0.1:8765" for a local server.
+    void setEndpoint(const std::string& hostname, bool secure);
+
+    /// Number of dedicated market-data connections (0 = single connection).
+    /// Must be called before start(); clamped to WS_MAX_MARKET_CONNECTIONS.
+    void setMarketConnections(int count);
+    int getMarketConnections() const { return marketCount_; }
+
+    /// l2Book subscribe pacing per connection (token bucket). Safe at runtime.
+    void setSubscriptionPacing(double framesPerSec, int burst);
+
+    /// True once every l2Book subscription on every connection is acked
+    bool allSubscriptionsAcked() const;
+
+    //=========================================================================
+    // WARM STANDBY (redundant connection, first arrival wins)
+    //=========================================================================
+
+    /// Add/remove the warm-standby connection. Must be called before start().
+    void setStandbyEnabled(bool enable);
+    bool isStandbyEnabled() const { return standby_ != nullptr; }
+
+    /// Mirror a coin's l2Book on the standby (coins with open positions are
+    /// added automatically from clearinghouseState). No-op without standby.
+    void addStandbyCoin(const std::string& coin);
+
+    /// Frames dropped because the other connection delivered them first
+    long long getDuplicatesDropped() const { return duplicatesDropped_.load(); }
+
+    //=========================================================================
+    // SHARED PRICES (one process subscribes l2Book for every instance)
+    //=========================================================================
+
+    /// Publish or read l2Book quotes through the network's shared table.
+    /// Must be called before start(); falls back to direct subscriptions if
+    /// the table cannot be mapped.
+    void setSharedPricesEnabled(bool enable) { sharedRequested_ = enable; }
+    bool isSharedPricesEnabled() const { return sharedRequested_; }
+    SharedPriceStats getSharedPriceStats() const { return shared_.getStats(); }
+
+    //=========================================================================
+    // GUI NOTIFICATIONS (WM_APP+1 to the window set by setZorroWindow)
+    //=========================================================================
+
+    /// Minimum ms between two notifications (0 = one in flight is the only limit)
+    void setNotifyMinInterval(int ms) { notifier_.setMinInterval(ms); }
+    /// Notify only for coins with a position, an open order or a recent placement
+    void setNotifyTradedOnly(bool on) { notifier_.setTradedOnly(on); }
+    /// Coin of an order just placed: notify before the account feeds show it
+    void watchNotifyCoin(const std::string& coin);
+    /// Zorro is reading prices; call from its thread (BrokerAsset)
+    void acknowledgeNotify() { notifier_.acknowledge(); }
+    GuiNotifyStats getNotifyStats() const { return notifier_.getStats(); }
+
     // Fill notification callback (from userFills subscription) [OPM-87]
     // Called on WS connection thread — implementation must be thread-safe.
     // Parameters: oid, cumulative filled size, weighted avg fill price.
@@ -72,6 +201,29 @@ public:
                                         double avgFillPx);
     void setFillNotifyCallback(FillNotifyCallback cb) { fillNotifyCallback_ = cb; }
 
+    /// Order is complete — drop its fill totals; late/replayed fills are ignored
+    void retireFillOrder(const std::string& oid);
+
+    /// Order cancelled/rejected — its fill totals are dropped once no fill
+    /// has arrived for FILL_AGG_IDLE_RETIRE_MS
+    void closeFillOrder(const std::string& oid);
+
+    /// Fills dropped as already applied (snapshot replays, standby copies)
+    long long getFillDuplicatesDropped() const { return fillAgg_.duplicatesDropped(); }
+
+    //=========================================================================
+    // ORDER FEED (orderUpdates authority)
+    //=========================================================================
+
+    /// Bumped whenever orderUpdates may have missed events: a carrier
+    /// (primary or standby) reconnected while no other carrier was up.
+    /// Order state confirmed in an older epoch needs reconciliation.
+    uint32_t getOrderFeedEpoch() const { return orderFeedEpoch_.load(); }
+
+    /// True if a carrier is connected, its orderUpdates subscription is
+    /// acked and it received traffic within WS_HEALTH_THRESHOLD_SEC
+    bool isOrderFeedLive() const;
+
     //=========================================================================
     // SUBSCRIPTIONS (queue for sender thread)
     //=========================================================================
@@ -84,6 +236,10 @@ public:
     void subscribeOpenOrders();
     void subscribeAllAccountData();
 
+    /// Stream activeAssetCtx for a coin into g_assetCtx (primary connection,
+    /// resubscribed after a reconnect). Idempotent.
+    void subscribeAssetCtx(const std::string& coin);
+
     /// Signal that initial subscriptions are queued (unlocks sender thread)
     void markInitialSubscriptionsQueued() { initialSubsQueued_ = true; }
 
@@ -108,35 +264,118 @@ public:
     PriceCache& getPriceCache() { return cache_; }
 
     /// Debug: force WS disconnect to test auto-reconnect behavior [OPM-170]
-    void forceDisconnectForTest();
+    /// @param index Connection index (0 = primary, -1 = all connections)
+    void forceDisconnectForTest(int index = -1);
+
+    /// Dispatch a captured frame as if connection `index` had received it
+    /// (offline replay, see hl_capture.h). Works without start(); indexes
+    /// beyond the pool go to the primary. Call from one thread.
+    void replayMessage(int index, const char* data, size_t len);
+
+    /// Index of the connection carrying a coin's l2Book (0 when pool disabled)
+    int getConnectionIndexForCoin(const std::string& coin) const;
+
+    /// Snapshot health metrics for every connection in the pool
+    std::vector<ConnectionHealth> getConnectionHealth() const;
 
     /// Check if a coin was banned due to causing repeated disconnects [OPM-170]
     bool isCoinBanned(const std::string& coin) const;
 
+    /// Lifecycle state of the l2Book subscription on the coin's connection
+    SubStatus getL2Status(const std::string& coin) const;
+
+    /// False if no l2Book subscription can deliver data for this coin soon
+    /// (never requested, banned, or sent but never acked). O(1).
+    bool willReceiveL2Data(const std::string& coin) const;
+
+    /// All subscriptions on all connections (for HL_GET_WS_SUBSCRIPTIONS)
+    std::vector<SubscriptionInfo> getSubscriptionTable() const;
+
 private:
+    /// One physical connection of the pool. Each shard has its own thread
+    /// (sender thread removed in OPM-128 — IXWebSocket handles I/O), reconnect
+    /// handling and circuit breaker. l2Book lists are guarded by l2SubCs_.
+    struct Shard {
+        int index;
+        WebSocketManager* owner;
+        Connection connection;
+        HANDLE thread;
+
+        // l2Book subscriptions routed to this connection (queued/sent/acked)
+        SubscriptionScheduler l2Subs;
+
+        // Toxic subscription tracking — coins that cause disconnects [OPM-170]
+        std::map<uint32_t, int> l2RequeueFailCount;     // g_symbols id -> reconnects without data
+
+        // Circuit breaker — stops reconnect storm after consecutive failures
+        int consecutiveReconnects;
+        bool circuitOpen;
+        DWORD circuitOpenedAt;
+
+        // Health metrics (written by this shard's thread, read by anyone)
+        std::atomic<int> totalReconnects;
+        std::atomic<long long> messages;
+        std::atomic<long long> bytes;
+        std::atomic<long long> firstArrivals;
+
+        Shard(int idx, WebSocketManager* mgr)
+            : index(idx), owner(mgr), thread(NULL),
+              consecutiveReconnects(0), circuitOpen(false), circuitOpenedAt(0),
+              totalReconnects(0), messages(0), bytes(0), firstArrivals(0) {
+            connection.setCaptureId(idx);
+        }
+    };
+
     // Core components
     PriceCache& cache_;
-    Connection connection_;
-
-    // Thread management (sender thread removed in OPM-128 — IXWebSocket handles I/O)
-    HANDLE connectionThread_;
+    std::vector<Shard*> shards_;  // [0] = primary, [1..N] = market data, [N+1] = standby
+    int marketCount_;
+    Shard* standby_;              // nullptr unless setStandbyEnabled(true)
+    bool standbyRequested_;
+    double subRate_;
+    int subBurst_;
+    void rebuildShards();
+
+    Shard& primary() { return *shards_[0]; }
+    const Shard& primary() const { return *shards_[0]; }
+    Shard& shardForCoin(const std::string& coin);
+    const Shard& shardForCoin(const std::string& coin) const;
+
+    // Shared prices: table mapped by start(); publisher role taken and
+    // released by the primary thread (syncSharedPrices)
+    bool sharedRequested_;
+    SharedPriceTable shared_;
+    std::atomic<bool> sharedLocalFallback_;  // Publisher silent: subscribe own coins
+    std::set<std::string> sharedCoins_;      // Coins requested through the table (l2SubCs_)
+    DWORD sharedCheckAt_;                    // Last takeover attempt (primary thread)
+    bool sharedFeedDown_;                    // No heartbeat: l2Book feed down (primary thread)
+    void syncSharedPrices();
+    bool marketFeedConnected() const;
+    bool servedByShared(const std::string& coin) const;
+
+    // GUI notifications: posts from parseL2Book, trailing posts and the
+    // traded-only watch list from the primary thread (tickNotify)
+    GuiNotifier notifier_;
+    DWORD notifyWatchAt_;
+    void tickNotify();
+
+    // Thread management
     HANDLE shutdownEvent_;
     std::atomic<bool> running_;
 
     // Configuration
     std::string hostname_;
+    std::string endpointHost_;    // Empty = derive from testnet_
+    bool endpointSecure_;
     bool testnet_;
     std::string userAddress_;
-    HWND zorroWindow_;
     int diagLevel_;
     LogCallback logCallback_;
     OrderUpdateCallback orderUpdateCallback_;
     FillNotifyCallback fillNotifyCallback_;
 
-    // l2Book subscriptions
-    CRITICAL_SECTION l2SubCs_;
-    std::vector<std::string> l2Subscriptions_;
-    std::vector<std::string> pendingL2Subs_;
+    // l2Book subscriptions (per-shard lists live in Shard)
+    mutable CRITICAL_SECTION l2SubCs_;
 
     // Account subscriptions
     CRITICAL_SECTION accountSubCs_;
@@ -152,20 +391,41 @@ private:
     std::set<std::string> subscribedClearinghouseDexes_;
     std::vector<std::string> pendingClearinghouseDexSubs_;
 
+    // activeAssetCtx streams, sent with the account channels (accountSubCs_)
+    std::set<std::string> subscribedAssetCtx_;
+    std::vector<std::string> pendingAssetCtxSubs_;
+
     // Order post queue
     CRITICAL_SECTION postCs_;
     struct PendingPost { int id; std::string json; };
     std::queue<PendingPost> pendingPosts_;
     std::atomic<int> nextRequestId_;
 
-    // Circuit breaker — stops reconnect storm after consecutive failures
-    int consecutiveReconnects_;
-    bool circuitOpen_;
-    DWORD circuitOpenedAt_;
+    // Subscription lifecycle/watermarks, all channels (own lock)
+    SubscriptionRegistry registry_;
+
+    // Per-order fill totals from userFills (own lock)
+    FillAggregator fillAgg_;
+    std::atomic<DWORD> lastFillRetireAt_;   // Primary and standby both deliver userFills
+
+    // Order-feed gap counter (see getOrderFeedEpoch)
+    std::atomic<uint32_t> orderFeedEpoch_;
+
+    // Coins permanently dropped from subscriptions [OPM-170] (guarded by l2SubCs_)
+    std::set<uint32_t> bannedL2Coins_;                // g_symbols ids
+
+    // Standby l2Book coins (guarded by l2SubCs_)
+    std::set<std::string> standbyCoins_;
 
-    // Toxic subscription tracking — coins that cause disconnects [OPM-170]
-    std::map<std::string, int> l2RequeueFailCount_;
-    std::set<std::string> bannedL2Coins_;  // Coins permanently dropped from subscriptions
+    // First-arrival dedup between primary/market connections and the standby
+    CRITICAL_SECTION dedupCs_;
+    std::vector<long long> lastBookTime_;             // g_symbols id -> newest exchange time
+    std::vector<unsigned long long> frameRing_;       // Recent frame hashes (FIFO eviction)
+    std::set<unsigned long long> frameSet_;
+    size_t frameRingPos_;
+    std::atomic<long long> duplicatesDropped_;
+    bool acceptBook(uint32_t coinId, long long time);
+    bool acceptFrame(const char* data, size_t len);
 
     // Response correlation
     CRITICAL_SECTION responseCs_;
@@ -178,13 +438,15 @@ private:
 
     // Thread functions
     static DWORD WINAPI ConnectionThreadProc(LPVOID param);
-    void connectionLoop();
+    void connectionLoop(Shard& shard);
+    bool connectShard(Shard& shard);
 
     // Message handling
-    void handleMessage(const char* data, size_t len);
-    void parseL2Book(const char* json);
-    void parseClearinghouseState(const char* json);
+    void handleMessage(Shard& shard, const char* data, size_t len);
+    void parseL2Book(Shard& shard, yyjson_val* root);   // root of the dispatched frame
+    std::string parseClearinghouseState(const char* json);  // Returns dex ("" = main)
     std::string inferDexFromPositions(const char* json);  // [OPM-218]
+    void mirrorPositionsOnStandby();
     void parseOpenOrders(const char* json);
     void parseUserFills(const char* json);
     void parseOrderUpdates(const char* json);
@@ -192,14 +454,20 @@ private:
 
     // Subscription helpers
     void subscribeInitialChannels();
-    void sendPendingL2Subscriptions();
+    void subscribeStandbyChannels(Shard& shard);
+    void sendPendingL2Subscriptions(Shard& shard);
     void sendPendingAccountSubscriptions();
-    void sendPendingPosts();
-    void requeueSubscriptionsAfterReconnect();
+    void sendPendingPosts(Connection& conn);
+    void requeueSubscriptionsAfterReconnect(Shard& shard);
+    int subscriptionPriority(const std::string& coin);
+    std::map<std::string, int> subscriptionPriorities();
 
-    // Logging
+    // Logging (deferred through g_logRing off Zorro's thread)
     void log(int minLevel, const char* msg);
-    void logf(int minLevel, const char* fmt, ...);
+    template <class... A>
+    void logf(int minLevel, const char* fmt, const A&... args) {
+        if (logCallback_ && diagLevel_ >= minLevel) logPrintf(logCallback_, fmt, args...);
+    }
 };
 
 } // namespace ws
@@ -14,6 +14,7 @@
 
 #include "ws_parsers.h"
 #include "json_helpers.h"
+#include "../foundation/hl_log_ring.h"
 #include <cstdio>
 #include <cstring>
 #include <cstdlib>
@@ -25,15 +26,25 @@ namespace ws {
 // HELPERS
 //=============================================================================
 
+// Deferred through g_logRing when called on a WS thread
+template <class... A>
 static void logMsg(int diagLevel, LogCallback logCb, int minLevel,
-                   const char* fmt, ...) {
+                   const char* fmt, const A&... args) {
     if (!logCb || diagLevel < minLevel) return;
-    char buf[512];
-    va_list args;
-    va_start(args, fmt);
-    vsnprintf(buf, sizeof(buf), fmt, args);
-    va_end(args);
-    logCb(buf);
+    logPrintf(logCb, fmt, args...);
+}
+
+// Ids (oid, tid) arrive as numbers on the wire, strings in some responses
+static bool getId(yyjson_val* obj, const char* key, char* out, size_t outSize) {
+    yyjson_val* item = yyjson_obj_get(obj, key);
+    if (!item) return false;
+    if (yyjson_is_str(item))
+        strncpy_s(out, outSize, yyjson_get_str(item), _TRUNCATE);
+    else if (yyjson_is_int(item))
+        snprintf(out, outSize, "%llu", (unsigned long long)yyjson_get_uint(item));
+    else
+        return false;
+    return true;
 }
 
 //=============================================================================
@@ -41,14 +52,18 @@ static void logMsg(int diagLevel, LogCallback logCb, int minLevel,
 //=============================================================================
 
 L2BookUpdate parseL2Book(const char* jsonStr, int diagLevel, LogCallback logCb) {
-    L2BookUpdate result;
-
-    yyjson_doc* doc = yyjson_read(jsonStr, strlen(jsonStr), 0);
+    yyjson_doc* doc = json::parse(jsonStr, strlen(jsonStr));
     if (!doc) {
         logMsg(diagLevel, logCb, 2, "WS parseL2Book: JSON parse error");
-        return result;
+        return L2BookUpdate();
     }
-    yyjson_val* root = yyjson_doc_get_root(doc);
+    L2BookUpdate result = parseL2Book(yyjson_doc_get_root(doc), diagLevel, logCb);
+    yyjson_doc_free(doc);
+    return result;
+}
+
+L2BookUpdate parseL2Book(yyjson_val* root, int diagLevel, LogCallback logCb) {
+    L2BookUpdate result;
 
     // Navigate: root.data (WS path) or root directly (HTTP path)
     yyjson_val* data = json::getObject(root, "data");
@@ -57,15 +72,17 @@ L2BookUpdate parseL2Book(const char* jsonStr, int diagLevel, LogCallback logCb)
     // Extract coin name
     if (!json::getString(bookObj, "coin", result.coin, sizeof(result.coin))) {
         logMsg(diagLevel, logCb, 2, "WS parseL2Book: no coin field");
-        yyjson_doc_free(doc);
         return result;
     }
+    result.coinId = g_symbols.intern(result.coin);
+
+    // Exchange timestamp — used to drop duplicate books from a standby connection
+    result.time = json::getInt64(bookObj, "time");
 
     // Extract bid/ask from levels: [[{px,sz,...},...],[{px,sz,...},...]]
     yyjson_val* levels = json::getArray(bookObj, "levels");
     if (!levels) {
         logMsg(diagLevel, logCb, 2, "WS parseL2Book: no levels array");
-        yyjson_doc_free(doc);
         return result;
     }
 
@@ -83,8 +100,33 @@ L2BookUpdate parseL2Book(const char* jsonStr, int diagLevel, LogCallback logCb)
     }
 
     result.valid = (result.bid > 0 && result.ask > 0);
+    return result;
+}
 
-    yyjson_doc_free(doc);
+//=============================================================================
+// parseActiveAssetCtx
+//=============================================================================
+
+void readAssetCtx(yyjson_val* ctxObj, AssetCtx& out) {
+    out.funding = json::getDouble(ctxObj, "funding");
+    out.markPx = json::getDouble(ctxObj, "markPx");
+    out.oraclePx = json::getDouble(ctxObj, "oraclePx");
+    out.midPx = json::getDouble(ctxObj, "midPx");
+    out.prevDayPx = json::getDouble(ctxObj, "prevDayPx");
+    out.openInterest = json::getDouble(ctxObj, "openInterest");
+    out.dayNtlVlm = json::getDouble(ctxObj, "dayNtlVlm");
+    out.dayBaseVlm = json::getDouble(ctxObj, "dayBaseVlm");
+}
+
+AssetCtxUpdate parseActiveAssetCtx(yyjson_val* root) {
+    AssetCtxUpdate result;
+    yyjson_val* data = json::getObject(root, "data");
+    yyjson_val* ctxObj = json::getObject(data, "ctx");
+    if (!ctxObj) return result;
+    result.coinId = g_symbols.find(json::getStringPtr(data, "coin"));
+    if (!result.coinId) return result;
+    readAssetCtx(ctxObj, result.ctx);
+    result.valid = true;
     return result;
 }
 
@@ -95,7 +137,7 @@ L2BookUpdate parseL2Book(const char* jsonStr, int diagLevel, LogCallback logCb)
 OrderResponse parsePostResponse(const char* jsonStr, int diagLevel, LogCallback logCb) {
     OrderResponse result;
 
-    yyjson_doc* doc = yyjson_read(jsonStr, strlen(jsonStr), 0);
+    yyjson_doc* doc = json::parse(jsonStr, strlen(jsonStr));
     if (!doc) {
         logMsg(diagLevel, logCb, 2, "WS parsePostResponse: JSON parse error");
         return result;
@@ -152,7 +194,7 @@ OrderResponse parsePostResponse(const char* jsonStr, int diagLevel, LogCallback
 void parseClearinghouseState(PriceCache& cache, const char* jsonStr,
                              int diagLevel, LogCallback logCb,
                              const char* dex) {
-    yyjson_doc* doc = yyjson_read(jsonStr, strlen(jsonStr), 0);
+    yyjson_doc* doc = json::parse(jsonStr, strlen(jsonStr));
     if (!doc) {
         logMsg(diagLevel, logCb, 1, "WS clearinghouseState: JSON parse error");
         return;
@@ -166,10 +208,12 @@ void parseClearinghouseState(PriceCache& cache, const char* jsonStr,
     if (!state) state = root;
 
     // --- Parse asset positions ---
-    // [OPM-212] Clear only positions from THIS dex, not all dexes.
+    // [OPM-212] Replace only positions from THIS dex, not all dexes.
     // Each clearinghouseState response contains positions for one dex only.
+    // The book is built here and published whole, so readers never see it
+    // empty or half filled.
     std::string dexStr = dex ? dex : "";
-    cache.clearPositionsByDex(dexStr);
+    std::vector<PositionData> book;
 
     yyjson_val* positions = json::getArray(state, "assetPositions");
     size_t idx, max;
@@ -218,13 +262,14 @@ void parseClearinghouseState(PriceCache& cache, const char* jsonStr,
 
         if (!pos.coin.empty()) {
             pos.dex = dexStr;  // [OPM-212] Tag position with its dex
-            cache.setPosition(pos);
             logMsg(diagLevel, logCb, 2,
                    "WS clearinghouseState: %s size=%.6f entry=%.2f pnl=%.2f dex=%s",
                    pos.coin.c_str(), pos.size, pos.entryPx, pos.unrealizedPnl,
                    dexStr.empty() ? "main" : dexStr.c_str());
+            book.push_back(std::move(pos));
         }
     }
+    cache.publishPositions(dexStr, book);
 
     // --- Parse account totals from marginSummary / crossMarginSummary ---
     // marginSummary = aggregate (cross + isolated positions)
@@ -273,11 +318,12 @@ void parseClearinghouseState(PriceCache& cache, const char* jsonStr,
 
 void parseOpenOrders(PriceCache& cache, const char* jsonStr,
                      int diagLevel, LogCallback logCb) {
-    yyjson_doc* doc = yyjson_read(jsonStr, strlen(jsonStr), 0);
+    yyjson_doc* doc = json::parse(jsonStr, strlen(jsonStr));
     if (!doc) return;
     yyjson_val* root = yyjson_doc_get_root(doc);
 
-    cache.clearOpenOrders();
+    // Built here and published whole (replaces the previous book)
+    std::vector<OpenOrderData> book;
 
     // WS path: root.data.orders (or root.data is the array directly)
     // The format is: {"channel":"openOrders","data":{"dex":"","user":"...","orders":[...]}}
@@ -312,13 +358,14 @@ void parseOpenOrders(PriceCache& cache, const char* jsonStr,
         order.origSz  = json::getDouble(orderItem, "origSz");
 
         if (!order.oid.empty() && !order.coin.empty()) {
-            cache.setOpenOrder(order);
             logMsg(diagLevel, logCb, 2,
                    "WS openOrders: %s %s %s %.6f @ %.2f",
                    order.coin.c_str(), order.isBuy ? "BUY" : "SELL",
                    order.oid.c_str(), order.sz, order.limitPx);
+            book.push_back(std::move(order));
         }
     }
+    cache.publishOpenOrders(book);
 
     yyjson_doc_free(doc);
 }
@@ -327,9 +374,9 @@ void parseOpenOrders(PriceCache& cache, const char* jsonStr,
 // parseUserFills
 //=============================================================================
 
-void parseUserFills(PriceCache& cache, const char* jsonStr,
-                    int diagLevel, LogCallback logCb) {
-    yyjson_doc* doc = yyjson_read(jsonStr, strlen(jsonStr), 0);
+void parseUserFillsList(const char* jsonStr, std::vector<FillData>& out,
+                        int diagLevel, LogCallback logCb) {
+    yyjson_doc* doc = json::parse(jsonStr, strlen(jsonStr));
     if (!doc) return;
     yyjson_val* root = yyjson_doc_get_root(doc);
 
@@ -347,11 +394,11 @@ void parseUserFills(PriceCache& cache, const char* jsonStr,
         FillData fill;
         char buf[64];
 
-        if (json::getString(fillItem, "oid", buf, sizeof(buf)))
+        if (getId(fillItem, "oid", buf, sizeof(buf)))
             fill.oid = buf;
         if (json::getString(fillItem, "coin", buf, sizeof(buf)))
             fill.coin = buf;
-        if (json::getString(fillItem, "tid", buf, sizeof(buf)))
+        if (getId(fillItem, "tid", buf, sizeof(buf)))
             fill.tid = buf;
 
         // side
@@ -367,17 +414,24 @@ void parseUserFills(PriceCache& cache, const char* jsonStr,
         fill.time = json::getInt64(fillItem, "time");
 
         if (!fill.oid.empty() && fill.sz > 0) {
-            cache.addFill(fill);
             logMsg(diagLevel, logCb, 2,
                    "WS userFill: %s %s %.6f @ %.2f (oid=%s)",
                    fill.coin.c_str(), fill.isBuy ? "BUY" : "SELL",
                    fill.sz, fill.px, fill.oid.c_str());
+            out.push_back(fill);
         }
     }
 
     yyjson_doc_free(doc);
 }
 
+void parseUserFills(PriceCache& cache, const char* jsonStr,
+                    int diagLevel, LogCallback logCb) {
+    std::vector<FillData> fills;
+    parseUserFillsList(jsonStr, fills, diagLevel, logCb);
+    for (const auto& fill : fills) cache.addFill(fill);
+}
+
 //=============================================================================
 // parseOrderUpdates
 //=============================================================================
@@ -386,7 +440,7 @@ void parseOrderUpdates(const char* jsonStr, OrderUpdateCallback callback,
                        int diagLevel, LogCallback logCb) {
     if (!callback) return;
 
-    yyjson_doc* doc = yyjson_read(jsonStr, strlen(jsonStr), 0);
+    yyjson_doc* doc = json::parse(jsonStr, strlen(jsonStr));
     if (!doc) {
         logMsg(diagLevel, logCb, 2, "WS parseOrderUpdates: JSON parse error");
         return;
@@ -13,12 +13,17 @@
 // - openOrders: resting orders snapshot
 // - userFills: trade fill events
 // - post response: order confirmation/rejection
+// - activeAssetCtx / activeSpotAssetCtx: funding, mark, oracle, OI, volume
 //=============================================================================
 
 #pragma once
 
 #include "ws_price_cache.h"
 #include "ws_types.h"
+#include "../foundation/hl_asset_ctx.h"
+#include <vector>
+
+struct yyjson_val;
 
 namespace hl {
 namespace ws {
@@ -26,16 +31,40 @@ namespace ws {
 /// Parsed L2Book price update (returned by parseL2Book)
 struct L2BookUpdate {
     char coin[64];
+    uint32_t coinId;    // g_symbols id of coin (0 if no coin)
     double bid;
     double ask;
+    long long time;     // Exchange timestamp (ms), 0 if absent
     bool valid;
-    L2BookUpdate() : bid(0), ask(0), valid(false) { coin[0] = 0; }
+    L2BookUpdate() : coinId(0), bid(0), ask(0), time(0), valid(false) { coin[0] = 0; }
 };
 
 /// Parse l2Book channel message, extracting coin + top-of-book bid/ask
-/// Format: {"channel":"l2Book","data":{"coin":"BTC","levels":[[{"px":"50000",...}],[{"px":"50001",...}]]}}
+/// Format: {"channel":"l2Book","data":{"coin":"BTC","time":1700000000000,"levels":[[{"px":"50000",...}],[{"px":"50001",...}]]}}
 L2BookUpdate parseL2Book(const char* json, int diagLevel, LogCallback logCb);
 
+/// Same, on a document the caller already parsed (WS dispatch reads each
+/// frame once). Does not allocate once the coin has been interned.
+L2BookUpdate parseL2Book(yyjson_val* root, int diagLevel, LogCallback logCb);
+
+/// Parsed activeAssetCtx / activeSpotAssetCtx push
+struct AssetCtxUpdate {
+    uint32_t coinId;    // g_symbols id of data.coin (0 if unknown coin)
+    AssetCtx ctx;
+    bool valid;
+    AssetCtxUpdate() : coinId(0), valid(false) {}
+};
+
+/// Read one asset context object (WS "ctx", or an element of the second
+/// array of a metaAndAssetCtxs / spotMetaAndAssetCtxs response).
+/// Numbers arrive as strings; absent fields stay 0.
+void readAssetCtx(yyjson_val* ctxObj, AssetCtx& out);
+
+/// Parse activeAssetCtx / activeSpotAssetCtx on an already parsed frame.
+/// Only coins known to g_symbols are reported (no interning).
+/// Format: {"channel":"activeAssetCtx","data":{"coin":"BTC","ctx":{"funding":"0.0000125","markPx":"97000.0",...}}}
+AssetCtxUpdate parseActiveAssetCtx(yyjson_val* root);
+
 /// Parse post/order response from WebSocket
 /// Extracts requestId, success/error, and filled/resting status
 /// Format: {"channel":"post","data":{"id":123,"response":{...}}}
@@ -61,6 +90,11 @@ void parseOpenOrders(PriceCache& cache, const char* json,
 void parseUserFills(PriceCache& cache, const char* json,
                     int diagLevel, LogCallback logCb);
 
+/// Parse userFills into a list without touching the cache (caller decides
+/// which fills are new — see FillAggregator). Zero-size fills are skipped.
+void parseUserFillsList(const char* json, std::vector<FillData>& out,
+                        int diagLevel, LogCallback logCb);
+
 /// Parse orderUpdates subscription message
 /// Calls callback for each order status change (filled, canceled, etc.)
 /// Format: {"channel":"orderUpdates","data":[{"order":{...},"status":"filled",...},...]}
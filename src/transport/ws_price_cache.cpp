@@ -8,6 +8,7 @@
 //=============================================================================
 
 #include "ws_price_cache.h"
+#include "ws_shared_prices.h"
 
 namespace hl {
 namespace ws {
@@ -16,9 +17,10 @@ namespace ws {
 // CONSTRUCTION / DESTRUCTION
 //=============================================================================
 
-PriceCache::PriceCache()
-    : lastOpenOrdersUpdate_(0), lastPositionsUpdate_(0) {
+PriceCache::PriceCache(size_t fillCapacity)
+    : shared_(nullptr), fills_(fillCapacity), lastOpenOrdersUpdate_(0), lastPositionsUpdate_(0) {
     InitializeCriticalSection(&cs_);
+    InitializeConditionVariable(&firstQuoteCv_);
 }
 
 PriceCache::~PriceCache() {
@@ -29,75 +31,98 @@ PriceCache::~PriceCache() {
 // PRICE DATA
 //=============================================================================
 
+const PriceData* PriceCache::priceLocked(uint32_t coinId) const {
+    return (coinId != 0 && coinId < prices_.size()) ? &prices_[coinId] : nullptr;
+}
+
+PriceData& PriceCache::priceSlotLocked(uint32_t coinId) {
+    if (coinId >= prices_.size()) {
+        size_t n = prices_.size() < 64 ? 64 : prices_.size();
+        while (n <= coinId) n *= 2;
+        prices_.resize(n);
+    }
+    return prices_[coinId];
+}
+
 void PriceCache::setPrice(const std::string& coin, double price) {
+    uint32_t id = g_symbols.intern(coin.c_str());
+    if (!id) return;
     EnterCriticalSection(&cs_);
-    prices_[coin].mid = price;
-    prices_[coin].timestamp = GetTickCount();
+    PriceData& p = priceSlotLocked(id);
+    p.mid = price;
+    p.timestamp = GetTickCount();
     LeaveCriticalSection(&cs_);
 }
 
 void PriceCache::setBidAsk(const std::string& coin, double bid, double ask) {
+    setBidAsk(g_symbols.intern(coin.c_str()), bid, ask);
+}
+
+bool PriceCache::setBidAsk(uint32_t coinId, double bid, double ask) {
+    if (!coinId) return false;
     EnterCriticalSection(&cs_);
-    prices_[coin].bid = bid;
-    prices_[coin].ask = ask;
-    prices_[coin].mid = (bid + ask) / 2.0;
-    prices_[coin].timestamp = GetTickCount();
+    PriceData& p = priceSlotLocked(coinId);
+    bool firstQuote = (p.bid <= 0.0 || p.ask <= 0.0) && bid > 0.0 && ask > 0.0;
+    p.bid = bid;
+    p.ask = ask;
+    p.mid = (bid + ask) / 2.0;
+    p.timestamp = GetTickCount();
+    // Only the empty -> quoted transition wakes waiters; steady-state updates
+    // pay nothing beyond the compare above
+    if (firstQuote) WakeAllConditionVariable(&firstQuoteCv_);
     LeaveCriticalSection(&cs_);
+    return firstQuote;
 }
 
 double PriceCache::getPrice(const std::string& coin) const {
-    EnterCriticalSection(&cs_);
-    double price = 0.0;
-    auto it = prices_.find(coin);
-    if (it != prices_.end()) {
-        price = it->second.mid;
-    }
-    LeaveCriticalSection(&cs_);
-    return price;
+    return getPriceData(g_symbols.find(coin.c_str())).mid;
 }
 
 double PriceCache::getBid(const std::string& coin) const {
+    return getBid(g_symbols.find(coin.c_str()));
+}
+
+double PriceCache::getBid(uint32_t coinId) const {
+    if (shared_.load(std::memory_order_acquire)) return getPriceData(coinId).bid;
     EnterCriticalSection(&cs_);
-    double bid = 0.0;
-    auto it = prices_.find(coin);
-    if (it != prices_.end()) {
-        bid = it->second.bid;
-    }
+    const PriceData* p = priceLocked(coinId);
+    double bid = p ? p->bid : 0.0;
     LeaveCriticalSection(&cs_);
     return bid;
 }
 
 double PriceCache::getAsk(const std::string& coin) const {
-    EnterCriticalSection(&cs_);
-    double ask = 0.0;
-    auto it = prices_.find(coin);
-    if (it != prices_.end()) {
-        ask = it->second.ask;
-    }
-    LeaveCriticalSection(&cs_);
-    return ask;
+    return getPriceData(g_symbols.find(coin.c_str())).ask;
 }
 
 PriceData PriceCache::getPriceData(const std::string& coin) const {
+    return getPriceData(g_symbols.find(coin.c_str()));
+}
+
+PriceData PriceCache::getPriceData(uint32_t coinId, DWORD* age) const {
     EnterCriticalSection(&cs_);
     PriceData data;
-    auto it = prices_.find(coin);
-    if (it != prices_.end()) {
-        data = it->second;
-    }
+    const PriceData* p = priceLocked(coinId);
+    if (p) data = *p;
     LeaveCriticalSection(&cs_);
+    const SharedPriceTable* shared = shared_.load(std::memory_order_acquire);
+    if (shared) {
+        PriceData published;
+        if (shared->read(coinId, &published) &&
+            (data.timestamp == 0 || (int)(published.timestamp - data.timestamp) > 0))
+            data = published;
+    }
+    if (age) {
+        DWORD now = GetTickCount();
+        *age = data.timestamp == 0 ? MAXDWORD
+             : (now >= data.timestamp) ? (now - data.timestamp) : 0;
+    }
     return data;
 }
 
 DWORD PriceCache::getAge(const std::string& coin) const {
-    EnterCriticalSection(&cs_);
-    DWORD age = MAXDWORD;
-    auto it = prices_.find(coin);
-    if (it != prices_.end() && it->second.timestamp > 0) {
-        DWORD now = GetTickCount();
-        age = (now >= it->second.timestamp) ? (now - it->second.timestamp) : 0;
-    }
-    LeaveCriticalSection(&cs_);
+    DWORD age;
+    getPriceData(g_symbols.find(coin.c_str()), &age);
     return age;
 }
 
@@ -105,6 +130,49 @@ bool PriceCache::isFresh(const std::string& coin, DWORD maxAgeMs) const {
     return getAge(coin) < maxAgeMs;
 }
 
+bool PriceCache::waitForBidAsk(const std::string& coin, DWORD timeoutMs) const {
+    std::vector<std::string> coins(1, coin);
+    return waitForBidAsk(coins, timeoutMs) == 1;
+}
+
+void PriceCache::setSharedSource(const SharedPriceTable* table) {
+    shared_.store(table, std::memory_order_release);
+}
+
+int PriceCache::waitForBidAsk(const std::vector<std::string>& coins, DWORD timeoutMs) const {
+    DWORD start = GetTickCount();
+    // Quotes from another process signal nothing here: poll those briefly
+    const SharedPriceTable* shared = shared_.load(std::memory_order_acquire);
+    // Interned up front: a coin's first quote must land on the id waited on
+    std::vector<uint32_t> pending;
+    pending.reserve(coins.size());
+    for (const auto& c : coins) pending.push_back(g_symbols.intern(c.c_str()));
+
+    EnterCriticalSection(&cs_);
+    for (;;) {
+        // Drop coins that have a quote; the rest keep waiting
+        size_t w = 0;
+        for (size_t i = 0; i < pending.size(); ++i) {
+            const PriceData* p = priceLocked(pending[i]);
+            bool quoted = p && p->bid > 0.0 && p->ask > 0.0;
+            PriceData published;
+            if (!quoted && shared && shared->read(pending[i], &published))
+                quoted = published.bid > 0.0 && published.ask > 0.0;
+            if (!quoted) pending[w++] = pending[i];
+        }
+        pending.resize(w);
+        if (pending.empty()) break;
+
+        DWORD elapsed = GetTickCount() - start;
+        if (elapsed >= timeoutMs) break;
+        DWORD wait = timeoutMs - elapsed;
+        if (shared && wait > (DWORD)config::SHM_WAIT_POLL_MS) wait = config::SHM_WAIT_POLL_MS;
+        SleepConditionVariableCS(&firstQuoteCv_, &cs_, wait);
+    }
+    LeaveCriticalSection(&cs_);
+    return (int)(coins.size() - pending.size());
+}
+
 //=============================================================================
 // ACCOUNT DATA
 //=============================================================================
@@ -148,67 +216,120 @@ DWORD PriceCache::getAccountDataAge() const {
 //=============================================================================
 // POSITION DATA
 //=============================================================================
+// Books are built off-lock; the lock only guards the pointer swap/copy.
+
+namespace {
+
+const PositionSnapshot& emptyPositionBook() {
+    static const PositionSnapshot empty = std::make_shared<const PositionBook>();
+    return empty;
+}
+
+const OpenOrderSnapshot& emptyOpenOrderBook() {
+    static const OpenOrderSnapshot empty = std::make_shared<const OpenOrderBook>();
+    return empty;
+}
+
+// Book a position belongs to: its dex tag, else the "dex:" coin prefix
+std::string dexOf(const PositionData& pos) {
+    if (!pos.dex.empty()) return pos.dex;
+    size_t colon = pos.coin.find(':');
+    return colon == std::string::npos ? std::string() : pos.coin.substr(0, colon);
+}
+
+} // namespace
+
+void PriceCache::publishPositions(const std::string& dex,
+                                  const std::vector<PositionData>& positions) {
+    auto book = std::make_shared<PositionBook>();
+    book->dex = dex;
+    DWORD now = GetTickCount();
+    for (const auto& p : positions) {
+        PositionData& slot = book->byCoin[p.coin];
+        slot = p;
+        slot.dex = dex;
+        slot.timestamp = now;
+    }
+    PositionSnapshot published = std::move(book);
+
+    EnterCriticalSection(&cs_);
+    positionBooks_[dex].swap(published);
+    lastPositionsUpdate_ = now;
+    LeaveCriticalSection(&cs_);
+    // Previous book released here, outside the lock (or by its last reader)
+}
+
+PositionSnapshot PriceCache::getPositionSnapshot(const std::string& dex) const {
+    EnterCriticalSection(&cs_);
+    auto it = positionBooks_.find(dex);
+    PositionSnapshot book = (it != positionBooks_.end()) ? it->second : emptyPositionBook();
+    LeaveCriticalSection(&cs_);
+    return book;
+}
+
+std::vector<PositionSnapshot> PriceCache::positionBooks() const {
+    std::vector<PositionSnapshot> books;
+    EnterCriticalSection(&cs_);
+    books.reserve(positionBooks_.size());
+    for (const auto& b : positionBooks_) books.push_back(b.second);
+    LeaveCriticalSection(&cs_);
+    return books;
+}
 
 void PriceCache::setPosition(const PositionData& pos) {
+    std::string dex = dexOf(pos);
+    PositionData entry = pos;
+    entry.dex = dex;
+    entry.timestamp = GetTickCount();
+
+    // Copy-on-write under the lock: concurrent single updates must not be lost
     EnterCriticalSection(&cs_);
-    positions_[pos.coin] = pos;
-    positions_[pos.coin].timestamp = GetTickCount();
+    PositionSnapshot& current = positionBooks_[dex];
+    auto book = current ? std::make_shared<PositionBook>(*current)
+                        : std::make_shared<PositionBook>();
+    book->dex = dex;
+    book->byCoin[entry.coin] = entry;
+    PositionSnapshot published = std::move(book);
+    current.swap(published);
     LeaveCriticalSection(&cs_);
 }
 
 void PriceCache::clearPositions() {
     EnterCriticalSection(&cs_);
-    positions_.clear();
+    positionBooks_.clear();
     lastPositionsUpdate_ = GetTickCount();
     LeaveCriticalSection(&cs_);
 }
 
 void PriceCache::clearPositionsByDex(const std::string& dex) {
-    EnterCriticalSection(&cs_);
-    for (auto it = positions_.begin(); it != positions_.end(); ) {
-        if (it->second.dex == dex) {
-            it = positions_.erase(it);
-        } else {
-            ++it;
-        }
-    }
-    lastPositionsUpdate_ = GetTickCount();
-    LeaveCriticalSection(&cs_);
+    publishPositions(dex, std::vector<PositionData>());
 }
 
 PositionData PriceCache::getPosition(const std::string& coin) const {
-    EnterCriticalSection(&cs_);
-    PositionData pos;
-    auto it = positions_.find(coin);
-    if (it != positions_.end()) {
-        pos = it->second;
+    for (const auto& book : positionBooks()) {
+        auto it = book->byCoin.find(coin);
+        if (it != book->byCoin.end()) return it->second;
     }
-    LeaveCriticalSection(&cs_);
-    return pos;
+    return PositionData();
 }
 
 std::vector<PositionData> PriceCache::getAllPositions() const {
-    EnterCriticalSection(&cs_);
     std::vector<PositionData> result;
-    for (const auto& p : positions_) {
-        if (p.second.size != 0) {  // Only non-zero positions
-            result.push_back(p.second);
+    for (const auto& book : positionBooks()) {
+        for (const auto& p : book->byCoin) {
+            if (p.second.size != 0) {  // Only non-zero positions
+                result.push_back(p.second);
+            }
         }
     }
-    LeaveCriticalSection(&cs_);
     return result;
 }
 
 DWORD PriceCache::getPositionAge(const std::string& coin) const {
-    EnterCriticalSection(&cs_);
-    DWORD age = MAXDWORD;
-    auto it = positions_.find(coin);
-    if (it != positions_.end() && it->second.timestamp > 0) {
-        DWORD now = GetTickCount();
-        age = (now >= it->second.timestamp) ? (now - it->second.timestamp) : 0;
-    }
-    LeaveCriticalSection(&cs_);
-    return age;
+    PositionData pos = getPosition(coin);
+    if (pos.timestamp == 0) return MAXDWORD;
+    DWORD now = GetTickCount();
+    return (now >= pos.timestamp) ? (now - pos.timestamp) : 0;
 }
 
 DWORD PriceCache::getPositionsAge() const {
@@ -224,56 +345,81 @@ DWORD PriceCache::getPositionsAge() const {
 // OPEN ORDERS
 //=============================================================================
 
-void PriceCache::setOpenOrder(const OpenOrderData& order) {
+void PriceCache::publishOpenOrders(const std::vector<OpenOrderData>& orders) {
+    auto book = std::make_shared<OpenOrderBook>();
+    DWORD now = GetTickCount();
+    for (const auto& o : orders) {
+        OpenOrderData& slot = book->byOid[o.oid];
+        slot = o;
+        slot.timestamp = now;
+    }
+    OpenOrderSnapshot published = std::move(book);
+
     EnterCriticalSection(&cs_);
-    openOrders_[order.oid] = order;
-    openOrders_[order.oid].timestamp = GetTickCount();
+    openOrders_.swap(published);
+    lastOpenOrdersUpdate_ = now;
     LeaveCriticalSection(&cs_);
 }
 
-void PriceCache::removeOpenOrder(const std::string& oid) {
+OpenOrderSnapshot PriceCache::getOpenOrderSnapshot() const {
     EnterCriticalSection(&cs_);
-    openOrders_.erase(oid);
+    OpenOrderSnapshot book = openOrders_ ? openOrders_ : emptyOpenOrderBook();
     LeaveCriticalSection(&cs_);
+    return book;
 }
 
-void PriceCache::clearOpenOrders() {
+void PriceCache::setOpenOrder(const OpenOrderData& order) {
+    OpenOrderData entry = order;
+    entry.timestamp = GetTickCount();
+
     EnterCriticalSection(&cs_);
-    openOrders_.clear();
-    lastOpenOrdersUpdate_ = GetTickCount();
+    auto book = openOrders_ ? std::make_shared<OpenOrderBook>(*openOrders_)
+                            : std::make_shared<OpenOrderBook>();
+    book->byOid[entry.oid] = entry;
+    OpenOrderSnapshot published = std::move(book);
+    openOrders_.swap(published);
     LeaveCriticalSection(&cs_);
 }
 
-OpenOrderData PriceCache::getOpenOrder(const std::string& oid) const {
+void PriceCache::removeOpenOrder(const std::string& oid) {
     EnterCriticalSection(&cs_);
-    OpenOrderData order;
-    auto it = openOrders_.find(oid);
-    if (it != openOrders_.end()) {
-        order = it->second;
+    if (openOrders_ && openOrders_->byOid.count(oid)) {
+        auto book = std::make_shared<OpenOrderBook>(*openOrders_);
+        book->byOid.erase(oid);
+        OpenOrderSnapshot published = std::move(book);
+        openOrders_.swap(published);
     }
     LeaveCriticalSection(&cs_);
-    return order;
+}
+
+void PriceCache::clearOpenOrders() {
+    publishOpenOrders(std::vector<OpenOrderData>());
+}
+
+OpenOrderData PriceCache::getOpenOrder(const std::string& oid) const {
+    OpenOrderSnapshot book = getOpenOrderSnapshot();
+    auto it = book->byOid.find(oid);
+    return (it != book->byOid.end()) ? it->second : OpenOrderData();
 }
 
 std::vector<OpenOrderData> PriceCache::getAllOpenOrders() const {
-    EnterCriticalSection(&cs_);
+    OpenOrderSnapshot book = getOpenOrderSnapshot();
     std::vector<OpenOrderData> result;
-    for (const auto& o : openOrders_) {
+    result.reserve(book->byOid.size());
+    for (const auto& o : book->byOid) {
         result.push_back(o.second);
     }
-    LeaveCriticalSection(&cs_);
     return result;
 }
 
 std::vector<OpenOrderData> PriceCache::getOpenOrdersForCoin(const std::string& coin) const {
-    EnterCriticalSection(&cs_);
+    OpenOrderSnapshot book = getOpenOrderSnapshot();
     std::vector<OpenOrderData> result;
-    for (const auto& o : openOrders_) {
+    for (const auto& o : book->byOid) {
         if (o.second.coin == coin) {
             result.push_back(o.second);
         }
     }
-    LeaveCriticalSection(&cs_);
     return result;
 }
 
@@ -292,54 +438,67 @@ DWORD PriceCache::getOpenOrdersAge() const {
 
 void PriceCache::addFill(const FillData& fill) {
     EnterCriticalSection(&cs_);
-    recentFills_.push_back(fill);
-    if (recentFills_.size() > MAX_FILLS) {
-        recentFills_.erase(recentFills_.begin());
-    }
+    fills_.add(fill);
     LeaveCriticalSection(&cs_);
 }
 
 void PriceCache::clearFills() {
     EnterCriticalSection(&cs_);
-    recentFills_.clear();
+    fills_.clear();
     LeaveCriticalSection(&cs_);
 }
 
 std::vector<FillData> PriceCache::getRecentFills(int count) const {
     EnterCriticalSection(&cs_);
-    std::vector<FillData> result;
-    int start = static_cast<int>(recentFills_.size()) - count;
-    if (start < 0) start = 0;
-    for (int i = start; i < static_cast<int>(recentFills_.size()); i++) {
-        result.push_back(recentFills_[i]);
-    }
+    std::vector<FillData> result = fills_.recent(count);
     LeaveCriticalSection(&cs_);
     return result;
 }
 
 std::vector<FillData> PriceCache::getFillsForOrder(const std::string& oid) const {
     EnterCriticalSection(&cs_);
-    std::vector<FillData> result;
-    for (const auto& f : recentFills_) {
-        if (f.oid == oid) {
-            result.push_back(f);
-        }
-    }
+    std::vector<FillData> result = fills_.forOrder(oid);
     LeaveCriticalSection(&cs_);
     return result;
 }
 
+void PriceCache::getFillTotals(const std::vector<const char*>& oids,
+                               std::vector<FillTotal>& out) const {
+    out.assign(oids.size(), FillTotal());
+    EnterCriticalSection(&cs_);
+    for (size_t i = 0; i < oids.size(); i++) {
+        double notional;
+        FillTotal& t = out[i];
+        t.fills = fills_.sumForOrder(oids[i], t.size, notional);
+        if (t.size > 0) t.avgPx = notional / t.size;
+    }
+    LeaveCriticalSection(&cs_);
+}
+
+void PriceCache::setFillCapacity(size_t capacity) {
+    EnterCriticalSection(&cs_);
+    fills_.setCapacity(capacity);
+    LeaveCriticalSection(&cs_);
+}
+
+size_t PriceCache::getFillCapacity() const {
+    EnterCriticalSection(&cs_);
+    size_t n = fills_.capacity();
+    LeaveCriticalSection(&cs_);
+    return n;
+}
+
 //=============================================================================
 // CLEAR ALL
 //=============================================================================
 
 void PriceCache::clear() {
     EnterCriticalSection(&cs_);
-    prices_.clear();
+    prices_.assign(prices_.size(), PriceData());   // Keep the table; ids are permanent
     accountData_ = AccountData();
-    positions_.clear();
-    openOrders_.clear();
-    recentFills_.clear();
+    positionBooks_.clear();
+    openOrders_.reset();
+    fills_.clear();
     lastOpenOrdersUpdate_ = 0;
     lastPositionsUpdate_ = 0;
     LeaveCriticalSection(&cs_);
@@ -4,19 +4,50 @@
 // Part of Hyperliquid Plugin for Zorro
 //
 // LAYER: Transport
-// DEPENDENCIES: ws_types.h
+// DEPENDENCIES: ws_types.h, ws_fill_ring.h, hl_symbols.h
 // THREAD SAFETY: All public methods are thread-safe via CRITICAL_SECTION
+//
+// Prices are stored by g_symbols id. The l2Book path resolves the coin once
+// and uses the id overloads; the string overloads resolve and forward.
+//
+// With setSharedSource() attached, l2Book reads also consult the
+// cross-process SharedPriceTable and return whichever quote is newer.
+//
+// Positions (per dex) and open orders are immutable snapshots, built off-lock
+// and published with a pointer swap; readers hold a snapshot handle and never
+// see a book that is half replaced.
 //=============================================================================
 
 #pragma once
 
 #include "ws_types.h"
+#include "ws_fill_ring.h"
+#include "../foundation/hl_symbols.h"
+#include <atomic>
 #include <map>
+#include <memory>
 #include <vector>
 
 namespace hl {
 namespace ws {
 
+class SharedPriceTable;
+
+/// Positions of one dex from one clearinghouseState, keyed by coin. Never
+/// modified after publication.
+struct PositionBook {
+    std::string dex;
+    std::map<std::string, PositionData> byCoin;
+};
+typedef std::shared_ptr<const PositionBook> PositionSnapshot;
+
+/// Open orders from one openOrders message, keyed by oid. Never modified
+/// after publication.
+struct OpenOrderBook {
+    std::map<std::string, OpenOrderData> byOid;
+};
+typedef std::shared_ptr<const OpenOrderBook> OpenOrderSnapshot;
+
 /// Thread-safe cache for WebSocket data
 ///
 /// Stores prices (from l2Book), account data (from clearinghouseState),
@@ -29,7 +60,9 @@ namespace ws {
 ///
 class PriceCache {
 public:
-    PriceCache();
+    static const size_t DEFAULT_FILL_CAPACITY = 1000;
+
+    explicit PriceCache(size_t fillCapacity = DEFAULT_FILL_CAPACITY);
     ~PriceCache();
 
     // Non-copyable
@@ -64,6 +97,27 @@ public:
     /// Check if price exists and is fresh (age < maxAgeMs)
     bool isFresh(const std::string& coin, DWORD maxAgeMs = 5000) const;
 
+    /// Block until the coin has a valid bid/ask or timeoutMs elapses.
+    /// Woken by the setBidAsk that supplies the first valid quote — no polling.
+    /// @return true if bid/ask are available
+    bool waitForBidAsk(const std::string& coin, DWORD timeoutMs) const;
+
+    /// Same for a set of coins, waited on in parallel (one shared deadline)
+    /// @return number of coins that have a valid bid/ask
+    int waitForBidAsk(const std::vector<std::string>& coins, DWORD timeoutMs) const;
+
+    /// By symbol id (g_symbols) — no string work, no allocation once the id
+    /// has been seen. @return true if this is the coin's first valid quote
+    bool setBidAsk(uint32_t coinId, double bid, double ask);
+    double getBid(uint32_t coinId) const;
+
+    /// Price and its age (MAXDWORD if never set) under one lock
+    PriceData getPriceData(uint32_t coinId, DWORD* age = nullptr) const;
+
+    /// Also read quotes published by another process (nullptr detaches).
+    /// The table must outlive the attachment.
+    void setSharedSource(const SharedPriceTable* table);
+
     //=========================================================================
     // ACCOUNT DATA (webData3/clearinghouseState)
     //=========================================================================
@@ -78,6 +132,13 @@ public:
     // POSITION DATA (clearinghouseState)
     //=========================================================================
 
+    /// Replace all positions of one dex at once [OPM-212]
+    void publishPositions(const std::string& dex, const std::vector<PositionData>& positions);
+    /// Immutable positions of one dex (empty book if none yet)
+    PositionSnapshot getPositionSnapshot(const std::string& dex) const;
+
+    /// Single-position update (fill bridge): copy-on-write of its dex's book.
+    /// The dex is pos.dex, else the "dex:" prefix of pos.coin.
     void setPosition(const PositionData& pos);
     void clearPositions();
     void clearPositionsByDex(const std::string& dex);  // [OPM-212] Clear only positions from a specific dex
@@ -90,8 +151,13 @@ public:
     // OPEN ORDERS (openOrders)
     //=========================================================================
 
-    void setOpenOrder(const OpenOrderData& order);
-    void removeOpenOrder(const std::string& oid);
+    /// Replace the open-order book at once
+    void publishOpenOrders(const std::vector<OpenOrderData>& orders);
+    /// Immutable open-order book
+    OpenOrderSnapshot getOpenOrderSnapshot() const;
+
+    void setOpenOrder(const OpenOrderData& order);     // Copy-on-write
+    void removeOpenOrder(const std::string& oid);      // Copy-on-write
     void clearOpenOrders();
     OpenOrderData getOpenOrder(const std::string& oid) const;
     std::vector<OpenOrderData> getAllOpenOrders() const;
@@ -102,10 +168,18 @@ public:
     // FILLS (userFills)
     //=========================================================================
 
+    /// Allocation-free once the coin is known; overwrites the oldest fill when full
     void addFill(const FillData& fill);
     void clearFills();
     std::vector<FillData> getRecentFills(int count = 10) const;
-    std::vector<FillData> getFillsForOrder(const std::string& oid) const;
+    std::vector<FillData> getFillsForOrder(const std::string& oid) const;  // O(fills of oid)
+
+    /// Fill totals of many orders under one lock; out[i] matches oids[i]
+    void getFillTotals(const std::vector<const char*>& oids, std::vector<FillTotal>& out) const;
+
+    /// Resize the fill store, keeping the newest fills
+    void setFillCapacity(size_t capacity);
+    size_t getFillCapacity() const;
 
     //=========================================================================
     // CLEAR ALL
@@ -115,17 +189,25 @@ public:
 
 private:
     mutable CRITICAL_SECTION cs_;
+    mutable CONDITION_VARIABLE firstQuoteCv_;  // Signaled on a coin's first valid bid/ask
 
-    std::map<std::string, PriceData> prices_;
+    std::vector<PriceData> prices_;                          // symbol id -> price
+    std::atomic<const SharedPriceTable*> shared_;            // Cross-process quotes (optional)
     AccountData accountData_;
-    std::map<std::string, PositionData> positions_;
-    std::map<std::string, OpenOrderData> openOrders_;
-    std::vector<FillData> recentFills_;
+    std::map<std::string, PositionSnapshot> positionBooks_;   // dex -> book
+    OpenOrderSnapshot openOrders_;
+    FillRing fills_;
 
     DWORD lastOpenOrdersUpdate_;
     DWORD lastPositionsUpdate_;
 
-    static const size_t MAX_FILLS = 100;
+    /// Caller holds cs_. Null if the id has no price; the mutable form grows
+    /// the table (only the first time an id is seen)
+    const PriceData* priceLocked(uint32_t coinId) const;
+    PriceData& priceSlotLocked(uint32_t coinId);
+
+    /// Current book of every dex (pointers copied under the lock)
+    std::vector<PositionSnapshot> positionBooks() const;
 };
 
 } // namespace ws
@@ -0,0 +1,296 @@
+//=============================================================================
+// ws_shared_prices.cpp - Cross-process l2Book price table implementation
+//=============================================================================
+// Part of Hyperliquid Plugin for Zorro
+//
+// LAYER: Transport
+// THREAD SAFETY: See ws_shared_prices.h
+//=============================================================================
+
+#include "ws_shared_prices.h"
+#include <cstring>
+
+namespace hl {
+namespace ws {
+
+static const uint32_t SEGMENT_MAGIC = 0x50534C48;   // "HLSP"
+static const uint32_t SEGMENT_VERSION = 1;
+static const int READ_MAX_TRIES = 64;                // Then report no shared quote
+
+// One cache line per coin: readers of different coins never share a line
+// with a write in progress
+struct SharedPriceTable::Slot {
+    std::atomic<uint32_t> seq;      // Odd while a write is in progress
+    volatile DWORD updated;         // GetTickCount() of the quote (0 = none yet)
+    volatile double bid;
+    volatile double ask;
+    char coin[COIN_LEN];            // Written once, before slotsUsed counts it
+};
+
+struct SharedPriceTable::Header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t capacity;
+    std::atomic<uint32_t> slotsUsed;
+    std::atomic<uint32_t> publisherPid;   // 0 = none
+    std::atomic<uint32_t> heartbeat;      // Publisher's GetTickCount()
+    std::atomic<uint32_t> takeovers;
+    char pad[64 - 7 * sizeof(uint32_t)];
+};
+
+struct SharedPriceTable::Segment {
+    Header header;
+    Slot slots[config::SHM_PRICE_SLOTS];
+};
+
+//=============================================================================
+// CONSTRUCTION / MAPPING
+//=============================================================================
+
+SharedPriceTable::SharedPriceTable()
+    : seg_(nullptr), mapping_(NULL), publisherMutex_(NULL), claimMutex_(NULL),
+      publisher_(false), seenSlots_(0), published_(0), readRetries_(0) {
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "shared atomics must be plain words");
+    static_assert(sizeof(Slot) == 64 && sizeof(Header) == 64, "one slot per cache line");
+    for (int i = 0; i < config::SYMBOL_MAX_IDS; ++i) slotOf_[i].store(0, std::memory_order_relaxed);
+}
+
+SharedPriceTable::~SharedPriceTable() {
+    close();
+}
+
+bool SharedPriceTable::open(const char* name) {
+    if (seg_) return true;
+    if (!name || !*name) return false;
+
+    char objName[128];
+    sprintf_s(objName, "%s.Claim", name);
+    claimMutex_ = CreateMutexA(NULL, FALSE, objName);
+    sprintf_s(objName, "%s.Publisher", name);
+    publisherMutex_ = CreateMutexA(NULL, FALSE, objName);
+    mapping_ = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE,
+                                  0, (DWORD)sizeof(Segment), name);
+    void* view = mapping_ ? MapViewOfFile(mapping_, FILE_MAP_ALL_ACCESS, 0, 0, sizeof(Segment)) : nullptr;
+    if (!claimMutex_ || !publisherMutex_ || !view) {
+        if (view) UnmapViewOfFile(view);
+        seg_ = nullptr;
+        close();
+        return false;
+    }
+
+    // The creator's zero-filled pages get the header under the claim mutex;
+    // a segment left by another build with a different layout is refused
+    Segment* seg = static_cast<Segment*>(view);
+    WaitForSingleObject(claimMutex_, INFINITE);
+    if (seg->header.magic == 0) {
+        seg->header.version = SEGMENT_VERSION;
+        seg->header.capacity = (uint32_t)config::SHM_PRICE_SLOTS;
+        seg->header.magic = SEGMENT_MAGIC;
+    }
+    bool compatible = seg->header.magic == SEGMENT_MAGIC &&
+                      seg->header.version == SEGMENT_VERSION &&
+                      seg->header.capacity == (uint32_t)config::SHM_PRICE_SLOTS;
+    ReleaseMutex(claimMutex_);
+    if (!compatible) {
+        UnmapViewOfFile(view);
+        close();
+        return false;
+    }
+
+    seg_ = seg;
+    return true;
+}
+
+void SharedPriceTable::close() {
+    releasePublisher();
+    if (seg_) {
+        UnmapViewOfFile(seg_);
+        seg_ = nullptr;
+    }
+    if (mapping_) { CloseHandle(mapping_); mapping_ = NULL; }
+    if (publisherMutex_) { CloseHandle(publisherMutex_); publisherMutex_ = NULL; }
+    if (claimMutex_) { CloseHandle(claimMutex_); claimMutex_ = NULL; }
+    for (int i = 0; i < config::SYMBOL_MAX_IDS; ++i) slotOf_[i].store(0, std::memory_order_relaxed);
+    seenSlots_ = 0;
+}
+
+//=============================================================================
+// PUBLISHER
+//=============================================================================
+
+bool SharedPriceTable::tryAcquirePublisher() {
+    if (!seg_) return false;
+    if (isPublisher()) return true;
+    DWORD rc = WaitForSingleObject(publisherMutex_, 0);
+    if (rc != WAIT_OBJECT_0 && rc != WAIT_ABANDONED) return false;
+
+    seg_->header.publisherPid.store((uint32_t)GetCurrentProcessId(), std::memory_order_relaxed);
+    seg_->header.takeovers.fetch_add(1, std::memory_order_relaxed);
+    heartbeat();
+    seenSlots_ = 0;     // Every coin in the table is new to this publisher
+    publisher_.store(true, std::memory_order_release);
+    return true;
+}
+
+void SharedPriceTable::releasePublisher() {
+    if (!isPublisher()) return;
+    publisher_.store(false, std::memory_order_release);
+    if (seg_) seg_->header.publisherPid.store(0, std::memory_order_release);
+    ReleaseMutex(publisherMutex_);
+}
+
+void SharedPriceTable::heartbeat() {
+    heartbeat(GetTickCount());
+}
+
+void SharedPriceTable::heartbeat(DWORD now) {
+    if (!seg_) return;
+    seg_->header.heartbeat.store(now ? now : 1, std::memory_order_release);
+}
+
+int SharedPriceTable::takeRequests(std::vector<std::string>& out) {
+    if (!seg_) return 0;
+    uint32_t used = seg_->header.slotsUsed.load(std::memory_order_acquire);
+    int added = 0;
+    for (; seenSlots_ < used; ++seenSlots_, ++added)
+        out.push_back(seg_->slots[seenSlots_].coin);
+    return added;
+}
+
+void SharedPriceTable::publish(uint32_t coinId, const char* coin, double bid, double ask) {
+    if (!seg_ || !isPublisher() || !coinId || coinId >= (uint32_t)config::SYMBOL_MAX_IDS) return;
+    int idx = slotOf_[coinId].load(std::memory_order_acquire) - 1;
+    if (idx < 0) {
+        idx = findOrClaim(coin);
+        if (idx < 0) return;
+        slotOf_[coinId].store(idx + 1, std::memory_order_release);
+    }
+    Slot& slot = seg_->slots[idx];
+
+    // Connections of one publisher may race on a coin (standby): the odd
+    // sequence doubles as the writers' lock
+    uint32_t seq = slot.seq.load(std::memory_order_relaxed);
+    for (;;) {
+        if (!(seq & 1) && slot.seq.compare_exchange_weak(seq, seq + 1, std::memory_order_acquire))
+            break;
+        if (seq & 1) {
+            YieldProcessor();
+            seq = slot.seq.load(std::memory_order_relaxed);
+        }
+    }
+    DWORD now = GetTickCount();
+    slot.bid = bid;
+    slot.ask = ask;
+    slot.updated = now ? now : 1;
+    slot.seq.store(seq + 2, std::memory_order_release);
+    published_.fetch_add(1, std::memory_order_relaxed);
+}
+
+//=============================================================================
+// ANY PROCESS
+//=============================================================================
+
+int SharedPriceTable::request(const char* coin) {
+    if (!seg_ || !coin || !*coin) return -1;
+    int idx = findOrClaim(coin);
+    uint32_t id = g_symbols.intern(coin);
+    if (idx >= 0 && id) slotOf_[id].store(idx + 1, std::memory_order_release);
+    return idx;
+}
+
+int SharedPriceTable::findOrClaim(const char* coin) {
+    if (!coin || !*coin || strlen(coin) >= (size_t)COIN_LEN) return -1;
+
+    DWORD rc = WaitForSingleObject(claimMutex_, INFINITE);
+    if (rc != WAIT_OBJECT_0 && rc != WAIT_ABANDONED) return -1;
+    uint32_t used = seg_->header.slotsUsed.load(std::memory_order_acquire);
+    int idx = -1;
+    for (uint32_t i = 0; i < used; ++i) {
+        if (strcmp(seg_->slots[i].coin, coin) == 0) { idx = (int)i; break; }
+    }
+    if (idx < 0 && used < (uint32_t)config::SHM_PRICE_SLOTS) {
+        strcpy_s(seg_->slots[used].coin, coin);
+        seg_->header.slotsUsed.store(used + 1, std::memory_order_release);
+        idx = (int)used;
+    }
+    ReleaseMutex(claimMutex_);
+    return idx;
+}
+
+// Names below slotsUsed never change, so a coin another process claimed is
+// found without the claim mutex. Misses remember how far they scanned.
+int SharedPriceTable::resolveSlot(uint32_t coinId) const {
+    int32_t cached = slotOf_[coinId].load(std::memory_order_acquire);
+    if (cached > 0) return cached - 1;
+
+    uint32_t used = seg_->header.slotsUsed.load(std::memory_order_acquire);
+    uint32_t scanned = (uint32_t)(-cached);
+    if (scanned >= used) return -1;
+    const char* name = g_symbols.name(coinId);
+    if (!name) return -1;
+    for (uint32_t i = scanned; i < used; ++i) {
+        if (strcmp(seg_->slots[i].coin, name) == 0) {
+            slotOf_[coinId].store((int32_t)i + 1, std::memory_order_release);
+            return (int)i;
+        }
+    }
+    slotOf_[coinId].store(-(int32_t)used, std::memory_order_release);
+    return -1;
+}
+
+bool SharedPriceTable::read(uint32_t coinId, PriceData* out) const {
+    if (!seg_ || isPublisher() || !coinId || coinId >= (uint32_t)config::SYMBOL_MAX_IDS) return false;
+    if (!publisherAlive()) return false;
+    int idx = resolveSlot(coinId);
+    if (idx < 0) return false;
+    const Slot& slot = seg_->slots[idx];
+
+    for (int tries = 0; tries < READ_MAX_TRIES; ++tries) {
+        uint32_t before = slot.seq.load(std::memory_order_acquire);
+        if (before & 1) {
+            readRetries_.fetch_add(1, std::memory_order_relaxed);
+            YieldProcessor();
+            continue;
+        }
+        double bid = slot.bid;
+        double ask = slot.ask;
+        DWORD updated = slot.updated;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.seq.load(std::memory_order_relaxed) != before) {
+            readRetries_.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        if (updated == 0) return false;
+        if (out) {
+            out->bid = bid;
+            out->ask = ask;
+            out->mid = (bid + ask) / 2.0;
+            out->timestamp = updated;
+        }
+        return true;
+    }
+    return false;
+}
+
+bool SharedPriceTable::publisherAlive() const {
+    if (!seg_ || seg_->header.publisherPid.load(std::memory_order_acquire) == 0) return false;
+    DWORD beat = seg_->header.heartbeat.load(std::memory_order_acquire);
+    return (DWORD)(GetTickCount() - beat) < (DWORD)config::SHM_PUBLISHER_STALE_MS;
+}
+
+SharedPriceStats SharedPriceTable::getStats() const {
+    SharedPriceStats s;
+    s.open = (seg_ != nullptr);
+    s.publisher = isPublisher();
+    s.published = published_.load(std::memory_order_relaxed);
+    s.readRetries = readRetries_.load(std::memory_order_relaxed);
+    if (!seg_) return s;
+    s.publisherAlive = publisherAlive();
+    s.publisherPid = seg_->header.publisherPid.load(std::memory_order_relaxed);
+    s.takeovers = seg_->header.takeovers.load(std::memory_order_relaxed);
+    s.slotsUsed = (int)seg_->header.slotsUsed.load(std::memory_order_relaxed);
+    return s;
+}
+
+} // namespace ws
+} // namespace hl
@@ -0,0 +1,134 @@
+//=============================================================================
+// ws_shared_prices.h - Cross-process l2Book price table in shared memory
+//=============================================================================
+// Part of Hyperliquid Plugin for Zorro
+//
+// LAYER: Transport
+// DEPENDENCIES: ws_types.h, hl_config.h, hl_symbols.h
+// THREAD SAFETY: publish/read/request are thread-safe; tryAcquirePublisher,
+//                releasePublisher, heartbeat and takeRequests belong to one
+//                thread (the WS primary connection thread)
+//
+// Several Zorro instances on one box would otherwise each open their own
+// sockets and subscribe the same l2Book feeds. With the table enabled one
+// process - whichever holds the publisher mutex - keeps the subscriptions
+// and writes every top-of-book into a named file mapping; the others read it
+// with no sockets of their own for market data.
+//
+// LAYOUT (one segment per network, SHM_PRICE_SLOTS fixed 64-byte slots):
+//   - A slot is claimed once per coin name under a named claim mutex and
+//     never reused; claims from readers are how they request a coin
+//   - Each slot carries a seqlock: the writer makes seq odd, stores
+//     bid/ask/time, makes it even; a reader retries if seq was odd or changed
+//   - The header holds the publisher's pid and a heartbeat tick. The
+//     publisher only beats while its l2Book feed is connected; readers
+//     ignore the table once the heartbeat is SHM_PUBLISHER_STALE_MS old.
+//
+// FAILOVER: the publisher mutex is a Win32 named mutex, so a publisher that
+// exits or crashes leaves it abandoned and the next reader to try it takes
+// over, re-subscribing every coin in the table.
+//=============================================================================
+
+#pragma once
+
+#include "ws_types.h"
+#include "../foundation/hl_config.h"
+#include "../foundation/hl_symbols.h"
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace hl {
+namespace ws {
+
+/// Counters for HL_GET_WS_HEALTH and the benchmark
+struct SharedPriceStats {
+    bool open = false;
+    bool publisher = false;         // This process writes the table
+    bool publisherAlive = false;    // Some process heartbeats within SHM_PUBLISHER_STALE_MS
+    DWORD publisherPid = 0;
+    uint32_t takeovers = 0;         // Publisher changes since the segment was created
+    int slotsUsed = 0;
+    long long published = 0;        // Quotes written by this process
+    long long readRetries = 0;      // Reads by this process that raced a write
+};
+
+class SharedPriceTable {
+public:
+    static const int COIN_LEN = 40;     // Slot coin name incl. terminator
+
+    SharedPriceTable();
+    ~SharedPriceTable();
+
+    SharedPriceTable(const SharedPriceTable&) = delete;
+    SharedPriceTable& operator=(const SharedPriceTable&) = delete;
+
+    /// Map the named segment, creating it in the first process.
+    /// @param name Segment name, one per network (e.g. "Local\\HyperliquidZorro.Prices.mainnet")
+    /// @return false if it could not be mapped or has another layout version
+    bool open(const char* name);
+    void close();
+    bool isOpen() const { return seg_ != nullptr; }
+
+    //=========================================================================
+    // PUBLISHER (owner thread only)
+    //=========================================================================
+
+    /// Take the publisher mutex without waiting (also succeeds on an
+    /// abandoned one). Afterwards takeRequests() reports every claimed coin.
+    bool tryAcquirePublisher();
+    void releasePublisher();
+    bool isPublisher() const { return publisher_.load(std::memory_order_acquire); }
+
+    /// Stamp the header so readers know the publisher is alive and fed.
+    /// Skipped while the publisher's feed is disconnected.
+    void heartbeat();
+    void heartbeat(DWORD now);          // Time injection
+
+    /// Coins claimed since the last call (by any process)
+    /// @return number appended to out
+    int takeRequests(std::vector<std::string>& out);
+
+    /// Seqlock write of one top-of-book (claims the coin's slot on first use)
+    void publish(uint32_t coinId, const char* coin, double bid, double ask);
+
+    //=========================================================================
+    // ANY PROCESS
+    //=========================================================================
+
+    /// Claim a slot for a coin so the publisher subscribes it
+    /// @return slot index, -1 if the table is full or not open
+    int request(const char* coin);
+
+    /// Seqlock read by this process's g_symbols id
+    /// @return false if this process is the publisher, the publisher is
+    ///         stale, the coin has no slot or no quote yet
+    bool read(uint32_t coinId, PriceData* out) const;
+
+    bool publisherAlive() const;
+    SharedPriceStats getStats() const;
+
+private:
+    struct Slot;
+    struct Header;
+    struct Segment;
+
+    Segment* seg_;
+    HANDLE mapping_;
+    HANDLE publisherMutex_;
+    HANDLE claimMutex_;
+    std::atomic<bool> publisher_;
+    uint32_t seenSlots_;                // takeRequests watermark (owner thread)
+    std::atomic<long long> published_;
+    mutable std::atomic<long long> readRetries_;
+
+    // g_symbols id -> slot + 1; <= 0 means not found after scanning -value slots
+    mutable std::atomic<int32_t> slotOf_[config::SYMBOL_MAX_IDS];
+
+    int resolveSlot(uint32_t coinId) const;
+    int findOrClaim(const char* coin);
+};
+
+} // namespace ws
+} // namespace hl
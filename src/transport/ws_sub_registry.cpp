@@ -0,0 +1,211 @@
+//=============================================================================
+// ws_sub_registry.cpp - Per-subscription lifecycle and data watermarks
+//=============================================================================
+// Part of Hyperliquid Plugin for Zorro
+//
+// LAYER: Transport
+//=============================================================================
+
+#include "ws_sub_registry.h"
+
+namespace hl {
+namespace ws {
+
+const char* subStatusName(SubStatus status) {
+    switch (status) {
+        case SubStatus::None:      return "none";
+        case SubStatus::Requested: return "requested";
+        case SubStatus::Sent:      return "sent";
+        case SubStatus::Acked:     return "acked";
+        case SubStatus::Live:      return "live";
+        case SubStatus::Dead:      return "DEAD";
+    }
+    return "?";
+}
+
+SubscriptionRegistry::SubscriptionRegistry(DWORD ackTimeoutMs)
+    : ackTimeoutMs_(ackTimeoutMs) {
+    InitializeCriticalSection(&cs_);
+}
+
+SubscriptionRegistry::~SubscriptionRegistry() {
+    DeleteCriticalSection(&cs_);
+}
+
+std::string SubscriptionRegistry::makeKey(const char* type, const char* arg) {
+    std::string key = type ? type : "";
+    if (arg && *arg) {
+        key += ':';
+        key += arg;
+    }
+    return key;
+}
+
+std::string SubscriptionRegistry::recordKey(int connection, const std::string& key) {
+    return key + '@' + std::to_string(connection);
+}
+
+// Caller holds cs_
+SubscriptionRegistry::Record& SubscriptionRegistry::recordFor(int connection,
+                                                              const std::string& key) {
+    auto it = records_.find(recordKey(connection, key));
+    if (it != records_.end()) return it->second;
+    Record& r = records_[recordKey(connection, key)];
+    r.info.key = key;
+    r.info.connection = connection;
+    r.sent = false;
+    r.acked = false;
+    r.everData = false;
+    r.dataSinceSubscribe = false;
+    return r;
+}
+
+// Caller holds cs_
+SubStatus SubscriptionRegistry::statusOf(const Record& r, DWORD now) const {
+    if (r.dataSinceSubscribe) return SubStatus::Live;
+    if (r.acked) return SubStatus::Acked;
+    if (!r.sent) return SubStatus::Requested;
+    if (now - r.info.sentAt >= ackTimeoutMs_) return SubStatus::Dead;
+    return SubStatus::Sent;
+}
+
+//=============================================================================
+// LIFECYCLE EVENTS
+//=============================================================================
+
+void SubscriptionRegistry::onRequested(int connection, const std::string& key, DWORD now) {
+    EnterCriticalSection(&cs_);
+    Record& r = recordFor(connection, key);
+    if (r.info.requestedAt == 0) r.info.requestedAt = now;
+    LeaveCriticalSection(&cs_);
+}
+
+void SubscriptionRegistry::onSent(int connection, const std::string& key, DWORD now) {
+    EnterCriticalSection(&cs_);
+    Record& r = recordFor(connection, key);
+    if (r.info.requestedAt == 0) r.info.requestedAt = now;
+    r.sent = true;
+    r.info.sentAt = now;
+    r.info.sends++;
+    LeaveCriticalSection(&cs_);
+}
+
+void SubscriptionRegistry::onAcked(int connection, const std::string& key, DWORD now) {
+    EnterCriticalSection(&cs_);
+    Record& r = recordFor(connection, key);
+    if (!r.acked) {
+        r.acked = true;
+        r.info.ackedAt = now;
+    }
+    LeaveCriticalSection(&cs_);
+}
+
+// Caller holds cs_
+void SubscriptionRegistry::markData(Record& r, DWORD now) {
+    if (!r.everData) {
+        r.everData = true;
+        r.info.firstDataAt = now;
+    }
+    r.info.lastDataAt = now;
+    r.info.messages++;
+    r.dataSinceSubscribe = true;
+    // Data implies the subscription is live even if the ack was lost
+    if (!r.acked) { r.acked = true; r.info.ackedAt = now; }
+}
+
+void SubscriptionRegistry::onData(int connection, const std::string& key, DWORD now) {
+    EnterCriticalSection(&cs_);
+    markData(recordFor(connection, key), now);
+    LeaveCriticalSection(&cs_);
+}
+
+void SubscriptionRegistry::onData(int connection, uint32_t argId, const char* type,
+                                  const char* arg, DWORD now) {
+    if (!argId) { onData(connection, makeKey(type, arg), now); return; }
+    uint64_t id = ((uint64_t)(uint32_t)connection << 32) | argId;
+    EnterCriticalSection(&cs_);
+    auto it = byArgId_.find(id);
+    Record* r = (it != byArgId_.end()) ? it->second : nullptr;
+    if (!r) {
+        r = &recordFor(connection, makeKey(type, arg));
+        byArgId_[id] = r;
+    }
+    markData(*r, now);
+    LeaveCriticalSection(&cs_);
+}
+
+void SubscriptionRegistry::onConnectionLost(int connection) {
+    EnterCriticalSection(&cs_);
+    for (auto& kv : records_) {
+        Record& r = kv.second;
+        if (r.info.connection != connection) continue;
+        r.sent = false;
+        r.acked = false;
+        r.dataSinceSubscribe = false;
+        r.info.sentAt = 0;
+        r.info.ackedAt = 0;
+    }
+    LeaveCriticalSection(&cs_);
+}
+
+void SubscriptionRegistry::remove(int connection, const std::string& key) {
+    EnterCriticalSection(&cs_);
+    auto rec = records_.find(recordKey(connection, key));
+    if (rec != records_.end()) {
+        for (auto it = byArgId_.begin(); it != byArgId_.end(); ) {
+            if (it->second == &rec->second) it = byArgId_.erase(it);
+            else ++it;
+        }
+        records_.erase(rec);
+    }
+    LeaveCriticalSection(&cs_);
+}
+
+void SubscriptionRegistry::clear() {
+    EnterCriticalSection(&cs_);
+    byArgId_.clear();
+    records_.clear();
+    LeaveCriticalSection(&cs_);
+}
+
+//=============================================================================
+// QUERIES
+//=============================================================================
+
+SubStatus SubscriptionRegistry::status(int connection, const std::string& key, DWORD now) const {
+    EnterCriticalSection(&cs_);
+    auto it = records_.find(recordKey(connection, key));
+    SubStatus s = (it != records_.end()) ? statusOf(it->second, now) : SubStatus::None;
+    LeaveCriticalSection(&cs_);
+    return s;
+}
+
+bool SubscriptionRegistry::willReceiveData(int connection, const std::string& key, DWORD now) const {
+    SubStatus s = status(connection, key, now);
+    return s == SubStatus::Requested || s == SubStatus::Sent ||
+           s == SubStatus::Acked || s == SubStatus::Live;
+}
+
+bool SubscriptionRegistry::hadData(int connection, const std::string& key) const {
+    EnterCriticalSection(&cs_);
+    auto it = records_.find(recordKey(connection, key));
+    bool had = it != records_.end() && it->second.everData;
+    LeaveCriticalSection(&cs_);
+    return had;
+}
+
+std::vector<SubscriptionInfo> SubscriptionRegistry::snapshot(DWORD now) const {
+    std::vector<SubscriptionInfo> result;
+    EnterCriticalSection(&cs_);
+    result.reserve(records_.size());
+    for (const auto& kv : records_) {
+        SubscriptionInfo info = kv.second.info;
+        info.status = statusOf(kv.second, now);
+        result.push_back(info);
+    }
+    LeaveCriticalSection(&cs_);
+    return result;
+}
+
+} // namespace ws
+} // namespace hl
@@ -0,0 +1,113 @@
+//=============================================================================
+// ws_sub_registry.h - Per-subscription lifecycle and data watermarks
+//=============================================================================
+// Part of Hyperliquid Plugin for Zorro
+//
+// LAYER: Transport
+// DEPENDENCIES: ws_types.h
+// THREAD SAFETY: All public methods are thread-safe (internal lock)
+//
+// One record per (connection, subscription) — e.g. "l2Book:BTC" on
+// connection 2, "orderUpdates" on connection 0. Records are created when a
+// subscription is requested and track:
+//   requested -> sent -> acked (subscriptionResponse) -> first data -> last data
+// plus a message counter. Replaces guessing liveness from PriceCache
+// (getBid > 0), which cannot tell "acked but quiet" from "silently dropped".
+//=============================================================================
+
+#pragma once
+
+#include "ws_types.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace hl {
+namespace ws {
+
+/// Where a subscription stands — status() answers "will data come?"
+enum class SubStatus {
+    None,       // Never requested on this connection
+    Requested,  // Queued or resubscribing after reconnect, not sent yet
+    Sent,       // Sent, waiting for subscriptionResponse
+    Acked,      // Acked, no data since (re)subscribe
+    Live,       // Data received since (re)subscribe
+    Dead        // Sent but never acked within the ack timeout
+};
+
+const char* subStatusName(SubStatus status);
+
+/// Snapshot row of the registry (see SubscriptionRegistry::snapshot)
+struct SubscriptionInfo {
+    std::string key;             // "l2Book:BTC", "clearinghouseState:xyz", ...
+    int connection = 0;
+    SubStatus status = SubStatus::None;
+    int sends = 0;               // Subscribe frames sent (including resends)
+    DWORD requestedAt = 0;       // GetTickCount() ticks, 0 = never
+    DWORD sentAt = 0;
+    DWORD ackedAt = 0;
+    DWORD firstDataAt = 0;       // First data ever (survives reconnects)
+    DWORD lastDataAt = 0;
+    long long messages = 0;
+};
+
+class SubscriptionRegistry {
+public:
+    explicit SubscriptionRegistry(DWORD ackTimeoutMs);
+    ~SubscriptionRegistry();
+
+    SubscriptionRegistry(const SubscriptionRegistry&) = delete;
+    SubscriptionRegistry& operator=(const SubscriptionRegistry&) = delete;
+
+    /// "type" or "type:arg" (arg = coin or dex; empty arg -> "type")
+    static std::string makeKey(const char* type, const char* arg = nullptr);
+
+    void onRequested(int connection, const std::string& key, DWORD now);
+    void onSent(int connection, const std::string& key, DWORD now);
+    void onAcked(int connection, const std::string& key, DWORD now);
+    void onData(int connection, const std::string& key, DWORD now);
+
+    /// onData(connection, makeKey(type, arg)) for callers holding a symbol
+    /// id for arg (l2Book coins). The record is cached per (connection, id),
+    /// so only the first call for a pair builds the key.
+    void onData(int connection, uint32_t argId, const char* type, const char* arg, DWORD now);
+
+    /// Server forgot every subscription of this connection; they are replayed,
+    /// so records go back to Requested. Data history is kept.
+    void onConnectionLost(int connection);
+
+    void remove(int connection, const std::string& key);
+    void clear();
+
+    /// O(1) lookup
+    SubStatus status(int connection, const std::string& key, DWORD now) const;
+    bool willReceiveData(int connection, const std::string& key, DWORD now) const;
+
+    /// True if the subscription ever delivered data (across reconnects)
+    bool hadData(int connection, const std::string& key) const;
+
+    std::vector<SubscriptionInfo> snapshot(DWORD now) const;
+
+private:
+    struct Record {
+        SubscriptionInfo info;
+        bool sent;                  // Tick 0 is a valid tick — explicit flags
+        bool acked;
+        bool everData;
+        bool dataSinceSubscribe;
+    };
+
+    DWORD ackTimeoutMs_;
+    mutable CRITICAL_SECTION cs_;
+    std::unordered_map<std::string, Record> records_;
+    std::unordered_map<uint64_t, Record*> byArgId_;    // (connection, id) -> record; nodes never move
+
+    static std::string recordKey(int connection, const std::string& key);
+    Record& recordFor(int connection, const std::string& key);
+    SubStatus statusOf(const Record& r, DWORD now) const;
+    static void markData(Record& r, DWORD now);
+};
+
+} // namespace ws
+} // namespace hl
@@ -0,0 +1,166 @@
+//=============================================================================
+// ws_sub_scheduler.cpp - Paced, prioritized l2Book subscription scheduler
+//=============================================================================
+// Part of Hyperliquid Plugin for Zorro
+//
+// LAYER: Transport
+//=============================================================================
+
+#include "ws_sub_scheduler.h"
+
+namespace hl {
+namespace ws {
+
+//=============================================================================
+// CONSTRUCTION / CONFIGURATION
+//=============================================================================
+
+SubscriptionScheduler::SubscriptionScheduler()
+    : nextSeq_(1ull << 32), frontSeq_(1ull << 32), ackedCount_(0),
+      rate_(25.0), burst_(10), tokens_(10.0), lastRefill_(0), refillStarted_(false) {}
+
+void SubscriptionScheduler::setPacing(double framesPerSec, int burst) {
+    rate_ = framesPerSec > 0 ? framesPerSec : 1.0;
+    burst_ = burst > 0 ? burst : 1;
+    if (tokens_ > burst_) tokens_ = burst_;
+}
+
+void SubscriptionScheduler::refill(DWORD now) {
+    if (!refillStarted_) {
+        refillStarted_ = true;
+        lastRefill_ = now;
+        return;
+    }
+    DWORD elapsed = now - lastRefill_;  // Wraps correctly (unsigned)
+    if (elapsed == 0) return;
+    tokens_ += elapsed * rate_ / 1000.0;
+    if (tokens_ > burst_) tokens_ = burst_;
+    lastRefill_ = now;
+}
+
+//=============================================================================
+// QUEUE MANAGEMENT
+//=============================================================================
+
+void SubscriptionScheduler::pushQueued(const std::string& coin, Entry& e, bool front) {
+    if (e.state == State::Acked) ackedCount_--;
+    e.state = State::Queued;
+    e.sentAt = 0;
+    e.seq = front ? --frontSeq_ : nextSeq_++;
+    queue_.insert(QueueKey{ e.priority, e.seq, coin });
+}
+
+void SubscriptionScheduler::enqueue(const std::string& coin, int priority) {
+    if (entries_.count(coin)) return;
+    Entry& e = entries_[coin];
+    e.priority = priority;
+    e.timeouts = 0;
+    e.state = State::Sent;  // pushQueued transitions to Queued
+    pushQueued(coin, e, false);
+}
+
+void SubscriptionScheduler::remove(const std::string& coin) {
+    auto it = entries_.find(coin);
+    if (it == entries_.end()) return;
+    if (it->second.state == State::Queued)
+        queue_.erase(QueueKey{ it->second.priority, it->second.seq, coin });
+    else if (it->second.state == State::Acked)
+        ackedCount_--;
+    entries_.erase(it);
+}
+
+void SubscriptionScheduler::clear() {
+    entries_.clear();
+    queue_.clear();
+    ackedCount_ = 0;
+}
+
+bool SubscriptionScheduler::isAcked(const std::string& coin) const {
+    auto it = entries_.find(coin);
+    return it != entries_.end() && it->second.state == State::Acked;
+}
+
+bool SubscriptionScheduler::isQueued(const std::string& coin) const {
+    auto it = entries_.find(coin);
+    return it != entries_.end() && it->second.state == State::Queued;
+}
+
+std::vector<std::string> SubscriptionScheduler::takeReady(DWORD now) {
+    std::vector<std::string> ready;
+    if (queue_.empty()) return ready;
+
+    refill(now);
+    int n = (int)tokens_;
+    if (n <= 0) return ready;
+    if (n > (int)queue_.size()) n = (int)queue_.size();
+
+    ready.reserve(n);
+    for (int i = 0; i < n; ++i) {
+        auto qit = queue_.begin();
+        Entry& e = entries_[qit->coin];
+        e.state = State::Sent;
+        e.sentAt = now;
+        ready.push_back(qit->coin);
+        queue_.erase(qit);
+    }
+    tokens_ -= n;
+    return ready;
+}
+
+void SubscriptionScheduler::requeue(const std::string& coin) {
+    auto it = entries_.find(coin);
+    if (it == entries_.end() || it->second.state == State::Queued) return;
+    pushQueued(coin, it->second, true);
+    if (tokens_ + 1 <= burst_) tokens_ += 1;  // Frame never left — refund
+}
+
+void SubscriptionScheduler::onAck(const std::string& coin) {
+    auto it = entries_.find(coin);
+    if (it == entries_.end() || it->second.state == State::Acked) return;
+    // Late ack for a coin already requeued: it IS subscribed, drop the resend
+    if (it->second.state == State::Queued)
+        queue_.erase(QueueKey{ it->second.priority, it->second.seq, coin });
+    it->second.state = State::Acked;
+    it->second.timeouts = 0;
+    ackedCount_++;
+}
+
+int SubscriptionScheduler::requeueUnacked(DWORD now, DWORD timeoutMs, int maxAttempts,
+                                          std::vector<std::string>* givenUp) {
+    int count = 0;
+    for (auto it = entries_.begin(); it != entries_.end(); ) {
+        Entry& e = it->second;
+        if (e.state != State::Sent || now - e.sentAt < timeoutMs) { ++it; continue; }
+        if (++e.timeouts >= maxAttempts) {
+            // Sent entries are neither queued nor counted as acked
+            if (givenUp) givenUp->push_back(it->first);
+            it = entries_.erase(it);
+            continue;
+        }
+        pushQueued(it->first, e, true);
+        count++;
+        ++it;
+    }
+    return count;
+}
+
+void SubscriptionScheduler::resetAll(const std::map<std::string, int>& priorities) {
+    queue_.clear();
+    ackedCount_ = 0;
+    for (auto& kv : entries_) {
+        auto p = priorities.find(kv.first);
+        kv.second.priority = p != priorities.end() ? p->second : SUB_PRIORITY_NORMAL;
+        kv.second.state = State::Sent;  // pushQueued transitions to Queued
+        pushQueued(kv.first, kv.second, false);
+    }
+}
+
+std::vector<std::string> SubscriptionScheduler::coins() const {
+    std::vector<std::string> result;
+    result.reserve(entries_.size());
+    for (const auto& kv : entries_) result.push_back(kv.first);
+    return result;
+}
+
+} // namespace ws
+} // namespace hl
@@ -0,0 +1,128 @@
+//=============================================================================
+// ws_sub_scheduler.h - Paced, prioritized l2Book subscription scheduler
+//=============================================================================
+// Part of Hyperliquid Plugin for Zorro
+//
+// LAYER: Transport
+// DEPENDENCIES: ws_types.h
+// THREAD SAFETY: NOT thread-safe — owner serializes access (ws_manager uses
+//                l2SubCs_)
+//
+// Replaces the "one frame per coin in a tight loop" resubscribe burst that
+// triggered server-side disconnects with large symbol lists [OPM-170]:
+//   - Token bucket paces subscribe frames (rate per second + burst)
+//   - Queue is ordered by priority (lower value first), then FIFO
+//   - Each coin is Queued -> Sent -> Acked (subscriptionResponse); coins
+//     sent but never acked are requeued after a timeout, and dropped once
+//     they have timed out maxAttempts times without an ack
+//=============================================================================
+
+#pragma once
+
+#include "ws_types.h"
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace hl {
+namespace ws {
+
+/// Subscription priority classes (lower = sent first)
+enum SubPriority {
+    SUB_PRIORITY_POSITION = 0,    // Coin has an open position
+    SUB_PRIORITY_ORDER    = 1,    // Coin has a resting order
+    SUB_PRIORITY_NORMAL   = 2
+};
+
+class SubscriptionScheduler {
+public:
+    enum class State { Queued, Sent, Acked };
+
+    SubscriptionScheduler();
+
+    /// Configure pacing. burst = frames allowed back-to-back after idle.
+    void setPacing(double framesPerSec, int burst);
+    double rate() const { return rate_; }
+    int burst() const { return burst_; }
+
+    /// Add a coin (no-op if already known). Lower priority value = earlier.
+    void enqueue(const std::string& coin, int priority = SUB_PRIORITY_NORMAL);
+
+    /// Forget a coin entirely (e.g. banned)
+    void remove(const std::string& coin);
+    void clear();
+
+    bool contains(const std::string& coin) const { return entries_.count(coin) > 0; }
+    bool isAcked(const std::string& coin) const;
+    bool isQueued(const std::string& coin) const;
+
+    /// Pop the queued coins the token bucket allows right now, best
+    /// priority first. Returned coins are in the Sent state.
+    std::vector<std::string> takeReady(DWORD now);
+
+    /// Send failed — put the coin back at the front of its class and refund
+    /// the token.
+    void requeue(const std::string& coin);
+
+    /// subscriptionResponse received for coin
+    void onAck(const std::string& coin);
+
+    /// Coins sent more than timeoutMs ago without ack go back to the queue.
+    /// A coin that has now timed out maxAttempts times since its last ack is
+    /// removed instead and appended to `givenUp` (if given).
+    /// @return number of coins requeued
+    int requeueUnacked(DWORD now, DWORD timeoutMs, int maxAttempts,
+                       std::vector<std::string>* givenUp = nullptr);
+
+    /// After a reconnect the server has forgotten every subscription: move
+    /// all coins back to Queued with the priority from `priorities`; coins
+    /// not in it drop back to SUB_PRIORITY_NORMAL. Ack timeouts are kept, so
+    /// a coin the server never acks cannot dodge the cap by reconnecting.
+    void resetAll(const std::map<std::string, int>& priorities);
+
+    /// All known coins (any state)
+    std::vector<std::string> coins() const;
+
+    int size() const { return (int)entries_.size(); }
+    int queuedCount() const { return (int)queue_.size(); }
+    int ackedCount() const { return ackedCount_; }
+    int sentCount() const { return size() - queuedCount() - ackedCount_; }
+
+private:
+    struct Entry {
+        int priority;
+        unsigned long long seq;
+        State state;
+        DWORD sentAt;
+        int timeouts;           // Ack timeouts since the last ack
+    };
+    struct QueueKey {
+        int priority;
+        unsigned long long seq;
+        std::string coin;
+        bool operator<(const QueueKey& o) const {
+            if (priority != o.priority) return priority < o.priority;
+            return seq < o.seq;
+        }
+    };
+
+    std::map<std::string, Entry> entries_;
+    std::set<QueueKey> queue_;
+    unsigned long long nextSeq_;
+    unsigned long long frontSeq_;   // Decrements — requeued coins jump ahead
+    int ackedCount_;
+
+    // Token bucket
+    double rate_;
+    int burst_;
+    double tokens_;
+    DWORD lastRefill_;
+    bool refillStarted_;
+
+    void refill(DWORD now);
+    void pushQueued(const std::string& coin, Entry& e, bool front);
+};
+
+} // namespace ws
+} // namespace hl
@@ -4,14 +4,14 @@
 // Part of Hyperliquid Plugin for Zorro
 //
 // LAYER: Transport
-// DEPENDENCIES: <windows.h>, <string>
+// DEPENDENCIES: hl_platform.h, <string>
 // THREAD SAFETY: All structures are POD or simple types (thread-safety
 //                depends on external synchronization)
 //=============================================================================
 
 #pragma once
 
-#include <windows.h>
+#include "../foundation/hl_platform.h"
 #include <string>
 
 namespace hl {
@@ -97,6 +97,15 @@ struct FillData {
     FillData() : isBuy(false), px(0), sz(0), fee(0), time(0) {}
 };
 
+/// Stored fills of one order, summed (PriceCache::getFillTotals)
+struct FillTotal {
+    double size;           // Total filled size
+    double avgPx;          // Size-weighted average price (0 if no fills)
+    int fills;             // Fills summed
+
+    FillTotal() : size(0), avgPx(0), fills(0) {}
+};
+
 //=============================================================================
 // ORDER REQUEST/RESPONSE FOR WEBSOCKET POST
 //=============================================================================
@@ -0,0 +1,158 @@
+//=============================================================================
+// bench_broker_trade.cpp - Trade-map cost of a BrokerTrade sweep
+//=============================================================================
+// Part of Hyperliquid Plugin for Zorro
+//
+// LAYER: Test (benchmark)
+// PURPOSE: Zorro calls BrokerTrade once per open trade per tick. Measure the
+//          trade-map part of that call (read the order, apply the WS fill
+//          total, read what the return path needs) for:
+//            before - map of full OrderState (~460 bytes): BrokerTrade's
+//                     getOrder, then trading::updateOrder's own getOrder,
+//                     modify and full write-back
+//            after  - map of 64-byte OrderRecord: copy out the record,
+//                     one locked field update (applyFillProgress)
+//
+// SETUP:   OPEN_TRADES open orders with numeric oids and hex cloids; every
+//          round visits each trade once with a slightly larger fill total.
+//
+// EXPECTED: after -> higher calls/sec (one locked lookup fewer, ~1 KB less
+//           copied per call); the remaining cost is the lock and map walk,
+//           and the gap grows once the OrderState map no longer fits in cache
+//
+// NETWORK: None
+//=============================================================================
+
+#include "hl_globals.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <map>
+
+using namespace hl;
+
+static const int OPEN_TRADES = 500;
+static const int ROUNDS = 2000;
+static const int REPEATS = 5;
+
+// Previous TradingState trade map: full OrderState per entry
+struct LegacyTradeMap {
+    std::map<int, OrderState> trades;
+
+    bool getOrder(int tradeId, OrderState& out) {
+        EnterCriticalSection(&g_trading.tradeCs);
+        auto it = trades.find(tradeId);
+        bool found = it != trades.end();
+        if (found) out = it->second;
+        LeaveCriticalSection(&g_trading.tradeCs);
+        return found;
+    }
+
+    bool updateOrder(int tradeId, const OrderState& state) {
+        EnterCriticalSection(&g_trading.tradeCs);
+        auto it = trades.find(tradeId);
+        bool found = it != trades.end();
+        if (found) it->second = state;
+        LeaveCriticalSection(&g_trading.tradeCs);
+        return found;
+    }
+};
+
+static OrderState makeOrder(int id) {
+    OrderState s;
+    sprintf_s(s.orderId, "%d", 300000000 + id);
+    sprintf_s(s.cloid, "0x%08x0000000000000000cafebabe", (unsigned)id);
+    strcpy_s(s.coin, (id % 3) ? "BTC" : "ETH");
+    s.requestedSize = 1000.0;
+    s.status = OrderStatus::Open;
+    s.zorroTradeId = id;
+    return s;
+}
+
+// Previous BrokerTrade shape: getOrder, monotonic check, trading::updateOrder
+static double runBefore(LegacyTradeMap& legacy, double& checksum) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 1; r <= ROUNDS; r++) {
+        double total = r * 0.1;
+        for (int id = 1; id <= OPEN_TRADES; id++) {
+            OrderState state;
+            if (!legacy.getOrder(id, state)) continue;
+            if (total >= state.filledSize) {
+                // trading::updateOrder: its own get, modify, full write-back
+                OrderState updated;
+                if (legacy.getOrder(id, updated)) {
+                    updated.filledSize = total;
+                    updated.avgPrice = 50000.0 + id;
+                    updated.status = determineFilledStatus(total, state.requestedSize);
+                    updated.lastUpdate = 45000.0 + r;
+                    legacy.updateOrder(id, updated);
+                }
+                state.filledSize = total;
+                state.avgPrice = 50000.0 + id;
+            }
+            checksum += state.filledSize * state.avgPrice + (double)state.side;
+        }
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(t1 - t0).count();
+}
+
+// Current BrokerTrade shape: getRecord, applyFillProgress
+static double runAfter(double& checksum) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 1; r <= ROUNDS; r++) {
+        double total = r * 0.1;
+        for (int id = 1; id <= OPEN_TRADES; id++) {
+            OrderRecord rec;
+            if (!g_trading.getRecord(id, rec)) continue;
+            OrderStatus st;
+            double avgPx = 50000.0 + id;
+            if (g_trading.applyFillProgress(id, total, avgPx, 45000.0 + r, &st)) {
+                rec.filledSize = total;
+                rec.avgPrice = avgPx;
+                rec.status = (uint8_t)st;
+            }
+            checksum += rec.filledSize * rec.avgPrice + (double)rec.orderSide();
+        }
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(t1 - t0).count();
+}
+
+int main() {
+    printf("=== BrokerTrade Trade-Map Benchmark ===\n");
+    printf("open_trades=%d rounds=%d sizeof(OrderState)=%zu sizeof(OrderRecord)=%zu\n\n",
+           OPEN_TRADES, ROUNDS, sizeof(OrderState), sizeof(OrderRecord));
+
+    g_trading.init();
+    LegacyTradeMap legacy;
+    for (int id = 1; id <= OPEN_TRADES; id++) {
+        OrderState s = makeOrder(id);
+        legacy.trades[id] = s;
+        g_trading.setOrder(id, s);
+    }
+
+    // Best of REPEATS; each run restarts the fill totals from zero
+    double secBefore = 1e9, secAfter = 1e9;
+    double sumBefore = 0, sumAfter = 0;
+    for (int rep = 0; rep < REPEATS; rep++) {
+        for (auto& t : legacy.trades) t.second.filledSize = 0;
+        for (int id = 1; id <= OPEN_TRADES; id++)
+            g_trading.applyFill(id, 0, 0, OrderStatus::Open, 0);
+        sumBefore = sumAfter = 0;
+        secBefore = std::min(secBefore, runBefore(legacy, sumBefore));
+        secAfter = std::min(secAfter, runAfter(sumAfter));
+    }
+    double calls = (double)OPEN_TRADES * ROUNDS;
+
+    printf("%-8s %14s %10s\n", "path", "calls_per_sec", "ns_call");
+    printf("%-8s %14.0f %10.1f\n", "before", calls / secBefore, secBefore * 1e9 / calls);
+    printf("%-8s %14.0f %10.1f\n", "after", calls / secAfter, secAfter * 1e9 / calls);
+    printf("\nspeedup: %.1fx\n", secAfter > 0 ? secBefore / secAfter : 0.0);
+
+    g_trading.cleanup();
+    bool ok = sumBefore == sumAfter;
+    if (!ok) printf("checksum mismatch: %.6f vs %.6f\n", sumBefore, sumAfter);
+    return ok ? 0 : 1;
+}
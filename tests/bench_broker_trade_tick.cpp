@@ -0,0 +1,188 @@
+//=============================================================================
+// bench_broker_trade_tick.cpp - BrokerTrade cost per Zorro tick
+//=============================================================================
+// Part of Hyperliquid Plugin for Zorro
+//
+// LAYER: Test (benchmark)
+// PURPOSE: Zorro calls BrokerTrade once per open trade per tick. Measure a
+//          full tick over OPEN_TRADES trades for:
+//            before - each call on its own: record lookup, copy of the
+//                     order's WS fills, fill update, getPrice (three
+//                     PriceCache locks) for the P&L
+//            after  - trading::getTradeView: the first call of the tick
+//                     evaluates every trade in one pass (one trade-map lock,
+//                     one fill-store lock, one getPrice per coin), the rest
+//                     are snapshot lookups
+//
+// SETUP:   OPEN_TRADES partially filled orders over COINS coins, each with
+//          FILLS_PER_ORDER fills in the PriceCache; fresh WS prices so
+//          getPrice never falls back to HTTP.
+//
+// EXPECTED: after -> several times fewer ns per call; the gap grows with
+//           trades per coin. Both paths report the same P&L (checksum).
+//
+// NETWORK: None
+//=============================================================================
+
+#define MOCK_ZORRO_IMPLEMENTATION
+#include "mocks/mock_zorro.h"
+#include "hl_globals.h"
+#include "hl_trading_service.h"
+#include "hl_market_service.h"
+#include "hl_trade_snapshot.h"
+#include "ws_price_cache.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+using namespace hl;
+
+static const int OPEN_TRADES = 100;
+static const int COINS = 5;
+static const int FILLS_PER_ORDER = 3;
+static const int TICKS = 2000;
+static const int REPEATS = 5;
+
+static const char* COIN_NAMES[COINS] = { "BTC", "ETH", "SOL", "ARB", "DOGE" };
+
+static ws::PriceCache* g_cache = nullptr;
+
+static void setup() {
+    g_trading.init();
+    g_trading.lotSize = 0.001;
+    g_config.enableWebSocket = true;
+    g_config.diagLevel = 0;
+    g_cache = new ws::PriceCache();
+    g_priceCache = g_cache;
+
+    for (int id = 1; id <= OPEN_TRADES; id++) {
+        OrderState s;
+        sprintf_s(s.orderId, "%d", 300000000 + id);
+        sprintf_s(s.cloid, "0x%08x0000000000000000cafebabe", (unsigned)id);
+        strcpy_s(s.coin, COIN_NAMES[id % COINS]);
+        s.side = (id & 1) ? OrderSide::Buy : OrderSide::Sell;
+        s.requestedSize = 1.0;
+        s.status = OrderStatus::Open;
+        s.zorroTradeId = id;
+        g_trading.setOrder(id, s);
+
+        for (int f = 0; f < FILLS_PER_ORDER; f++) {
+            ws::FillData fill;
+            fill.coin = s.coin;
+            fill.oid = s.orderId;
+            fill.tid = std::to_string(id * 10 + f);
+            fill.isBuy = (s.side == OrderSide::Buy);
+            fill.px = 1000.0 * (1 + id % COINS) + f;
+            fill.sz = 0.1;
+            g_cache->addFill(fill);
+        }
+    }
+}
+
+static void refreshPrices(int tick) {
+    for (int c = 0; c < COINS; c++) {
+        double mid = 1000.0 * (1 + c) + (tick % 7);
+        g_cache->setBidAsk(COIN_NAMES[c], mid - 0.5, mid + 0.5);
+    }
+}
+
+// Previous BrokerTrade generic path, one trade per call
+static int brokerTradeBefore(int tradeId, double* pProfit) {
+    OrderRecord rec;
+    if (!g_trading.getRecord(tradeId, rec)) return -1;
+    const char* coin = g_trading.coinName(rec.coinId);
+    char oid[64] = {0};
+    TradingState::formatOid(rec, oid, sizeof(oid));
+
+    auto wsFills = g_cache->getFillsForOrder(oid);
+    if (!wsFills.empty()) {
+        double totalFilled = 0, totalValue = 0;
+        for (const auto& fill : wsFills) {
+            totalFilled += fill.sz;
+            totalValue += fill.px * fill.sz;
+        }
+        double avgPx = totalValue / totalFilled;
+        OrderStatus newSt;
+        if (trading::updateFillProgress(tradeId, totalFilled, avgPx, &newSt)) {
+            rec.filledSize = totalFilled;
+            rec.avgPrice = avgPx;
+            rec.status = (uint8_t)newSt;
+        }
+    }
+
+    if (rec.avgPrice > 0 && rec.filledSize > 0) {
+        PriceData price = market::getPrice(coin);
+        double currentPx = price.mid > 0 ? price.mid : price.ask;
+        if (currentPx > 0) {
+            double pnl = (currentPx - rec.avgPrice) * rec.filledSize;
+            if (rec.orderSide() == OrderSide::Sell) pnl = -pnl;
+            *pProfit = pnl;
+        }
+    }
+    if (rec.filledSize > 0) {
+        int lots = (int)round(rec.filledSize / g_trading.lotSize);
+        return lots > 0 ? lots : 1;
+    }
+    return 0;
+}
+
+static double runBefore(double& checksum) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (int t = 0; t < TICKS; t++) {
+        refreshPrices(t);
+        for (int id = 1; id <= OPEN_TRADES; id++) {
+            double profit = 0;
+            int lots = brokerTradeBefore(id, &profit);
+            checksum += lots + profit;
+        }
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(t1 - t0).count();
+}
+
+static double runAfter(double& checksum) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (int t = 0; t < TICKS; t++) {
+        refreshPrices(t);
+        for (int id = 1; id <= OPEN_TRADES; id++) {
+            trading::TradeView v = trading::getTradeView(id);
+            checksum += v.lots + (v.hasProfit ? v.profit : 0.0);
+        }
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(t1 - t0).count();
+}
+
+int main() {
+    printf("=== BrokerTrade Per-Tick Benchmark ===\n");
+    printf("open_trades=%d coins=%d fills_per_order=%d ticks=%d\n\n",
+           OPEN_TRADES, COINS, FILLS_PER_ORDER, TICKS);
+
+    setup();
+
+    double secBefore = 1e9, secAfter = 1e9;
+    double sumBefore = 0, sumAfter = 0;
+    for (int rep = 0; rep < REPEATS; rep++) {
+        trading::resetTradeSnapshot();
+        sumBefore = sumAfter = 0;
+        secBefore = std::min(secBefore, runBefore(sumBefore));
+        secAfter = std::min(secAfter, runAfter(sumAfter));
+    }
+    double calls = (double)OPEN_TRADES * TICKS;
+    trading::TradeSnapshotStats st = trading::getTradeSnapshotStats();
+
+    printf("%-8s %14s %10s\n", "path", "calls_per_sec", "ns_call");
+    printf("%-8s %14.0f %10.1f\n", "before", calls / secBefore, secBefore * 1e9 / calls);
+    printf("%-8s %14.0f %10.1f\n", "after", calls / secAfter, secAfter * 1e9 / calls);
+    printf("\nspeedup: %.1fx  (last run: rebuilds=%lld hits=%lld misses=%lld)\n",
+           secAfter > 0 ? secBefore / secAfter : 0.0, st.rebuilds, st.hits, st.misses);
+
+    g_priceCache = nullptr;
+    delete g_cache;
+    g_trading.cleanup();
+    bool ok = fabs(sumBefore - sumAfter) < 1e-6 * (1.0 + fabs(sumBefore));
+    if (!ok) printf("checksum mismatch: %.6f vs %.6f\n", sumBefore, sumAfter);
+    return ok ? 0 : 1;
+}
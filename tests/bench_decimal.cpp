@@ -0,0 +1,143 @@
+//=============================================================================
+// bench_decimal.cpp - ns per px/sz field: decimal kernels vs C runtime
+//=============================================================================
+// Part of Hyperliquid Plugin for Zorro
+//
+// LAYER: Test (benchmark)
+// PURPOSE: Cost of one price/size field in each direction:
+//            inbound  - json::getDouble on "px"/"sz" strings: atof before,
+//                       decimal::parse after
+//            outbound - formatPriceForExchange / formatSize /
+//                       eip712::formatNumber: ostringstream or snprintf +
+//                       std::string trimming before, decimal::formatFixed /
+//                       formatTrimmed after
+//
+// SETUP:   FIELDS log-uniform prices (1e-6 .. 1e6) in exchange string form,
+//          szDecimals cycling 0..5. Each variant's output is checked
+//          against the previous implementation before timing.
+//
+// EXPECTED: parse several times faster than atof; formatting several times
+//           faster than ostringstream / snprintf with trimming
+//
+// NETWORK: None
+//=============================================================================
+
+#include "hl_decimal.h"
+#include "hl_utils.h"
+#include "hl_platform.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace hl;
+
+static const int FIELDS = 100000;
+static const int ROUNDS = 20;
+
+// Previous implementations
+static std::string oldPriceForExchange(double price, int szDecimals) {
+    double rounded = utils::roundPriceForExchange(price, szDecimals, 6);
+    int maxDecPlaces = 6 - szDecimals;
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(maxDecPlaces) << rounded;
+    std::string s = oss.str();
+    size_t dot = s.find('.');
+    if (dot != std::string::npos) {
+        size_t end = s.find_last_not_of('0');
+        if (end != std::string::npos)
+            s = s.substr(0, end + 1);
+        if (!s.empty() && s.back() == '.')
+            s.pop_back();
+    }
+    return s;
+}
+
+static std::string oldFormatSize(double size, int szDecimals) {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(szDecimals) << size;
+    return oss.str();
+}
+
+static std::string oldFormatNumber(double value) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.8f", value);
+    std::string s(buf);
+    size_t dot = s.find('.');
+    if (dot != std::string::npos) {
+        size_t end = s.find_last_not_of('0');
+        if (end != std::string::npos)
+            s = s.substr(0, end + 1);
+        if (!s.empty() && s.back() == '.')
+            s.pop_back();
+    }
+    return s;
+}
+
+static std::string newFormatNumber(double value) {
+    char buf[decimal::MAX_FIXED_CHARS];
+    int n = decimal::formatTrimmed(value, 8, buf, sizeof(buf));
+    return std::string(buf, n);
+}
+
+template <class Fn>
+static double nsPerField(Fn fn) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < ROUNDS; r++)
+        for (int i = 0; i < FIELDS; i++) fn(i);
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / ((double)FIELDS * ROUNDS);
+}
+
+static void report(const char* label, double before, double after) {
+    printf("%-22s %10.1f %10.1f %8.1fx\n", label, before, after, before / after);
+}
+
+int main() {
+    printf("=== Decimal px/sz Kernel Benchmark ===\n");
+    printf("fields=%d rounds=%d\n\n", FIELDS, ROUNDS);
+
+    std::mt19937_64 rng(11);
+    std::uniform_real_distribution<double> exp10(-6.0, 6.0);
+    std::vector<double> values(FIELDS);
+    std::vector<std::string> strings(FIELDS);
+    char buf[64];
+    for (int i = 0; i < FIELDS; i++) {
+        values[i] = pow(10.0, exp10(rng));
+        sprintf_s(buf, "%.*f", 1 + i % 6, values[i]);
+        strings[i] = buf;
+    }
+
+    int mismatches = 0;
+    for (int i = 0; i < FIELDS; i++) {
+        int sz = i % 6;
+        if (decimal::parse(strings[i].c_str()) != atof(strings[i].c_str())) mismatches++;
+        if (utils::formatPriceForExchange(values[i], sz) != oldPriceForExchange(values[i], sz)) mismatches++;
+        if (utils::formatSize(values[i], sz) != oldFormatSize(values[i], sz)) mismatches++;
+        if (newFormatNumber(values[i]) != oldFormatNumber(values[i])) mismatches++;
+    }
+
+    volatile double sinkD = 0;
+    volatile size_t sinkN = 0;
+    printf("%-22s %10s %10s %9s\n", "field", "before_ns", "after_ns", "speedup");
+    report("parse px/sz",
+           nsPerField([&](int i) { sinkD = sinkD + atof(strings[i].c_str()); }),
+           nsPerField([&](int i) { sinkD = sinkD + decimal::parse(strings[i].c_str()); }));
+    report("formatPriceForExchange",
+           nsPerField([&](int i) { sinkN = sinkN + oldPriceForExchange(values[i], i % 6).size(); }),
+           nsPerField([&](int i) { sinkN = sinkN + utils::formatPriceForExchange(values[i], i % 6).size(); }));
+    report("formatSize",
+           nsPerField([&](int i) { sinkN = sinkN + oldFormatSize(values[i], i % 6).size(); }),
+           nsPerField([&](int i) { sinkN = sinkN + utils::formatSize(values[i], i % 6).size(); }));
+    report("formatNumber",
+           nsPerField([&](int i) { sinkN = sinkN + oldFormatNumber(values[i]).size(); }),
+           nsPerField([&](int i) { sinkN = sinkN + newFormatNumber(values[i]).size(); }));
+
+    if (mismatches) printf("\nFAILED: %d outputs differ from the previous implementation\n", mismatches);
+    return mismatches ? 1 : 0;
+}
@@ -0,0 +1,193 @@
+//=============================================================================
+// bench_fill_aggregator.cpp - userFills handling cost per frame
+//=============================================================================
+// Part of Hyperliquid Plugin for Zorro
+//
+// LAYER: Test (benchmark)
+// PURPOSE: Compare the old userFills path (cache the fills, then re-sum the
+//          last 100 cached fills and notify every oid in them) with the
+//          FillAggregator path (apply each new fill once, notify changed oids).
+//
+// SETUP:   One simulated minute at 10k fills/min: 2000 orders x 5 fills,
+//          20 orders filling concurrently, frames of 1-5 fills. Every
+//          REPLAY_EVERY frames a reconnect snapshot re-sends the last 50
+//          fills. Frames are pre-built JSON, parsed on every run.
+//
+// EXPECTED: aggregator -> fewer callbacks (changed oids only), zero wrong
+//                         totals after replays, lower ns/frame
+//           re-sum      -> callbacks for ~20 oids per frame, replayed fills
+//                         counted twice
+//
+// NETWORK: None
+//=============================================================================
+
+#include "ws_parsers.h"
+#include "ws_fill_aggregator.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace hl::ws;
+
+static const int TOTAL_FILLS = 10000;     // One minute at 10k fills/min
+static const int FILLS_PER_ORDER = 5;
+static const int CONCURRENT_ORDERS = 20;
+static const int REPLAY_EVERY = 1000;     // Frames between snapshot replays
+static const int REPLAY_FILLS = 50;
+
+struct Frame {
+    std::string json;
+    std::vector<std::pair<std::string, double>> newFills;  // Empty for replays
+};
+
+struct RunResult {
+    double avgNs;
+    double p99Ns;
+    long long callbacks;
+    long long wrongTotals;
+};
+
+// Truth for the callback check: oid -> cumulative size of unique fills so far
+static std::unordered_map<std::string, double> s_truth;
+static long long s_callbacks = 0;
+static long long s_wrong = 0;
+
+static void onFill(const char* oid, double totalSz, double /*avgPx*/) {
+    s_callbacks++;
+    if (std::fabs(totalSz - s_truth[oid]) > 1e-9) s_wrong++;
+}
+
+static std::string fillJson(long long oid, long long tid, double px, double sz) {
+    char buf[256];
+    snprintf(buf, sizeof(buf),
+             "{\"coin\":\"BTC\",\"px\":\"%.1f\",\"sz\":\"%.4f\",\"side\":\"B\","
+             "\"time\":%lld,\"oid\":%lld,\"tid\":%lld,\"fee\":\"0.01\"}",
+             px, sz, 1700000000000LL + tid, oid, tid);
+    return buf;
+}
+
+static std::vector<Frame> buildFrames() {
+    struct Fill { long long oid, tid; double px, sz; };
+    std::vector<Fill> fills;
+    const int block = CONCURRENT_ORDERS * FILLS_PER_ORDER;
+    for (int i = 0; i < TOTAL_FILLS; i++) {
+        long long oid = 9000000 + (i % CONCURRENT_ORDERS) + CONCURRENT_ORDERS * (i / block);
+        fills.push_back({oid, 500000000LL + i, 50000.0 + (i % 37), 0.001 * (1 + i % 7)});
+    }
+
+    std::vector<Frame> frames;
+    unsigned seed = 12345;
+    size_t pos = 0;
+    while (pos < fills.size()) {
+        if (!frames.empty() && frames.size() % REPLAY_EVERY == 0) {
+            Frame replay;
+            replay.json = "{\"channel\":\"userFills\",\"data\":{\"isSnapshot\":true,\"fills\":[";
+            size_t from = pos > (size_t)REPLAY_FILLS ? pos - REPLAY_FILLS : 0;
+            for (size_t i = from; i < pos; i++) {
+                if (i > from) replay.json += ',';
+                replay.json += fillJson(fills[i].oid, fills[i].tid, fills[i].px, fills[i].sz);
+            }
+            replay.json += "]}}";
+            frames.push_back(replay);
+        }
+
+        seed = seed * 1103515245u + 12345u;
+        size_t n = std::min<size_t>(1 + (seed >> 16) % 5, fills.size() - pos);
+        Frame f;
+        f.json = "{\"channel\":\"userFills\",\"data\":{\"fills\":[";
+        for (size_t i = 0; i < n; i++) {
+            const Fill& x = fills[pos + i];
+            if (i) f.json += ',';
+            f.json += fillJson(x.oid, x.tid, x.px, x.sz);
+            f.newFills.push_back({std::to_string(x.oid), x.sz});
+        }
+        f.json += "]}}";
+        frames.push_back(f);
+        pos += n;
+    }
+    return frames;
+}
+
+// Previous WebSocketManager::parseUserFills
+static void resumPath(PriceCache& cache, const char* json) {
+    parseUserFills(cache, json, 0, nullptr);
+    auto fills = cache.getRecentFills(100);
+    std::map<std::string, std::pair<double, double>> totals;
+    for (const auto& f : fills) {
+        auto& t = totals[f.oid];
+        t.first += f.sz;
+        t.second += f.sz * f.px;
+    }
+    for (const auto& entry : totals) {
+        double avgPx = entry.second.first > 0 ? entry.second.second / entry.second.first : 0;
+        onFill(entry.first.c_str(), entry.second.first, avgPx);
+    }
+}
+
+// Current WebSocketManager::parseUserFills
+static void aggregatorPath(PriceCache& cache, FillAggregator& agg, const char* json) {
+    std::vector<FillData> fills;
+    parseUserFillsList(json, fills, 0, nullptr);
+    DWORD now = GetTickCount();
+    for (const auto& f : fills) {
+        if (agg.addFill(f, now)) cache.addFill(f);
+    }
+    for (const auto& t : agg.takeChanged()) onFill(t.oid.c_str(), t.filledSz, t.avgPx());
+}
+
+static RunResult run(const std::vector<Frame>& frames, bool useAggregator) {
+    PriceCache cache;
+    FillAggregator agg;
+    s_truth.clear();
+    s_callbacks = 0;
+    s_wrong = 0;
+
+    std::vector<double> ns;
+    ns.reserve(frames.size());
+    for (const auto& f : frames) {
+        for (const auto& nf : f.newFills) s_truth[nf.first] += nf.second;
+
+        auto t0 = std::chrono::steady_clock::now();
+        if (useAggregator) aggregatorPath(cache, agg, f.json.c_str());
+        else resumPath(cache, f.json.c_str());
+        auto t1 = std::chrono::steady_clock::now();
+        ns.push_back((double)std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+    }
+
+    RunResult r;
+    double sum = 0;
+    for (double v : ns) sum += v;
+    r.avgNs = sum / ns.size();
+    std::sort(ns.begin(), ns.end());
+    r.p99Ns = ns[(size_t)(ns.size() * 0.99)];
+    r.callbacks = s_callbacks;
+    r.wrongTotals = s_wrong;
+    return r;
+}
+
+int main() {
+    printf("=== userFills Aggregation Benchmark ===\n");
+    std::vector<Frame> frames = buildFrames();
+    printf("fills=%d frames=%zu orders=%d replay_every=%d frames\n\n",
+           TOTAL_FILLS, frames.size(), TOTAL_FILLS / FILLS_PER_ORDER, REPLAY_EVERY);
+
+    run(frames, false);   // Warm-up
+    RunResult resum = run(frames, false);
+    RunResult agg = run(frames, true);
+
+    printf("%-12s %12s %12s %12s %12s\n", "path", "avg_ns", "p99_ns", "callbacks", "wrong");
+    printf("%-12s %12.0f %12.0f %12lld %12lld\n", "re-sum",
+           resum.avgNs, resum.p99Ns, resum.callbacks, resum.wrongTotals);
+    printf("%-12s %12.0f %12.0f %12lld %12lld\n", "aggregator",
+           agg.avgNs, agg.p99Ns, agg.callbacks, agg.wrongTotals);
+    printf("\nspeedup: %.1fx, callbacks: %.1fx fewer\n",
+           agg.avgNs > 0 ? resum.avgNs / agg.avgNs : 0.0,
+           agg.callbacks > 0 ? (double)resum.callbacks / agg.callbacks : 0.0);
+
+    return agg.wrongTotals == 0 ? 0 : 1;
+}
@@ -0,0 +1,180 @@
+//=============================================================================
+// bench_l2book_alloc.cpp - Heap allocations and cost per l2Book update
+//=============================================================================
+// Part of Hyperliquid Plugin for Zorro
+//
+// LAYER: Test (benchmark)
+// PURPOSE: Steady-state work per l2Book frame on a WS connection thread:
+//            before - dispatch parses the frame, parseL2Book(json) parses it
+//                     again; registry watermark by "l2Book:<coin>" key
+//                     (+ "@<conn>" record key); standby dedup and prices in
+//                     std::map<std::string, ...>; getBid + setBidAsk by name
+//            after  - one parse into the thread's json::parse pool;
+//                     parseL2Book(root) returns the coin's g_symbols id;
+//                     registry, dedup and PriceCache are all keyed by that
+//                     id (setBidAsk reports the first quote)
+//
+// SETUP:   FRAMES pre-built frames over the coins below (main perps, HIP-3
+//          "dex:COIN" names, spot "@N"), every coin seen once before
+//          measuring. Allocations are counted by replacing operator new.
+//
+// EXPECTED: after -> 0 allocations per update; before -> allocations for
+//           every coin whose registry key outgrows the small-string buffer.
+//           yyjson documents per update: before 2 (malloc'd by yyjson, not
+//           counted by operator new), after 1 from the pool: no heap reads
+//           and no pool grows while measuring.
+//
+// NETWORK: None
+//=============================================================================
+
+#include "ws_parsers.h"
+#include "ws_price_cache.h"
+#include "ws_sub_registry.h"
+#include "json_pool.h"
+#include "yyjson.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <new>
+#include <string>
+#include <vector>
+
+using namespace hl::ws;
+
+static std::atomic<long long> g_news(0);
+
+void* operator new(size_t n) {
+    g_news++;
+    void* p = malloc(n ? n : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+static const int FRAMES = 4096;
+static const int ROUNDS = 50;
+static const int CONNECTION = 1;
+
+static const char* COINS[] = {
+    "BTC", "ETH", "SOL", "kPEPE", "HYPE", "@107", "@142",
+    "xyz:XYZ100", "xyz:GOLD", "flx:SILVER", "vntl:SPACEX", "km:USTECH100"
+};
+static const int NCOINS = sizeof(COINS) / sizeof(COINS[0]);
+
+static std::vector<std::string> buildFrames() {
+    std::vector<std::string> frames;
+    char buf[512];
+    for (int i = 0; i < FRAMES; i++) {
+        double px = 100.0 + (i % 97) * 0.25;
+        sprintf_s(buf, "{\"channel\":\"l2Book\",\"data\":{\"coin\":\"%s\",\"time\":%lld,"
+                  "\"levels\":[[{\"px\":\"%.2f\",\"sz\":\"3.5\",\"n\":4}],"
+                  "[{\"px\":\"%.2f\",\"sz\":\"1.25\",\"n\":2}]]}}",
+                  COINS[i % NCOINS], 1700000000000LL + i, px, px + 0.25);
+        frames.push_back(buf);
+    }
+    return frames;
+}
+
+// Previous per-frame path (string-keyed structures)
+struct Before {
+    SubscriptionRegistry registry{5000};
+    std::map<std::string, long long> lastBookTime;
+    std::map<std::string, PriceData> prices;
+    CRITICAL_SECTION cs;
+    Before() { InitializeCriticalSection(&cs); }
+    ~Before() { DeleteCriticalSection(&cs); }
+
+    double handle(const std::string& frame) {
+        yyjson_doc* doc = yyjson_read(frame.c_str(), frame.size(), 0);
+        L2BookUpdate r = parseL2Book(frame.c_str(), 0, nullptr);
+        registry.onData(CONNECTION, SubscriptionRegistry::makeKey("l2Book", r.coin), 1);
+        long long& last = lastBookTime[r.coin];
+        if (r.time > last) last = r.time;
+        EnterCriticalSection(&cs);
+        auto it = prices.find(r.coin);
+        bool isFirst = it == prices.end() || it->second.bid <= 0;
+        LeaveCriticalSection(&cs);
+        EnterCriticalSection(&cs);
+        PriceData& p = prices[r.coin];
+        p.bid = r.bid;
+        p.ask = r.ask;
+        p.mid = (r.bid + r.ask) / 2.0;
+        LeaveCriticalSection(&cs);
+        yyjson_doc_free(doc);
+        return p.mid + (isFirst ? 1 : 0);
+    }
+};
+
+// Current path (WebSocketManager::handleMessage -> parseL2Book)
+struct After {
+    SubscriptionRegistry registry{5000};
+    std::vector<long long> lastBookTime;
+    PriceCache cache;
+
+    double handle(const std::string& frame) {
+        yyjson_doc* doc = hl::json::parse(frame.c_str(), frame.size());
+        L2BookUpdate r = parseL2Book(yyjson_doc_get_root(doc), 0, nullptr);
+        registry.onData(CONNECTION, r.coinId, "l2Book", r.coin, 1);
+        if (r.coinId >= lastBookTime.size())
+            lastBookTime.resize(hl::config::SYMBOL_MAX_IDS, 0);
+        long long& last = lastBookTime[r.coinId];
+        if (r.time > last) last = r.time;
+        bool isFirst = cache.setBidAsk(r.coinId, r.bid, r.ask);
+        yyjson_doc_free(doc);
+        return (r.bid + r.ask) / 2.0 + (isFirst ? 1 : 0);
+    }
+};
+
+template <class Path>
+static void run(const char* label, Path& path, const std::vector<std::string>& frames,
+                double& checksum, double& allocsPerUpdate) {
+    for (int i = 0; i < NCOINS; i++) path.handle(frames[i]);   // Warm-up: every coin once
+
+    long long news0 = g_news.load();
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < ROUNDS; r++)
+        for (const auto& f : frames) checksum += path.handle(f);
+    auto t1 = std::chrono::steady_clock::now();
+    long long news = g_news.load() - news0;
+
+    double updates = (double)FRAMES * ROUNDS;
+    double sec = std::chrono::duration<double>(t1 - t0).count();
+    allocsPerUpdate = news / updates;
+    printf("%-8s %12.0f %10.1f %14.3f\n", label, updates / sec, sec * 1e9 / updates,
+           allocsPerUpdate);
+}
+
+int main() {
+    printf("=== l2Book Update Allocation Benchmark ===\n");
+    printf("frames=%d rounds=%d coins=%d\n\n", FRAMES, ROUNDS, NCOINS);
+
+    std::vector<std::string> frames = buildFrames();
+    Before* before = new Before();
+    After* after = new After();
+
+    double sumBefore = 0, sumAfter = 0, allocBefore = 0, allocAfter = 0;
+    printf("%-8s %12s %10s %14s\n", "path", "updates_sec", "ns_update", "allocs_update");
+    run("before", *before, frames, sumBefore, allocBefore);
+    after->handle(frames[0]);                                    // Sizes this thread's pool
+    hl::json::PoolStats pool0 = hl::json::getPoolStats();
+    run("after", *after, frames, sumAfter, allocAfter);
+    hl::json::PoolStats pool1 = hl::json::getPoolStats();
+    long long poolHeap = pool1.heap - pool0.heap;
+    long long poolGrows = pool1.grows - pool0.grows;
+    printf("\nyyjson documents per update: before 2, after 1\n");
+    printf("after parse pool: pooled=%lld heap=%lld grows=%lld reserved=%lld bytes\n",
+           pool1.pooled - pool0.pooled, poolHeap, poolGrows, pool1.bytesReserved);
+
+    delete before;
+    delete after;
+
+    bool ok = allocAfter == 0.0 && poolHeap == 0 && poolGrows == 0 &&
+              std::abs(sumBefore - sumAfter) < 1e-6 * (1.0 + std::abs(sumBefore));
+    if (!ok) printf("FAILED: allocs_after=%.3f pool heap=%lld grows=%lld checksum %.6f vs %.6f\n",
+                    allocAfter, poolHeap, poolGrows, sumBefore, sumAfter);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,107 @@
+//=============================================================================
+// bench_latency.cpp - Cost of one latency sample
+//=============================================================================
+// Part of Hyperliquid Plugin for Zorro
+//
+// LAYER: Test (benchmark)
+// PURPOSE: What HL_LAT_BEGIN/HL_LAT_END adds to a hot-path stage:
+//            now        - one QueryPerformanceCounter read
+//            sample     - HL_LAT_BEGIN + HL_LAT_END around no work
+//            recordNs   - histogram update alone
+//            sample x4  - sample on 4 threads at once (own slabs)
+//            overflow   - sample on threads past LATENCY_MAX_THREADS
+//                         (shared slab, atomic adds)
+//
+// SETUP:   SAMPLES samples per thread, best of ROUNDS per thread. The x4
+//          rows need 4 free cores to mean anything. The last line prints the
+//          Parse stage the sample runs recorded, as HL_GET_LATENCY would.
+//
+// EXPECTED: sample under 50 ns: two clock reads plus a few ns of histogram
+//           update, so it tracks the cost of `now` (QPC on an invariant TSC
+//           is ~10-20 ns; a VM clock can be several times that). sample x4
+//           equal to sample while threads have their own slab.
+//
+// NETWORK: None
+//=============================================================================
+
+#include "hl_latency.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using namespace hl::lat;
+
+static const int SAMPLES = 2000000;
+static const int ROUNDS = 5;
+
+enum class Mode { Now, Sample, RecordNs };
+
+static std::atomic<uint64_t> g_sink(0);
+
+static double runOne(Mode mode) {
+    uint64_t sink = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < SAMPLES; i++) {
+        if (mode == Mode::Now) {
+            sink += now();
+        } else if (mode == Mode::Sample) {
+            HL_LAT_BEGIN(start);
+            HL_LAT_END(Parse, start);
+        } else {
+            recordNs(Stage::CachePublish, 100 + (i & 1023));
+        }
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+    g_sink += sink;
+    return ns / SAMPLES;
+}
+
+// `threads` running the loop at once; each keeps its best of ROUNDS on one
+// thread (one slab claimed per thread), the slowest thread is reported
+static double run(Mode mode, int threads) {
+    std::vector<double> best(threads, 1e30);
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; t++) {
+        pool.emplace_back([&best, t, mode]() {
+            for (int r = 0; r < ROUNDS; r++) {
+                double v = runOne(mode);
+                if (v < best[t]) best[t] = v;
+            }
+        });
+    }
+    for (auto& th : pool) th.join();
+    double worst = 0;
+    for (double v : best) if (v > worst) worst = v;
+    return worst;
+}
+
+int main() {
+    printf("=== Latency Sample Cost ===\n");
+    printf("samples=%d rounds=%d compiled=%s\n\n", SAMPLES, ROUNDS, compiledIn() ? "yes" : "NO");
+
+    printf("%-12s %10s\n", "path", "ns/sample");
+    printf("%-12s %10.1f\n", "now", run(Mode::Now, 1));
+    double sample = run(Mode::Sample, 1);
+    printf("%-12s %10.1f\n", "sample", sample);
+    printf("%-12s %10.1f\n", "recordNs", run(Mode::RecordNs, 1));
+    printf("%-12s %10.1f\n", "sample x4", run(Mode::Sample, 4));
+
+    // Claim every remaining slab so the next threads share the overflow slab
+    std::vector<std::thread> burn;
+    for (int t = 0; t < hl::config::LATENCY_MAX_THREADS; t++)
+        burn.emplace_back([]() { recordNs(Stage::BrokerAsset, 1); });
+    for (auto& th : burn) th.join();
+    printf("%-12s %10.1f\n", "overflow x4", run(Mode::Sample, 4));
+
+    StageSummary rows[(int)Stage::Count];
+    summarize(rows, (int)Stage::Count);
+    const StageSummary& p = rows[(int)Stage::Parse];
+    printf("\nParse n=%.0f p50=%.3fus p90=%.3fus p99=%.3fus max=%.1fus\n",
+           p.count, p.p50Us, p.p90Us, p.p99Us, p.maxUs);
+
+    bool ok = sample < 50.0;
+    if (!ok) printf("FAILED: sample cost above 50 ns\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,160 @@
+//=============================================================================
+// bench_log_ring.cpp - l2Book frame cost at diag 0 and diag 2
+//=============================================================================
+// Part of Hyperliquid Plugin for Zorro
+//
+// LAYER: Test (benchmark)
+// PURPOSE: Per-frame work on a WS connection thread (json::parse,
+//          parseL2Book, PriceCache::setBidAsk) plus the diag-2 line
+//          WebSocketManager::parseL2Book logs for every book update:
+//            diag0   - no logging
+//            sync    - previous path: vsnprintf + callback on the WS thread
+//            ring    - logPrintf into g_logRing; a second thread stands in
+//                      for Zorro's and drains every millisecond
+//
+// SETUP:   The callback stands in for BrokerMessage: it copies the line and
+//          spins CALLBACK_US to model the SendMessage round trip to Zorro's
+//          GUI thread (an assumption; set 0 to see formatting cost alone).
+//          The sync path pays it on the WS thread, the ring path on the
+//          drainer. FRAMES frames over NCOINS coins, ROUNDS passes.
+//
+// EXPECTED: ring within a few hundred ns per frame of diag0 and no
+//           callback time on the WS thread; sync at least CALLBACK_US per
+//           frame. dropped > 0 only if the drainer cannot keep up with the
+//           callback cost (reported, never blocks the WS thread).
+//
+// NETWORK: None
+//=============================================================================
+
+#include "ws_parsers.h"
+#include "ws_price_cache.h"
+#include "json_pool.h"
+#include "hl_log_ring.h"
+#include "yyjson.h"
+#include <atomic>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace hl::ws;
+
+static const int FRAMES = 4096;
+static const int ROUNDS = 20;
+static const int CALLBACK_US = 20;
+
+static const char* COINS[] = {
+    "BTC", "ETH", "SOL", "DOGE", "AVAX", "LINK", "xyz:XYZ100", "xyz:GOLD", "@107", "@142"
+};
+static const int NCOINS = sizeof(COINS) / sizeof(COINS[0]);
+
+static std::atomic<long long> g_delivered(0);
+static char g_lastLine[512];
+
+static int brokerMessage(const char* msg) {
+    strncpy_s(g_lastLine, msg, _TRUNCATE);
+    auto until = std::chrono::steady_clock::now() + std::chrono::microseconds(CALLBACK_US);
+    while (std::chrono::steady_clock::now() < until) {}
+    g_delivered++;
+    return 0;
+}
+
+// The removed WebSocketManager::logf
+static void syncLogf(LogCallback cb, const char* fmt, ...) {
+    char buf[512];
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+    cb(buf);
+}
+
+enum class Mode { Diag0, Sync, Ring };
+
+static std::vector<std::string> buildFrames() {
+    std::vector<std::string> frames;
+    char buf[512];
+    for (int i = 0; i < FRAMES; i++) {
+        double px = 100.0 + (i % 97) * 0.25;
+        sprintf_s(buf, "{\"channel\":\"l2Book\",\"data\":{\"coin\":\"%s\",\"time\":%lld,"
+                  "\"levels\":[[{\"px\":\"%.2f\",\"sz\":\"3.5\",\"n\":4}],"
+                  "[{\"px\":\"%.2f\",\"sz\":\"1.25\",\"n\":2}]]}}",
+                  COINS[i % NCOINS], 1700000000000LL + i, px, px + 0.25);
+        frames.push_back(buf);
+    }
+    return frames;
+}
+
+static double handle(PriceCache& cache, const std::string& frame, Mode mode) {
+    yyjson_doc* doc = hl::json::parse(frame.c_str(), frame.size());
+    int diag = mode == Mode::Diag0 ? 0 : 2;
+    L2BookUpdate r = parseL2Book(yyjson_doc_get_root(doc), diag, brokerMessage);
+    cache.setBidAsk(r.coinId, r.bid, r.ask);
+    if (mode == Mode::Sync)
+        syncLogf(brokerMessage, "WS: l2Book %s bid=%.4f ask=%.4f", r.coin, r.bid, r.ask);
+    else if (mode == Mode::Ring)
+        hl::logPrintf(brokerMessage, "WS: l2Book %s bid=%.4f ask=%.4f", r.coin, r.bid, r.ask);
+    yyjson_doc_free(doc);
+    return r.bid;
+}
+
+// Runs on its own thread, as a WS connection thread would
+static double run(const char* label, Mode mode, const std::vector<std::string>& frames) {
+    PriceCache cache;
+    double checksum = 0, nsFrame = 0;
+    long long delivered0 = g_delivered.load();
+    hl::LogRingStats ring0 = hl::g_logRing.getStats();
+
+    std::thread ws([&]() {
+        for (int i = 0; i < NCOINS; i++) handle(cache, frames[i], Mode::Diag0);
+        auto t0 = std::chrono::steady_clock::now();
+        for (int r = 0; r < ROUNDS; r++)
+            for (const auto& f : frames) checksum += handle(cache, f, mode);
+        nsFrame = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() /
+                  ((double)FRAMES * ROUNDS);
+    });
+    ws.join();
+    while (hl::g_logRing.getStats().pushed > hl::g_logRing.getStats().drained) Sleep(1);
+
+    hl::LogRingStats ring1 = hl::g_logRing.getStats();
+    printf("%-8s %10.1f %12lld %10lld\n", label, nsFrame, g_delivered.load() - delivered0,
+           ring1.dropped - ring0.dropped);
+    return checksum;
+}
+
+int main() {
+    printf("=== l2Book Frame Cost vs Logging ===\n");
+    printf("frames=%d rounds=%d coins=%d callback=%dus\n\n", FRAMES, ROUNDS, NCOINS, CALLBACK_US);
+
+    std::vector<std::string> frames = buildFrames();
+
+    // Stand-in for Zorro's thread: it drains the ring between Broker* calls
+    std::atomic<bool> stop(false);
+    std::atomic<DWORD> zorroThread(0);
+    std::thread zorro([&]() {
+        zorroThread = GetCurrentThreadId();
+        while (!stop.load()) {
+            hl::g_logRing.drain();
+            Sleep(1);
+        }
+        hl::g_logRing.drain();
+    });
+    while (!zorroThread.load()) Sleep(1);
+    hl::g_logRing.setDrainThread(zorroThread.load());
+
+    printf("%-8s %10s %12s %10s\n", "path", "ns_frame", "delivered", "dropped");
+    double a = run("diag0", Mode::Diag0, frames);
+    double b = run("sync", Mode::Sync, frames);
+    double c = run("ring", Mode::Ring, frames);
+
+    stop = true;
+    zorro.join();
+    hl::g_logRing.setDrainThread(0);
+
+    printf("\nlast line: %s\n", g_lastLine);
+    bool ok = a == b && b == c;
+    if (!ok) printf("FAILED: checksum %.4f / %.4f / %.4f\n", a, b, c);
+    return ok ? 0 : 1;
+}
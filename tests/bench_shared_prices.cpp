@@ -0,0 +1,218 @@
+//=============================================================================
+// bench_shared_prices.cpp - Multi-process reads of the shared price table
+//=============================================================================
+// Part of Hyperliquid Plugin for Zorro
+//
+// LAYER: Test (benchmark)
+// PURPOSE: One publisher process writes top-of-book for NCOINS coins into a
+//          SharedPriceTable as fast as it can while READERS child processes
+//          (this exe started with "reader <segment>") read random coins
+//          through it, as Zorro instances with shared prices enabled would.
+//          Every quote written keeps ask == 2 * bid, so a torn read (bid of
+//          one write, ask of another) is detected by every reader.
+//
+// SETUP:   Segment named after this process's pid (no clash with a running
+//          plugin). Readers request every coin, wait for the first quote of
+//          each, then read for DURATION_MS. Baseline: the same random reads
+//          from a local PriceCache in the publisher process.
+//
+// EXPECTED: torn=0 in every reader (exit code 1 otherwise). Under this
+//           saturating writer (millions of quotes/sec vs a few thousand
+//           l2Book updates/sec live) reads pay for cache-line ping-pong and
+//           retries; misses (READ_MAX_TRIES exhausted) stay around 1%.
+//
+// NETWORK: None
+//=============================================================================
+
+#include "ws_shared_prices.h"
+#include "ws_price_cache.h"
+#include <windows.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace hl::ws;
+
+static const int NCOINS = 128;
+static const int READERS = 4;
+static const int DURATION_MS = 2000;
+
+static std::vector<std::string> coinNames() {
+    std::vector<std::string> coins;
+    char name[32];
+    for (int i = 0; i < NCOINS; i++) {
+        sprintf_s(name, "BENCH%d", i);
+        coins.push_back(name);
+    }
+    return coins;
+}
+
+static double elapsedNs(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+}
+
+//=============================================================================
+// READER PROCESS
+//=============================================================================
+
+static int runReader(const char* segment) {
+    SharedPriceTable table;
+    if (!table.open(segment)) {
+        printf("reader %lu: cannot open %s\n", (unsigned long)GetCurrentProcessId(), segment);
+        return 2;
+    }
+    std::vector<std::string> coins = coinNames();
+    std::vector<uint32_t> ids;
+    for (const auto& c : coins) {
+        table.request(c.c_str());
+        ids.push_back(hl::g_symbols.intern(c.c_str()));
+    }
+
+    PriceData p;
+    DWORD start = GetTickCount();
+    for (uint32_t id : ids) {
+        while (!table.read(id, &p)) {
+            if (GetTickCount() - start > 5000) {
+                printf("reader %lu: no quote for %s\n", (unsigned long)GetCurrentProcessId(),
+                       hl::g_symbols.name(id));
+                return 2;
+            }
+            Sleep(1);
+        }
+    }
+
+    long long reads = 0, misses = 0, torn = 0;
+    double checksum = 0;
+    uint32_t rng = (uint32_t)GetCurrentProcessId() * 2654435761u;
+    auto t0 = std::chrono::steady_clock::now();
+    auto stop = t0 + std::chrono::milliseconds(DURATION_MS);
+    while (std::chrono::steady_clock::now() < stop) {
+        for (int i = 0; i < 1024; i++) {
+            rng = rng * 1664525u + 1013904223u;
+            if (!table.read(ids[(rng >> 8) % NCOINS], &p)) { misses++; continue; }
+            reads++;
+            if (p.ask != 2.0 * p.bid) torn++;
+            checksum += p.bid;
+        }
+    }
+    double ns = elapsedNs(t0);
+
+    SharedPriceStats s = table.getStats();
+    printf("reader %-6lu %12.1f %12lld %10lld %8lld %6lld\n", (unsigned long)GetCurrentProcessId(),
+           ns / (double)(reads + misses), reads, s.readRetries, misses, torn);
+    if (checksum < 0) printf("%f\n", checksum);
+    return torn == 0 ? 0 : 1;
+}
+
+//=============================================================================
+// PUBLISHER PROCESS
+//=============================================================================
+
+static double localReadNs(const std::vector<std::string>& coins) {
+    PriceCache cache;
+    std::vector<uint32_t> ids;
+    for (const auto& c : coins) {
+        uint32_t id = hl::g_symbols.intern(c.c_str());
+        cache.setBidAsk(id, 1.0, 2.0);
+        ids.push_back(id);
+    }
+    const long long N = 4000000;
+    double checksum = 0;
+    uint32_t rng = 12345;
+    auto t0 = std::chrono::steady_clock::now();
+    for (long long i = 0; i < N; i++) {
+        rng = rng * 1664525u + 1013904223u;
+        checksum += cache.getPriceData(ids[(rng >> 8) % NCOINS]).bid;
+    }
+    double ns = elapsedNs(t0) / (double)N;
+    if (checksum < 0) printf("%f\n", checksum);
+    return ns;
+}
+
+int main(int argc, char** argv) {
+    if (argc >= 3 && strcmp(argv[1], "reader") == 0) return runReader(argv[2]);
+
+    printf("=== Shared Price Table Benchmark ===\n");
+    printf("coins=%d readers=%d duration=%dms\n\n", NCOINS, READERS, DURATION_MS);
+
+    char segment[128];
+    sprintf_s(segment, "Local\\HyperliquidZorro.PricesBench.%lu", (unsigned long)GetCurrentProcessId());
+    SharedPriceTable table;
+    if (!table.open(segment) || !table.tryAcquirePublisher()) {
+        printf("FAILED: cannot open/publish %s\n", segment);
+        return 1;
+    }
+
+    std::vector<std::string> coins = coinNames();
+    std::vector<uint32_t> ids;
+    for (const auto& c : coins) ids.push_back(hl::g_symbols.intern(c.c_str()));
+
+    // Writer saturates the table, heartbeating like the WS primary thread
+    std::atomic<bool> stop(false);
+    std::atomic<long long> writes(0);
+    std::thread writer([&]() {
+        long long n = 0;
+        DWORD lastBeat = GetTickCount();
+        while (!stop.load(std::memory_order_relaxed)) {
+            for (int i = 0; i < NCOINS; i++) {
+                double bid = (double)(++n);
+                table.publish(ids[i], coins[i].c_str(), bid, 2.0 * bid);
+            }
+            if (GetTickCount() - lastBeat >= 100) {
+                table.heartbeat();
+                lastBeat = GetTickCount();
+            }
+        }
+        writes = n;
+    });
+
+    char exe[MAX_PATH];
+    GetModuleFileNameA(NULL, exe, MAX_PATH);
+    std::vector<PROCESS_INFORMATION> procs;
+    printf("%-13s %12s %12s %10s %8s %6s\n", "process", "ns_read", "reads", "retries", "misses", "torn");
+    fflush(stdout);
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < READERS; i++) {
+        char cmd[MAX_PATH + 160];
+        sprintf_s(cmd, "\"%s\" reader %s", exe, segment);
+        STARTUPINFOA si;
+        memset(&si, 0, sizeof(si));
+        si.cb = sizeof(si);
+        PROCESS_INFORMATION pi;
+        memset(&pi, 0, sizeof(pi));
+        if (!CreateProcessA(NULL, cmd, NULL, NULL, TRUE, 0, NULL, NULL, &si, &pi)) {
+            printf("FAILED: cannot start reader %d\n", i);
+            stop = true;
+            writer.join();
+            return 1;
+        }
+        procs.push_back(pi);
+    }
+
+    int failed = 0;
+    for (auto& pi : procs) {
+        WaitForSingleObject(pi.hProcess, INFINITE);
+        DWORD code = 1;
+        GetExitCodeProcess(pi.hProcess, &code);
+        if (code != 0) failed++;
+        CloseHandle(pi.hProcess);
+        if (pi.hThread) CloseHandle(pi.hThread);
+    }
+    double sec = elapsedNs(t0) / 1e9;
+    stop = true;
+    writer.join();
+
+    SharedPriceStats s = table.getStats();
+    printf("\npublisher: %.0f quotes/sec over %.2fs (%lld published)\n",
+           (double)writes.load() / sec, sec, s.published);
+    printf("local PriceCache read: %.1f ns\n", localReadNs(coins));
+    table.releasePublisher();
+
+    if (failed) printf("FAILED: %d reader(s) saw torn quotes or no quotes\n", failed);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,130 @@
+//=============================================================================
+// bench_trade_index.cpp - WS callback trade lookup at 10k tracked trades
+//=============================================================================
+// Part of Hyperliquid Plugin for Zorro
+//
+// LAYER: Test (benchmark)
+// PURPOSE: Measure the trade-map work done by onFillNotify / onOrderUpdate
+//          (find trade by oid or cloid, read it, write it back) with the
+//          cloid/oid indices, against the previous linear strcmp scan.
+//
+// SETUP:   TRACKED_TRADES trades, LIVE_TRADES of them still open; the rest
+//          are filled/cancelled (archived). Callbacks hit live orders.
+//          The scan baseline walks the same entries the old code walked
+//          (every tracked trade, since nothing was evicted).
+//
+// EXPECTED: indexed lookup flat in the number of tracked trades; scan grows
+//           linearly (tens of microseconds at 10k)
+//
+// NETWORK: None
+//=============================================================================
+
+#include "hl_globals.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <vector>
+
+using namespace hl;
+
+static const int TRACKED_TRADES = 10000;
+static const int LIVE_TRADES = 200;
+static const int CALLBACKS = 20000;
+
+// Previous findTradeIdByOid (hl_trading_cancel.cpp)
+static int scanByOid(const std::map<int, OrderState>& all, const char* oid) {
+    EnterCriticalSection(&g_trading.tradeCs);
+    int result = 0;
+    for (const auto& pair : all) {
+        if (strcmp(pair.second.orderId, oid) == 0) { result = pair.first; break; }
+    }
+    LeaveCriticalSection(&g_trading.tradeCs);
+    return result;
+}
+
+static int scanByCloid(const std::map<int, OrderState>& all, const char* cloid) {
+    EnterCriticalSection(&g_trading.tradeCs);
+    int result = 0;
+    for (const auto& pair : all) {
+        if (strcmp(pair.second.cloid, cloid) == 0) { result = pair.first; break; }
+    }
+    LeaveCriticalSection(&g_trading.tradeCs);
+    return result;
+}
+
+struct Stats { double avgNs; double p99Ns; };
+
+static Stats summarize(std::vector<double>& ns) {
+    double sum = 0;
+    for (double v : ns) sum += v;
+    std::sort(ns.begin(), ns.end());
+    return { sum / ns.size(), ns[(size_t)(ns.size() * 0.99)] };
+}
+
+// One callback: lookup, read, write back (onFillNotify / onOrderUpdate shape)
+template <typename Find>
+static Stats runCallbacks(Find find, bool byCloid) {
+    std::vector<double> ns;
+    ns.reserve(CALLBACKS);
+    char key[64];
+    for (int i = 0; i < CALLBACKS; i++) {
+        // Live trades are the newest IDs (worst case for the ordered scan)
+        int tradeId = TRACKED_TRADES - LIVE_TRADES + 1 + (i % LIVE_TRADES);
+        if (byCloid) sprintf_s(key, "0x%08x0000000000000000cafebabe", (unsigned)tradeId);
+        else sprintf_s(key, "%d", 300000000 + tradeId);
+
+        auto t0 = std::chrono::steady_clock::now();
+        int found = find(key);
+        OrderState state;
+        if (found > 0 && g_trading.getOrder(found, state)) {
+            state.filledSize += 0.001;
+            g_trading.updateOrder(found, state);
+        }
+        auto t1 = std::chrono::steady_clock::now();
+        if (found != tradeId) {
+            printf("lookup mismatch: %s -> %d (want %d)\n", key, found, tradeId);
+            return { -1, -1 };
+        }
+        ns.push_back((double)std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+    }
+    return summarize(ns);
+}
+
+int main() {
+    printf("=== Trade Map Lookup Benchmark ===\n");
+    printf("tracked=%d live=%d callbacks=%d\n\n", TRACKED_TRADES, LIVE_TRADES, CALLBACKS);
+
+    g_trading.init();
+    std::map<int, OrderState> all;   // What the old tradeMap held
+    for (int id = 1; id <= TRACKED_TRADES; id++) {
+        OrderState s;
+        sprintf_s(s.orderId, "%d", 300000000 + id);
+        sprintf_s(s.cloid, "0x%08x0000000000000000cafebabe", (unsigned)id);
+        strcpy_s(s.coin, "BTC");
+        s.requestedSize = 1.0;
+        s.status = (id > TRACKED_TRADES - LIVE_TRADES) ? OrderStatus::PartialFill
+                                                      : OrderStatus::Filled;
+        s.zorroTradeId = id;
+        g_trading.setOrder(id, s);
+        all[id] = s;
+    }
+    printf("active=%zu archived=%zu\n\n",
+           g_trading.activeOrderCount(), g_trading.archivedOrderCount());
+
+    Stats scanOid = runCallbacks([&](const char* k) { return scanByOid(all, k); }, false);
+    Stats scanCloid = runCallbacks([&](const char* k) { return scanByCloid(all, k); }, true);
+    Stats idxOid = runCallbacks([](const char* k) { return g_trading.findByOid(k); }, false);
+    Stats idxCloid = runCallbacks([](const char* k) { return g_trading.findByCloid(k); }, true);
+
+    printf("%-16s %12s %12s\n", "path", "avg_ns", "p99_ns");
+    printf("%-16s %12.0f %12.0f\n", "scan oid", scanOid.avgNs, scanOid.p99Ns);
+    printf("%-16s %12.0f %12.0f\n", "scan cloid", scanCloid.avgNs, scanCloid.p99Ns);
+    printf("%-16s %12.0f %12.0f\n", "index oid", idxOid.avgNs, idxOid.p99Ns);
+    printf("%-16s %12.0f %12.0f\n", "index cloid", idxCloid.avgNs, idxCloid.p99Ns);
+
+    g_trading.cleanup();
+    bool ok = scanOid.avgNs >= 0 && scanCloid.avgNs >= 0 && idxOid.avgNs >= 0 && idxCloid.avgNs >= 0;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,106 @@
+//=============================================================================
+// bench_ws_failover.cpp - Price freshness gap during WS failover
+//=============================================================================
+// Part of Hyperliquid Plugin for Zorro
+//
+// LAYER: Test (benchmark)
+// PURPOSE: Measure how stale the price cache gets when the primary WS
+//          connection drops, with and without the warm-standby connection.
+//
+// SETUP:   Local mock server (tests/mocks/mock_ws_server.h) publishes an
+//          l2Book update for BTC every FEED_INTERVAL_MS with a rising
+//          exchange timestamp. After warm-up the primary connection is
+//          force-closed (fault injection); the sampler records the worst
+//          PriceCache::getAge("BTC") over the following window.
+//
+// EXPECTED: standby off -> gap ~ IXWebSocket reconnect backoff (>= 1s)
+//           standby on  -> gap ~ feed interval, duplicates dropped > 0
+//
+// NETWORK: Local only (127.0.0.1)
+//=============================================================================
+
+#include "ws_manager.h"
+#include "mocks/mock_ws_server.h"
+#include <IXNetSystem.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <cstdio>
+
+static const char* DUMMY_ADDR = "0x0000000000000000000000000000000000000000";
+static const int FEED_INTERVAL_MS = 5;
+static const int WARMUP_MS = 1000;
+static const int WINDOW_MS = 3000;
+
+struct FailoverResult {
+    DWORD maxGapMs;
+    long long duplicates;
+    int reconnects;
+};
+
+static FailoverResult runScenario(int port, bool standby) {
+    hl::test::MockWsServer server(port);
+    FailoverResult r = { 0, 0, 0 };
+    if (!server.start()) return r;
+
+    hl::ws::PriceCache cache;
+    hl::ws::WebSocketManager mgr(cache);
+    mgr.setUserAddress(DUMMY_ADDR);
+    mgr.setEndpoint(server.host(), false);
+    mgr.setStandbyEnabled(standby);
+    mgr.start("", false);
+    mgr.subscribeL2Book("BTC");
+    mgr.addStandbyCoin("BTC");
+    mgr.markInitialSubscriptionsQueued();
+
+    std::atomic<bool> feeding(true);
+    std::thread feed([&] {
+        long long t = 1;
+        while (feeding) {
+            server.broadcastL2Book("BTC", 50000.0, 50001.0, t++);
+            std::this_thread::sleep_for(std::chrono::milliseconds(FEED_INTERVAL_MS));
+        }
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(WARMUP_MS));
+    mgr.forceDisconnectForTest(0);  // Fault injection: primary drops
+
+    auto start = std::chrono::steady_clock::now();
+    while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(WINDOW_MS)) {
+        DWORD age = cache.getAge("BTC");
+        if (age != MAXDWORD && age > r.maxGapMs) r.maxGapMs = age;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    feeding = false;
+    feed.join();
+
+    r.duplicates = mgr.getDuplicatesDropped();
+    for (const auto& h : mgr.getConnectionHealth())
+        if (h.index == 0) r.reconnects = h.reconnects;
+
+    mgr.stop();
+    server.stop();
+    return r;
+}
+
+int main() {
+    printf("=== WS Failover Freshness Benchmark ===\n");
+    printf("feed=%dms warmup=%dms window=%dms\n\n", FEED_INTERVAL_MS, WARMUP_MS, WINDOW_MS);
+
+    ix::initNetSystem();
+
+    FailoverResult single = runScenario(18770, false);
+    FailoverResult standby = runScenario(18771, true);
+
+    printf("%-14s %12s %12s %12s\n", "mode", "max_gap_ms", "duplicates", "reconnects");
+    printf("%-14s %12u %12lld %12d\n", "single", (unsigned)single.maxGapMs,
+           single.duplicates, single.reconnects);
+    printf("%-14s %12u %12lld %12d\n", "warm-standby", (unsigned)standby.maxGapMs,
+           standby.duplicates, standby.reconnects);
+
+    ix::uninitNetSystem();
+
+    // Non-zero exit if the standby failed to shorten the gap
+    return (standby.maxGapMs < single.maxGapMs) ? 0 : 1;
+}
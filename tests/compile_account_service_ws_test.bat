@@ -23,7 +23,11 @@ cl /nologo /EHsc /std:c++17 ^
    /I. ^
    unit\test_account_service_ws.cpp ^
    ..\src\foundation\hl_globals.cpp ^
+   ..\src\foundation\hl_symbols.cpp ^
+   ..\src\foundation\hl_log_ring.cpp ^
    ..\src\transport\ws_price_cache.cpp ^
+   ..\src\transport\ws_fill_ring.cpp ^
+   ..\src\transport\ws_shared_prices.cpp ^
    /Fe:"%~dp0test_account_service_ws.exe"
 
 if errorlevel 1 (
@@ -0,0 +1,63 @@
+@echo off
+setlocal
+
+echo ============================================
+echo   COMPILING decimal UNIT TEST
+echo ============================================
+echo.
+
+:: Setup Visual Studio environment (32-bit for Zorro compatibility)
+call "C:\Program Files (x86)\Microsoft Visual Studio\2022\BuildTools\VC\Auxiliary\Build\vcvars32.bat" >nul 2>&1
+if errorlevel 1 (
+    echo ERROR: Could not setup Visual Studio environment
+    exit /b 1
+)
+
+cd /d "%~dp0"
+
+echo Include paths:
+echo   - ..\src\foundation
+echo.
+
+echo Compiling...
+cl /nologo /EHsc /std:c++17 ^
+   /I..\src\foundation ^
+   /I. ^
+   unit\test_decimal.cpp ^
+   ..\src\foundation\hl_decimal.cpp ^
+   ..\src\foundation\hl_utils.cpp ^
+   /Fe:test_decimal.exe
+
+if errorlevel 1 (
+    echo.
+    echo ============================================
+    echo   COMPILATION FAILED!
+    echo ============================================
+    exit /b 1
+)
+
+echo.
+echo ============================================
+echo   COMPILATION SUCCESSFUL
+echo ============================================
+echo.
+
+echo Running test...
+echo.
+test_decimal.exe
+set TEST_RESULT=%ERRORLEVEL%
+
+echo.
+echo Cleaning up...
+del /Q *.obj 2>nul
+del /Q test_decimal.exe 2>nul
+
+if %TEST_RESULT% NEQ 0 (
+    echo.
+    echo TEST FAILED!
+    exit /b 1
+)
+
+echo.
+echo ALL TESTS PASSED!
+exit /b 0
@@ -16,7 +16,7 @@ echo  Tests: GET_POSITION returns correct value after fill
 echo ===================================================
 echo.
 
-cl /nologo /EHsc /std:c++17 /I..\src\transport unit\test_get_position_after_fill.cpp ..\src\transport\ws_price_cache.cpp /Fe:test_get_position_after_fill.exe
+cl /nologo /EHsc /std:c++17 /I..\src\transport unit\test_get_position_after_fill.cpp ..\src\transport\ws_price_cache.cpp ..\src\transport\ws_fill_ring.cpp ..\src\transport\ws_shared_prices.cpp ..\src\foundation\hl_symbols.cpp /Fe:test_get_position_after_fill.exe
 
 if errorlevel 1 (
     echo.
@@ -26,7 +26,12 @@ cl /nologo /EHsc /std:c++14 ^
    /I..\src\transport ^
    test_http_compile.cpp ^
    ..\src\transport\hl_http.cpp ^
+   ..\src\transport\hl_capture.cpp ^
    ..\src\foundation\hl_globals.cpp ^
+   ..\src\foundation\hl_symbols.cpp ^
+   ..\src\foundation\hl_log_ring.cpp ^
+   ..\src\foundation\hl_latency.cpp ^
+   ..\src\foundation\hl_trace.cpp ^
    /Fe:test_http.exe
 
 if errorlevel 1 (
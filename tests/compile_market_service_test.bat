@@ -22,6 +22,8 @@ cl /nologo /EHsc /std:c++17 ^
    /I. ^
    unit\test_market_service.cpp ^
    ..\src\foundation\hl_globals.cpp ^
+   ..\src\foundation\hl_symbols.cpp ^
+   ..\src\foundation\hl_log_ring.cpp ^
    /Fe:"%~dp0test_market_service.exe"
 
 if errorlevel 1 (
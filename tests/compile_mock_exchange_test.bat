@@ -0,0 +1,71 @@
+@echo off
+setlocal
+
+echo ============================================
+echo   COMPILING mock exchange UNIT TEST
+echo ============================================
+echo.
+
+:: Setup Visual Studio environment (32-bit for Zorro compatibility)
+call "C:\Program Files (x86)\Microsoft Visual Studio\2022\BuildTools\VC\Auxiliary\Build\vcvars32.bat" >nul 2>&1
+if errorlevel 1 (
+    echo ERROR: Could not setup Visual Studio environment
+    exit /b 1
+)
+
+cd /d "%~dp0"
+
+echo Include paths:
+echo   - ..\src\foundation
+echo   - ..\src\vendor\yyjson
+echo   - ..\Source\HyperliquidPlugin\crypto
+echo.
+
+echo Compiling...
+cl /nologo /EHsc /std:c++17 ^
+   /I..\src\foundation ^
+   /I..\src\vendor\yyjson ^
+   /I..\Source\HyperliquidPlugin\crypto ^
+   /I. ^
+   unit\test_mock_exchange.cpp ^
+   ..\src\foundation\hl_eip712.cpp ^
+   ..\src\foundation\hl_decimal.cpp ^
+   ..\src\foundation\hl_msgpack.cpp ^
+   ..\src\foundation\hl_crypto.cpp ^
+   ..\Source\HyperliquidPlugin\crypto\keccak256.c ^
+   ..\src\vendor\yyjson\yyjson.c ^
+   /Fe:test_mock_exchange.exe
+
+if errorlevel 1 (
+    echo.
+    echo ============================================
+    echo   COMPILATION FAILED!
+    echo ============================================
+    exit /b 1
+)
+
+echo.
+echo ============================================
+echo   COMPILATION SUCCESSFUL
+echo ============================================
+echo.
+
+echo Running test...
+echo.
+test_mock_exchange.exe
+set TEST_RESULT=%ERRORLEVEL%
+
+echo.
+echo Cleaning up...
+del /Q *.obj 2>nul
+del /Q test_mock_exchange.exe 2>nul
+
+if %TEST_RESULT% NEQ 0 (
+    echo.
+    echo TEST FAILED!
+    exit /b 1
+)
+
+echo.
+echo ALL TESTS PASSED!
+exit /b 0
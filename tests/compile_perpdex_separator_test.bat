@@ -2,7 +2,7 @@
 call "C:\Program Files (x86)\Microsoft Visual Studio\2022\BuildTools\VC\Auxiliary\Build\vcvars64.bat" >nul 2>&1
 cd /d "%~dp0"
 echo Compiling OPM-132 asset naming test...
-cl /nologo /EHsc /std:c++14 /I..\src\foundation unit\test_perpdex_separator.cpp ..\src\foundation\hl_utils.cpp /Fe:test_perpdex_separator.exe
+cl /nologo /EHsc /std:c++14 /I..\src\foundation unit\test_perpdex_separator.cpp ..\src\foundation\hl_utils.cpp ..\src\foundation\hl_decimal.cpp /Fe:test_perpdex_separator.exe
 if errorlevel 1 (
     echo COMPILATION FAILED!
     exit /b 1
@@ -22,6 +22,7 @@ cl /nologo /EHsc /std:c++14 ^
    /I..\Source\HyperliquidPlugin\crypto ^
    unit\test_schedule_cancel.cpp ^
    ..\src\foundation\hl_eip712.cpp ^
+   ..\src\foundation\hl_decimal.cpp ^
    ..\src\foundation\hl_msgpack.cpp ^
    ..\src\foundation\hl_crypto.cpp ^
    ..\Source\HyperliquidPlugin\crypto\keccak256.c ^
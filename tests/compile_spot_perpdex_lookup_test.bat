@@ -16,7 +16,7 @@ echo  Tests: OPM-138 spot/perpDex registry lookup chain
 echo ===================================================
 echo.
 
-cl /nologo /EHsc /std:c++14 /I. /I..\src\foundation unit\test_spot_perpdex_lookup.cpp ..\src\foundation\hl_globals.cpp /Fe:test_spot_perpdex_lookup.exe
+cl /nologo /EHsc /std:c++14 /I. /I..\src\foundation unit\test_spot_perpdex_lookup.cpp ..\src\foundation\hl_globals.cpp ..\src\foundation\hl_symbols.cpp ..\src\foundation\hl_log_ring.cpp /Fe:test_spot_perpdex_lookup.exe
 
 if errorlevel 1 (
     echo.
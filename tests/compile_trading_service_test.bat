@@ -2,7 +2,7 @@
 REM =============================================================================
 REM compile_trading_service_test.bat - Trading service tests [OPM-9]
 REM =============================================================================
-REM TESTS: CLOID gen/parse, trade ID, nonce, order storage, fill status
+REM TESTS: CLOID gen/parse, trade ID, nonce, order storage + indices, fill status
 REM =============================================================================
 
 call "C:\Program Files (x86)\Microsoft Visual Studio\2022\BuildTools\VC\Auxiliary\Build\vcvars32.bat" >nul 2>&1
@@ -21,6 +21,8 @@ cl /nologo /EHsc /std:c++17 ^
    /I. ^
    unit\test_trading_service.cpp ^
    ..\src\foundation\hl_globals.cpp ^
+   ..\src\foundation\hl_symbols.cpp ^
+   ..\src\foundation\hl_log_ring.cpp ^
    /Fe:"%~dp0test_trading_service.exe"
 
 if errorlevel 1 (
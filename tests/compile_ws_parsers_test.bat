@@ -27,6 +27,12 @@ cl /nologo /EHsc /std:c++17 ^
    unit\test_ws_parsers.cpp ^
    ..\src\transport\ws_parsers.cpp ^
    ..\src\transport\ws_price_cache.cpp ^
+   ..\src\transport\ws_fill_ring.cpp ^
+   ..\src\transport\ws_shared_prices.cpp ^
+   ..\src\transport\json_pool.cpp ^
+   ..\src\foundation\hl_symbols.cpp ^
+   ..\src\foundation\hl_log_ring.cpp ^
+   ..\src\foundation\hl_asset_ctx.cpp ^
    ..\src\vendor\yyjson\yyjson.c ^
    /Fe:test_ws_parsers.exe
 
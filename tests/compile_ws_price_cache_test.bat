@@ -24,6 +24,9 @@ cl /nologo /EHsc /std:c++17 ^
    /I..\src\transport ^
    test_ws_price_cache.cpp ^
    ..\src\transport\ws_price_cache.cpp ^
+   ..\src\transport\ws_fill_ring.cpp ^
+   ..\src\transport\ws_shared_prices.cpp ^
+   ..\src\foundation\hl_symbols.cpp ^
    /Fe:test_ws_price_cache.exe
 
 if errorlevel 1 (
@@ -0,0 +1,656 @@
+//=============================================================================
+// hl_bench.cpp - Microbenchmark suite with machine-readable results
+//=============================================================================
+// Part of Hyperliquid Plugin for Zorro
+//
+// LAYER: Test (benchmark)
+// PURPOSE: One number per hot-path function, reproducible enough to track
+//          per commit (scripts/bench_compare.py flags slowdowns):
+//            parse.*     ws::parseL2Book, parseClearinghouseState,
+//                        parseUserFills, parsePostResponse on exchange-shaped
+//                        payloads (built in, or the first frame of each kind
+//                        from a capture with --capture)
+//            sign.*      eip712::hashOrderForSigning, crypto::signHash
+//            msgpack.*   the msgpack::pack*Action family
+//            pricecache.* setBidAsk / getPriceData by symbol id, alone and
+//                        with two background threads on the same cache
+//            assets.*    AssetRegistry findByCoin / findByName / getByIndex
+//                        over a 200-asset universe
+//            format.*    utils::formatPriceForExchange, formatSize
+//
+// SETUP:   Fixed payloads and inputs (no clock or RNG seeds from the
+//          environment). Each case is calibrated to --min-ms per repeat, the
+//          calibration doubling as warm-up, then run --repeats times; the
+//          median ns/op is the result, min/max show the spread.
+//
+// USAGE:   hl_bench [--json FILE|-] [--filter TEXT] [--repeats N]
+//                   [--min-ms N] [--label TEXT] [--capture FILE] [--list]
+//            --json     write results as JSON (schema below; "-" = stdout)
+//            --filter   only cases whose name contains TEXT
+//            --label    free text stored with the results (e.g. commit id)
+//            --capture  take parser payloads from an HL_SET_CAPTURE file
+//
+//          {"suite":"hl_bench","schema":1,"label":"...","platform":"...",
+//           "compiler":"...","payloads":"builtin"|"capture:<file>",
+//           "results":[{"name":"parse.l2Book","ns_per_op":812.4,
+//                       "min_ns":801.0,"max_ns":840.2,"iterations":12288,
+//                       "repeats":7},...]}
+//
+// EXPECTED: parse.* around a microsecond, sign.signHash tens of microseconds,
+//           msgpack.* and format.* a few hundred ns, pricecache.* and
+//           assets.getByIndex tens of ns. Returns 1 if a payload does not
+//           parse to what it contains (numbers would be meaningless).
+//
+// NETWORK: None
+//=============================================================================
+
+#define MOCK_ZORRO_IMPLEMENTATION
+#include "mocks/mock_zorro.h"
+#include "hl_capture.h"
+#include "hl_crypto.h"
+#include "hl_eip712.h"
+#include "hl_globals.h"
+#include "hl_msgpack.h"
+#include "hl_symbols.h"
+#include "hl_utils.h"
+#include "ws_parsers.h"
+#include "ws_price_cache.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace hl;
+
+// Hardhat/Ganache account #0 (public test key)
+static const char* KEY = "0xac0974bec39a17e36ba4a6b4d238ff944bacb478cbed5efcae784d7bf4f2ff80";
+static const char* ADDR = "0xf39fd6e51aad88f6f4ce6ab8827279cfffb92266";
+
+static const int BOOK_LEVELS = 20;
+static const int POSITION_COUNT = 8;
+static const int FILL_COUNT = 20;
+static const int ASSET_COUNT = 200;
+
+// Results land here so the optimizer cannot drop the measured calls
+static volatile uint64_t s_sink = 0;
+
+static void consume(uint64_t v) { s_sink = v; }
+
+//=============================================================================
+// PAYLOADS
+//=============================================================================
+
+// Fixed-seed generator: same payload bytes on every platform and run
+struct Lcg {
+    uint64_t state;
+    explicit Lcg(uint64_t seed) : state(seed) {}
+    uint32_t next() {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return (uint32_t)(state >> 33);
+    }
+    double unit() { return (double)next() / 2147483648.0; }   // [0, 1)
+};
+
+static const char* POSITION_COINS[POSITION_COUNT] = {
+    "BTC", "ETH", "SOL", "AVAX", "ARB", "DOGE", "LINK", "OP"
+};
+
+static std::string buildL2Book() {
+    Lcg rng(1);
+    std::string s = "{\"channel\":\"l2Book\",\"data\":{\"coin\":\"BTC\",\"time\":1700000000000,\"levels\":[";
+    char buf[96];
+    for (int side = 0; side < 2; side++) {
+        s += side ? ",[" : "[";
+        for (int i = 0; i < BOOK_LEVELS; i++) {
+            double px = side ? 50001.0 + i : 50000.0 - i;
+            sprintf_s(buf, "%s{\"px\":\"%.1f\",\"sz\":\"%.5f\",\"n\":%u}", i ? "," : "",
+                      px, 0.001 + rng.unit() * 3.0, 1 + rng.next() % 12);
+            s += buf;
+        }
+        s += "]";
+    }
+    s += "]}}";
+    return s;
+}
+
+static std::string buildClearinghouseState() {
+    Lcg rng(2);
+    std::string s = "{\"channel\":\"clearinghouseState\",\"data\":{\"dex\":\"\",\"user\":\"";
+    s += ADDR;
+    s += "\",\"clearinghouseState\":{\"assetPositions\":[";
+    char buf[512];
+    double ntl = 0.0, margin = 0.0;
+    for (int i = 0; i < POSITION_COUNT; i++) {
+        double entry = 10.0 + rng.unit() * 1000.0;
+        double size = (rng.next() % 2 ? 1.0 : -1.0) * (0.1 + rng.unit() * 50.0);
+        double value = entry * (size < 0 ? -size : size);
+        ntl += value;
+        margin += value / 10.0;
+        sprintf_s(buf, "%s{\"type\":\"oneWay\",\"position\":{\"coin\":\"%s\",\"szi\":\"%.4f\","
+                  "\"leverage\":{\"type\":\"cross\",\"value\":10},\"entryPx\":\"%.2f\","
+                  "\"positionValue\":\"%.2f\",\"unrealizedPnl\":\"%.2f\",\"returnOnEquity\":\"0.0\","
+                  "\"liquidationPx\":null,\"marginUsed\":\"%.2f\",\"maxLeverage\":50,"
+                  "\"cumFunding\":{\"allTime\":\"0.0\",\"sinceOpen\":\"0.0\",\"sinceChange\":\"0.0\"}}}",
+                  i ? "," : "", POSITION_COINS[i], size, entry, value,
+                  (rng.unit() - 0.5) * value * 0.1, value / 10.0);
+        s += buf;
+    }
+    sprintf_s(buf, "],\"marginSummary\":{\"accountValue\":\"100000.0\",\"totalNtlPos\":\"%.2f\","
+              "\"totalRawUsd\":\"100000.0\",\"totalMarginUsed\":\"%.2f\"},"
+              "\"crossMarginSummary\":{\"accountValue\":\"100000.0\",\"totalNtlPos\":\"%.2f\","
+              "\"totalRawUsd\":\"100000.0\",\"totalMarginUsed\":\"%.2f\"},"
+              "\"crossMaintenanceMarginUsed\":\"%.2f\",\"withdrawable\":\"%.2f\","
+              "\"time\":1700000000000}}}",
+              ntl, margin, ntl, margin, margin / 2.0, 100000.0 - margin);
+    s += buf;
+    return s;
+}
+
+static std::string buildUserFills() {
+    Lcg rng(3);
+    std::string s = "{\"channel\":\"userFills\",\"data\":{\"isSnapshot\":true,\"user\":\"";
+    s += ADDR;
+    s += "\",\"fills\":[";
+    char buf[512];
+    for (int i = 0; i < FILL_COUNT; i++) {
+        bool buy = rng.next() % 2 == 0;
+        sprintf_s(buf, "%s{\"coin\":\"%s\",\"px\":\"%.2f\",\"sz\":\"%.4f\",\"side\":\"%s\","
+                  "\"time\":%llu,\"startPosition\":\"0.0\",\"dir\":\"%s\",\"closedPnl\":\"0.0\","
+                  "\"hash\":\"0x%08x%08x\",\"oid\":%u,\"crossed\":true,\"fee\":\"%.4f\","
+                  "\"tid\":%u,\"feeToken\":\"USDC\"}",
+                  i ? "," : "", POSITION_COINS[i % POSITION_COUNT], 10.0 + rng.unit() * 1000.0,
+                  0.01 + rng.unit() * 10.0, buy ? "B" : "A",
+                  (unsigned long long)(1700000000000ULL + (uint64_t)i * 1000u),
+                  buy ? "Open Long" : "Open Short", rng.next(), rng.next(),
+                  30000000u + (unsigned)i, rng.unit(), 900000000u + (unsigned)i);
+        s += buf;
+    }
+    s += "]}}";
+    return s;
+}
+
+static std::string buildPostResponse() {
+    return "{\"channel\":\"post\",\"data\":{\"id\":42,\"response\":{\"type\":\"action\","
+           "\"payload\":{\"status\":\"ok\",\"response\":{\"type\":\"order\",\"data\":{"
+           "\"statuses\":[{\"filled\":{\"totalSz\":\"0.02\",\"avgPx\":\"50001.0\",\"oid\":30000001}}]"
+           "}}}}}}";
+}
+
+struct Payloads {
+    std::string l2Book;
+    std::string clearinghouse;
+    std::string userFills;
+    std::string post;
+    std::string source = "builtin";
+};
+
+static bool isChannel(const std::string& frame, const char* channel) {
+    char key[64];
+    sprintf_s(key, "\"channel\":\"%s\"", channel);
+    return frame.find(key) != std::string::npos;
+}
+
+// First received frame of each kind replaces the built-in payload
+static bool loadCapture(const char* path, Payloads& p) {
+    std::vector<capture::Record> records;
+    if (!capture::Reader::readAll(path, records)) return false;
+    bool book = false, state = false, fills = false, post = false;
+    for (const capture::Record& r : records) {
+        if (r.kind != capture::Kind::WsRecv) continue;
+        if (!book && isChannel(r.data, "l2Book")) { p.l2Book = r.data; book = true; }
+        else if (!state && isChannel(r.data, "clearinghouseState")) { p.clearinghouse = r.data; state = true; }
+        else if (!fills && isChannel(r.data, "userFills")) { p.userFills = r.data; fills = true; }
+        else if (!post && isChannel(r.data, "post") && r.data.find("\"id\":") != std::string::npos) {
+            p.post = r.data;
+            post = true;
+        }
+    }
+    printf("capture %s: l2Book %s, clearinghouseState %s, userFills %s, post %s\n", path,
+           book ? "recorded" : "built-in", state ? "recorded" : "built-in",
+           fills ? "recorded" : "built-in", post ? "recorded" : "built-in");
+    p.source = std::string("capture:") + path;
+    return true;
+}
+
+//=============================================================================
+// HARNESS
+//=============================================================================
+
+struct BenchCase {
+    std::string name;
+    std::function<void(uint64_t)> run;          // Performs the operation `iters` times
+    std::function<void()> setup = nullptr;      // Optional, outside the timed region
+    std::function<void()> teardown = nullptr;
+};
+
+struct BenchResult {
+    std::string name;
+    double nsPerOp = 0.0;               // Median over repeats
+    double minNs = 0.0;
+    double maxNs = 0.0;
+    uint64_t iterations = 0;            // Per repeat
+    int repeats = 0;
+};
+
+struct Options {
+    const char* jsonPath = nullptr;
+    const char* filter = nullptr;
+    const char* label = "";
+    const char* capturePath = nullptr;
+    int repeats = 7;
+    int minMs = 50;
+    bool list = false;
+};
+
+static double timeBatch(const BenchCase& b, uint64_t iters) {
+    auto t0 = std::chrono::steady_clock::now();
+    b.run(iters);
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+}
+
+static BenchResult measure(const BenchCase& b, const Options& opt) {
+    if (b.setup) b.setup();
+
+    // Calibrate (and warm up): double until a batch takes an eighth of the target
+    const double targetNs = (double)opt.minMs * 1e6;
+    uint64_t iters = 1;
+    double ns = timeBatch(b, iters);
+    while (ns < targetNs / 8.0 && iters < (1ULL << 40)) {
+        iters *= 2;
+        ns = timeBatch(b, iters);
+    }
+    iters = (std::max)((uint64_t)1, (uint64_t)((double)iters * targetNs / (std::max)(ns, 1.0)));
+    // Once more at that size: one stall in a short batch (thread start-up,
+    // lock handoff) would otherwise shrink every repeat
+    ns = timeBatch(b, iters);
+    iters = (std::max)((uint64_t)1, (uint64_t)((double)iters * targetNs / (std::max)(ns, 1.0)));
+
+    std::vector<double> perOp;
+    for (int r = 0; r < opt.repeats; r++) perOp.push_back(timeBatch(b, iters) / (double)iters);
+    if (b.teardown) b.teardown();
+
+    std::sort(perOp.begin(), perOp.end());
+    BenchResult res;
+    res.name = b.name;
+    size_t n = perOp.size();
+    res.nsPerOp = n % 2 ? perOp[n / 2] : (perOp[n / 2 - 1] + perOp[n / 2]) / 2.0;
+    res.minNs = perOp.front();
+    res.maxNs = perOp.back();
+    res.iterations = iters;
+    res.repeats = opt.repeats;
+    return res;
+}
+
+// Background threads hammering a PriceCache while one case measures
+class Contention {
+public:
+    void start(std::function<void(int, uint64_t)> work, int threads) {
+        stop_.store(false);
+        for (int t = 0; t < threads; t++) {
+            threads_.emplace_back([this, work, t] {
+                uint64_t i = 0;
+                while (!stop_.load(std::memory_order_relaxed)) work(t, i++);
+            });
+        }
+    }
+    void stop() {
+        stop_.store(true);
+        for (std::thread& t : threads_) t.join();
+        threads_.clear();
+    }
+
+private:
+    std::atomic<bool> stop_{false};
+    std::vector<std::thread> threads_;
+};
+
+static const char* platformName() {
+#if defined(_WIN32)
+    return "windows";
+#elif defined(__APPLE__)
+    return "macos";
+#elif defined(__linux__)
+    return "linux";
+#else
+    return "posix";
+#endif
+}
+
+static std::string compilerName() {
+    char buf[64];
+#if defined(_MSC_VER)
+    sprintf_s(buf, "msvc %d", _MSC_VER);
+#elif defined(__clang__)
+    sprintf_s(buf, "clang %d.%d.%d", __clang_major__, __clang_minor__, __clang_patchlevel__);
+#elif defined(__GNUC__)
+    sprintf_s(buf, "gcc %d.%d.%d", __GNUC__, __GNUC_MINOR__, __GNUC_PATCHLEVEL__);
+#else
+    strcpy_s(buf, "unknown");
+#endif
+    return buf;
+}
+
+static std::string jsonEscape(const std::string& in) {
+    std::string out;
+    for (char c : in) {
+        if (c == '"' || c == '\\') { out += '\\'; out += c; }
+        else if ((unsigned char)c < 0x20) out += ' ';
+        else out += c;
+    }
+    return out;
+}
+
+static bool writeJson(const char* path, const Options& opt, const Payloads& payloads,
+                      const std::vector<BenchResult>& results) {
+    FILE* f = stdout;
+    if (strcmp(path, "-") != 0 && fopen_s(&f, path, "w") != 0) return false;
+    fprintf(f, "{\"suite\":\"hl_bench\",\"schema\":1,\"label\":\"%s\",\"platform\":\"%s\","
+            "\"compiler\":\"%s\",\"payloads\":\"%s\",\"repeats\":%d,\"min_ms\":%d,\"results\":[",
+            jsonEscape(opt.label).c_str(), platformName(), compilerName().c_str(),
+            jsonEscape(payloads.source).c_str(), opt.repeats, opt.minMs);
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        fprintf(f, "%s\n  {\"name\":\"%s\",\"ns_per_op\":%.2f,\"min_ns\":%.2f,\"max_ns\":%.2f,"
+                "\"iterations\":%llu,\"repeats\":%d}", i ? "," : "", r.name.c_str(), r.nsPerOp,
+                r.minNs, r.maxNs, (unsigned long long)r.iterations, r.repeats);
+    }
+    fprintf(f, "\n]}\n");
+    if (f != stdout) fclose(f);
+    return true;
+}
+
+//=============================================================================
+// CASES
+//=============================================================================
+
+static void addParseCases(std::vector<BenchCase>& cases, const Payloads& p, ws::PriceCache& cache) {
+    cases.push_back({ "parse.l2Book", [&p](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) consume((uint64_t)ws::parseL2Book(p.l2Book.c_str(), 0, nullptr).bid);
+    } });
+    cases.push_back({ "parse.clearinghouseState", [&p, &cache](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) ws::parseClearinghouseState(cache, p.clearinghouse.c_str(), 0, nullptr);
+    } });
+    cases.push_back({ "parse.userFills", [&p, &cache](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) ws::parseUserFills(cache, p.userFills.c_str(), 0, nullptr);
+    } });
+    cases.push_back({ "parse.postResponse", [&p](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) consume((uint64_t)ws::parsePostResponse(p.post.c_str(), 0, nullptr).requestId);
+    } });
+}
+
+static void addSignCases(std::vector<BenchCase>& cases, const eip712::OrderAction& action) {
+    static eip712::ByteArray s_hash;
+    s_hash = eip712::hashOrderForSigning(action, true, 1700000000000ULL);
+
+    cases.push_back({ "sign.hashOrder", [&action](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++)
+            consume(eip712::hashOrderForSigning(action, true, 1700000000000ULL + i)[0]);
+    } });
+    cases.push_back({ "sign.signHash", [](uint64_t n) {
+        crypto::Signature sig;
+        for (uint64_t i = 0; i < n; i++) {
+            crypto::signHash(s_hash.data(), KEY, sig);
+            consume((uint64_t)sig.v);
+        }
+    } });
+    cases.push_back({ "sign.hashAndSign", [&action](uint64_t n) {
+        crypto::Signature sig;
+        for (uint64_t i = 0; i < n; i++) {
+            eip712::ByteArray h = eip712::hashOrderForSigning(action, true, 1700000000000ULL + i);
+            crypto::signHash(h.data(), KEY, sig);
+            consume((uint64_t)sig.v);
+        }
+    } });
+}
+
+static void addMsgpackCases(std::vector<BenchCase>& cases) {
+    static const std::string CLOID = "0x0000000000000000000000000000002a";
+    static std::vector<msgpack::BracketOrderWire> s_bracket;
+    s_bracket = {
+        { 0, true, "50000", "0.01", false, "Gtc", CLOID, false, true, "", "" },
+        { 0, false, "52500", "0.01", true, "Gtc", "", true, false, "52500", "tp" },
+        { 0, false, "47500", "0.01", true, "Gtc", "", true, true, "47500", "sl" },
+    };
+
+    cases.push_back({ "msgpack.order", [](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++)
+            consume(msgpack::packOrderAction(0, true, "50000", "0.01", false, "Gtc", CLOID).size());
+    } });
+    cases.push_back({ "msgpack.triggerOrder", [](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++)
+            consume(msgpack::packTriggerOrderAction(0, false, "47000", "0.01", true, true, "47500",
+                                                    "sl", CLOID).size());
+    } });
+    cases.push_back({ "msgpack.cancel", [](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) consume(msgpack::packCancelAction(0, 30000001ULL + i).size());
+    } });
+    cases.push_back({ "msgpack.batchModify", [](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++)
+            consume(msgpack::packBatchModifyAction(30000001ULL, "", false, 0, true, "50010", "0.01",
+                                                   false, "Gtc", CLOID).size());
+    } });
+    cases.push_back({ "msgpack.twapOrder", [](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++)
+            consume(msgpack::packTwapOrderAction(0, true, "0.5", false, 30, false).size());
+    } });
+    cases.push_back({ "msgpack.twapCancel", [](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) consume(msgpack::packTwapCancelAction(0, 77ULL + i).size());
+    } });
+    cases.push_back({ "msgpack.scheduleCancel", [](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++)
+            consume(msgpack::packScheduleCancelAction(1700000000000ULL + i).size());
+    } });
+    cases.push_back({ "msgpack.bracketOrder", [](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) consume(msgpack::packBracketOrderAction(s_bracket).size());
+    } });
+}
+
+static void addPriceCacheCases(std::vector<BenchCase>& cases, ws::PriceCache& cache,
+                               const std::vector<uint32_t>& ids, Contention& bg) {
+    const size_t mask = ids.size() - 1;     // ids.size() is a power of two
+    cases.push_back({ "pricecache.write", [&cache, &ids, mask](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) {
+            double px = 50000.0 + (double)(i & 1023);
+            cache.setBidAsk(ids[i & mask], px, px + 1.0);
+        }
+    } });
+    cases.push_back({ "pricecache.read", [&cache, &ids, mask](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) consume((uint64_t)cache.getPriceData(ids[i & mask]).bid);
+    } });
+
+    // Contended: one thread writing, one reading, alongside the measured side
+    auto background = [&cache, &ids, mask](int t, uint64_t i) {
+        uint32_t id = ids[(i * 7 + (uint64_t)t) & mask];
+        if (t == 0) cache.setBidAsk(id, 50000.0 + (double)(i & 1023), 50001.0 + (double)(i & 1023));
+        else consume((uint64_t)cache.getPriceData(id).ask);
+    };
+    cases.push_back({ "pricecache.writeContended", cases[cases.size() - 2].run,
+                      [&bg, background] { bg.start(background, 2); }, [&bg] { bg.stop(); } });
+    cases.push_back({ "pricecache.readContended", cases[cases.size() - 2].run,
+                      [&bg, background] { bg.start(background, 2); }, [&bg] { bg.stop(); } });
+}
+
+static void addAssetCases(std::vector<BenchCase>& cases) {
+    static char s_lastCoin[32], s_lastName[64];
+    strcpy_s(s_lastCoin, g_assets.getByIndex(ASSET_COUNT - 1)->coin);
+    strcpy_s(s_lastName, g_assets.getByIndex(ASSET_COUNT - 1)->name);
+
+    cases.push_back({ "assets.findByCoin.first", [](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) consume((uint64_t)g_assets.findByCoin("BTC"));
+    } });
+    cases.push_back({ "assets.findByCoin.last", [](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) consume((uint64_t)g_assets.findByCoin(s_lastCoin));
+    } });
+    cases.push_back({ "assets.findByName.last", [](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) consume((uint64_t)g_assets.findByName(s_lastName));
+    } });
+    cases.push_back({ "assets.getByIndex", [](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++)
+            consume((uint64_t)g_assets.getByIndex((int)(i % ASSET_COUNT))->szDecimals);
+    } });
+}
+
+static void addFormatCases(std::vector<BenchCase>& cases) {
+    static const double PRICES[8] = { 50123.4567, 3012.3456, 151.23456, 0.123456,
+                                      0.00001234, 25.5, 1.999999, 98765.4321 };
+    static const int SZ_DECIMALS[8] = { 5, 4, 2, 0, 0, 1, 2, 5 };
+    cases.push_back({ "format.priceForExchange", [](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++)
+            consume(utils::formatPriceForExchange(PRICES[i & 7], SZ_DECIMALS[i & 7]).size());
+    } });
+    cases.push_back({ "format.size", [](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++)
+            consume(utils::formatSize(PRICES[i & 7] / 1000.0, SZ_DECIMALS[i & 7]).size());
+    } });
+}
+
+//=============================================================================
+// CHECKS
+//=============================================================================
+
+// A payload that silently parses to nothing would benchmark the error path
+static bool checkPayloads(const Payloads& p) {
+    bool ok = true;
+    ws::L2BookUpdate book = ws::parseL2Book(p.l2Book.c_str(), 0, nullptr);
+    if (!book.valid || book.bid <= 0.0 || book.ask <= book.bid) {
+        printf("FAILED: l2Book payload has no top of book\n");
+        ok = false;
+    }
+    ws::PriceCache cache;
+    ws::parseClearinghouseState(cache, p.clearinghouse.c_str(), 0, nullptr);
+    if (cache.getAllPositions().empty() && cache.getAccountData().accountValue <= 0.0) {
+        printf("FAILED: clearinghouseState payload has no positions or account value\n");
+        ok = false;
+    }
+    ws::parseUserFills(cache, p.userFills.c_str(), 0, nullptr);
+    if (cache.getRecentFills(1).empty()) {
+        printf("FAILED: userFills payload has no fills\n");
+        ok = false;
+    }
+    if (ws::parsePostResponse(p.post.c_str(), 0, nullptr).requestId == 0) {
+        printf("FAILED: post payload has no request id\n");
+        ok = false;
+    }
+    return ok;
+}
+
+static void registerAssets() {
+    static const char* MAJORS[] = { "BTC", "ETH", "SOL", "AVAX", "ARB", "DOGE", "LINK", "OP" };
+    g_assets.init();
+    for (int i = 0; i < ASSET_COUNT; i++) {
+        AssetInfo a;
+        if (i < 8) strcpy_s(a.coin, MAJORS[i]);
+        else sprintf_s(a.coin, "COIN%03d", i);
+        sprintf_s(a.name, "%s-USD", a.coin);
+        a.index = i;
+        a.szDecimals = i % 6;
+        a.maxLeverage = 10;
+        g_assets.add(a);
+    }
+}
+
+//=============================================================================
+// MAIN
+//=============================================================================
+
+int main(int argc, char** argv) {
+    Options opt;
+    for (int i = 1; i < argc; i++) {
+        const char* a = argv[i];
+        if (!strcmp(a, "--list")) { opt.list = true; continue; }
+        const char* v = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (!v) {
+            printf("usage: hl_bench [--json FILE|-] [--filter TEXT] [--repeats N] [--min-ms N] "
+                   "[--label TEXT] [--capture FILE] [--list]\n");
+            return 2;
+        }
+        i++;
+        if (!strcmp(a, "--json")) opt.jsonPath = v;
+        else if (!strcmp(a, "--filter")) opt.filter = v;
+        else if (!strcmp(a, "--label")) opt.label = v;
+        else if (!strcmp(a, "--capture")) opt.capturePath = v;
+        else if (!strcmp(a, "--repeats")) opt.repeats = (std::max)(1, atoi(v));
+        else if (!strcmp(a, "--min-ms")) opt.minMs = (std::max)(1, atoi(v));
+        else {
+            printf("unknown option %s\n", a);
+            return 2;
+        }
+    }
+    // JSON on stdout must stay parseable: the table goes to stderr then
+    FILE* out = opt.jsonPath && !strcmp(opt.jsonPath, "-") ? stderr : stdout;
+
+    Payloads payloads;
+    payloads.l2Book = buildL2Book();
+    payloads.clearinghouse = buildClearinghouseState();
+    payloads.userFills = buildUserFills();
+    payloads.post = buildPostResponse();
+    if (opt.capturePath && !loadCapture(opt.capturePath, payloads)) {
+        fprintf(out, "FAILED: cannot read capture %s\n", opt.capturePath);
+        return 1;
+    }
+    if (!checkPayloads(payloads)) return 1;
+
+    crypto::init();
+    registerAssets();
+
+    eip712::OrderAction action;
+    action.asset = 0;
+    action.isBuy = true;
+    action.price = "50000";
+    action.size = "0.01";
+    action.reduceOnly = false;
+    action.orderType = "Gtc";
+    action.cloid = "0x0000000000000000000000000000002a";
+
+    ws::PriceCache parseCache;
+    ws::PriceCache priceCache;
+    std::vector<uint32_t> ids;
+    for (int i = 0; i < 64; i++) {
+        uint32_t id = g_symbols.intern(g_assets.getByIndex(i)->coin);
+        priceCache.setBidAsk(id, 100.0, 101.0);
+        ids.push_back(id);
+    }
+    Contention contention;
+
+    std::vector<BenchCase> cases;
+    addParseCases(cases, payloads, parseCache);
+    addSignCases(cases, action);
+    addMsgpackCases(cases);
+    addPriceCacheCases(cases, priceCache, ids, contention);
+    addAssetCases(cases);
+    addFormatCases(cases);
+
+    if (opt.list) {
+        for (const BenchCase& c : cases) printf("%s\n", c.name.c_str());
+        return 0;
+    }
+
+    fprintf(out, "=== hl_bench (%s, %s, payloads %s) ===\n\n", platformName(),
+            compilerName().c_str(), payloads.source.c_str());
+    fprintf(out, "%-30s %12s %12s %12s %12s\n", "case", "ns/op", "min", "max", "iters");
+
+    std::vector<BenchResult> results;
+    for (const BenchCase& c : cases) {
+        if (opt.filter && c.name.find(opt.filter) == std::string::npos) continue;
+        BenchResult r = measure(c, opt);
+        fprintf(out, "%-30s %12.1f %12.1f %12.1f %12llu\n", r.name.c_str(), r.nsPerOp, r.minNs,
+                r.maxNs, (unsigned long long)r.iterations);
+        fflush(out);
+        results.push_back(r);
+    }
+
+    g_assets.cleanup();
+    crypto::cleanup();
+
+    if (opt.jsonPath && !writeJson(opt.jsonPath, opt, payloads, results)) {
+        fprintf(out, "FAILED: cannot write %s\n", opt.jsonPath);
+        return 1;
+    }
+    return 0;
+}
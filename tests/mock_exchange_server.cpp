@@ -0,0 +1,143 @@
+//=============================================================================
+// mock_exchange_server.cpp - Standalone local Hyperliquid mock exchange
+//=============================================================================
+// Part of Hyperliquid Plugin for Zorro
+//
+// LAYER: Test (server binary)
+// PURPOSE: Runs MockExchangeServer (tests/mocks/mock_exchange_server.h) until
+//          --duration elapses or the process is stopped, then prints what it
+//          served. Orders must be signed by --signer (or any key if omitted)
+//          with the EIP-712 domain of --mainnet / testnet.
+//
+// USAGE:   mock_exchange_server [options]
+//            --ws-port N          WebSocket port (default 18765)
+//            --http-port N        /info + /exchange port (default 18766)
+//            --coins LIST         NAME:MID:SZDEC,... (default BTC:50000:5,ETH:3000:4,SOL:150:2)
+//            --user ADDR          account for /info and user channels
+//            --signer ADDR        required signer (default: accept any valid signature)
+//            --mainnet            verify with the mainnet source ("a")
+//            --no-verify          skip signature recovery (nonces still checked)
+//            --book-hz X          l2Book / activeAssetCtx push rate (default 10)
+//            --account-hz X       clearinghouseState / openOrders push rate (default 1)
+//            --volatility X       relative mid stddev per book tick (default 0.0002)
+//            --429 P              share of HTTP requests answered 429
+//            --slow-ms N [--slow-rate P]  delay HTTP replies
+//            --lost-reply P       apply /exchange but answer 502
+//            --drop-ack P         drop WS subscription acks / post replies
+//            --disconnect-ms N    close every WS client every N ms
+//            --duration S         exit after S seconds (default: run forever)
+//
+// Point the plugin at it: baseUrl = http://127.0.0.1:<http-port>,
+// WebSocketManager::setEndpoint("127.0.0.1:<ws-port>", false).
+//
+// NETWORK: Local only (127.0.0.1)
+//=============================================================================
+
+#include "mocks/mock_exchange_server.h"
+#include <IXNetSystem.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <thread>
+
+using namespace hl::test;
+
+static bool parseCoins(const char* list, std::vector<MockCoin>& out) {
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        size_t a = item.find(':');
+        size_t b = a == std::string::npos ? a : item.find(':', a + 1);
+        if (b == std::string::npos) return false;
+        MockCoin c;
+        c.name = item.substr(0, a);
+        c.mid = atof(item.substr(a + 1, b - a - 1).c_str());
+        c.szDecimals = atoi(item.substr(b + 1).c_str());
+        if (c.name.empty() || c.mid <= 0) return false;
+        out.push_back(c);
+    }
+    return !out.empty();
+}
+
+int main(int argc, char** argv) {
+    MockExchangeConfig cfg;
+    MockFaults faults;
+    int wsPort = 18765, httpPort = 18766;
+    double bookHz = 10.0, accountHz = 1.0;
+    double duration = 0.0;
+    const char* coins = "BTC:50000:5,ETH:3000:4,SOL:150:2";
+    cfg.user = "0x0000000000000000000000000000000000000001";
+
+    for (int i = 1; i < argc; i++) {
+        const char* a = argv[i];
+        const char* v = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (!strcmp(a, "--mainnet")) { cfg.isMainnet = true; continue; }
+        if (!strcmp(a, "--no-verify")) { cfg.verifySignatures = false; continue; }
+        if (!v) {
+            printf("usage: mock_exchange_server [options] (see header of mock_exchange_server.cpp)\n");
+            return 2;
+        }
+        i++;
+        if (!strcmp(a, "--ws-port")) wsPort = atoi(v);
+        else if (!strcmp(a, "--http-port")) httpPort = atoi(v);
+        else if (!strcmp(a, "--coins")) coins = v;
+        else if (!strcmp(a, "--user")) cfg.user = v;
+        else if (!strcmp(a, "--signer")) cfg.signer = v;
+        else if (!strcmp(a, "--book-hz")) bookHz = atof(v);
+        else if (!strcmp(a, "--account-hz")) accountHz = atof(v);
+        else if (!strcmp(a, "--volatility")) cfg.volatility = atof(v);
+        else if (!strcmp(a, "--429")) faults.http429Rate = atof(v);
+        else if (!strcmp(a, "--slow-ms")) faults.slowMs = atoi(v);
+        else if (!strcmp(a, "--slow-rate")) faults.slowRate = atof(v);
+        else if (!strcmp(a, "--lost-reply")) faults.lostReplyRate = atof(v);
+        else if (!strcmp(a, "--drop-ack")) faults.dropAckRate = atof(v);
+        else if (!strcmp(a, "--disconnect-ms")) faults.disconnectEveryMs = atoi(v);
+        else if (!strcmp(a, "--duration")) duration = atof(v);
+        else {
+            printf("unknown option %s\n", a);
+            return 2;
+        }
+    }
+    if (!parseCoins(coins, cfg.coins)) {
+        printf("bad --coins list: %s\n", coins);
+        return 2;
+    }
+
+    ix::initNetSystem();
+    MockExchangeServer server(cfg, wsPort, httpPort);
+    server.faults() = faults;
+    server.setRates(bookHz, accountHz);
+    if (!server.start()) return 1;
+
+    printf("=== Mock Hyperliquid Exchange ===\n");
+    printf("HTTP %s (/info, /exchange)\nWS   ws://%s/ws\n", server.httpUrl().c_str(),
+           server.wsHost().c_str());
+    printf("user %s, signer %s, %s signatures%s\n", cfg.user.c_str(),
+           cfg.signer.empty() ? "any" : cfg.signer.c_str(), cfg.isMainnet ? "mainnet" : "testnet",
+           cfg.verifySignatures ? "" : " (not verified)");
+    for (const MockCoin& c : cfg.coins) printf("  %-8s mid %g szDecimals %d\n", c.name.c_str(), c.mid, c.szDecimals);
+    printf("faults: 429 %.3f, slow %dms@%.2f, lost reply %.3f, drop ack %.3f, disconnect every %dms\n",
+           faults.http429Rate, faults.slowMs, faults.slowRate, faults.lostReplyRate,
+           faults.dropAckRate, faults.disconnectEveryMs);
+    fflush(stdout);
+
+    auto t0 = std::chrono::steady_clock::now();
+    while (duration <= 0.0 ||
+           std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count() < duration) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    server.stop();
+
+    MockServerStats st = server.stats();
+    MockExchangeStats ex = server.exchange().stats();
+    printf("\nHTTP: %lld requests, %lld x 429, %lld slowed, %lld lost replies\n",
+           st.httpRequests, st.http429, st.httpSlowed, st.lostReplies);
+    printf("WS:   %lld connections, %lld frames in, %lld out, %lld acks dropped, %lld disconnect rounds\n",
+           st.wsConnections, st.wsFramesIn, st.wsFramesOut, st.droppedAcks, st.disconnects);
+    printf("Exchange: %lld orders, %lld fills, %lld cancels, %lld rejected, %lld bad signatures, %lld bad nonces\n",
+           ex.orders, ex.fills, ex.cancels, ex.rejected, ex.badSignatures, ex.badNonces);
+    ix::uninitNetSystem();
+    return 0;
+}
@@ -0,0 +1,891 @@
+//=============================================================================
+// mock_exchange.h - In-process Hyperliquid exchange model for offline tests
+//=============================================================================
+// Part of Hyperliquid Plugin for Zorro
+//
+// LAYER: Test Infrastructure
+// PURPOSE: Answers /info and /exchange request bodies the way the exchange
+//          does, without any network code (mock_exchange_server.h puts it
+//          behind real WS and HTTP sockets):
+//          - /exchange: nonce window + duplicate check, EIP-712 signer
+//            recovery through the plugin's own hl_eip712/hl_msgpack/hl_crypto,
+//            then order / cancel / batchModify / scheduleCancel
+//          - /info: meta, metaAndAssetCtxs, allMids, l2Book, clearinghouseState,
+//            spotClearinghouseState, openOrders, frontendOpenOrders,
+//            orderStatus, userFills, historicalOrders, spot/perpDex stubs
+//          - Matching: each coin has a synthetic top of book around a mid that
+//            random-walks on tick(). Crossing orders fill at the touch (IOC,
+//            GTC), ALO that would cross is rejected, resting orders and
+//            triggers fill when the touch moves through them.
+//          - One account (config.user): positions, entry price, realized PnL
+//            and fees feed clearinghouseState.
+//          Order events go to the event sink as ready WS frames (orderUpdates,
+//          userFills); the sink runs outside the engine lock.
+//
+// USAGE:
+//   hl::test::MockExchangeConfig cfg;
+//   cfg.coins = { {"BTC", 50000.0, 5}, {"ETH", 3000.0, 4} };
+//   cfg.user = "0x...";
+//   hl::test::MockExchange ex(cfg);
+//   hl::test::MockReply r = ex.exchange(signedOrderJson);   // r.status, r.body
+//   ex.tick();                                              // move mids
+//=============================================================================
+
+#pragma once
+
+#include "hl_crypto.h"
+#include "hl_eip712.h"
+#include "hl_msgpack.h"
+#include <yyjson.h>
+#include <chrono>
+#include <cmath>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <random>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+#ifndef _WIN32
+#include <strings.h>
+#endif
+
+namespace hl {
+namespace test {
+
+struct MockCoin {
+    std::string name;
+    double mid;
+    int szDecimals;
+};
+
+struct MockExchangeConfig {
+    std::vector<MockCoin> coins;        // Asset index = position in this list
+    std::string user;                   // Account served by /info and user channels
+    std::string signer;                 // Required signer ("" = any valid signature)
+    bool isMainnet = false;             // EIP-712 source "a" (mainnet) or "b"
+    bool verifySignatures = true;
+    double accountValue = 100000.0;     // Starting USDC
+    double spreadBps = 1.0;             // Synthetic touch: mid +/- half of this
+    double volatility = 0.0002;         // Relative stddev of the mid per tick()
+    double feeRate = 0.00035;           // Taker fee on crossing fills
+    double makerFeeRate = 0.0001;
+    int leverage = 10;
+    unsigned seed = 1;
+};
+
+struct MockReply {
+    int status;
+    std::string body;
+};
+
+struct MockExchangeStats {
+    long long orders = 0;               // Accepted order wires
+    long long fills = 0;
+    long long cancels = 0;
+    long long rejected = 0;             // Order wires answered with an error
+    long long badSignatures = 0;
+    long long badNonces = 0;
+};
+
+class MockExchange {
+public:
+    typedef std::function<void(const char* channel, const std::string& frame)> EventSink;
+
+    explicit MockExchange(const MockExchangeConfig& cfg)
+        : cfg_(cfg), rng_(cfg.seed), nextOid_(1000000), nextTid_(1), scheduleCancelMs_(0) {
+        for (const MockCoin& c : cfg_.coins) {
+            Book b;
+            b.mid = c.mid;
+            books_.push_back(b);
+        }
+        realized_ = 0.0;
+        if (cfg_.verifySignatures) crypto::init();
+    }
+
+    /// Receives orderUpdates/userFills frames as orders change
+    void setEventSink(EventSink sink) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        sink_ = sink;
+    }
+
+    const MockExchangeConfig& config() const { return cfg_; }
+
+    MockExchangeStats stats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stats_;
+    }
+
+    double mid(const std::string& coin) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        int a = assetOf(coin);
+        return a >= 0 ? books_[a].mid : 0.0;
+    }
+
+    /// Moves a mid by hand (tests); resting orders and triggers it crosses fill
+    void setMid(const std::string& coin, double px) {
+        Events ev;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            int a = assetOf(coin);
+            if (a < 0) return;
+            books_[a].mid = px;
+            matchResting(a, ev);
+        }
+        emit(ev);
+    }
+
+    /// One random-walk step on every mid, then resting/trigger matching and
+    /// an expired scheduleCancel
+    void tick() {
+        Events ev;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            std::normal_distribution<double> step(0.0, cfg_.volatility);
+            for (size_t a = 0; a < books_.size(); a++) {
+                books_[a].mid *= 1.0 + step(rng_);
+                matchResting((int)a, ev);
+            }
+            if (scheduleCancelMs_ && nowMs() >= scheduleCancelMs_) {
+                scheduleCancelMs_ = 0;
+                for (auto& kv : orders_) {
+                    if (kv.second.status == "open") cancelLocked(kv.second, "scheduledCancel", ev);
+                }
+            }
+        }
+        emit(ev);
+    }
+
+    //-------------------------------------------------------------------------
+    // POST /exchange
+    //-------------------------------------------------------------------------
+
+    MockReply exchange(const std::string& body) {
+        Events ev;
+        MockReply reply;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            reply = exchangeLocked(body, ev);
+        }
+        emit(ev);
+        return reply;
+    }
+
+    //-------------------------------------------------------------------------
+    // POST /info
+    //-------------------------------------------------------------------------
+
+    MockReply info(const std::string& body) {
+        yyjson_doc* doc = yyjson_read(body.c_str(), body.size(), 0);
+        yyjson_val* root = doc ? yyjson_doc_get_root(doc) : nullptr;
+        const char* type = yyjson_get_str(yyjson_obj_get(root, "type"));
+        MockReply r = { 200, std::string() };
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!type) {
+            r = { 422, "Failed to deserialize the JSON body into the target type" };
+        } else if (!strcmp(type, "meta")) {
+            r.body = metaJson();
+        } else if (!strcmp(type, "metaAndAssetCtxs")) {
+            r.body = "[" + metaJson() + ",[";
+            for (size_t a = 0; a < books_.size(); a++) {
+                if (a) r.body += ",";
+                r.body += assetCtxJson((int)a);
+            }
+            r.body += "]]";
+        } else if (!strcmp(type, "allMids")) {
+            r.body = "{";
+            for (size_t a = 0; a < books_.size(); a++) {
+                r.body += format("%s\"%s\":\"%s\"", a ? "," : "", cfg_.coins[a].name.c_str(),
+                                 num(books_[a].mid).c_str());
+            }
+            r.body += "}";
+        } else if (!strcmp(type, "l2Book")) {
+            const char* coin = yyjson_get_str(yyjson_obj_get(root, "coin"));
+            int a = coin ? assetOf(coin) : -1;
+            r.body = a >= 0 ? bookJson(a) : "null";
+        } else if (!strcmp(type, "clearinghouseState")) {
+            r.body = clearinghouseJson();
+        } else if (!strcmp(type, "spotClearinghouseState")) {
+            r.body = format("{\"balances\":[{\"coin\":\"USDC\",\"token\":0,\"hold\":\"0.0\","
+                            "\"total\":\"%s\",\"entryNtl\":\"0.0\"}]}", num(accountValue()).c_str());
+        } else if (!strcmp(type, "openOrders") || !strcmp(type, "frontendOpenOrders")) {
+            r.body = openOrdersJson(!strcmp(type, "frontendOpenOrders"));
+        } else if (!strcmp(type, "orderStatus")) {
+            const Order* o = findOrder(yyjson_obj_get(root, "oid"));
+            r.body = o ? format("{\"status\":\"order\",\"order\":{\"order\":%s,\"status\":\"%s\","
+                                "\"statusTimestamp\":%llu}}", orderJson(*o, true).c_str(),
+                                o->status.c_str(), (unsigned long long)o->statusMs)
+                       : "{\"status\":\"unknownOid\"}";
+        } else if (!strcmp(type, "userFills")) {
+            r.body = "[";
+            for (size_t i = 0; i < fills_.size(); i++) r.body += (i ? "," : "") + fills_[i];
+            r.body += "]";
+        } else if (!strcmp(type, "historicalOrders")) {
+            r.body = "[";
+            bool first = true;
+            for (const auto& kv : orders_) {
+                r.body += format("%s{\"order\":%s,\"status\":\"%s\",\"statusTimestamp\":%llu}",
+                                 first ? "" : ",", orderJson(kv.second, true).c_str(),
+                                 kv.second.status.c_str(), (unsigned long long)kv.second.statusMs);
+                first = false;
+            }
+            r.body += "]";
+        } else if (!strcmp(type, "spotMeta")) {
+            r.body = "{\"universe\":[],\"tokens\":[]}";
+        } else if (!strcmp(type, "spotMetaAndAssetCtxs")) {
+            r.body = "[{\"universe\":[],\"tokens\":[]},[]]";
+        } else if (!strcmp(type, "perpDexs")) {
+            r.body = "[null]";
+        } else if (!strcmp(type, "userRole")) {
+            r.body = "{\"role\":\"user\"}";
+        } else if (!strcmp(type, "candleSnapshot")) {
+            r.body = "[]";
+        } else {
+            r = { 422, "Failed to deserialize the JSON body into the target type" };
+        }
+        if (doc) yyjson_doc_free(doc);
+        return r;
+    }
+
+    //-------------------------------------------------------------------------
+    // WS frames for the server's periodic pushes
+    //-------------------------------------------------------------------------
+
+    std::string l2BookFrame(const std::string& coin) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        int a = assetOf(coin);
+        return a >= 0 ? "{\"channel\":\"l2Book\",\"data\":" + bookJson(a) + "}" : std::string();
+    }
+
+    std::string clearinghouseFrame() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return format("{\"channel\":\"clearinghouseState\",\"data\":{\"dex\":\"\",\"user\":\"%s\","
+                      "\"clearinghouseState\":", cfg_.user.c_str()) + clearinghouseJson() + "}}";
+    }
+
+    std::string openOrdersFrame() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return format("{\"channel\":\"openOrders\",\"data\":{\"dex\":\"\",\"user\":\"%s\",\"orders\":",
+                      cfg_.user.c_str()) + openOrdersJson(false) + "}}";
+    }
+
+    std::string assetCtxFrame(const std::string& coin) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        int a = assetOf(coin);
+        if (a < 0) return std::string();
+        return format("{\"channel\":\"activeAssetCtx\",\"data\":{\"coin\":\"%s\",\"ctx\":",
+                      coin.c_str()) + assetCtxJson(a) + "}}";
+    }
+
+    /// userFills snapshot sent right after a userFills subscribe
+    std::string userFillsSnapshotFrame() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::string f = format("{\"channel\":\"userFills\",\"data\":{\"isSnapshot\":true,"
+                               "\"user\":\"%s\",\"fills\":[", cfg_.user.c_str());
+        for (size_t i = 0; i < fills_.size(); i++) f += (i ? "," : "") + fills_[i];
+        return f + "]}}";
+    }
+
+    static uint64_t nowMs() {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+private:
+    struct Book {
+        double mid;
+    };
+
+    struct Order {
+        uint64_t oid;
+        int asset;
+        bool isBuy;
+        double px;
+        double sz;              // Remaining
+        double origSz;
+        std::string tif;        // "Gtc", "Ioc", "Alo"; empty for triggers
+        std::string cloid;
+        bool reduceOnly;
+        bool isTrigger;
+        bool triggerIsMarket;
+        double triggerPx;
+        std::string tpsl;
+        uint64_t timestamp;
+        std::string status;     // open, filled, canceled, triggered, rejected, ...
+        uint64_t statusMs;
+    };
+
+    struct Position {
+        double szi = 0.0;
+        double entryPx = 0.0;
+    };
+
+    typedef std::vector<std::pair<const char*, std::string>> Events;
+
+    MockExchangeConfig cfg_;
+    mutable std::mutex mutex_;
+    EventSink sink_;
+    std::mt19937 rng_;
+    std::vector<Book> books_;
+    std::map<uint64_t, Order> orders_;
+    std::map<int, Position> positions_;
+    std::vector<std::string> fills_;        // userFills entries (JSON objects)
+    std::set<uint64_t> nonces_;             // 100 highest nonces seen
+    uint64_t nextOid_;
+    uint64_t nextTid_;
+    uint64_t scheduleCancelMs_;
+    double realized_;                       // Closed PnL minus fees
+    MockExchangeStats stats_;
+
+    //-------------------------------------------------------------------------
+    // Formatting
+    //-------------------------------------------------------------------------
+
+    static std::string format(const char* fmt, ...) {
+        char buf[2048];
+        va_list args;
+        va_start(args, fmt);
+        vsnprintf(buf, sizeof(buf), fmt, args);
+        va_end(args);
+        return buf;
+    }
+
+    /// Decimal string as the exchange sends it ("50000.5", "0.01")
+    static std::string num(double v) {
+        char buf[64];
+        snprintf(buf, sizeof(buf), "%.8f", v);
+        char* dot = strchr(buf, '.');
+        if (dot) {
+            char* end = buf + strlen(buf) - 1;
+            while (end > dot && *end == '0') *end-- = 0;
+            if (end == dot) end[1] = '0';           // Keep "50000.0"
+        }
+        return buf;
+    }
+
+    static double getNum(yyjson_val* v) {
+        if (yyjson_is_str(v)) return atof(yyjson_get_str(v));
+        return yyjson_is_num(v) ? yyjson_get_num(v) : 0.0;
+    }
+
+    static bool sameAddress(const std::string& a, const char* b) {
+#ifdef _WIN32
+        return _stricmp(a.c_str(), b) == 0;
+#else
+        return strcasecmp(a.c_str(), b) == 0;
+#endif
+    }
+
+    int assetOf(const std::string& coin) const {
+        for (size_t a = 0; a < cfg_.coins.size(); a++) {
+            if (cfg_.coins[a].name == coin) return (int)a;
+        }
+        return -1;
+    }
+
+    double bid(int a) const { return books_[a].mid * (1.0 - cfg_.spreadBps * 0.5e-4); }
+    double ask(int a) const { return books_[a].mid * (1.0 + cfg_.spreadBps * 0.5e-4); }
+
+    double accountValue() const {
+        double v = cfg_.accountValue + realized_;
+        for (const auto& kv : positions_) {
+            v += kv.second.szi * (books_[kv.first].mid - kv.second.entryPx);
+        }
+        return v;
+    }
+
+    std::string metaJson() const {
+        std::string s = "{\"universe\":[";
+        for (size_t a = 0; a < cfg_.coins.size(); a++) {
+            s += format("%s{\"name\":\"%s\",\"szDecimals\":%d,\"maxLeverage\":50}", a ? "," : "",
+                        cfg_.coins[a].name.c_str(), cfg_.coins[a].szDecimals);
+        }
+        return s + "]}";
+    }
+
+    std::string assetCtxJson(int a) const {
+        std::string m = num(books_[a].mid);
+        return format("{\"funding\":\"0.0000125\",\"openInterest\":\"1000.0\",\"prevDayPx\":\"%s\","
+                      "\"dayNtlVlm\":\"1000000.0\",\"premium\":\"0.0\",\"oraclePx\":\"%s\","
+                      "\"markPx\":\"%s\",\"midPx\":\"%s\",\"impactPxs\":[\"%s\",\"%s\"],"
+                      "\"dayBaseVlm\":\"100.0\"}",
+                      num(cfg_.coins[a].mid).c_str(), m.c_str(), m.c_str(), m.c_str(),
+                      num(bid(a)).c_str(), num(ask(a)).c_str());
+    }
+
+    /// Five synthetic levels per side, one spread apart
+    std::string bookJson(int a) const {
+        double step = books_[a].mid * cfg_.spreadBps * 1e-4;
+        std::string side[2];
+        for (int s = 0; s < 2; s++) {
+            for (int i = 0; i < 5; i++) {
+                double px = s == 0 ? bid(a) - i * step : ask(a) + i * step;
+                side[s] += format("%s{\"px\":\"%s\",\"sz\":\"%s\",\"n\":%d}", i ? "," : "",
+                                  num(px).c_str(), num(10.0 * (i + 1)).c_str(), i + 1);
+            }
+        }
+        return format("{\"coin\":\"%s\",\"time\":%llu,\"levels\":[[%s],[%s]]}",
+                      cfg_.coins[a].name.c_str(), (unsigned long long)nowMs(),
+                      side[0].c_str(), side[1].c_str());
+    }
+
+    std::string orderJson(const Order& o, bool frontend) const {
+        std::string s = format("{\"coin\":\"%s\",\"side\":\"%s\",\"limitPx\":\"%s\",\"sz\":\"%s\","
+                               "\"oid\":%llu,\"timestamp\":%llu,\"origSz\":\"%s\"",
+                               cfg_.coins[o.asset].name.c_str(), o.isBuy ? "B" : "A",
+                               num(o.px).c_str(), num(o.sz).c_str(), (unsigned long long)o.oid,
+                               (unsigned long long)o.timestamp, num(o.origSz).c_str());
+        if (!o.cloid.empty()) s += ",\"cloid\":\"" + o.cloid + "\"";
+        if (frontend) {
+            s += format(",\"orderType\":\"%s\",\"tif\":%s,\"reduceOnly\":%s,\"isTrigger\":%s,"
+                        "\"triggerPx\":\"%s\",\"triggerCondition\":\"%s\",\"isPositionTpsl\":false",
+                        o.isTrigger ? (o.tpsl == "tp" ? "Take Profit Market" : "Stop Market") : "Limit",
+                        o.isTrigger ? "null" : ("\"" + o.tif + "\"").c_str(),
+                        o.reduceOnly ? "true" : "false", o.isTrigger ? "true" : "false",
+                        num(o.triggerPx).c_str(), o.isTrigger ? "Triggered by mark price" : "N/A");
+        }
+        return s + "}";
+    }
+
+    std::string openOrdersJson(bool frontend) const {
+        std::string s = "[";
+        bool first = true;
+        for (const auto& kv : orders_) {
+            if (kv.second.status != "open") continue;
+            s += (first ? "" : ",") + orderJson(kv.second, frontend);
+            first = false;
+        }
+        return s + "]";
+    }
+
+    std::string clearinghouseJson() const {
+        double ntl = 0.0, margin = 0.0;
+        std::string pos;
+        for (const auto& kv : positions_) {
+            const Position& p = kv.second;
+            if (p.szi == 0.0) continue;
+            double mid = books_[kv.first].mid;
+            double value = fabs(p.szi) * mid;
+            double upnl = p.szi * (mid - p.entryPx);
+            ntl += value;
+            margin += value / cfg_.leverage;
+            pos += format("%s{\"type\":\"oneWay\",\"position\":{\"coin\":\"%s\",\"szi\":\"%s\","
+                          "\"leverage\":{\"type\":\"cross\",\"value\":%d},\"entryPx\":\"%s\","
+                          "\"positionValue\":\"%s\",\"unrealizedPnl\":\"%s\",\"returnOnEquity\":\"%s\","
+                          "\"liquidationPx\":null,\"marginUsed\":\"%s\",\"maxLeverage\":50}}",
+                          pos.empty() ? "" : ",", cfg_.coins[kv.first].name.c_str(),
+                          num(p.szi).c_str(), cfg_.leverage, num(p.entryPx).c_str(),
+                          num(value).c_str(), num(upnl).c_str(),
+                          num(value > 0 ? upnl / (value / cfg_.leverage) : 0.0).c_str(),
+                          num(value / cfg_.leverage).c_str());
+        }
+        double acct = accountValue();
+        std::string summary = format("{\"accountValue\":\"%s\",\"totalNtlPos\":\"%s\","
+                                     "\"totalRawUsd\":\"%s\",\"totalMarginUsed\":\"%s\"}",
+                                     num(acct).c_str(), num(ntl).c_str(), num(acct).c_str(),
+                                     num(margin).c_str());
+        return "{\"marginSummary\":" + summary + ",\"crossMarginSummary\":" + summary +
+               format(",\"crossMaintenanceMarginUsed\":\"%s\",\"withdrawable\":\"%s\","
+                      "\"assetPositions\":[", num(margin / 2).c_str(), num(acct - margin).c_str()) +
+               pos + format("],\"time\":%llu}", (unsigned long long)nowMs());
+    }
+
+    //-------------------------------------------------------------------------
+    // Events
+    //-------------------------------------------------------------------------
+
+    void orderEvent(const Order& o, Events& ev) {
+        ev.push_back(std::make_pair("orderUpdates",
+            format("{\"channel\":\"orderUpdates\",\"data\":[{\"order\":%s,\"status\":\"%s\","
+                   "\"statusTimestamp\":%llu}]}", orderJson(o, false).c_str(), o.status.c_str(),
+                   (unsigned long long)o.statusMs)));
+    }
+
+    void emit(const Events& ev) {
+        EventSink sink;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            sink = sink_;
+        }
+        if (!sink) return;
+        for (const auto& e : ev) sink(e.first, e.second);
+    }
+
+    //-------------------------------------------------------------------------
+    // Matching
+    //-------------------------------------------------------------------------
+
+    /// Applies a fill to the order and the position, records the userFill
+    void fillLocked(Order& o, double px, double sz, bool crossed, Events& ev) {
+        Position& p = positions_[o.asset];
+        double start = p.szi;
+        double signedSz = o.isBuy ? sz : -sz;
+        double closedPnl = 0.0;
+        const char* dir;
+        if (start == 0.0 || (start > 0) == o.isBuy) {
+            p.entryPx = (fabs(start) * p.entryPx + sz * px) / (fabs(start) + sz);
+            p.szi = start + signedSz;
+            dir = o.isBuy ? "Open Long" : "Open Short";
+        } else {
+            double closed = (std::min)(sz, fabs(start));
+            closedPnl = closed * (px - p.entryPx) * (start > 0 ? 1.0 : -1.0);
+            p.szi = start + signedSz;
+            if (fabs(p.szi) < 1e-12) p.szi = 0.0;
+            if (p.szi != 0.0 && (p.szi > 0) != (start > 0)) p.entryPx = px;   // Flipped
+            dir = start > 0 ? "Close Long" : "Close Short";
+        }
+        double fee = sz * px * (crossed ? cfg_.feeRate : cfg_.makerFeeRate);
+        realized_ += closedPnl - fee;
+
+        double filledBefore = o.origSz - o.sz;
+        o.sz -= sz;
+        if (o.sz < 1e-12) o.sz = 0.0;
+        o.statusMs = nowMs();
+        if (o.sz == 0.0) o.status = "filled";
+        // Average fill price lives in px for filled orders (orderStatus avgPx)
+        o.px = filledBefore > 0 ? (o.px * filledBefore + px * sz) / (filledBefore + sz) : px;
+        stats_.fills++;
+
+        std::string fill = format("{\"coin\":\"%s\",\"px\":\"%s\",\"sz\":\"%s\",\"side\":\"%s\","
+                                  "\"time\":%llu,\"startPosition\":\"%s\",\"dir\":\"%s\","
+                                  "\"closedPnl\":\"%s\",\"hash\":\"0x%064llx\",\"oid\":%llu,"
+                                  "\"crossed\":%s,\"fee\":\"%s\",\"tid\":%llu,\"feeToken\":\"USDC\"",
+                                  cfg_.coins[o.asset].name.c_str(), num(px).c_str(), num(sz).c_str(),
+                                  o.isBuy ? "B" : "A", (unsigned long long)o.statusMs,
+                                  num(start).c_str(), dir, num(closedPnl).c_str(),
+                                  (unsigned long long)nextTid_, (unsigned long long)o.oid,
+                                  crossed ? "true" : "false", num(fee).c_str(),
+                                  (unsigned long long)nextTid_);
+        nextTid_++;
+        if (!o.cloid.empty()) fill += ",\"cloid\":\"" + o.cloid + "\"";
+        fill += "}";
+        fills_.push_back(fill);
+        ev.push_back(std::make_pair("userFills",
+            format("{\"channel\":\"userFills\",\"data\":{\"isSnapshot\":false,\"user\":\"%s\","
+                   "\"fills\":[", cfg_.user.c_str()) + fill + "]}}"));
+        orderEvent(o, ev);
+    }
+
+    void cancelLocked(Order& o, const char* status, Events& ev) {
+        o.status = status;
+        o.statusMs = nowMs();
+        stats_.cancels++;
+        orderEvent(o, ev);
+    }
+
+    /// Resting limits the touch moved through fill at their limit price;
+    /// triggers fire at the mid and fill at the touch
+    void matchResting(int a, Events& ev) {
+        for (auto& kv : orders_) {
+            Order& o = kv.second;
+            if (o.asset != a || o.status != "open") continue;
+            if (o.isTrigger) {
+                double m = books_[a].mid;
+                bool fire = (o.tpsl == "sl") == o.isBuy ? m >= o.triggerPx : m <= o.triggerPx;
+                if (!fire) continue;
+                o.status = "triggered";
+                o.statusMs = nowMs();
+                orderEvent(o, ev);
+                double touch = o.isBuy ? ask(a) : bid(a);
+                if (!o.triggerIsMarket && (o.isBuy ? o.px < touch : o.px > touch)) {
+                    o.isTrigger = false;            // Becomes a resting limit
+                    o.tif = "Gtc";
+                    o.status = "open";
+                    continue;
+                }
+                fillLocked(o, o.triggerIsMarket ? touch : o.px, o.sz, true, ev);
+            } else if (o.isBuy ? ask(a) <= o.px : bid(a) >= o.px) {
+                fillLocked(o, o.px, o.sz, false, ev);
+            }
+        }
+    }
+
+    /// One order wire; returns its status JSON for response.data.statuses
+    std::string placeLocked(yyjson_val* w, Events& ev) {
+        Order o;
+        o.asset = (int)yyjson_get_sint(yyjson_obj_get(w, "a"));
+        if (o.asset < 0 || o.asset >= (int)books_.size()) {
+            stats_.rejected++;
+            return "{\"error\":\"Invalid asset\"}";
+        }
+        o.oid = 0;
+        o.isBuy = yyjson_get_bool(yyjson_obj_get(w, "b"));
+        o.px = getNum(yyjson_obj_get(w, "p"));
+        o.sz = o.origSz = getNum(yyjson_obj_get(w, "s"));
+        o.reduceOnly = yyjson_get_bool(yyjson_obj_get(w, "r"));
+        const char* c = yyjson_get_str(yyjson_obj_get(w, "c"));
+        o.cloid = c ? c : "";
+        yyjson_val* t = yyjson_obj_get(w, "t");
+        yyjson_val* trig = yyjson_obj_get(t, "trigger");
+        o.isTrigger = trig != nullptr;
+        o.triggerIsMarket = trig ? yyjson_get_bool(yyjson_obj_get(trig, "isMarket")) : false;
+        o.triggerPx = trig ? getNum(yyjson_obj_get(trig, "triggerPx")) : 0.0;
+        const char* tpsl = trig ? yyjson_get_str(yyjson_obj_get(trig, "tpsl")) : nullptr;
+        o.tpsl = tpsl ? tpsl : "";
+        const char* tif = yyjson_get_str(yyjson_obj_get(yyjson_obj_get(t, "limit"), "tif"));
+        o.tif = tif ? tif : (o.isTrigger ? "" : "Gtc");
+        o.timestamp = o.statusMs = nowMs();
+        o.status = "open";
+        int a = o.asset;
+
+        if (o.sz <= 0.0 || o.px <= 0.0) {
+            stats_.rejected++;
+            return format("{\"error\":\"Order has invalid size or price. asset=%d\"}", a);
+        }
+        if (!o.cloid.empty()) {
+            for (const auto& kv : orders_) {
+                if (kv.second.cloid == o.cloid) {
+                    stats_.rejected++;
+                    return format("{\"error\":\"Duplicate cloid. asset=%d\"}", a);
+                }
+            }
+        }
+        if (o.reduceOnly) {
+            double szi = positions_[a].szi;
+            if (szi == 0.0 || (szi > 0) == o.isBuy) {
+                stats_.rejected++;
+                return format("{\"error\":\"Reduce only order would increase position. asset=%d\"}", a);
+            }
+            o.sz = o.origSz = (std::min)(o.sz, fabs(szi));
+        }
+
+        bool crosses = o.isBuy ? o.px >= ask(a) : o.px <= bid(a);
+        if (!o.isTrigger && o.tif == "Alo" && crosses) {
+            stats_.rejected++;
+            return format("{\"error\":\"Post only order would have immediately matched, "
+                          "bbo was %s@%s. asset=%d\"}", num(bid(a)).c_str(), num(ask(a)).c_str(), a);
+        }
+        if (!o.isTrigger && o.tif == "Ioc" && !crosses) {
+            stats_.rejected++;
+            return format("{\"error\":\"Order could not immediately match against any resting "
+                          "orders. asset=%d\"}", a);
+        }
+
+        o.oid = nextOid_++;
+        stats_.orders++;
+        Order& stored = orders_[o.oid] = o;
+        std::string cloidJson = o.cloid.empty() ? "" : ",\"cloid\":\"" + o.cloid + "\"";
+        if (!o.isTrigger && crosses) {
+            fillLocked(stored, o.isBuy ? ask(a) : bid(a), stored.sz, true, ev);
+            return format("{\"filled\":{\"totalSz\":\"%s\",\"avgPx\":\"%s\",\"oid\":%llu",
+                          num(stored.origSz).c_str(), num(stored.px).c_str(),
+                          (unsigned long long)stored.oid) + cloidJson + "}}";
+        }
+        orderEvent(stored, ev);
+        return format("{\"resting\":{\"oid\":%llu", (unsigned long long)stored.oid) + cloidJson + "}}";
+    }
+
+    //-------------------------------------------------------------------------
+    // Authentication
+    //-------------------------------------------------------------------------
+
+    /// Exchange nonce rules: within (now - 2 days, now + 1 day), unused, and
+    /// above the smallest of the 100 highest nonces once 100 were seen
+    const char* checkNonce(uint64_t nonce) {
+        uint64_t now = nowMs();
+        if (nonce <= now - 2ull * 86400000 || nonce >= now + 86400000ull)
+            return "Invalid nonce: nonce out of range";
+        if (nonces_.count(nonce)) return "Invalid nonce: duplicate nonce";
+        if (nonces_.size() >= 100 && nonce < *nonces_.begin()) return "Invalid nonce: nonce too low";
+        nonces_.insert(nonce);
+        if (nonces_.size() > 100) nonces_.erase(nonces_.begin());
+        return nullptr;
+    }
+
+    static msgpack::BracketOrderWire readWire(yyjson_val* w) {
+        msgpack::BracketOrderWire o;
+        o.asset = (int)yyjson_get_sint(yyjson_obj_get(w, "a"));
+        o.isBuy = yyjson_get_bool(yyjson_obj_get(w, "b"));
+        const char* p = yyjson_get_str(yyjson_obj_get(w, "p"));
+        const char* s = yyjson_get_str(yyjson_obj_get(w, "s"));
+        const char* c = yyjson_get_str(yyjson_obj_get(w, "c"));
+        o.price = p ? p : "";
+        o.size = s ? s : "";
+        o.cloid = c ? c : "";
+        o.reduceOnly = yyjson_get_bool(yyjson_obj_get(w, "r"));
+        yyjson_val* t = yyjson_obj_get(w, "t");
+        yyjson_val* trig = yyjson_obj_get(t, "trigger");
+        o.isTrigger = trig != nullptr;
+        o.triggerIsMarket = trig ? yyjson_get_bool(yyjson_obj_get(trig, "isMarket")) : true;
+        const char* tpx = trig ? yyjson_get_str(yyjson_obj_get(trig, "triggerPx")) : nullptr;
+        const char* tpsl = trig ? yyjson_get_str(yyjson_obj_get(trig, "tpsl")) : nullptr;
+        o.triggerPx = tpx ? tpx : "";
+        o.tpsl = tpsl ? tpsl : "";
+        const char* tif = yyjson_get_str(yyjson_obj_get(yyjson_obj_get(t, "limit"), "tif"));
+        o.tif = tif ? tif : "";
+        return o;
+    }
+
+    /// Rebuilds the EIP-712 hash the client must have signed; empty if the
+    /// action shape is not one the plugin sends
+    eip712::ByteArray signingHash(yyjson_val* action, const char* type, uint64_t nonce,
+                                  const std::string& vault) const {
+        bool mainnet = cfg_.isMainnet;
+        if (!strcmp(type, "order")) {
+            std::vector<msgpack::BracketOrderWire> wires;
+            size_t i, n;
+            yyjson_val* w;
+            yyjson_arr_foreach(yyjson_obj_get(action, "orders"), i, n, w) wires.push_back(readWire(w));
+            const char* grouping = yyjson_get_str(yyjson_obj_get(action, "grouping"));
+            return eip712::hashBatchModifyForSigning(
+                msgpack::packBracketOrderAction(wires, grouping ? grouping : "na"), mainnet, nonce, vault);
+        }
+        if (!strcmp(type, "cancel")) {
+            yyjson_val* cancels = yyjson_obj_get(action, "cancels");
+            if (yyjson_arr_size(cancels) != 1) return eip712::ByteArray();
+            yyjson_val* c = yyjson_arr_get_first(cancels);
+            eip712::CancelAction ca;
+            ca.asset = (int)yyjson_get_sint(yyjson_obj_get(c, "a"));
+            ca.orderId = (uint64_t)yyjson_get_uint(yyjson_obj_get(c, "o"));
+            return eip712::hashCancelForSigning(ca, mainnet, nonce, vault);
+        }
+        if (!strcmp(type, "batchModify")) {
+            yyjson_val* mods = yyjson_obj_get(action, "modifies");
+            if (yyjson_arr_size(mods) != 1) return eip712::ByteArray();
+            yyjson_val* m = yyjson_arr_get_first(mods);
+            yyjson_val* oid = yyjson_obj_get(m, "oid");
+            msgpack::BracketOrderWire o = readWire(yyjson_obj_get(m, "order"));
+            if (o.isTrigger) return eip712::ByteArray();
+            return eip712::hashBatchModifyForSigning(
+                msgpack::packBatchModifyAction(yyjson_is_int(oid) ? (uint64_t)yyjson_get_uint(oid) : 0,
+                                               yyjson_is_str(oid) ? yyjson_get_str(oid) : "",
+                                               yyjson_is_str(oid), o.asset, o.isBuy, o.price, o.size,
+                                               o.reduceOnly, o.tif, o.cloid),
+                mainnet, nonce, vault);
+        }
+        if (!strcmp(type, "scheduleCancel")) {
+            yyjson_val* t = yyjson_obj_get(action, "time");
+            return eip712::hashScheduleCancelForSigning(t ? (uint64_t)yyjson_get_uint(t) : 0,
+                                                        mainnet, nonce, vault);
+        }
+        return eip712::ByteArray();
+    }
+
+    //-------------------------------------------------------------------------
+    // /exchange dispatch
+    //-------------------------------------------------------------------------
+
+    static MockReply err(const std::string& msg) {
+        std::string escaped;
+        for (char ch : msg) {
+            if (ch == '"' || ch == '\\') escaped += '\\';
+            escaped += ch;
+        }
+        return { 200, "{\"status\":\"err\",\"response\":\"" + escaped + "\"}" };
+    }
+
+    MockReply exchangeLocked(const std::string& body, Events& ev) {
+        yyjson_doc* doc = yyjson_read(body.c_str(), body.size(), 0);
+        if (!doc) return { 422, "Failed to deserialize the JSON body into the target type" };
+        struct DocGuard { yyjson_doc* d; ~DocGuard() { yyjson_doc_free(d); } } guard = { doc };
+        yyjson_val* root = yyjson_doc_get_root(doc);
+        yyjson_val* action = yyjson_obj_get(root, "action");
+        const char* type = yyjson_get_str(yyjson_obj_get(action, "type"));
+        yyjson_val* nonceVal = yyjson_obj_get(root, "nonce");
+        yyjson_val* sigVal = yyjson_obj_get(root, "signature");
+        if (!type || !yyjson_is_int(nonceVal) || !yyjson_is_obj(sigVal))
+            return { 422, "Failed to deserialize the JSON body into the target type" };
+        uint64_t nonce = yyjson_get_uint(nonceVal);
+        const char* vaultStr = yyjson_get_str(yyjson_obj_get(root, "vaultAddress"));
+        std::string vault = vaultStr ? vaultStr : "";
+
+        if (cfg_.verifySignatures) {
+            eip712::ByteArray hash = signingHash(action, type, nonce, vault);
+            if (hash.size() != 32) {
+                stats_.badSignatures++;
+                return err(std::string("Mock exchange cannot verify action: ") + type);
+            }
+            crypto::Signature sig;
+            const char* r = yyjson_get_str(yyjson_obj_get(sigVal, "r"));
+            const char* s = yyjson_get_str(yyjson_obj_get(sigVal, "s"));
+            snprintf(sig.r, sizeof(sig.r), "%s", r ? r : "");
+            snprintf(sig.s, sizeof(sig.s), "%s", s ? s : "");
+            sig.v = (int)yyjson_get_int(yyjson_obj_get(sigVal, "v"));
+            char signer[64] = {0};
+            if (!crypto::recoverAddress(hash.data(), sig, signer, sizeof(signer))) {
+                stats_.badSignatures++;
+                return err("Invalid signature");
+            }
+            if (!cfg_.signer.empty() && !sameAddress(cfg_.signer, signer)) {
+                // What the exchange says for a signature by any other key
+                stats_.badSignatures++;
+                return err(std::string("User or API Wallet ") + signer + " does not exist.");
+            }
+        }
+        if (const char* bad = checkNonce(nonce)) {
+            stats_.badNonces++;
+            return err(bad);
+        }
+
+        std::string statuses;
+        if (!strcmp(type, "order")) {
+            size_t i, n;
+            yyjson_val* w;
+            yyjson_arr_foreach(yyjson_obj_get(action, "orders"), i, n, w) {
+                statuses += (i ? "," : "") + placeLocked(w, ev);
+            }
+        } else if (!strcmp(type, "cancel")) {
+            size_t i, n;
+            yyjson_val* c;
+            yyjson_arr_foreach(yyjson_obj_get(action, "cancels"), i, n, c) {
+                auto it = orders_.find((uint64_t)yyjson_get_uint(yyjson_obj_get(c, "o")));
+                int a = (int)yyjson_get_sint(yyjson_obj_get(c, "a"));
+                if (it != orders_.end() && it->second.asset == a && it->second.status == "open") {
+                    cancelLocked(it->second, "canceled", ev);
+                    statuses += i ? ",\"success\"" : "\"success\"";
+                } else {
+                    statuses += format("%s{\"error\":\"Order was never placed, already canceled, "
+                                       "or filled. asset=%d\"}", i ? "," : "", a);
+                }
+            }
+        } else if (!strcmp(type, "batchModify")) {
+            size_t i, n;
+            yyjson_val* m;
+            yyjson_arr_foreach(yyjson_obj_get(action, "modifies"), i, n, m) {
+                const Order* old = findOrder(yyjson_obj_get(m, "oid"));
+                if (!old || old->status != "open") {
+                    statuses += format("%s{\"error\":\"Cannot modify canceled or filled order\"}",
+                                       i ? "," : "");
+                    continue;
+                }
+                cancelLocked(orders_[old->oid], "canceled", ev);
+                statuses += (i ? "," : "") + placeLocked(yyjson_obj_get(m, "order"), ev);
+            }
+        } else if (!strcmp(type, "scheduleCancel")) {
+            yyjson_val* t = yyjson_obj_get(action, "time");
+            scheduleCancelMs_ = t ? (uint64_t)yyjson_get_uint(t) : 0;
+            return { 200, "{\"status\":\"ok\",\"response\":{\"type\":\"default\"}}" };
+        } else {
+            return err(std::string("Unsupported action type: ") + type);
+        }
+        return { 200, format("{\"status\":\"ok\",\"response\":{\"type\":\"%s\",\"data\":{\"statuses\":[",
+                             type) + statuses + "]}}}" };
+    }
+
+    /// oid as number, numeric string or cloid
+    const Order* findOrder(yyjson_val* id) const {
+        if (yyjson_is_int(id)) {
+            auto it = orders_.find((uint64_t)yyjson_get_uint(id));
+            return it != orders_.end() ? &it->second : nullptr;
+        }
+        const char* s = yyjson_get_str(id);
+        if (!s || !*s) return nullptr;
+        if (s[0] == '0' && (s[1] == 'x' || s[1] == 'X')) {
+            for (const auto& kv : orders_) {
+                if (sameAddress(kv.second.cloid, s)) return &kv.second;
+            }
+            return nullptr;
+        }
+        auto it = orders_.find(strtoull(s, nullptr, 10));
+        return it != orders_.end() ? &it->second : nullptr;
+    }
+};
+
+} // namespace test
+} // namespace hl
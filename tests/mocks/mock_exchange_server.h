@@ -0,0 +1,384 @@
+//=============================================================================
+// mock_exchange_server.h - MockExchange behind local WS and HTTP sockets
+//=============================================================================
+// Part of Hyperliquid Plugin for Zorro
+//
+// LAYER: Test Infrastructure
+// PURPOSE: Serves a MockExchange (mock_exchange.h) the way the real endpoint
+//          is reached, so WebSocketManager and hl_http run unmodified:
+//          - HTTP  POST /info, POST /exchange (ix::HttpServer)
+//          - WS    subscribe (l2Book, activeAssetCtx, orderUpdates, userFills,
+//                  clearinghouseState, openOrders), post (action / info),
+//                  ping -> pong (ix::WebSocketServer)
+//          A pusher thread steps the mids and publishes l2Book at bookHz and
+//          clearinghouseState/openOrders at accountHz; order events go out
+//          as they happen.
+//          Faults: HTTP 429s, slow HTTP replies, /exchange replies lost after
+//          the action was applied (client sees a 502 and must query), dropped
+//          WS acks/post responses, periodic disconnect of every WS client.
+//
+// USAGE:
+//   hl::test::MockExchangeServer server(cfg, 18765, 18766);
+//   server.faults().http429Rate = 0.05;
+//   server.start();
+//   g_config.baseUrl = server.httpUrl();           // "http://127.0.0.1:18766"
+//   mgr.setEndpoint(server.wsHost(), false);       // "127.0.0.1:18765"
+//=============================================================================
+
+#pragma once
+
+#include "mock_exchange.h"
+#include <IXHttpServer.h>
+#include <IXWebSocketServer.h>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+
+namespace hl {
+namespace test {
+
+struct MockFaults {
+    double http429Rate = 0.0;       // Share of HTTP requests answered 429
+    int slowMs = 0;                 // Delay added to HTTP replies...
+    double slowRate = 1.0;          // ...on this share of them
+    double lostReplyRate = 0.0;     // /exchange applied, reply replaced by a 502
+    double dropAckRate = 0.0;       // WS subscriptionResponse / post reply not sent
+    int disconnectEveryMs = 0;      // Close every WS client on this period (0 = off)
+};
+
+struct MockServerStats {
+    long long httpRequests = 0;
+    long long http429 = 0;
+    long long httpSlowed = 0;
+    long long lostReplies = 0;
+    long long wsConnections = 0;
+    long long wsFramesIn = 0;
+    long long wsFramesOut = 0;
+    long long droppedAcks = 0;
+    long long disconnects = 0;      // Forced disconnect rounds
+};
+
+class MockExchangeServer {
+public:
+    MockExchangeServer(const MockExchangeConfig& cfg, int wsPort, int httpPort)
+        : exchange_(cfg), wsPort_(wsPort), httpPort_(httpPort),
+          ws_(wsPort, "127.0.0.1"), http_(httpPort, "127.0.0.1"),
+          rng_(cfg.seed + 1), bookHz_(10.0), accountHz_(1.0), running_(false) {
+        ws_.disablePerMessageDeflate();
+        ws_.setOnClientMessageCallback(
+            [this](std::shared_ptr<ix::ConnectionState>, ix::WebSocket& ws,
+                   const ix::WebSocketMessagePtr& msg) {
+                onWsMessage(ws, msg);
+            });
+        http_.setOnConnectionCallback(
+            [this](ix::HttpRequestPtr req, std::shared_ptr<ix::ConnectionState>) {
+                return onHttp(req);
+            });
+        exchange_.setEventSink([this](const char* channel, const std::string& frame) {
+            publishUser(channel, frame);
+        });
+    }
+
+    ~MockExchangeServer() { stop(); }
+
+    MockExchange& exchange() { return exchange_; }
+    /// Set before start() or between runs; read by the socket threads
+    MockFaults& faults() { return faults_; }
+
+    /// Publication rates of the pusher thread (0 = off)
+    void setRates(double bookHz, double accountHz) { bookHz_ = bookHz; accountHz_ = accountHz; }
+
+    bool start() {
+        auto res = ws_.listen();
+        if (!res.first) {
+            printf("    [MockExchange] WS listen failed: %s\n", res.second.c_str());
+            return false;
+        }
+        res = http_.listen();
+        if (!res.first) {
+            printf("    [MockExchange] HTTP listen failed: %s\n", res.second.c_str());
+            return false;
+        }
+        ws_.start();
+        http_.start();
+        running_ = true;
+        pusher_ = std::thread([this]() { pushLoop(); });
+        return true;
+    }
+
+    void stop() {
+        if (!running_.exchange(false)) return;
+        if (pusher_.joinable()) pusher_.join();
+        http_.stop();
+        ws_.stop();
+    }
+
+    std::string wsHost() const { return "127.0.0.1:" + std::to_string(wsPort_); }
+    std::string httpUrl() const { return "http://127.0.0.1:" + std::to_string(httpPort_); }
+
+    MockServerStats stats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stats_;
+    }
+
+    int openConnections() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return (int)clients_.size();
+    }
+
+    /// Close every WS client now (reconnect storm on demand)
+    void dropAll() {
+        for (auto& client : ws_.getClients()) client->close();
+    }
+
+private:
+    struct ClientSubs {
+        std::set<std::string> books;
+        std::set<std::string> ctxs;
+        std::set<std::string> user;     // orderUpdates, userFills, clearinghouseState, openOrders
+    };
+
+    MockExchange exchange_;
+    MockFaults faults_;
+    int wsPort_;
+    int httpPort_;
+    ix::WebSocketServer ws_;
+    ix::HttpServer http_;
+    std::mt19937 rng_;
+    double bookHz_;
+    double accountHz_;
+    std::atomic<bool> running_;
+    std::thread pusher_;
+
+    mutable std::mutex mutex_;      // clients_, stats_, rng_
+    std::map<ix::WebSocket*, ClientSubs> clients_;
+    MockServerStats stats_;
+
+    /// True with probability p
+    bool roll(double p) {
+        if (p <= 0.0) return false;
+        std::lock_guard<std::mutex> lock(mutex_);
+        return std::uniform_real_distribution<double>(0.0, 1.0)(rng_) < p;
+    }
+
+    void count(long long MockServerStats::*field, long long n = 1) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.*field += n;
+    }
+
+    void send(ix::WebSocket& ws, const std::string& frame) {
+        ws.sendText(frame);
+        count(&MockServerStats::wsFramesOut);
+    }
+
+    //-------------------------------------------------------------------------
+    // HTTP
+    //-------------------------------------------------------------------------
+
+    ix::HttpResponsePtr reply(int status, const char* text, const std::string& body) {
+        ix::WebSocketHttpHeaders headers;
+        headers["Content-Type"] = "application/json";
+        return std::make_shared<ix::HttpResponse>(status, text, ix::HttpErrorCode::Ok, headers, body);
+    }
+
+    ix::HttpResponsePtr onHttp(ix::HttpRequestPtr req) {
+        count(&MockServerStats::httpRequests);
+        if (faults_.slowMs > 0 && roll(faults_.slowRate)) {
+            count(&MockServerStats::httpSlowed);
+            std::this_thread::sleep_for(std::chrono::milliseconds(faults_.slowMs));
+        }
+        if (roll(faults_.http429Rate)) {
+            count(&MockServerStats::http429);
+            return reply(429, "Too Many Requests", "null");
+        }
+        if (req->method != "POST") return reply(405, "Method Not Allowed", "");
+
+        MockReply r;
+        if (req->uri == "/info") {
+            r = exchange_.info(req->body);
+        } else if (req->uri == "/exchange") {
+            r = exchange_.exchange(req->body);
+            if (roll(faults_.lostReplyRate)) {
+                count(&MockServerStats::lostReplies);
+                return reply(502, "Bad Gateway", "");
+            }
+        } else {
+            return reply(404, "Not Found", "");
+        }
+        return reply(r.status, r.status == 200 ? "OK" : "Unprocessable Entity", r.body);
+    }
+
+    //-------------------------------------------------------------------------
+    // WebSocket
+    //-------------------------------------------------------------------------
+
+    void onWsMessage(ix::WebSocket& ws, const ix::WebSocketMessagePtr& msg) {
+        if (msg->type == ix::WebSocketMessageType::Open) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            clients_[&ws];
+            stats_.wsConnections++;
+            return;
+        }
+        if (msg->type == ix::WebSocketMessageType::Close) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            clients_.erase(&ws);
+            return;
+        }
+        if (msg->type != ix::WebSocketMessageType::Message) return;
+        count(&MockServerStats::wsFramesIn);
+
+        yyjson_doc* doc = yyjson_read(msg->str.c_str(), msg->str.size(), 0);
+        if (!doc) return;
+        yyjson_val* root = yyjson_doc_get_root(doc);
+        const char* method = yyjson_get_str(yyjson_obj_get(root, "method"));
+        if (method && !strcmp(method, "ping")) {
+            send(ws, "{\"channel\":\"pong\"}");
+        } else if (method && !strcmp(method, "subscribe")) {
+            onSubscribe(ws, yyjson_obj_get(root, "subscription"));
+        } else if (method && !strcmp(method, "post")) {
+            onPost(ws, yyjson_get_int(yyjson_obj_get(root, "id")), yyjson_obj_get(root, "request"));
+        }
+        yyjson_doc_free(doc);
+    }
+
+    void onSubscribe(ix::WebSocket& ws, yyjson_val* sub) {
+        const char* type = yyjson_get_str(yyjson_obj_get(sub, "type"));
+        const char* coin = yyjson_get_str(yyjson_obj_get(sub, "coin"));
+        if (!type) return;
+        std::string key = type;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = clients_.find(&ws);
+            if (it == clients_.end()) return;
+            if (key == "l2Book" && coin) it->second.books.insert(coin);
+            else if (key == "activeAssetCtx" && coin) it->second.ctxs.insert(coin);
+            else it->second.user.insert(key);
+        }
+        if (roll(faults_.dropAckRate)) {
+            count(&MockServerStats::droppedAcks);
+        } else {
+            char* subJson = yyjson_val_write(sub, 0, nullptr);
+            send(ws, std::string("{\"channel\":\"subscriptionResponse\",\"data\":{\"method\":"
+                                 "\"subscribe\",\"subscription\":") + (subJson ? subJson : "{}") + "}}");
+            free(subJson);
+        }
+        // Initial snapshot, as the real server sends after the ack
+        std::string snap;
+        if (key == "l2Book" && coin) snap = exchange_.l2BookFrame(coin);
+        else if (key == "activeAssetCtx" && coin) snap = exchange_.assetCtxFrame(coin);
+        else if (key == "clearinghouseState") snap = exchange_.clearinghouseFrame();
+        else if (key == "openOrders") snap = exchange_.openOrdersFrame();
+        else if (key == "userFills") snap = exchange_.userFillsSnapshotFrame();
+        if (!snap.empty()) send(ws, snap);
+    }
+
+    /// {"type":"action"|"info","payload":{...}}; a bare signed action (what
+    /// WebSocketManager::sendOrderSync posts) counts as an action
+    void onPost(ix::WebSocket& ws, int64_t id, yyjson_val* request) {
+        const char* type = yyjson_get_str(yyjson_obj_get(request, "type"));
+        yyjson_val* payload = yyjson_obj_get(request, "payload");
+        bool isInfo = type && !strcmp(type, "info");
+        if (!payload) payload = request;
+        char* body = yyjson_val_write(payload, 0, nullptr);
+        MockReply r = isInfo ? exchange_.info(body ? body : "") : exchange_.exchange(body ? body : "");
+        free(body);
+        if (roll(faults_.dropAckRate)) {
+            count(&MockServerStats::droppedAcks);
+            return;
+        }
+        char head[96];
+        snprintf(head, sizeof(head), "{\"channel\":\"post\",\"data\":{\"id\":%lld,\"response\":",
+                 (long long)id);
+        if (r.status != 200) {
+            send(ws, std::string(head) + "{\"type\":\"error\",\"payload\":\"" + r.body + "\"}}}");
+        } else {
+            send(ws, std::string(head) + "{\"type\":\"" + (isInfo ? "info" : "action") +
+                     "\",\"payload\":" + r.body + "}}}");
+        }
+    }
+
+    /// Order events from the engine to clients subscribed to that channel
+    void publishUser(const char* channel, const std::string& frame) {
+        std::vector<ix::WebSocket*> targets;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (auto& kv : clients_) {
+                if (kv.second.user.count(channel)) targets.push_back(kv.first);
+            }
+        }
+        sendTo(targets, frame);
+    }
+
+    /// Sends only to sockets the server still holds (a client may have closed)
+    void sendTo(const std::vector<ix::WebSocket*>& targets, const std::string& frame) {
+        if (targets.empty()) return;
+        for (auto& client : ws_.getClients()) {
+            for (ix::WebSocket* t : targets) {
+                if (client.get() == t) send(*client, frame);
+            }
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    // Pusher thread
+    //-------------------------------------------------------------------------
+
+    void pushLoop() {
+        typedef std::chrono::steady_clock Clock;
+        auto nextBook = Clock::now(), nextAccount = Clock::now(), nextDrop = Clock::now();
+        if (faults_.disconnectEveryMs > 0)
+            nextDrop += std::chrono::milliseconds(faults_.disconnectEveryMs);
+        while (running_) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            auto now = Clock::now();
+            if (bookHz_ > 0 && now >= nextBook) {
+                nextBook = now + std::chrono::microseconds((long long)(1e6 / bookHz_));
+                exchange_.tick();
+                pushMarket();
+            }
+            if (accountHz_ > 0 && now >= nextAccount) {
+                nextAccount = now + std::chrono::microseconds((long long)(1e6 / accountHz_));
+                pushAccount();
+            }
+            if (faults_.disconnectEveryMs > 0 && now >= nextDrop) {
+                nextDrop = now + std::chrono::milliseconds(faults_.disconnectEveryMs);
+                count(&MockServerStats::disconnects);
+                dropAll();
+            }
+        }
+    }
+
+    void pushMarket() {
+        std::map<std::string, std::vector<ix::WebSocket*>> books, ctxs;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (auto& kv : clients_) {
+                for (const std::string& c : kv.second.books) books[c].push_back(kv.first);
+                for (const std::string& c : kv.second.ctxs) ctxs[c].push_back(kv.first);
+            }
+        }
+        for (auto& kv : books) sendTo(kv.second, exchange_.l2BookFrame(kv.first));
+        for (auto& kv : ctxs) sendTo(kv.second, exchange_.assetCtxFrame(kv.first));
+    }
+
+    void pushAccount() {
+        std::vector<ix::WebSocket*> clearing, open;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (auto& kv : clients_) {
+                if (kv.second.user.count("clearinghouseState")) clearing.push_back(kv.first);
+                if (kv.second.user.count("openOrders")) open.push_back(kv.first);
+            }
+        }
+        if (!clearing.empty()) sendTo(clearing, exchange_.clearinghouseFrame());
+        if (!open.empty()) sendTo(open, exchange_.openOrdersFrame());
+    }
+};
+
+} // namespace test
+} // namespace hl
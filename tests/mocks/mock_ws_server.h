@@ -0,0 +1,246 @@
+//=============================================================================
+// mock_ws_server.h - Local Hyperliquid-style WebSocket server for tests
+//=============================================================================
+// Part of Hyperliquid Plugin for Zorro
+//
+// LAYER: Test Infrastructure
+// PURPOSE: Minimal in-process WS server (IXWebSocket) that speaks enough of
+//          the Hyperliquid protocol to drive WebSocketManager offline:
+//          - subscribe l2Book  -> subscriptionResponse + one book snapshot
+//          - subscribe <other> -> subscriptionResponse
+//          - ping              -> pong
+//          Tracks connections and per-coin subscribe counts, and can drop
+//          every client to exercise reconnect paths. setBurstLimit() makes
+//          it close clients that subscribe faster than a real server allows.
+//
+// USAGE:
+//   hl::test::MockWsServer server(18765);
+//   if (!server.start()) { ... }
+//   mgr.setEndpoint(server.host(), false);   // "127.0.0.1:18765", ws://
+//   ...
+//   server.broadcastL2Book("BTC", 100.0, 101.0);
+//   server.stop();
+//=============================================================================
+
+#pragma once
+
+#include <IXWebSocketServer.h>
+#include <yyjson.h>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace hl {
+namespace test {
+
+class MockWsServer {
+public:
+    explicit MockWsServer(int port)
+        : port_(port), server_(port, "127.0.0.1"),
+          openConnections_(0), totalConnections_(0), totalSubscribes_(0),
+          burstRejections_(0) {
+        server_.disablePerMessageDeflate();
+        server_.setOnClientMessageCallback(
+            [this](std::shared_ptr<ix::ConnectionState>, ix::WebSocket& ws,
+                   const ix::WebSocketMessagePtr& msg) {
+                onMessage(ws, msg);
+            });
+    }
+
+    ~MockWsServer() { stop(); }
+
+    bool start() {
+        auto res = server_.listen();
+        if (!res.first) {
+            printf("    [MockWS] listen failed: %s\n", res.second.c_str());
+            return false;
+        }
+        server_.start();
+        started_ = true;
+        return true;
+    }
+
+    void stop() {
+        if (!started_) return;
+        started_ = false;
+        server_.stop();
+    }
+
+    /// Host string for Connection::connect (ws://, no TLS)
+    std::string host() const { return "127.0.0.1:" + std::to_string(port_); }
+
+    int openConnections() const { return openConnections_.load(); }
+    int totalConnections() const { return totalConnections_.load(); }
+    int totalSubscribes() const { return totalSubscribes_.load(); }
+
+    /// How many times a coin's l2Book was subscribed (across all clients)
+    int subscribeCount(const std::string& coin) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = subscribeCounts_.find(coin);
+        return it != subscribeCounts_.end() ? it->second : 0;
+    }
+
+    /// Number of distinct clients that have subscribed l2Book for any coin
+    int clientsWithL2Subs() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        int n = 0;
+        for (const auto& kv : clientCoins_) if (!kv.second.empty()) n++;
+        return n;
+    }
+
+    /// Push an l2Book update to every client subscribed to coin
+    /// @param timeMs Exchange timestamp in the frame (drives standby dedup)
+    void broadcastL2Book(const std::string& coin, double bid, double ask,
+                         long long timeMs = 0) {
+        std::string frame = l2BookFrame(coin, bid, ask, timeMs);
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& kv : clientCoins_) {
+            if (kv.second.count(coin)) kv.first->sendText(frame);
+        }
+    }
+
+    /// Close every client socket (clients with auto-reconnect will return)
+    void dropAll() {
+        for (auto& client : server_.getClients()) client->close();
+    }
+
+    /// Price used for the initial snapshot sent on subscribe
+    void setSnapshotPrice(double bid, double ask) { snapBid_ = bid; snapAsk_ = ask; }
+
+    /// Close any client that sends more than maxSubs subscribe frames within
+    /// windowMs (0 = unlimited). The offending subscribe is not acked.
+    void setBurstLimit(int maxSubs, int windowMs) { burstMax_ = maxSubs; burstWindowMs_ = windowMs; }
+    int burstRejections() const { return burstRejections_.load(); }
+
+    /// l2Book coins in the order their subscribes were accepted
+    std::vector<std::string> subscribeLog() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return subscribeLog_;
+    }
+    void clearSubscribeLog() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        subscribeLog_.clear();
+    }
+
+    /// Distinct l2Book coins acked across all currently connected clients
+    int ackedL2Coins() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::set<std::string> all;
+        for (const auto& kv : clientCoins_) all.insert(kv.second.begin(), kv.second.end());
+        return (int)all.size();
+    }
+
+private:
+    int port_;
+    ix::WebSocketServer server_;
+    bool started_ = false;
+    double snapBid_ = 100.0;
+    double snapAsk_ = 100.5;
+    int burstMax_ = 0;
+    int burstWindowMs_ = 0;
+
+    std::atomic<int> openConnections_;
+    std::atomic<int> totalConnections_;
+    std::atomic<int> totalSubscribes_;
+    std::atomic<int> burstRejections_;
+
+    mutable std::mutex mutex_;
+    std::map<std::string, int> subscribeCounts_;
+    std::vector<std::string> subscribeLog_;
+    std::map<ix::WebSocket*, std::set<std::string>> clientCoins_;
+    std::map<ix::WebSocket*, std::deque<std::chrono::steady_clock::time_point>> clientSubTimes_;
+
+    /// Record a subscribe frame; false if the client exceeded the burst limit
+    bool admitSubscribe(ix::WebSocket& ws) {
+        if (burstMax_ <= 0) return true;
+        auto now = std::chrono::steady_clock::now();
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto& times = clientSubTimes_[&ws];
+        while (!times.empty() &&
+               now - times.front() >= std::chrono::milliseconds(burstWindowMs_))
+            times.pop_front();
+        times.push_back(now);
+        return (int)times.size() <= burstMax_;
+    }
+
+    static std::string l2BookFrame(const std::string& coin, double bid, double ask,
+                                   long long timeMs = 0) {
+        char buf[512];
+        snprintf(buf, sizeof(buf),
+                 "{\"channel\":\"l2Book\",\"data\":{\"coin\":\"%s\",\"time\":%lld,"
+                 "\"levels\":[[{\"px\":\"%.6f\",\"sz\":\"1.0\",\"n\":1}],"
+                 "[{\"px\":\"%.6f\",\"sz\":\"1.0\",\"n\":1}]]}}",
+                 coin.c_str(), timeMs, bid, ask);
+        return buf;
+    }
+
+    void onMessage(ix::WebSocket& ws, const ix::WebSocketMessagePtr& msg) {
+        if (msg->type == ix::WebSocketMessageType::Open) {
+            openConnections_++;
+            totalConnections_++;
+            std::lock_guard<std::mutex> lock(mutex_);
+            clientCoins_[&ws];
+            return;
+        }
+        if (msg->type == ix::WebSocketMessageType::Close) {
+            openConnections_--;
+            std::lock_guard<std::mutex> lock(mutex_);
+            clientCoins_.erase(&ws);
+            clientSubTimes_.erase(&ws);
+            return;
+        }
+        if (msg->type != ix::WebSocketMessageType::Message) return;
+
+        yyjson_doc* doc = yyjson_read(msg->str.c_str(), msg->str.size(), 0);
+        if (!doc) return;
+        yyjson_val* root = yyjson_doc_get_root(doc);
+        const char* method = yyjson_get_str(yyjson_obj_get(root, "method"));
+
+        if (method && strcmp(method, "ping") == 0) {
+            ws.sendText("{\"channel\":\"pong\"}");
+        } else if (method && strcmp(method, "subscribe") == 0) {
+            totalSubscribes_++;
+            if (!admitSubscribe(ws)) {
+                // Real server behaviour under a subscribe flood: drop the client
+                burstRejections_++;
+                yyjson_doc_free(doc);
+                ws.close();
+                return;
+            }
+            yyjson_val* sub = yyjson_obj_get(root, "subscription");
+            const char* type = yyjson_get_str(yyjson_obj_get(sub, "type"));
+            const char* coin = yyjson_get_str(yyjson_obj_get(sub, "coin"));
+
+            // Echo the subscription object back, as the real server does
+            std::string ack = "{\"channel\":\"subscriptionResponse\",\"data\":"
+                              "{\"method\":\"subscribe\",\"subscription\":";
+            char* subJson = sub ? yyjson_val_write(sub, 0, nullptr) : nullptr;
+            ack += subJson ? subJson : "{}";
+            free(subJson);
+            ack += "}}";
+            ws.sendText(ack);
+
+            if (type && coin && strcmp(type, "l2Book") == 0) {
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    subscribeCounts_[coin]++;
+                    subscribeLog_.push_back(coin);
+                    clientCoins_[&ws].insert(coin);
+                }
+                ws.sendText(l2BookFrame(coin, snapBid_, snapAsk_));
+            }
+        }
+        yyjson_doc_free(doc);
+    }
+};
+
+} // namespace test
+} // namespace hl
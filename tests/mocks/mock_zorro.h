@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <cstdarg>
 #include <cstdio>
 #include <cstring>
 #include <cstdint>
@@ -97,10 +98,12 @@ static int mock_nap(int ms) {
     return 1;
 }
 
+#ifdef _WIN32
 static int mock_wait(int ms) {
     // In tests, we don't actually wait
     return 1;
 }
+#endif
 
 //=============================================================================
 // LOGGING MOCKS
@@ -144,7 +147,9 @@ int (*http_status)(int) = mock_http_status;
 size_t (*http_result)(int, char*, size_t) = mock_http_result;
 int (*http_free)(int) = mock_http_free;
 int (*nap)(int) = mock_nap;
-int (*wait)(int) = mock_wait;
+#ifdef _WIN32
+int (*wait)(int) = mock_wait;        // POSIX libc owns wait()
+#endif
 
 // Note: print/msg have variable args, so we declare them differently
 // For most tests, the plugin's BrokerError/logInfo functions are mocked instead
@@ -160,7 +165,9 @@ extern int (*http_status)(int);
 extern size_t (*http_result)(int, char*, size_t);
 extern int (*http_free)(int);
 extern int (*nap)(int);
+#ifdef _WIN32
 extern int (*wait)(int);
+#endif
 
 #endif // MOCK_ZORRO_IMPLEMENTATION
 
@@ -0,0 +1,163 @@
+//=============================================================================
+// replay_capture.cpp - Feed a traffic capture through WebSocketManager
+//=============================================================================
+// Part of Hyperliquid Plugin for Zorro
+//
+// LAYER: Test (replay driver / benchmark)
+// PURPOSE: Replays a capture recorded with HL_SET_CAPTURE (hl_capture.h):
+//            WsRecv        -> WebSocketManager::replayMessage on the
+//                             recorded connection index
+//            HttpRequest/  -> served back through http::setResponder, so
+//            HttpResponse     code issuing requests gets the recorded answers;
+//                             anything else fails in the Zorro HTTP mock
+//            WsOpen/WsClose-> counted per connection (reconnect timeline)
+//
+// USAGE:   replay_capture <file.hlcap> [--realtime] [--bench] [--loops N]
+//            --realtime  keep the recorded pacing (default: as fast as possible)
+//            --bench     messages/s and dispatch latency (all frames, l2Book
+//                        frames) plus the Parse/CachePublish stage histograms
+//            --loops N   replay the frames N times (bench warm-up / longer runs)
+//
+// EXPECTED: Every record read back; with --bench, l2Book dispatch p50 in the
+//           low microseconds (parse + cache publish, no network).
+//
+// NETWORK: None
+//=============================================================================
+
+#include "hl_capture.h"
+#include "ws_manager.h"
+#include "ws_price_cache.h"
+#include "hl_latency.h"
+#define MOCK_ZORRO_IMPLEMENTATION
+#include "mocks/mock_zorro.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using namespace hl::capture;
+
+static HttpReplay s_http;
+
+static bool serveFromCapture(const char* method, const char* url, const char* body,
+                             hl::http::Response& out) {
+    return s_http.serve(method, url, body, out);
+}
+
+static double pct(std::vector<double>& v, double q) {
+    if (v.empty()) return 0.0;
+    size_t i = (size_t)(q * (double)(v.size() - 1) + 0.5);
+    return v[i];
+}
+
+static void printDist(const char* label, std::vector<double>& us) {
+    std::sort(us.begin(), us.end());
+    printf("%-14s n=%-8zu p50=%8.2fus p90=%8.2fus p99=%8.2fus max=%8.2fus\n", label, us.size(),
+           pct(us, 0.50), pct(us, 0.90), pct(us, 0.99), us.empty() ? 0.0 : us.back());
+}
+
+static bool isL2Book(const std::string& frame) {
+    return frame.find("\"channel\":\"l2Book\"") != std::string::npos;
+}
+
+int main(int argc, char** argv) {
+    const char* path = nullptr;
+    bool realtime = false, bench = false;
+    int loops = 1;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--realtime") == 0) realtime = true;
+        else if (strcmp(argv[i], "--bench") == 0) bench = true;
+        else if (strcmp(argv[i], "--loops") == 0 && i + 1 < argc) loops = (std::max)(1, atoi(argv[++i]));
+        else path = argv[i];
+    }
+    if (!path) {
+        printf("usage: replay_capture <file.hlcap> [--realtime] [--bench] [--loops N]\n");
+        return 2;
+    }
+
+    std::vector<Record> records;
+    if (!Reader::readAll(path, records)) {
+        printf("FAILED: %s is not a capture file\n", path);
+        return 1;
+    }
+
+    long long kinds[8] = {};
+    int opens[256] = {}, closes[256] = {};
+    for (const Record& r : records) {
+        if ((int)r.kind < 8) kinds[(int)r.kind]++;
+        if (r.kind == Kind::WsOpen) opens[r.channel]++;
+        if (r.kind == Kind::WsClose) closes[r.channel]++;
+    }
+    printf("=== Capture Replay ===\n%s: %zu records\n", path, records.size());
+    for (int k = (int)Kind::WsRecv; k <= (int)Kind::HttpResponse; k++)
+        printf("  %-13s %lld\n", kindName((Kind)k), kinds[k]);
+    for (int c = 0; c < 256; c++) {
+        if (opens[c] || closes[c])
+            printf("  WS[%d] opened %d, closed %d (reconnects %d)\n", c, opens[c], closes[c],
+                   opens[c] > 0 ? opens[c] - 1 : 0);
+    }
+
+    s_http.load(records);
+    hl::http::setResponder(&serveFromCapture);
+    hl::mock::resetMocks();
+    hl::mock::setHttpFailure(true);             // Offline: requests not in the capture fail
+
+    hl::ws::PriceCache cache;
+    hl::ws::WebSocketManager mgr(cache);
+    hl::lat::reset();
+
+    std::vector<double> allUs, l2Us;
+    if (bench) {
+        allUs.reserve((size_t)kinds[(int)Kind::WsRecv] * loops);
+        l2Us.reserve((size_t)kinds[(int)Kind::WsRecv] * loops);
+    }
+
+    long long frames = 0;
+    double busySec = 0.0;
+    auto wall0 = std::chrono::steady_clock::now();
+    for (int loop = 0; loop < loops; loop++) {
+        auto loopStart = std::chrono::steady_clock::now();
+        for (const Record& r : records) {
+            if (r.kind != Kind::WsRecv) continue;
+            if (realtime) {
+                auto due = loopStart + std::chrono::nanoseconds(r.tsNs);
+                std::this_thread::sleep_until(due);
+            }
+            auto t0 = std::chrono::steady_clock::now();
+            mgr.replayMessage(r.channel, r.data.c_str(), r.data.size());
+            double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+            busySec += us / 1e6;
+            frames++;
+            if (bench) {
+                allUs.push_back(us);
+                if (isL2Book(r.data)) l2Us.push_back(us);
+            }
+        }
+    }
+    double wallSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall0).count();
+    hl::http::setResponder(nullptr);
+
+    printf("\nreplayed %lld frames in %.3fs (%s)\n", frames, wallSec, realtime ? "recorded pacing" : "as fast as possible");
+    printf("HTTP replay: %d exchanges, %d served, %d not in capture\n",
+           s_http.size(), s_http.served(), s_http.missed());
+
+    if (bench) {
+        printf("\n%-14s %.0f msg/s (dispatch only), %.0f msg/s (wall)\n", "throughput",
+               busySec > 0 ? frames / busySec : 0.0, wallSec > 0 ? frames / wallSec : 0.0);
+        printDist("all frames", allUs);
+        printDist("l2Book frames", l2Us);
+
+        hl::lat::StageSummary rows[(int)hl::lat::Stage::Count];
+        hl::lat::summarize(rows, (int)hl::lat::Stage::Count);
+        const hl::lat::Stage stages[] = { hl::lat::Stage::Parse, hl::lat::Stage::CachePublish };
+        for (hl::lat::Stage s : stages) {
+            const hl::lat::StageSummary& row = rows[(int)s];
+            printf("%-14s n=%-8.0f p50=%8.2fus p90=%8.2fus p99=%8.2fus max=%8.2fus\n", row.name,
+                   row.count, row.p50Us, row.p90Us, row.p99Us, row.maxUs);
+        }
+    }
+    return 0;
+}
@@ -28,7 +28,7 @@ REM ============================================================================
 REM Test 1: PIP/PIPCost/LotAmount Formulas
 REM Prevents bugs: 6dfb104, 213643c, 8303e8b
 REM =============================================================================
-echo [1/21] Testing PIP/PIPCost/LotAmount formulas...
+echo [1/37] Testing PIP/PIPCost/LotAmount formulas...
 call compile_broker_asset_test.bat
 if !ERRORLEVEL! EQU 0 (
     set /a TESTS_PASSED+=1
@@ -43,7 +43,7 @@ REM ============================================================================
 REM Test 2: Multi-Asset Position Parsing
 REM Prevents bug: 81db4b6
 REM =============================================================================
-echo [2/21] Testing multi-asset position parsing...
+echo [2/37] Testing multi-asset position parsing...
 call compile_position_parsing_test.bat
 if !ERRORLEVEL! EQU 0 (
     set /a TESTS_PASSED+=1
@@ -58,7 +58,7 @@ REM ============================================================================
 REM Test 3: IMPORTED Trade Position Tracking
 REM Prevents bug: 18c287c
 REM =============================================================================
-echo [3/21] Testing IMPORTED trade position tracking...
+echo [3/37] Testing IMPORTED trade position tracking...
 call compile_imported_test.bat
 if !ERRORLEVEL! EQU 0 (
     set /a TESTS_PASSED+=1
@@ -73,7 +73,7 @@ REM ============================================================================
 REM Test 4: EIP-712 Mainnet vs Testnet Source
 REM Prevents bug: OPM-22 (e392a43)
 REM =============================================================================
-echo [4/21] Testing EIP-712 mainnet vs testnet source...
+echo [4/37] Testing EIP-712 mainnet vs testnet source...
 call compile_eip712_source_test.bat
 if !ERRORLEVEL! EQU 0 (
     set /a TESTS_PASSED+=1
@@ -87,7 +87,7 @@ echo.
 REM =============================================================================
 REM Test 5: Existing utils tests (if they exist)
 REM =============================================================================
-echo [5/21] Testing utility functions...
+echo [5/37] Testing utility functions...
 if exist compile_utils_test.bat (
     call compile_utils_test.bat >nul 2>&1
     if !ERRORLEVEL! EQU 0 (
@@ -106,7 +106,7 @@ REM ============================================================================
 REM Test 6: GET_PRICE Context Isolation [OPM-6]
 REM Prevents bug: OPM-6 (GET_PRICE returns wrong asset's price)
 REM =============================================================================
-echo [6/21] Testing GET_PRICE context isolation...
+echo [6/37] Testing GET_PRICE context isolation...
 call compile_get_price_context_test.bat
 if !ERRORLEVEL! EQU 0 (
     set /a TESTS_PASSED+=1
@@ -121,7 +121,7 @@ REM ============================================================================
 REM Test 7: Trigger Order Construction [OPM-77]
 REM Prevents bug: Silent STOP flag discard, incorrect trigger JSON
 REM =============================================================================
-echo [7/21] Testing trigger order construction...
+echo [7/37] Testing trigger order construction...
 call compile_trigger_order_test.bat
 if !ERRORLEVEL! EQU 0 (
     set /a TESTS_PASSED+=1
@@ -136,7 +136,7 @@ REM ============================================================================
 REM Test 8: Partial Fill Detection [OPM-91]
 REM Prevents bug: Missing PartialFill status, HTTP fallback guard
 REM =============================================================================
-echo [8/21] Testing partial fill detection...
+echo [8/37] Testing partial fill detection...
 call compile_partial_fill_test.bat
 if !ERRORLEVEL! EQU 0 (
     set /a TESTS_PASSED+=1
@@ -151,7 +151,7 @@ REM ============================================================================
 REM Test 9: lotSize Division-by-Zero Guard [OPM-158]
 REM Prevents bug: Division by zero when lotSize is 0 (uninitialized state)
 REM =============================================================================
-echo [9/21] Testing lotSize division-by-zero guard...
+echo [9/37] Testing lotSize division-by-zero guard...
 call compile_lotsize_divzero_test.bat
 if !ERRORLEVEL! EQU 0 (
     set /a TESTS_PASSED+=1
@@ -166,7 +166,7 @@ REM ============================================================================
 REM Test 10: WebSocket Parser Unit Tests [OPM-10]
 REM Tests all 6 ws_parsers.cpp functions with canned JSON fixtures
 REM =============================================================================
-echo [10/21] Testing WebSocket parsers...
+echo [10/37] Testing WebSocket parsers...
 call compile_ws_parsers_test.bat
 if !ERRORLEVEL! EQU 0 (
     set /a TESTS_PASSED+=1
@@ -181,7 +181,7 @@ REM ============================================================================
 REM Test 11: TWAP Order Construction [OPM-81]
 REM Prevents: Incorrect msgpack field ordering, wrong TWAP action types
 REM =============================================================================
-echo [11/21] Testing TWAP order construction...
+echo [11/37] Testing TWAP order construction...
 call compile_twap_test.bat
 if !ERRORLEVEL! EQU 0 (
     set /a TESTS_PASSED+=1
@@ -196,7 +196,7 @@ REM ============================================================================
 REM Test 12: scheduleCancel (Dead Man's Switch) [OPM-83]
 REM Prevents: Incorrect msgpack encoding, signature mismatch
 REM =============================================================================
-echo [12/21] Testing scheduleCancel signing...
+echo [12/37] Testing scheduleCancel signing...
 call compile_schedule_cancel_test.bat
 if !ERRORLEVEL! EQU 0 (
     set /a TESTS_PASSED+=1
@@ -211,7 +211,7 @@ REM ============================================================================
 REM Test 13: batchModify (Atomic Order Modify) [OPM-80]
 REM Prevents: Incorrect msgpack encoding, wrong oid type, field ordering
 REM =============================================================================
-echo [13/21] Testing batchModify encoding...
+echo [13/37] Testing batchModify encoding...
 call compile_batch_modify_test.bat
 if !ERRORLEVEL! EQU 0 (
     set /a TESTS_PASSED+=1
@@ -226,7 +226,7 @@ REM ============================================================================
 REM Test 14: Bracket Order Encoding [OPM-79]
 REM Prevents: Wrong grouping, missing orders, incorrect trigger fields
 REM =============================================================================
-echo [14/21] Testing bracket order encoding...
+echo [14/37] Testing bracket order encoding...
 call compile_bracket_order_test.bat
 if !ERRORLEVEL! EQU 0 (
     set /a TESTS_PASSED+=1
@@ -241,7 +241,7 @@ REM ============================================================================
 REM Test 15: Trading Service [OPM-9]
 REM Tests: CLOID gen/parse, trade ID, nonce, order storage, fill status
 REM =============================================================================
-echo [15/21] Testing trading service logic...
+echo [15/37] Testing trading service logic...
 call compile_trading_service_test.bat
 if !ERRORLEVEL! EQU 0 (
     set /a TESTS_PASSED+=1
@@ -256,7 +256,7 @@ REM ============================================================================
 REM Test 16: Account Service [OPM-9]
 REM Tests: PositionInfo, Balance, applyFill, Zorro account values
 REM =============================================================================
-echo [16/21] Testing account service logic...
+echo [16/37] Testing account service logic...
 call compile_account_service_test.bat
 if !ERRORLEVEL! EQU 0 (
     set /a TESTS_PASSED+=1
@@ -271,7 +271,7 @@ REM ============================================================================
 REM Test 17: Market Service [OPM-9]
 REM Tests: Candle intervals, HTTP seed cooldown
 REM =============================================================================
-echo [17/21] Testing market service logic...
+echo [17/37] Testing market service logic...
 call compile_market_service_test.bat
 if !ERRORLEVEL! EQU 0 (
     set /a TESTS_PASSED+=1
@@ -286,7 +286,7 @@ REM ============================================================================
 REM Test 18: Market Service HTTP Parsing [OPM-174]
 REM Tests: l2Book, candleSnapshot, metaAndAssetCtxs parsing
 REM =============================================================================
-echo [18/21] Testing market service HTTP parsing...
+echo [18/37] Testing market service HTTP parsing...
 call compile_market_service_http_test.bat
 if !ERRORLEVEL! EQU 0 (
     set /a TESTS_PASSED+=1
@@ -301,7 +301,7 @@ REM ============================================================================
 REM Test 19: Account Service HTTP Parsing [OPM-174]
 REM Tests: spotBalance, userRole, orderStatus parsing
 REM =============================================================================
-echo [19/21] Testing account service HTTP parsing...
+echo [19/37] Testing account service HTTP parsing...
 call compile_account_service_http_test.bat
 if !ERRORLEVEL! EQU 0 (
     set /a TESTS_PASSED+=1
@@ -316,7 +316,7 @@ REM ============================================================================
 REM Test 20: Account Service WS Cache Tests [OPM-175]
 REM Tests: getBalance, hasRealtimeBalance, getPosition with PriceCache
 REM =============================================================================
-echo [20/21] Testing account service WS cache interactions...
+echo [20/37] Testing account service WS cache interactions...
 call compile_account_service_ws_test.bat
 if !ERRORLEVEL! EQU 0 (
     set /a TESTS_PASSED+=1
@@ -331,7 +331,7 @@ REM ============================================================================
 REM Test 21: Market Service WS Cache Tests [OPM-175]
 REM Tests: getPrice WS reads, stale-data fallback, HTTP seed cooldown
 REM =============================================================================
-echo [21/21] Testing market service WS cache interactions...
+echo [21/37] Testing market service WS cache interactions...
 call compile_market_service_ws_test.bat
 if !ERRORLEVEL! EQU 0 (
     set /a TESTS_PASSED+=1
@@ -342,6 +342,202 @@ if !ERRORLEVEL! EQU 0 (
 )
 echo.
 
+REM =============================================================================
+REM Test 22: l2Book Subscription Scheduler
+REM Tests: pacing token bucket, priority order, ack tracking, unacked resend
+REM =============================================================================
+echo [22/37] Testing l2Book subscription scheduler...
+call compile_ws_sub_scheduler_test.bat
+if !ERRORLEVEL! EQU 0 (
+    set /a TESTS_PASSED+=1
+    echo       PASSED
+) else (
+    set /a TESTS_FAILED+=1
+    echo       FAILED - Subscription pacing/ack tracking broken!
+)
+echo.
+
+REM =============================================================================
+REM Test 23: WS Subscription Registry
+REM Tests: requested/sent/acked/live lifecycle, ack timeout, reconnect reset
+REM =============================================================================
+echo [23/37] Testing WS subscription registry...
+call compile_ws_sub_registry_test.bat
+if !ERRORLEVEL! EQU 0 (
+    set /a TESTS_PASSED+=1
+    echo       PASSED
+) else (
+    set /a TESTS_FAILED+=1
+    echo       FAILED - Subscription registry lifecycle broken!
+)
+echo.
+
+REM =============================================================================
+REM Test 24: WS Fill Aggregator
+REM Tests: tid dedup, VWAP, changed-only notify, order retirement
+REM =============================================================================
+echo [24/37] Testing WS fill aggregator...
+call compile_fill_aggregator_test.bat
+if !ERRORLEVEL! EQU 0 (
+    set /a TESTS_PASSED+=1
+    echo       PASSED
+) else (
+    set /a TESTS_FAILED+=1
+    echo       FAILED - Fill aggregation/dedup broken!
+)
+echo.
+
+REM =============================================================================
+REM Test 25: WS Fill Ring
+REM Tests: ring wrap-around, oid index under eviction, capacity resize
+REM =============================================================================
+echo [25/37] Testing WS fill ring...
+call compile_ws_fill_ring_test.bat
+if !ERRORLEVEL! EQU 0 (
+    set /a TESTS_PASSED+=1
+    echo       PASSED
+) else (
+    set /a TESTS_FAILED+=1
+    echo       FAILED - Fill store/oid index broken!
+)
+echo.
+
+REM =============================================================================
+REM Test 26: Order Sync
+REM Tests: order state machine, epoch-gated batched reconciliation, PENDING_ resolution
+REM =============================================================================
+echo [26/37] Testing order sync...
+call compile_order_sync_test.bat
+if !ERRORLEVEL! EQU 0 (
+    set /a TESTS_PASSED+=1
+    echo       PASSED
+) else (
+    set /a TESTS_FAILED+=1
+    echo       FAILED - Order state/reconciliation broken!
+)
+echo.
+
+echo [27/37] Testing BrokerTrade snapshot...
+call compile_trade_snapshot_test.bat
+if !ERRORLEVEL! EQU 0 (
+    set /a TESTS_PASSED+=1
+    echo       PASSED
+) else (
+    set /a TESTS_FAILED+=1
+    echo       FAILED - BrokerTrade per-tick snapshot broken!
+)
+echo.
+
+echo [28/37] Testing coin symbol table...
+call compile_symbols_test.bat
+if !ERRORLEVEL! EQU 0 (
+    set /a TESTS_PASSED+=1
+    echo       PASSED
+) else (
+    set /a TESTS_FAILED+=1
+    echo       FAILED - Coin intern table broken!
+)
+echo.
+
+echo [29/37] Testing JSON parse pool...
+call compile_json_pool_test.bat
+if !ERRORLEVEL! EQU 0 (
+    set /a TESTS_PASSED+=1
+    echo       PASSED
+) else (
+    set /a TESTS_FAILED+=1
+    echo       FAILED - Pooled yyjson parsing broken!
+)
+echo.
+
+echo [30/37] Testing decimal px/sz kernels...
+call compile_decimal_test.bat
+if !ERRORLEVEL! EQU 0 (
+    set /a TESTS_PASSED+=1
+    echo       PASSED
+) else (
+    set /a TESTS_FAILED+=1
+    echo       FAILED - Price/size string conversion broken!
+)
+echo.
+
+echo [31/37] Testing shared-memory price table...
+call compile_shared_prices_test.bat
+if !ERRORLEVEL! EQU 0 (
+    set /a TESTS_PASSED+=1
+    echo       PASSED
+) else (
+    set /a TESTS_FAILED+=1
+    echo       FAILED - Cross-process price sharing broken!
+)
+echo.
+
+echo [32/37] Testing deferred log ring...
+call compile_log_ring_test.bat
+if !ERRORLEVEL! EQU 0 (
+    set /a TESTS_PASSED+=1
+    echo       PASSED
+) else (
+    set /a TESTS_FAILED+=1
+    echo       FAILED - Deferred logging broken!
+)
+echo.
+
+echo [33/37] Testing GUI notification coalescing...
+call compile_gui_notifier_test.bat
+if !ERRORLEVEL! EQU 0 (
+    set /a TESTS_PASSED+=1
+    echo       PASSED
+) else (
+    set /a TESTS_FAILED+=1
+    echo       FAILED - GUI notifications broken!
+)
+echo.
+
+echo [34/37] Testing latency histograms...
+call compile_latency_test.bat
+if !ERRORLEVEL! EQU 0 (
+    set /a TESTS_PASSED+=1
+    echo       PASSED
+) else (
+    set /a TESTS_FAILED+=1
+    echo       FAILED - Latency stats broken!
+)
+echo.
+
+echo [35/37] Testing order trace...
+call compile_trace_test.bat
+if !ERRORLEVEL! EQU 0 (
+    set /a TESTS_PASSED+=1
+    echo       PASSED
+) else (
+    set /a TESTS_FAILED+=1
+    echo       FAILED - Order trace broken!
+)
+echo.
+
+echo [36/37] Testing traffic capture...
+call compile_capture_test.bat
+if !ERRORLEVEL! EQU 0 (
+    set /a TESTS_PASSED+=1
+    echo       PASSED
+) else (
+    set /a TESTS_FAILED+=1
+    echo       FAILED - Traffic capture broken!
+)
+echo.
+
+echo [37/37] Testing mock exchange...
+call compile_mock_exchange_test.bat
+if !ERRORLEVEL! EQU 0 (
+    set /a TESTS_PASSED+=1
+    echo       PASSED
+) else (
+    set /a TESTS_FAILED+=1
+    echo       FAILED - Mock exchange broken!
+)
+echo.
+
 REM =============================================================================
 REM SUMMARY
 REM =============================================================================
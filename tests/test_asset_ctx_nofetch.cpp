@@ -0,0 +1,137 @@
+//=============================================================================
+// test_asset_ctx_nofetch.cpp - BrokerAsset never fetches asset contexts
+//=============================================================================
+// Part of Hyperliquid Plugin for Zorro
+//
+// LAYER: Test
+// PURPOSE: BrokerAsset fills rollover and volume through
+//          market::peekAssetCtx on Zorro's thread. A missing or stale context
+//          must not turn into a blocking metaAndAssetCtxs request; only the
+//          subscription pass (primeAssetCtx) and explicit queries
+//          (getAssetCtx) pull.
+//
+// SETUP:   MockExchange with BTC/ETH answers /info through
+//          http::setResponder (Zorro's HTTP is mock_zorro.h); every
+//          metaAndAssetCtxs request is counted. Context age is injected
+//          through AssetCtxStore::set.
+//
+// NETWORK: None
+//=============================================================================
+
+#define MOCK_ZORRO_IMPLEMENTATION
+#include "mocks/mock_zorro.h"
+#include "mocks/mock_exchange.h"
+#include "test_framework.h"
+#include "hl_globals.h"
+#include "hl_http.h"
+#include "hl_market_service.h"
+#include <cstring>
+
+using namespace hl;
+
+static test::MockExchange* s_exchange = nullptr;
+static int s_ctxPulls = 0;
+
+static bool serveFromMock(const char*, const char* url, const char* body, http::Response& out) {
+    if (!strstr(url, "/info")) return false;
+    if (body && strstr(body, "AssetCtxs")) s_ctxPulls++;
+    test::MockReply r = s_exchange->info(body ? body : "");
+    out.statusCode = r.status;
+    out.body = r.body;
+    return true;
+}
+
+static void resetContexts() {
+    market::cleanup();      // Forgets stored contexts and per-dex pull times
+    s_ctxPulls = 0;
+}
+
+//=============================================================================
+// TEST CASES
+//=============================================================================
+
+TEST_CASE(peek_missing_context_sends_nothing) {
+    resetContexts();
+    AssetCtx ctx;
+    ASSERT_FALSE(market::peekAssetCtx("BTC", &ctx));
+    ASSERT_EQ(s_ctxPulls, 0);
+
+    // Control: the blocking lookup does pull
+    ASSERT_TRUE(market::getAssetCtx("BTC", &ctx));
+    ASSERT_EQ(s_ctxPulls, 1);
+}
+
+TEST_CASE(peek_stale_context_sends_nothing) {
+    resetContexts();
+    uint32_t id = market::getAsset("BTC")->symbolId;
+    AssetCtx old;
+    old.funding = 0.0001;
+    old.markPx = 50000.0;
+    DWORD stale = GetTickCount() - 2 * (DWORD)config::ASSET_CTX_TTL_MS;
+    ASSERT_TRUE(g_assetCtx.set(id, old, AssetCtxSource::Http, stale));
+
+    AssetCtx ctx;
+    ASSERT_TRUE(market::peekAssetCtx("BTC", &ctx));
+    ASSERT_FLOAT_EQ(ctx.funding, 0.0001);      // Served as stored
+    ASSERT_EQ(s_ctxPulls, 0);
+
+    ASSERT_TRUE(market::getAssetCtx("BTC", &ctx));
+    ASSERT_EQ(s_ctxPulls, 1);                  // Control: past the TTL
+}
+
+TEST_CASE(prime_pulls_each_dex_once) {
+    resetContexts();
+    ASSERT_TRUE(market::primeAssetCtx("BTC"));
+    ASSERT_EQ(s_ctxPulls, 1);
+    ASSERT_TRUE(market::primeAssetCtx("ETH"));  // Same dex: already stored
+    ASSERT_TRUE(market::primeAssetCtx("BTC"));
+    ASSERT_EQ(s_ctxPulls, 1);
+
+    AssetCtx ctx;
+    ASSERT_TRUE(market::peekAssetCtx("ETH", &ctx));
+    ASSERT_GT(ctx.markPx, 0.0);
+}
+
+TEST_CASE(unknown_coin_sends_nothing) {
+    resetContexts();
+    AssetCtx ctx;
+    ASSERT_FALSE(market::peekAssetCtx("NOPE", &ctx));
+    ASSERT_FALSE(market::peekAssetCtx("", &ctx));
+    ASSERT_FALSE(market::primeAssetCtx("NOPE"));
+    ASSERT_EQ(s_ctxPulls, 0);
+}
+
+//=============================================================================
+// MAIN
+//=============================================================================
+
+int main() {
+    printf("=== Asset Context No-Fetch Tests ===\n\n");
+
+    test::MockExchangeConfig cfg;
+    cfg.coins.push_back({ "BTC", 50000.0, 5 });
+    cfg.coins.push_back({ "ETH", 3000.0, 4 });
+    test::MockExchange exchange(cfg);
+    s_exchange = &exchange;
+
+    g_config.isTestnet = true;
+    g_config.diagLevel = 0;
+    strcpy_s(g_config.baseUrl, "http://mock.local");
+
+    mock::resetMocks();
+    mock::setHttpFailure(true);                 // Anything the mock exchange doesn't answer fails
+    http::setResponder(&serveFromMock);
+    if (market::refreshMeta() < 2) {
+        printf("FAILED: meta from the mock exchange\n");
+        return 1;
+    }
+
+    RUN_TEST(peek_missing_context_sends_nothing);
+    RUN_TEST(peek_stale_context_sends_nothing);
+    RUN_TEST(prime_pulls_each_dex_once);
+    RUN_TEST(unknown_coin_sends_nothing);
+
+    http::setResponder(nullptr);
+    market::cleanup();
+    return test::printTestSummary();
+}
@@ -132,8 +132,25 @@ int main() {
         failed++;
     }
 
+    // Test 9: Signer recovery (what the exchange checks)
+    printf("[9] Testing crypto::recoverAddress()...\n");
+    char recovered[64] = {0};
+    hl::crypto::Signature tampered = sig;
+    tampered.v = sig.v == 27 ? 28 : 27;
+    char other[64] = {0};
+    if (hl::crypto::recoverAddress(testHash, sig, recovered, sizeof(recovered)) &&
+        _stricmp(recovered, "0xf39Fd6e51aad88F6F4ce6aB8827279cffFb92266") == 0 &&
+        (!hl::crypto::recoverAddress(testHash, tampered, other, sizeof(other)) ||
+         _stricmp(other, recovered) != 0)) {
+        printf("    PASSED: Recovered signer %s\n", recovered);
+        passed++;
+    } else {
+        printf("    FAILED: recoverAddress returned '%s'\n", recovered);
+        failed++;
+    }
+
     // Cleanup
-    printf("[9] Testing crypto::cleanup()...\n");
+    printf("[10] Testing crypto::cleanup()...\n");
     hl::crypto::cleanup();
     if (!hl::crypto::isInitialized()) {
         printf("    PASSED: Cleanup successful\n");
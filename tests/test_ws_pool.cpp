@@ -0,0 +1,255 @@
+//=============================================================================
+// test_ws_pool.cpp - Sharded WebSocket connection pool test
+//=============================================================================
+// Part of Hyperliquid Plugin for Zorro
+//
+// LAYER: Test
+// PURPOSE: Drive WebSocketManager in connection-pool mode against a local
+//          mock server (tests/mocks/mock_ws_server.h) and verify:
+//   1. l2Book subscriptions spread over N market connections by coin hash,
+//      account traffic stays on the primary connection
+//   2. A dropped market connection only resubscribes its own coins
+//   3. Pool size 0 keeps the legacy single-connection layout
+//   4. Warm standby mirrors books and drops the duplicate copy
+//
+// NETWORK: Local only (127.0.0.1), no internet required
+//=============================================================================
+
+#include "test_framework.h"
+#include "ws_manager.h"
+#include "mocks/mock_ws_server.h"
+#include <IXNetSystem.h>
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <string>
+#include <vector>
+#include <cstdio>
+
+static int testLog(const char* msg) {
+    printf("    [WS] %s\n", msg);
+    return 0;
+}
+
+static const char* DUMMY_ADDR = "0x0000000000000000000000000000000000000000";
+
+// Poll a condition until true or timeout
+static bool waitFor(const std::function<bool()>& cond, int timeoutMs) {
+    auto start = std::chrono::steady_clock::now();
+    while (!cond()) {
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        if (std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() >= timeoutMs)
+            return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    return true;
+}
+
+static std::vector<std::string> makeCoins(int n) {
+    std::vector<std::string> coins;
+    for (int i = 0; i < n; ++i) coins.push_back("COIN" + std::to_string(i));
+    return coins;
+}
+
+static bool allPriced(hl::ws::PriceCache& cache, const std::vector<std::string>& coins) {
+    for (const auto& c : coins) if (cache.getBid(c) <= 0) return false;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// Test 1: Coins spread over market connections; primary carries no l2Book
+//-----------------------------------------------------------------------------
+TEST_CASE(pool_spreads_coins_by_hash) {
+    hl::test::MockWsServer server(18765);
+    ASSERT_TRUE(server.start());
+
+    hl::ws::PriceCache cache;
+    hl::ws::WebSocketManager mgr(cache);
+    mgr.setLogCallback(testLog);
+    mgr.setDiagLevel(1);
+    mgr.setUserAddress(DUMMY_ADDR);
+    mgr.setEndpoint(server.host(), false);
+    mgr.setMarketConnections(3);
+    ASSERT_EQ(mgr.getMarketConnections(), 3);
+
+    auto coins = makeCoins(24);
+    mgr.start("", false);
+    for (const auto& c : coins) mgr.subscribeL2Book(c);
+    mgr.markInitialSubscriptionsQueued();
+
+    ASSERT_TRUE(waitFor([&] { return allPriced(cache, coins); }, 5000));
+    ASSERT_EQ(server.totalConnections(), 4);
+    ASSERT_EQ(server.clientsWithL2Subs(), 3);
+
+    // Stable mapping, never the primary connection
+    for (const auto& c : coins) {
+        int idx = mgr.getConnectionIndexForCoin(c);
+        ASSERT_GE(idx, 1);
+        ASSERT_LE(idx, 3);
+        ASSERT_EQ(mgr.getConnectionIndexForCoin(c), idx);
+    }
+
+    auto health = mgr.getConnectionHealth();
+    ASSERT_EQ((int)health.size(), 4);
+    ASSERT_EQ(health[0].l2Subscriptions, 0);
+    int total = 0;
+    for (size_t i = 1; i < health.size(); ++i) {
+        printf("    conn %d: subs=%d msgs=%lld\n",
+               health[i].index, health[i].l2Subscriptions, health[i].messages);
+        ASSERT_TRUE(health[i].connected);
+        ASSERT_GT(health[i].messages, 0);
+        total += health[i].l2Subscriptions;
+    }
+    ASSERT_EQ(total, 24);
+    ASSERT_TRUE(mgr.isHealthyForCoin(coins[0]));
+
+    mgr.stop();
+    server.stop();
+}
+
+//-----------------------------------------------------------------------------
+// Test 2: Dropping one market connection resubscribes only its coins
+//-----------------------------------------------------------------------------
+TEST_CASE(reconnect_isolated_to_shard) {
+    hl::test::MockWsServer server(18766);
+    ASSERT_TRUE(server.start());
+
+    hl::ws::PriceCache cache;
+    hl::ws::WebSocketManager mgr(cache);
+    mgr.setLogCallback(testLog);
+    mgr.setDiagLevel(1);
+    mgr.setUserAddress(DUMMY_ADDR);
+    mgr.setEndpoint(server.host(), false);
+    mgr.setMarketConnections(3);
+
+    auto coins = makeCoins(24);
+    mgr.start("", false);
+    for (const auto& c : coins) mgr.subscribeL2Book(c);
+    mgr.markInitialSubscriptionsQueued();
+    ASSERT_TRUE(waitFor([&] { return allPriced(cache, coins); }, 5000));
+
+    const int victim = 2;
+    std::vector<std::string> victimCoins, otherCoins;
+    for (const auto& c : coins)
+        (mgr.getConnectionIndexForCoin(c) == victim ? victimCoins : otherCoins).push_back(c);
+    ASSERT_GT((int)victimCoins.size(), 0);
+
+    mgr.forceDisconnectForTest(victim);
+
+    bool resubscribed = waitFor([&] {
+        for (const auto& c : victimCoins) if (server.subscribeCount(c) < 2) return false;
+        return true;
+    }, 10000);
+    ASSERT_TRUE(resubscribed);
+
+    for (const auto& c : otherCoins) ASSERT_EQ(server.subscribeCount(c), 1);
+
+    auto health = mgr.getConnectionHealth();
+    for (const auto& h : health) {
+        printf("    conn %d: reconnects=%d subs=%d\n", h.index, h.reconnects, h.l2Subscriptions);
+        if (h.index == victim) ASSERT_GE(h.reconnects, 1);
+        else ASSERT_EQ(h.reconnects, 0);
+    }
+
+    mgr.stop();
+    server.stop();
+}
+
+//-----------------------------------------------------------------------------
+// Test 3: Pool disabled — everything on the primary connection
+//-----------------------------------------------------------------------------
+TEST_CASE(single_connection_mode) {
+    hl::test::MockWsServer server(18767);
+    ASSERT_TRUE(server.start());
+
+    hl::ws::PriceCache cache;
+    hl::ws::WebSocketManager mgr(cache);
+    mgr.setLogCallback(testLog);
+    mgr.setDiagLevel(1);
+    mgr.setEndpoint(server.host(), false);
+    mgr.setMarketConnections(0);
+
+    auto coins = makeCoins(8);
+    mgr.start("", false);
+    for (const auto& c : coins) mgr.subscribeL2Book(c);
+    mgr.markInitialSubscriptionsQueued();
+    ASSERT_TRUE(waitFor([&] { return allPriced(cache, coins); }, 5000));
+
+    ASSERT_EQ(server.totalConnections(), 1);
+    for (const auto& c : coins) ASSERT_EQ(mgr.getConnectionIndexForCoin(c), 0);
+
+    auto health = mgr.getConnectionHealth();
+    ASSERT_EQ((int)health.size(), 1);
+    ASSERT_EQ(health[0].l2Subscriptions, 8);
+
+    mgr.stop();
+    server.stop();
+}
+
+//-----------------------------------------------------------------------------
+// Test 4: Warm standby — both connections see each book, one copy is applied
+//-----------------------------------------------------------------------------
+TEST_CASE(standby_first_arrival_dedup) {
+    hl::test::MockWsServer server(18768);
+    ASSERT_TRUE(server.start());
+
+    hl::ws::PriceCache cache;
+    hl::ws::WebSocketManager mgr(cache);
+    mgr.setLogCallback(testLog);
+    mgr.setDiagLevel(1);
+    mgr.setUserAddress(DUMMY_ADDR);
+    mgr.setEndpoint(server.host(), false);
+    mgr.setStandbyEnabled(true);
+    ASSERT_TRUE(mgr.isStandbyEnabled());
+
+    mgr.start("", false);
+    mgr.subscribeL2Book("BTC");
+    mgr.addStandbyCoin("BTC");
+    mgr.markInitialSubscriptionsQueued();
+
+    // Both connections subscribed to BTC
+    ASSERT_TRUE(waitFor([&] { return server.subscribeCount("BTC") == 2; }, 5000));
+    ASSERT_EQ(server.totalConnections(), 2);
+
+    const int UPDATES = 50;
+    for (int i = 1; i <= UPDATES; ++i) {
+        server.broadcastL2Book("BTC", 100.0 + i, 101.0 + i, 1000 + i);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    ASSERT_TRUE(waitFor([&] { return cache.getBid("BTC") == 100.0 + UPDATES; }, 3000));
+    ASSERT_TRUE(waitFor([&] { return mgr.getDuplicatesDropped() >= UPDATES; }, 3000));
+
+    long long first = 0;
+    auto health = mgr.getConnectionHealth();
+    ASSERT_EQ((int)health.size(), 2);
+    ASSERT_TRUE(health[1].standby);
+    for (const auto& h : health) first += h.firstArrivals;
+    printf("    first arrivals=%lld duplicates=%lld\n", first, mgr.getDuplicatesDropped());
+    ASSERT_LE(first, UPDATES + 2);  // + initial snapshots (time 0 is never deduped)
+
+    // Primary down: standby keeps the coin healthy
+    mgr.forceDisconnectForTest(0);
+    server.broadcastL2Book("BTC", 200.0, 201.0, 5000);
+    ASSERT_TRUE(waitFor([&] { return cache.getBid("BTC") == 200.0; }, 1000));
+
+    mgr.stop();
+    server.stop();
+}
+
+//-----------------------------------------------------------------------------
+// Main
+//-----------------------------------------------------------------------------
+int main() {
+    printf("=== WebSocket Connection Pool Tests ===\n\n");
+
+    ix::initNetSystem();
+
+    RUN_TEST(pool_spreads_coins_by_hash);
+    RUN_TEST(reconnect_isolated_to_shard);
+    RUN_TEST(single_connection_mode);
+    RUN_TEST(standby_first_arrival_dedup);
+
+    int result = hl::test::printTestSummary();
+    ix::uninitNetSystem();
+    return result;
+}
@@ -5,6 +5,9 @@
 #include "ws_price_cache.h"
 #include <cassert>
 #include <cstdio>
+#include <atomic>
+#include <chrono>
+#include <thread>
 
 using namespace hl::ws;
 
@@ -106,6 +109,99 @@ void test_open_orders() {
     printf(" PASSED\n");
 }
 
+void test_position_snapshots() {
+    printf("  test_position_snapshots...");
+
+    PriceCache cache;
+    std::vector<PositionData> mainBook(3), xyzBook(1);
+    const char* coins[] = { "BTC", "ETH", "SOL" };
+    for (int i = 0; i < 3; i++) {
+        mainBook[i].coin = coins[i];
+        mainBook[i].size = 1.0 + i;
+    }
+    xyzBook[0].coin = "xyz:XYZ100";
+    xyzBook[0].size = -2.0;
+    cache.publishPositions("", mainBook);
+    cache.publishPositions("xyz", xyzBook);
+    assert(cache.getAllPositions().size() == 4);
+    assert(cache.getPosition("xyz:XYZ100").dex == "xyz");
+
+    // A held handle is immutable: republishing does not change it
+    PositionSnapshot held = cache.getPositionSnapshot("");
+    mainBook.pop_back();
+    cache.publishPositions("", mainBook);
+    assert(held->byCoin.size() == 3);
+    assert(cache.getPositionSnapshot("").get() != held.get());
+    assert(cache.getPosition("SOL").size == 0);
+    assert(cache.getPosition("xyz:XYZ100").size == -2.0);  // Other dex untouched
+
+    // Single update (fill bridge) lands in the dex of its coin prefix
+    PositionData fill;
+    fill.coin = "xyz:ABC";
+    fill.size = 0.5;
+    cache.setPosition(fill);
+    assert(cache.getPositionSnapshot("xyz")->byCoin.size() == 2);
+    assert(cache.getPositionSnapshot("")->byCoin.size() == 2);
+
+    // Readers never see a book that is empty or half replaced
+    mainBook.push_back(PositionData());
+    mainBook.back().coin = "SOL";
+    mainBook.back().size = 3.0;
+    cache.publishPositions("", mainBook);
+    std::atomic<bool> stop(false);
+    std::atomic<int> torn(0);
+    std::thread writer([&] {
+        for (int i = 0; i < 20000; i++) cache.publishPositions("", mainBook);
+        stop = true;
+    });
+    while (!stop.load()) {
+        if (cache.getPosition("BTC").size != 1.0) torn++;
+        if (cache.getPositionSnapshot("")->byCoin.size() != 3) torn++;
+    }
+    writer.join();
+    assert(torn.load() == 0);
+
+    printf(" PASSED\n");
+}
+
+void test_open_order_snapshots() {
+    printf("  test_open_order_snapshots...");
+
+    PriceCache cache;
+    std::vector<OpenOrderData> orders(2);
+    orders[0].oid = "1";
+    orders[0].coin = "BTC";
+    orders[1].oid = "2";
+    orders[1].coin = "ETH";
+    cache.publishOpenOrders(orders);
+    assert(cache.getOpenOrdersAge() < 1000);
+
+    OpenOrderSnapshot held = cache.getOpenOrderSnapshot();
+    cache.removeOpenOrder("1");
+    assert(held->byOid.size() == 2);
+    assert(cache.getAllOpenOrders().size() == 1);
+    assert(cache.getOpenOrder("1").oid.empty());
+
+    cache.publishOpenOrders(orders);
+    std::atomic<bool> stop(false);
+    std::atomic<int> torn(0);
+    std::thread writer([&] {
+        for (int i = 0; i < 20000; i++) cache.publishOpenOrders(orders);
+        stop = true;
+    });
+    while (!stop.load()) {
+        if (cache.getOpenOrdersForCoin("ETH").size() != 1) torn++;
+        if (cache.getAllOpenOrders().size() != 2) torn++;
+    }
+    writer.join();
+    assert(torn.load() == 0);
+
+    cache.clearOpenOrders();
+    assert(cache.getAllOpenOrders().empty());
+
+    printf(" PASSED\n");
+}
+
 void test_fills() {
     printf("  test_fills...");
 
@@ -126,6 +222,34 @@ void test_fills() {
 
     auto forOrder = cache.getFillsForOrder("order123");
     assert(forOrder.size() == 1);
+    assert(forOrder[0].coin == "BTC");
+
+    printf(" PASSED\n");
+}
+
+void test_fill_capacity() {
+    printf("  test_fill_capacity...");
+
+    PriceCache cache(4);
+    assert(cache.getFillCapacity() == 4);
+
+    // Basket order: more partial fills than the old 100-fill limit
+    cache.setFillCapacity(500);
+    FillData fill;
+    fill.coin = "ETH";
+    fill.sz = 0.01;
+    for (int i = 0; i < 300; i++) {
+        fill.oid = (i % 3 == 0) ? "basket" : "other";
+        fill.tid = std::to_string(i);
+        cache.addFill(fill);
+    }
+    assert(cache.getFillsForOrder("basket").size() == 100);
+    assert(cache.getRecentFills(1000).size() == 300);
+
+    // Shrinking keeps the newest fills and the oid index in step
+    cache.setFillCapacity(30);
+    assert(cache.getFillsForOrder("basket").size() == 10);
+    assert(cache.getRecentFills(1)[0].tid == "299");
 
     printf(" PASSED\n");
 }
@@ -155,6 +279,60 @@ void test_clear_all() {
     printf(" PASSED\n");
 }
 
+void test_wait_first_quote() {
+    printf("  test_wait_first_quote...");
+
+    PriceCache cache;
+    typedef std::chrono::steady_clock Clock;
+
+    // Timeout: nothing arrives
+    auto t0 = Clock::now();
+    assert(!cache.waitForBidAsk("BTC", 50));
+    assert(Clock::now() - t0 >= std::chrono::milliseconds(40));
+
+    // Already quoted: returns immediately
+    cache.setBidAsk("ETH", 3000.0, 3001.0);
+    assert(cache.waitForBidAsk("ETH", 0));
+
+    // Woken by the setBidAsk itself, not by a poll interval
+    std::atomic<long long> setAtNs(0);
+    std::thread feeder([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        setAtNs = Clock::now().time_since_epoch().count();
+        cache.setBidAsk("BTC", 50000.0, 50001.0);
+    });
+    bool got = cache.waitForBidAsk("BTC", 2000);
+    long long wakeNs = Clock::now().time_since_epoch().count() - setAtNs.load();
+    feeder.join();
+    assert(got);
+    assert(wakeNs < 5000000LL);  // Well under any 50ms poll step
+
+    printf(" PASSED (wake %lldus)\n", wakeNs / 1000);
+}
+
+void test_wait_coin_set() {
+    printf("  test_wait_coin_set...");
+
+    PriceCache cache;
+    std::vector<std::string> coins = { "A", "B", "C" };
+
+    // Staggered arrivals, one shared deadline
+    std::thread feeder([&] {
+        for (const auto& c : coins) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            cache.setBidAsk(c, 1.0, 1.1);
+        }
+    });
+    assert(cache.waitForBidAsk(coins, 2000) == 3);
+    feeder.join();
+
+    // Partial: deadline hits with one coin missing
+    coins.push_back("MISSING");
+    assert(cache.waitForBidAsk(coins, 30) == 3);
+
+    printf(" PASSED\n");
+}
+
 int main() {
     printf("=== ws_price_cache tests ===\n");
 
@@ -162,8 +340,13 @@ int main() {
     test_account_data();
     test_positions();
     test_open_orders();
+    test_position_snapshots();
+    test_open_order_snapshots();
     test_fills();
+    test_fill_capacity();
     test_clear_all();
+    test_wait_first_quote();
+    test_wait_coin_set();
 
     printf("\nAll ws_price_cache tests PASSED!\n");
     return 0;
@@ -0,0 +1,157 @@
+//=============================================================================
+// test_ws_resubscribe_pacing.cpp - Paced l2Book resubscription after reconnect
+//=============================================================================
+// Part of Hyperliquid Plugin for Zorro
+//
+// LAYER: Test
+// PURPOSE: 300 l2Book coins against a local server that drops any client
+//          sending more than BURST_LIMIT subscribes per second (the failure
+//          mode behind OPM-170 reconnect storms). Reports time from a
+//          server-side disconnect until every subscription is acked again:
+//   1. Paced scheduler: completes, no burst rejections, positions first
+//   2. Unpaced (huge rate/burst): the server keeps dropping the client
+//
+// NETWORK: Local only (127.0.0.1), no internet required
+//=============================================================================
+
+#include "test_framework.h"
+#include "ws_manager.h"
+#include "mocks/mock_ws_server.h"
+#include <IXNetSystem.h>
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <string>
+#include <vector>
+#include <cstdio>
+
+static const int COINS = 300;
+static const int BURST_LIMIT = 50;        // Server: max subscribes per window
+static const int BURST_WINDOW_MS = 1000;
+
+static int testLog(const char* msg) {
+    printf("    [WS] %s\n", msg);
+    return 0;
+}
+
+static bool waitFor(const std::function<bool()>& cond, int timeoutMs) {
+    auto start = std::chrono::steady_clock::now();
+    while (!cond()) {
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        if (std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() >= timeoutMs)
+            return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    return true;
+}
+
+static long long msSince(std::chrono::steady_clock::time_point t) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - t).count();
+}
+
+static std::vector<std::string> makeCoins(int n) {
+    std::vector<std::string> coins;
+    for (int i = 0; i < n; ++i) coins.push_back("COIN" + std::to_string(i));
+    return coins;
+}
+
+//-----------------------------------------------------------------------------
+// Test 1: Paced resubscription completes under the server's burst limit
+//-----------------------------------------------------------------------------
+TEST_CASE(paced_resubscribe_300_coins) {
+    hl::test::MockWsServer server(18772);
+    server.setBurstLimit(BURST_LIMIT, BURST_WINDOW_MS);
+    ASSERT_TRUE(server.start());
+
+    hl::ws::PriceCache cache;
+    hl::ws::WebSocketManager mgr(cache);
+    mgr.setLogCallback(testLog);
+    mgr.setDiagLevel(1);
+    mgr.setEndpoint(server.host(), false);
+    mgr.setSubscriptionPacing(40.0, 10);  // Under the 50/s limit
+
+    // Open position on the last coin — must come back first
+    hl::ws::PositionData pos = {};
+    pos.coin = "COIN299";
+    pos.size = 1.0;
+    cache.setPosition(pos);
+
+    auto coins = makeCoins(COINS);
+    auto t0 = std::chrono::steady_clock::now();
+    mgr.start("", false);
+    for (const auto& c : coins) mgr.subscribeL2Book(c);
+    mgr.markInitialSubscriptionsQueued();
+
+    ASSERT_TRUE(waitFor([&] { return mgr.allSubscriptionsAcked(); }, 20000));
+    long long initialMs = msSince(t0);
+    ASSERT_EQ(server.ackedL2Coins(), COINS);
+
+    // Server-side disconnect; every subscription must be replayed
+    server.clearSubscribeLog();
+    auto t1 = std::chrono::steady_clock::now();
+    server.dropAll();
+    ASSERT_TRUE(waitFor([&] { return !mgr.allSubscriptionsAcked(); }, 3000));
+    ASSERT_TRUE(waitFor([&] {
+        return mgr.allSubscriptionsAcked() && server.ackedL2Coins() == COINS;
+    }, 20000));
+    long long resubMs = msSince(t1);
+
+    auto order = server.subscribeLog();
+    ASSERT_GE((int)order.size(), COINS);
+    ASSERT_STREQ(order[0].c_str(), "COIN299");
+
+    printf("    initial=%lldms resubscribe=%lldms rejections=%d\n",
+           initialMs, resubMs, server.burstRejections());
+    ASSERT_EQ(server.burstRejections(), 0);
+
+    mgr.stop();
+    server.stop();
+}
+
+//-----------------------------------------------------------------------------
+// Test 2: Unpaced baseline — the burst gets the client dropped
+//-----------------------------------------------------------------------------
+TEST_CASE(unpaced_burst_rejected) {
+    hl::test::MockWsServer server(18773);
+    server.setBurstLimit(BURST_LIMIT, BURST_WINDOW_MS);
+    ASSERT_TRUE(server.start());
+
+    hl::ws::PriceCache cache;
+    hl::ws::WebSocketManager mgr(cache);
+    mgr.setLogCallback(testLog);
+    mgr.setDiagLevel(1);
+    mgr.setEndpoint(server.host(), false);
+    mgr.setSubscriptionPacing(100000.0, 1000);  // Effectively the old tight loop
+
+    auto coins = makeCoins(COINS);
+    mgr.start("", false);
+    for (const auto& c : coins) mgr.subscribeL2Book(c);
+    mgr.markInitialSubscriptionsQueued();
+
+    bool complete = waitFor([&] { return mgr.allSubscriptionsAcked(); }, 5000);
+    printf("    complete=%s rejections=%d acked=%d/%d\n", complete ? "yes" : "no",
+           server.burstRejections(), server.ackedL2Coins(), COINS);
+    ASSERT_FALSE(complete);
+    ASSERT_GT(server.burstRejections(), 0);
+
+    mgr.stop();
+    server.stop();
+}
+
+//-----------------------------------------------------------------------------
+// Main
+//-----------------------------------------------------------------------------
+int main() {
+    printf("=== WebSocket Resubscribe Pacing Tests ===\n");
+    printf("coins=%d server limit=%d/%dms\n\n", COINS, BURST_LIMIT, BURST_WINDOW_MS);
+
+    ix::initNetSystem();
+
+    RUN_TEST(paced_resubscribe_300_coins);
+    RUN_TEST(unpaced_burst_rejected);
+
+    int result = hl::test::printTestSummary();
+    ix::uninitNetSystem();
+    return result;
+}
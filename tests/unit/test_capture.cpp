@@ -0,0 +1,160 @@
+//=============================================================================
+// test_capture.cpp - Unit tests for the traffic capture format and replay
+//=============================================================================
+// Part of Hyperliquid Plugin for Zorro
+//
+// LAYER: Test
+// PURPOSE: Records written by the recorder read back in order with their
+//          kind, channel, status and payload; nothing is written while no
+//          capture runs; foreign and truncated files are rejected; the HTTP
+//          replay pairs requests with responses by call id (also when
+//          interleaved), prefers exact bodies and falls back to the same
+//          endpoint, and reports what it could not serve.
+//=============================================================================
+
+#include "../test_framework.h"
+#include "hl_capture.h"
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace hl::capture;
+
+static std::string capturePath(const char* tag) {
+    char path[MAX_PATH];
+    sprintf_s(path, "capture_test_%s_%lu.hlcap", tag, (unsigned long)GetCurrentProcessId());
+    return path;
+}
+
+static Record makeRecord(Kind kind, uint8_t channel, uint16_t status, const std::string& data) {
+    Record r;
+    r.kind = kind;
+    r.channel = channel;
+    r.status = status;
+    r.data = data;
+    return r;
+}
+
+TEST_CASE(records_round_trip) {
+    std::string path = capturePath("rt");
+    record(Kind::WsRecv, 0, 0, "ignored", 7);           // Not capturing yet
+    ASSERT_TRUE(start(path.c_str()));
+    ASSERT_TRUE(active());
+
+    const char* book = "{\"channel\":\"l2Book\",\"data\":{\"coin\":\"BTC\"}}";
+    record(Kind::WsOpen, 1, 0, nullptr, 0);
+    record(Kind::WsRecv, 1, 0, book, strlen(book));
+    record(Kind::WsSend, 0, 0, "{\"method\":\"ping\"}", 17);
+    uint8_t id = nextHttpId();
+    recordHttpRequest(id, "POST", "https://api.hyperliquid.xyz/info", "{\"type\":\"meta\"}");
+    record(Kind::HttpResponse, id, 200, "{\"universe\":[]}", 15);
+    record(Kind::WsClose, 1, 1006, "gone", 4);
+    ASSERT_EQ((int)getStats().records, 6);
+    stop();
+    ASSERT_FALSE(active());
+    record(Kind::WsRecv, 0, 0, "late", 4);              // After stop: dropped
+
+    std::vector<Record> recs;
+    ASSERT_TRUE(Reader::readAll(path.c_str(), recs));
+    remove(path.c_str());
+    ASSERT_EQ((int)recs.size(), 6);
+    ASSERT_TRUE(recs[0].kind == Kind::WsOpen);
+    ASSERT_EQ((int)recs[0].channel, 1);
+    ASSERT_TRUE(recs[1].kind == Kind::WsRecv);
+    ASSERT_STREQ(recs[1].data.c_str(), book);
+    ASSERT_TRUE(recs[2].kind == Kind::WsSend);
+    ASSERT_TRUE(recs[3].kind == Kind::HttpRequest);
+    ASSERT_EQ((int)recs[3].channel, (int)id);
+    ASSERT_STREQ(recs[3].data.c_str(), "POST https://api.hyperliquid.xyz/info\n{\"type\":\"meta\"}");
+    ASSERT_EQ((int)recs[4].status, 200);
+    ASSERT_TRUE(recs[5].kind == Kind::WsClose);
+    ASSERT_EQ((int)recs[5].status, 1006);
+    ASSERT_STREQ(recs[5].data.c_str(), "gone");
+    for (size_t i = 1; i < recs.size(); i++) ASSERT_TRUE(recs[i].tsNs >= recs[i - 1].tsNs);
+}
+
+TEST_CASE(http_ids_skip_zero) {
+    for (int i = 0; i < 600; i++) ASSERT_TRUE(nextHttpId() != 0);
+}
+
+TEST_CASE(foreign_and_truncated_files) {
+    std::string path = capturePath("bad");
+    FILE* f = nullptr;
+    ASSERT_EQ(fopen_s(&f, path.c_str(), "wb"), 0);
+    fputs("not a capture file at all", f);
+    fclose(f);
+    Reader r;
+    ASSERT_FALSE(r.open(path.c_str()));
+    ASSERT_FALSE(r.open("no_such_capture.hlcap"));
+
+    ASSERT_TRUE(start(path.c_str()));
+    record(Kind::WsRecv, 0, 0, "0123456789", 10);
+    record(Kind::WsRecv, 0, 0, "abcdefghij", 10);
+    stop();
+    // Cut the last record's payload short
+    ASSERT_EQ(fopen_s(&f, path.c_str(), "rb"), 0);
+    std::string bytes;
+    char buf[256];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) bytes.append(buf, n);
+    fclose(f);
+    ASSERT_EQ((int)bytes.size(), 16 + 2 * (16 + 10));
+    ASSERT_EQ(fopen_s(&f, path.c_str(), "wb"), 0);
+    fwrite(bytes.data(), 1, bytes.size() - 3, f);
+    fclose(f);
+
+    ASSERT_TRUE(r.open(path.c_str()));
+    Record rec;
+    ASSERT_TRUE(r.next(rec));
+    ASSERT_STREQ(rec.data.c_str(), "0123456789");
+    ASSERT_FALSE(r.next(rec));
+    r.close();
+    remove(path.c_str());
+}
+
+TEST_CASE(http_replay_pairs_and_matches) {
+    const char* info = "POST https://api.hyperliquid.xyz/info\n";
+    const char* exch = "POST https://api.hyperliquid.xyz/exchange\n";
+    std::vector<Record> recs;
+    // Two calls in flight at once: responses arrive in the other order
+    recs.push_back(makeRecord(Kind::HttpRequest, 1, 0, std::string(info) + "{\"type\":\"meta\"}"));
+    recs.push_back(makeRecord(Kind::HttpRequest, 2, 0, std::string(info) + "{\"type\":\"allMids\"}"));
+    recs.push_back(makeRecord(Kind::HttpResponse, 2, 200, "{\"BTC\":\"50000\"}"));
+    recs.push_back(makeRecord(Kind::HttpResponse, 1, 200, "{\"universe\":[]}"));
+    recs.push_back(makeRecord(Kind::HttpRequest, 3, 0, std::string(exch) + "{\"nonce\":1}"));
+    recs.push_back(makeRecord(Kind::HttpResponse, 3, 0, ""));
+    recs.push_back(makeRecord(Kind::WsRecv, 0, 0, "{}"));
+
+    HttpReplay replay;
+    replay.load(recs);
+    ASSERT_EQ(replay.size(), 3);
+
+    hl::http::Response resp;
+    ASSERT_TRUE(replay.serve("POST", "https://api.hyperliquid.xyz/info", "{\"type\":\"allMids\"}", resp));
+    ASSERT_EQ(resp.statusCode, 200);
+    ASSERT_STREQ(resp.body.c_str(), "{\"BTC\":\"50000\"}");
+
+    // Signed bodies differ on replay: same endpoint, oldest first
+    ASSERT_TRUE(replay.serve("POST", "https://api.hyperliquid.xyz/exchange", "{\"nonce\":2}", resp));
+    ASSERT_EQ(resp.statusCode, 0);
+    ASSERT_FALSE(resp.success());
+
+    ASSERT_TRUE(replay.serve("POST", "https://api.hyperliquid.xyz/info", "{\"type\":\"other\"}", resp));
+    ASSERT_STREQ(resp.body.c_str(), "{\"universe\":[]}");
+
+    ASSERT_FALSE(replay.serve("POST", "https://api.hyperliquid.xyz/info", "{\"type\":\"meta\"}", resp));
+    ASSERT_EQ(replay.served(), 3);
+    ASSERT_EQ(replay.missed(), 1);
+}
+
+int main() {
+    printf("=== Traffic Capture Tests ===\n\n");
+
+    RUN_TEST(records_round_trip);
+    RUN_TEST(http_ids_skip_zero);
+    RUN_TEST(foreign_and_truncated_files);
+    RUN_TEST(http_replay_pairs_and_matches);
+
+    return hl::test::printTestSummary();
+}
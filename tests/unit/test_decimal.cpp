@@ -0,0 +1,227 @@
+//=============================================================================
+// test_decimal.cpp - Property tests for the px/sz decimal kernels
+//=============================================================================
+// Part of Hyperliquid Plugin for Zorro
+//
+// LAYER: Test
+// PURPOSE: decimal::parse must equal strtod, and formatPriceForExchange /
+//          formatSize / the "%.8f"-trimmed formatNumber must return the same
+//          strings as the previous ostringstream / snprintf implementations
+//          (copied below as references) for random prices and sizes at every
+//          szDecimals, including exact .5 ties, negatives and non-finite.
+//=============================================================================
+
+#include "../test_framework.h"
+#include "hl_decimal.h"
+#include "hl_utils.h"
+#include <cfloat>
+#include <cmath>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <string>
+
+using namespace hl;
+
+static const int SAMPLES = 20000;
+
+// -----------------------------------------------------------------------------
+// Previous implementations (reference)
+// -----------------------------------------------------------------------------
+
+static std::string stripZeros(std::string s) {
+    size_t dot = s.find('.');
+    if (dot != std::string::npos) {
+        size_t end = s.find_last_not_of('0');
+        if (end != std::string::npos)
+            s = s.substr(0, end + 1);
+        if (!s.empty() && s.back() == '.')
+            s.pop_back();
+    }
+    return s;
+}
+
+static std::string refFixed(double v, int decimals) {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(decimals) << v;
+    return oss.str();
+}
+
+static std::string refPriceForExchange(double price, int szDecimals, int maxDecimals) {
+    double rounded = utils::roundPriceForExchange(price, szDecimals, maxDecimals);
+    int maxDecPlaces = maxDecimals - szDecimals;
+    if (maxDecPlaces < 0) maxDecPlaces = 0;
+    return stripZeros(refFixed(rounded, maxDecPlaces));
+}
+
+static std::string refFormatNumber(double value) {
+    char buf[512];
+    snprintf(buf, sizeof(buf), "%.8f", value);
+    return stripZeros(buf);
+}
+
+static std::string trimmed(double v, int decimals) {
+    char buf[decimal::MAX_FIXED_CHARS];
+    int n = decimal::formatTrimmed(v, decimals, buf, sizeof(buf));
+    return n < 0 ? std::string("<error>") : std::string(buf, n);
+}
+
+static std::string fixed(double v, int decimals) {
+    char buf[decimal::MAX_FIXED_CHARS];
+    int n = decimal::formatFixed(v, decimals, buf, sizeof(buf));
+    return n < 0 ? std::string("<error>") : std::string(buf, n);
+}
+
+// Log-uniform over [1e-7, 1e9): sub-satoshi quotes to index-sized prices
+static double randomPrice(std::mt19937_64& rng) {
+    std::uniform_real_distribution<double> exp10(-7.0, 9.0);
+    return pow(10.0, exp10(rng));
+}
+
+static bool sameDouble(double a, double b) {
+    if (std::isnan(a) || std::isnan(b)) return std::isnan(a) && std::isnan(b);
+    return a == b && std::signbit(a) == std::signbit(b);
+}
+
+// -----------------------------------------------------------------------------
+// parse
+// -----------------------------------------------------------------------------
+
+TEST_CASE(parse_matches_strtod_on_exchange_strings) {
+    std::mt19937_64 rng(42);
+    std::uniform_int_distribution<int> decs(0, 10);
+    char buf[64];
+    for (int i = 0; i < SAMPLES; i++) {
+        double v = randomPrice(rng);
+        if (i % 3 == 0) v = -v;
+        sprintf_s(buf, "%.*f", decs(rng), v);
+        double got = decimal::parse(buf);
+        double ref = strtod(buf, nullptr);
+        if (!sameDouble(got, ref)) ASSERT_STREQ(buf, "<parse mismatch>");
+    }
+}
+
+TEST_CASE(parse_matches_strtod_on_random_digits) {
+    // Up to 20 digits with the point anywhere: covers the >15 digit fallback
+    std::mt19937_64 rng(7);
+    std::uniform_int_distribution<int> len(1, 20);
+    std::uniform_int_distribution<int> digit(0, 9);
+    char buf[64];
+    for (int i = 0; i < SAMPLES; i++) {
+        int n = len(rng);
+        int dot = std::uniform_int_distribution<int>(0, n)(rng);
+        int k = 0;
+        for (int j = 0; j < n; j++) {
+            if (j == dot && j > 0) buf[k++] = '.';
+            buf[k++] = (char)('0' + digit(rng));
+        }
+        buf[k] = '\0';
+        if (!sameDouble(decimal::parse(buf), strtod(buf, nullptr)))
+            ASSERT_STREQ(buf, "<parse mismatch>");
+    }
+}
+
+TEST_CASE(parse_edge_cases_match_strtod) {
+    const char* cases[] = {
+        "0", "-0", "-0.0", "0.0", "5.", ".5", "-.5", "", "-", ".", "abc",
+        "1e5", "1.5E-3", " 42", "42 ", "+7", "0x10", "inf", "-inf", "nan",
+        "123456789012345", "1234567890123456", "0.0000000000000000000001",
+        "0.00000000000000000000001", "97000.5", "0.00001234", "999999.999999",
+        "00000000000000000001.5"
+    };
+    for (const char* s : cases) {
+        if (!sameDouble(decimal::parse(s), strtod(s, nullptr)))
+            ASSERT_STREQ(s, "<parse mismatch>");
+    }
+    ASSERT_EQ(decimal::parse(nullptr), 0.0);
+}
+
+// -----------------------------------------------------------------------------
+// format
+// -----------------------------------------------------------------------------
+
+TEST_CASE(price_matches_reference_every_szdecimals) {
+    std::mt19937_64 rng(1);
+    for (int i = 0; i < SAMPLES; i++) {
+        double px = randomPrice(rng);
+        for (int sz = 0; sz <= 6; sz++) {                   // Perps: 6 - szDecimals
+            std::string got = utils::formatPriceForExchange(px, sz, 6);
+            std::string ref = refPriceForExchange(px, sz, 6);
+            if (got != ref) ASSERT_STREQ(got.c_str(), ref.c_str());
+        }
+        for (int sz = 0; sz <= 8; sz++) {                   // Spot: 8 - szDecimals
+            std::string got = utils::formatPriceForExchange(px, sz, 8);
+            std::string ref = refPriceForExchange(px, sz, 8);
+            if (got != ref) ASSERT_STREQ(got.c_str(), ref.c_str());
+        }
+    }
+    ASSERT_STREQ(utils::formatPriceForExchange(97123.456, 5).c_str(), "97123");
+    ASSERT_STREQ(utils::formatPriceForExchange(0.000123456, 0).c_str(), "0.000123");
+    ASSERT_STREQ(utils::formatPriceForExchange(0.0, 2).c_str(), "0");
+}
+
+TEST_CASE(size_matches_reference_every_szdecimals) {
+    std::mt19937_64 rng(2);
+    for (int i = 0; i < SAMPLES; i++) {
+        double size = randomPrice(rng);
+        for (int sz = 0; sz <= 15; sz++) {
+            std::string got = utils::formatSize(size, sz);
+            std::string ref = refFixed(size, sz);
+            if (got != ref) ASSERT_STREQ(got.c_str(), ref.c_str());
+        }
+    }
+}
+
+TEST_CASE(format_number_matches_reference) {
+    std::mt19937_64 rng(3);
+    for (int i = 0; i < SAMPLES; i++) {
+        double v = randomPrice(rng);
+        if (i % 2) v = -v;
+        std::string got = trimmed(v, 8);
+        std::string ref = refFormatNumber(v);
+        if (got != ref) ASSERT_STREQ(got.c_str(), ref.c_str());
+    }
+}
+
+TEST_CASE(ties_negatives_and_non_finite_match_printf) {
+    // Exact binary ties go through the C runtime, whatever its tie rule
+    const double values[] = {
+        0.125, 0.375, 2.5, 3.5, -2.5, 1.005, 0.5, 1e-9, -0.001, -0.0, 0.0,
+        123456789.125, 4503599627370496.0, 1e300, -DBL_MAX, DBL_MIN,
+        INFINITY, -INFINITY, NAN
+    };
+    for (double v : values) {
+        for (int d = 0; d <= 15; d++) {
+            std::string got = fixed(v, d);
+            std::string ref = refFixed(v, d);
+            if (got != ref) ASSERT_STREQ(got.c_str(), ref.c_str());
+        }
+    }
+    ASSERT_STREQ(fixed(-0.001, 2).c_str(), "-0.00");
+    ASSERT_STREQ(trimmed(-0.001, 2).c_str(), "-0");
+    ASSERT_STREQ(trimmed(2.0, 3).c_str(), "2");
+    ASSERT_STREQ(trimmed(100.0, 0).c_str(), "100");
+}
+
+TEST_CASE(small_buffer_reports_error) {
+    char buf[4];
+    ASSERT_EQ(decimal::formatFixed(12.5, 2, buf, sizeof(buf)), -1);
+    ASSERT_EQ(decimal::formatFixed(1.5, 1, buf, sizeof(buf)), 3);
+    ASSERT_STREQ(buf, "1.5");
+    ASSERT_EQ(decimal::formatFixed(1.0, 1, nullptr, 0), -1);
+}
+
+int main() {
+    printf("=== Decimal Kernel Property Tests ===\n\n");
+
+    RUN_TEST(parse_matches_strtod_on_exchange_strings);
+    RUN_TEST(parse_matches_strtod_on_random_digits);
+    RUN_TEST(parse_edge_cases_match_strtod);
+    RUN_TEST(price_matches_reference_every_szdecimals);
+    RUN_TEST(size_matches_reference_every_szdecimals);
+    RUN_TEST(format_number_matches_reference);
+    RUN_TEST(ties_negatives_and_non_finite_match_printf);
+    RUN_TEST(small_buffer_reports_error);
+
+    return hl::test::printTestSummary();
+}
@@ -0,0 +1,202 @@
+//=============================================================================
+// test_fill_aggregator.cpp - Unit tests for FillAggregator
+//=============================================================================
+// Part of Hyperliquid Plugin for Zorro
+//
+// LAYER: Test
+// PURPOSE: tid dedup, cumulative size/VWAP, changed-only notification,
+//          retirement, idle parking, cancelled orders and late-fill
+//          handling. Time is injected — no sleeps, no network.
+//=============================================================================
+
+#include "../test_framework.h"
+#include "ws_fill_aggregator.h"
+#include <cmath>
+
+using hl::ws::FillAggregator;
+using hl::ws::FillData;
+using hl::ws::OrderFillTotals;
+
+static FillData makeFill(const char* oid, const char* tid, double px, double sz,
+                         long long time = 1700000000000LL) {
+    FillData f;
+    f.oid = oid;
+    f.coin = "BTC";
+    f.tid = tid;
+    f.px = px;
+    f.sz = sz;
+    f.fee = sz * px * 0.0002;
+    f.time = time;
+    return f;
+}
+
+TEST_CASE(cumulative_size_and_vwap) {
+    FillAggregator agg;
+    ASSERT_TRUE(agg.addFill(makeFill("100", "t1", 50000.0, 0.1), 10));
+    ASSERT_TRUE(agg.addFill(makeFill("100", "t2", 50100.0, 0.3), 20));
+
+    OrderFillTotals t;
+    ASSERT_TRUE(agg.getTotals("100", t));
+    ASSERT_EQ(t.fills, 2);
+    ASSERT_TRUE(std::fabs(t.filledSz - 0.4) < 1e-12);
+    ASSERT_TRUE(std::fabs(t.avgPx() - 50075.0) < 1e-6);
+    ASSERT_EQ((int)t.lastFillAt, 20);
+    ASSERT_FALSE(agg.getTotals("999", t));
+}
+
+TEST_CASE(duplicate_tid_is_dropped) {
+    FillAggregator agg;
+    ASSERT_TRUE(agg.addFill(makeFill("100", "t1", 50000.0, 0.1), 0));
+    ASSERT_FALSE(agg.addFill(makeFill("100", "t1", 50000.0, 0.1), 0));  // Snapshot replay
+    ASSERT_EQ(agg.duplicatesDropped(), 1LL);
+
+    OrderFillTotals t;
+    ASSERT_TRUE(agg.getTotals("100", t));
+    ASSERT_EQ(t.fills, 1);
+    ASSERT_TRUE(std::fabs(t.filledSz - 0.1) < 1e-12);
+}
+
+TEST_CASE(missing_tid_uses_fill_fields) {
+    FillAggregator agg;
+    ASSERT_TRUE(agg.addFill(makeFill("100", "", 50000.0, 0.1, 1), 0));
+    ASSERT_FALSE(agg.addFill(makeFill("100", "", 50000.0, 0.1, 1), 0));
+    ASSERT_TRUE(agg.addFill(makeFill("100", "", 50000.0, 0.1, 2), 0));  // Different time
+}
+
+TEST_CASE(only_changed_orders_are_reported) {
+    FillAggregator agg;
+    agg.addFill(makeFill("100", "t1", 50000.0, 0.1), 0);
+    agg.addFill(makeFill("200", "t2", 3000.0, 1.0), 0);
+    agg.addFill(makeFill("100", "t3", 50010.0, 0.1), 0);
+
+    auto changed = agg.takeChanged();
+    ASSERT_EQ((int)changed.size(), 2);            // Each oid once
+    ASSERT_STREQ(changed[0].oid.c_str(), "100");
+    ASSERT_EQ(changed[0].fills, 2);
+    ASSERT_STREQ(changed[1].oid.c_str(), "200");
+    ASSERT_TRUE(agg.takeChanged().empty());
+
+    agg.addFill(makeFill("200", "t2", 3000.0, 1.0), 0);   // Duplicate: no change
+    ASSERT_TRUE(agg.takeChanged().empty());
+
+    agg.addFill(makeFill("200", "t4", 3001.0, 0.5), 0);
+    changed = agg.takeChanged();
+    ASSERT_EQ((int)changed.size(), 1);
+    ASSERT_STREQ(changed[0].oid.c_str(), "200");
+}
+
+TEST_CASE(retired_order_ignores_late_fills) {
+    FillAggregator agg;
+    agg.addFill(makeFill("100", "t1", 50000.0, 0.1), 0);
+    agg.takeChanged();
+    agg.retire("100");
+    ASSERT_EQ((int)agg.activeOrders(), 0);
+
+    // A replay after retirement must not restart the totals at zero
+    ASSERT_FALSE(agg.addFill(makeFill("100", "t1", 50000.0, 0.1), 0));
+    ASSERT_FALSE(agg.addFill(makeFill("100", "t9", 50000.0, 0.1), 0));
+    ASSERT_TRUE(agg.takeChanged().empty());
+    ASSERT_EQ((int)agg.activeOrders(), 0);
+}
+
+TEST_CASE(retired_memory_is_bounded) {
+    FillAggregator agg(2);
+    agg.retire("1");
+    agg.retire("2");
+    agg.retire("3");   // Evicts "1"
+    ASSERT_TRUE(agg.addFill(makeFill("1", "a", 1.0, 1.0), 0));
+    ASSERT_FALSE(agg.addFill(makeFill("3", "b", 1.0, 1.0), 0));
+}
+
+TEST_CASE(retire_idle_keeps_recent_and_pending) {
+    FillAggregator agg;
+    agg.addFill(makeFill("old", "t1", 1.0, 1.0), 1000);
+    agg.addFill(makeFill("new", "t2", 1.0, 1.0), 9000);
+    agg.takeChanged();
+    agg.addFill(makeFill("pending", "t3", 1.0, 1.0), 1000);  // Not yet reported
+
+    ASSERT_EQ(agg.retireIdle(10000, 5000), 1);
+    ASSERT_EQ((int)agg.activeOrders(), 2);
+    OrderFillTotals t;
+    ASSERT_TRUE(agg.getTotals("old", t));       // Parked: totals kept
+    ASSERT_TRUE(agg.getTotals("new", t));
+    ASSERT_TRUE(agg.getTotals("pending", t));
+    ASSERT_EQ(agg.retireIdle(10000, 5000), 0);  // Already parked
+}
+
+TEST_CASE(fill_after_idle_retire_is_counted) {
+    // Resting GTC order: partial fill, nothing for longer than the idle
+    // window, then the next fill
+    FillAggregator agg;
+    ASSERT_TRUE(agg.addFill(makeFill("77", "t1", 100.0, 1.0, 1700000000000LL), 1000));
+    agg.takeChanged();
+    ASSERT_EQ(agg.retireIdle(700000, 600000), 1);
+
+    ASSERT_TRUE(agg.addFill(makeFill("77", "t2", 102.0, 1.0, 1700000700000LL), 700000));
+    auto changed = agg.takeChanged();
+    ASSERT_EQ((int)changed.size(), 1);
+    ASSERT_FLOAT_EQ_TOL(changed[0].filledSz, 2.0, 1e-12);      // Cumulative, not restarted
+    ASSERT_FLOAT_EQ_TOL(changed[0].avgPx(), 101.0, 1e-9);
+    ASSERT_EQ(changed[0].fills, 2);
+
+    // Reconnect snapshot replaying both fills: neither counts again
+    ASSERT_FALSE(agg.addFill(makeFill("77", "t1", 100.0, 1.0, 1700000000000LL), 700100));
+    ASSERT_FALSE(agg.addFill(makeFill("77", "t2", 102.0, 1.0, 1700000700000LL), 700100));
+    OrderFillTotals t;
+    ASSERT_TRUE(agg.getTotals("77", t));
+    ASSERT_FLOAT_EQ_TOL(t.filledSz, 2.0, 1e-12);
+}
+
+TEST_CASE(partial_fill_then_cancel_is_retired) {
+    FillAggregator agg;
+    ASSERT_TRUE(agg.addFill(makeFill("55", "t1", 100.0, 1.0), 1000));
+    agg.takeChanged();
+    agg.close("55");
+
+    // Fill still in flight when the cancel arrived is applied
+    ASSERT_TRUE(agg.addFill(makeFill("55", "t2", 100.0, 0.5), 2000));
+    ASSERT_EQ((int)agg.takeChanged().size(), 1);
+
+    ASSERT_EQ(agg.retireIdle(601000, 600000), 0);   // Not idle long enough
+    ASSERT_EQ(agg.retireIdle(602000, 600000), 1);
+    OrderFillTotals t;
+    ASSERT_FALSE(agg.getTotals("55", t));           // Entry freed, not parked
+    ASSERT_EQ((int)agg.activeOrders(), 0);
+    ASSERT_FALSE(agg.addFill(makeFill("55", "t1", 100.0, 1.0), 603000));  // Replay ignored
+}
+
+TEST_CASE(fill_after_cancel_of_unfilled_order_is_retired) {
+    // orderUpdates "canceled" overtakes the only userFills frame
+    FillAggregator agg;
+    agg.close("56");
+    ASSERT_TRUE(agg.addFill(makeFill("56", "t1", 100.0, 1.0), 1000));
+    agg.takeChanged();
+    ASSERT_EQ(agg.retireIdle(601000, 600000), 1);
+    OrderFillTotals t;
+    ASSERT_FALSE(agg.getTotals("56", t));
+}
+
+TEST_CASE(zero_size_and_missing_oid_ignored) {
+    FillAggregator agg;
+    ASSERT_FALSE(agg.addFill(makeFill("100", "t1", 50000.0, 0.0), 0));
+    ASSERT_FALSE(agg.addFill(makeFill("", "t2", 50000.0, 0.1), 0));
+    ASSERT_EQ((int)agg.activeOrders(), 0);
+}
+
+int main() {
+    printf("=== FillAggregator Unit Tests ===\n\n");
+
+    RUN_TEST(cumulative_size_and_vwap);
+    RUN_TEST(duplicate_tid_is_dropped);
+    RUN_TEST(missing_tid_uses_fill_fields);
+    RUN_TEST(only_changed_orders_are_reported);
+    RUN_TEST(retired_order_ignores_late_fills);
+    RUN_TEST(retired_memory_is_bounded);
+    RUN_TEST(retire_idle_keeps_recent_and_pending);
+    RUN_TEST(fill_after_idle_retire_is_counted);
+    RUN_TEST(partial_fill_then_cancel_is_retired);
+    RUN_TEST(fill_after_cancel_of_unfilled_order_is_retired);
+    RUN_TEST(zero_size_and_missing_oid_ignored);
+
+    return hl::test::printTestSummary();
+}
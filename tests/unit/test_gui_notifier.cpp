@@ -0,0 +1,150 @@
+//=============================================================================
+// test_gui_notifier.cpp - Unit tests for coalesced WM_APP+1 notifications
+//=============================================================================
+// Part of Hyperliquid Plugin for Zorro
+//
+// LAYER: Test
+// PURPOSE: One message in flight until acknowledged; the minimum interval
+//          holds posts back and tick() delivers the trailing one; an
+//          acknowledge covers updates already marked dirty; an unconsumed
+//          message re-arms after NOTIFY_REARM_MS; tradedOnly drops coins
+//          that are not watched; racing updaters post exactly once.
+//          Posts are counted through getStats() (the handle is fake).
+//=============================================================================
+
+#include "../test_framework.h"
+#include "ws_gui_notifier.h"
+#include <thread>
+#include <vector>
+
+using hl::ws::GuiNotifier;
+using hl::ws::GuiNotifyStats;
+
+static const HWND FAKE_WINDOW = (HWND)0x1234;
+
+TEST_CASE(no_window_posts_nothing) {
+    GuiNotifier n;
+    n.onUpdate(1);
+    n.tick();
+    GuiNotifyStats s = n.getStats();
+    ASSERT_EQ((int)s.updates, 0);
+    ASSERT_EQ((int)s.posted, 0);
+}
+
+TEST_CASE(one_message_in_flight_until_acknowledged) {
+    GuiNotifier n;
+    n.setWindow(FAKE_WINDOW);
+    for (int i = 0; i < 100; i++) n.onUpdate(1 + i % 5);
+    GuiNotifyStats s = n.getStats();
+    ASSERT_EQ((int)s.updates, 100);
+    ASSERT_EQ((int)s.posted, 1);
+    ASSERT_EQ((int)s.coalesced, 99);
+    ASSERT_TRUE(s.pending);
+
+    n.acknowledge();
+    n.acknowledge();                        // Nothing pending: not counted
+    ASSERT_EQ((int)n.getStats().acks, 1);
+    n.onUpdate(2);
+    ASSERT_EQ((int)n.getStats().posted, 2);
+}
+
+TEST_CASE(acknowledge_covers_dirty_updates) {
+    GuiNotifier n;
+    n.setWindow(FAKE_WINDOW);
+    n.onUpdate(1);
+    n.onUpdate(2);                          // Coalesced: quotes dirty
+    n.acknowledge();                        // Zorro reads every quote
+    n.tick();
+    ASSERT_EQ((int)n.getStats().posted, 1);
+    ASSERT_FALSE(n.getStats().pending);
+}
+
+TEST_CASE(min_interval_holds_then_tick_posts) {
+    GuiNotifier n;
+    n.setWindow(FAKE_WINDOW);
+    n.setMinInterval(50);
+    n.onUpdate(1);
+    n.acknowledge();
+    n.onUpdate(1);                          // Inside the interval
+    n.tick();
+    ASSERT_EQ((int)n.getStats().posted, 1);
+    ASSERT_EQ((int)n.getStats().coalesced, 1);
+
+    Sleep(70);
+    n.tick();                               // Trailing post for the held update
+    ASSERT_EQ((int)n.getStats().posted, 2);
+    n.acknowledge();
+    Sleep(70);
+    n.tick();                               // Not dirty: nothing to post
+    ASSERT_EQ((int)n.getStats().posted, 2);
+    ASSERT_EQ(n.getStats().minIntervalMs, 50);
+}
+
+TEST_CASE(unconsumed_message_rearms) {
+    GuiNotifier n;
+    n.setWindow(FAKE_WINDOW);
+    n.onUpdate(1);
+    n.onUpdate(1);
+    ASSERT_EQ((int)n.getStats().posted, 1);
+    Sleep(hl::config::NOTIFY_REARM_MS + 50);
+    n.tick();                               // Dirty and the message looks lost
+    GuiNotifyStats s = n.getStats();
+    ASSERT_EQ((int)s.posted, 2);
+    ASSERT_EQ((int)s.rearms, 1);
+    ASSERT_EQ((int)s.acks, 0);
+}
+
+TEST_CASE(traded_only_filters_unwatched_coins) {
+    GuiNotifier n;
+    n.setWindow(FAKE_WINDOW);
+    n.setTradedOnly(true);
+    n.onUpdate(5);
+    ASSERT_EQ((int)n.getStats().filtered, 1);
+    ASSERT_EQ((int)n.getStats().posted, 0);
+
+    n.watch(5, 1000);
+    ASSERT_TRUE(n.isWatched(5));
+    n.onUpdate(5);
+    ASSERT_EQ((int)n.getStats().posted, 1);
+
+    n.watch(6, 10);
+    Sleep(30);
+    ASSERT_FALSE(n.isWatched(6));           // Watch expired
+    n.watch(0, 1000);                       // Invalid ids ignored
+    n.watch((uint32_t)hl::config::SYMBOL_MAX_IDS, 1000);
+    ASSERT_FALSE(n.isWatched(0));
+    ASSERT_FALSE(n.isWatched((uint32_t)hl::config::SYMBOL_MAX_IDS));
+
+    n.setTradedOnly(false);
+    n.acknowledge();
+    n.onUpdate(7);
+    ASSERT_EQ((int)n.getStats().posted, 2);
+}
+
+TEST_CASE(racing_updaters_post_once) {
+    GuiNotifier n;
+    n.setWindow(FAKE_WINDOW);
+    const int THREADS = 4, PER_THREAD = 20000;
+    std::vector<std::thread> ws;
+    for (int t = 0; t < THREADS; t++)
+        ws.emplace_back([&n, t]() { for (int i = 0; i < PER_THREAD; i++) n.onUpdate(1 + t); });
+    for (auto& t : ws) t.join();
+    GuiNotifyStats s = n.getStats();
+    ASSERT_EQ((int)s.updates, THREADS * PER_THREAD);
+    ASSERT_EQ((int)s.posted, 1);
+    ASSERT_EQ((int)(s.posted + s.coalesced), THREADS * PER_THREAD);
+}
+
+int main() {
+    printf("=== GUI Notifier Tests ===\n\n");
+
+    RUN_TEST(no_window_posts_nothing);
+    RUN_TEST(one_message_in_flight_until_acknowledged);
+    RUN_TEST(acknowledge_covers_dirty_updates);
+    RUN_TEST(min_interval_holds_then_tick_posts);
+    RUN_TEST(unconsumed_message_rearms);
+    RUN_TEST(traded_only_filters_unwatched_coins);
+    RUN_TEST(racing_updaters_post_once);
+
+    return hl::test::printTestSummary();
+}
@@ -0,0 +1,155 @@
+//=============================================================================
+// test_json_pool.cpp - Unit tests for json::parse (per-thread yyjson pool)
+//=============================================================================
+// Part of Hyperliquid Plugin for Zorro
+//
+// LAYER: Test
+// PURPOSE: Steady-state parses stay in the pool (no heap reads, no grows),
+//          nested parses fall back once and then fit, oversized documents
+//          and invalid JSON, separate pools per thread released on exit.
+//=============================================================================
+
+#include "../test_framework.h"
+#include "json_pool.h"
+#include "json_helpers.h"
+#include "hl_config.h"
+#include <string>
+#include <thread>
+
+using hl::json::PoolStats;
+using hl::json::getPoolStats;
+
+static const char* FRAME =
+    "{\"channel\":\"l2Book\",\"data\":{\"coin\":\"BTC\",\"time\":1700000000000,"
+    "\"levels\":[[{\"px\":\"97000.5\",\"sz\":\"1.5\",\"n\":3}],"
+    "[{\"px\":\"97001.0\",\"sz\":\"0.25\",\"n\":1}]]}}";
+
+static std::string intArray(int count) {
+    std::string s = "[";
+    for (int i = 0; i < count; i++) {
+        if (i) s += ",";
+        s += std::to_string(i % 10);
+    }
+    s += "]";
+    return s;
+}
+
+// Runs fn on a fresh thread (fresh, empty pool)
+template <class Fn>
+static void onNewThread(Fn fn) {
+    std::thread t(fn);
+    t.join();
+}
+
+TEST_CASE(steady_state_stays_pooled) {
+    size_t len = strlen(FRAME);
+    yyjson_doc* warm = hl::json::parse(FRAME, len);
+    ASSERT_TRUE(warm != nullptr);
+    yyjson_doc_free(warm);
+
+    PoolStats s0 = getPoolStats();
+    int ok = 0;
+    for (int i = 0; i < 1000; i++) {
+        yyjson_doc* doc = hl::json::parse(FRAME, len);
+        yyjson_val* data = hl::json::getObject(yyjson_doc_get_root(doc), "data");
+        if (strcmp(hl::json::getStringPtr(data, "coin"), "BTC") == 0) ok++;
+        yyjson_doc_free(doc);
+    }
+    PoolStats s1 = getPoolStats();
+
+    ASSERT_EQ(ok, 1000);
+    ASSERT_EQ(s1.pooled - s0.pooled, 1000LL);
+    ASSERT_EQ(s1.heap - s0.heap, 0LL);
+    ASSERT_EQ(s1.grows - s0.grows, 0LL);
+}
+
+TEST_CASE(invalid_json_returns_null_without_heap) {
+    PoolStats s0 = getPoolStats();
+    ASSERT_TRUE(hl::json::parse("{\"coin\":", 8) == nullptr);
+    ASSERT_TRUE(hl::json::parse("", 0) == nullptr);
+    ASSERT_TRUE(hl::json::parse(nullptr, 0) == nullptr);
+    PoolStats s1 = getPoolStats();
+    ASSERT_EQ(s1.heap - s0.heap, 0LL);
+}
+
+TEST_CASE(oversized_document_uses_heap) {
+    // ~13x len exceeds JSON_POOL_MAX_BYTES
+    std::string big = intArray(hl::config::JSON_POOL_MAX_BYTES / 16);
+    PoolStats s0 = getPoolStats();
+    yyjson_doc* doc = hl::json::parse(big.c_str(), big.size());
+    PoolStats s1 = getPoolStats();
+
+    ASSERT_TRUE(doc != nullptr);
+    ASSERT_EQ(yyjson_arr_size(yyjson_doc_get_root(doc)),
+              (size_t)(hl::config::JSON_POOL_MAX_BYTES / 16));
+    yyjson_doc_free(doc);
+    ASSERT_EQ(s1.heap - s0.heap, 1LL);
+    ASSERT_EQ(s1.grows - s0.grows, 0LL);
+}
+
+TEST_CASE(nested_parse_falls_back_once_then_fits) {
+    // WS thread: handleMessage keeps its document while a parser reads again
+    std::string inner = intArray(10000);
+    long long heap[3] = {0, 0, 0};
+    long long grows[3] = {0, 0, 0};
+    bool valid = true;
+
+    onNewThread([&]() {
+        for (int round = 0; round < 3; round++) {
+            PoolStats s0 = getPoolStats();
+            yyjson_doc* outer = hl::json::parse(FRAME, strlen(FRAME));
+            yyjson_doc* nested = hl::json::parse(inner.c_str(), inner.size());
+            if (!outer || !nested || yyjson_arr_size(yyjson_doc_get_root(nested)) != 10000)
+                valid = false;
+            yyjson_doc_free(nested);
+            yyjson_doc_free(outer);
+            PoolStats s1 = getPoolStats();
+            heap[round] = s1.heap - s0.heap;
+            grows[round] = s1.grows - s0.grows;
+        }
+    });
+
+    ASSERT_TRUE(valid);
+    ASSERT_EQ(heap[0], 1LL);     // First pool too small for both
+    ASSERT_EQ(grows[0], 1LL);
+    ASSERT_EQ(heap[1], 0LL);     // Grown before the next outer parse
+    ASSERT_EQ(grows[1], 1LL);
+    ASSERT_EQ(heap[2], 0LL);     // Steady state
+    ASSERT_EQ(grows[2], 0LL);
+}
+
+TEST_CASE(threads_have_separate_pools) {
+    PoolStats s0 = getPoolStats();
+    int okA = 0, okB = 0;
+    auto work = [](int& ok) {
+        for (int i = 0; i < 2000; i++) {
+            yyjson_doc* doc = hl::json::parse(FRAME, strlen(FRAME));
+            yyjson_val* data = hl::json::getObject(yyjson_doc_get_root(doc), "data");
+            if (hl::json::getInt64(data, "time") == 1700000000000LL) ok++;
+            yyjson_doc_free(doc);
+        }
+    };
+    std::thread a(work, std::ref(okA));
+    std::thread b(work, std::ref(okB));
+    a.join();
+    b.join();
+    PoolStats s1 = getPoolStats();
+
+    ASSERT_EQ(okA, 2000);
+    ASSERT_EQ(okB, 2000);
+    ASSERT_EQ(s1.grows - s0.grows, 2LL);         // One pool per thread
+    ASSERT_EQ(s1.heap - s0.heap, 0LL);
+    ASSERT_EQ(s1.bytesReserved, s0.bytesReserved);   // Released on thread exit
+}
+
+int main() {
+    printf("=== JSON Parse Pool Unit Tests ===\n\n");
+
+    RUN_TEST(steady_state_stays_pooled);
+    RUN_TEST(invalid_json_returns_null_without_heap);
+    RUN_TEST(oversized_document_uses_heap);
+    RUN_TEST(nested_parse_falls_back_once_then_fits);
+    RUN_TEST(threads_have_separate_pools);
+
+    return hl::test::printTestSummary();
+}
@@ -0,0 +1,150 @@
+//=============================================================================
+// test_latency.cpp - Unit tests for the per-stage latency histograms
+//=============================================================================
+// Part of Hyperliquid Plugin for Zorro
+//
+// LAYER: Test
+// PURPOSE: Samples below 64 ns are exact and larger ones within the bucket
+//          resolution; p50/p90/p99 follow the distribution and max is exact;
+//          slabs of many threads (including overflow threads) merge without
+//          losing samples; FirstFill is recorded once per sent order;
+//          the CSV export and reset() work.
+//=============================================================================
+
+#include "../test_framework.h"
+#include "hl_latency.h"
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace hl::lat;
+
+static StageSummary stage(Stage s) {
+    StageSummary rows[(int)Stage::Count];
+    summarize(rows, (int)Stage::Count);
+    return rows[(int)s];
+}
+
+static bool within(double actual, double expected, double relTol) {
+    return std::fabs(actual - expected) <= expected * relTol;
+}
+
+TEST_CASE(small_samples_are_exact) {
+    reset();
+    for (int i = 0; i < 10; i++) recordNs(Stage::Parse, 40);
+    StageSummary s = stage(Stage::Parse);
+    ASSERT_EQ((int)s.count, 10);
+    ASSERT_FLOAT_EQ(s.p50Us, 0.040);
+    ASSERT_FLOAT_EQ(s.p99Us, 0.040);
+    ASSERT_FLOAT_EQ(s.maxUs, 0.040);
+    ASSERT_STREQ(s.name, "Parse");
+}
+
+TEST_CASE(percentiles_follow_distribution) {
+    reset();
+    for (int i = 1; i <= 1000; i++) recordNs(Stage::Ack, (uint64_t)i * 1000);   // 1..1000 us
+    StageSummary s = stage(Stage::Ack);
+    ASSERT_EQ((int)s.count, 1000);
+    ASSERT_TRUE(within(s.p50Us, 500.0, 0.035));
+    ASSERT_TRUE(within(s.p90Us, 900.0, 0.035));
+    ASSERT_TRUE(within(s.p99Us, 990.0, 0.035));
+    ASSERT_FLOAT_EQ(s.maxUs, 1000.0);
+    ASSERT_EQ((int)stage(Stage::Sign).count, 0);     // Other stages untouched
+}
+
+TEST_CASE(huge_sample_clamps_to_last_bucket) {
+    reset();
+    recordNs(Stage::Send, 1ULL << 50);
+    StageSummary s = stage(Stage::Send);
+    ASSERT_EQ((int)s.count, 1);
+    ASSERT_FLOAT_EQ(s.maxUs, (double)(1ULL << 50) / 1000.0);
+    ASSERT_TRUE(s.p99Us <= s.maxUs);
+}
+
+TEST_CASE(threads_merge_including_overflow) {
+    reset();
+    const int THREADS = hl::config::LATENCY_MAX_THREADS + 4, PER_THREAD = 5000;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < THREADS; t++)
+        workers.emplace_back([]() { for (int i = 0; i < PER_THREAD; i++) recordNs(Stage::WsReceive, 1000 + i); });
+    for (auto& w : workers) w.join();
+    StageSummary s = stage(Stage::WsReceive);
+    ASSERT_EQ((int)s.count, THREADS * PER_THREAD);
+    ASSERT_TRUE(within(s.maxUs, (1000 + PER_THREAD - 1) / 1000.0, 0.001));
+}
+
+TEST_CASE(first_fill_recorded_once_per_order) {
+    reset();
+    orderFilled(5);                         // Never sent: ignored
+    orderSent(5);
+    orderFilled(5);
+    orderFilled(5);                         // Later fills: ignored
+    ASSERT_EQ((int)stage(Stage::FirstFill).count, 1);
+
+    const int slots = hl::config::LATENCY_ORDER_SLOTS;
+    orderSent(7);
+    orderSent(7 + slots);                   // Same slot: the older order is forgotten
+    orderFilled(7);
+    ASSERT_EQ((int)stage(Stage::FirstFill).count, 1);
+    orderFilled(7 + slots);
+    ASSERT_EQ((int)stage(Stage::FirstFill).count, 2);
+}
+
+TEST_CASE(macros_time_real_work) {
+    reset();
+    {
+        HL_LAT_SCOPE(BrokerBuy);
+        HL_LAT_BEGIN(t0);
+        Sleep(2);
+        HL_LAT_END(Sign, t0);
+    }
+    uint64_t a = now();
+    uint64_t b = now();
+    HL_LAT_SPAN(Serialize, a, b);
+    ASSERT_TRUE(compiledIn());
+    ASSERT_EQ((int)stage(Stage::BrokerBuy).count, 1);
+    ASSERT_TRUE(stage(Stage::Sign).p50Us >= 1000.0);
+    ASSERT_EQ((int)stage(Stage::Serialize).count, 1);
+}
+
+TEST_CASE(csv_export_and_reset) {
+    reset();
+    recordNs(Stage::Eip712Hash, 2500);
+    char path[MAX_PATH];
+    sprintf_s(path, "latency_test_%lu.csv", (unsigned long)GetCurrentProcessId());
+    ASSERT_TRUE(writeCsv(path));
+
+    FILE* f = nullptr;
+    ASSERT_EQ(fopen_s(&f, path, "r"), 0);
+    char line[256];
+    int lines = 0;
+    std::string hash;
+    while (fgets(line, sizeof(line), f)) {
+        if (strncmp(line, "Eip712Hash,", 11) == 0) hash = line;
+        lines++;
+    }
+    fclose(f);
+    remove(path);
+    ASSERT_EQ(lines, 1 + (int)Stage::Count);
+    ASSERT_TRUE(hash.find("Eip712Hash,1,") == 0);
+
+    reset();
+    ASSERT_EQ((int)stage(Stage::Eip712Hash).count, 0);
+    ASSERT_FALSE(writeCsv(""));
+}
+
+int main() {
+    printf("=== Latency Histogram Tests ===\n\n");
+
+    RUN_TEST(small_samples_are_exact);
+    RUN_TEST(percentiles_follow_distribution);
+    RUN_TEST(huge_sample_clamps_to_last_bucket);
+    RUN_TEST(threads_merge_including_overflow);
+    RUN_TEST(first_fill_recorded_once_per_order);
+    RUN_TEST(macros_time_real_work);
+    RUN_TEST(csv_export_and_reset);
+
+    return hl::test::printTestSummary();
+}
@@ -0,0 +1,194 @@
+//=============================================================================
+// test_log_ring.cpp - Unit tests for the deferred logging ring
+//=============================================================================
+// Part of Hyperliquid Plugin for Zorro
+//
+// LAYER: Test
+// PURPOSE: Off the drain thread messages are stored, not delivered; drain()
+//          delivers them in order with the same text snprintf would give;
+//          string arguments are copied at push; a full ring drops and the
+//          next drain reports it; producers racing a drain lose nothing
+//          beyond the counted drops; Logger::logf keeps order across both paths.
+//=============================================================================
+
+#include "../test_framework.h"
+#include "hl_log_ring.h"
+#include "hl_globals.h"
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using hl::g_logRing;
+
+static std::vector<std::string> s_lines;
+
+static int collect(const char* msg) {
+    s_lines.push_back(msg);
+    return 0;
+}
+
+// Each test starts empty with this thread draining
+static void freshRing() {
+    g_logRing.reset();
+    g_logRing.setDrainThread(GetCurrentThreadId());
+    s_lines.clear();
+}
+
+TEST_CASE(no_drain_thread_logs_synchronously) {
+    g_logRing.reset();
+    g_logRing.setDrainThread(0);
+    s_lines.clear();
+    std::thread t([]() { hl::logPrintf(collect, "WS: l2Book %s bid=%.4f", "BTC", 97000.5); });
+    t.join();
+    ASSERT_EQ((int)s_lines.size(), 1);
+    ASSERT_STREQ(s_lines[0].c_str(), "WS: l2Book BTC bid=97000.5000");
+    ASSERT_EQ((int)g_logRing.getStats().pushed, 0);
+}
+
+TEST_CASE(other_threads_defer_until_drain) {
+    freshRing();
+    std::thread t([]() {
+        for (int i = 0; i < 3; i++) hl::logPrintf(collect, "WS[%d]: msg %d", 1, i);
+    });
+    t.join();
+    ASSERT_EQ((int)s_lines.size(), 0);
+    ASSERT_EQ((int)g_logRing.getStats().pushed, 3);
+
+    ASSERT_EQ(g_logRing.drain(), 3);
+    ASSERT_EQ((int)s_lines.size(), 3);
+    ASSERT_STREQ(s_lines[0].c_str(), "WS[1]: msg 0");
+    ASSERT_STREQ(s_lines[2].c_str(), "WS[1]: msg 2");
+    ASSERT_EQ(g_logRing.drain(), 0);
+}
+
+TEST_CASE(drained_text_matches_snprintf) {
+    freshRing();
+    const char* nullStr = nullptr;
+    std::thread t([&]() {
+        hl::logPrintf(collect, "%d|%5.2f|%-6s|%u|%lld|%x|%c|%%|%.3s|%*d",
+                      -42, 3.14159, "ab", 7u, 1234567890123LL, 255, 'Z', "abcdef", 4, 9);
+        hl::logPrintf(collect, "%zu bytes: %.120s", (size_t)17, "payload");
+        hl::logPrintf(collect, "pid=%lu ok=%d", (unsigned long)4242, true);
+        hl::logPrintf(collect, "null=%s", nullStr);
+        hl::logPrintf(collect, "int as float %.2f, long long as %%d %d", 5, 1LL << 40);
+        hl::logPrintf(collect, "missing %d %s");
+    });
+    t.join();
+    g_logRing.drain();
+    ASSERT_EQ((int)s_lines.size(), 6);
+    ASSERT_STREQ(s_lines[0].c_str(), "-42| 3.14|ab    |7|1234567890123|ff|Z|%|abc|   9");
+    ASSERT_STREQ(s_lines[1].c_str(), "17 bytes: payload");
+    ASSERT_STREQ(s_lines[2].c_str(), "pid=4242 ok=1");
+    ASSERT_STREQ(s_lines[3].c_str(), "null=(null)");
+    ASSERT_STREQ(s_lines[4].c_str(), "int as float 5.00, long long as %d 1099511627776");
+    ASSERT_STREQ(s_lines[5].c_str(), "missing <?> <?>");
+}
+
+TEST_CASE(string_arguments_are_copied_at_push) {
+    freshRing();
+    std::thread t([]() {
+        char coin[16];
+        strcpy_s(coin, "ETH");
+        hl::logPrintf(collect, "coin=%s", coin);
+        strcpy_s(coin, "XXX");                  // Buffer reused before the drain
+        std::string big(2000, 'x');
+        hl::logPrintf(collect, "%s", big.c_str());
+    });
+    t.join();
+    g_logRing.drain();
+    ASSERT_EQ((int)s_lines.size(), 2);
+    ASSERT_STREQ(s_lines[0].c_str(), "coin=ETH");
+    ASSERT_TRUE(s_lines[1].size() > 300);           // Truncated to the record's text
+    ASSERT_TRUE(s_lines[1].size() < 2000);
+}
+
+TEST_CASE(full_ring_drops_and_reports) {
+    freshRing();
+    std::thread t([]() {
+        for (int i = 0; i < hl::config::LOG_RING_CAPACITY + 5; i++)
+            hl::logPrintf(collect, "n=%d", i);
+    });
+    t.join();
+    hl::LogRingStats s = g_logRing.getStats();
+    ASSERT_EQ((int)s.pushed, hl::config::LOG_RING_CAPACITY);
+    ASSERT_EQ((int)s.dropped, 5);
+
+    ASSERT_EQ(g_logRing.drain(), hl::config::LOG_RING_CAPACITY);
+    ASSERT_EQ((int)s_lines.size(), hl::config::LOG_RING_CAPACITY + 1);
+    ASSERT_STREQ(s_lines.back().c_str(), "LOG: 5 message(s) dropped (ring full)");
+    ASSERT_EQ(g_logRing.getStats().highWater, hl::config::LOG_RING_CAPACITY);
+
+    // Reported once; the ring is reusable after a full lap
+    s_lines.clear();
+    std::thread t2([]() { hl::logPrintf(collect, "after"); });
+    t2.join();
+    g_logRing.drain();
+    ASSERT_EQ((int)s_lines.size(), 1);
+    ASSERT_STREQ(s_lines[0].c_str(), "after");
+}
+
+TEST_CASE(producers_racing_drain_keep_per_thread_order) {
+    freshRing();
+    const int THREADS = 4, PER_THREAD = 20000;
+    std::atomic<int> done(0);
+    std::vector<std::thread> producers;
+    for (int t = 0; t < THREADS; t++) {
+        producers.emplace_back([t, &done]() {
+            for (int i = 0; i < PER_THREAD; i++) hl::logPrintf(collect, "%d %d", t, i);
+            done++;
+        });
+    }
+    while (done.load() < THREADS) g_logRing.drain();
+    for (auto& p : producers) p.join();
+    g_logRing.drain();
+
+    int last[THREADS] = { -1, -1, -1, -1 };
+    int delivered = 0;
+    bool ordered = true;
+    for (const auto& line : s_lines) {
+        int t = -1, i = -1;
+        if (sscanf_s(line.c_str(), "%d %d", &t, &i) != 2) continue;   // Drop report
+        if (i <= last[t]) ordered = false;
+        last[t] = i;
+        delivered++;
+    }
+    hl::LogRingStats s = g_logRing.getStats();
+    ASSERT_TRUE(ordered);
+    ASSERT_EQ((long long)delivered + s.dropped, (long long)THREADS * PER_THREAD);
+    ASSERT_EQ((long long)delivered, s.drained);
+}
+
+TEST_CASE(logger_drains_before_its_own_message) {
+    freshRing();
+    hl::g_logger.callback = collect;
+    hl::g_logger.level = 2;
+    std::thread t([]() {
+        hl::g_logger.logf(2, "worker %d", 1);
+        hl::g_logger.log(2, "worker text");
+        hl::g_logger.logf(3, "filtered %d", 2);     // Above level: never stored
+    });
+    t.join();
+    ASSERT_EQ((int)s_lines.size(), 0);
+    hl::g_logger.logf(1, "zorro %s", "thread");
+    ASSERT_EQ((int)s_lines.size(), 3);
+    ASSERT_STREQ(s_lines[0].c_str(), "worker 1");
+    ASSERT_STREQ(s_lines[1].c_str(), "worker text");
+    ASSERT_STREQ(s_lines[2].c_str(), "zorro thread");
+    hl::g_logger.callback = nullptr;
+    g_logRing.setDrainThread(0);
+}
+
+int main() {
+    printf("=== Log Ring Tests ===\n\n");
+
+    RUN_TEST(no_drain_thread_logs_synchronously);
+    RUN_TEST(other_threads_defer_until_drain);
+    RUN_TEST(drained_text_matches_snprintf);
+    RUN_TEST(string_arguments_are_copied_at_push);
+    RUN_TEST(full_ring_drops_and_reports);
+    RUN_TEST(producers_racing_drain_keep_per_thread_order);
+    RUN_TEST(logger_drains_before_its_own_message);
+
+    return hl::test::printTestSummary();
+}
@@ -0,0 +1,213 @@
+//=============================================================================
+// test_mock_exchange.cpp - Unit tests for the local mock exchange engine
+//=============================================================================
+// Part of Hyperliquid Plugin for Zorro
+//
+// LAYER: Test
+// PURPOSE: Orders signed by the plugin's own EIP-712/secp256k1 path are
+//          accepted, filled at the touch and reported as orderUpdates and
+//          userFills; resting orders fill when the mid moves through them;
+//          ALO/IOC rejections match the exchange wording;
+//          duplicate and out-of-window nonces, foreign signers and bodies
+//          altered after signing are refused; cancel and the /info answers
+//          the services parse (meta, allMids, clearinghouseState,
+//          orderStatus) have the exchange's shape.
+//=============================================================================
+
+#include "../test_framework.h"
+#include "mocks/mock_exchange.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace hl::test;
+
+// Hardhat/Ganache account #0 (public test key)
+static const char* KEY = "0xac0974bec39a17e36ba4a6b4d238ff944bacb478cbed5efcae784d7bf4f2ff80";
+static const char* ADDR = "0xf39fd6e51aad88f6f4ce6ab8827279cfffb92266";
+
+static MockExchangeConfig makeConfig() {
+    MockExchangeConfig cfg;
+    cfg.coins.push_back({ "BTC", 50000.0, 5 });
+    cfg.coins.push_back({ "ETH", 3000.0, 4 });
+    cfg.user = ADDR;
+    cfg.signer = ADDR;
+    cfg.volatility = 0.0;
+    return cfg;
+}
+
+static uint64_t s_nonce = 0;
+
+static uint64_t nextNonce() {
+    uint64_t now = MockExchange::nowMs();
+    s_nonce = s_nonce < now ? now : s_nonce + 1;
+    return s_nonce;
+}
+
+// Signed order body as TradingService::placeOrder builds it
+static std::string orderBody(int asset, bool isBuy, const char* px, const char* sz, const char* tif,
+                             const char* cloid, uint64_t nonce, const char* signedPx = nullptr) {
+    hl::eip712::OrderAction a;
+    a.asset = asset;
+    a.isBuy = isBuy;
+    a.price = signedPx ? signedPx : px;
+    a.size = sz;
+    a.reduceOnly = false;
+    a.orderType = tif;
+    a.cloid = cloid;
+    hl::eip712::ByteArray hash = hl::eip712::hashOrderForSigning(a, false, nonce);
+    hl::crypto::Signature sig;
+    hl::crypto::signHash(hash.data(), KEY, sig);
+    char body[1024];
+    sprintf_s(body, "{\"action\":{\"type\":\"order\",\"orders\":[{\"a\":%d,\"b\":%s,\"p\":\"%s\","
+              "\"s\":\"%s\",\"r\":false,\"t\":{\"limit\":{\"tif\":\"%s\"}},\"c\":\"%s\"}],"
+              "\"grouping\":\"na\"},\"nonce\":%llu,\"signature\":%s,\"vaultAddress\":null,"
+              "\"expiresAfter\":null}", asset, isBuy ? "true" : "false", px, sz, tif, cloid,
+              (unsigned long long)nonce, sig.toJson().c_str());
+    return body;
+}
+
+static std::string cancelBody(int asset, uint64_t oid, uint64_t nonce) {
+    hl::eip712::CancelAction c;
+    c.asset = asset;
+    c.orderId = oid;
+    hl::eip712::ByteArray hash = hl::eip712::hashCancelForSigning(c, false, nonce);
+    hl::crypto::Signature sig;
+    hl::crypto::signHash(hash.data(), KEY, sig);
+    char body[512];
+    sprintf_s(body, "{\"action\":{\"type\":\"cancel\",\"cancels\":[{\"a\":%d,\"o\":%llu}]},"
+              "\"nonce\":%llu,\"signature\":%s,\"vaultAddress\":null,\"expiresAfter\":null}",
+              asset, (unsigned long long)oid, (unsigned long long)nonce, sig.toJson().c_str());
+    return body;
+}
+
+static bool contains(const std::string& text, const char* needle) {
+    return text.find(needle) != std::string::npos;
+}
+
+static uint64_t restingOid(const std::string& body) {
+    size_t p = body.find("\"resting\":{\"oid\":");
+    return p == std::string::npos ? 0 : strtoull(body.c_str() + p + 17, nullptr, 10);
+}
+
+TEST_CASE(signed_ioc_fills_at_touch) {
+    MockExchange ex(makeConfig());
+    std::vector<std::string> channels;
+    ex.setEventSink([&](const char* channel, const std::string&) { channels.push_back(channel); });
+
+    MockReply r = ex.exchange(orderBody(0, true, "50100", "0.01", "Ioc",
+                                        "0x00000000000000000000000000000001", nextNonce()));
+    ASSERT_EQ(r.status, 200);
+    ASSERT_TRUE(contains(r.body, "\"status\":\"ok\""));
+    ASSERT_TRUE(contains(r.body, "\"filled\":{\"totalSz\":\"0.01\",\"avgPx\":\"50002.5\""));
+    ASSERT_EQ((int)channels.size(), 2);
+    ASSERT_STREQ(channels[0].c_str(), "userFills");
+    ASSERT_STREQ(channels[1].c_str(), "orderUpdates");
+
+    std::string state = ex.clearinghouseFrame();
+    ASSERT_TRUE(contains(state, "\"coin\":\"BTC\",\"szi\":\"0.01\""));
+    ASSERT_EQ((int)ex.stats().fills, 1);
+}
+
+TEST_CASE(resting_order_fills_when_mid_moves) {
+    MockExchange ex(makeConfig());
+    const char* cloid = "0x00000000000000000000000000000002";
+    MockReply r = ex.exchange(orderBody(1, true, "2990", "0.5", "Gtc", cloid, nextNonce()));
+    ASSERT_TRUE(contains(r.body, "\"resting\":{\"oid\":"));
+    ASSERT_TRUE(contains(ex.openOrdersFrame(), "\"limitPx\":\"2990.0\""));
+
+    std::string query = std::string("{\"type\":\"orderStatus\",\"user\":\"") + ADDR +
+                        "\",\"oid\":\"" + cloid + "\"}";
+    ASSERT_TRUE(contains(ex.info(query).body, "\"status\":\"open\""));
+
+    ex.setMid("ETH", 2989.0);                   // Ask 2989.15 <= 2990
+    ASSERT_TRUE(contains(ex.info(query).body, "\"status\":\"filled\""));
+    ASSERT_FALSE(contains(ex.openOrdersFrame(), "2990"));
+}
+
+TEST_CASE(alo_and_ioc_rejections) {
+    MockExchange ex(makeConfig());
+    MockReply r = ex.exchange(orderBody(0, true, "50100", "0.01", "Alo",
+                                        "0x00000000000000000000000000000003", nextNonce()));
+    ASSERT_TRUE(contains(r.body, "Post only order would have immediately matched"));
+    r = ex.exchange(orderBody(0, true, "49000", "0.01", "Ioc",
+                              "0x00000000000000000000000000000004", nextNonce()));
+    ASSERT_TRUE(contains(r.body, "could not immediately match"));
+    ASSERT_EQ((int)ex.stats().rejected, 2);
+    ASSERT_EQ((int)ex.stats().orders, 0);
+}
+
+TEST_CASE(nonce_rules) {
+    MockExchange ex(makeConfig());
+    uint64_t n = nextNonce();
+    std::string body = orderBody(0, true, "49000", "0.01", "Gtc", "0x00000000000000000000000000000005", n);
+    ASSERT_TRUE(contains(ex.exchange(body).body, "\"resting\""));
+    ASSERT_TRUE(contains(ex.exchange(body).body, "Invalid nonce: duplicate nonce"));
+
+    uint64_t stale = MockExchange::nowMs() - 3ull * 86400000;
+    MockReply r = ex.exchange(orderBody(0, true, "49000", "0.01", "Gtc",
+                                        "0x00000000000000000000000000000006", stale));
+    ASSERT_TRUE(contains(r.body, "nonce out of range"));
+    ASSERT_EQ((int)ex.stats().badNonces, 2);
+}
+
+TEST_CASE(foreign_signer_and_altered_body_rejected) {
+    MockExchangeConfig cfg = makeConfig();
+    cfg.signer = "0x70997970c51812dc3a010c7d01b50e0d17dc79c8";   // Hardhat account #1
+    MockExchange other(cfg);
+    MockReply r = other.exchange(orderBody(0, true, "49000", "0.01", "Gtc",
+                                           "0x00000000000000000000000000000007", nextNonce()));
+    ASSERT_TRUE(contains(r.body, "\"status\":\"err\""));
+    ASSERT_TRUE(contains(r.body, "does not exist"));
+
+    // Price changed after signing: recovers some other address
+    MockExchange ex(makeConfig());
+    r = ex.exchange(orderBody(0, true, "49000", "0.01", "Gtc",
+                              "0x00000000000000000000000000000008", nextNonce(), "48000"));
+    ASSERT_TRUE(contains(r.body, "\"status\":\"err\""));
+    ASSERT_EQ((int)ex.stats().badSignatures, 1);
+    ASSERT_EQ((int)ex.stats().orders, 0);
+}
+
+TEST_CASE(cancel_resting_order) {
+    MockExchange ex(makeConfig());
+    MockReply r = ex.exchange(orderBody(0, false, "51000", "0.02", "Gtc",
+                                        "0x00000000000000000000000000000009", nextNonce()));
+    uint64_t oid = restingOid(r.body);
+    ASSERT_TRUE(oid != 0);
+    r = ex.exchange(cancelBody(0, oid, nextNonce()));
+    ASSERT_TRUE(contains(r.body, "\"statuses\":[\"success\"]"));
+    r = ex.exchange(cancelBody(0, oid, nextNonce()));
+    ASSERT_TRUE(contains(r.body, "already canceled, or filled"));
+    ASSERT_EQ((int)ex.stats().cancels, 1);
+}
+
+TEST_CASE(info_shapes) {
+    MockExchange ex(makeConfig());
+    MockReply r = ex.info("{\"type\":\"meta\"}");
+    ASSERT_EQ(r.status, 200);
+    ASSERT_TRUE(contains(r.body, "{\"universe\":[{\"name\":\"BTC\",\"szDecimals\":5"));
+    ASSERT_TRUE(contains(ex.info("{\"type\":\"allMids\"}").body, "\"ETH\":\"3000.0\""));
+    ASSERT_TRUE(contains(ex.info("{\"type\":\"l2Book\",\"coin\":\"BTC\"}").body, "\"levels\":[[{\"px\":"));
+    ASSERT_TRUE(contains(ex.info("{\"type\":\"clearinghouseState\",\"user\":\"0x1\"}").body,
+                         "\"marginSummary\":{\"accountValue\":\"100000.0\""));
+    ASSERT_TRUE(contains(ex.info("{\"type\":\"orderStatus\",\"user\":\"0x1\",\"oid\":42}").body,
+                         "unknownOid"));
+    ASSERT_EQ(ex.info("{\"type\":\"noSuchQuery\"}").status, 422);
+    ASSERT_EQ(ex.info("not json").status, 422);
+}
+
+int main() {
+    printf("=== Mock Exchange Tests ===\n\n");
+
+    RUN_TEST(signed_ioc_fills_at_touch);
+    RUN_TEST(resting_order_fills_when_mid_moves);
+    RUN_TEST(alo_and_ioc_rejections);
+    RUN_TEST(nonce_rules);
+    RUN_TEST(foreign_signer_and_altered_body_rejected);
+    RUN_TEST(cancel_resting_order);
+    RUN_TEST(info_shapes);
+
+    hl::crypto::cleanup();
+    return hl::test::printTestSummary();
+}
@@ -0,0 +1,460 @@
+//=============================================================================
+// test_order_sync.cpp - Push-driven order state and batched reconciliation
+//=============================================================================
+// LAYER: Test | TESTS: hl_order_sync, TradingState::applyOrderUpdate
+//
+// Tests:
+//   1. Exchange status mapping and both order-list response formats
+//   2. Order state machine: monotonic fills, absorbing terminal states,
+//      userFills average not overwritten by orderUpdates limit price
+//   3. Reconciliation: no HTTP while the feed is live and the epoch matches,
+//      one batched query after an epoch gap, staleness polling with the feed
+//      down, PENDING_ resolution / cancellation, historical fills, per-dex
+//      queries and throttling
+//
+// hl::http::infoPost / infoPostPerpDex are stubbed below with canned
+// responses and a call log.
+//=============================================================================
+
+#include "../test_framework.h"
+#include "../../src/foundation/hl_globals.h"
+#include "../../src/services/hl_order_sync.h"
+#include "../../src/transport/hl_http.h"
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace hl::test;
+using namespace hl;
+
+//=============================================================================
+// HTTP STUB
+//=============================================================================
+
+namespace {
+
+std::map<std::string, std::string> s_openByDex;     // dex -> frontendOpenOrders body
+std::string s_history = "[]";
+std::vector<std::string> s_calls;                   // "open:<dex>" / "history"
+bool s_failAll = false;
+
+http::Response reply(const std::string& body) {
+    http::Response r;
+    r.statusCode = s_failAll ? 0 : 200;
+    if (!s_failAll) r.body = body;
+    return r;
+}
+
+http::Response answer(const char* jsonBody, const char* dex) {
+    std::string d = dex ? dex : "";
+    if (strstr(jsonBody, "frontendOpenOrders")) {
+        s_calls.push_back("open:" + d);
+        auto it = s_openByDex.find(d);
+        return reply(it != s_openByDex.end() ? it->second : "[]");
+    }
+    s_calls.push_back("history");
+    return reply(s_history);
+}
+
+} // namespace
+
+namespace hl {
+namespace http {
+Response infoPost(const char* jsonBody, bool) { return answer(jsonBody, nullptr); }
+Response infoPostPerpDex(const char* jsonBody, const char* perpDex, bool) {
+    return answer(jsonBody, perpDex);
+}
+} // namespace http
+} // namespace hl
+
+//=============================================================================
+// FEED PROBE STUB + HELPERS
+//=============================================================================
+
+static bool s_feedLive = false;
+static uint32_t s_feedEpoch = 1;
+
+static bool testProbe(uint32_t* epoch) {
+    *epoch = s_feedEpoch;
+    return s_feedLive;
+}
+
+static double oleNow() { return (double)time(nullptr) / 86400.0 + 25569.0; }
+static double secondsAgo(int s) { return oleNow() - s / 86400.0; }
+
+static void reset() {
+    g_trading.cleanup();
+    g_trading.init();
+    strcpy_s(g_config.walletAddress, "0x1111111111111111111111111111111111111111");
+    trading::setOrderFeedProbe(testProbe);
+    trading::resetOrderSync();
+    s_openByDex.clear();
+    s_history = "[]";
+    s_calls.clear();
+    s_failAll = false;
+    s_feedLive = false;
+    s_feedEpoch = 1;
+}
+
+static void cloidFor(int id, char* out, size_t size) {
+    sprintf_s(out, size, "0x%08x0000000000000000cafebabe", (unsigned)id);
+}
+
+static void addOrder(int id, const char* oid, double ageSec, const char* coin = "BTC",
+                     double filled = 0.0) {
+    OrderState s;
+    strncpy_s(s.orderId, oid, _TRUNCATE);
+    cloidFor(id, s.cloid, sizeof(s.cloid));
+    strncpy_s(s.coin, coin, _TRUNCATE);
+    s.requestedSize = 1.0;
+    s.filledSize = filled;
+    s.avgPrice = filled > 0 ? 100.0 : 0.0;
+    s.status = filled > 0 ? OrderStatus::PartialFill : OrderStatus::Open;
+    s.zorroTradeId = id;
+    s.lastUpdate = secondsAgo((int)ageSec);
+    g_trading.setOrder(id, s);
+}
+
+static std::string openEntry(int id, const char* oid, double origSz, double sz,
+                             const char* coin = "BTC") {
+    char cloid[64], buf[256];
+    cloidFor(id, cloid, sizeof(cloid));
+    sprintf_s(buf, "{\"coin\":\"%s\",\"oid\":%s,\"cloid\":\"%s\",\"limitPx\":\"101.5\","
+              "\"origSz\":\"%g\",\"sz\":\"%g\",\"side\":\"B\"}", coin, oid, cloid, origSz, sz);
+    return buf;
+}
+
+static OrderStatus statusOf(int id) {
+    OrderRecord rec;
+    g_trading.getRecord(id, rec);
+    return rec.orderStatus();
+}
+
+//=============================================================================
+// STATUS MAPPING / PARSING
+//=============================================================================
+
+TEST_CASE(maps_exchange_status) {
+    ASSERT_EQ((int)trading::mapExchangeStatus("open", 0, 1), (int)OrderStatus::Open);
+    ASSERT_EQ((int)trading::mapExchangeStatus("open", 0.4, 1), (int)OrderStatus::PartialFill);
+    ASSERT_EQ((int)trading::mapExchangeStatus("filled", 1, 1), (int)OrderStatus::Filled);
+    ASSERT_EQ((int)trading::mapExchangeStatus("canceled", 0, 1), (int)OrderStatus::Cancelled);
+    ASSERT_EQ((int)trading::mapExchangeStatus("marginCanceled", 0, 1), (int)OrderStatus::Cancelled);
+    ASSERT_EQ((int)trading::mapExchangeStatus("siblingFilledCanceled", 0, 1),
+              (int)OrderStatus::Cancelled);
+    ASSERT_EQ((int)trading::mapExchangeStatus("rejected", 0, 1), (int)OrderStatus::Error);
+    ASSERT_EQ((int)trading::mapExchangeStatus(nullptr, 0, 1), (int)OrderStatus::Open);
+}
+
+TEST_CASE(parses_open_and_historical_formats) {
+    const char* open = "[{\"coin\":\"BTC\",\"oid\":123,\"cloid\":\"0xAB\",\"limitPx\":\"50000.0\","
+                       "\"origSz\":\"2.0\",\"sz\":\"0.5\"},"
+                       "{\"coin\":\"xyz:TSLA\",\"oid\":124,\"cloid\":null,\"limitPx\":\"250\","
+                       "\"origSz\":\"1\",\"sz\":\"1\"}]";
+    std::vector<trading::ExchangeOrder> out;
+    ASSERT_EQ(trading::parseExchangeOrders(open, strlen(open), out), 2);
+    ASSERT_STREQ(out[0].oid, "123");
+    ASSERT_STREQ(out[0].cloid, "0xAB");
+    ASSERT_STREQ(out[0].status, "open");
+    ASSERT_FLOAT_EQ(out[0].origSz - out[0].sz, 1.5);
+    ASSERT_FLOAT_EQ(out[0].limitPx, 50000.0);
+    ASSERT_STREQ(out[1].coin, "xyz:TSLA");
+    ASSERT_STREQ(out[1].cloid, "");
+
+    const char* hist = "[{\"order\":{\"coin\":\"ETH\",\"oid\":\"125\",\"limitPx\":\"3000\","
+                       "\"origSz\":\"1\",\"sz\":\"0\"},\"status\":\"filled\","
+                       "\"statusTimestamp\":1}]";
+    out.clear();
+    ASSERT_EQ(trading::parseExchangeOrders(hist, strlen(hist), out), 1);
+    ASSERT_STREQ(out[0].oid, "125");
+    ASSERT_STREQ(out[0].status, "filled");
+
+    out.clear();
+    ASSERT_EQ(trading::parseExchangeOrders("{\"status\":\"err\"}", 16, out), 0);
+    ASSERT_EQ(trading::parseExchangeOrders("not json", 8, out), 0);
+}
+
+//=============================================================================
+// STATE MACHINE
+//=============================================================================
+
+TEST_CASE(order_update_keeps_userfills_average) {
+    reset();
+    addOrder(1, "900", 0);
+    ASSERT_TRUE(trading::applyFillUpdate(1, 0.5, 99.25));
+    // orderUpdates carries the limit price, not the fill average
+    ASSERT_EQ(trading::applyOrderUpdate("900", nullptr, "open", 0.5, 101.0), 1);
+
+    OrderRecord rec;
+    ASSERT_TRUE(g_trading.getRecord(1, rec));
+    ASSERT_FLOAT_EQ(rec.avgPrice, 99.25);
+    ASSERT_EQ((int)rec.orderStatus(), (int)OrderStatus::PartialFill);
+
+    // Unknown average (no userFills yet): the limit price seeds it
+    addOrder(2, "901", 0);
+    trading::applyOrderUpdate("901", nullptr, "filled", 1.0, 101.0);
+    ASSERT_TRUE(g_trading.getRecord(2, rec));
+    ASSERT_FLOAT_EQ(rec.avgPrice, 101.0);
+    ASSERT_EQ((int)rec.orderStatus(), (int)OrderStatus::Filled);
+}
+
+TEST_CASE(terminal_states_absorb_late_events) {
+    reset();
+    addOrder(1, "900", 0);
+    trading::applyOrderUpdate("900", nullptr, "open", 0.3, 100.0);
+    trading::applyOrderUpdate("900", nullptr, "canceled", 0.3, 100.0);
+    ASSERT_EQ((int)statusOf(1), (int)OrderStatus::Cancelled);
+
+    // A reordered "open" after the cancel, and a smaller fill, change nothing
+    trading::applyOrderUpdate("900", nullptr, "open", 0.1, 100.0);
+    OrderRecord rec;
+    ASSERT_TRUE(g_trading.getRecord(1, rec));
+    ASSERT_EQ((int)rec.orderStatus(), (int)OrderStatus::Cancelled);
+    ASSERT_FLOAT_EQ(rec.filledSize, 0.3);
+
+    // Late partial userFills keep it cancelled; a completed fill wins
+    trading::applyFillUpdate(1, 0.5, 100.0);
+    ASSERT_EQ((int)statusOf(1), (int)OrderStatus::Cancelled);
+    trading::applyFillUpdate(1, 1.0, 100.0);
+    ASSERT_EQ((int)statusOf(1), (int)OrderStatus::Filled);
+}
+
+TEST_CASE(order_update_resolves_pending_by_cloid) {
+    reset();
+    char pending[80], cloid[64];
+    cloidFor(7, cloid, sizeof(cloid));
+    sprintf_s(pending, "PENDING_%s", cloid);
+    addOrder(7, pending, 0);
+
+    ASSERT_EQ(trading::applyOrderUpdate("777", cloid, "open", 0, 100.0), 7);
+    OrderRecord rec;
+    ASSERT_TRUE(g_trading.getRecord(7, rec));
+    ASSERT_EQ((int)rec.oidKind, (int)OidKind::Exchange);
+    ASSERT_EQ(g_trading.findByOid("777"), 7);
+    ASSERT_EQ(trading::applyOrderUpdate("555", nullptr, "open", 0, 1.0), 0);  // Untracked
+}
+
+TEST_CASE(pushes_stamp_epoch_only_while_live) {
+    reset();
+    addOrder(1, "900", 0);
+    trading::markOrderSynced(1);
+    OrderRecord rec;
+    g_trading.getRecord(1, rec);
+    ASSERT_EQ((int)rec.syncEpoch, 0);
+
+    s_feedLive = true;
+    s_feedEpoch = 4;
+    trading::applyOrderUpdate("900", nullptr, "open", 0, 100.0);
+    g_trading.getRecord(1, rec);
+    ASSERT_NE((int)rec.syncEpoch, 0);
+    uint16_t tag = rec.syncEpoch;
+
+    // Re-storing the full state keeps the stamp
+    OrderState s;
+    g_trading.getOrder(1, s);
+    g_trading.setOrder(1, s);
+    g_trading.getRecord(1, rec);
+    ASSERT_EQ((int)rec.syncEpoch, (int)tag);
+}
+
+//=============================================================================
+// RECONCILIATION
+//=============================================================================
+
+TEST_CASE(live_feed_makes_no_http) {
+    reset();
+    s_feedLive = true;
+    for (int id = 1; id <= 50; id++) {
+        char oid[16];
+        sprintf_s(oid, "%d", 1000 + id);
+        addOrder(id, oid, 3600);       // Resting for an hour: stale by age alone
+        trading::markOrderSynced(id);
+    }
+    ASSERT_EQ(trading::reconcileOrders(), 0);
+    ASSERT_EQ((int)s_calls.size(), 0);
+    ASSERT_EQ((int)trading::getOrderSyncStats().batches, 0);
+}
+
+TEST_CASE(epoch_gap_reconciles_in_one_batch) {
+    reset();
+    s_feedLive = true;
+    std::string open = "[";
+    for (int id = 1; id <= 30; id++) {
+        char oid[16];
+        sprintf_s(oid, "%d", 1000 + id);
+        addOrder(id, oid, 60);
+        trading::markOrderSynced(id);
+        if (id > 1) open += ",";
+        open += openEntry(id, oid, 1.0, id == 5 ? 0.25 : 1.0);   // #5 filled 0.75 meanwhile
+    }
+    s_openByDex[""] = open + "]";
+
+    s_feedEpoch = 2;                   // Feed reconnected without the standby
+    ASSERT_EQ(trading::reconcileOrders(), 30);
+    ASSERT_EQ((int)s_calls.size(), 1);
+    ASSERT_STREQ(s_calls[0].c_str(), "open:");
+    ASSERT_EQ((int)statusOf(5), (int)OrderStatus::PartialFill);
+
+    OrderRecord rec;
+    g_trading.getRecord(5, rec);
+    ASSERT_FLOAT_EQ(rec.filledSize, 0.75);
+
+    auto stats = trading::getOrderSyncStats();
+    ASSERT_EQ((int)stats.batches, 1);
+    ASSERT_EQ((int)stats.httpCalls, 1);
+    ASSERT_EQ((int)stats.ordersReconciled, 30);
+    ASSERT_EQ(stats.lastBatchOrders, 30);
+
+    // Everything is stamped with the new epoch: nothing left to do
+    trading::resetOrderSync();         // Clear the throttle
+    ASSERT_EQ(trading::reconcileOrders(), 0);
+    ASSERT_EQ((int)s_calls.size(), 1);
+}
+
+TEST_CASE(reconcile_is_throttled) {
+    reset();
+    s_feedLive = true;
+    addOrder(1, "1001", 60);
+    s_openByDex[""] = "[" + openEntry(1, "1001", 1.0, 1.0) + "]";
+    ASSERT_EQ(trading::reconcileOrders(), 1);
+
+    s_feedEpoch = 9;                   // Due again, but inside the interval
+    ASSERT_EQ(trading::reconcileOrders(), 0);
+    ASSERT_EQ((int)s_calls.size(), 1);
+}
+
+TEST_CASE(feed_down_polls_only_stale_orders) {
+    reset();
+    addOrder(1, "1001", 1);            // Fresh
+    addOrder(2, "1002", 30);           // Stale, unfilled
+    addOrder(3, "1003", 7, "BTC", 0.5);   // Partial: 10s window, not yet stale
+    s_openByDex[""] = "[" + openEntry(1, "1001", 1, 1) + "," + openEntry(2, "1002", 1, 1) +
+                      "," + openEntry(3, "1003", 1, 0.5) + "]";
+
+    ASSERT_EQ(trading::reconcileOrders(), 1);
+    ASSERT_EQ(trading::getOrderSyncStats().lastBatchOrders, 1);
+}
+
+TEST_CASE(missing_order_found_in_history) {
+    reset();
+    s_feedLive = true;
+    addOrder(1, "1001", 60);           // Filled while the feed was gapped
+    addOrder(2, "1002", 60);           // Cancelled while the feed was gapped
+    s_history = "[{\"order\":{\"coin\":\"BTC\",\"oid\":1001,\"limitPx\":\"101.5\",\"origSz\":\"1\","
+                "\"sz\":\"0\"},\"status\":\"filled\"},"
+                "{\"order\":{\"coin\":\"BTC\",\"oid\":1002,\"limitPx\":\"99\",\"origSz\":\"1\","
+                "\"sz\":\"1\"},\"status\":\"canceled\"}]";
+
+    ASSERT_EQ(trading::reconcileOrders(), 2);
+    ASSERT_EQ((int)s_calls.size(), 2);
+    ASSERT_STREQ(s_calls[1].c_str(), "history");
+    ASSERT_EQ((int)statusOf(1), (int)OrderStatus::Filled);
+    ASSERT_EQ((int)statusOf(2), (int)OrderStatus::Cancelled);
+
+    OrderRecord rec;
+    g_trading.getRecord(1, rec);
+    ASSERT_FLOAT_EQ(rec.avgPrice, 101.5);
+    ASSERT_EQ((int)g_trading.activeOrderCount(), 0);
+}
+
+TEST_CASE(pending_waits_for_grace_then_resolves) {
+    reset();
+    char pending[80], cloid[64];
+    cloidFor(3, cloid, sizeof(cloid));
+    sprintf_s(pending, "PENDING_%s", cloid);
+    addOrder(3, pending, 0);
+    OrderState s;
+    g_trading.getOrder(3, s);
+    s.status = OrderStatus::Pending;
+    g_trading.setOrder(3, s);
+    s_openByDex[""] = "[" + openEntry(3, "3003", 1, 1) + "]";
+
+    ASSERT_EQ(trading::reconcileOrders(), 0);   // Within the grace period
+    ASSERT_EQ((int)s_calls.size(), 0);
+
+    s.lastUpdate = secondsAgo(10);
+    g_trading.setOrder(3, s);
+    trading::resetOrderSync();
+    ASSERT_EQ(trading::reconcileOrders(), 1);
+    ASSERT_EQ(g_trading.findByOid("3003"), 3);
+    ASSERT_EQ((int)statusOf(3), (int)OrderStatus::Open);
+}
+
+TEST_CASE(pending_not_on_exchange_is_cancelled) {
+    reset();
+    char pending[80], cloid[64];
+    cloidFor(4, cloid, sizeof(cloid));
+    sprintf_s(pending, "PENDING_%s", cloid);
+    addOrder(4, pending, 10);
+
+    ASSERT_EQ(trading::reconcileOrders(), 1);
+    ASSERT_EQ((int)s_calls.size(), 2);          // open + history
+    ASSERT_EQ((int)statusOf(4), (int)OrderStatus::Cancelled);
+    ASSERT_EQ((int)trading::getOrderSyncStats().ordersNotFound, 1);
+}
+
+TEST_CASE(failed_query_changes_nothing) {
+    reset();
+    char pending[80], cloid[64];
+    cloidFor(4, cloid, sizeof(cloid));
+    sprintf_s(pending, "PENDING_%s", cloid);
+    addOrder(4, pending, 10);
+    s_failAll = true;
+
+    ASSERT_EQ(trading::reconcileOrders(), 0);
+    ASSERT_EQ((int)s_calls.size(), 1);          // No history after a failed open query
+    ASSERT_EQ((int)statusOf(4), (int)OrderStatus::Open);
+    ASSERT_EQ((int)trading::getOrderSyncStats().httpFailures, 1);
+}
+
+TEST_CASE(one_open_query_per_dex) {
+    reset();
+    addOrder(1, "1001", 30);
+    addOrder(2, "1002", 30, "xyz:TSLA");
+    addOrder(3, "1003", 30, "xyz:NVDA");
+    addOrder(4, "1004", 30);
+    s_openByDex[""] = "[" + openEntry(1, "1001", 1, 1) + "," + openEntry(4, "1004", 1, 1) + "]";
+    s_openByDex["xyz"] = "[" + openEntry(2, "1002", 1, 1, "xyz:TSLA") + "," +
+                         openEntry(3, "1003", 1, 1, "xyz:NVDA") + "]";
+
+    ASSERT_EQ(trading::reconcileOrders(), 4);
+    ASSERT_EQ((int)s_calls.size(), 2);
+    ASSERT_STREQ(s_calls[0].c_str(), "open:");
+    ASSERT_STREQ(s_calls[1].c_str(), "open:xyz");
+}
+
+TEST_CASE(synthetic_trades_are_never_queried) {
+    reset();
+    addOrder(1, "RESUMED_1", 3600);
+    addOrder(2, "IMPORTED_2", 3600);
+    addOrder(3, "DRY_RUN", 3600);
+    ASSERT_EQ(trading::reconcileOrders(), 0);
+    ASSERT_EQ((int)s_calls.size(), 0);
+}
+
+int main() {
+    printf("=== Order Sync Unit Tests ===\n\n");
+
+    RUN_TEST(maps_exchange_status);
+    RUN_TEST(parses_open_and_historical_formats);
+    RUN_TEST(order_update_keeps_userfills_average);
+    RUN_TEST(terminal_states_absorb_late_events);
+    RUN_TEST(order_update_resolves_pending_by_cloid);
+    RUN_TEST(pushes_stamp_epoch_only_while_live);
+    RUN_TEST(live_feed_makes_no_http);
+    RUN_TEST(epoch_gap_reconciles_in_one_batch);
+    RUN_TEST(reconcile_is_throttled);
+    RUN_TEST(feed_down_polls_only_stale_orders);
+    RUN_TEST(missing_order_found_in_history);
+    RUN_TEST(pending_waits_for_grace_then_resolves);
+    RUN_TEST(pending_not_on_exchange_is_cancelled);
+    RUN_TEST(failed_query_changes_nothing);
+    RUN_TEST(one_open_query_per_dex);
+    RUN_TEST(synthetic_trades_are_never_queried);
+
+    g_trading.cleanup();
+    return hl::test::printTestSummary();
+}
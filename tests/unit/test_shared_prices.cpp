@@ -0,0 +1,230 @@
+//=============================================================================
+// test_shared_prices.cpp - Cross-process shared price table
+//=============================================================================
+// Part of Hyperliquid Plugin for Zorro
+//
+// LAYER: Test
+// PURPOSE: Two SharedPriceTable instances on one segment stand in for two
+//          Zorro processes: publisher election and takeover, a silent
+//          publisher, coin requests, seqlock reads under a concurrent writer
+//          (no torn quotes), the PriceCache read-through and a full table.
+//=============================================================================
+
+#include "../test_framework.h"
+#include "ws_shared_prices.h"
+#include "ws_price_cache.h"
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace hl;
+using namespace hl::ws;
+
+// One segment per test so leftovers of a previous case never leak in
+static std::string segmentName(const char* test) {
+    char name[128];
+    sprintf_s(name, "Local\\HyperliquidZorro.PricesTest.%lu.%s",
+              (unsigned long)GetCurrentProcessId(), test);
+    return name;
+}
+
+TEST_CASE(first_opener_publishes_second_reads) {
+    std::string name = segmentName("elect");
+    SharedPriceTable pub, reader;
+    ASSERT_TRUE(pub.open(name.c_str()));
+    ASSERT_TRUE(reader.open(name.c_str()));
+
+    ASSERT_TRUE(pub.tryAcquirePublisher());
+    ASSERT_FALSE(reader.tryAcquirePublisher());
+    ASSERT_TRUE(pub.isPublisher());
+    ASSERT_FALSE(reader.isPublisher());
+
+    SharedPriceStats s = reader.getStats();
+    ASSERT_TRUE(s.open);
+    ASSERT_TRUE(s.publisherAlive);
+    ASSERT_EQ((unsigned long)s.publisherPid, (unsigned long)GetCurrentProcessId());
+    ASSERT_EQ((int)s.takeovers, 1);
+    pub.releasePublisher();
+}
+
+TEST_CASE(reader_request_reaches_publisher) {
+    std::string name = segmentName("request");
+    SharedPriceTable pub, reader;
+    ASSERT_TRUE(pub.open(name.c_str()));
+    ASSERT_TRUE(reader.open(name.c_str()));
+    ASSERT_TRUE(pub.tryAcquirePublisher());
+
+    std::vector<std::string> coins;
+    ASSERT_EQ(pub.takeRequests(coins), 0);
+    ASSERT_EQ(reader.request("BTC"), 0);
+    ASSERT_EQ(reader.request("xyz:XYZ100"), 1);
+    ASSERT_EQ(reader.request("BTC"), 0);                   // Same slot again
+    ASSERT_EQ(pub.takeRequests(coins), 2);
+    ASSERT_STREQ(coins[0].c_str(), "BTC");
+    ASSERT_STREQ(coins[1].c_str(), "xyz:XYZ100");
+    ASSERT_EQ(pub.takeRequests(coins), 0);
+
+    uint32_t btc = g_symbols.intern("BTC");
+    PriceData p;
+    ASSERT_FALSE(reader.read(btc, &p));                    // No quote yet
+    pub.publish(btc, "BTC", 97000.0, 97001.0);
+    ASSERT_TRUE(reader.read(btc, &p));
+    ASSERT_FLOAT_EQ_TOL(p.bid, 97000.0, 1e-9);
+    ASSERT_FLOAT_EQ_TOL(p.ask, 97001.0, 1e-9);
+    ASSERT_FLOAT_EQ_TOL(p.mid, 97000.5, 1e-9);
+    ASSERT_TRUE(GetTickCount() - p.timestamp < 1000);
+    ASSERT_FALSE(pub.read(btc, &p));                       // Publisher reads its own cache
+
+    // A coin the publisher quotes unrequested is found by name
+    uint32_t eth = g_symbols.intern("ETH");
+    ASSERT_FALSE(reader.read(eth, &p));
+    pub.publish(eth, "ETH", 3500.0, 3500.5);
+    ASSERT_TRUE(reader.read(eth, &p));
+    ASSERT_FLOAT_EQ_TOL(p.bid, 3500.0, 1e-9);
+    pub.releasePublisher();
+}
+
+TEST_CASE(released_publisher_is_taken_over) {
+    std::string name = segmentName("takeover");
+    SharedPriceTable pub, reader;
+    ASSERT_TRUE(pub.open(name.c_str()));
+    ASSERT_TRUE(reader.open(name.c_str()));
+    ASSERT_TRUE(pub.tryAcquirePublisher());
+    reader.request("SOL");
+    uint32_t sol = g_symbols.intern("SOL");
+    pub.publish(sol, "SOL", 150.0, 150.1);
+
+    pub.releasePublisher();
+    PriceData p;
+    ASSERT_FALSE(reader.read(sol, &p));                    // No publisher: don't trust the table
+    ASSERT_FALSE(reader.publisherAlive());
+
+    ASSERT_TRUE(reader.tryAcquirePublisher());
+    std::vector<std::string> coins;
+    ASSERT_EQ(reader.takeRequests(coins), 1);              // Whole table is new to it
+    ASSERT_STREQ(coins[0].c_str(), "SOL");
+    ASSERT_EQ((int)reader.getStats().takeovers, 2);
+    ASSERT_FALSE(pub.tryAcquirePublisher());
+    reader.releasePublisher();
+}
+
+TEST_CASE(silent_publisher_quotes_are_not_served) {
+    // Publisher's own feed dropped: it holds the mutex but stops beating
+    std::string name = segmentName("silent");
+    SharedPriceTable pub, reader;
+    ASSERT_TRUE(pub.open(name.c_str()));
+    ASSERT_TRUE(reader.open(name.c_str()));
+    ASSERT_TRUE(pub.tryAcquirePublisher());
+    reader.request("DOGE");
+    uint32_t doge = g_symbols.intern("DOGE");
+    pub.publish(doge, "DOGE", 0.1, 0.1001);
+    PriceData p;
+    ASSERT_TRUE(reader.read(doge, &p));
+
+    pub.heartbeat(GetTickCount() - (DWORD)config::SHM_PUBLISHER_STALE_MS);  // Last beat
+    ASSERT_FALSE(reader.publisherAlive());
+    ASSERT_FALSE(reader.read(doge, &p));                   // Frozen quote not served
+    ASSERT_FALSE(reader.tryAcquirePublisher());            // Reader subscribes itself instead
+
+    pub.heartbeat();                                       // Feed back
+    ASSERT_TRUE(reader.publisherAlive());
+    ASSERT_TRUE(reader.read(doge, &p));
+    pub.releasePublisher();
+}
+
+TEST_CASE(seqlock_reads_are_never_torn) {
+    std::string name = segmentName("seqlock");
+    SharedPriceTable pub, reader;
+    ASSERT_TRUE(pub.open(name.c_str()));
+    ASSERT_TRUE(reader.open(name.c_str()));
+    ASSERT_TRUE(pub.tryAcquirePublisher());
+    uint32_t id = g_symbols.intern("DOGE");
+    reader.request("DOGE");
+    pub.publish(id, "DOGE", 1.0, 2.0);
+
+    // Every write keeps ask == 2 * bid; a torn read breaks it
+    std::atomic<bool> done(false);
+    std::thread writer([&]() {
+        for (int i = 1; i <= 200000; i++) pub.publish(id, "DOGE", (double)i, 2.0 * i);
+        done = true;
+    });
+    int torn = 0, reads = 0;
+    PriceData p;
+    while (!done) {
+        if (reader.read(id, &p)) {
+            reads++;
+            if (p.ask != 2.0 * p.bid) torn++;
+        }
+    }
+    writer.join();
+    ASSERT_EQ(torn, 0);
+    ASSERT_TRUE(reads > 0);
+    ASSERT_TRUE(reader.read(id, &p));
+    ASSERT_FLOAT_EQ_TOL(p.bid, 200000.0, 1e-9);
+    pub.releasePublisher();
+}
+
+TEST_CASE(price_cache_reads_through_newest_wins) {
+    std::string name = segmentName("cache");
+    SharedPriceTable pub, reader;
+    ASSERT_TRUE(pub.open(name.c_str()));
+    ASSERT_TRUE(reader.open(name.c_str()));
+    ASSERT_TRUE(pub.tryAcquirePublisher());
+
+    PriceCache cache;
+    cache.setSharedSource(&reader);
+    uint32_t id = g_symbols.intern("AVAX");
+    reader.request("AVAX");
+    ASSERT_EQ(cache.getBid("AVAX"), 0.0);
+
+    pub.publish(id, "AVAX", 30.0, 30.1);
+    ASSERT_FLOAT_EQ_TOL(cache.getBid("AVAX"), 30.0, 1e-9);
+    ASSERT_FLOAT_EQ_TOL(cache.getAsk("AVAX"), 30.1, 1e-9);
+    ASSERT_TRUE(cache.isFresh("AVAX", 1000));
+
+    // A first quote published while waiting is seen within the poll period
+    uint32_t link = g_symbols.intern("LINK");
+    reader.request("LINK");
+    std::thread late([&]() { Sleep(50); pub.publish(link, "LINK", 15.0, 15.01); });
+    std::vector<std::string> coins(1, "LINK");
+    ASSERT_EQ(cache.waitForBidAsk(coins, 2000), 1);
+    late.join();
+
+    // Local quote newer than the shared one wins
+    Sleep(20);
+    cache.setBidAsk("AVAX", 31.0, 31.1);
+    ASSERT_FLOAT_EQ_TOL(cache.getBid("AVAX"), 31.0, 1e-9);
+
+    cache.setSharedSource(nullptr);
+    ASSERT_EQ(cache.getBid("LINK"), 0.0);
+    pub.releasePublisher();
+}
+
+TEST_CASE(full_table_refuses_new_coins) {
+    std::string name = segmentName("full");
+    SharedPriceTable table;
+    ASSERT_TRUE(table.open(name.c_str()));
+    char coin[32];
+    for (int i = 0; i < config::SHM_PRICE_SLOTS; i++) {
+        sprintf_s(coin, "FULL%d", i);
+        if (table.request(coin) != i) ASSERT_STREQ(coin, "<slot mismatch>");
+    }
+    ASSERT_EQ(table.request("ONE_TOO_MANY"), -1);
+    ASSERT_EQ(table.request("FULL7"), 7);                  // Existing coins still resolve
+    ASSERT_EQ(table.getStats().slotsUsed, config::SHM_PRICE_SLOTS);
+}
+
+int main() {
+    printf("=== Shared Price Table Tests ===\n\n");
+
+    RUN_TEST(first_opener_publishes_second_reads);
+    RUN_TEST(reader_request_reaches_publisher);
+    RUN_TEST(released_publisher_is_taken_over);
+    RUN_TEST(silent_publisher_quotes_are_not_served);
+    RUN_TEST(seqlock_reads_are_never_torn);
+    RUN_TEST(price_cache_reads_through_newest_wins);
+    RUN_TEST(full_table_refuses_new_coins);
+
+    return hl::test::printTestSummary();
+}
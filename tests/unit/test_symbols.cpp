@@ -0,0 +1,187 @@
+//=============================================================================
+// test_symbols.cpp - Unit tests for SymbolTable (coin intern table)
+//=============================================================================
+// Part of Hyperliquid Plugin for Zorro
+//
+// LAYER: Test
+// PURPOSE: Dense stable ids, aliases (first mapping wins), "dex:COIN" lookup
+//          without building the string, AssetRegistry::add registering every
+//          coin form, capacity limits, and lock-free readers racing a writer.
+//=============================================================================
+
+#include "../test_framework.h"
+#include "hl_symbols.h"
+#include "hl_globals.h"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using hl::SymbolTable;
+
+TEST_CASE(intern_assigns_dense_stable_ids) {
+    std::unique_ptr<SymbolTable> t(new SymbolTable());
+    ASSERT_EQ(t->count(), 0u);
+    uint32_t btc = t->intern("BTC");
+    uint32_t eth = t->intern("ETH");
+    ASSERT_EQ(btc, 1u);
+    ASSERT_EQ(eth, 2u);
+    ASSERT_EQ(t->intern("BTC"), btc);
+    ASSERT_EQ(t->find("ETH"), eth);
+    ASSERT_EQ(t->count(), 2u);
+    ASSERT_STREQ(t->name(btc), "BTC");
+}
+
+TEST_CASE(unknown_and_empty_are_zero) {
+    std::unique_ptr<SymbolTable> t(new SymbolTable());
+    ASSERT_EQ(t->find("BTC"), 0u);
+    ASSERT_EQ(t->intern(""), 0u);
+    ASSERT_EQ(t->intern(nullptr), 0u);
+    ASSERT_EQ(t->find(nullptr), 0u);
+    ASSERT_STREQ(t->name(0), "");
+    ASSERT_STREQ(t->name(12345), "");
+}
+
+TEST_CASE(lookup_is_case_sensitive) {
+    // kPEPE and KPEPE would be different API coins
+    std::unique_ptr<SymbolTable> t(new SymbolTable());
+    uint32_t a = t->intern("kPEPE");
+    ASSERT_EQ(t->find("KPEPE"), 0u);
+    ASSERT_NE(t->intern("KPEPE"), a);
+}
+
+TEST_CASE(alias_resolves_to_canonical_id) {
+    std::unique_ptr<SymbolTable> t(new SymbolTable());
+    uint32_t gold = t->intern("xyz:GOLD");
+    ASSERT_EQ(t->alias("xyz_GOLD", gold), gold);
+    ASSERT_EQ(t->alias("GOLD-USDC_xyz", gold), gold);
+    ASSERT_EQ(t->find("xyz_GOLD"), gold);
+    ASSERT_EQ(t->find("GOLD-USDC_xyz"), gold);
+    ASSERT_STREQ(t->name(gold), "xyz:GOLD");     // name() is the interned form
+    ASSERT_EQ(t->count(), 1u);                   // Aliases take no id
+
+    // First mapping wins; unknown ids are rejected
+    uint32_t btc = t->intern("BTC");
+    ASSERT_EQ(t->alias("xyz_GOLD", btc), gold);
+    ASSERT_EQ(t->alias("NOPE", 99), 0u);
+    ASSERT_EQ(t->find("NOPE"), 0u);
+}
+
+TEST_CASE(find_joined_matches_full_form) {
+    std::unique_ptr<SymbolTable> t(new SymbolTable());
+    uint32_t gold = t->intern("xyz:GOLD");
+    t->intern("xyz:GOLDX");
+    ASSERT_EQ(t->find("xyz", ':', "GOLD"), gold);
+    ASSERT_EQ(t->find("xyz", '_', "GOLD"), 0u);
+    ASSERT_EQ(t->find("xy", ':', "GOLD"), 0u);
+    ASSERT_EQ(t->find("xyz", ':', "GOL"), 0u);
+    ASSERT_NE(t->find("xyz", ':', "GOLDX"), gold);
+    uint32_t btc = t->intern("BTC");
+    ASSERT_EQ(t->find("", ':', "BTC"), btc);     // No prefix = plain coin
+}
+
+TEST_CASE(asset_registry_add_registers_all_forms) {
+    hl::g_assets.init();
+
+    hl::AssetInfo perp;
+    strcpy_s(perp.name, "SYMTEST-USDC");
+    strcpy_s(perp.coin, "SYMTEST");
+    ASSERT_TRUE(hl::g_assets.add(perp));
+
+    hl::AssetInfo dex;
+    strcpy_s(dex.name, "SYMGOLD-USDC_xyz");
+    strcpy_s(dex.coin, "SYMGOLD");
+    strcpy_s(dex.perpDex, "xyz");
+    dex.isPerpDex = true;
+    ASSERT_TRUE(hl::g_assets.add(dex));
+
+    hl::AssetInfo spot;
+    strcpy_s(spot.name, "SYMSPOT/USDC");
+    strcpy_s(spot.coin, "@9107");
+    strcpy_s(spot.spotCoin, "@9107");
+    spot.isSpot = true;
+    ASSERT_TRUE(hl::g_assets.add(spot));
+
+    uint32_t perpId = hl::g_symbols.find("SYMTEST");
+    uint32_t dexId = hl::g_symbols.find("xyz:SYMGOLD");
+    uint32_t spotId = hl::g_symbols.find("@9107");
+    ASSERT_NE(perpId, 0u);
+    ASSERT_NE(dexId, 0u);
+    ASSERT_NE(spotId, 0u);
+    ASSERT_EQ(hl::g_symbols.find("SYMTEST-USDC"), perpId);
+    ASSERT_EQ(hl::g_symbols.find("xyz_SYMGOLD"), dexId);
+    ASSERT_EQ(hl::g_symbols.find("SYMGOLD-USDC_xyz"), dexId);
+    ASSERT_EQ(hl::g_symbols.find("SYMSPOT/USDC"), spotId);
+
+    ASSERT_EQ(hl::g_assets.getByIndex(0)->symbolId, perpId);
+    ASSERT_EQ(hl::g_assets.getByIndex(1)->symbolId, dexId);
+    ASSERT_EQ(hl::g_assets.getByIndex(2)->symbolId, spotId);
+
+    // A meta reload keeps the ids
+    hl::g_assets.clear();
+    ASSERT_TRUE(hl::g_assets.add(dex));
+    ASSERT_EQ(hl::g_assets.getByIndex(0)->symbolId, dexId);
+    hl::g_assets.cleanup();
+}
+
+TEST_CASE(full_table_returns_zero) {
+    std::unique_ptr<SymbolTable> t(new SymbolTable());
+    uint32_t last = 0;
+    char name[32];
+    for (int i = 0; i < hl::config::SYMBOL_MAX_IDS + 10; i++) {
+        sprintf_s(name, "C%d", i);
+        uint32_t id = t->intern(name);
+        if (id) last = id;
+    }
+    ASSERT_EQ(last, (uint32_t)hl::config::SYMBOL_MAX_IDS - 1);
+    ASSERT_EQ(t->intern("ONE_TOO_MANY"), 0u);
+    ASSERT_EQ(t->find("C0"), 1u);                // Earlier ids unaffected
+}
+
+TEST_CASE(readers_race_writer) {
+    std::unique_ptr<SymbolTable> t(new SymbolTable());
+    const int N = 2000;
+    std::vector<std::string> names;
+    for (int i = 0; i < N; i++) names.push_back("COIN" + std::to_string(i));
+
+    std::atomic<int> published(0);
+    std::atomic<int> mismatches(0);
+    std::atomic<bool> done(false);
+
+    auto reader = [&]() {
+        while (!done.load()) {
+            int n = published.load();
+            for (int i = 0; i < n; i += 7) {
+                uint32_t id = t->find(names[i].c_str());
+                if (id == 0 || names[i] != t->name(id)) mismatches++;
+            }
+        }
+    };
+    std::thread r1(reader), r2(reader);
+    for (int i = 0; i < N; i++) {
+        t->intern(names[i].c_str());
+        published.store(i + 1);
+    }
+    done = true;
+    r1.join();
+    r2.join();
+
+    ASSERT_EQ(mismatches.load(), 0);
+    ASSERT_EQ(t->count(), (uint32_t)N);
+}
+
+int main() {
+    printf("=== SymbolTable Unit Tests ===\n\n");
+
+    RUN_TEST(intern_assigns_dense_stable_ids);
+    RUN_TEST(unknown_and_empty_are_zero);
+    RUN_TEST(lookup_is_case_sensitive);
+    RUN_TEST(alias_resolves_to_canonical_id);
+    RUN_TEST(find_joined_matches_full_form);
+    RUN_TEST(asset_registry_add_registers_all_forms);
+    RUN_TEST(full_table_returns_zero);
+    RUN_TEST(readers_race_writer);
+
+    return hl::test::printTestSummary();
+}
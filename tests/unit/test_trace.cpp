@@ -0,0 +1,167 @@
+//=============================================================================
+// test_trace.cpp - Unit tests for the per-order lifecycle trace
+//=============================================================================
+// Part of Hyperliquid Plugin for Zorro
+//
+// LAYER: Test
+// PURPOSE: Nothing is recorded while tracing is off; spans and instants
+//          carry tradeId/cloid/detail into Chrome trace JSON with one async
+//          track per order; strings are JSON-escaped; the ring keeps the
+//          newest TRACE_CAPACITY events; concurrent writers lose nothing;
+//          flush/clear empty the ring.
+//=============================================================================
+
+#include "../test_framework.h"
+#include "hl_trace.h"
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace hl::trace;
+
+static std::string tracePath() {
+    char path[MAX_PATH];
+    sprintf_s(path, "trace_test_%lu.json", (unsigned long)GetCurrentProcessId());
+    return path;
+}
+
+// Flushes into a temp file and returns its content (events written in *count)
+static std::string flushToString(int* count) {
+    std::string path = tracePath();
+    *count = flush(path.c_str());
+    std::string text;
+    FILE* f = nullptr;
+    if (fopen_s(&f, path.c_str(), "r") == 0 && f) {
+        char buf[4096];
+        size_t n;
+        while ((n = fread(buf, 1, sizeof(buf), f)) > 0) text.append(buf, n);
+        fclose(f);
+    }
+    remove(path.c_str());
+    return text;
+}
+
+static bool contains(const std::string& text, const char* needle) {
+    return text.find(needle) != std::string::npos;
+}
+
+TEST_CASE(off_records_nothing) {
+    setEnabled(false);
+    clear();
+    {
+        Span span("BrokerBuy2", "api");
+        span.setOrder(1, "0x01");
+        ASSERT_FALSE(span.active());
+    }
+    instant("userFills", "ws", 1, nullptr, "sz 1");
+    ASSERT_EQ((int)getStats().recorded, 0);
+}
+
+TEST_CASE(span_and_instant_to_chrome_json) {
+    setEnabled(true);
+    clear();
+    {
+        Span span("placeOrder", "trading");
+        span.setOrder(7);
+        Sleep(1);
+        span.setOrder(7, "0x0000000000000000000000000000abcd");
+        span.setDetail("filled");
+        ASSERT_TRUE(span.active());
+    }
+    instant("orderUpdates", "ws", 7, nullptr, "filled");
+    instant("heartbeat", "misc", 0, nullptr);
+    ASSERT_EQ((int)getStats().recorded, 3);
+
+    int count = 0;
+    std::string json = flushToString(&count);
+    ASSERT_EQ(count, 3);
+    ASSERT_TRUE(json.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[") == 0);
+    ASSERT_TRUE(contains(json, "\"ph\":\"X\",\"name\":\"placeOrder\",\"cat\":\"trading\""));
+    ASSERT_TRUE(contains(json, "\"cloid\":\"0x0000000000000000000000000000abcd\""));
+    ASSERT_TRUE(contains(json, "\"ph\":\"i\",\"name\":\"orderUpdates\""));
+    ASSERT_TRUE(contains(json, "\"detail\":\"filled\""));
+    // One async track for order 7, none for the untagged event
+    ASSERT_TRUE(contains(json, "{\"ph\":\"b\",\"name\":\"order 7\""));
+    ASSERT_TRUE(contains(json, "{\"ph\":\"e\",\"name\":\"order 7\""));
+    ASSERT_FALSE(contains(json, "\"name\":\"order 0\""));
+    ASSERT_TRUE(contains(json, "]}"));
+
+    ASSERT_EQ((int)getStats().recorded, 0);     // Flushed events are gone
+}
+
+TEST_CASE(strings_are_escaped) {
+    setEnabled(true);
+    clear();
+    instant("exchange response", "trading", 3, nullptr, "Exchange error: \"bad\\px\"\n");
+    int count = 0;
+    std::string json = flushToString(&count);
+    ASSERT_EQ(count, 1);
+    ASSERT_TRUE(contains(json, "\"detail\":\"Exchange error: \\\"bad\\\\px\\\"\\u000a\""));
+}
+
+TEST_CASE(ring_keeps_newest_events) {
+    setEnabled(true);
+    clear();
+    const int cap = hl::config::TRACE_CAPACITY;
+    for (int i = 1; i <= cap + 10; i++) instant("tick", "test", i, nullptr);
+    TraceStats st = getStats();
+    ASSERT_EQ((int)st.recorded, cap + 10);
+    ASSERT_EQ((int)st.overwritten, 10);
+    ASSERT_EQ(st.capacity, cap);
+
+    int count = 0;
+    std::string json = flushToString(&count);
+    ASSERT_EQ(count, cap);
+    ASSERT_FALSE(contains(json, "\"name\":\"order 10\""));
+    ASSERT_TRUE(contains(json, "\"name\":\"order 11\""));
+}
+
+TEST_CASE(concurrent_writers) {
+    setEnabled(true);
+    clear();
+    const int THREADS = 4, PER_THREAD = 1000;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < THREADS; t++) {
+        workers.emplace_back([t]() {
+            for (int i = 0; i < PER_THREAD; i++) {
+                Span span("getPrice", "market");
+                span.setOrder(t * PER_THREAD + i + 1);
+            }
+        });
+    }
+    for (auto& w : workers) w.join();
+    int count = 0;
+    flushToString(&count);
+    ASSERT_EQ(count, THREADS * PER_THREAD);
+}
+
+TEST_CASE(stop_keeps_events_and_clear_drops_them) {
+    setEnabled(true);
+    clear();
+    instant("a", "test", 1, nullptr);
+    setEnabled(false);
+    instant("b", "test", 2, nullptr);           // Ignored while stopped
+    ASSERT_FALSE(getStats().enabled);
+    ASSERT_EQ((int)getStats().recorded, 1);
+    clear();
+    ASSERT_EQ((int)getStats().recorded, 0);
+
+    int count = 0;
+    flushToString(&count);
+    ASSERT_EQ(count, 0);
+    ASSERT_EQ(flush(""), -1);
+}
+
+int main() {
+    printf("=== Order Trace Tests ===\n\n");
+
+    RUN_TEST(off_records_nothing);
+    RUN_TEST(span_and_instant_to_chrome_json);
+    RUN_TEST(strings_are_escaped);
+    RUN_TEST(ring_keeps_newest_events);
+    RUN_TEST(concurrent_writers);
+    RUN_TEST(stop_keeps_events_and_clear_drops_them);
+
+    return hl::test::printTestSummary();
+}
@@ -0,0 +1,427 @@
+//=============================================================================
+// test_trade_snapshot.cpp - Per-tick BrokerTrade snapshot
+//=============================================================================
+// LAYER: Test | TESTS: hl_trade_snapshot, PriceCache::getFillTotals,
+//                      TradingState::getRecords
+//
+// Tests:
+//   1. Results: every trade kind (generic, RESUMED_, IMPORTED_ open/closed/
+//      reversed, PENDING_, cancelled, unknown) and snapshot == direct compute
+//   2. One pass per tick: one price lookup per coin, later calls are hits,
+//      new trades are computed alone and join the next snapshot
+//   3. New tick / invalidation: repeat request, reconciliation, explicit
+//      invalidation, max age; trades Zorro stops asking for are dropped
+//   4. WS fill totals are applied to the trade map
+//
+// hl::market::getPrice, hl::account::getPosition, hl::trading::reconcileOrders
+// and the two trade-map wrappers from hl_trading_service are stubbed below.
+//=============================================================================
+
+#include "../test_framework.h"
+#include "../../src/foundation/hl_globals.h"
+#include "../../src/services/hl_trade_snapshot.h"
+#include "../../src/services/hl_trading_service.h"
+#include "../../src/services/hl_market_service.h"
+#include "../../src/services/hl_account_service.h"
+#include "../../src/services/hl_order_sync.h"
+#include "../../src/transport/ws_price_cache.h"
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+
+using namespace hl::test;
+using namespace hl;
+
+//=============================================================================
+// SERVICE STUBS
+//=============================================================================
+
+namespace {
+
+std::map<std::string, double> s_mid;                        // coin -> mid
+std::map<std::string, account::PositionInfo> s_positions;   // coin -> position
+int s_priceCalls = 0;
+int s_positionCalls = 0;
+int s_reconcileResult = 0;
+
+} // namespace
+
+namespace hl {
+namespace market {
+PriceData getPrice(const char* coin, uint32_t) {
+    s_priceCalls++;
+    PriceData p;
+    auto it = s_mid.find(coin);
+    if (it != s_mid.end()) {
+        p.mid = it->second;
+        p.bid = p.mid - 0.5;
+        p.ask = p.mid + 0.5;
+    }
+    return p;
+}
+} // namespace market
+
+namespace account {
+PositionInfo getPosition(const char* coin) {
+    s_positionCalls++;
+    auto it = s_positions.find(coin);
+    return it != s_positions.end() ? it->second : PositionInfo();
+}
+} // namespace account
+
+namespace trading {
+int reconcileOrders() { return s_reconcileResult; }
+bool getOrder(int tradeId, OrderState& outState) { return g_trading.getOrder(tradeId, outState); }
+bool updateFillProgress(int tradeId, double totalFilled, double avgPrice, OrderStatus* outStatus) {
+    return g_trading.applyFillProgress(tradeId, totalFilled, avgPrice, 45000.0, outStatus);
+}
+} // namespace trading
+} // namespace hl
+
+//=============================================================================
+// HELPERS
+//=============================================================================
+
+static ws::PriceCache* s_cache = nullptr;
+
+static void reset() {
+    g_trading.cleanup();
+    g_trading.init();
+    g_trading.lotSize = 0.01;
+    g_config.enableWebSocket = false;
+    g_config.diagLevel = 0;
+    if (s_cache) {
+        g_priceCache = nullptr;
+        delete s_cache;
+        s_cache = nullptr;
+    }
+    trading::resetTradeSnapshot();
+    s_mid.clear();
+    s_mid["BTC"] = 110.0;
+    s_mid["ETH"] = 55.0;
+    s_positions.clear();
+    s_priceCalls = 0;
+    s_positionCalls = 0;
+    s_reconcileResult = 0;
+}
+
+static void enableFillCache() {
+    s_cache = new ws::PriceCache();
+    g_priceCache = s_cache;
+    g_config.enableWebSocket = true;
+}
+
+static void addOrder(int id, const char* oid, const char* coin, OrderSide side,
+                     double filled, double avgPx,
+                     OrderStatus status = OrderStatus::PartialFill) {
+    OrderState s;
+    strncpy_s(s.orderId, oid, _TRUNCATE);
+    sprintf_s(s.cloid, "0x%08x0000000000000000cafebabe", (unsigned)id);
+    strncpy_s(s.coin, coin, _TRUNCATE);
+    s.side = side;
+    s.requestedSize = 1.0;
+    s.filledSize = filled;
+    s.avgPrice = avgPx;
+    s.status = status;
+    s.zorroTradeId = id;
+    g_trading.setOrder(id, s);
+}
+
+static void addFill(const char* oid, double px, double sz) {
+    ws::FillData f;
+    f.oid = oid;
+    f.coin = "BTC";
+    f.px = px;
+    f.sz = sz;
+    s_cache->addFill(f);
+}
+
+static bool sameView(const trading::TradeView& a, const trading::TradeView& b) {
+    return a.kind == b.kind && a.lots == b.lots
+        && a.hasOpen == b.hasOpen && a.openPx == b.openPx
+        && a.hasClose == b.hasClose && a.closePx == b.closePx
+        && a.hasProfit == b.hasProfit && a.profit == b.profit;
+}
+
+// One Zorro tick: BrokerTrade for trades first..last
+static void tick(int first, int last) {
+    for (int id = first; id <= last; id++) trading::getTradeView(id);
+}
+
+//=============================================================================
+// RESULTS
+//=============================================================================
+
+TEST_CASE(generic_trade_reports_lots_and_profit) {
+    reset();
+    addOrder(1, "1001", "BTC", OrderSide::Buy, 0.5, 100.0);
+    addOrder(2, "1002", "BTC", OrderSide::Sell, 0.5, 100.0);
+
+    trading::TradeView v = trading::getTradeView(1);
+    ASSERT_TRUE(v.kind == trading::TradeViewKind::Open);
+    ASSERT_EQ(v.lots, 50);
+    ASSERT_TRUE(v.hasOpen);
+    ASSERT_FLOAT_EQ(v.openPx, 100.0);
+    ASSERT_TRUE(v.hasProfit);
+    ASSERT_FLOAT_EQ(v.profit, 5.0);         // (110 - 100) * 0.5
+
+    v = trading::getTradeView(2);
+    ASSERT_FLOAT_EQ(v.profit, -5.0);        // Short
+}
+
+TEST_CASE(open_and_cancelled_without_fills) {
+    reset();
+    addOrder(1, "1001", "BTC", OrderSide::Buy, 0.0, 0.0, OrderStatus::Open);
+    addOrder(2, "1002", "BTC", OrderSide::Buy, 0.0, 0.0, OrderStatus::Cancelled);
+
+    trading::TradeView v = trading::getTradeView(1);
+    ASSERT_TRUE(v.kind == trading::TradeViewKind::Pending);
+    ASSERT_TRUE(v.hasOpen);
+    ASSERT_FALSE(v.hasProfit);
+    ASSERT_TRUE(trading::getTradeView(2).kind == trading::TradeViewKind::Cancelled);
+    ASSERT_TRUE(trading::getTradeView(99).kind == trading::TradeViewKind::Missing);
+}
+
+TEST_CASE(pending_order_reports_nothing_until_cancelled) {
+    reset();
+    addOrder(1, "PENDING_1", "BTC", OrderSide::Buy, 0.0, 0.0, OrderStatus::Open);
+    addOrder(2, "PENDING_2", "BTC", OrderSide::Buy, 0.0, 0.0, OrderStatus::Cancelled);
+
+    trading::TradeView v = trading::getTradeView(1);
+    ASSERT_TRUE(v.kind == trading::TradeViewKind::Pending);
+    ASSERT_FALSE(v.hasOpen);
+    ASSERT_TRUE(trading::getTradeView(2).kind == trading::TradeViewKind::Cancelled);
+}
+
+TEST_CASE(resumed_uses_cached_entry) {
+    reset();
+    addOrder(1, "RESUMED_1", "ETH", OrderSide::Buy, 0.2, 50.0, OrderStatus::Filled);
+
+    trading::TradeView v = trading::getTradeView(1);
+    ASSERT_TRUE(v.kind == trading::TradeViewKind::Open);
+    ASSERT_EQ(v.lots, 20);
+    ASSERT_FLOAT_EQ(v.openPx, 50.0);
+    ASSERT_FLOAT_EQ(v.profit, 1.0);         // (55 - 50) * 0.2
+    ASSERT_EQ(s_positionCalls, 0);
+}
+
+TEST_CASE(imported_follows_live_position) {
+    reset();
+    addOrder(1, "IMPORTED_1", "BTC", OrderSide::Buy, 0.5, 100.0, OrderStatus::Filled);
+    addOrder(2, "IMPORTED_2", "ETH", OrderSide::Buy, 0.5, 50.0, OrderStatus::Filled);
+    addOrder(3, "IMPORTED_3", "SOL", OrderSide::Buy, 0.5, 20.0, OrderStatus::Filled);
+    s_positions["BTC"].size = 0.3;
+    s_positions["BTC"].entryPrice = 105.0;
+    s_positions["ETH"].size = -0.4;         // Reversed
+    s_positions["ETH"].entryPrice = 52.0;
+
+    trading::TradeView v = trading::getTradeView(1);
+    ASSERT_TRUE(v.kind == trading::TradeViewKind::Open);
+    ASSERT_EQ(v.lots, 30);
+    ASSERT_FLOAT_EQ(v.openPx, 105.0);
+    ASSERT_FLOAT_EQ_TOL(v.profit, 1.5, 1e-9);   // (110 - 105) * 0.3
+
+    v = trading::getTradeView(2);
+    ASSERT_TRUE(v.kind == trading::TradeViewKind::Closed);
+    ASSERT_TRUE(v.hasClose);
+    ASSERT_FLOAT_EQ(v.closePx, 52.0);
+    ASSERT_TRUE(v.hasProfit);
+    ASSERT_FLOAT_EQ(v.profit, 0.0);
+
+    v = trading::getTradeView(3);           // No position: closed at import price
+    ASSERT_TRUE(v.kind == trading::TradeViewKind::Closed);
+    ASSERT_FLOAT_EQ(v.closePx, 20.0);
+}
+
+TEST_CASE(snapshot_matches_direct_compute) {
+    reset();
+    addOrder(1, "1001", "BTC", OrderSide::Buy, 0.5, 100.0);
+    addOrder(2, "1002", "ETH", OrderSide::Sell, 0.25, 60.0);
+    addOrder(3, "RESUMED_3", "ETH", OrderSide::Buy, 0.2, 50.0, OrderStatus::Filled);
+    addOrder(4, "IMPORTED_4", "BTC", OrderSide::Sell, 0.1, 120.0, OrderStatus::Filled);
+    addOrder(5, "PENDING_5", "BTC", OrderSide::Buy, 0.0, 0.0, OrderStatus::Open);
+    addOrder(6, "1006", "BTC", OrderSide::Buy, 0.0, 0.0, OrderStatus::Cancelled);
+    s_positions["BTC"].size = -0.1;
+    s_positions["BTC"].entryPrice = 118.0;
+
+    tick(1, 7);
+    tick(1, 7);                             // Served from one snapshot
+    for (int id = 1; id <= 7; id++) {
+        trading::TradeView snap = trading::getTradeView(id);
+        ASSERT_TRUE(sameView(snap, trading::computeTradeView(id)));
+    }
+}
+
+//=============================================================================
+// ONE PASS PER TICK
+//=============================================================================
+
+TEST_CASE(one_price_lookup_per_coin_per_tick) {
+    reset();
+    for (int id = 1; id <= 20; id++)
+        addOrder(id, std::to_string(1000 + id).c_str(), (id & 1) ? "BTC" : "ETH",
+                 OrderSide::Buy, 0.1, 50.0);
+
+    tick(1, 20);                            // Watch set builds up
+    trading::TradeSnapshotStats st = trading::getTradeSnapshotStats();
+    ASSERT_EQ(st.rebuilds, 1LL);
+    ASSERT_EQ(st.misses, 19LL);
+
+    s_priceCalls = 0;
+    tick(1, 20);
+    st = trading::getTradeSnapshotStats();
+    ASSERT_EQ(s_priceCalls, 2);             // BTC and ETH, once each
+    ASSERT_EQ(st.rebuilds, 2LL);
+    ASSERT_EQ(st.lastTrades, 20);
+    ASSERT_EQ(st.hits, 21LL);               // 1 in the first tick + 20
+
+    s_priceCalls = 0;
+    tick(1, 20);
+    ASSERT_EQ(s_priceCalls, 2);
+    ASSERT_EQ(trading::getTradeSnapshotStats().misses, 19LL);
+}
+
+TEST_CASE(new_trade_joins_next_snapshot) {
+    reset();
+    addOrder(1, "1001", "BTC", OrderSide::Buy, 0.1, 100.0);
+    addOrder(2, "1002", "BTC", OrderSide::Buy, 0.1, 100.0);
+    tick(1, 1);
+    tick(1, 1);
+
+    tick(1, 2);                             // 2 is new: computed alone
+    ASSERT_EQ(trading::getTradeSnapshotStats().misses, 1LL);
+    ASSERT_EQ(trading::getTradeSnapshotStats().lastTrades, 1);
+
+    tick(1, 2);
+    ASSERT_EQ(trading::getTradeSnapshotStats().misses, 1LL);
+    ASSERT_EQ(trading::getTradeSnapshotStats().lastTrades, 2);
+}
+
+TEST_CASE(closed_trades_leave_the_watch_set) {
+    reset();
+    for (int id = 1; id <= 3; id++)
+        addOrder(id, std::to_string(1000 + id).c_str(), "BTC", OrderSide::Buy, 0.1, 100.0);
+    tick(1, 3);
+    tick(1, 3);
+    ASSERT_EQ(trading::getTradeSnapshotStats().lastTrades, 3);
+
+    tick(1, 1);                             // Zorro no longer asks for 2 and 3
+    tick(1, 1);
+    tick(1, 1);
+    ASSERT_EQ(trading::getTradeSnapshotStats().lastTrades, 1);
+}
+
+//=============================================================================
+// NEW TICK / INVALIDATION
+//=============================================================================
+
+TEST_CASE(invalidation_forces_rebuild) {
+    reset();
+    addOrder(1, "1001", "BTC", OrderSide::Buy, 0.1, 100.0);
+    addOrder(2, "1002", "BTC", OrderSide::Buy, 0.1, 100.0);
+    tick(1, 2);
+    trading::getTradeView(1);               // New tick: snapshot of 1 and 2
+    long long rebuilds = trading::getTradeSnapshotStats().rebuilds;
+
+    // Change trade 2 mid-tick: without invalidation the snapshot still holds
+    g_trading.applyFill(2, 0.3, 100.0, OrderStatus::PartialFill, 45000.0);
+    trading::invalidateTradeSnapshot();
+    trading::TradeView v = trading::getTradeView(2);
+    ASSERT_EQ(v.lots, 30);
+    ASSERT_EQ(trading::getTradeSnapshotStats().rebuilds, rebuilds + 1);
+}
+
+TEST_CASE(reconciliation_batch_invalidates) {
+    reset();
+    addOrder(1, "1001", "BTC", OrderSide::Buy, 0.1, 100.0);
+    addOrder(2, "1002", "BTC", OrderSide::Buy, 0.1, 100.0);
+    tick(1, 2);
+    trading::getTradeView(1);
+    long long rebuilds = trading::getTradeSnapshotStats().rebuilds;
+
+    s_reconcileResult = 1;
+    trading::getTradeView(2);
+    ASSERT_EQ(trading::getTradeSnapshotStats().rebuilds, rebuilds + 1);
+}
+
+TEST_CASE(snapshot_expires) {
+    reset();
+    addOrder(1, "1001", "BTC", OrderSide::Buy, 0.1, 100.0);
+    addOrder(2, "1002", "BTC", OrderSide::Buy, 0.1, 100.0);
+    tick(1, 2);
+    trading::getTradeView(1);
+    long long rebuilds = trading::getTradeSnapshotStats().rebuilds;
+
+    Sleep(config::TRADE_SNAPSHOT_MAX_AGE_MS + 50);
+    trading::getTradeView(2);
+    ASSERT_EQ(trading::getTradeSnapshotStats().rebuilds, rebuilds + 1);
+}
+
+//=============================================================================
+// WS FILL TOTALS
+//=============================================================================
+
+TEST_CASE(ws_fill_totals_update_trade_map) {
+    reset();
+    enableFillCache();
+    addOrder(1, "1001", "BTC", OrderSide::Buy, 0.0, 0.0, OrderStatus::Open);
+    addOrder(2, "1002", "BTC", OrderSide::Buy, 0.0, 0.0, OrderStatus::Open);
+    addFill("1001", 100.0, 0.2);
+    addFill("1001", 104.0, 0.2);
+
+    trading::TradeView v = trading::getTradeView(1);
+    ASSERT_TRUE(v.kind == trading::TradeViewKind::Open);
+    ASSERT_EQ(v.lots, 40);
+    ASSERT_FLOAT_EQ(v.openPx, 102.0);
+    ASSERT_TRUE(trading::getTradeView(2).kind == trading::TradeViewKind::Pending);
+
+    OrderRecord rec;
+    ASSERT_TRUE(g_trading.getRecord(1, rec));
+    ASSERT_FLOAT_EQ(rec.filledSize, 0.4);
+    ASSERT_FLOAT_EQ(rec.avgPrice, 102.0);
+}
+
+TEST_CASE(fill_totals_batch_lookup) {
+    ws::PriceCache cache;
+    ws::FillData f;
+    f.coin = "BTC";
+    f.oid = "7";  f.px = 10.0; f.sz = 1.0; cache.addFill(f);
+    f.oid = "7";  f.px = 20.0; f.sz = 3.0; cache.addFill(f);
+    f.oid = "8";  f.px = 5.0;  f.sz = 2.0; cache.addFill(f);
+
+    std::vector<const char*> oids = { "8", "9", "7" };
+    std::vector<ws::FillTotal> totals;
+    cache.getFillTotals(oids, totals);
+    ASSERT_EQ((int)totals.size(), 3);
+    ASSERT_EQ(totals[0].fills, 1);
+    ASSERT_FLOAT_EQ(totals[0].avgPx, 5.0);
+    ASSERT_EQ(totals[1].fills, 0);
+    ASSERT_FLOAT_EQ(totals[1].size, 0.0);
+    ASSERT_EQ(totals[2].fills, 2);
+    ASSERT_FLOAT_EQ(totals[2].size, 4.0);
+    ASSERT_FLOAT_EQ(totals[2].avgPx, 17.5);
+}
+
+int main() {
+    printf("=== Trade Snapshot Unit Tests ===\n\n");
+
+    RUN_TEST(generic_trade_reports_lots_and_profit);
+    RUN_TEST(open_and_cancelled_without_fills);
+    RUN_TEST(pending_order_reports_nothing_until_cancelled);
+    RUN_TEST(resumed_uses_cached_entry);
+    RUN_TEST(imported_follows_live_position);
+    RUN_TEST(snapshot_matches_direct_compute);
+    RUN_TEST(one_price_lookup_per_coin_per_tick);
+    RUN_TEST(new_trade_joins_next_snapshot);
+    RUN_TEST(closed_trades_leave_the_watch_set);
+    RUN_TEST(invalidation_forces_rebuild);
+    RUN_TEST(reconciliation_batch_invalidates);
+    RUN_TEST(snapshot_expires);
+    RUN_TEST(ws_fill_totals_update_trade_map);
+    RUN_TEST(fill_totals_batch_lookup);
+
+    reset();
+    g_trading.cleanup();
+    return hl::test::printTestSummary();
+}
@@ -7,7 +7,8 @@
 //   1. CLOID generation and parsing (generateCloid, extractTradeIdFromCloid)
 //   2. Trade ID generation (generateTradeId via g_trading)
 //   3. Nonce generation (generateNonce via g_trading)
-//   4. Order storage & retrieval (g_trading trade map)
+//   4. Order storage & retrieval (g_trading trade map, cloid/oid indices,
+//      terminal-order archive, compact record round-trip and field updates)
 //   5. Fill status determination (determineFilledStatus)
 //   6. Fill status string parsing (notifyFill logic)
 //=============================================================================
@@ -371,6 +372,318 @@ TEST_CASE(multiple_orders_coexist) {
     g_trading.cleanup();
 }
 
+TEST_CASE(lookup_by_cloid_and_oid) {
+    g_trading.init();
+
+    OrderState state;
+    strcpy_s(state.orderId, "777");
+    strcpy_s(state.cloid, "0x0000001e0000000000000000aaaaaaaa");
+    state.status = OrderStatus::Open;
+    g_trading.setOrder(30, state);
+
+    ASSERT_EQ(g_trading.findByOid("777"), 30);
+    ASSERT_EQ(g_trading.findByCloid("0x0000001e0000000000000000aaaaaaaa"), 30);
+    ASSERT_EQ(g_trading.findByOid("778"), 0);
+    ASSERT_EQ(g_trading.findByOid(""), 0);
+    ASSERT_EQ(g_trading.findByCloid(nullptr), 0);
+
+    OrderState out;
+    ASSERT_TRUE(g_trading.getOrderByOid("777", out));
+    ASSERT_STREQ(out.cloid, "0x0000001e0000000000000000aaaaaaaa");
+
+    g_trading.cleanup();
+}
+
+TEST_CASE(oid_assigned_after_placement_is_indexed) {
+    g_trading.init();
+
+    OrderState state;
+    strcpy_s(state.cloid, "0x000000280000000000000000bbbbbbbb");
+    state.status = OrderStatus::Pending;
+    g_trading.setOrder(40, state);
+    ASSERT_EQ(g_trading.findByOid("900"), 0);
+
+    // Exchange acknowledges with an oid
+    strcpy_s(state.orderId, "900");
+    state.status = OrderStatus::Open;
+    ASSERT_TRUE(g_trading.updateOrder(40, state));
+    ASSERT_EQ(g_trading.findByOid("900"), 40);
+
+    // oid replaced (e.g. modify) — the old key no longer resolves
+    strcpy_s(state.orderId, "901");
+    g_trading.updateOrder(40, state);
+    ASSERT_EQ(g_trading.findByOid("900"), 0);
+    ASSERT_EQ(g_trading.findByOid("901"), 40);
+
+    g_trading.cleanup();
+}
+
+TEST_CASE(terminal_order_is_archived_but_found) {
+    g_trading.init();
+
+    OrderState state;
+    strcpy_s(state.orderId, "1001");
+    state.status = OrderStatus::Open;
+    g_trading.setOrder(50, state);
+    ASSERT_EQ((int)g_trading.activeOrderCount(), 1);
+
+    state.status = OrderStatus::Filled;
+    state.filledSize = 1.0;
+    g_trading.updateOrder(50, state);
+    ASSERT_EQ((int)g_trading.activeOrderCount(), 0);
+    ASSERT_EQ((int)g_trading.archivedOrderCount(), 1);
+
+    // Zorro keeps asking about filled trades until it closes them
+    OrderState out;
+    ASSERT_TRUE(g_trading.getOrder(50, out));
+    ASSERT_FLOAT_EQ(out.filledSize, 1.0);
+    ASSERT_EQ(g_trading.findByOid("1001"), 50);
+
+    g_trading.removeOrder(50);
+    ASSERT_FALSE(g_trading.getOrder(50, out));
+    ASSERT_EQ(g_trading.findByOid("1001"), 0);
+
+    g_trading.cleanup();
+}
+
+TEST_CASE(archive_drops_oldest_beyond_limit) {
+    g_trading.init();
+
+    OrderState state;
+    state.status = OrderStatus::Cancelled;
+    int total = config::TRADE_ARCHIVE_MAX + 5;
+    for (int id = 1; id <= total; id++) {
+        sprintf_s(state.orderId, "%d", 100000 + id);
+        g_trading.setOrder(id, state);
+    }
+    ASSERT_EQ((int)g_trading.archivedOrderCount(), config::TRADE_ARCHIVE_MAX);
+
+    OrderState out;
+    ASSERT_FALSE(g_trading.getOrder(5, out));
+    ASSERT_EQ(g_trading.findByOid("100005"), 0);
+    ASSERT_TRUE(g_trading.getOrder(6, out));
+    ASSERT_EQ(g_trading.findByOid("100006"), 6);
+
+    g_trading.cleanup();
+}
+
+TEST_CASE(filled_trade_survives_archive_trim) {
+    g_trading.init();
+
+    // Oldest trade: a position Zorro still holds
+    OrderState state;
+    strcpy_s(state.orderId, "777");
+    state.requestedSize = 1.0;
+    state.status = OrderStatus::Open;
+    g_trading.setOrder(2, state);
+    ASSERT_TRUE(g_trading.applyFillProgress(2, 1.0, 50000.0, 1.0));
+
+    // Far more newer cancelled orders and filled closes than the archive keeps
+    int total = config::TRADE_ARCHIVE_MAX + config::TRADE_ARCHIVE_MAX / 5;
+    for (int i = 0; i < total; i++) {
+        int id = 3 + i;
+        sprintf_s(state.orderId, "%d", 200000 + i);
+        state.status = i % 10 == 0 ? OrderStatus::Filled : OrderStatus::Cancelled;
+        g_trading.setOrder(id, state);
+    }
+
+    OrderState out;
+    ASSERT_TRUE(g_trading.getOrder(2, out));
+    ASSERT_EQ((int)out.status, (int)OrderStatus::Filled);
+    ASSERT_FLOAT_EQ(out.filledSize, 1.0);
+    ASSERT_EQ(g_trading.findByOid("777"), 2);
+    ASSERT_TRUE(g_trading.getOrder(3, out));            // Filled close, oldest of the batch
+    ASSERT_FALSE(g_trading.getOrder(4, out));           // Oldest cancelled: evicted
+    ASSERT_EQ((int)g_trading.archivedOrderCount(), 1 + total / 10 + config::TRADE_ARCHIVE_MAX);
+
+    g_trading.cleanup();
+}
+
+//=============================================================================
+// TEST CASES: Compact order records (hot/cold split)
+//=============================================================================
+
+TEST_CASE(order_record_is_one_cache_line) {
+    ASSERT_EQ((int)sizeof(OrderRecord), 64);
+    ASSERT_EQ((int)alignof(OrderRecord), 64);
+}
+
+static bool sameState(const OrderState& a, const OrderState& b) {
+    return strcmp(a.orderId, b.orderId) == 0 && strcmp(a.cloid, b.cloid) == 0 &&
+           strcmp(a.coin, b.coin) == 0 && a.side == b.side &&
+           a.requestedSize == b.requestedSize && a.filledSize == b.filledSize &&
+           a.avgPrice == b.avgPrice && a.status == b.status &&
+           a.zorroTradeId == b.zorroTradeId && a.lastUpdate == b.lastUpdate &&
+           strcmp(a.lastError, b.lastError) == 0;
+}
+
+TEST_CASE(record_round_trips_compact_ids) {
+    g_trading.init();
+
+    OrderState in;
+    strcpy_s(in.orderId, "18446744073709551615");   // UINT64_MAX: 20 digits, goes cold
+    strcpy_s(in.cloid, "0x0000002a0123456789abcdef00000001");
+    strcpy_s(in.coin, "xyz:TSLA");
+    in.side = OrderSide::Sell;
+    in.requestedSize = 1.5;
+    in.filledSize = 0.5;
+    in.avgPrice = 250.25;
+    in.status = OrderStatus::PartialFill;
+    in.zorroTradeId = 42;
+    in.lastUpdate = 45000.5;
+    g_trading.setOrder(42, in);
+
+    OrderState out;
+    ASSERT_TRUE(g_trading.getOrder(42, out));
+    ASSERT_TRUE(sameState(in, out));
+
+    strcpy_s(in.orderId, "9876543210123");
+    g_trading.setOrder(42, in);
+    OrderRecord rec;
+    ASSERT_TRUE(g_trading.getRecord(42, rec));
+    ASSERT_EQ((int)rec.oidKind, (int)OidKind::Exchange);
+    ASSERT_EQ((int)rec.cloidKind, (int)CloidKind::Hex128);
+    ASSERT_STREQ(g_trading.coinName(rec.coinId), "xyz:TSLA");
+    char buf[64];
+    ASSERT_TRUE(TradingState::formatOid(rec, buf, sizeof(buf)));
+    ASSERT_STREQ(buf, "9876543210123");
+    ASSERT_TRUE(TradingState::formatCloid(rec, buf, sizeof(buf)));
+    ASSERT_STREQ(buf, in.cloid);
+    ASSERT_TRUE(g_trading.getOrder(42, out));
+    ASSERT_TRUE(sameState(in, out));
+
+    g_trading.cleanup();
+}
+
+TEST_CASE(record_round_trips_text_fields) {
+    g_trading.init();
+
+    // Synthetic oid, non-hex and uppercase-hex cloids, error text, and a
+    // zorroTradeId that differs from the key all live out of line
+    OrderState in;
+    strcpy_s(in.orderId, "PENDING_0x00000007");
+    strcpy_s(in.cloid, "0x0000000700000000000000000000000A");
+    strcpy_s(in.coin, "ETH");
+    strcpy_s(in.lastError, "Insufficient margin");
+    in.zorroTradeId = 99;
+    g_trading.setOrder(7, in);
+
+    OrderRecord rec;
+    ASSERT_TRUE(g_trading.getRecord(7, rec));
+    ASSERT_EQ((int)rec.oidKind, (int)OidKind::Text);
+    ASSERT_EQ((int)rec.cloidKind, (int)CloidKind::Text);
+    OrderState out;
+    ASSERT_TRUE(g_trading.getOrder(7, out));
+    ASSERT_TRUE(sameState(in, out));
+    ASSERT_EQ(g_trading.findByOid("PENDING_0x00000007"), 7);
+    ASSERT_EQ(g_trading.findByCloid(in.cloid), 7);
+
+    // Leading zeros would not round-trip through uint64
+    strcpy_s(in.orderId, "0123");
+    in.cloid[0] = 0;
+    in.lastError[0] = 0;
+    in.zorroTradeId = 7;
+    g_trading.setOrder(7, in);
+    ASSERT_TRUE(g_trading.getOrder(7, out));
+    ASSERT_TRUE(sameState(in, out));
+    ASSERT_EQ(g_trading.findByCloid("0x0000000700000000000000000000000A"), 0);
+
+    g_trading.cleanup();
+}
+
+TEST_CASE(apply_fill_moves_between_tiers) {
+    g_trading.init();
+
+    OrderState s;
+    strcpy_s(s.orderId, "500");
+    s.requestedSize = 1.0;
+    s.status = OrderStatus::Open;
+    g_trading.setOrder(1, s);
+    ASSERT_EQ((int)g_trading.activeOrderCount(), 1);
+
+    ASSERT_TRUE(g_trading.applyFill(1, 1.0, 10.0, OrderStatus::Filled, 45000.0));
+    ASSERT_EQ((int)g_trading.activeOrderCount(), 0);
+    ASSERT_EQ((int)g_trading.archivedOrderCount(), 1);
+    ASSERT_EQ(g_trading.findByOid("500"), 1);
+
+    OrderRecord rec;
+    ASSERT_TRUE(g_trading.getRecord(1, rec));
+    ASSERT_FLOAT_EQ(rec.avgPrice, 10.0);
+    ASSERT_FLOAT_EQ(rec.lastUpdate, 45000.0);
+    ASSERT_FALSE(g_trading.applyFill(2, 1.0, 10.0, OrderStatus::Filled, 0));
+
+    g_trading.cleanup();
+}
+
+TEST_CASE(apply_fill_progress_is_monotonic) {
+    g_trading.init();
+
+    OrderState s;
+    strcpy_s(s.orderId, "600");
+    s.requestedSize = 2.0;
+    s.status = OrderStatus::Open;
+    g_trading.setOrder(3, s);
+
+    OrderStatus st = OrderStatus::Pending;
+    ASSERT_TRUE(g_trading.applyFillProgress(3, 1.0, 100.0, 1.0, &st));
+    ASSERT_EQ((int)st, (int)OrderStatus::PartialFill);
+    ASSERT_FALSE(g_trading.applyFillProgress(3, 0.5, 99.0, 2.0, &st));   // Stale total
+
+    OrderRecord rec;
+    ASSERT_TRUE(g_trading.getRecord(3, rec));
+    ASSERT_FLOAT_EQ(rec.filledSize, 1.0);
+    ASSERT_FLOAT_EQ(rec.avgPrice, 100.0);
+
+    ASSERT_TRUE(g_trading.applyFillProgress(3, 2.0, 101.0, 3.0, &st));
+    ASSERT_EQ((int)st, (int)OrderStatus::Filled);
+    ASSERT_EQ((int)g_trading.archivedOrderCount(), 1);
+
+    g_trading.cleanup();
+}
+
+TEST_CASE(set_order_id_reindexes) {
+    g_trading.init();
+
+    OrderState s;
+    strcpy_s(s.orderId, "PENDING_x");
+    g_trading.setOrder(4, s);
+    ASSERT_TRUE(g_trading.setOrderId(4, "777", 1.0));
+    ASSERT_EQ(g_trading.findByOid("PENDING_x"), 0);
+    ASSERT_EQ(g_trading.findByOid("777"), 4);
+
+    ASSERT_TRUE(g_trading.setOrderId(4, "RESUMED_BTC", 2.0));
+    ASSERT_EQ(g_trading.findByOid("777"), 0);
+    ASSERT_EQ(g_trading.findByOid("RESUMED_BTC"), 4);
+    OrderState out;
+    ASSERT_TRUE(g_trading.getOrder(4, out));
+    ASSERT_STREQ(out.orderId, "RESUMED_BTC");
+    ASSERT_EQ(out.zorroTradeId, 0);   // Unchanged by the cold entry
+
+    g_trading.cleanup();
+}
+
+TEST_CASE(coins_are_interned_once) {
+    g_trading.init();
+
+    OrderState s;
+    strcpy_s(s.coin, "BTC");
+    g_trading.setOrder(1, s);
+    g_trading.setOrder(2, s);
+    strcpy_s(s.coin, "ETH");
+    g_trading.setOrder(3, s);
+
+    OrderRecord a, b, c;
+    ASSERT_TRUE(g_trading.getRecord(1, a));
+    ASSERT_TRUE(g_trading.getRecord(2, b));
+    ASSERT_TRUE(g_trading.getRecord(3, c));
+    ASSERT_EQ((int)a.coinId, (int)b.coinId);
+    ASSERT_NE((int)a.coinId, (int)c.coinId);
+    ASSERT_STREQ(g_trading.coinName(c.coinId), "ETH");
+    ASSERT_STREQ(g_trading.coinName(9999), "");
+
+    g_trading.cleanup();
+}
+
 //=============================================================================
 // TEST CASES: determineFilledStatus (inline in hl_types.h)
 //=============================================================================
@@ -488,6 +801,20 @@ int main() {
     RUN_TEST(update_nonexistent_order_returns_false);
     RUN_TEST(remove_order_makes_it_unfindable);
     RUN_TEST(multiple_orders_coexist);
+    RUN_TEST(lookup_by_cloid_and_oid);
+    RUN_TEST(oid_assigned_after_placement_is_indexed);
+    RUN_TEST(terminal_order_is_archived_but_found);
+    RUN_TEST(archive_drops_oldest_beyond_limit);
+    RUN_TEST(filled_trade_survives_archive_trim);
+
+    // Compact order records
+    RUN_TEST(order_record_is_one_cache_line);
+    RUN_TEST(record_round_trips_compact_ids);
+    RUN_TEST(record_round_trips_text_fields);
+    RUN_TEST(apply_fill_moves_between_tiers);
+    RUN_TEST(apply_fill_progress_is_monotonic);
+    RUN_TEST(set_order_id_reindexes);
+    RUN_TEST(coins_are_interned_once);
 
     // Fill status determination
     RUN_TEST(filled_status_zero_fill_is_open);
@@ -0,0 +1,127 @@
+//=============================================================================
+// test_ws_fill_ring.cpp - Unit tests for FillRing
+//=============================================================================
+// Part of Hyperliquid Plugin for Zorro
+//
+// LAYER: Test
+// PURPOSE: Ring wrap-around, per-order index kept in step with eviction,
+//          recent() ordering, resize keeping the newest fills, and index
+//          integrity under heavy oid churn (linear-probing deletes).
+//=============================================================================
+
+#include "../test_framework.h"
+#include "ws_fill_ring.h"
+#include <string>
+
+using hl::ws::FillRing;
+using hl::ws::FillData;
+
+static FillData makeFill(const std::string& oid, int tid, const char* coin = "BTC") {
+    FillData f;
+    f.oid = oid;
+    f.tid = std::to_string(tid);
+    f.coin = coin;
+    f.px = 100.0 + tid;
+    f.sz = 1.0;
+    f.time = tid;
+    return f;
+}
+
+TEST_CASE(stores_and_looks_up_by_oid) {
+    FillRing ring(10);
+    ring.add(makeFill("1", 1));
+    ring.add(makeFill("2", 2, "ETH"));
+    ring.add(makeFill("1", 3));
+
+    auto fills = ring.forOrder("1");
+    ASSERT_EQ((int)fills.size(), 2);
+    ASSERT_STREQ(fills[0].tid.c_str(), "1");   // Oldest first
+    ASSERT_STREQ(fills[1].tid.c_str(), "3");
+    ASSERT_STREQ(fills[1].coin.c_str(), "BTC");
+    ASSERT_STREQ(ring.forOrder("2")[0].coin.c_str(), "ETH");
+    ASSERT_EQ(ring.countForOrder("999"), 0);
+    ASSERT_TRUE(ring.forOrder("999").empty());
+}
+
+TEST_CASE(wraps_and_evicts_oldest) {
+    FillRing ring(4);
+    for (int i = 0; i < 6; i++) ring.add(makeFill(i < 3 ? "A" : "B", i));
+
+    ASSERT_EQ((int)ring.size(), 4);
+    ASSERT_EQ(ring.countForOrder("A"), 1);     // tids 0,1 evicted
+    ASSERT_STREQ(ring.forOrder("A")[0].tid.c_str(), "2");
+    ASSERT_EQ(ring.countForOrder("B"), 3);
+
+    auto recent = ring.recent(10);
+    ASSERT_EQ((int)recent.size(), 4);
+    ASSERT_STREQ(recent[0].tid.c_str(), "2");
+    ASSERT_STREQ(recent[3].tid.c_str(), "5");
+
+    recent = ring.recent(2);
+    ASSERT_EQ((int)recent.size(), 2);
+    ASSERT_STREQ(recent[0].tid.c_str(), "4");
+}
+
+TEST_CASE(fully_evicted_order_leaves_index) {
+    FillRing ring(3);
+    ring.add(makeFill("A", 1));
+    for (int i = 2; i <= 4; i++) ring.add(makeFill("B", i));
+    ASSERT_EQ(ring.countForOrder("A"), 0);
+    ASSERT_TRUE(ring.forOrder("A").empty());
+    ASSERT_EQ(ring.countForOrder("B"), 3);
+}
+
+TEST_CASE(index_survives_churn) {
+    // Many distinct oids through a small ring: every add evicts, so index
+    // entries are deleted constantly and probe runs must stay intact
+    FillRing ring(16);
+    for (int i = 0; i < 5000; i++) ring.add(makeFill(std::to_string(i / 2), i));
+
+    int total = 0;
+    for (int oid = 0; oid < 2500; oid++)
+        total += ring.countForOrder(std::to_string(oid));
+    ASSERT_EQ(total, 16);
+    ASSERT_EQ(ring.countForOrder("2499"), 2);
+    ASSERT_EQ(ring.countForOrder("2492"), 2);
+    ASSERT_EQ(ring.countForOrder("2491"), 0);
+}
+
+TEST_CASE(set_capacity_keeps_newest) {
+    FillRing ring(8);
+    for (int i = 0; i < 8; i++) ring.add(makeFill(i % 2 ? "odd" : "even", i));
+
+    ring.setCapacity(3);
+    ASSERT_EQ((int)ring.capacity(), 3);
+    ASSERT_EQ((int)ring.size(), 3);
+    ASSERT_STREQ(ring.recent(1)[0].tid.c_str(), "7");
+    ASSERT_EQ(ring.countForOrder("odd"), 2);    // 5, 7
+    ASSERT_EQ(ring.countForOrder("even"), 1);   // 6
+
+    ring.setCapacity(100);
+    ASSERT_EQ((int)ring.size(), 3);
+    ring.add(makeFill("odd", 8));
+    ASSERT_EQ(ring.countForOrder("odd"), 3);
+}
+
+TEST_CASE(clear_empties_ring_and_index) {
+    FillRing ring(4);
+    ring.add(makeFill("A", 1));
+    ring.clear();
+    ASSERT_EQ((int)ring.size(), 0);
+    ASSERT_EQ(ring.countForOrder("A"), 0);
+    ring.add(makeFill("A", 2));
+    ASSERT_EQ(ring.countForOrder("A"), 1);
+}
+
+int main() {
+    printf("=== FillRing Unit Tests ===\n\n");
+
+    RUN_TEST(stores_and_looks_up_by_oid);
+    RUN_TEST(wraps_and_evicts_oldest);
+    RUN_TEST(fully_evicted_order_leaves_index);
+    RUN_TEST(index_survives_churn);
+    RUN_TEST(set_capacity_keeps_newest);
+    RUN_TEST(clear_empties_ring_and_index);
+
+    return hl::test::printTestSummary();
+}
@@ -15,6 +15,7 @@
 #include "../test_framework.h"
 #include "ws_parsers.h"
 #include "ws_price_cache.h"
+#include "yyjson.h"
 
 //=============================================================================
 // HELPERS
@@ -159,6 +160,108 @@ TEST_CASE(l2book_perpdex_cache_roundtrip) {
     ASSERT_FLOAT_EQ_TOL(btcBid, 0.0, 0.01);
 }
 
+TEST_CASE(l2book_parsed_root_carries_symbol_id) {
+    // WS dispatch hands over the already-parsed frame; the coin comes back
+    // as its g_symbols id and the cache is fed by id
+    const char* json = R"({"channel":"l2Book","data":{"coin":"xyz:XYZ100","time":1700000000000,
+        "levels":[[{"px":"42.50","sz":"100.0"}],[{"px":"42.75","sz":"80.0"}]]}})";
+    yyjson_doc* doc = yyjson_read(json, strlen(json), 0);
+    ASSERT_TRUE(doc != nullptr);
+    auto r = hl::ws::parseL2Book(yyjson_doc_get_root(doc), 0, nullptr);
+    yyjson_doc_free(doc);
+
+    ASSERT_TRUE(r.valid);
+    ASSERT_TRUE(r.coinId != 0);
+    ASSERT_EQ(r.coinId, hl::g_symbols.find("xyz:XYZ100"));
+    ASSERT_EQ(r.coinId, hl::g_symbols.find("xyz", ':', "XYZ100"));
+    ASSERT_EQ(r.time, 1700000000000LL);
+
+    hl::ws::PriceCache cache;
+    ASSERT_TRUE(cache.setBidAsk(r.coinId, r.bid, r.ask));    // First quote
+    ASSERT_FALSE(cache.setBidAsk(r.coinId, r.bid, r.ask));
+    ASSERT_FLOAT_EQ_TOL(cache.getBid("xyz:XYZ100"), 42.50, 0.01);
+    ASSERT_FLOAT_EQ_TOL(cache.getAsk("xyz:XYZ100"), 42.75, 0.01);
+}
+
+//=============================================================================
+// parseActiveAssetCtx TESTS
+//=============================================================================
+
+static hl::ws::AssetCtxUpdate parseAssetCtxJson(const char* json) {
+    yyjson_doc* doc = yyjson_read(json, strlen(json), 0);
+    if (!doc) return hl::ws::AssetCtxUpdate();
+    auto r = hl::ws::parseActiveAssetCtx(yyjson_doc_get_root(doc));
+    yyjson_doc_free(doc);
+    return r;
+}
+
+TEST_CASE(asset_ctx_perp) {
+    uint32_t id = hl::g_symbols.intern("BTC");
+    auto r = parseAssetCtxJson(R"({"channel":"activeAssetCtx","data":{"coin":"BTC","ctx":{
+        "funding":"0.0000125","openInterest":"12345.6","prevDayPx":"96000.0",
+        "dayNtlVlm":"1500000000.0","premium":"0.0001","oraclePx":"97010.0",
+        "markPx":"97000.0","midPx":"97005.0","impactPxs":["97000.0","97010.0"],
+        "dayBaseVlm":"15500.25"}}})");
+
+    ASSERT_TRUE(r.valid);
+    ASSERT_EQ(r.coinId, id);
+    ASSERT_FLOAT_EQ_TOL(r.ctx.funding, 0.0000125, 1e-12);
+    ASSERT_FLOAT_EQ_TOL(r.ctx.markPx, 97000.0, 1e-9);
+    ASSERT_FLOAT_EQ_TOL(r.ctx.oraclePx, 97010.0, 1e-9);
+    ASSERT_FLOAT_EQ_TOL(r.ctx.midPx, 97005.0, 1e-9);
+    ASSERT_FLOAT_EQ_TOL(r.ctx.prevDayPx, 96000.0, 1e-9);
+    ASSERT_FLOAT_EQ_TOL(r.ctx.openInterest, 12345.6, 1e-9);
+    ASSERT_FLOAT_EQ_TOL(r.ctx.dayNtlVlm, 1500000000.0, 1e-3);
+    ASSERT_FLOAT_EQ_TOL(r.ctx.dayBaseVlm, 15500.25, 1e-9);
+}
+
+TEST_CASE(asset_ctx_spot_missing_perp_fields) {
+    uint32_t id = hl::g_symbols.intern("@107");
+    auto r = parseAssetCtxJson(R"({"channel":"activeSpotAssetCtx","data":{"coin":"@107","ctx":{
+        "prevDayPx":"25.1","dayNtlVlm":"880000.0","markPx":"25.4","midPx":"25.41",
+        "circulatingSupply":"1000000.0","dayBaseVlm":"35000.0"}}})");
+
+    ASSERT_TRUE(r.valid);
+    ASSERT_EQ(r.coinId, id);
+    ASSERT_FLOAT_EQ_TOL(r.ctx.markPx, 25.4, 1e-9);
+    ASSERT_FLOAT_EQ_TOL(r.ctx.dayBaseVlm, 35000.0, 1e-9);
+    ASSERT_FLOAT_EQ_TOL(r.ctx.funding, 0.0, 1e-12);
+    ASSERT_FLOAT_EQ_TOL(r.ctx.oraclePx, 0.0, 1e-12);
+}
+
+TEST_CASE(asset_ctx_unknown_coin_or_no_ctx) {
+    auto r = parseAssetCtxJson(R"({"channel":"activeAssetCtx","data":{"coin":"NOT_INTERNED_COIN",
+        "ctx":{"funding":"0.0001","markPx":"1.0"}}})");
+    ASSERT_FALSE(r.valid);
+    ASSERT_EQ(r.coinId, 0u);
+
+    r = parseAssetCtxJson(R"({"channel":"activeAssetCtx","data":{"coin":"BTC"}})");
+    ASSERT_FALSE(r.valid);
+}
+
+TEST_CASE(asset_ctx_store_roundtrip) {
+    uint32_t id = hl::g_symbols.intern("xyz:XYZ100");
+    auto r = parseAssetCtxJson(R"({"channel":"activeAssetCtx","data":{"coin":"xyz:XYZ100",
+        "ctx":{"funding":"-0.00002","markPx":"42.5","dayBaseVlm":"1000"}}})");
+    ASSERT_TRUE(r.valid);
+
+    hl::AssetCtxStore store;
+    hl::AssetCtx out;
+    DWORD age = 12345;
+    ASSERT_FALSE(store.get(id, &out, &age));                // Never set
+    ASSERT_FALSE(store.set(0, r.ctx, hl::AssetCtxSource::Ws));
+
+    ASSERT_TRUE(store.set(r.coinId, r.ctx, hl::AssetCtxSource::Ws));
+    ASSERT_TRUE(store.get(id, &out, &age));
+    ASSERT_TRUE(out.source == hl::AssetCtxSource::Ws);
+    ASSERT_TRUE(age < 1000);
+    ASSERT_FLOAT_EQ_TOL(out.funding, -0.00002, 1e-12);
+    ASSERT_FLOAT_EQ_TOL(out.markPx, 42.5, 1e-9);
+
+    store.clear();
+    ASSERT_FALSE(store.get(id, &out));
+}
+
 //=============================================================================
 // parsePostResponse TESTS
 //=============================================================================
@@ -312,6 +415,32 @@ TEST_CASE(clearinghouse_empty_positions) {
     ASSERT_FLOAT_EQ_TOL(acct.accountValue, 500.0, 0.01);
 }
 
+TEST_CASE(clearinghouse_replaces_only_its_dex) {
+    hl::ws::PriceCache cache;
+    const char* mainJson = R"({"assetPositions":[
+        {"position":{"coin":"BTC","szi":"0.5","entryPx":"90000"}},
+        {"position":{"coin":"ETH","szi":"-1.0","entryPx":"3000"}}]})";
+    const char* xyzJson = R"({"assetPositions":[
+        {"position":{"coin":"XYZ100","szi":"2.0","entryPx":"25"}}]})";
+    hl::ws::parseClearinghouseState(cache, mainJson, 0, nullptr);
+    hl::ws::parseClearinghouseState(cache, xyzJson, 0, nullptr, "xyz");
+    hl::ws::PositionSnapshot before = cache.getPositionSnapshot("");
+
+    // Next main-dex state: ETH closed
+    const char* mainJson2 = R"({"assetPositions":[
+        {"position":{"coin":"BTC","szi":"0.7","entryPx":"90500"}}]})";
+    hl::ws::parseClearinghouseState(cache, mainJson2, 0, nullptr);
+
+    ASSERT_FLOAT_EQ_TOL(cache.getPosition("BTC").size, 0.7, 1e-9);
+    ASSERT_FLOAT_EQ(cache.getPosition("ETH").size, 0.0);
+    ASSERT_FLOAT_EQ_TOL(cache.getPosition("xyz:XYZ100").size, 2.0, 1e-9);
+    ASSERT_EQ((int)cache.getAllPositions().size(), 2);
+
+    // A handle taken earlier still shows the complete previous book
+    ASSERT_EQ((int)before->byCoin.size(), 2);
+    ASSERT_FLOAT_EQ_TOL(before->byCoin.at("BTC").size, 0.5, 1e-9);
+}
+
 TEST_CASE(clearinghouse_cross_margin_higher) {
     hl::ws::PriceCache cache;
     // crossMarginSummary has higher accountValue → should be preferred
@@ -413,7 +542,7 @@ TEST_CASE(open_orders_empty) {
     const char* json = R"({"data":{"orders":[]}})";
     hl::ws::parseOpenOrders(cache, json, 0, nullptr);
 
-    // clearOpenOrders() is called at the start of parseOpenOrders
+    // parseOpenOrders publishes a whole new book, replacing the old one
     auto old = cache.getOpenOrder("old");
     ASSERT_TRUE(old.oid.empty());
 }
@@ -592,6 +721,13 @@ int main() {
     RUN_TEST(l2book_malformed_json);
     RUN_TEST(l2book_perpdex_ws_message);
     RUN_TEST(l2book_perpdex_cache_roundtrip);
+    RUN_TEST(l2book_parsed_root_carries_symbol_id);
+
+    // parseActiveAssetCtx
+    RUN_TEST(asset_ctx_perp);
+    RUN_TEST(asset_ctx_spot_missing_perp_fields);
+    RUN_TEST(asset_ctx_unknown_coin_or_no_ctx);
+    RUN_TEST(asset_ctx_store_roundtrip);
 
     // parsePostResponse
     RUN_TEST(post_response_filled);
@@ -604,6 +740,7 @@ int main() {
     RUN_TEST(clearinghouse_ws_path);
     RUN_TEST(clearinghouse_http_path);
     RUN_TEST(clearinghouse_empty_positions);
+    RUN_TEST(clearinghouse_replaces_only_its_dex);
     RUN_TEST(clearinghouse_cross_margin_higher);
     RUN_TEST(clearinghouse_leverage_as_number);
 
@@ -0,0 +1,140 @@
+//=============================================================================
+// test_ws_sub_registry.cpp - Unit tests for SubscriptionRegistry
+//=============================================================================
+// Part of Hyperliquid Plugin for Zorro
+//
+// LAYER: Test
+// PURPOSE: Lifecycle transitions (requested -> sent -> acked -> live), ack
+//          timeout detection, reconnect reset and data watermarks. Time is
+//          injected — no sleeps, no network.
+//=============================================================================
+
+#include "../test_framework.h"
+#include "ws_sub_registry.h"
+
+using hl::ws::SubscriptionRegistry;
+using hl::ws::SubStatus;
+
+static const DWORD ACK_TIMEOUT = 5000;
+
+TEST_CASE(make_key) {
+    ASSERT_STREQ(SubscriptionRegistry::makeKey("l2Book", "BTC").c_str(), "l2Book:BTC");
+    ASSERT_STREQ(SubscriptionRegistry::makeKey("clearinghouseState", "").c_str(), "clearinghouseState");
+    ASSERT_STREQ(SubscriptionRegistry::makeKey("orderUpdates").c_str(), "orderUpdates");
+}
+
+TEST_CASE(lifecycle_transitions) {
+    SubscriptionRegistry reg(ACK_TIMEOUT);
+    ASSERT_TRUE(reg.status(1, "l2Book:BTC", 0) == SubStatus::None);
+    ASSERT_FALSE(reg.willReceiveData(1, "l2Book:BTC", 0));
+
+    reg.onRequested(1, "l2Book:BTC", 100);
+    ASSERT_TRUE(reg.status(1, "l2Book:BTC", 100) == SubStatus::Requested);
+    ASSERT_TRUE(reg.willReceiveData(1, "l2Book:BTC", 100));
+
+    reg.onSent(1, "l2Book:BTC", 200);
+    ASSERT_TRUE(reg.status(1, "l2Book:BTC", 300) == SubStatus::Sent);
+
+    reg.onAcked(1, "l2Book:BTC", 250);
+    ASSERT_TRUE(reg.status(1, "l2Book:BTC", 300) == SubStatus::Acked);
+    ASSERT_TRUE(reg.willReceiveData(1, "l2Book:BTC", 99999));  // Acked + quiet is fine
+
+    reg.onData(1, "l2Book:BTC", 400);
+    reg.onData(1, "l2Book:BTC", 500);
+    ASSERT_TRUE(reg.status(1, "l2Book:BTC", 600) == SubStatus::Live);
+
+    auto rows = reg.snapshot(600);
+    ASSERT_EQ((int)rows.size(), 1);
+    ASSERT_EQ(rows[0].connection, 1);
+    ASSERT_EQ(rows[0].sends, 1);
+    ASSERT_EQ(rows[0].messages, 2LL);
+    ASSERT_EQ((int)rows[0].firstDataAt, 400);
+    ASSERT_EQ((int)rows[0].lastDataAt, 500);
+}
+
+TEST_CASE(unacked_becomes_dead) {
+    SubscriptionRegistry reg(ACK_TIMEOUT);
+    reg.onSent(0, "l2Book:BADCOIN", 1000);
+    ASSERT_TRUE(reg.status(0, "l2Book:BADCOIN", 5999) == SubStatus::Sent);
+    ASSERT_TRUE(reg.status(0, "l2Book:BADCOIN", 6000) == SubStatus::Dead);
+    ASSERT_FALSE(reg.willReceiveData(0, "l2Book:BADCOIN", 6000));
+
+    // Resend restarts the ack clock
+    reg.onSent(0, "l2Book:BADCOIN", 7000);
+    ASSERT_TRUE(reg.status(0, "l2Book:BADCOIN", 7000) == SubStatus::Sent);
+    ASSERT_EQ(reg.snapshot(7000)[0].sends, 2);
+}
+
+TEST_CASE(data_without_ack_counts_as_acked) {
+    SubscriptionRegistry reg(ACK_TIMEOUT);
+    reg.onSent(0, "orderUpdates", 0);
+    reg.onData(0, "orderUpdates", 10);
+    ASSERT_TRUE(reg.status(0, "orderUpdates", 100000) == SubStatus::Live);
+}
+
+TEST_CASE(connection_lost_resets_only_that_connection) {
+    SubscriptionRegistry reg(ACK_TIMEOUT);
+    reg.onSent(1, "l2Book:BTC", 0);
+    reg.onData(1, "l2Book:BTC", 10);
+    reg.onSent(2, "l2Book:ETH", 0);
+    reg.onData(2, "l2Book:ETH", 10);
+
+    reg.onConnectionLost(1);
+    ASSERT_TRUE(reg.status(1, "l2Book:BTC", 20) == SubStatus::Requested);
+    ASSERT_TRUE(reg.status(2, "l2Book:ETH", 20) == SubStatus::Live);
+    ASSERT_TRUE(reg.hadData(1, "l2Book:BTC"));  // History survives the reconnect
+    ASSERT_FALSE(reg.hadData(1, "l2Book:ETH"));
+}
+
+TEST_CASE(same_key_per_connection_is_separate) {
+    SubscriptionRegistry reg(ACK_TIMEOUT);
+    reg.onSent(0, "orderUpdates", 0);
+    reg.onSent(3, "orderUpdates", 0);   // Standby
+    reg.onData(3, "orderUpdates", 5);
+    ASSERT_TRUE(reg.status(0, "orderUpdates", 10) == SubStatus::Sent);
+    ASSERT_TRUE(reg.status(3, "orderUpdates", 10) == SubStatus::Live);
+    ASSERT_EQ((int)reg.snapshot(10).size(), 2);
+
+    reg.remove(3, "orderUpdates");
+    ASSERT_TRUE(reg.status(3, "orderUpdates", 10) == SubStatus::None);
+}
+
+TEST_CASE(data_by_symbol_id_matches_key) {
+    SubscriptionRegistry reg(ACK_TIMEOUT);
+    const uint32_t BTC_ID = 7;
+    reg.onSent(1, "l2Book:BTC", 0);
+    reg.onData(1, BTC_ID, "l2Book", "BTC", 10);
+    reg.onData(1, BTC_ID, "l2Book", "BTC", 20);     // Cached record
+    reg.onData(2, BTC_ID, "l2Book", "BTC", 30);     // Other connection, own record
+    ASSERT_TRUE(reg.status(1, "l2Book:BTC", 40) == SubStatus::Live);
+    ASSERT_TRUE(reg.hadData(2, "l2Book:BTC"));
+
+    auto rows = reg.snapshot(40);
+    ASSERT_EQ((int)rows.size(), 2);
+    for (const auto& row : rows)
+        ASSERT_EQ(row.messages, row.connection == 1 ? 2LL : 1LL);
+
+    // remove() drops the cached record; the next update starts a new one
+    reg.remove(1, "l2Book:BTC");
+    ASSERT_TRUE(reg.status(1, "l2Book:BTC", 50) == SubStatus::None);
+    reg.onData(1, BTC_ID, "l2Book", "BTC", 60);
+    ASSERT_TRUE(reg.status(1, "l2Book:BTC", 70) == SubStatus::Live);
+
+    reg.clear();
+    reg.onData(1, BTC_ID, "l2Book", "BTC", 80);
+    ASSERT_EQ((int)reg.snapshot(90).size(), 1);
+}
+
+int main() {
+    printf("=== SubscriptionRegistry Unit Tests ===\n\n");
+
+    RUN_TEST(make_key);
+    RUN_TEST(lifecycle_transitions);
+    RUN_TEST(unacked_becomes_dead);
+    RUN_TEST(data_without_ack_counts_as_acked);
+    RUN_TEST(connection_lost_resets_only_that_connection);
+    RUN_TEST(same_key_per_connection_is_separate);
+    RUN_TEST(data_by_symbol_id_matches_key);
+
+    return hl::test::printTestSummary();
+}
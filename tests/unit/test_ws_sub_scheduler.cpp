@@ -0,0 +1,267 @@
+//=============================================================================
+// test_ws_sub_scheduler.cpp - Unit tests for SubscriptionScheduler
+//=============================================================================
+// Part of Hyperliquid Plugin for Zorro
+//
+// LAYER: Test
+// PURPOSE: Deterministic tests for l2Book subscription pacing: token bucket
+//          rate/burst, priority ordering, ack tracking and resend of
+//          unacked subscriptions. Time is injected — no sleeps, no network.
+//=============================================================================
+
+#include "../test_framework.h"
+#include "ws_sub_scheduler.h"
+
+using hl::ws::SubscriptionScheduler;
+
+//=============================================================================
+// PACING
+//=============================================================================
+
+TEST_CASE(burst_then_rate_limited) {
+    SubscriptionScheduler s;
+    s.setPacing(10.0, 5);  // 10 frames/s, 5 back-to-back
+    for (int i = 0; i < 20; ++i) s.enqueue("C" + std::to_string(i));
+
+    ASSERT_EQ((int)s.takeReady(1000).size(), 5);   // Full burst
+    ASSERT_EQ((int)s.takeReady(1000).size(), 0);   // Bucket empty
+    ASSERT_EQ((int)s.takeReady(1050).size(), 0);   // 0.5 token
+    ASSERT_EQ((int)s.takeReady(1100).size(), 1);   // 100ms = 1 token
+    ASSERT_EQ((int)s.takeReady(1400).size(), 3);
+    ASSERT_EQ(s.queuedCount(), 11);
+    ASSERT_EQ(s.sentCount(), 9);
+}
+
+TEST_CASE(idle_refill_capped_at_burst) {
+    SubscriptionScheduler s;
+    s.setPacing(100.0, 4);
+    s.enqueue("A");
+    ASSERT_EQ((int)s.takeReady(0).size(), 1);
+    for (int i = 0; i < 10; ++i) s.enqueue("B" + std::to_string(i));
+    // 60s idle must not bank more than the burst
+    ASSERT_EQ((int)s.takeReady(60000).size(), 4);
+}
+
+TEST_CASE(tick_wraparound) {
+    SubscriptionScheduler s;
+    s.setPacing(10.0, 1);
+    s.enqueue("A");
+    s.enqueue("B");
+    ASSERT_EQ((int)s.takeReady(0xFFFFFF00u).size(), 1);
+    ASSERT_EQ((int)s.takeReady(0x00000010u).size(), 1);  // 272ms later
+}
+
+//=============================================================================
+// PRIORITY
+//=============================================================================
+
+TEST_CASE(priority_order_then_fifo) {
+    SubscriptionScheduler s;
+    s.setPacing(1000.0, 10);
+    s.enqueue("N1", hl::ws::SUB_PRIORITY_NORMAL);
+    s.enqueue("O1", hl::ws::SUB_PRIORITY_ORDER);
+    s.enqueue("N2", hl::ws::SUB_PRIORITY_NORMAL);
+    s.enqueue("P1", hl::ws::SUB_PRIORITY_POSITION);
+    s.enqueue("P2", hl::ws::SUB_PRIORITY_POSITION);
+
+    auto r = s.takeReady(0);
+    ASSERT_EQ((int)r.size(), 5);
+    ASSERT_STREQ(r[0].c_str(), "P1");
+    ASSERT_STREQ(r[1].c_str(), "P2");
+    ASSERT_STREQ(r[2].c_str(), "O1");
+    ASSERT_STREQ(r[3].c_str(), "N1");
+    ASSERT_STREQ(r[4].c_str(), "N2");
+}
+
+TEST_CASE(enqueue_is_idempotent) {
+    SubscriptionScheduler s;
+    s.enqueue("BTC");
+    s.enqueue("BTC", hl::ws::SUB_PRIORITY_POSITION);
+    ASSERT_EQ(s.size(), 1);
+    ASSERT_EQ(s.queuedCount(), 1);
+    ASSERT_TRUE(s.contains("BTC"));
+    ASSERT_FALSE(s.contains("ETH"));
+}
+
+TEST_CASE(reset_all_applies_new_priorities) {
+    SubscriptionScheduler s;
+    s.setPacing(1000.0, 10);
+    s.enqueue("A");
+    s.enqueue("B");
+    s.enqueue("C");
+    for (const auto& c : s.takeReady(0)) s.onAck(c);
+    ASSERT_EQ(s.ackedCount(), 3);
+
+    std::map<std::string, int> prio;
+    prio["C"] = hl::ws::SUB_PRIORITY_POSITION;
+    s.resetAll(prio);
+    ASSERT_EQ(s.ackedCount(), 0);
+    ASSERT_EQ(s.queuedCount(), 3);
+
+    auto r = s.takeReady(1000);
+    ASSERT_EQ((int)r.size(), 3);
+    ASSERT_STREQ(r[0].c_str(), "C");
+}
+
+TEST_CASE(reset_all_drops_stale_priority) {
+    SubscriptionScheduler s;
+    s.setPacing(1000.0, 10);
+    s.enqueue("A");
+    s.enqueue("B", hl::ws::SUB_PRIORITY_POSITION);     // Had a position before the reconnect
+    for (const auto& c : s.takeReady(0)) s.onAck(c);
+
+    std::map<std::string, int> prio;                    // ...and none now
+    s.resetAll(prio);
+    auto r = s.takeReady(1000);
+    ASSERT_EQ((int)r.size(), 2);
+    ASSERT_STREQ(r[0].c_str(), "A");                    // FIFO at normal priority
+    ASSERT_STREQ(r[1].c_str(), "B");
+}
+
+//=============================================================================
+// ACKS AND RESEND
+//=============================================================================
+
+TEST_CASE(ack_tracking) {
+    SubscriptionScheduler s;
+    s.setPacing(1000.0, 10);
+    s.enqueue("BTC");
+    s.enqueue("ETH");
+    s.takeReady(0);
+    s.onAck("BTC");
+    s.onAck("BTC");          // Duplicate ack counted once
+    s.onAck("UNKNOWN");      // Ignored
+    ASSERT_TRUE(s.isAcked("BTC"));
+    ASSERT_FALSE(s.isAcked("ETH"));
+    ASSERT_EQ(s.ackedCount(), 1);
+    ASSERT_EQ(s.sentCount(), 1);
+}
+
+TEST_CASE(only_unacked_are_resent) {
+    SubscriptionScheduler s;
+    s.setPacing(1000.0, 10);
+    s.enqueue("A");
+    s.enqueue("B");
+    s.enqueue("C");
+    s.takeReady(0);
+    s.onAck("A");
+    s.onAck("C");
+
+    ASSERT_EQ(s.requeueUnacked(4999, 5000, 5), 0);  // Not yet timed out
+    ASSERT_EQ(s.requeueUnacked(5000, 5000, 5), 1);
+    auto r = s.takeReady(5000);
+    ASSERT_EQ((int)r.size(), 1);
+    ASSERT_STREQ(r[0].c_str(), "B");
+}
+
+TEST_CASE(late_ack_cancels_resend) {
+    SubscriptionScheduler s;
+    s.setPacing(1000.0, 10);
+    s.enqueue("A");
+    s.takeReady(0);
+    ASSERT_EQ(s.requeueUnacked(6000, 5000, 5), 1);
+    s.onAck("A");                     // Ack arrives after the requeue
+    ASSERT_EQ(s.queuedCount(), 0);
+    ASSERT_EQ((int)s.takeReady(7000).size(), 0);
+}
+
+TEST_CASE(never_acked_coin_given_up_after_max_attempts) {
+    SubscriptionScheduler s;
+    s.setPacing(1000.0, 10);
+    s.enqueue("A");
+    s.enqueue("B");
+    s.takeReady(0);
+    s.onAck("B");
+    std::vector<std::string> givenUp;
+
+    ASSERT_EQ(s.requeueUnacked(5000, 5000, 3, &givenUp), 1);    // Timeout 1
+    s.takeReady(5000);
+    s.resetAll(std::map<std::string, int>());                    // Reconnect keeps the count
+    s.takeReady(5000);
+    s.onAck("B");
+    ASSERT_EQ(s.requeueUnacked(10000, 5000, 3, &givenUp), 1);   // Timeout 2
+    s.takeReady(10000);
+    ASSERT_EQ((int)givenUp.size(), 0);
+
+    ASSERT_EQ(s.requeueUnacked(15000, 5000, 3, &givenUp), 0);   // Timeout 3: give up
+    ASSERT_EQ((int)givenUp.size(), 1);
+    ASSERT_STREQ(givenUp[0].c_str(), "A");
+    ASSERT_FALSE(s.contains("A"));
+    ASSERT_TRUE(s.isAcked("B"));
+    ASSERT_EQ(s.sentCount(), 0);
+    ASSERT_EQ(s.queuedCount(), 0);
+}
+
+TEST_CASE(ack_resets_attempts) {
+    SubscriptionScheduler s;
+    s.setPacing(1000.0, 10);
+    s.enqueue("A");
+    std::vector<std::string> givenUp;
+    s.takeReady(0);
+    ASSERT_EQ(s.requeueUnacked(5000, 5000, 2, &givenUp), 1);
+    s.takeReady(5000);
+    s.onAck("A");                    // Late, but acked: counter starts over
+    s.resetAll(std::map<std::string, int>());
+    s.takeReady(6000);
+    ASSERT_EQ(s.requeueUnacked(11000, 5000, 2, &givenUp), 1);
+    ASSERT_EQ((int)givenUp.size(), 0);
+    ASSERT_TRUE(s.contains("A"));
+}
+
+TEST_CASE(requeue_on_send_failure_refunds_token) {
+    SubscriptionScheduler s;
+    s.setPacing(1.0, 2);
+    s.enqueue("A");
+    s.enqueue("B");
+    s.enqueue("C");
+    auto r = s.takeReady(0);
+    ASSERT_EQ((int)r.size(), 2);
+    s.requeue(r[1]);   // Reverse order keeps the original sequence
+    s.requeue(r[0]);
+    auto again = s.takeReady(0);
+    ASSERT_EQ((int)again.size(), 2);
+    ASSERT_STREQ(again[0].c_str(), "A");
+    ASSERT_STREQ(again[1].c_str(), "B");
+}
+
+TEST_CASE(remove_forgets_coin) {
+    SubscriptionScheduler s;
+    s.setPacing(1000.0, 10);
+    s.enqueue("A");
+    s.enqueue("B");
+    s.remove("A");
+    ASSERT_FALSE(s.contains("A"));
+    ASSERT_EQ(s.queuedCount(), 1);
+    s.takeReady(0);
+    s.onAck("B");
+    s.remove("B");
+    ASSERT_EQ(s.ackedCount(), 0);
+    ASSERT_EQ(s.size(), 0);
+}
+
+//=============================================================================
+// MAIN
+//=============================================================================
+
+int main() {
+    printf("=== SubscriptionScheduler Unit Tests ===\n\n");
+
+    RUN_TEST(burst_then_rate_limited);
+    RUN_TEST(idle_refill_capped_at_burst);
+    RUN_TEST(tick_wraparound);
+
+    RUN_TEST(priority_order_then_fifo);
+    RUN_TEST(enqueue_is_idempotent);
+    RUN_TEST(reset_all_applies_new_priorities);
+    RUN_TEST(reset_all_drops_stale_priority);
+
+    RUN_TEST(ack_tracking);
+    RUN_TEST(only_unacked_are_resent);
+    RUN_TEST(late_ack_cancels_resend);
+    RUN_TEST(never_acked_coin_given_up_after_max_attempts);
+    RUN_TEST(ack_resets_attempts);
+    RUN_TEST(requeue_on_send_failure_refunds_token);
+    RUN_TEST(remove_forgets_coin);
+
+    return hl::test::printTestSummary();
+}